@@ -1,4 +1,5 @@
 #include "AIFeatures.h"
+#include "../Analysis/LoudnessMeter.h"
 #include <algorithm>
 #include <cmath>
 #include <random>
@@ -387,14 +388,20 @@ TempoKeyDetector::DetectionResult TempoKeyDetector::analyze(const juce::AudioBuf
     return result;
 }
 
-std::vector<double> TempoKeyDetector::detectOnsets(const juce::AudioBuffer<float>& /* audio */, double /* sampleRate */)
+std::vector<double> TempoKeyDetector::detectOnsets(const juce::AudioBuffer<float>& audio, double sampleRate)
 {
-    // Simplified - return evenly spaced onsets
-    std::vector<double> onsets;
-    for (int i = 0; i < 32; ++i)
+    // Shared onset detector; weak onsets (< 10% of the strongest) are left out
+    if (sampleRate != onsetDetector_.getSampleRate() || !onsetDetectorReady_)
     {
-        onsets.push_back(i * 0.5);  // Every 0.5 seconds
+        onsetDetector_.initialize(sampleRate);
+        onsetDetectorReady_ = true;
     }
+    
+    onsetDetector_.detect(audio, onsetList_);
+    
+    std::vector<double> onsets;
+    for (const auto& onset : onsetList_.select(0.1f))
+        onsets.push_back(onset.position / sampleRate);
     return onsets;
 }
 
@@ -512,15 +519,8 @@ MasteringChain::ChainSettings MasteringChain::getPreset(const juce::String& genr
 
 float MasteringChain::analyzeLUFS(const juce::AudioBuffer<float>& audio)
 {
-    // Simplified RMS-based estimate
-    float rms = 0.0f;
-    for (int ch = 0; ch < audio.getNumChannels(); ++ch)
-    {
-        rms += audio.getRMSLevel(ch, 0, audio.getNumSamples());
-    }
-    rms /= audio.getNumChannels();
-    
-    return juce::Decibels::gainToDecibels(rms) - 23.0f;  // Rough LUFS approximation
+    // Gated integrated loudness (ITU-R BS.1770)
+    return Analysis::LoudnessMeter::measure(audio, sampleRate_).integratedLUFS;
 }
 
 std::vector<float> MasteringChain::analyzeFrequencyResponse(const juce::AudioBuffer<float>& /* audio */)
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include "../DSP/OnsetDetector.h"
 
 namespace omega {
 namespace AI {
@@ -153,6 +154,10 @@ private:
     
     DetectionResult currentResult_;
     bool hasResult_;
+    
+    OnsetDetector onsetDetector_;
+    OnsetList onsetList_;
+    bool onsetDetectorReady_ = false;
 };
 
 /**
@@ -197,8 +202,11 @@ public:
     // Presets
     ChainSettings getPreset(const juce::String& genre);
     
+    void setSampleRate(double sampleRate) { sampleRate_ = sampleRate; }
+    
 private:
     std::map<juce::String, ChainSettings> presets_;
+    double sampleRate_ = 44100.0;
     void initializePresets();
     
     float analyzeLUFS(const juce::AudioBuffer<float>& audio);
@@ -1,12 +1,53 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <algorithm>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace omega {
 namespace AI {
 
+enum class AIJobPriority {
+    Low,
+    Normal,
+    High
+};
+
+/**
+ * What a running job sees: progress reporting and cooperative cancellation.
+ * Shared between the queue, the job and whoever started it.
+ */
+class AIJobContext {
+public:
+    void setProgress(float value) {
+        progress.store(juce::jlimit(0.0f, 1.0f, value));
+        if (onProgress)
+            onProgress(progress.load());
+    }
+    float getProgress() const { return progress.load(); }
+
+    /** Called on the job's thread for every update; set it before the job starts */
+    std::function<void(float)> onProgress;
+
+    void cancel() { cancelled.store(true); }
+    bool isCancelled() const { return cancelled.load(); }
+
+    bool isFinished() const { return finished.load(); }
+
+private:
+    friend class AIJobQueue;
+
+    std::atomic<float> progress { 0.0f };
+    std::atomic<bool> cancelled { false };
+    std::atomic<bool> finished { false };
+};
+
+using AIJobHandle = std::shared_ptr<AIJobContext>;
+
 struct AIJob {
     juce::String name;
     std::function<void()> run;
@@ -16,35 +57,94 @@ struct AIJob {
 class AIJobQueue {
 public:
     explicit AIJobQueue(int workerThreads = 2) : pool(workerThreads) {}
-    ~AIJobQueue() = default;
 
-    void enqueue(const AIJob& job) {
-        pool.addJob(new PoolJob(job, progress), true);
+    ~AIJobQueue() {
+        cancelAll();
+        pool.removeAllJobs(true, 10000);
     }
 
-    float getProgress() const { return progress.load(); }
-
-private:
-    class PoolJob : public juce::ThreadPoolJob {
-    public:
-        PoolJob(const AIJob& j, std::atomic<float>& p)
-            : juce::ThreadPoolJob(j.name), job(j), progressRef(p) {}
-
-        JobStatus runJob() override {
-            progressRef.store(0.0f);
+    void enqueue(const AIJob& job) {
+        addJob([this, job](AIJobContext&) {
+            progress.store(0.0f);
             if (job.run)
                 job.run();
-            progressRef.store(1.0f);
+            progress.store(1.0f);
             if (job.onComplete)
                 job.onComplete();
-            return jobHasFinished;
+        });
+    }
+
+    /**
+     * Queue a job; higher priorities start first, equal ones in order.
+     * The job reports progress and polls cancellation through its context.
+     */
+    AIJobHandle addJob(std::function<void(AIJobContext&)> run,
+                       AIJobPriority priority = AIJobPriority::Normal) {
+        auto context = std::make_shared<AIJobContext>();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back({ std::move(run), context, priority, nextSequence++ });
+        }
+        // One runner per job: whichever starts takes the most urgent pending one
+        pool.addJob([this] { runNext(); });
+        return context;
+    }
+
+    /** Cancel queued jobs (they never start) and ask running ones to stop */
+    void cancelAll() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& entry : pending) {
+            entry.context->cancel();
+            entry.context->finished.store(true);
         }
+        pending.clear();
+        for (auto& context : running)
+            context->cancel();
+    }
 
-    private:
-        AIJob job;
-        std::atomic<float>& progressRef;
+    int getNumPendingJobs() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (int) pending.size();
+    }
+
+    float getProgress() const { return progress.load(); }
+
+private:
+    struct Entry {
+        std::function<void(AIJobContext&)> run;
+        AIJobHandle context;
+        AIJobPriority priority;
+        uint64_t sequence;
     };
 
+    void runNext() {
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (pending.empty())
+                return;     // Cancelled before it started
+
+            auto next = std::min_element(pending.begin(), pending.end(), [](const Entry& a, const Entry& b) {
+                return a.priority != b.priority ? a.priority > b.priority : a.sequence < b.sequence;
+            });
+            entry = std::move(*next);
+            pending.erase(next);
+            running.push_back(entry.context);
+        }
+
+        if (!entry.context->isCancelled() && entry.run)
+            entry.run(*entry.context);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running.erase(std::find(running.begin(), running.end(), entry.context));
+        entry.context->finished.store(true);
+    }
+
+    mutable std::mutex mutex;
+    std::vector<Entry> pending;
+    std::vector<AIJobHandle> running;
+    uint64_t nextSequence = 0;
+
     std::atomic<float> progress { 0.0f };
     juce::ThreadPool pool;
 };
@@ -18,10 +18,17 @@ AIVocalTuner::AIVocalTuner() {
 
 void AIVocalTuner::initialize(double sampleRate) {
     sampleRate_ = sampleRate;
+    pitchTracker_.initialize(sampleRate);
 }
 
 void AIVocalTuner::process(juce::AudioBuffer<float>& buffer) {
-    detectedPitch_ = detectPitch(buffer);
+    // Shared tracker: keep the last pitch through unvoiced frames
+    pitchTracker_.push(buffer.getReadPointer(0), buffer.getNumSamples());
+    const auto& estimate = pitchTracker_.getEstimate();
+    if (!estimate.voiced)
+        return;
+    
+    detectedPitch_ = estimate.frequency;
     float targetPitch = quantizeToScale(detectedPitch_);
     
     // Placeholder pitch shift
@@ -31,29 +38,6 @@ void AIVocalTuner::process(juce::AudioBuffer<float>& buffer) {
     }
 }
 
-float AIVocalTuner::detectPitch(const juce::AudioBuffer<float>& buffer) {
-    // Simplified autocorrelation
-    const float* data = buffer.getReadPointer(0);
-    int numSamples = buffer.getNumSamples();
-    
-    float maxCorr = 0.0f;
-    int bestLag = 100;
-    
-    for (int lag = 50; lag < 500; ++lag) {
-        float corr = 0.0f;
-        for (int i = 0; i < numSamples - lag; ++i) {
-            corr += data[i] * data[i + lag];
-        }
-        if (corr > maxCorr) {
-            maxCorr = corr;
-            bestLag = lag;
-        }
-    }
-    
-    float freq = static_cast<float>(sampleRate_) / bestLag;
-    return freq;
-}
-
 float AIVocalTuner::quantizeToScale(float pitch) {
     int midiNote = static_cast<int>(12.0f * std::log2(pitch / 440.0f) + 69.0f);
     int octave = midiNote / 12;
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "../DSP/PitchTracker.h"
 
 namespace omega {
 namespace AI {
@@ -27,9 +28,9 @@ public:
     float getDetectedPitch() const { return detectedPitch_; }
     
 private:
-    float detectPitch(const juce::AudioBuffer<float>& buffer);
     float quantizeToScale(float pitch);
     
+    PitchTracker pitchTracker_;
     double sampleRate_ = 48000.0;
     float correction_ = 1.0f;
     bool preserveVibrato_ = true;
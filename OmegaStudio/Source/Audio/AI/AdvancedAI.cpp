@@ -6,6 +6,8 @@
 */
 
 #include "AdvancedAI.h"
+#include "OnnxRuntimeWrapper.h"
+#include "../Analysis/LoudnessMeter.h"
 #include <algorithm>
 #include <cmath>
 
@@ -15,8 +17,17 @@ namespace OmegaStudio {
 // StemSeparator Implementation
 //==============================================================================
 
+namespace {
+StemSeparator::StemType stemTypeFromName(const juce::String& name) {
+    if (name == "vocals") return StemSeparator::StemType::Vocals;
+    if (name == "drums")  return StemSeparator::StemType::Drums;
+    if (name == "bass")   return StemSeparator::StemType::Bass;
+    return StemSeparator::StemType::Other;
+}
+}
+
 StemSeparator::StemSeparator() = default;
-StemSeparator::~StemSeparator() = default;
+StemSeparator::~StemSeparator() = default;   // jobQueue espera al trabajo en curso
 
 void StemSeparator::prepareToPlay(double sr, int bs) {
     sampleRate = sr;
@@ -29,7 +40,15 @@ void StemSeparator::releaseResources() {
 
 bool StemSeparator::separateStems(const juce::AudioBuffer<float>& mixedAudio,
                                   std::map<StemType, juce::AudioBuffer<float>>& separatedStems) {
-    // Stub implementation - En producción usaría modelo ML (Demucs, Spleeter, etc.)
+    // Con modelo ONNX: separación real por ventanas
+    processWithModel(mixedAudio);
+    if (!stems.empty()) {
+        for (const auto& [type, buffer] : stems)
+            separatedStems[type] = buffer;
+        return true;
+    }
+    
+    // Sin modelo: reparto aproximado (no AI)
     int numChannels = mixedAudio.getNumChannels();
     int numSamples = mixedAudio.getNumSamples();
     
@@ -38,13 +57,11 @@ bool StemSeparator::separateStems(const juce::AudioBuffer<float>& mixedAudio,
         juce::AudioBuffer<float> stemBuffer(numChannels, numSamples);
         stemBuffer.clear();
         
-        // Stub: Simple frequency-based separation (no real AI)
-        // En producción: Aquí iría el modelo de deep learning
+        // Filtrado simplificado por rangos de frecuencia
         for (int ch = 0; ch < numChannels; ++ch) {
             for (int i = 0; i < numSamples; ++i) {
                 float sample = mixedAudio.getSample(ch, i);
                 
-                // Filtrado simplificado por rangos de frecuencia
                 switch (type) {
                     case StemType::Vocals:
                         stemBuffer.setSample(ch, i, sample * 0.3f);
@@ -69,13 +86,43 @@ bool StemSeparator::separateStems(const juce::AudioBuffer<float>& mixedAudio,
 }
 
 void StemSeparator::startSeparation(const juce::File& inputFile) {
-    juce::ignoreUnused(inputFile);
-    separating = true;
+    stopSeparation();
     progress = 0.0f;
+    {
+        const juce::ScopedLock sl(resultLock);
+        stemFiles.clear();
+        lastError.clear();
+    }
+    
+    if (!loadModel())
+        return;
+    
+    // Memoria acotada por ventanas: la longitud del archivo no importa
+    pipeline = std::make_unique<omega::AI::StemSeparationPipeline>(*session, makePipelineConfig());
+    if (jobQueue == nullptr)
+        jobQueue = std::make_unique<omega::AI::AIJobQueue>(1);
+    
+    const auto outputDirectory = inputFile.getSiblingFile(inputFile.getFileNameWithoutExtension() + " Stems");
+    job = pipeline->separateFileAsync(*jobQueue, inputFile, outputDirectory,
+        [this](const omega::AI::StemPipelineResult& result) {
+            const juce::ScopedLock sl(resultLock);
+            lastError = result.errorMessage;
+            for (const auto& [name, file] : result.stemFiles)
+                stemFiles[stemTypeFromName(name)] = file;
+        });
 }
 
 void StemSeparator::stopSeparation() {
-    separating = false;
+    // Destruir la cola cancela y espera al lote en curso
+    jobQueue.reset();
+    if (job != nullptr)
+        progress = job->getProgress();
+    job.reset();
+}
+
+juce::String StemSeparator::getLastError() const {
+    const juce::ScopedLock sl(resultLock);
+    return lastError;
 }
 
 void StemSeparator::setQuality(int q) {
@@ -83,17 +130,88 @@ void StemSeparator::setQuality(int q) {
 }
 
 void StemSeparator::setModelPath(const juce::File& path) {
+    stopSeparation();
+    pipeline.reset();
+    session.reset();
     modelPath = path;
 }
 
 bool StemSeparator::exportStem(StemType type, const juce::File& outputFile) {
-    juce::ignoreUnused(type, outputFile);
-    return false;  // Stub
+    {
+        const juce::ScopedLock sl(resultLock);
+        auto it = stemFiles.find(type);
+        if (it != stemFiles.end() && it->second.existsAsFile())
+            return it->second.copyFileTo(outputFile);
+    }
+    
+    auto it = stems.find(type);
+    if (it == stems.end())
+        return false;
+    
+    const auto& buffer = it->second;
+    outputFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+    if (stream == nullptr)
+        return false;
+    
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), sampleRate, (unsigned int) buffer.getNumChannels(), 24, {}, 0));
+    if (writer == nullptr)
+        return false;
+    stream.release();   // Ahora es del writer
+    
+    return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+}
+
+bool StemSeparator::loadModel() {
+    if (session != nullptr)
+        return true;
+    
+    auto candidate = std::make_unique<omega::AI::OnnxStemSession>();
+    omega::AI::OnnxSessionOptions options;
+    options.intraOpThreads = juce::jmax(1, juce::SystemStats::getNumCpus() / 2);
+    if (!candidate->loadModel(modelPath, options)) {
+        const juce::ScopedLock sl(resultLock);
+        lastError = "No se pudo cargar el modelo: " + modelPath.getFullPathName();
+        return false;
+    }
+    
+    session = std::move(candidate);
+    return true;
+}
+
+omega::AI::StemPipelineConfig StemSeparator::makePipelineConfig() const {
+    // Más calidad = más solapamiento entre ventanas (fundido más largo)
+    static constexpr double overlapSeconds[] = { 0.25, 1.0, 2.5 };
+    
+    omega::AI::StemPipelineConfig config;
+    config.overlapSeconds = overlapSeconds[quality];
+    config.maxBatchesInFlight = 2;
+    return config;
 }
 
 void StemSeparator::processWithModel(const juce::AudioBuffer<float>& input) {
-    juce::ignoreUnused(input);
-    // Stub - Aquí iría el procesamiento con modelo ML
+    stems.clear();
+    if (modelPath == juce::File() || !loadModel())
+        return;
+    
+    std::map<juce::String, juce::AudioBuffer<float>> separated;
+    omega::AI::StemSeparationPipeline modelPipeline(*session, makePipelineConfig());
+    if (!modelPipeline.separateBuffer(input, sampleRate, separated).success)
+        return;
+    
+    for (auto& [name, buffer] : separated) {
+        const auto type = stemTypeFromName(name);
+        auto existing = stems.find(type);
+        if (existing == stems.end()) {
+            stems[type] = std::move(buffer);
+        } else {
+            // Stems adicionales del modelo se suman a "Other"
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                existing->second.addFrom(ch, 0, buffer, ch, 0, buffer.getNumSamples());
+        }
+    }
 }
 
 //==============================================================================
@@ -144,16 +262,8 @@ void MasteringAssistant::applyAllSuggestions(juce::AudioProcessor* processor) {
 }
 
 void MasteringAssistant::analyzeLoudness(const juce::AudioBuffer<float>& audio) {
-    // Stub - Análisis simple de RMS
-    float rms = 0.0f;
-    for (int ch = 0; ch < audio.getNumChannels(); ++ch) {
-        for (int i = 0; i < audio.getNumSamples(); ++i) {
-            float sample = audio.getSample(ch, i);
-            rms += sample * sample;
-        }
-    }
-    rms = std::sqrt(rms / (audio.getNumChannels() * audio.getNumSamples()));
-    currentLUFS = 20.0f * std::log10(rms + 0.00001f);
+    // Loudness integrada con gating (ITU-R BS.1770)
+    currentLUFS = omega::Analysis::LoudnessMeter::measure(audio, sampleRate).integratedLUFS;
 }
 
 void MasteringAssistant::analyzeDynamics(const juce::AudioBuffer<float>& audio) {
@@ -390,7 +500,7 @@ void MixAnalyzer::analyzeDynamics(const juce::AudioBuffer<float>& audio, MixAnal
     
     rms = std::sqrt(rms / (audio.getNumChannels() * audio.getNumSamples()));
     result.peakLevel = 20.0f * std::log10(peak + 0.00001f);
-    result.lufs = 20.0f * std::log10(rms + 0.00001f);
+    result.lufs = omega::Analysis::LoudnessMeter::measure(audio, sampleRate).integratedLUFS;
     result.dynamicRange = 20.0f * std::log10(peak / (rms + 0.00001f));
 }
 
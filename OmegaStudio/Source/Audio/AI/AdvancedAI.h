@@ -15,11 +15,14 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "StemSeparationPipeline.h"
 #include <vector>
 #include <map>
 #include <memory>
 #include <functional>
 
+namespace omega { namespace AI { class OnnxStemSession; } }
+
 namespace OmegaStudio {
 
 //==============================================================================
@@ -44,11 +47,13 @@ public:
     bool separateStems(const juce::AudioBuffer<float>& mixedAudio,
                       std::map<StemType, juce::AudioBuffer<float>>& separatedStems);
     
-    // Process in chunks for real-time
+    // Separación de un archivo en segundo plano: ventanas solapadas, stems a
+    // "<nombre> Stems/" junto al archivo (requiere modelo ONNX)
     void startSeparation(const juce::File& inputFile);
-    void stopSeparation();
-    bool isSeparating() const { return separating; }
-    float getProgress() const { return progress; }
+    void stopSeparation();      // Cancela y espera al lote en curso
+    bool isSeparating() const { return job != nullptr && !job->isFinished(); }
+    float getProgress() const { return job != nullptr ? job->getProgress() : progress; }
+    juce::String getLastError() const;
     
     // Quality settings
     void setQuality(int quality);  // 0=draft, 1=good, 2=best
@@ -60,15 +65,24 @@ public:
 private:
     double sampleRate { 44100.0 };
     int blockSize { 512 };
-    bool separating { false };
     float progress { 0.0f };
     
     int quality { 1 };
     juce::File modelPath;
     
-    std::map<StemType, juce::AudioBuffer<float>> stems;
+    std::map<StemType, juce::AudioBuffer<float>> stems;     // separateStems()
+    std::map<StemType, juce::File> stemFiles;               // Última startSeparation()
+    juce::String lastError;
+    juce::CriticalSection resultLock;
+    
+    // Modelo ONNX (carga diferida); la cola se declara después: se destruye antes
+    std::unique_ptr<omega::AI::OnnxStemSession> session;
+    std::unique_ptr<omega::AI::StemSeparationPipeline> pipeline;
+    std::unique_ptr<omega::AI::AIJobQueue> jobQueue;
+    omega::AI::AIJobHandle job;
     
-    // AI model processing (stub)
+    bool loadModel();
+    omega::AI::StemPipelineConfig makePipelineConfig() const;
     void processWithModel(const juce::AudioBuffer<float>& input);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StemSeparator)
@@ -93,6 +107,7 @@ public:
     ~MasteringAssistant();
     
     // Analysis
+    void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
     void analyzeAudio(const juce::AudioBuffer<float>& audio);
     std::vector<MasteringSuggestion> getSuggestions() const { return suggestions; }
     
@@ -119,6 +134,7 @@ private:
     float targetLUFS { -14.0f };
     float targetDynamicRange { 8.0f };
     juce::String genre { "Electronic" };
+    double sampleRate { 44100.0 };
     
     // Analysis results
     float currentLUFS { -23.0f };
@@ -221,6 +237,7 @@ public:
     ~MixAnalyzer();
     
     // Analysis
+    void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
     MixAnalysis analyzeMix(const juce::AudioBuffer<float>& audio);
     MixAnalysis analyzeMix(const juce::File& audioFile);
     
@@ -239,6 +256,7 @@ private:
     MixAnalysis lastAnalysis;
     juce::String targetGenre { "Electronic" };
     int analysisDepth { 1 };
+    double sampleRate { 44100.0 };
     
     std::vector<juce::AudioBuffer<float>> referenceTracks;
     
@@ -12,162 +12,209 @@ DenoiseService::~DenoiseService() {
     cancelAll();
 }
 
-DenoiseResult DenoiseService::processAudio(const juce::AudioBuffer<float>& input) {
+int DenoiseService::getFftSize(DenoiseQuality quality, double sampleRate) {
+    switch (quality) {
+        case DenoiseQuality::Fast:        return SpectralDenoiser::fftSizeForDuration(sampleRate, 0.008);
+        case DenoiseQuality::Balanced:    return SpectralDenoiser::fftSizeForDuration(sampleRate, 0.02);
+        case DenoiseQuality::HighQuality: return SpectralDenoiser::fftSizeForDuration(sampleRate, 0.04);
+    }
+    return SpectralDenoiser::fftSizeForDuration(sampleRate, 0.02);
+}
+
+DenoiseResult DenoiseService::processAudio(const juce::AudioBuffer<float>& input, AIJobContext* job) {
     if (input.getNumSamples() == 0) {
         return {juce::AudioBuffer<float>(), 0.0f, 0.0f, false, "Empty input buffer"};
     }
     
-    isProcessing_ = true;
+    ++activeJobs_;
     auto startTime = juce::Time::getMillisecondCounterHiRes();
     
+    const int numChannels = input.getNumChannels();
+    const int length = input.getNumSamples();
+    juce::AudioBuffer<float> output(numChannels, length);
+    int position = 0;
+    
+    auto read = [&input, length](juce::AudioBuffer<float>& block, juce::int64 start, int numSamples) {
+        const int available = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, length - start);
+        for (int ch = 0; ch < block.getNumChannels(); ++ch) {
+            if (available > 0)
+                block.copyFrom(ch, 0, input.getReadPointer(ch, (int) start), available);
+            if (available < numSamples)
+                juce::FloatVectorOperations::clear(block.getWritePointer(ch, available), numSamples - available);
+        }
+    };
+    auto write = [&output, &position](const juce::AudioBuffer<float>& block, int start, int numSamples) {
+        for (int ch = 0; ch < output.getNumChannels(); ++ch)
+            output.copyFrom(ch, position, block.getReadPointer(ch, start), numSamples);
+        position += numSamples;
+        return true;
+    };
+    
+    const auto config = config_;
+    auto result = render(config, config.sampleRate, numChannels, length, read, write, job);
+    if (result.success)
+        result.denoisedAudio = std::move(output);
+    
+    result.processingTimeMs = static_cast<float>(juce::Time::getMillisecondCounterHiRes() - startTime);
+    --activeJobs_;
+    
+    return result;
+}
+
+DenoiseResult DenoiseService::processFile(const juce::File& input, const juce::File& output, AIJobContext* job) {
     DenoiseResult result;
     
-    // Use ONNX model if available, otherwise fallback to spectral subtraction
-    if (config_.modelPath.existsAsFile()) {
-        result = applyRNNoise(input);
-    } else {
-        result = applySpectralSubtraction(input);
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+    if (reader == nullptr) {
+        result.errorMessage = "Could not read " + input.getFileName();
+        return result;
     }
     
-    // Post-process to reduce artifacts
-    if (result.success && config_.preserveTransients) {
-        reduceArtifacts(result.denoisedAudio);
+    ++activeJobs_;
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    
+    // Written next to the target first: a cancelled run leaves the old file
+    juce::TemporaryFile temporary(output);
+    std::unique_ptr<juce::FileOutputStream> stream(temporary.getFile().createOutputStream());
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    juce::WavAudioFormat wavFormat;
+    if (stream != nullptr)
+        writer.reset(wavFormat.createWriterFor(stream.get(), reader->sampleRate, reader->numChannels, 24, {}, 0));
+    
+    if (writer == nullptr) {
+        result.errorMessage = "Could not create " + output.getFullPathName();
+    } else {
+        stream.release();   // Owned by the writer
+        
+        auto read = [&reader](juce::AudioBuffer<float>& block, juce::int64 start, int numSamples) {
+            reader->read(&block, 0, numSamples, start, true, true);
+        };
+        auto write = [&writer](const juce::AudioBuffer<float>& block, int start, int numSamples) {
+            return writer->writeFromAudioSampleBuffer(block, start, numSamples);
+        };
+        
+        const auto config = config_;
+        result = render(config, reader->sampleRate, (int) reader->numChannels, reader->lengthInSamples, read, write, job);
+        
+        writer.reset();     // Flush and close before moving into place
+        if (result.success && !temporary.overwriteTargetFileWithTemporary()) {
+            result.success = false;
+            result.errorMessage = "Could not write " + output.getFullPathName();
+        }
     }
     
     result.processingTimeMs = static_cast<float>(juce::Time::getMillisecondCounterHiRes() - startTime);
-    isProcessing_ = false;
+    --activeJobs_;
     
     return result;
 }
 
-void DenoiseService::processAudioAsync(const juce::AudioBuffer<float>& input,
-                                       std::function<void(DenoiseResult)> callback) {
-    if (!jobQueue_) return;
+AIJobHandle DenoiseService::processAudioAsync(const juce::AudioBuffer<float>& input,
+                                              std::function<void(DenoiseResult)> callback) {
+    if (!jobQueue_) return {};
     
     auto inputCopy = input;
     
-    jobQueue_->addJob([this, inputCopy, callback]() {
-        auto result = processAudio(inputCopy);
+    return jobQueue_->addJob([this, inputCopy, callback](AIJobContext& job) {
+        auto result = processAudio(inputCopy, &job);
         if (callback) {
             callback(result);
         }
     }, AIJobPriority::High); // Denoise is high priority for user experience
 }
 
+AIJobHandle DenoiseService::processFileAsync(const juce::File& input, const juce::File& output,
+                                             std::function<void(DenoiseResult)> callback) {
+    if (!jobQueue_) return {};
+    
+    return jobQueue_->addJob([this, input, output, callback](AIJobContext& job) {
+        auto result = processFile(input, output, &job);
+        if (callback) {
+            callback(result);
+        }
+    }, AIJobPriority::High);
+}
+
 void DenoiseService::cancelAll() {
-    isProcessing_ = false;
     if (jobQueue_) {
-        jobQueue_.reset();
-        jobQueue_ = std::make_unique<AIJobQueue>(2);
+        jobQueue_->cancelAll();
     }
 }
 
-DenoiseResult DenoiseService::applyRNNoise(const juce::AudioBuffer<float>& input) {
-    // TODO: Integrate ONNX RNNoise model
-    // For now, fallback to spectral subtraction
-    return applySpectralSubtraction(input);
-}
-
-DenoiseResult DenoiseService::applySpectralSubtraction(const juce::AudioBuffer<float>& input) {
+DenoiseResult DenoiseService::render(const DenoiseConfig& config, double sampleRate, int numChannels, juce::int64 length,
+                                     const BlockReader& read, const BlockWriter& write, AIJobContext* job) {
     DenoiseResult result;
-    result.denoisedAudio.setSize(input.getNumChannels(), input.getNumSamples());
+    if (numChannels <= 0 || length <= 0) {
+        result.errorMessage = "Empty input";
+        return result;
+    }
     
-    // Simple spectral subtraction algorithm
-    const int fftSize = 2048;
-    const int hopSize = fftSize / 4;
+    SpectralDenoiser denoiser;
+    denoiser.prepare(sampleRate, numChannels, getFftSize(config.quality, sampleRate));
+    denoiser.setParameters({ config.reductionAmount, config.adaptiveMode, config.preserveTransients });
     
-    juce::dsp::FFT fft(11); // 2^11 = 2048
-    juce::HeapBlock<juce::dsp::Complex<float>> fftBuffer;
-    fftBuffer.calloc(fftSize * 2);
+    juce::AudioBuffer<float> block(numChannels, kBlockSize);
+    
+    // Noise profile from the first 100 ms; adaptive mode keeps tracking from there
+    const juce::int64 learnSamples = juce::jmin((juce::int64) (sampleRate * 0.1), length / 4);
+    if (learnSamples > 0) {
+        denoiser.setLearning(true);
+        for (juce::int64 pos = 0; pos < learnSamples; pos += kBlockSize) {
+            const int numSamples = (int) juce::jmin((juce::int64) kBlockSize, learnSamples - pos);
+            read(block, pos, numSamples);
+            denoiser.process(block.getArrayOfWritePointers(), numChannels, numSamples);
+        }
+        denoiser.setLearning(false);
+        denoiser.reset();
+    }
     
-    for (int channel = 0; channel < input.getNumChannels(); ++channel) {
-        const float* inputData = input.getReadPointer(channel);
-        float* outputData = result.denoisedAudio.getWritePointer(channel);
+    // Feed latency extra samples of silence and drop the first latency outputs
+    const int latency = denoiser.getLatencySamples();
+    const juce::int64 total = length + latency;
+    juce::int64 fed = 0, written = 0;
+    double inputEnergy = 0.0, outputEnergy = 0.0;
+    
+    while (written < length) {
+        if (job != nullptr && job->isCancelled()) {
+            result.errorMessage = "Cancelled";
+            return result;
+        }
         
-        // Estimate noise floor from first 100ms
-        int noiseEstimateSamples = juce::jmin((int)(config_.sampleRate * 0.1), input.getNumSamples() / 4);
-        float noiseFloor = 0.0f;
+        const int numSamples = (int) juce::jmin((juce::int64) kBlockSize, total - fed);
+        read(block, fed, numSamples);
         
-        for (int i = 0; i < noiseEstimateSamples; ++i) {
-            noiseFloor += std::abs(inputData[i]);
-        }
-        noiseFloor /= noiseEstimateSamples;
-        noiseFloor *= config_.reductionAmount;
+        const int real = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, length - fed);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < real; ++i)
+                inputEnergy += (double) block.getSample(ch, i) * block.getSample(ch, i);
         
-        // Process in overlapping windows
-        for (int pos = 0; pos < input.getNumSamples(); pos += hopSize) {
-            int windowSize = juce::jmin(fftSize, input.getNumSamples() - pos);
-            
-            // Copy window with Hann windowing
-            for (int i = 0; i < windowSize; ++i) {
-                float window = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::twoPi * i / (windowSize - 1)));
-                fftBuffer[i].real(inputData[pos + i] * window);
-                fftBuffer[i].imag(0.0f);
-            }
-            
-            // Zero pad
-            for (int i = windowSize; i < fftSize; ++i) {
-                fftBuffer[i] = juce::dsp::Complex<float>(0.0f, 0.0f);
-            }
-            
-            // Forward FFT
-            fft.perform(fftBuffer, fftBuffer + fftSize, false);
-            
-            // Spectral subtraction
-            for (int i = 0; i < fftSize / 2; ++i) {
-                float magnitude = std::sqrt(fftBuffer[i].real() * fftBuffer[i].real() + 
-                                          fftBuffer[i].imag() * fftBuffer[i].imag());
-                float phase = std::atan2(fftBuffer[i].imag(), fftBuffer[i].real());
-                
-                // Subtract noise floor
-                magnitude = juce::jmax(0.0f, magnitude - noiseFloor);
-                
-                // Reconstruct complex number
-                fftBuffer[i].real(magnitude * std::cos(phase));
-                fftBuffer[i].imag(magnitude * std::sin(phase));
-                
-                // Mirror for negative frequencies
-                if (i > 0 && i < fftSize / 2) {
-                    fftBuffer[fftSize - i] = std::conj(fftBuffer[i]);
-                }
-            }
-            
-            // Inverse FFT
-            fft.perform(fftBuffer + fftSize, fftBuffer, true);
+        denoiser.process(block.getArrayOfWritePointers(), numChannels, numSamples);
+        
+        const int skip = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, (juce::int64) latency - fed);
+        const int count = (int) juce::jmin((juce::int64) (numSamples - skip), length - written);
+        if (count > 0) {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = skip; i < skip + count; ++i)
+                    outputEnergy += (double) block.getSample(ch, i) * block.getSample(ch, i);
             
-            // Overlap-add
-            for (int i = 0; i < windowSize && (pos + i) < input.getNumSamples(); ++i) {
-                float window = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::twoPi * i / (windowSize - 1)));
-                outputData[pos + i] += fftBuffer[fftSize + i].real() * window / fftSize;
+            if (!write(block, skip, count)) {
+                result.errorMessage = "Could not write the denoised audio";
+                return result;
             }
+            written += count;
         }
+        fed += numSamples;
         
-        // Calculate noise reduction amount
-        float inputRMS = input.getRMSLevel(channel, 0, input.getNumSamples());
-        float outputRMS = result.denoisedAudio.getRMSLevel(channel, 0, result.denoisedAudio.getNumSamples());
-        result.noiseReductionDb = 20.0f * std::log10(outputRMS / juce::jmax(inputRMS, 0.0001f));
+        if (job != nullptr)
+            job->setProgress((float) written / (float) length);
     }
     
+    result.noiseReductionDb = 10.0f * std::log10((float) juce::jmax(outputEnergy, 1.0e-12) / (float) juce::jmax(inputEnergy, 1.0e-12));
     result.success = true;
     return result;
 }
 
-void DenoiseService::reduceArtifacts(juce::AudioBuffer<float>& buffer) {
-    // Apply gentle smoothing to reduce musical noise artifacts
-    const int smoothingSize = 3;
-    
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-        float* data = buffer.getWritePointer(channel);
-        
-        for (int i = smoothingSize; i < buffer.getNumSamples() - smoothingSize; ++i) {
-            float smoothed = 0.0f;
-            for (int j = -smoothingSize; j <= smoothingSize; ++j) {
-                smoothed += data[i + j];
-            }
-            data[i] = smoothed / (2 * smoothingSize + 1);
-        }
-    }
-}
-
 } // namespace AI
 } // namespace omega
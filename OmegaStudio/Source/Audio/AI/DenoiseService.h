@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include "AIJobQueue.h"
+#include "../DSP/SpectralDenoiser.h"
 #include <functional>
 #include <atomic>
 
@@ -9,9 +10,9 @@ namespace omega {
 namespace AI {
 
 enum class DenoiseQuality {
-    Fast,
-    Balanced,
-    HighQuality
+    Fast,           // ~10 ms frames (live insert latency)
+    Balanced,       // ~20 ms
+    HighQuality     // ~40 ms, finer frequency resolution
 };
 
 struct DenoiseConfig {
@@ -20,11 +21,11 @@ struct DenoiseConfig {
     float reductionAmount = 0.8f; // 0.0 - 1.0
     bool preserveTransients = true;
     bool adaptiveMode = true;
-    juce::File modelPath;
+    juce::File modelPath;           // Learned model (not used by the spectral core yet)
 };
 
 struct DenoiseResult {
-    juce::AudioBuffer<float> denoisedAudio;
+    juce::AudioBuffer<float> denoisedAudio;     // Empty for file processing
     float noiseReductionDb = 0.0f;
     float processingTimeMs = 0.0f;
     bool success = false;
@@ -39,31 +40,40 @@ public:
     void setConfig(const DenoiseConfig& config) { config_ = config; }
     void setModelPath(const juce::File& path) { config_.modelPath = path; }
     
-    // Synchronous processing
-    DenoiseResult processAudio(const juce::AudioBuffer<float>& input);
+    // Synchronous processing (same streaming core as the live DenoiseNode;
+    // the output is aligned with the input)
+    DenoiseResult processAudio(const juce::AudioBuffer<float>& input, AIJobContext* job = nullptr);
     
-    // Asynchronous processing with callback
-    void processAudioAsync(const juce::AudioBuffer<float>& input,
-                          std::function<void(DenoiseResult)> callback);
+    // Streams a file block by block into a WAV: memory does not depend on
+    // the take length. The output replaces an existing file only on success
+    DenoiseResult processFile(const juce::File& input, const juce::File& output, AIJobContext* job = nullptr);
+    
+    // Asynchronous processing with callback (called on the worker thread)
+    AIJobHandle processAudioAsync(const juce::AudioBuffer<float>& input,
+                                  std::function<void(DenoiseResult)> callback);
+    AIJobHandle processFileAsync(const juce::File& input, const juce::File& output,
+                                 std::function<void(DenoiseResult)> callback);
     
     // Cancel ongoing operations
     void cancelAll();
     
-    bool isProcessing() const { return isProcessing_.load(); }
+    bool isProcessing() const { return activeJobs_.load() > 0; }
+    
+    static int getFftSize(DenoiseQuality quality, double sampleRate);
     
 private:
-    DenoiseConfig config_;
-    std::atomic<bool> isProcessing_{false};
-    std::unique_ptr<AIJobQueue> jobQueue_;
+    using BlockReader = std::function<void(juce::AudioBuffer<float>& block, juce::int64 start, int numSamples)>;   // Zero past the end
+    using BlockWriter = std::function<bool(const juce::AudioBuffer<float>& block, int start, int numSamples)>;
     
-    // RNNoise-based denoising algorithm
-    DenoiseResult applyRNNoise(const juce::AudioBuffer<float>& input);
+    static constexpr int kBlockSize = 4096;
     
-    // Spectral subtraction fallback
-    DenoiseResult applySpectralSubtraction(const juce::AudioBuffer<float>& input);
+    DenoiseConfig config_;
+    std::atomic<int> activeJobs_{0};
+    std::unique_ptr<AIJobQueue> jobQueue_;
     
-    // Artifact reduction post-processing
-    void reduceArtifacts(juce::AudioBuffer<float>& buffer);
+    // Learns the first 100 ms, then streams everything through one SpectralDenoiser
+    static DenoiseResult render(const DenoiseConfig& config, double sampleRate, int numChannels, juce::int64 length,
+                                const BlockReader& read, const BlockWriter& write, AIJobContext* job);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DenoiseService)
 };
@@ -1,16 +1,19 @@
 #include "OnnxRuntimeWrapper.h"
 
-#ifdef ENABLE_ORT
- #include <onnxruntime_cxx_api.h>
-#endif
-
 namespace omega {
 namespace AI {
 
+namespace {
+// Fixed model dimension, or 0 when dynamic (-1) or absent
+int fixedDimension(const std::vector<int64_t>& shape, size_t index) {
+    return index < shape.size() && shape[index] > 0 ? (int) shape[index] : 0;
+}
+}
+
 OnnxStemSession::OnnxStemSession() = default;
 OnnxStemSession::~OnnxStemSession() = default;
 
-bool OnnxStemSession::loadModel(const juce::File& modelPath) {
+bool OnnxStemSession::loadModel(const juce::File& modelPath, const OnnxSessionOptions& sessionOptions) {
 #ifdef ENABLE_ORT
     if (!modelPath.existsAsFile())
         return false;
@@ -18,7 +21,10 @@ bool OnnxStemSession::loadModel(const juce::File& modelPath) {
     try {
         env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "OmegaStudio");
         options = std::make_unique<Ort::SessionOptions>();
-        options->SetIntraOpNumThreads(4);
+        options->SetIntraOpNumThreads(sessionOptions.intraOpThreads);
+        options->SetInterOpNumThreads(sessionOptions.interOpThreads);
+        options->SetExecutionMode(sessionOptions.interOpThreads > 1 ? ExecutionMode::ORT_PARALLEL
+                                                                    : ExecutionMode::ORT_SEQUENTIAL);
         options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
 
         auto utf8 = modelPath.getFullPathName().toStdString();
@@ -28,25 +34,28 @@ bool OnnxStemSession::loadModel(const juce::File& modelPath) {
         Ort::AllocatorWithDefaultOptions allocator;
         size_t inputCount = session->GetInputCount();
         size_t outputCount = session->GetOutputCount();
+        nameStorage.clear();
         inputNames.clear();
         outputNames.clear();
         if (inputCount > 0) {
-            inputNames.push_back(session->GetInputNameAllocated(0, allocator).release());
+            nameStorage.push_back(session->GetInputNameAllocated(0, allocator));
+            inputNames.push_back(nameStorage.back().get());
             auto typeInfo = session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo();
             inputShape = typeInfo.GetShape();
         }
         if (outputCount > 0) {
-            outputNames.push_back(session->GetOutputNameAllocated(0, allocator).release());
+            nameStorage.push_back(session->GetOutputNameAllocated(0, allocator));
+            outputNames.push_back(nameStorage.back().get());
             auto typeInfo = session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo();
             outputShape = typeInfo.GetShape();
         }
-        return true;
+        return !inputNames.empty() && !outputNames.empty();
     } catch (const Ort::Exception&) {
         session.reset();
         return false;
     }
 #else
-    juce::ignoreUnused(modelPath);
+    juce::ignoreUnused(modelPath, sessionOptions);
     return false;
 #endif
 }
@@ -59,66 +68,85 @@ bool OnnxStemSession::isLoaded() const {
 #endif
 }
 
-OnnxInferenceResult OnnxStemSession::run(const juce::AudioBuffer<float>& input,
-                                         std::function<void(float)> progress) {
-    OnnxInferenceResult result;
+int OnnxStemSession::getNumStems() const {
 #ifdef ENABLE_ORT
-    if (!session) return result;
-
-    const int numChannels = input.getNumChannels();
-    const int numSamples = input.getNumSamples();
-    if (numChannels <= 0 || numSamples <= 0) return result;
-
-    // Flatten interleaved tensor [1, numSamples, numChannels] or [1, channels, samples]
-    std::vector<float> interleaved;
-    interleaved.reserve(static_cast<size_t>(numChannels * numSamples));
-    for (int i = 0; i < numSamples; ++i)
-        for (int ch = 0; ch < numChannels; ++ch)
-            interleaved.push_back(input.getSample(ch, i));
-
-    std::vector<int64_t> shape{1, numChannels, numSamples};
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(memInfo, interleaved.data(), interleaved.size(), shape.data(), shape.size());
-
-    auto output = session->Run(Ort::RunOptions{nullptr}, inputNames.data(), &inputTensor, 1, outputNames.data(), outputNames.size());
-    if (output.empty() || !output[0].IsTensor()) return result;
-
-    auto& outTensor = output[0];
-    auto info = outTensor.GetTensorTypeAndShapeInfo();
-    auto outShape = info.GetShape(); // Expect [1, stems, channels, samples]
-    if (outShape.size() < 4) return result;
-
-    const int64_t stems = outShape[1];
-    const int64_t channels = outShape[2];
-    const int64_t samples = outShape[3];
-    const float* data = outTensor.GetTensorData<float>();
-
-    // Map stem index to name
-    auto stemName = [&](int idx) {
-        switch (idx) {
-            case 0: return juce::String("vocals");
-            case 1: return juce::String("drums");
-            case 2: return juce::String("bass");
-            case 3: return juce::String("other");
-            default: return juce::String("stem") + juce::String(idx);
-        }
-    };
-
-    size_t cursor = 0;
-    for (int64_t s = 0; s < stems; ++s) {
-        juce::AudioBuffer<float> buf((int) channels, (int) samples);
-        for (int64_t c = 0; c < channels; ++c) {
-            for (int64_t i = 0; i < samples; ++i) {
-                buf.setSample((int) c, (int) i, data[cursor++]);
-            }
-        }
-        result.stems[stemName((int)s)] = std::move(buf);
-        if (progress) progress(static_cast<float>(s + 1) / (float) stems);
+    const int stems = fixedDimension(outputShape, 1);
+    return stems > 0 ? stems : 4;   // vocals, drums, bass, other
+#else
+    return 0;
+#endif
+}
+
+int OnnxStemSession::getNumChannels() const {
+#ifdef ENABLE_ORT
+    return fixedDimension(inputShape, 1);
+#else
+    return 0;
+#endif
+}
+
+int OnnxStemSession::getWindowLength() const {
+#ifdef ENABLE_ORT
+    return fixedDimension(inputShape, 2);
+#else
+    return 0;
+#endif
+}
+
+int OnnxStemSession::getMaxBatchSize() const {
+#ifdef ENABLE_ORT
+    return fixedDimension(inputShape, 0);
+#else
+    return 0;
+#endif
+}
+
+bool OnnxStemSession::separate(const float* input, int batchSize, int numChannels, int numSamples, float* output) {
+#ifdef ENABLE_ORT
+    if (!session) return false;
+
+    try {
+        const size_t inputSize = (size_t) batchSize * (size_t) numChannels * (size_t) numSamples;
+        std::array<int64_t, 3> shape { batchSize, numChannels, numSamples };
+        Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+        Ort::Value inputTensor = Ort::Value::CreateTensor<float>(memInfo, const_cast<float*>(input), inputSize,
+                                                                 shape.data(), shape.size());
+
+        auto outputs = session->Run(Ort::RunOptions{nullptr}, inputNames.data(), &inputTensor, 1,
+                                    outputNames.data(), outputNames.size());
+        if (outputs.empty() || !outputs[0].IsTensor()) return false;
+
+        // Expect [batch, stems, channels, samples]
+        auto outShape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        if (outShape.size() != 4 || outShape[0] != batchSize || outShape[1] != getNumStems()
+            || outShape[2] != numChannels || outShape[3] != numSamples)
+            return false;
+
+        const float* data = outputs[0].GetTensorData<float>();
+        std::copy(data, data + inputSize * (size_t) getNumStems(), output);
+        return true;
+    } catch (const Ort::Exception&) {
+        return false;
     }
-    result.success = true;
 #else
-    juce::ignoreUnused(input, progress);
+    juce::ignoreUnused(input, batchSize, numChannels, numSamples, output);
+    return false;
 #endif
+}
+
+OnnxInferenceResult OnnxStemSession::run(const juce::AudioBuffer<float>& input,
+                                         std::function<void(float)> progress,
+                                         double sampleRate) {
+    OnnxInferenceResult result;
+    if (!isLoaded() || input.getNumChannels() <= 0 || input.getNumSamples() <= 0)
+        return result;
+
+    // Tensors stay window sized however long the buffer is
+    AIJobContext job;
+    job.onProgress = progress;
+
+    StemSeparationPipeline pipeline(*this);
+    result.success = pipeline.separateBuffer(input, sampleRate, result.stems, &job).success;
     return result;
 }
 
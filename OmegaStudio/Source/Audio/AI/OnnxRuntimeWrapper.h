@@ -1,10 +1,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "StemSeparationPipeline.h"
 #include <functional>
 #include <map>
 #include <vector>
 
+#ifdef ENABLE_ORT
+ #include <onnxruntime_cxx_api.h>
+#endif
+
 namespace omega {
 namespace AI {
 
@@ -13,24 +18,41 @@ struct OnnxInferenceResult {
     bool success = false;
 };
 
-class OnnxStemSession {
+struct OnnxSessionOptions {
+    int intraOpThreads = 4;     // Threads inside one operator
+    int interOpThreads = 1;     // Independent graph branches (> 1 = parallel execution mode)
+};
+
+/**
+ * Stem separation model: input [batch, channels, samples],
+ * output [batch, stems, channels, samples]. Runs are thread-safe, so the
+ * pipeline can keep several batches in flight on one session.
+ */
+class OnnxStemSession : public StemInferenceModel {
 public:
     OnnxStemSession();
-    ~OnnxStemSession();
+    ~OnnxStemSession() override;
 
-    bool loadModel(const juce::File& modelPath);
+    bool loadModel(const juce::File& modelPath, const OnnxSessionOptions& sessionOptions = {});
     bool isLoaded() const;
 
+    /** Whole buffer in overlapping windows (see StemSeparationPipeline) */
     OnnxInferenceResult run(const juce::AudioBuffer<float>& input,
-                            std::function<void(float)> progress = {});
+                            std::function<void(float)> progress = {},
+                            double sampleRate = 44100.0);
+
+    int getNumStems() const override;
+    int getNumChannels() const override;
+    int getWindowLength() const override;
+    int getMaxBatchSize() const override;
+    bool separate(const float* input, int batchSize, int numChannels, int numSamples, float* output) override;
 
 private:
 #ifdef ENABLE_ORT
-    bool prepareIo(const juce::AudioBuffer<float>& input);
-
     std::unique_ptr<Ort::Env> env;
     std::unique_ptr<Ort::SessionOptions> options;
     std::unique_ptr<Ort::Session> session;
+    std::vector<Ort::AllocatedStringPtr> nameStorage;
     std::vector<const char*> inputNames;
     std::vector<const char*> outputNames;
     std::vector<int64_t> inputShape;
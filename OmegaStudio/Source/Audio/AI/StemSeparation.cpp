@@ -19,6 +19,7 @@ inline float clamp01(float v) { return juce::jlimit(0.0f, 1.0f, v); }
 }
 
 StemSeparator::StemSeparator() = default;
+StemSeparator::~StemSeparator() = default;
 
 bool StemSeparator::separateStems(const juce::AudioBuffer<float>& input,
                  std::map<StemType, juce::AudioBuffer<float>>& outputs,
@@ -48,7 +49,7 @@ bool StemSeparator::separateStems(const juce::AudioBuffer<float>& input,
       onnxSession_->loadModel(config_.modelPath);
 
     if (onnxSession_->isLoaded()) {
-      auto res = onnxSession_->run(input, progressCallback);
+      auto res = onnxSession_->run(input, progressCallback, config_.sampleRate);
       if (res.success) {
         for (const auto& [name, buf] : res.stems) {
           auto toStem = [](const juce::String& n) {
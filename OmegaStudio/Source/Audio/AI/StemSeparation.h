@@ -13,10 +13,13 @@
 #include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 
 namespace omega {
 namespace AI {
 
+class OnnxStemSession;
+
 enum class StemType {
   Vocals,
   Drums,
@@ -43,6 +46,7 @@ struct SeparationConfig {
 class StemSeparator {
 public:
   StemSeparator();
+  ~StemSeparator();
 
   void setConfig(const SeparationConfig& config) { config_ = config; }
   void setModelPath(const juce::File& path) { config_.modelPath = path; }
@@ -76,7 +80,6 @@ private:
   std::atomic<float> progress_{0.0f};
 
 #ifdef ENABLE_ORT
-  class OnnxStemSession;
   std::unique_ptr<OnnxStemSession> onnxSession_;
 #endif
 };
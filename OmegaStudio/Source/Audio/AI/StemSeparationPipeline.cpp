@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    StemSeparationPipeline.cpp
+
+  ==============================================================================
+*/
+
+#include "StemSeparationPipeline.h"
+#include <cmath>
+#include <limits>
+
+namespace omega {
+namespace AI {
+
+juce::String StemInferenceModel::getStemName(int stem) const {
+    switch (stem) {
+        case 0: return "vocals";
+        case 1: return "drums";
+        case 2: return "bass";
+        case 3: return "other";
+        default: return "stem" + juce::String(stem);
+    }
+}
+
+namespace {
+size_t batchBytes(int batchSize, int numChannels, int numStems, int windowLength) {
+    // Input and output tensors of one model call
+    return sizeof(float) * (size_t) batchSize * (size_t) numChannels * (size_t) windowLength * (size_t) (1 + numStems);
+}
+
+size_t fixedBytes(int numChannels, int numStems, int windowLength, int overlap) {
+    // Read buffer, mix scratch and the fade-out tails of every stem
+    return sizeof(float) * ((size_t) numChannels * (size_t) windowLength * 2
+                            + (size_t) numStems * (size_t) numChannels * (size_t) overlap);
+}
+}
+
+StemSeparationPipeline::StemSeparationPipeline(StemInferenceModel& model, const StemPipelineConfig& config)
+    : model_(model), config_(config) {}
+
+StemSeparationPipeline::Layout StemSeparationPipeline::makeLayout(int numChannels, double sampleRate) const {
+    Layout layout;
+    layout.numChannels = model_.getNumChannels() > 0 ? model_.getNumChannels() : juce::jmax(1, numChannels);
+    layout.numStems = model_.getNumStems();
+    layout.windowLength = model_.getWindowLength() > 0
+        ? model_.getWindowLength()
+        : juce::jmax(2, juce::roundToInt(config_.windowSeconds * sampleRate));
+    layout.overlap = juce::jlimit(0, layout.windowLength / 2, juce::roundToInt(config_.overlapSeconds * sampleRate));
+    layout.hop = layout.windowLength - layout.overlap;
+
+    const int maxBatch = model_.getMaxBatchSize() > 0 ? model_.getMaxBatchSize() : std::numeric_limits<int>::max();
+    layout.batchSize = juce::jlimit(1, maxBatch, config_.batchSize);
+
+    // Memory cap: smaller batches first, then fewer batches in flight (never below one call)
+    const size_t fixed = fixedBytes(layout.numChannels, layout.numStems, layout.windowLength, layout.overlap);
+    auto perBatch = [&] { return batchBytes(layout.batchSize, layout.numChannels, layout.numStems, layout.windowLength); };
+    while (layout.batchSize > 1 && fixed + perBatch() > config_.maxMemoryBytes)
+        --layout.batchSize;
+
+    const size_t budget = config_.maxMemoryBytes > fixed ? config_.maxMemoryBytes - fixed : 0;
+    layout.batchesInFlight = juce::jlimit(1, juce::jmax(1, config_.maxBatchesInFlight), (int) juce::jmin(budget / perBatch(), (size_t) 1024));
+    return layout;
+}
+
+size_t StemSeparationPipeline::getWorkingMemoryBytes(int numChannels, double sampleRate) const {
+    const auto layout = makeLayout(numChannels, sampleRate);
+    return fixedBytes(layout.numChannels, layout.numStems, layout.windowLength, layout.overlap)
+         + (size_t) layout.batchesInFlight * batchBytes(layout.batchSize, layout.numChannels, layout.numStems, layout.windowLength);
+}
+
+StemPipelineResult StemSeparationPipeline::run(const Source& source, const Layout& layout,
+                                               const StemWriter& write, AIJobContext* job) {
+    StemPipelineResult result;
+    result.numSamples = source.length;
+
+    if (layout.numStems <= 0) {
+        result.errorMessage = "Model reports no stems";
+        return result;
+    }
+    if (source.length <= 0 || source.numChannels <= 0) {
+        result.errorMessage = "Empty input";
+        return result;
+    }
+
+    const int numChannels = layout.numChannels, numStems = layout.numStems;
+    const int window = layout.windowLength, overlap = layout.overlap, hop = layout.hop;
+    const int batchSize = layout.batchSize, inFlight = layout.batchesInFlight;
+    const size_t windowInput = (size_t) numChannels * (size_t) window;
+    const size_t windowOutput = windowInput * (size_t) numStems;
+
+    // Window k covers [k * hop, k * hop + window); the last one is zero padded
+    const juce::int64 numWindows = 1 + (source.length > window ? (source.length - window + hop - 1) / hop : 0);
+    const juce::int64 numBatches = (numWindows + batchSize - 1) / batchSize;
+
+    struct Batch {
+        std::vector<float> input, output;
+        juce::int64 firstWindow = 0;
+        int numWindows = 0;
+        bool ok = false;
+        juce::WaitableEvent done;
+    };
+    std::vector<std::unique_ptr<Batch>> slots;
+    for (int i = 0; i < inFlight; ++i) {
+        slots.push_back(std::make_unique<Batch>());
+        slots.back()->input.resize(windowInput * (size_t) batchSize);
+        slots.back()->output.resize(windowOutput * (size_t) batchSize);
+    }
+
+    juce::AudioBuffer<float> readBuffer(source.numChannels, window);
+    std::vector<float> mix(windowInput);
+    std::vector<const float*> mixChannels((size_t) numChannels);
+    std::vector<float> tails((size_t) numStems * (size_t) numChannels * (size_t) overlap, 0.0f);
+
+    // sin^2 / cos^2 cross-fade: the two windows always sum to one
+    std::vector<float> fadeIn((size_t) overlap);
+    for (int i = 0; i < overlap; ++i) {
+        const double s = std::sin(juce::MathConstants<double>::halfPi * (i + 0.5) / overlap);
+        fadeIn[(size_t) i] = (float) (s * s);
+    }
+
+    auto readWindow = [&](float* tensor, juce::int64 index) {
+        source.read(readBuffer, index * hop);
+        const int sourceChannels = readBuffer.getNumChannels();
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* dest = tensor + (size_t) ch * (size_t) window;
+            if (numChannels == 1 && sourceChannels > 1) {
+                juce::FloatVectorOperations::clear(dest, window);
+                for (int s = 0; s < sourceChannels; ++s)
+                    juce::FloatVectorOperations::addWithMultiply(dest, readBuffer.getReadPointer(s), 1.0f / (float) sourceChannels, window);
+            } else {
+                juce::FloatVectorOperations::copy(dest, readBuffer.getReadPointer(juce::jmin(ch, sourceChannels - 1)), window);
+            }
+        }
+    };
+
+    // Emits [index * hop, index * hop + hop) (up to the end for the last window)
+    auto writeWindow = [&](const float* stems, juce::int64 index) {
+        const bool first = index == 0, last = index == numWindows - 1;
+        const int count = last ? (int) (source.length - index * hop) : hop;
+        const int faded = juce::jmin(overlap, count);
+
+        for (int stem = 0; stem < numStems; ++stem) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const float* y = stems + ((size_t) stem * (size_t) numChannels + (size_t) ch) * (size_t) window;
+                float* tail = tails.data() + ((size_t) stem * (size_t) numChannels + (size_t) ch) * (size_t) overlap;
+                float* out = mix.data() + (size_t) ch * (size_t) window;
+
+                juce::FloatVectorOperations::copy(out, y, count);
+                if (!first) {
+                    for (int i = 0; i < faded; ++i)
+                        out[i] = y[i] * fadeIn[(size_t) i] + tail[i];
+                }
+                if (!last) {
+                    for (int i = 0; i < overlap; ++i)
+                        tail[i] = y[hop + i] * (1.0f - fadeIn[(size_t) i]);
+                }
+                mixChannels[(size_t) ch] = out;
+            }
+            if (!write(stem, mixChannels.data(), count))
+                return false;
+        }
+        return true;
+    };
+
+    // Batches are read and written in order here; the model runs up to inFlight of them at once
+    juce::ThreadPool pool(inFlight);
+    juce::int64 submitted = 0, completed = 0;
+    bool failed = false;
+    auto stopRequested = [&] { return failed || (job != nullptr && job->isCancelled()); };
+
+    while (completed < numBatches) {
+        while (submitted < numBatches && submitted - completed < inFlight && !stopRequested()) {
+            auto& batch = *slots[(size_t) (submitted % inFlight)];
+            batch.firstWindow = submitted * batchSize;
+            batch.numWindows = (int) juce::jmin((juce::int64) batchSize, numWindows - batch.firstWindow);
+            for (int w = 0; w < batch.numWindows; ++w)
+                readWindow(batch.input.data() + (size_t) w * windowInput, batch.firstWindow + w);
+            // Models with a fixed batch dimension get full batches
+            std::fill(batch.input.begin() + (std::ptrdiff_t) ((size_t) batch.numWindows * windowInput), batch.input.end(), 0.0f);
+
+            pool.addJob([this, &batch, batchSize, numChannels, window] {
+                batch.ok = model_.separate(batch.input.data(), batchSize, numChannels, window, batch.output.data());
+                batch.done.signal();
+            });
+            ++submitted;
+        }
+
+        if (completed == submitted)
+            break;
+
+        auto& batch = *slots[(size_t) (completed % inFlight)];
+        batch.done.wait();
+        ++completed;
+
+        if (stopRequested())
+            continue;   // Drain what is still running
+
+        if (!batch.ok) {
+            failed = true;
+            result.errorMessage = "Model inference failed";
+            continue;
+        }
+
+        for (int w = 0; w < batch.numWindows && !failed; ++w) {
+            if (!writeWindow(batch.output.data() + (size_t) w * windowOutput, batch.firstWindow + w)) {
+                failed = true;
+                result.errorMessage = "Could not write stems";
+            }
+        }
+
+        if (job != nullptr)
+            job->setProgress((float) completed / (float) numBatches);
+    }
+
+    result.cancelled = job != nullptr && job->isCancelled();
+    result.success = !failed && !result.cancelled;
+    if (result.cancelled && result.errorMessage.isEmpty())
+        result.errorMessage = "Cancelled";
+    return result;
+}
+
+StemPipelineResult StemSeparationPipeline::separateFile(const juce::File& input, const juce::File& outputDirectory,
+                                                        AIJobContext* job) {
+    StemPipelineResult result;
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+    if (reader == nullptr) {
+        result.errorMessage = "Could not read " + input.getFileName();
+        return result;
+    }
+
+    const auto layout = makeLayout((int) reader->numChannels, reader->sampleRate);
+    if (!outputDirectory.createDirectory()) {
+        result.errorMessage = "Could not create " + outputDirectory.getFullPathName();
+        return result;
+    }
+
+    // Stems go to temporary files first: a cancelled or failed run leaves no partial stems
+    juce::WavAudioFormat wavFormat;
+    std::vector<std::unique_ptr<juce::TemporaryFile>> temporaries;
+    std::vector<std::unique_ptr<juce::AudioFormatWriter>> writers;
+    for (int stem = 0; stem < layout.numStems; ++stem) {
+        temporaries.push_back(std::make_unique<juce::TemporaryFile>(
+            outputDirectory.getChildFile(model_.getStemName(stem) + ".wav")));
+
+        std::unique_ptr<juce::FileOutputStream> stream(temporaries.back()->getFile().createOutputStream());
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (stream != nullptr)
+            writer.reset(wavFormat.createWriterFor(stream.get(), reader->sampleRate, (unsigned int) layout.numChannels,
+                                                   config_.bitsPerSample, {}, 0));
+        if (writer == nullptr) {
+            result.errorMessage = "Could not create the " + model_.getStemName(stem) + " stem file";
+            return result;
+        }
+        stream.release();   // Owned by the writer
+        writers.push_back(std::move(writer));
+    }
+
+    Source source;
+    source.numChannels = (int) reader->numChannels;
+    source.length = reader->lengthInSamples;
+    source.read = [&reader](juce::AudioBuffer<float>& window, juce::int64 start) {
+        reader->read(&window, 0, window.getNumSamples(), start, true, true);
+    };
+
+    const int numChannels = layout.numChannels;
+    result = run(source, layout, [&writers, numChannels](int stem, const float* const* channels, int numSamples) {
+        return writers[(size_t) stem]->writeFromFloatArrays(channels, numChannels, numSamples);
+    }, job);
+
+    writers.clear();    // Flush and close before moving into place
+    if (result.success) {
+        for (int stem = 0; stem < layout.numStems; ++stem) {
+            auto& temporary = *temporaries[(size_t) stem];
+            if (!temporary.overwriteTargetFileWithTemporary()) {
+                result.success = false;
+                result.errorMessage = "Could not write " + temporary.getTargetFile().getFullPathName();
+                break;
+            }
+            result.stemFiles[model_.getStemName(stem)] = temporary.getTargetFile();
+        }
+    }
+    return result;
+}
+
+StemPipelineResult StemSeparationPipeline::separateBuffer(const juce::AudioBuffer<float>& input, double sampleRate,
+                                                          std::map<juce::String, juce::AudioBuffer<float>>& stems,
+                                                          AIJobContext* job) {
+    const auto layout = makeLayout(input.getNumChannels(), sampleRate);
+    const int length = input.getNumSamples();
+
+    stems.clear();
+    std::vector<juce::AudioBuffer<float>*> targets;
+    for (int stem = 0; stem < layout.numStems; ++stem) {
+        auto& buffer = stems[model_.getStemName(stem)];
+        buffer.setSize(layout.numChannels, length);
+        targets.push_back(&buffer);
+    }
+    std::vector<int> positions((size_t) layout.numStems, 0);
+
+    Source source;
+    source.numChannels = input.getNumChannels();
+    source.length = length;
+    source.read = [&input, length](juce::AudioBuffer<float>& window, juce::int64 start) {
+        const int available = (int) juce::jlimit((juce::int64) 0, (juce::int64) window.getNumSamples(), length - start);
+        for (int ch = 0; ch < window.getNumChannels(); ++ch) {
+            if (available > 0)
+                window.copyFrom(ch, 0, input.getReadPointer(ch, (int) start), available);
+            if (available < window.getNumSamples())
+                juce::FloatVectorOperations::clear(window.getWritePointer(ch, available), window.getNumSamples() - available);
+        }
+    };
+
+    auto result = run(source, layout, [&](int stem, const float* const* channels, int numSamples) {
+        auto& target = *targets[(size_t) stem];
+        for (int ch = 0; ch < target.getNumChannels(); ++ch)
+            target.copyFrom(ch, positions[(size_t) stem], channels[ch], numSamples);
+        positions[(size_t) stem] += numSamples;
+        return true;
+    }, job);
+
+    if (!result.success)
+        stems.clear();
+    return result;
+}
+
+AIJobHandle StemSeparationPipeline::separateFileAsync(AIJobQueue& queue, const juce::File& input,
+                                                      const juce::File& outputDirectory,
+                                                      std::function<void(const StemPipelineResult&)> onComplete) {
+    return queue.addJob([this, input, outputDirectory, onComplete](AIJobContext& job) {
+        const auto result = separateFile(input, outputDirectory, &job);
+        if (onComplete)
+            onComplete(result);
+    });
+}
+
+} // namespace AI
+} // namespace omega
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    StemSeparationPipeline.h
+    Windowed stem separation with bounded memory: the input is streamed in
+    overlapping windows, batches of windows run on the model concurrently and
+    the cross-faded stems are written out as soon as they are complete
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AIJobQueue.h"
+#include <map>
+#include <vector>
+
+namespace omega {
+namespace AI {
+
+/**
+ * A separation model as the pipeline sees it. separate() may be called from
+ * several threads at once.
+ */
+class StemInferenceModel {
+public:
+    virtual ~StemInferenceModel() = default;
+
+    virtual int getNumStems() const = 0;
+    virtual juce::String getStemName(int stem) const;
+
+    /** Fixed tensor dimensions, or 0 when the model accepts any */
+    virtual int getNumChannels() const { return 0; }
+    virtual int getWindowLength() const { return 0; }
+    virtual int getMaxBatchSize() const { return 0; }
+
+    /**
+     * Separate a batch of windows.
+     * @param input   [batchSize][numChannels][numSamples]
+     * @param output  [batchSize][stems][numChannels][numSamples]
+     */
+    virtual bool separate(const float* input, int batchSize, int numChannels, int numSamples, float* output) = 0;
+};
+
+struct StemPipelineConfig {
+    double windowSeconds = 10.0;        // Used when the model has no fixed window length
+    double overlapSeconds = 1.0;        // Cross-fade between windows (at most half a window)
+    int batchSize = 1;                  // Windows per model call
+    int maxBatchesInFlight = 2;         // Concurrent model calls
+    size_t maxMemoryBytes = 256u << 20; // Caps batches in flight whatever the track length
+    int bitsPerSample = 24;             // Stem files (32 = float)
+};
+
+struct StemPipelineResult {
+    bool success = false;
+    bool cancelled = false;
+    juce::String errorMessage;
+    std::map<juce::String, juce::File> stemFiles;   // separateFile() only
+    juce::int64 numSamples = 0;
+};
+
+class StemSeparationPipeline {
+public:
+    explicit StemSeparationPipeline(StemInferenceModel& model, const StemPipelineConfig& config = {});
+
+    /**
+     * Stream a file from disk and write one WAV per stem into outputDirectory
+     * (<stem name>.wav). Stems replace existing files only on success.
+     */
+    StemPipelineResult separateFile(const juce::File& input, const juce::File& outputDirectory,
+                                    AIJobContext* job = nullptr);
+
+    /** Same processing for audio already in memory */
+    StemPipelineResult separateBuffer(const juce::AudioBuffer<float>& input, double sampleRate,
+                                      std::map<juce::String, juce::AudioBuffer<float>>& stems,
+                                      AIJobContext* job = nullptr);
+
+    /**
+     * Run a file separation on the queue (the pipeline and model must outlive it).
+     * onComplete is called on the worker thread.
+     */
+    AIJobHandle separateFileAsync(AIJobQueue& queue, const juce::File& input, const juce::File& outputDirectory,
+                                  std::function<void(const StemPipelineResult&)> onComplete = {});
+
+    /** Peak working memory for a given channel count: the same for any track length */
+    size_t getWorkingMemoryBytes(int numChannels, double sampleRate) const;
+
+private:
+    struct Layout {
+        int numChannels = 0, numStems = 0;
+        int windowLength = 0, overlap = 0, hop = 0;
+        int batchSize = 1, batchesInFlight = 1;
+    };
+
+    struct Source {
+        int numChannels = 0;
+        juce::int64 length = 0;
+        std::function<void(juce::AudioBuffer<float>& window, juce::int64 start)> read;   // Zero past the end
+    };
+
+    using StemWriter = std::function<bool(int stem, const float* const* channels, int numSamples)>;
+
+    Layout makeLayout(int numChannels, double sampleRate) const;
+    StemPipelineResult run(const Source& source, const Layout& layout, const StemWriter& write, AIJobContext* job);
+
+    StemInferenceModel& model_;
+    StemPipelineConfig config_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StemSeparationPipeline)
+};
+
+} // namespace AI
+} // namespace omega
@@ -118,56 +118,53 @@ void DeEsser::initialize(double sampleRate) {
 
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = 2048;
+    spec.maximumBlockSize = kMaxBlockSize;
     spec.numChannels = 1;
 
     // Initialize bandpass filter for sibilance detection
     m_bandpassFilter.prepare(spec);
     setFrequencyRange(m_lowFreq, m_highFreq);
 
-    // Initialize compressor for reduction
-    m_compressor.prepare(spec);
-    m_compressor.setRatio(4.0f);
-    m_compressor.setAttack(1.0f);
-    m_compressor.setRelease(50.0f);
+    // Detection ballistics (1 ms attack, 50 ms release)
+    m_sidechain.assign(kMaxBlockSize, 0.0f);
+    m_follower.setTimes(sampleRate, 1.0f, 50.0f);
 }
 
 void DeEsser::process(float* buffer, int numSamples) {
-    if (m_amount <= 0.0f) {
+    if (m_amount <= 0.0f || m_sidechain.empty()) {
         return; // Bypass
     }
 
-    // Create JUCE audio block
-    float* channelPointers[] = {buffer};
-    juce::dsp::AudioBlock<float> block(channelPointers, 1, numSamples);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-
-    // Copy for sidechain detection
-    std::vector<float> sidechain(buffer, buffer + numSamples);
-    float* sidechainPointers[] = {sidechain.data()};
-    juce::dsp::AudioBlock<float> sidechainBlock(sidechainPointers, 1, numSamples);
-    juce::dsp::ProcessContextReplacing<float> sidechainContext(sidechainBlock);
-
-    // Filter sidechain to isolate sibilance
-    m_bandpassFilter.process(sidechainContext);
-
-    // Compress based on filtered signal
-    m_compressor.setThreshold(m_threshold);
-    
-    // Apply compression with amount control
-    for (int i = 0; i < numSamples; ++i) {
-        float sibilanceLevel = std::abs(sidechain[i]);
-        
-        if (sibilanceLevel > juce::Decibels::decibelsToGain(m_threshold)) {
-            float reduction = 1.0f - (m_amount * 0.5f);
-            buffer[i] *= reduction;
-        }
+    // 4:1 above the threshold, never deeper than (1 - amount / 2)
+    OmegaStudio::Dynamics::GainCurve::Parameters curve;
+    curve.threshold = m_threshold;
+    curve.ratio = 4.0f;
+    curve.knee = 0.0f;
+    curve.range = -juce::Decibels::gainToDecibels(1.0f - m_amount * 0.5f);
+    m_curve.setParameters(curve);
+
+    float* sidechain = m_sidechain.data();
+    for (int offset = 0; offset < numSamples; offset += kMaxBlockSize) {
+        const int chunk = juce::jmin(kMaxBlockSize, numSamples - offset);
+        float* data = buffer + offset;
+
+        // Filter sidechain to isolate sibilance
+        juce::FloatVectorOperations::copy(sidechain, data, chunk);
+        float* sidechainPointers[] = { sidechain };
+        juce::dsp::AudioBlock<float> sidechainBlock(sidechainPointers, 1, static_cast<size_t>(chunk));
+        m_bandpassFilter.process(juce::dsp::ProcessContextReplacing<float>(sidechainBlock));
+
+        // Envelope -> gain, in place, then applied in one vector pass
+        juce::FloatVectorOperations::abs(sidechain, sidechain, chunk);
+        m_follower.process(sidechain, sidechain, chunk);
+        m_curve.process(sidechain, sidechain, chunk);
+        juce::FloatVectorOperations::multiply(data, sidechain, chunk);
     }
 }
 
 void DeEsser::reset() {
     m_bandpassFilter.reset();
-    m_compressor.reset();
+    m_follower.reset();
 }
 
 void DeEsser::setFrequencyRange(float lowFreq, float highFreq) {
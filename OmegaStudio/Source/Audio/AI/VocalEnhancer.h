@@ -19,6 +19,7 @@
 #include <memory>
 #include <vector>
 #include "../../Utils/Constants.h"
+#include "../DSP/DynamicsCore.h"
 
 namespace omega {
 
@@ -126,9 +127,13 @@ public:
     void setFrequencyRange(float lowFreq, float highFreq);
 
 private:
+    static constexpr int kMaxBlockSize = 2048;
+
     juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
                                     juce::dsp::IIR::Coefficients<float>> m_bandpassFilter;
-    juce::dsp::Compressor<float> m_compressor;
+    OmegaStudio::Dynamics::EnvelopeFollower m_follower;
+    OmegaStudio::Dynamics::GainCurve m_curve;
+    std::vector<float> m_sidechain;   // Filtered key, then per-sample gain (preallocated)
     
     double m_sampleRate = 48000.0;
     float m_threshold = -20.0f;
@@ -272,32 +272,6 @@ void Vectorscope::clear() {
     points_.clear();
 }
 
-// ============================================================================
-// VisualizationSuite Implementation
-// ============================================================================
-
-VisualizationSuite::VisualizationSuite() {
-    initialize(48000.0);
-}
-
-void VisualizationSuite::initialize(double sampleRate) {
-    goniometer_.initialize(sampleRate);
-    spectrogram_.initialize(sampleRate);
-    vectorscope_.initialize(sampleRate);
-}
-
-void VisualizationSuite::process(const juce::AudioBuffer<float>& buffer) {
-    goniometer_.process(buffer);
-    spectrogram_.process(buffer);
-    vectorscope_.process(buffer);
-}
-
-void VisualizationSuite::clear() {
-    goniometer_.clear();
-    spectrogram_.clear();
-    vectorscope_.clear();
-}
-
 // ============================================================================
 // CorrelationMeter Implementation
 // ============================================================================
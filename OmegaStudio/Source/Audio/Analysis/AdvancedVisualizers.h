@@ -4,6 +4,9 @@
     AdvancedVisualizers.h
     Goniometer, Spectrogram, and advanced visual analysis tools
 
+    None of these run on the audio thread: AnalysisTapService feeds them
+    from a tap (makeStereoAnalyzer, makeSpectrogram) and publishes snapshots.
+
   ==============================================================================
 */
 
@@ -152,39 +155,6 @@ private:
     bool frequencyColoring_ = false;
 };
 
-/**
- * @brief Combined visualization panel
- */
-class VisualizationSuite {
-public:
-    VisualizationSuite();
-    ~VisualizationSuite() = default;
-    
-    void initialize(double sampleRate);
-    void process(const juce::AudioBuffer<float>& buffer);
-    void clear();
-    
-    // Access individual visualizers
-    Goniometer& getGoniometer() { return goniometer_; }
-    Spectrogram& getSpectrogram() { return spectrogram_; }
-    Vectorscope& getVectorscope() { return vectorscope_; }
-    
-    const Goniometer& getGoniometer() const { return goniometer_; }
-    const Spectrogram& getSpectrogram() const { return spectrogram_; }
-    const Vectorscope& getVectorscope() const { return vectorscope_; }
-    
-    // Global settings
-    void setUpdateRate(float hz) { updateRateHz_ = hz; }
-    
-private:
-    Goniometer goniometer_;
-    Spectrogram spectrogram_;
-    Vectorscope vectorscope_;
-    
-    float updateRateHz_ = 30.0f;
-    int updateCounter_ = 0;
-};
-
 /**
  * @brief Phase correlation meter
  */
@@ -0,0 +1,405 @@
+//==============================================================================
+// AnalysisTapService.cpp - Tap service implementation
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#include "AnalysisTapService.h"
+#include "SpectrumAnalyzer.h"
+#include "AdvancedVisualizers.h"
+#include "DynamicRangeAnalyzer.h"
+#include "TonalBalance.h"
+#include "../ReferenceTrack.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace OmegaStudio {
+
+//==============================================================================
+// AnalysisTap
+//==============================================================================
+
+AnalysisTap::AnalysisTap(const juce::String& name, int numChannels, int capacityPow2)
+    : name_(name),
+      numChannels_(juce::jmax(1, numChannels)),
+      capacity_(juce::nextPowerOfTwo(juce::jmax(1024, capacityPow2))),
+      mask_(capacity_ - 1)
+{
+}
+
+void AnalysisTap::allocateRing()
+{
+    // Antes de activar el tap: push() solo toca el ring si lo ve activo
+    if (ring_.getNumSamples() == 0) {
+        ring_.setSize(numChannels_, capacity_);
+        ring_.clear();
+    }
+}
+
+void AnalysisTap::push(const juce::AudioBuffer<float>& buffer) noexcept
+{
+    push(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+}
+
+void AnalysisTap::push(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (!active_.load(std::memory_order_acquire) || numChannels <= 0 || numSamples <= 0)
+        return;
+
+    // Un bloque mayor que el ring: solo interesa el final
+    const int offset = juce::jmax(0, numSamples - capacity_);
+    const int count = numSamples - offset;
+
+    const juce::uint64 write = writePos_.load(std::memory_order_relaxed);
+    const int start = static_cast<int>(write & static_cast<juce::uint64>(mask_));
+    const int first = juce::jmin(count, capacity_ - start);
+
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        // Fuente mono en un tap estéreo: se duplica el último canal
+        const float* src = channels[juce::jmin(ch, numChannels - 1)] + offset;
+        float* dst = ring_.getWritePointer(ch);
+        std::memcpy(dst + start, src, sizeof(float) * static_cast<size_t>(first));
+        if (count > first)
+            std::memcpy(dst, src + first, sizeof(float) * static_cast<size_t>(count - first));
+    }
+
+    writePos_.store(write + static_cast<juce::uint64>(count), std::memory_order_release);
+}
+
+int AnalysisTap::read(juce::AudioBuffer<float>& dest, int maxSamples) noexcept
+{
+    const auto capacity = static_cast<juce::uint64>(capacity_);
+    const auto margin = capacity / 4;   // Bloque que el productor puede estar escribiendo
+
+    juce::uint64 write = writePos_.load(std::memory_order_acquire);
+    if (write - readPos_ > capacity - margin) {
+        const juce::uint64 resync = write - capacity / 2;
+        dropped_.fetch_add(resync - readPos_, std::memory_order_relaxed);
+        readPos_ = resync;
+    }
+
+    const int count = static_cast<int>(juce::jmin<juce::uint64>(write - readPos_,
+        static_cast<juce::uint64>(juce::jmin(maxSamples, dest.getNumSamples()))));
+    if (count <= 0)
+        return 0;
+
+    const int start = static_cast<int>(readPos_ & static_cast<juce::uint64>(mask_));
+    const int first = juce::jmin(count, capacity_ - start);
+    const int channels = juce::jmin(numChannels_, dest.getNumChannels());
+
+    for (int ch = 0; ch < channels; ++ch) {
+        const float* src = ring_.getReadPointer(ch);
+        float* dst = dest.getWritePointer(ch);
+        std::memcpy(dst, src + start, sizeof(float) * static_cast<size_t>(first));
+        if (count > first)
+            std::memcpy(dst + first, src, sizeof(float) * static_cast<size_t>(count - first));
+    }
+
+    // Si el productor alcanzó lo que se copiaba, el bloque no es válido
+    std::atomic_thread_fence(std::memory_order_acquire);
+    write = writePos_.load(std::memory_order_relaxed);
+    if (write - readPos_ > capacity - margin) {
+        const juce::uint64 resync = write - capacity / 2;
+        dropped_.fetch_add(resync - readPos_, std::memory_order_relaxed);
+        readPos_ = resync;
+        return 0;
+    }
+
+    readPos_ += static_cast<juce::uint64>(count);
+    return count;
+}
+
+//==============================================================================
+// AnalysisTapService
+//==============================================================================
+
+AnalysisTapService::AnalysisTapService()
+    : juce::Thread("Analysis Taps")
+{
+    scratch_.setSize(8, chunkSize_);
+}
+
+AnalysisTapService::~AnalysisTapService()
+{
+    stop();
+}
+
+void AnalysisTapService::prepare(double sampleRate)
+{
+    // Espera a que termine la pasada en curso: el hilo de análisis no procesa
+    // un analizador a medio preparar
+    const juce::ScopedLock al(analysisLock_);
+    const juce::ScopedLock sl(lock_);
+    sampleRate_ = sampleRate;
+
+    for (auto& entry : taps_)
+        for (auto& analyzer : entry.analyzers)
+            analyzer->prepare(sampleRate);
+}
+
+void AnalysisTapService::setRefreshRate(double hz)
+{
+    refreshRate_.store(juce::jlimit(1.0, 240.0, hz));
+}
+
+void AnalysisTapService::start()
+{
+    if (!isThreadRunning())
+        startThread(juce::Thread::Priority::low);
+}
+
+void AnalysisTapService::stop()
+{
+    stopThread(1000);
+}
+
+AnalysisTap* AnalysisTapService::createTap(const juce::String& name, int numChannels, int capacity)
+{
+    auto tap = std::make_unique<AnalysisTap>(name, juce::jlimit(1, scratch_.getNumChannels(), numChannels), capacity);
+    auto* raw = tap.get();
+
+    const juce::ScopedLock sl(lock_);
+    taps_.push_back({ std::move(tap), {} });
+    return raw;
+}
+
+void AnalysisTapService::removeTap(AnalysisTap* tap)
+{
+    // El tap sigue vivo: el hilo de audio puede tener todavía el puntero
+    const juce::ScopedLock sl(lock_);
+    for (auto& entry : taps_) {
+        if (entry.tap.get() == tap) {
+            tap->setActive(false);
+            entry.analyzers.clear();
+        }
+    }
+}
+
+void AnalysisTapService::attach(AnalysisTap* tap, std::shared_ptr<TapAnalyzer> analyzer)
+{
+    if (tap == nullptr || analyzer == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock_);
+    if (sampleRate_ > 0.0)
+        analyzer->prepare(sampleRate_);
+
+    for (auto& entry : taps_) {
+        if (entry.tap.get() == tap) {
+            entry.analyzers.push_back(std::move(analyzer));
+            tap->allocateRing();
+            tap->setActive(true);
+            return;
+        }
+    }
+}
+
+void AnalysisTapService::detach(AnalysisTap* tap, const TapAnalyzer* analyzer)
+{
+    const juce::ScopedLock sl(lock_);
+    for (auto& entry : taps_) {
+        if (entry.tap.get() != tap)
+            continue;
+
+        auto& analyzers = entry.analyzers;
+        analyzers.erase(std::remove_if(analyzers.begin(), analyzers.end(),
+                                       [analyzer](const auto& a) { return a.get() == analyzer; }),
+                        analyzers.end());
+        tap->setActive(!analyzers.empty());
+    }
+}
+
+void AnalysisTapService::run()
+{
+    while (!threadShouldExit())
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        // Bajo lock_ solo se copia la lista: attach/detach/createTap desde el
+        // message thread no esperan a las FFT. Los analizadores quitados mientras
+        // tanto siguen vivos en la copia hasta el final de la pasada
+        {
+            const juce::ScopedLock sl(lock_);
+            running_.clear();
+            for (auto& entry : taps_)
+                if (!entry.analyzers.empty())
+                    running_.push_back({ entry.tap.get(), entry.analyzers });
+        }
+
+        {
+            const juce::ScopedLock sl(analysisLock_);
+            for (auto& entry : running_) {
+                drainTap(*entry.tap, entry.analyzers);
+                for (auto& analyzer : entry.analyzers)
+                    analyzer->publish();
+            }
+        }
+        running_.clear();
+
+        const double periodMs = 1000.0 / refreshRate_.load();
+        const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - start;
+        wait(juce::jmax(1, static_cast<int>(periodMs - elapsedMs)));
+    }
+}
+
+void AnalysisTapService::drainTap(AnalysisTap& tap, const std::vector<std::shared_ptr<TapAnalyzer>>& analyzers)
+{
+    for (int count = tap.read(scratch_, chunkSize_); count > 0; count = tap.read(scratch_, chunkSize_)) {
+        juce::AudioBuffer<float> block(scratch_.getArrayOfWritePointers(), tap.getNumChannels(), count);
+        for (auto& analyzer : analyzers)
+            analyzer->process(block);
+    }
+}
+
+//==============================================================================
+// Adaptadores
+//==============================================================================
+
+std::shared_ptr<SnapshotAnalyzer<LevelSnapshot>> AnalysisTapService::makeLevelMeter(double holdSeconds)
+{
+    struct State {
+        double sampleRate = 48000.0;
+        float peak[2] {}, sumSquares[2] {};
+        int count = 0;
+        LevelSnapshot last;
+        double time = 0.0, holdStart[2] {};
+    };
+    auto state = std::make_shared<State>();
+
+    return std::make_shared<SnapshotAnalyzer<LevelSnapshot>>(
+        [state](double sampleRate) { *state = State(); state->sampleRate = sampleRate; },
+        [state](const juce::AudioBuffer<float>& block) {
+            const int numSamples = block.getNumSamples();
+            for (int ch = 0; ch < juce::jmin(2, block.getNumChannels()); ++ch) {
+                const float* data = block.getReadPointer(ch);
+                for (int i = 0; i < numSamples; ++i) {
+                    state->peak[ch] = juce::jmax(state->peak[ch], std::abs(data[i]));
+                    state->sumSquares[ch] += data[i] * data[i];
+                }
+            }
+            state->count += numSamples;
+            state->time += numSamples / state->sampleRate;
+        },
+        [state, holdSeconds](LevelSnapshot& out) {
+            if (state->count > 0) {
+                auto& last = state->last;
+                for (int ch = 0; ch < 2; ++ch) {
+                    last.peak[ch] = state->peak[ch];
+                    last.rms[ch] = std::sqrt(state->sumSquares[ch] / (float) state->count);
+                    if (last.peak[ch] > last.peakHold[ch] || state->time - state->holdStart[ch] > holdSeconds) {
+                        last.peakHold[ch] = last.peak[ch];
+                        state->holdStart[ch] = state->time;
+                    }
+                    state->peak[ch] = state->sumSquares[ch] = 0.0f;
+                }
+                state->count = 0;
+            }
+            out = state->last;
+        });
+}
+
+std::shared_ptr<SnapshotAnalyzer<SpectrumSnapshot>> AnalysisTapService::makeSpectrumAnalyzer(int fftOrder)
+{
+    auto analyzer = std::make_shared<SpectrumAnalyzer>();
+    auto settings = analyzer->getSettings();
+    settings.fftOrder = fftOrder;
+    analyzer->setSettings(settings);
+
+    return std::make_shared<SnapshotAnalyzer<SpectrumSnapshot>>(
+        [analyzer](double sampleRate) { analyzer->prepare(sampleRate, chunkSize_); },
+        [analyzer](const juce::AudioBuffer<float>& block) { analyzer->pushBuffer(block); },
+        [analyzer](SpectrumSnapshot& out) {
+            out.magnitudes = analyzer->getMagnitudeSpectrum();
+            out.peaks = analyzer->getPeakSpectrum();
+            out.frequencies = analyzer->getFrequencies();
+            out.dominantFrequency = analyzer->getDominantFrequency();
+        });
+}
+
+std::shared_ptr<SnapshotAnalyzer<SpectrogramSnapshot>> AnalysisTapService::makeSpectrogram(int fftSize)
+{
+    auto spectrogram = std::make_shared<omega::Analysis::Spectrogram>();
+
+    return std::make_shared<SnapshotAnalyzer<SpectrogramSnapshot>>(
+        [spectrogram, fftSize](double sampleRate) { spectrogram->initialize(sampleRate, fftSize); },
+        [spectrogram](const juce::AudioBuffer<float>& block) { spectrogram->process(block); },
+        [spectrogram](SpectrogramSnapshot& out) {
+            const auto& lines = spectrogram->getLines();
+            out.lines.resize(lines.size());
+            for (size_t i = 0; i < lines.size(); ++i)
+                out.lines[i] = lines[i].magnitudes;
+        });
+}
+
+std::shared_ptr<SnapshotAnalyzer<StereoSnapshot>> AnalysisTapService::makeStereoAnalyzer()
+{
+    struct State {
+        omega::Analysis::Goniometer goniometer;
+        omega::Analysis::CorrelationMeter correlation;
+    };
+    auto state = std::make_shared<State>();
+
+    return std::make_shared<SnapshotAnalyzer<StereoSnapshot>>(
+        [state](double sampleRate) {
+            state->goniometer.initialize(sampleRate);
+            state->correlation.initialize(sampleRate);
+        },
+        [state](const juce::AudioBuffer<float>& block) {
+            state->goniometer.process(block);
+            state->correlation.process(block);
+        },
+        [state](StereoSnapshot& out) {
+            const auto& points = state->goniometer.getPoints();
+            out.points.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i)
+                out.points[i] = { points[i].x, points[i].y };
+            out.correlation = state->correlation.getInstantaneous();
+            out.shortTermCorrelation = state->correlation.getShortTerm();
+            out.stereoWidth = state->correlation.getStereoWidth();
+        });
+}
+
+std::shared_ptr<SnapshotAnalyzer<LoudnessSnapshot>> AnalysisTapService::makeLoudnessMeter()
+{
+    auto meter = std::make_shared<Audio::LUFSMeter>();
+
+    return std::make_shared<SnapshotAnalyzer<LoudnessSnapshot>>(
+        [meter](double sampleRate) { meter->prepare(sampleRate); },
+        [meter](const juce::AudioBuffer<float>& block) { meter->process(block); },
+        [meter](LoudnessSnapshot& out) {
+            out.momentary = meter->getMomentary();
+            out.shortTerm = meter->getShortTerm();
+            out.integrated = meter->getIntegrated();
+        });
+}
+
+std::shared_ptr<SnapshotAnalyzer<DynamicsSnapshot>> AnalysisTapService::makeDynamicRangeAnalyzer()
+{
+    auto suite = std::make_shared<omega::Analysis::DynamicRangeSuite>();
+
+    return std::make_shared<SnapshotAnalyzer<DynamicsSnapshot>>(
+        [suite](double sampleRate) { suite->initialize(sampleRate); },
+        [suite](const juce::AudioBuffer<float>& block) { suite->process(block); },
+        [suite](DynamicsSnapshot& out) {
+            out.dr14 = suite->getDR14();
+            out.plr = suite->getPLR();
+            out.crestFactor = suite->getCrestFactor();
+        });
+}
+
+std::shared_ptr<SnapshotAnalyzer<TonalBalanceSnapshot>> AnalysisTapService::makeTonalBalanceAnalyzer(int fftSize)
+{
+    auto analyzer = std::make_shared<omega::Analysis::TonalBalanceAnalyzer>();
+
+    return std::make_shared<SnapshotAnalyzer<TonalBalanceSnapshot>>(
+        [analyzer, fftSize](double sampleRate) { analyzer->initialize(sampleRate, fftSize); },
+        [analyzer](const juce::AudioBuffer<float>& block) { analyzer->processBlock(block); },
+        [analyzer](TonalBalanceSnapshot& out) {
+            const auto& result = analyzer->getCurrentResult();
+            out.bandLevels = result.octaveBandLevels;
+            out.difference = result.difference;
+            out.score = result.overallScore;
+        });
+}
+
+} // namespace OmegaStudio
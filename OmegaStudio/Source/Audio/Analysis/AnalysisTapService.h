@@ -0,0 +1,247 @@
+//==============================================================================
+// AnalysisTapService.h - Medidores y analizadores fuera del hilo de audio
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace OmegaStudio {
+
+//==============================================================================
+/** Punto de captura: el hilo de audio solo copia bloques a un ring lock-free
+ *  - Un productor (audio) y un consumidor (hilo de análisis)
+ *  - Si el consumidor se atrasa, salta a lo más reciente y cuenta lo perdido
+ *  - Sin analizadores conectados, push() no copia nada
+ *  - El ring se reserva con el primer analizador: un tap por canal sin nadie
+ *    escuchando apenas ocupa memoria
+ */
+class AnalysisTap {
+public:
+    AnalysisTap(const juce::String& name, int numChannels, int capacityPow2);
+
+    const juce::String& getName() const { return name_; }
+    int getNumChannels() const { return numChannels_; }
+
+    // Hilo de audio (RT-safe: solo memcpy)
+    void push(const juce::AudioBuffer<float>& buffer) noexcept;
+    void push(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Hilo de análisis: copia hasta maxSamples a dest y devuelve cuántos
+    int read(juce::AudioBuffer<float>& dest, int maxSamples) noexcept;
+
+    bool isActive() const noexcept { return active_.load(std::memory_order_relaxed); }
+    juce::uint64 getDroppedSamples() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    friend class AnalysisTapService;
+    void allocateRing();
+    void setActive(bool shouldBeActive) noexcept { active_.store(shouldBeActive, std::memory_order_release); }
+
+    juce::String name_;
+    int numChannels_;
+    int capacity_;
+    int mask_;
+    juce::AudioBuffer<float> ring_;
+
+    std::atomic<juce::uint64> writePos_ { 0 };
+    juce::uint64 readPos_ = 0;                  // Solo el consumidor
+    std::atomic<juce::uint64> dropped_ { 0 };
+    std::atomic<bool> active_ { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisTap)
+};
+
+//==============================================================================
+/** Resultado publicado con doble buffer
+ *  - El hilo de análisis escribe el buffer trasero y lo intercambia
+ *  - Si la UI todavía copia ese buffer, se salta la publicación (frame perdido)
+ */
+template <typename T>
+class DoubleBufferedSnapshot {
+public:
+    template <typename Fill>
+    bool publish(Fill&& fill) {
+        const int back = 1 - front_.load();
+        if (readers_[back].load() > 0)
+            return false;
+
+        fill(slots_[back]);
+        front_.store(back);
+        version_.fetch_add(1);
+        return true;
+    }
+
+    T read() const {
+        for (;;) {
+            const int index = front_.load();
+            readers_[index].fetch_add(1);
+            if (front_.load() == index) {
+                T copy = slots_[index];
+                readers_[index].fetch_sub(1);
+                return copy;
+            }
+            readers_[index].fetch_sub(1);
+        }
+    }
+
+    // Cambia en cada publicación: la UI puede evitar repintar si no hay datos nuevos
+    juce::uint64 getVersion() const { return version_.load(); }
+
+private:
+    T slots_[2] {};
+    std::atomic<int> front_ { 0 };
+    mutable std::atomic<int> readers_[2] { { 0 }, { 0 } };
+    std::atomic<juce::uint64> version_ { 0 };
+};
+
+//==============================================================================
+/** Analizador conectado a un tap. Todo corre en el hilo de análisis. */
+class TapAnalyzer {
+public:
+    virtual ~TapAnalyzer() = default;
+
+    virtual void prepare(double sampleRate) = 0;
+    virtual void process(const juce::AudioBuffer<float>& block) = 0;
+    virtual void publish() = 0;                 // A la tasa de refresco de la UI
+};
+
+/** Envuelve un medidor existente: process() lo alimenta y capture() llena el snapshot */
+template <typename Result>
+class SnapshotAnalyzer : public TapAnalyzer {
+public:
+    using PrepareFn = std::function<void(double)>;
+    using ProcessFn = std::function<void(const juce::AudioBuffer<float>&)>;
+    using CaptureFn = std::function<void(Result&)>;
+
+    SnapshotAnalyzer(PrepareFn prepareFn, ProcessFn processFn, CaptureFn captureFn)
+        : prepare_(std::move(prepareFn)), process_(std::move(processFn)), capture_(std::move(captureFn)) {}
+
+    void prepare(double sampleRate) override { if (prepare_) prepare_(sampleRate); }
+    void process(const juce::AudioBuffer<float>& block) override { process_(block); }
+    void publish() override { snapshot_.publish(capture_); }
+
+    // Cualquier hilo (UI)
+    Result getLatest() const { return snapshot_.read(); }
+    juce::uint64 getVersion() const { return snapshot_.getVersion(); }
+
+private:
+    PrepareFn prepare_;
+    ProcessFn process_;
+    CaptureFn capture_;
+    DoubleBufferedSnapshot<Result> snapshot_;
+};
+
+//==============================================================================
+// Snapshots de los analizadores del proyecto
+
+struct LevelSnapshot {
+    float peak[2] { 0.0f, 0.0f };
+    float rms[2] { 0.0f, 0.0f };
+    float peakHold[2] { 0.0f, 0.0f };
+};
+
+struct SpectrumSnapshot {
+    std::vector<float> magnitudes;      // dB por banda
+    std::vector<float> peaks;
+    std::vector<float> frequencies;
+    float dominantFrequency = 0.0f;
+};
+
+struct SpectrogramSnapshot {
+    std::vector<std::vector<float>> lines;  // dB, la más reciente primero
+};
+
+struct StereoSnapshot {
+    struct Point { float x, y; };
+    std::vector<Point> points;          // Goniómetro
+    float correlation = 0.0f;
+    float shortTermCorrelation = 0.0f;
+    float stereoWidth = 0.0f;
+};
+
+struct LoudnessSnapshot {
+    float momentary = -70.0f;
+    float shortTerm = -70.0f;
+    float integrated = -70.0f;
+};
+
+struct DynamicsSnapshot {
+    float dr14 = 0.0f;
+    float plr = 0.0f;
+    float crestFactor = 0.0f;
+};
+
+struct TonalBalanceSnapshot {
+    std::vector<float> bandLevels;      // dB por 1/3 de octava
+    std::vector<float> difference;      // dB respecto a la curva objetivo
+    float score = 0.0f;
+};
+
+//==============================================================================
+/** Servicio de análisis
+ *  - El hilo de audio solo llama AnalysisTap::push()
+ *  - Un hilo de baja prioridad drena los taps y alimenta los analizadores
+ *  - Los resultados se publican a la tasa de refresco de la UI
+ */
+class AnalysisTapService : private juce::Thread {
+public:
+    AnalysisTapService();
+    ~AnalysisTapService() override;
+
+    // Setup (message thread)
+    void prepare(double sampleRate);
+    void setRefreshRate(double hz);
+    void start();
+    void stop();
+
+    // Taps: viven hasta que se destruye el servicio (el audio puede seguir empujando)
+    AnalysisTap* createTap(const juce::String& name, int numChannels = 2, int capacity = 1 << 15);
+    void removeTap(AnalysisTap* tap);
+
+    // Analizadores
+    void attach(AnalysisTap* tap, std::shared_ptr<TapAnalyzer> analyzer);
+    void detach(AnalysisTap* tap, const TapAnalyzer* analyzer);
+
+    // Adaptadores para los medidores existentes
+    static std::shared_ptr<SnapshotAnalyzer<LevelSnapshot>> makeLevelMeter(double holdSeconds = 2.0);
+    static std::shared_ptr<SnapshotAnalyzer<SpectrumSnapshot>> makeSpectrumAnalyzer(int fftOrder = 13);
+    static std::shared_ptr<SnapshotAnalyzer<SpectrogramSnapshot>> makeSpectrogram(int fftSize = 2048);
+    static std::shared_ptr<SnapshotAnalyzer<StereoSnapshot>> makeStereoAnalyzer();
+    static std::shared_ptr<SnapshotAnalyzer<LoudnessSnapshot>> makeLoudnessMeter();
+    static std::shared_ptr<SnapshotAnalyzer<DynamicsSnapshot>> makeDynamicRangeAnalyzer();
+    static std::shared_ptr<SnapshotAnalyzer<TonalBalanceSnapshot>> makeTonalBalanceAnalyzer(int fftSize = 8192);
+
+private:
+    struct TapEntry {
+        std::unique_ptr<AnalysisTap> tap;
+        std::vector<std::shared_ptr<TapAnalyzer>> analyzers;
+    };
+
+    struct RunningTap {
+        AnalysisTap* tap;
+        std::vector<std::shared_ptr<TapAnalyzer>> analyzers;
+    };
+
+    void run() override;
+    void drainTap(AnalysisTap& tap, const std::vector<std::shared_ptr<TapAnalyzer>>& analyzers);
+
+    static constexpr int chunkSize_ = 4096;
+
+    juce::CriticalSection lock_;                // Lista de taps: message thread <-> hilo de análisis
+    juce::CriticalSection analysisLock_;        // Pasada de análisis <-> prepare()
+    std::vector<TapEntry> taps_;
+    std::vector<RunningTap> running_;           // Copia de la lista para la pasada en curso
+    juce::AudioBuffer<float> scratch_;
+    double sampleRate_ = 0.0;
+    std::atomic<double> refreshRate_ { 30.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisTapService)
+};
+
+} // namespace OmegaStudio
@@ -0,0 +1,828 @@
+/**
+ * @file AudioFeatureStore.cpp
+ * @brief Implementation of the audio feature store
+ */
+
+#include "AudioFeatureStore.h"
+#include "LoudnessMeter.h"
+#include "../DSP/OnsetDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_set>
+
+namespace omega {
+namespace Analysis {
+
+namespace {
+
+constexpr int kFileMagic = 0x4f464653;          // "OFFS"
+constexpr int kFileVersion = 2;                 // 2: onsets from the shared OnsetDetector
+constexpr int kIndexVersion = 1;
+constexpr int kReadChunkSize = 65536;
+
+constexpr float kMinBpm = 60.0f;
+constexpr float kMaxBpm = 200.0f;
+constexpr float kPreferredBpm = 120.0f;         // Resolves octave ambiguity towards the usual range
+constexpr float kChromaMinHz = 55.0f;
+constexpr float kChromaMaxHz = 2000.0f;
+constexpr float kMinKeyCorrelation = 0.5f;      // Below this (drums, noise) the key stays unknown
+
+// Krumhansl-Kessler key profiles
+constexpr std::array<float, 12> kMajorProfile = {
+    6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f
+};
+constexpr std::array<float, 12> kMinorProfile = {
+    6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f
+};
+
+/** 64-bit FNV-1a over every sample (interleaved order, so chunking doesn't matter) */
+class ContentHash {
+public:
+    ContentHash(int numChannels, int64_t length, double sampleRate) {
+        add((uint64_t) numChannels);
+        add((uint64_t) length);
+        uint64_t rateBits;
+        std::memcpy(&rateBits, &sampleRate, sizeof(rateBits));
+        add(rateBits);
+    }
+
+    void add(const float* const* channels, int numChannels, int numSamples) {
+        for (int i = 0; i < numSamples; ++i) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                uint32_t bits;
+                std::memcpy(&bits, channels[ch] + i, sizeof(bits));
+                add(bits);
+            }
+        }
+    }
+
+    uint64_t get() const {
+        // Final avalanche so nearby inputs spread over the whole key
+        uint64_t h = m_hash;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+private:
+    void add(uint64_t value) {
+        m_hash ^= value;
+        m_hash *= 0x100000001b3ull;
+    }
+
+    uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+float powerToDecibels(double power) {
+    return power > 0.0 ? (float) (10.0 * std::log10(power)) : -100.0f;
+}
+
+} // namespace
+
+//==============================================================================
+// AudioFeatureSummary / AudioFeatures
+//==============================================================================
+
+juce::String AudioFeatureSummary::getKeyName() const {
+    static const char* names[] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+    if (key < 0 || key >= 12)
+        return {};
+    return juce::String(names[key]) + (minor ? "m" : "");
+}
+
+std::vector<AudioFeatures::Onset> AudioFeatures::selectOnsets(float minStrength, int64_t minSpacing) const {
+    std::vector<Onset> selected;
+
+    for (const auto& onset : onsets) {
+        if (onset.strength < minStrength)
+            continue;
+
+        if (!selected.empty() && onset.position - selected.back().position < minSpacing) {
+            if (onset.strength > selected.back().strength)
+                selected.back() = onset;
+            continue;
+        }
+
+        selected.push_back(onset);
+    }
+
+    return selected;
+}
+
+//==============================================================================
+// Analyser: every feature from one streaming pass
+//==============================================================================
+
+/**
+ * Fed the decoded audio chunk by chunk. Onsets and the flux envelope the tempo
+ * is estimated from come from the shared OnsetDetector, fed the mono mix.
+ */
+class AudioFeatureStore::Analyser {
+public:
+    Analyser(double sampleRate, int numChannels, int64_t length)
+        : m_sampleRate(sampleRate),
+          m_numChannels(juce::jmax(1, numChannels)),
+          m_length(length),
+          m_hash(numChannels, length, sampleRate),
+          m_spectrumFft(12) {
+        static_assert(AudioFeatures::kSpectrumFftSize == 1 << 12, "spectrum FFT order");
+
+        OnsetDetector::Settings onsetSettings;
+        onsetSettings.fftSize = AudioFeatures::kOnsetFftSize;
+        onsetSettings.hopSize = AudioFeatures::kOnsetHopSize;
+        m_onsetDetector.initialize(sampleRate, onsetSettings);
+
+        // Normalized JUCE Hann, as ReferenceTrackMatcher uses (window sum = size)
+        auto makeHann = [](int size) {
+            std::vector<float> window((size_t) size);
+            juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) size,
+                                                                     juce::dsp::WindowingFunction<float>::hann, true);
+            return window;
+        };
+        m_spectrumWindow = makeHann(AudioFeatures::kSpectrumFftSize);
+        m_fftBuffer.resize((size_t) AudioFeatures::kSpectrumFftSize * 2);
+
+        m_powerSum.assign((size_t) AudioFeatures::kSpectrumFftSize / 2, 0.0);
+
+        m_loudness.prepare(sampleRate, m_numChannels, false);
+
+        if (m_length > 0)
+            m_envelope.reserve((size_t) (m_length / AudioFeatures::kOnsetHopSize + 2));
+    }
+
+    void push(const float* const* channels, int numSamples) {
+        juce::ScopedNoDenormals noDenormals;     // Filters ringing out into silence
+        m_hash.add(channels, m_numChannels, numSamples);
+
+        const size_t offset = m_pending.size();
+        m_pending.resize(offset + (size_t) numSamples);
+        float* mono = m_pending.data() + offset;
+        const float channelGain = 1.0f / (float) m_numChannels;
+
+        juce::FloatVectorOperations::clear(mono, numSamples);
+        for (int ch = 0; ch < m_numChannels; ++ch) {
+            const float* data = channels[ch];
+            juce::FloatVectorOperations::addWithMultiply(mono, data, channelGain, numSamples);
+
+            auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+            m_peak = juce::jmax(m_peak, std::abs(range.getStart()), std::abs(range.getEnd()));
+        }
+
+        m_onsetDetector.push(mono, numSamples,
+                             [this](const Onset& onset) { m_onsets.push_back(onset); },
+                             [this](float flux) { m_envelope.push_back(flux); });
+
+        // Loudness (shared BS.1770 engine) and RMS
+        m_loudness.process(channels, m_numChannels, numSamples);
+        for (int ch = 0; ch < m_numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                m_sumOfSquares += (double) channels[ch][i] * channels[ch][i];
+
+        m_numSamples += numSamples;
+        processFrames();
+    }
+
+    AudioFeatures finish() {
+        // Last partial hop, and at least one spectrum frame for very short audio
+        m_onsetDetector.finish([this](const Onset& onset) { m_onsets.push_back(onset); },
+                               [this](float flux) { m_envelope.push_back(flux); });
+        const int64_t end = m_pendingStart + (int64_t) m_pending.size();
+        if (m_spectrumFrames == 0 && m_numSamples > 0 && end < AudioFeatures::kSpectrumFftSize) {
+            m_pending.resize(m_pending.size() + (size_t) (AudioFeatures::kSpectrumFftSize - end), 0.0f);
+            processFrames();
+        }
+
+        AudioFeatures features;
+        auto& summary = features.summary;
+        summary.contentHash = m_hash.get();
+        summary.sampleRate = m_sampleRate;
+        summary.numChannels = m_numChannels;
+        summary.lengthInSamples = m_numSamples;
+
+        summary.peakDb = juce::Decibels::gainToDecibels(m_peak, -100.0f);
+        if (m_numSamples > 0)
+            summary.rmsDb = powerToDecibels(m_sumOfSquares / ((double) m_numSamples * m_numChannels));
+        summary.integratedLoudness = m_loudness.getIntegrated();
+
+        const float maxFlux = m_envelope.empty() ? 0.0f : *std::max_element(m_envelope.begin(), m_envelope.end());
+        features.onsets.reserve(m_onsets.size());
+        for (const auto& onset : m_onsets)
+            features.onsets.push_back({ onset.getSample(), onset.flux / maxFlux });
+        estimateTempo(features);
+        estimateKey(features);
+
+        features.spectrum.resize(m_powerSum.size());
+        for (size_t k = 0; k < m_powerSum.size(); ++k)
+            features.spectrum[k] = m_spectrumFrames > 0 ? powerToDecibels(m_powerSum[k] / m_spectrumFrames) : -100.0f;
+
+        return features;
+    }
+
+private:
+    void processFrames() {
+        const int64_t end = m_pendingStart + (int64_t) m_pending.size();
+
+        while (m_nextSpectrumFrame + AudioFeatures::kSpectrumFftSize <= end) {
+            analyseSpectrumFrame(m_pending.data() + (m_nextSpectrumFrame - m_pendingStart));
+            m_nextSpectrumFrame += AudioFeatures::kSpectrumFftSize / 2;
+        }
+
+        const int64_t consumed = m_nextSpectrumFrame - m_pendingStart;
+        if (consumed > 0) {
+            m_pending.erase(m_pending.begin(), m_pending.begin() + (ptrdiff_t) consumed);
+            m_pendingStart += consumed;
+        }
+    }
+
+    // Power per bin, same scale as ReferenceTrackMatcher::performFFT
+    void analyseSpectrumFrame(const float* frame) {
+        const int size = AudioFeatures::kSpectrumFftSize;
+        float* data = m_fftBuffer.data();
+
+        juce::FloatVectorOperations::multiply(data, frame, m_spectrumWindow.data(), size);
+        juce::FloatVectorOperations::clear(data + size, size);
+        m_spectrumFft.performFrequencyOnlyForwardTransform(data);
+
+        const int bins = size / 2;
+        for (int k = 0; k < bins; ++k)
+            m_powerSum[(size_t) k] += (double) data[k] * data[k];
+        ++m_spectrumFrames;
+
+        // Chroma from prominent peaks only: leakage and noise don't count,
+        // so clicks and noise give no pitch classes at all
+        const double binWidth = m_sampleRate / size;
+        const int firstBin = juce::jmax(2, (int) (kChromaMinHz / binWidth));
+        const int lastBin = juce::jmin(bins - 3, (int) (kChromaMaxHz / binWidth) + 1);
+        for (int k = firstBin; k <= lastBin; ++k) {
+            const float magnitude = data[k];
+            if (magnitude <= data[k - 1] || magnitude < data[k + 1]
+                || magnitude < 2.0f * data[k - 2] || magnitude < 2.0f * data[k + 2])
+                continue;
+
+            const float left = std::log(data[k - 1] + 1.0e-9f);
+            const float centre = std::log(magnitude + 1.0e-9f);
+            const float right = std::log(data[k + 1] + 1.0e-9f);
+            const float denominator = left - 2.0f * centre + right;
+            const float offset = denominator < 0.0f ? 0.5f * (left - right) / denominator : 0.0f;
+
+            const double frequency = (k + offset) * binWidth;
+            const int note = (int) std::lround(69.0 + 12.0 * std::log2(frequency / 440.0));
+            m_chroma[(size_t) (((note % 12) + 12) % 12)] += magnitude;
+        }
+    }
+
+    // Autocorrelation of the onset envelope, comb-reinforced with the double period
+    void estimateTempo(AudioFeatures& features) const {
+        const int numFrames = (int) m_envelope.size();
+        const double frameRate = m_sampleRate / AudioFeatures::kOnsetHopSize;
+        const int minLag = juce::jmax(1, (int) std::floor(60.0 * frameRate / kMaxBpm));
+        const int maxLag = juce::jmin((int) std::ceil(60.0 * frameRate / kMinBpm), numFrames / 2);
+
+        if (features.onsets.size() < 4 || maxLag <= minLag + 1)
+            return;
+
+        const float mean = std::accumulate(m_envelope.begin(), m_envelope.end(), 0.0f) / (float) numFrames;
+        std::vector<float> centred(m_envelope.size());
+        for (size_t i = 0; i < centred.size(); ++i)
+            centred[i] = m_envelope[i] - mean;
+
+        const int maxAcfLag = juce::jmin(4 * maxLag + 4, numFrames - 1);
+        std::vector<double> acf((size_t) maxAcfLag + 1, 0.0);
+        for (int lag = 0; lag <= maxAcfLag; ++lag) {
+            double sum = 0.0;
+            for (int i = 0; i + lag < numFrames; ++i)
+                sum += (double) centred[(size_t) i] * centred[(size_t) (i + lag)];
+            acf[(size_t) lag] = sum / (numFrames - lag);
+        }
+        if (acf[0] <= 0.0)
+            return;
+
+        int bestLag = -1;
+        double bestScore = 0.0;
+        for (int lag = minLag; lag <= maxLag; ++lag) {
+            double score = acf[(size_t) lag];
+            if (2 * lag <= maxAcfLag)
+                score += 0.5 * acf[(size_t) (2 * lag)];
+
+            const double octaves = std::log2(60.0 * frameRate / lag / kPreferredBpm);
+            score *= std::exp(-0.5 * octaves * octaves);
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestLag = lag;
+            }
+        }
+        if (bestLag < 0 || acf[(size_t) bestLag] <= 0.0)
+            return;
+
+        auto refine = [&](int lag) {
+            if (lag <= 0 || lag >= maxAcfLag)
+                return (double) lag;
+            const double a = acf[(size_t) lag - 1], b = acf[(size_t) lag], c = acf[(size_t) lag + 1];
+            const double denominator = a - 2.0 * b + c;
+            return std::abs(denominator) > 1.0e-12 ? lag + 0.5 * (a - c) / denominator : (double) lag;
+        };
+
+        // The peak at several periods pins the period down more finely
+        double period = refine(bestLag);
+        for (int multiple : { 4, 2 }) {
+            const int centre = juce::roundToInt(multiple * period);
+            if (centre + multiple >= maxAcfLag)
+                continue;
+
+            int peak = centre;
+            for (int lag = centre - multiple; lag <= centre + multiple; ++lag)
+                if (acf[(size_t) lag] > acf[(size_t) peak])
+                    peak = lag;
+            period = refine(peak) / multiple;
+            break;
+        }
+
+        features.summary.bpm = (float) (60.0 * frameRate / period);
+        features.summary.bpmConfidence = (float) juce::jlimit(0.0, 1.0, acf[(size_t) bestLag] / acf[0]);
+    }
+
+    // Chroma against major/minor profiles, all 24 rotations
+    void estimateKey(AudioFeatures& features) const {
+        const float maxChroma = *std::max_element(m_chroma.begin(), m_chroma.end());
+        if (maxChroma <= 0.0f)
+            return;
+
+        for (size_t i = 0; i < 12; ++i)
+            features.chroma[i] = m_chroma[i] / maxChroma;
+
+        auto correlate = [&](const std::array<float, 12>& profile, int tonic) {
+            float meanChroma = 0.0f, meanProfile = 0.0f;
+            for (int i = 0; i < 12; ++i) {
+                meanChroma += features.chroma[(size_t) i];
+                meanProfile += profile[(size_t) i];
+            }
+            meanChroma /= 12.0f;
+            meanProfile /= 12.0f;
+
+            float covariance = 0.0f, varianceChroma = 0.0f, varianceProfile = 0.0f;
+            for (int i = 0; i < 12; ++i) {
+                const float c = features.chroma[(size_t) ((i + tonic) % 12)] - meanChroma;
+                const float p = profile[(size_t) i] - meanProfile;
+                covariance += c * p;
+                varianceChroma += c * c;
+                varianceProfile += p * p;
+            }
+            const float denominator = std::sqrt(varianceChroma * varianceProfile);
+            return denominator > 0.0f ? covariance / denominator : 0.0f;
+        };
+
+        float best = -1.0f;
+        for (int tonic = 0; tonic < 12; ++tonic) {
+            for (bool minor : { false, true }) {
+                const float correlation = correlate(minor ? kMinorProfile : kMajorProfile, tonic);
+                if (correlation > best) {
+                    best = correlation;
+                    features.summary.key = tonic;
+                    features.summary.minor = minor;
+                }
+            }
+        }
+
+        features.summary.keyConfidence = juce::jmax(0.0f, best);
+        if (best < kMinKeyCorrelation) {
+            features.summary.key = -1;
+            features.summary.minor = false;
+        }
+    }
+
+    const double m_sampleRate;
+    const int m_numChannels;
+    const int64_t m_length;
+    ContentHash m_hash;
+
+    OnsetDetector m_onsetDetector;
+    std::vector<Onset> m_onsets;
+    std::vector<float> m_envelope;                  // Onset detection function per hop
+
+    juce::dsp::FFT m_spectrumFft;
+    std::vector<float> m_spectrumWindow;
+    std::vector<float> m_fftBuffer;
+
+    // Mono mix not yet consumed by the spectrum frames; m_pending[0] is at m_pendingStart
+    std::vector<float> m_pending;
+    int64_t m_pendingStart = 0;
+    int64_t m_nextSpectrumFrame = 0;
+    int64_t m_numSamples = 0;
+
+    std::array<float, 12> m_chroma {};
+    std::vector<double> m_powerSum;
+    int m_spectrumFrames = 0;
+
+    LoudnessMeter m_loudness;                       // Integrated only (no true peak)
+
+    double m_sumOfSquares = 0.0;
+    float m_peak = 0.0f;
+};
+
+//==============================================================================
+// AudioFeatureStore
+//==============================================================================
+
+AudioFeatureStore::AudioFeatureStore(const juce::File& directory)
+    : m_directory(directory) {
+    m_formatManager.registerBasicFormats();
+    m_directory.createDirectory();
+    loadIndex();
+    removeOrphanedFeatures();
+    m_threadPool = std::make_unique<juce::ThreadPool>(juce::jmax(1, juce::SystemStats::getNumCpus()));
+}
+
+AudioFeatureStore::~AudioFeatureStore() {
+    m_threadPool->removeAllJobs(true, 10000);
+    m_threadPool.reset();
+    flush();
+}
+
+AudioFeatureStore& AudioFeatureStore::getInstance() {
+    static AudioFeatureStore instance;
+    return instance;
+}
+
+juce::File AudioFeatureStore::getDefaultDirectory() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("OmegaStudio")
+        .getChildFile("FeatureStore");
+}
+
+bool AudioFeatureStore::getCachedSummary(const juce::File& file, AudioFeatureSummary& summary) const {
+    juce::ScopedLock lock(m_lock);
+
+    auto it = m_index.find(file.getFullPathName());
+    if (it == m_index.end()
+        || it->second.fileSize != file.getSize()
+        || it->second.modificationTime != file.getLastModificationTime().toMilliseconds()) {
+        return false;
+    }
+
+    summary = it->second.summary;
+    return true;
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::getFeatures(const juce::File& file) {
+    if (auto features = lookupIndex(file))
+        return features;
+    return analyseFile(file);
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::getFeatures(const juce::File& file,
+                                                                    const juce::AudioBuffer<float>& decoded,
+                                                                    double sampleRate) {
+    if (auto features = lookupIndex(file))
+        return features;
+
+    auto features = getFeatures(decoded, sampleRate);
+    if (features) {
+        addToIndex(file, features->summary);
+        persist(*features);     // It may have been analysed as memory-only audio
+    }
+    return features;
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::getFeatures(const juce::AudioBuffer<float>& buffer,
+                                                                    double sampleRate) {
+    if (buffer.getNumChannels() == 0 || buffer.getNumSamples() == 0 || sampleRate <= 0.0)
+        return nullptr;
+
+    if (auto features = findByHash(hashContent(buffer, sampleRate)))
+        return features;
+
+    return store(analyse(buffer, sampleRate), false);
+}
+
+void AudioFeatureStore::analyseInBackground(const juce::Array<juce::File>& files,
+                                            std::function<void()> onFinished) {
+    if (files.isEmpty()) {
+        if (onFinished)
+            onFinished();
+        return;
+    }
+
+    auto remaining = std::make_shared<std::atomic<int>>(files.size());
+    m_pendingJobs += files.size();
+
+    for (const auto& file : files) {
+        m_threadPool->addJob([this, file, remaining, onFinished]() {
+            AudioFeatureSummary summary;
+            if (!getCachedSummary(file, summary))
+                getFeatures(file);
+
+            --m_pendingJobs;
+            if (--(*remaining) == 0) {
+                flush();
+                if (onFinished)
+                    onFinished();
+            }
+        });
+    }
+}
+
+void AudioFeatureStore::analyseFiles(const juce::Array<juce::File>& files) {
+    juce::WaitableEvent finished;
+    analyseInBackground(files, [&finished]() { finished.signal(); });
+    finished.wait();
+}
+
+void AudioFeatureStore::flush() {
+    juce::ScopedLock lock(m_lock);
+    if (!m_indexDirty)
+        return;
+
+    juce::Array<juce::var> entries;
+    for (const auto& [path, entry] : m_index) {
+        const auto& summary = entry.summary;
+        auto* object = new juce::DynamicObject();
+        object->setProperty("path", path);
+        object->setProperty("size", (juce::int64) entry.fileSize);
+        object->setProperty("modified", (juce::int64) entry.modificationTime);
+        object->setProperty("hash", juce::String::toHexString((juce::int64) summary.contentHash));
+        object->setProperty("sampleRate", summary.sampleRate);
+        object->setProperty("channels", summary.numChannels);
+        object->setProperty("length", (juce::int64) summary.lengthInSamples);
+        object->setProperty("bpm", summary.bpm);
+        object->setProperty("bpmConfidence", summary.bpmConfidence);
+        object->setProperty("key", summary.key);
+        object->setProperty("minor", summary.minor);
+        object->setProperty("keyConfidence", summary.keyConfidence);
+        object->setProperty("loudness", summary.integratedLoudness);
+        object->setProperty("peak", summary.peakDb);
+        object->setProperty("rms", summary.rmsDb);
+        entries.add(juce::var(object));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("version", kIndexVersion);
+    root->setProperty("files", entries);
+
+    if (getIndexFile().replaceWithText(juce::JSON::toString(juce::var(root), true)))
+        m_indexDirty = false;
+}
+
+void AudioFeatureStore::clear() {
+    m_threadPool->removeAllJobs(true, 10000);
+
+    juce::ScopedLock lock(m_lock);
+    m_index.clear();
+    m_memory.clear();
+    m_memoryOrder.clear();
+    m_indexDirty = false;
+
+    for (const auto& file : m_directory.findChildFiles(juce::File::findFiles, false, "*.features"))
+        file.deleteFile();
+    getIndexFile().deleteFile();
+}
+
+int AudioFeatureStore::getNumIndexedFiles() const {
+    juce::ScopedLock lock(m_lock);
+    return (int) m_index.size();
+}
+
+uint64_t AudioFeatureStore::hashContent(const juce::AudioBuffer<float>& buffer, double sampleRate) {
+    ContentHash hash(buffer.getNumChannels(), buffer.getNumSamples(), sampleRate);
+    hash.add(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    return hash.get();
+}
+
+AudioFeatures AudioFeatureStore::analyse(const juce::AudioBuffer<float>& buffer, double sampleRate) {
+    Analyser analyser(sampleRate, buffer.getNumChannels(), buffer.getNumSamples());
+    analyser.push(buffer.getArrayOfReadPointers(), buffer.getNumSamples());
+    return analyser.finish();
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::analyseFile(const juce::File& file) {
+    std::unique_ptr<juce::AudioFormatReader> reader(m_formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->numChannels == 0 || reader->sampleRate <= 0.0)
+        return nullptr;
+
+    const int numChannels = (int) reader->numChannels;
+    const int64_t length = reader->lengthInSamples;
+
+    // Decoded in chunks: the whole file never needs to be in memory
+    Analyser analyser(reader->sampleRate, numChannels, length);
+    juce::AudioBuffer<float> chunk(numChannels, (int) juce::jmin((int64_t) kReadChunkSize, juce::jmax((int64_t) 1, length)));
+    for (int64_t position = 0; position < length; position += chunk.getNumSamples()) {
+        const int count = (int) juce::jmin((int64_t) chunk.getNumSamples(), length - position);
+        reader->read(&chunk, 0, count, position, true, true);
+        analyser.push(chunk.getArrayOfReadPointers(), count);
+    }
+
+    auto features = analyser.finish();
+    addToIndex(file, features.summary);
+
+    if (auto existing = findByHash(features.summary.contentHash)) {
+        persist(*existing);     // Same audio under another path, or seen in memory first
+        return existing;
+    }
+    return store(std::move(features), true);
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::findByHash(uint64_t hash) {
+    {
+        juce::ScopedLock lock(m_lock);
+        auto it = m_memory.find(hash);
+        if (it != m_memory.end())
+            return it->second;
+    }
+
+    std::shared_ptr<const AudioFeatures> features = readFeatures(getFeatureFile(hash));
+    if (features == nullptr || features->summary.contentHash != hash)
+        return nullptr;
+
+    remember(features);
+    return features;
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::store(AudioFeatures&& features, bool persist) {
+    auto shared = std::make_shared<const AudioFeatures>(std::move(features));
+    if (persist)
+        writeFeatures(*shared, getFeatureFile(shared->summary.contentHash));
+    remember(shared);
+    return shared;
+}
+
+void AudioFeatureStore::persist(const AudioFeatures& features) {
+    auto file = getFeatureFile(features.summary.contentHash);
+    if (!file.existsAsFile())
+        writeFeatures(features, file);
+}
+
+std::shared_ptr<const AudioFeatures> AudioFeatureStore::lookupIndex(const juce::File& file) {
+    AudioFeatureSummary summary;
+    if (!getCachedSummary(file, summary))
+        return nullptr;
+    return findByHash(summary.contentHash);
+}
+
+void AudioFeatureStore::addToIndex(const juce::File& file, const AudioFeatureSummary& summary) {
+    IndexEntry entry;
+    entry.fileSize = file.getSize();
+    entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+    entry.summary = summary;
+
+    juce::ScopedLock lock(m_lock);
+    m_index[file.getFullPathName()] = entry;
+    m_indexDirty = true;
+}
+
+void AudioFeatureStore::remember(const std::shared_ptr<const AudioFeatures>& features) {
+    juce::ScopedLock lock(m_lock);
+
+    const uint64_t hash = features->summary.contentHash;
+    if (m_memory.emplace(hash, features).second)
+        m_memoryOrder.push_back(hash);
+
+    while (m_memoryOrder.size() > kMaxFeaturesInMemory) {
+        m_memory.erase(m_memoryOrder.front());
+        m_memoryOrder.pop_front();
+    }
+}
+
+juce::File AudioFeatureStore::getFeatureFile(uint64_t hash) const {
+    return m_directory.getChildFile(juce::String::toHexString((juce::int64) hash).paddedLeft('0', 16) + ".features");
+}
+
+void AudioFeatureStore::loadIndex() {
+    auto indexFile = getIndexFile();
+    if (!indexFile.existsAsFile())
+        return;
+
+    auto root = juce::JSON::parse(indexFile);
+    if ((int) root.getProperty("version", 0) != kIndexVersion)
+        return;
+
+    if (auto* entries = root.getProperty("files", {}).getArray()) {
+        for (const auto& object : *entries) {
+            IndexEntry entry;
+            entry.fileSize = (juce::int64) object.getProperty("size", 0);
+            entry.modificationTime = (juce::int64) object.getProperty("modified", 0);
+
+            auto& summary = entry.summary;
+            summary.contentHash = (uint64_t) object.getProperty("hash", "").toString().getHexValue64();
+            summary.sampleRate = (double) object.getProperty("sampleRate", 0.0);
+            summary.numChannels = (int) object.getProperty("channels", 0);
+            summary.lengthInSamples = (juce::int64) object.getProperty("length", 0);
+            summary.bpm = (float) object.getProperty("bpm", 0.0f);
+            summary.bpmConfidence = (float) object.getProperty("bpmConfidence", 0.0f);
+            summary.key = (int) object.getProperty("key", -1);
+            summary.minor = (bool) object.getProperty("minor", false);
+            summary.keyConfidence = (float) object.getProperty("keyConfidence", 0.0f);
+            summary.integratedLoudness = (float) object.getProperty("loudness", -70.0f);
+            summary.peakDb = (float) object.getProperty("peak", -100.0f);
+            summary.rmsDb = (float) object.getProperty("rms", -100.0f);
+
+            m_index[object.getProperty("path", "").toString()] = entry;
+        }
+    }
+}
+
+// Feature files of audio no indexed file decodes to: written by older versions for
+// audio in memory, or left behind when an indexed file changed
+void AudioFeatureStore::removeOrphanedFeatures() {
+    std::unordered_set<uint64_t> referenced;
+    for (const auto& [path, entry] : m_index)
+        referenced.insert(entry.summary.contentHash);
+
+    for (const auto& file : m_directory.findChildFiles(juce::File::findFiles, false, "*.features")) {
+        if (referenced.count((uint64_t) file.getFileNameWithoutExtension().getHexValue64()) == 0)
+            file.deleteFile();
+    }
+}
+
+// Binary, little-endian: spectra as int16 centi-dB, onsets as deltas with int16 strength
+bool AudioFeatureStore::writeFeatures(const AudioFeatures& features, const juce::File& file) {
+    juce::MemoryOutputStream out;
+    const auto& summary = features.summary;
+
+    out.writeInt(kFileMagic);
+    out.writeInt(kFileVersion);
+    out.writeInt64((juce::int64) summary.contentHash);
+    out.writeDouble(summary.sampleRate);
+    out.writeInt(summary.numChannels);
+    out.writeInt64(summary.lengthInSamples);
+    out.writeFloat(summary.bpm);
+    out.writeFloat(summary.bpmConfidence);
+    out.writeInt(summary.key);
+    out.writeBool(summary.minor);
+    out.writeFloat(summary.keyConfidence);
+    out.writeFloat(summary.integratedLoudness);
+    out.writeFloat(summary.peakDb);
+    out.writeFloat(summary.rmsDb);
+
+    for (float value : features.chroma)
+        out.writeFloat(value);
+
+    out.writeInt((int) features.onsets.size());
+    int64_t previous = 0;
+    for (const auto& onset : features.onsets) {
+        out.writeCompressedInt((int) (onset.position - previous));
+        out.writeShort((short) juce::roundToInt(juce::jlimit(0.0f, 1.0f, onset.strength) * 32767.0f));
+        previous = onset.position;
+    }
+
+    out.writeInt((int) features.spectrum.size());
+    for (float decibels : features.spectrum)
+        out.writeShort((short) juce::roundToInt(juce::jlimit(-327.0f, 327.0f, decibels) * 100.0f));
+
+    return file.replaceWithData(out.getData(), out.getDataSize());
+}
+
+std::shared_ptr<AudioFeatures> AudioFeatureStore::readFeatures(const juce::File& file) {
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data))
+        return nullptr;
+
+    juce::MemoryInputStream in(data, false);
+    if (in.readInt() != kFileMagic || in.readInt() != kFileVersion)
+        return nullptr;
+
+    auto features = std::make_shared<AudioFeatures>();
+    auto& summary = features->summary;
+    summary.contentHash = (uint64_t) in.readInt64();
+    summary.sampleRate = in.readDouble();
+    summary.numChannels = in.readInt();
+    summary.lengthInSamples = in.readInt64();
+    summary.bpm = in.readFloat();
+    summary.bpmConfidence = in.readFloat();
+    summary.key = in.readInt();
+    summary.minor = in.readBool();
+    summary.keyConfidence = in.readFloat();
+    summary.integratedLoudness = in.readFloat();
+    summary.peakDb = in.readFloat();
+    summary.rmsDb = in.readFloat();
+
+    for (auto& value : features->chroma)
+        value = in.readFloat();
+
+    const int numOnsets = in.readInt();
+    if (numOnsets < 0 || (juce::int64) numOnsets * 3 > in.getNumBytesRemaining())
+        return nullptr;
+    features->onsets.resize((size_t) numOnsets);
+    int64_t position = 0;
+    for (auto& onset : features->onsets) {
+        position += in.readCompressedInt();
+        onset.position = position;
+        onset.strength = in.readShort() / 32767.0f;
+    }
+
+    const int numBins = in.readInt();
+    if (numBins < 0 || (juce::int64) numBins * 2 > in.getNumBytesRemaining())
+        return nullptr;
+    features->spectrum.resize((size_t) numBins);
+    for (auto& decibels : features->spectrum)
+        decibels = in.readShort() / 100.0f;
+
+    return features;
+}
+
+} // namespace Analysis
+} // namespace omega
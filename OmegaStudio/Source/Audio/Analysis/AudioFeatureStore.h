@@ -0,0 +1,207 @@
+/**
+ * @file AudioFeatureStore.h
+ * @brief Persistent, content-hash keyed store of per-file audio features
+ *
+ * One analysis module for every consumer of file features (SampleManager,
+ * SmartBrowser, SampleSlicer, AudioToMidi, ReferenceTrackMatcher,
+ * TempoDetector):
+ * - A single decode pass computes everything at once: onsets, tempo, key,
+ *   integrated loudness, peak/RMS and the long-term spectrum
+ * - Features are keyed by a hash of the decoded audio, so a buffer already in
+ *   memory finds the analysis of the file it came from (and duplicates of the
+ *   same audio share one entry)
+ * - A path index (size + modification time -> hash + summary) answers browser
+ *   listings without opening the audio at all; it and the features of files
+ *   live on disk, so a folder is only ever analysed once
+ * - Audio that only exists in memory (renders, recordings, edits) is cached in
+ *   memory only: nothing on disk would ever find it again. Feature files no
+ *   index entry refers to are removed when the store opens
+ * - Batches of files are analysed in parallel, one file per core
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace omega {
+namespace Analysis {
+
+/**
+ * @brief Small per-file result, kept in the path index (no feature blob needed)
+ */
+struct AudioFeatureSummary {
+    uint64_t contentHash = 0;
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int64_t lengthInSamples = 0;
+
+    float bpm = 0.0f;                   // 0 = no steady tempo (one-shots, too short)
+    float bpmConfidence = 0.0f;         // 0-1
+    int key = -1;                       // Tonic pitch class (0=C, 1=C#, etc.) -1=unknown
+    bool minor = false;
+    float keyConfidence = 0.0f;         // Profile correlation, 0-1
+
+    float integratedLoudness = -70.0f;  // LUFS (K-weighted, gated)
+    float peakDb = -100.0f;             // Sample peak, dBFS
+    float rmsDb = -100.0f;
+
+    /** "C", "F#m", etc. (empty when the key is unknown) */
+    juce::String getKeyName() const;
+};
+
+/**
+ * @brief Full analysis of one piece of audio
+ */
+struct AudioFeatures {
+    static constexpr int kOnsetFftSize = 2048;
+    static constexpr int kOnsetHopSize = 512;
+    static constexpr int kSpectrumFftSize = 4096;
+
+    struct Onset {
+        int64_t position = 0;           // Samples
+        float strength = 0.0f;          // Relative to the strongest onset, 0-1
+    };
+
+    AudioFeatureSummary summary;
+    std::vector<Onset> onsets;          // Ascending
+    std::array<float, 12> chroma {};    // Pitch class energy, normalized to a maximum of 1
+
+    /**
+     * Long-term average magnitude spectrum (dB), kSpectrumFftSize / 2 bins.
+     * Same scale as ReferenceTrackMatcher::analyzeSpectrum (mono mix, JUCE Hann,
+     * unscaled FFT) so the two can be compared directly
+     */
+    std::vector<float> spectrum;
+
+    /**
+     * Onsets at least minStrength strong and minSpacing samples apart
+     * (a stronger onset wins over a weaker one too close before it)
+     */
+    std::vector<Onset> selectOnsets(float minStrength, int64_t minSpacing = 0) const;
+};
+
+/**
+ * @class AudioFeatureStore
+ * @brief Cache of AudioFeatures in memory and on disk
+ *
+ * Thread-safe. The getFeatures() calls block while analysing on a miss; use
+ * analyseInBackground() to warm the store for many files at once.
+ */
+class AudioFeatureStore {
+public:
+    /**
+     * @param directory Where the index and the feature files are kept
+     *                  (created if needed)
+     */
+    explicit AudioFeatureStore(const juce::File& directory = getDefaultDirectory());
+    ~AudioFeatureStore();
+
+    /** Application-wide store in getDefaultDirectory() */
+    static AudioFeatureStore& getInstance();
+    static juce::File getDefaultDirectory();
+
+    /**
+     * Summary of a file analysed before, without decoding it
+     * @return False if the file is unknown or changed since its analysis
+     */
+    bool getCachedSummary(const juce::File& file, AudioFeatureSummary& summary) const;
+
+    /**
+     * Features of a file: the index, then disk, then one decode and analysis
+     * @return nullptr if the file can't be read
+     */
+    std::shared_ptr<const AudioFeatures> getFeatures(const juce::File& file);
+
+    /**
+     * Features of a file the caller already decoded (no second decode on a miss)
+     */
+    std::shared_ptr<const AudioFeatures> getFeatures(const juce::File& file,
+                                                     const juce::AudioBuffer<float>& decoded,
+                                                     double sampleRate);
+
+    /**
+     * Features of audio in memory, looked up by content hash (memory, then the
+     * files on disk). A miss is analysed and kept in memory, not written
+     */
+    std::shared_ptr<const AudioFeatures> getFeatures(const juce::AudioBuffer<float>& buffer,
+                                                     double sampleRate);
+
+    /**
+     * Analyse files not in the store yet, in parallel
+     * @param onFinished Called once all files are done, on a pool thread
+     */
+    void analyseInBackground(const juce::Array<juce::File>& files,
+                             std::function<void()> onFinished = nullptr);
+
+    /** Same as analyseInBackground(), waiting for the batch */
+    void analyseFiles(const juce::Array<juce::File>& files);
+
+    bool isAnalysing() const { return m_pendingJobs.load() > 0; }
+
+    /** Write the path index if it changed */
+    void flush();
+
+    /** Forget everything, on disk too */
+    void clear();
+
+    int getNumIndexedFiles() const;
+
+    /** Hash of decoded audio: samples, channel count, length and sample rate */
+    static uint64_t hashContent(const juce::AudioBuffer<float>& buffer, double sampleRate);
+
+    /** Analysis alone, no caching */
+    static AudioFeatures analyse(const juce::AudioBuffer<float>& buffer, double sampleRate);
+
+private:
+    class Analyser;
+
+    struct IndexEntry {
+        int64_t fileSize = 0;
+        int64_t modificationTime = 0;   // ms
+        AudioFeatureSummary summary;
+    };
+
+    std::shared_ptr<const AudioFeatures> analyseFile(const juce::File& file);
+    std::shared_ptr<const AudioFeatures> findByHash(uint64_t hash);
+    std::shared_ptr<const AudioFeatures> store(AudioFeatures&& features, bool persist);
+    void persist(const AudioFeatures& features);
+    std::shared_ptr<const AudioFeatures> lookupIndex(const juce::File& file);
+    void addToIndex(const juce::File& file, const AudioFeatureSummary& summary);
+    void remember(const std::shared_ptr<const AudioFeatures>& features);
+
+    juce::File getFeatureFile(uint64_t hash) const;
+    juce::File getIndexFile() const { return m_directory.getChildFile("index.json"); }
+    void loadIndex();
+    void removeOrphanedFeatures();
+
+    static bool writeFeatures(const AudioFeatures& features, const juce::File& file);
+    static std::shared_ptr<AudioFeatures> readFeatures(const juce::File& file);
+
+    juce::File m_directory;
+    juce::AudioFormatManager m_formatManager;
+
+    // Path index and in-memory features (bounded, oldest dropped first)
+    std::unordered_map<juce::String, IndexEntry> m_index;
+    std::unordered_map<uint64_t, std::shared_ptr<const AudioFeatures>> m_memory;
+    std::deque<uint64_t> m_memoryOrder;
+    bool m_indexDirty = false;
+    mutable juce::CriticalSection m_lock;
+
+    std::atomic<int> m_pendingJobs{0};
+    std::unique_ptr<juce::ThreadPool> m_threadPool;
+
+    static constexpr size_t kMaxFeaturesInMemory = 512;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFeatureStore)
+};
+
+} // namespace Analysis
+} // namespace omega
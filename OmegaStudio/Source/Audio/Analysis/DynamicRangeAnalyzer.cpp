@@ -24,14 +24,15 @@ DynamicRangeAnalyzer::DynamicRangeAnalyzer() {
 }
 
 void DynamicRangeAnalyzer::initialize(double sampleRate) {
-    sampleRate_ = sampleRate;
-    blockSize_ = static_cast<int>(sampleRate * 0.1); // 100ms blocks
+    setSampleRate(sampleRate);
     reset();
 }
 
 void DynamicRangeAnalyzer::setSampleRate(double newSampleRate) {
     sampleRate_ = newSampleRate;
-    blockSize_ = static_cast<int>(sampleRate_ * 0.1);
+    blockSize_ = static_cast<int>(sampleRate_ * 0.1); // 100ms blocks
+    accumulatedBuffer_.setSize(2, blockSize_);
+    accumulatedSamples_ = 0;
 }
 
 void DynamicRangeAnalyzer::reset() {
@@ -153,19 +154,8 @@ float DynamicRangeAnalyzer::calculateCrestFactor(float peakDb, float rmsDb) {
 }
 
 float DynamicRangeAnalyzer::calculateLUFS(const juce::AudioBuffer<float>& buffer) {
-    // Simplified LUFS calculation
-    double sumSquares = 0.0;
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            sumSquares += data[i] * data[i];
-        }
-    }
-    
-    double rms = std::sqrt(sumSquares / (buffer.getNumChannels() * buffer.getNumSamples()));
-    float lufs = -23.0f + 20.0f * std::log10(static_cast<float>(rms) + 1e-10f);
-    
-    return juce::jlimit(-70.0f, 0.0f, lufs);
+    // Gated integrated loudness (ITU-R BS.1770)
+    return LoudnessMeter::measure(buffer, sampleRate_).integratedLUFS;
 }
 
 void DynamicRangeAnalyzer::updateHistogram(const juce::AudioBuffer<float>& buffer) {
@@ -210,29 +200,24 @@ DynamicRangeResult DynamicRangeAnalyzer::analyzeFile(const juce::File& audioFile
 }
 
 void DynamicRangeAnalyzer::processBlock(const juce::AudioBuffer<float>& buffer) {
-    // Accumulate samples for batch analysis
-    if (accumulatedBuffer_.getNumSamples() == 0) {
-        accumulatedBuffer_.setSize(buffer.getNumChannels(), blockSize_ * 100);
-    }
-    
-    int samplesToAdd = std::min(buffer.getNumSamples(), 
-                                accumulatedBuffer_.getNumSamples() - accumulatedSamples_);
-    
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        accumulatedBuffer_.copyFrom(ch, accumulatedSamples_, buffer, ch, 0, samplesToAdd);
-    }
-    
-    accumulatedSamples_ += samplesToAdd;
-    
-    // Analyze when we have enough data
-    if (accumulatedSamples_ >= blockSize_) {
-        juce::AudioBuffer<float> analysisBuffer(accumulatedBuffer_.getNumChannels(), accumulatedSamples_);
-        for (int ch = 0; ch < accumulatedBuffer_.getNumChannels(); ++ch) {
-            analysisBuffer.copyFrom(ch, 0, accumulatedBuffer_, ch, 0, accumulatedSamples_);
-        }
+    // Accumulate into the buffer sized by setSampleRate(); each full 100ms window is analyzed
+    const int numChannels = std::min(buffer.getNumChannels(), accumulatedBuffer_.getNumChannels());
+    if (numChannels <= 0 || blockSize_ <= 0)
+        return;
+    
+    for (int position = 0; position < buffer.getNumSamples();) {
+        const int samplesToAdd = std::min(buffer.getNumSamples() - position, blockSize_ - accumulatedSamples_);
+        for (int ch = 0; ch < numChannels; ++ch)
+            accumulatedBuffer_.copyFrom(ch, accumulatedSamples_, buffer, ch, position, samplesToAdd);
+        
+        accumulatedSamples_ += samplesToAdd;
+        position += samplesToAdd;
         
-        currentResult_ = analyze(analysisBuffer);
-        accumulatedSamples_ = 0;
+        if (accumulatedSamples_ == blockSize_) {
+            juce::AudioBuffer<float> window(accumulatedBuffer_.getArrayOfWritePointers(), numChannels, blockSize_);
+            currentResult_ = analyze(window);
+            accumulatedSamples_ = 0;
+        }
     }
 }
 
@@ -246,37 +231,21 @@ PLRMeter::PLRMeter() {
 
 void PLRMeter::initialize(double sampleRate) {
     sampleRate_ = sampleRate;
+    meter_.prepare(sampleRate, 2);
     reset();
 }
 
 void PLRMeter::reset() {
+    meter_.reset();
     plr_ = 0.0f;
     truePeak_ = -100.0f;
     lufs_ = -23.0f;
 }
 
 void PLRMeter::process(const juce::AudioBuffer<float>& buffer) {
-    // Calculate true peak
-    float peak = 0.0f;
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            peak = std::max(peak, std::abs(data[i]));
-        }
-    }
-    truePeak_ = peak > 0.0f ? 20.0f * std::log10(peak) : -100.0f;
-    
-    // Calculate LUFS (simplified)
-    double sumSquares = 0.0;
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            sumSquares += data[i] * data[i];
-        }
-    }
-    double rms = std::sqrt(sumSquares / (buffer.getNumChannels() * buffer.getNumSamples()));
-    lufs_ = -23.0f + 20.0f * std::log10(static_cast<float>(rms) + 1e-10f);
-    lufs_ = juce::jlimit(-70.0f, 0.0f, lufs_);
+    meter_.process(buffer);
+    truePeak_ = meter_.getTruePeak();
+    lufs_ = meter_.getIntegrated();
     
     // Calculate PLR
     plr_ = truePeak_ - lufs_;
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "LoudnessMeter.h"
 #include <vector>
 #include <algorithm>
 
@@ -52,7 +53,7 @@ public:
     DynamicRangeResult analyzeFile(const juce::File& audioFile);
     void reset();
     
-    // Real-time analysis
+    // Streaming analysis, analysis thread only (AnalysisTapService::makeDynamicRangeAnalyzer)
     void processBlock(const juce::AudioBuffer<float>& buffer);
     DynamicRangeResult getCurrentResult() const { return currentResult_; }
     
@@ -109,8 +110,8 @@ private:
     float truePeak_ = -100.0f;
     float lufs_ = -23.0f;
     
-    // Accumulation
-    juce::AudioBuffer<float> buffer_;
+    // Integrated loudness and true peak since reset()
+    LoudnessMeter meter_;
 };
 
 /**
@@ -0,0 +1,580 @@
+/**
+ * @file LoudnessMeter.cpp
+ * @brief Implementation of the BS.1770 loudness engine
+ */
+
+#include "LoudnessMeter.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+namespace omega {
+namespace Analysis {
+
+namespace {
+
+constexpr int kNumHistogramBins = 8000;         // -70 to +10 LUFS
+constexpr double kBinsPerLU = 100.0;
+constexpr int kReadBlockSize = 65536;
+constexpr double kPreRollSeconds = 0.5;         // K-weighting settles in well under this
+constexpr double kMinSectionSeconds = 30.0;
+
+float toLoudness(double meanSquare) {
+    return meanSquare > 0.0
+        ? juce::jmax(LoudnessMeter::kMinimumLoudness, (float) (-0.691 + 10.0 * std::log10(meanSquare)))
+        : LoudnessMeter::kMinimumLoudness;
+}
+
+/** Section starts on 100 ms step boundaries, at most one section per thread */
+std::vector<int64_t> sectionStarts(int64_t length, int stepLength, double sampleRate, int numThreads) {
+    if (numThreads <= 0)
+        numThreads = juce::SystemStats::getNumCpus();
+
+    const auto minSection = juce::jmax<int64_t>(1, (int64_t) (kMinSectionSeconds * sampleRate));
+    const auto numSections = juce::jmin<int64_t>(numThreads, juce::jmax<int64_t>(1, length / minSection));
+    const int64_t numSteps = (length + stepLength - 1) / stepLength;
+    const int64_t stepsPerSection = juce::jmax<int64_t>(1, (numSteps + numSections - 1) / numSections);
+
+    std::vector<int64_t> starts { 0 };
+    for (int64_t start = stepsPerSection * stepLength; start < length; start += stepsPerSection * stepLength)
+        starts.push_back(start);
+    return starts;
+}
+
+/** Runs fn on every element, the first on the calling thread, and waits for all */
+template <typename Item, typename Function>
+void runInParallel(std::vector<Item>& items, Function fn) {
+    if (items.size() == 1) {
+        fn(items.front());
+        return;
+    }
+
+    juce::ThreadPool pool((int) items.size() - 1);
+    juce::WaitableEvent finished;
+    std::atomic<int> remaining { (int) items.size() - 1 };
+
+    for (size_t i = 1; i < items.size(); ++i) {
+        pool.addJob([&, i] {
+            fn(items[i]);
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    fn(items.front());
+    finished.wait();
+}
+
+/** Audio in memory: pointers straight into the buffer */
+class BufferSource {
+public:
+    explicit BufferSource(const juce::AudioBuffer<float>& buffer)
+        : m_buffer(buffer), m_pointers((size_t) buffer.getNumChannels()) {}
+
+    int read(int64_t start, int numSamples, const float* const*& channels) {
+        for (int ch = 0; ch < m_buffer.getNumChannels(); ++ch)
+            m_pointers[(size_t) ch] = m_buffer.getReadPointer(ch, (int) start);
+        channels = m_pointers.data();
+        return numSamples;
+    }
+
+private:
+    const juce::AudioBuffer<float>& m_buffer;
+    std::vector<const float*> m_pointers;
+};
+
+/** A file, decoded by a reader of its own */
+class ReaderSource {
+public:
+    explicit ReaderSource(const juce::File& file) {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        m_reader.reset(formatManager.createReaderFor(file));
+        if (m_reader != nullptr)
+            m_block.setSize((int) m_reader->numChannels, kReadBlockSize);
+    }
+
+    bool isValid() const { return m_reader != nullptr; }
+
+    int read(int64_t start, int numSamples, const float* const*& channels) {
+        if (!m_reader->read(&m_block, 0, numSamples, start, true, true))
+            return 0;
+        channels = m_block.getArrayOfReadPointers();
+        return numSamples;
+    }
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> m_reader;
+    juce::AudioBuffer<float> m_block;
+};
+
+} // namespace
+
+struct LoudnessMeter::Section {
+    int64_t start = 0;
+    int64_t end = 0;
+    bool last = false;
+    bool valid = true;
+
+    std::vector<double> steps;      // Mean square per completed 100 ms step
+    double partialEnergy = 0.0;     // Incomplete step at the end of the audio
+    int partialSamples = 0;
+    std::vector<float> truePeaks;
+};
+
+//==============================================================================
+// KWeighting
+//==============================================================================
+
+LoudnessMeter::KWeighting::KWeighting(double sampleRate) {
+    const double pi = juce::MathConstants<double>::pi;
+    {
+        const double f0 = 1681.974450955533, gain = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gain / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+}
+
+//==============================================================================
+// GatingHistogram
+//==============================================================================
+
+LoudnessMeter::GatingHistogram::GatingHistogram()
+    : m_counts((size_t) kNumHistogramBins, 0),
+      m_energies((size_t) kNumHistogramBins, 0.0) {
+}
+
+void LoudnessMeter::GatingHistogram::clear() {
+    std::fill(m_counts.begin(), m_counts.end(), 0u);
+    std::fill(m_energies.begin(), m_energies.end(), 0.0);
+    m_totalCount = 0;
+    m_totalEnergy = 0.0;
+}
+
+void LoudnessMeter::GatingHistogram::add(double meanSquare) {
+    if (meanSquare <= 0.0)
+        return;
+
+    const double loudness = -0.691 + 10.0 * std::log10(meanSquare);
+    if (loudness <= kMinimumLoudness)
+        return;
+
+    const auto bin = (size_t) juce::jmin(kNumHistogramBins - 1, (int) ((loudness - kMinimumLoudness) * kBinsPerLU));
+    ++m_counts[bin];
+    m_energies[bin] += meanSquare;
+    ++m_totalCount;
+    m_totalEnergy += meanSquare;
+}
+
+int LoudnessMeter::GatingHistogram::findGateBin(float relativeGate) const {
+    const float gate = toLoudness(m_totalEnergy / (double) m_totalCount) + relativeGate;
+    return juce::jlimit(0, kNumHistogramBins - 1, (int) std::floor((gate - kMinimumLoudness) * kBinsPerLU));
+}
+
+float LoudnessMeter::GatingHistogram::binLoudness(int bin) {
+    return kMinimumLoudness + (float) ((bin + 0.5) / kBinsPerLU);
+}
+
+float LoudnessMeter::GatingHistogram::gatedLoudness(float relativeGate) const {
+    if (m_totalCount == 0)
+        return kMinimumLoudness;
+
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (int bin = findGateBin(relativeGate); bin < kNumHistogramBins; ++bin) {
+        count += m_counts[(size_t) bin];
+        energy += m_energies[(size_t) bin];
+    }
+    return count > 0 ? toLoudness(energy / (double) count) : kMinimumLoudness;
+}
+
+float LoudnessMeter::GatingHistogram::range(float relativeGate) const {
+    if (m_totalCount == 0)
+        return 0.0f;
+
+    const int gateBin = findGateBin(relativeGate);
+    uint64_t count = 0;
+    for (int bin = gateBin; bin < kNumHistogramBins; ++bin)
+        count += m_counts[(size_t) bin];
+    if (count == 0)
+        return 0.0f;
+
+    // Bins holding the 10th and 95th percentile blocks
+    const auto lowRank = (uint64_t) std::llround((double) (count - 1) * 0.10);
+    const auto highRank = (uint64_t) std::llround((double) (count - 1) * 0.95);
+    int lowBin = gateBin, highBin = gateBin;
+    uint64_t seen = 0;
+    for (int bin = gateBin; bin < kNumHistogramBins; ++bin) {
+        const uint64_t next = seen + m_counts[(size_t) bin];
+        if (seen <= lowRank && lowRank < next)
+            lowBin = bin;
+        if (seen <= highRank && highRank < next) {
+            highBin = bin;
+            break;
+        }
+        seen = next;
+    }
+    return binLoudness(highBin) - binLoudness(lowBin);
+}
+
+//==============================================================================
+// LoudnessMeter
+//==============================================================================
+
+LoudnessMeter::LoudnessMeter() = default;
+
+void LoudnessMeter::prepare(double sampleRate, int numChannels, bool measureTruePeak) {
+    m_sampleRate = sampleRate;
+    m_numChannels = juce::jmax(1, numChannels);
+    m_stepLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+
+    m_filters.assign((size_t) m_numChannels, KWeighting(sampleRate));
+    m_channelWeights = makeChannelWeights(m_numChannels);
+
+    m_measureTruePeak = measureTruePeak;
+    m_truePeakDetectors.resize(measureTruePeak ? (size_t) m_numChannels : 0);
+    for (auto& detector : m_truePeakDetectors)
+        detector.prepare(4, OmegaStudio::TruePeakQuality::Realtime);
+    m_truePeaks.assign((size_t) m_numChannels, 0.0f);
+    m_peakScratch.assign(measureTruePeak ? (size_t) kTruePeakBlockSize : 0, 0.0f);
+
+    reset();
+}
+
+void LoudnessMeter::reset() {
+    for (auto& filter : m_filters)
+        filter.reset();
+    for (auto& detector : m_truePeakDetectors)
+        detector.reset();
+    std::fill(m_truePeaks.begin(), m_truePeaks.end(), 0.0f);
+
+    m_stepEnergy = 0.0;
+    m_stepPosition = 0;
+    m_steps.fill(0.0);
+    m_stepIndex = 0;
+    m_numSteps = 0;
+    m_completedEnergy = 0.0;
+
+    m_momentaryBlocks.clear();
+    m_shortTermBlocks.clear();
+
+    m_momentary = m_shortTerm = m_integrated = kMinimumLoudness;
+    m_maxMomentary = m_maxShortTerm = kMinimumLoudness;
+    m_loudnessRange = 0.0f;
+}
+
+std::vector<float> LoudnessMeter::makeChannelWeights(int numChannels) {
+    // BS.1770: L, R, C 1.0, surrounds 1.41 (+1.5 dB), LFE not measured
+    if (numChannels == 5)
+        return { 1.0f, 1.0f, 1.0f, 1.41f, 1.41f };
+    if (numChannels == 6)
+        return { 1.0f, 1.0f, 1.0f, 0.0f, 1.41f, 1.41f };
+    return std::vector<float>((size_t) numChannels, 1.0f);
+}
+
+double LoudnessMeter::filterEnergy(KWeighting* filters, const float* weights, const float* const* channels,
+                                   int numChannels, int offset, int numSamples) noexcept {
+    double total = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        if (weights[ch] == 0.0f)
+            continue;
+
+        auto& filter = filters[ch];
+        const float* x = channels[ch] + offset;
+        double sum = 0.0;
+        for (int i = 0; i < numSamples; ++i) {
+            const double y = filter.process(x[i]);
+            sum += y * y;
+        }
+        total += weights[ch] * sum;
+    }
+    return total;
+}
+
+void LoudnessMeter::process(const float* const* channels, int numChannels, int numSamples) {
+    if (m_numChannels == 0 || numSamples <= 0)
+        return;
+
+    juce::ScopedNoDenormals noDenormals;     // Filters ringing out into silence
+    const int channelsToMeasure = juce::jmin(numChannels, m_numChannels);
+    const int64_t stepsBefore = m_numSteps;
+
+    for (int offset = 0; offset < numSamples;) {
+        const int count = juce::jmin(numSamples - offset, m_stepLength - m_stepPosition);
+        m_stepEnergy += filterEnergy(m_filters.data(), m_channelWeights.data(), channels,
+                                     channelsToMeasure, offset, count);
+        m_stepPosition += count;
+        offset += count;
+
+        if (m_stepPosition == m_stepLength) {
+            addStep(m_stepEnergy / m_stepLength);
+            m_stepEnergy = 0.0;
+            m_stepPosition = 0;
+        }
+    }
+
+    if (m_measureTruePeak) {
+        for (int ch = 0; ch < channelsToMeasure; ++ch) {
+            for (int offset = 0; offset < numSamples; offset += kTruePeakBlockSize) {
+                const int count = juce::jmin(kTruePeakBlockSize, numSamples - offset);
+                m_truePeakDetectors[(size_t) ch].process(channels[ch] + offset, m_peakScratch.data(), count);
+                m_truePeaks[(size_t) ch] = juce::jmax(m_truePeaks[(size_t) ch],
+                                                      juce::FloatVectorOperations::findMaximum(m_peakScratch.data(), count));
+            }
+        }
+    }
+
+    // Histogram scans once per call at most (and only when a block was added)
+    if (m_numSteps != stepsBefore || m_numSteps < kMomentarySteps)
+        updateGatedValues();
+}
+
+void LoudnessMeter::addStep(double meanSquare) noexcept {
+    m_steps[(size_t) m_stepIndex] = meanSquare;
+    m_stepIndex = (m_stepIndex + 1) % kShortTermSteps;
+    ++m_numSteps;
+    m_completedEnergy += meanSquare;
+
+    // Windows over the most recent steps (silence before the start)
+    double momentary = 0.0, shortTerm = 0.0;
+    for (int i = 1; i <= kShortTermSteps; ++i) {
+        const double step = m_steps[(size_t) ((m_stepIndex - i + kShortTermSteps) % kShortTermSteps)];
+        if (i <= kMomentarySteps)
+            momentary += step;
+        shortTerm += step;
+    }
+    momentary /= kMomentarySteps;
+    shortTerm /= kShortTermSteps;
+
+    m_momentary = toLoudness(momentary);
+    m_shortTerm = toLoudness(shortTerm);
+    m_maxMomentary = juce::jmax(m_maxMomentary, m_momentary);
+    m_maxShortTerm = juce::jmax(m_maxShortTerm, m_shortTerm);
+
+    // Only complete blocks are gated
+    if (m_numSteps >= kMomentarySteps)
+        m_momentaryBlocks.add(momentary);
+    if (m_numSteps >= kShortTermSteps)
+        m_shortTermBlocks.add(shortTerm);
+}
+
+void LoudnessMeter::updateGatedValues() noexcept {
+    if (m_numSteps >= kMomentarySteps) {
+        m_integrated = m_momentaryBlocks.gatedLoudness(-10.0f);
+    } else {
+        // Shorter than one block (one-shots): plain mean of what there is
+        const double numSamples = (double) m_numSteps * m_stepLength + m_stepPosition;
+        m_integrated = numSamples > 0.0
+            ? toLoudness((m_completedEnergy * m_stepLength + m_stepEnergy) / numSamples)
+            : kMinimumLoudness;
+    }
+    m_loudnessRange = m_shortTermBlocks.range(-20.0f);
+}
+
+float LoudnessMeter::getTruePeak() const noexcept {
+    float peak = 0.0f;
+    for (float channelPeak : m_truePeaks)
+        peak = juce::jmax(peak, channelPeak);
+    return juce::Decibels::gainToDecibels(peak, kMinimumPeak);
+}
+
+float LoudnessMeter::getTruePeak(int channel) const noexcept {
+    if (!juce::isPositiveAndBelow(channel, (int) m_truePeaks.size()))
+        return kMinimumPeak;
+    return juce::Decibels::gainToDecibels(m_truePeaks[(size_t) channel], kMinimumPeak);
+}
+
+LoudnessData LoudnessMeter::getLoudnessData() const {
+    LoudnessData data;
+    data.integratedLUFS = m_integrated;
+    data.shortTermLUFS = m_shortTerm;
+    data.momentaryLUFS = m_momentary;
+    data.truePeak = getTruePeak();
+    data.loudnessRange = m_loudnessRange;
+    data.maxMomentaryLUFS = m_maxMomentary;
+    data.maxShortTermLUFS = m_maxShortTerm;
+    return data;
+}
+
+//==============================================================================
+// Offline measurement
+//==============================================================================
+
+template <typename Source>
+void LoudnessMeter::measureSection(Source& source, double sampleRate, int numChannels, Section& section) {
+    juce::ScopedNoDenormals noDenormals;
+
+    const int stepLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    std::vector<KWeighting> filters((size_t) numChannels, KWeighting(sampleRate));
+    const auto weights = makeChannelWeights(numChannels);
+
+    std::vector<OmegaStudio::TruePeakDetector> detectors((size_t) numChannels);
+    for (auto& detector : detectors)
+        detector.prepare(4, OmegaStudio::TruePeakQuality::Offline);
+    std::vector<float> peaks((size_t) kReadBlockSize);
+    section.truePeaks.assign((size_t) numChannels, 0.0f);
+
+    auto measurePeaks = [&](const float* const* channels, int count, bool keep) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            detectors[(size_t) ch].process(channels[ch], peaks.data(), count);
+            if (keep)
+                section.truePeaks[(size_t) ch] = juce::jmax(section.truePeaks[(size_t) ch],
+                                                            juce::FloatVectorOperations::findMaximum(peaks.data(), count));
+        }
+    };
+
+    // Warm-up from the audio before the section: the filters settle, and the
+    // true peak interpolator sees exactly what a single pass would
+    const int taps = detectors.front().getTapsPerPhase();
+    const int64_t preRoll = juce::jmin(section.start, (int64_t) juce::jmax(taps, juce::roundToInt(sampleRate * kPreRollSeconds)));
+
+    double stepEnergy = 0.0;
+    int stepPosition = 0;
+    const float* const* channels = nullptr;
+
+    for (int64_t position = section.start - preRoll; position < section.end;) {
+        const bool warmUp = position < section.start;
+        const int wanted = (int) juce::jmin<int64_t>(kReadBlockSize, (warmUp ? section.start : section.end) - position);
+        const int count = source.read(position, wanted, channels);
+        if (count <= 0) {
+            section.valid = false;
+            return;
+        }
+
+        measurePeaks(channels, count, !warmUp);
+
+        if (warmUp) {
+            filterEnergy(filters.data(), weights.data(), channels, numChannels, 0, count);
+        } else {
+            for (int offset = 0; offset < count;) {
+                const int chunk = juce::jmin(count - offset, stepLength - stepPosition);
+                stepEnergy += filterEnergy(filters.data(), weights.data(), channels, numChannels, offset, chunk);
+                stepPosition += chunk;
+                offset += chunk;
+
+                if (stepPosition == stepLength) {
+                    section.steps.push_back(stepEnergy / stepLength);
+                    stepEnergy = 0.0;
+                    stepPosition = 0;
+                }
+            }
+        }
+        position += count;
+    }
+
+    // Interpolator tail after the last sample
+    if (section.last) {
+        std::vector<float> silence((size_t) taps, 0.0f);
+        std::vector<const float*> silentChannels((size_t) numChannels, silence.data());
+        measurePeaks(silentChannels.data(), taps, true);
+    }
+
+    section.partialEnergy = stepEnergy;
+    section.partialSamples = stepPosition;
+}
+
+std::vector<LoudnessMeter::Section> LoudnessMeter::makeSections(int64_t length, double sampleRate, int numThreads) {
+    const int stepLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    const auto starts = sectionStarts(length, stepLength, sampleRate, numThreads);
+
+    std::vector<Section> sections(starts.size());
+    for (size_t i = 0; i < starts.size(); ++i) {
+        sections[i].start = starts[i];
+        sections[i].end = i + 1 < starts.size() ? starts[i + 1] : length;
+        sections[i].last = i + 1 == starts.size();
+    }
+    return sections;
+}
+
+LoudnessData LoudnessMeter::mergeSections(std::vector<Section>& sections, double sampleRate, int numChannels) {
+    LoudnessMeter meter;
+    meter.prepare(sampleRate, numChannels, false);
+
+    float truePeak = 0.0f;
+    for (const auto& section : sections) {
+        for (double step : section.steps)
+            meter.addStep(step);
+        for (float peak : section.truePeaks)
+            truePeak = juce::jmax(truePeak, peak);
+    }
+
+    meter.m_stepEnergy = sections.back().partialEnergy;
+    meter.m_stepPosition = sections.back().partialSamples;
+    meter.updateGatedValues();
+
+    auto result = meter.getLoudnessData();
+    result.truePeak = juce::Decibels::gainToDecibels(truePeak, kMinimumPeak);
+    return result;
+}
+
+LoudnessData LoudnessMeter::measure(const juce::AudioBuffer<float>& buffer, double sampleRate, int numThreads) {
+    const int numChannels = juce::jmax(1, buffer.getNumChannels());
+    const int64_t length = buffer.getNumChannels() > 0 ? buffer.getNumSamples() : 0;
+    auto sections = makeSections(length, sampleRate, numThreads);
+
+    if (length > 0) {
+        runInParallel(sections, [&](Section& section) {
+            BufferSource source(buffer);
+            measureSection(source, sampleRate, numChannels, section);
+        });
+    }
+
+    return mergeSections(sections, sampleRate, numChannels);
+}
+
+bool LoudnessMeter::measureFile(const juce::File& file, LoudnessData& result, int numThreads) {
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int64_t length = 0;
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+            return false;
+        sampleRate = reader->sampleRate;
+        numChannels = (int) reader->numChannels;
+        length = reader->lengthInSamples;
+    }
+
+    auto sections = makeSections(length, sampleRate, numThreads);
+
+    if (length > 0) {
+        runInParallel(sections, [&](Section& section) {
+            ReaderSource source(file);
+            if (!source.isValid()) {
+                section.valid = false;
+                return;
+            }
+            measureSection(source, sampleRate, numChannels, section);
+        });
+    }
+
+    for (const auto& section : sections)
+        if (!section.valid)
+            return false;
+
+    result = mergeSections(sections, sampleRate, numChannels);
+    return true;
+}
+
+} // namespace Analysis
+} // namespace omega
@@ -0,0 +1,208 @@
+/**
+ * @file LoudnessMeter.h
+ * @brief ITU-R BS.1770 / EBU R128 loudness engine
+ *
+ * One loudness implementation for every meter and analyser (ReferenceTrackMatcher,
+ * the LUFS meters, LimiterMaximizer, AdvancedMetering, DynamicRangeAnalyzer,
+ * the mastering assistants, AudioFeatureStore):
+ * - K-weighting IIR (high shelf + high-pass) designed for any sample rate,
+ *   BS.1770 channel weights (surrounds +1.5 dB, LFE excluded)
+ * - K-weighted energy per 100 ms step; momentary (400 ms) and short-term (3 s)
+ *   blocks advance every step
+ * - Integrated loudness (-70 LUFS absolute, -10 LU relative gate) and loudness
+ *   range (EBU Tech 3342) from fixed-size gating histograms: the streaming
+ *   meter never allocates after prepare()
+ * - True peak from the polyphase TruePeakDetector (4x)
+ * - measure() / measureFile(): the audio is split into sections on step
+ *   boundaries, measured on every core and the 100 ms energies are stitched
+ *   back in order, so blocks across section boundaries are exact and the
+ *   result is the one a single streaming pass would give
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/TruePeakDetector.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace omega {
+namespace Analysis {
+
+/**
+ * @brief Loudness analysis (LUFS)
+ */
+struct LoudnessData {
+    float integratedLUFS = -23.0f;   // Overall loudness
+    float shortTermLUFS = -23.0f;    // 3-second window
+    float momentaryLUFS = -23.0f;    // 400ms window
+    float truePeak = -6.0f;          // True peak dBTP
+    float loudnessRange = 10.0f;     // LRA in LU
+    float maxMomentaryLUFS = -23.0f;
+    float maxShortTermLUFS = -23.0f;
+
+    LoudnessData() = default;
+};
+
+/**
+ * @class LoudnessMeter
+ * @brief Streaming loudness meter plus parallel whole-buffer/file measurement
+ *
+ * process() is RT-safe after prepare(). Loudness below the absolute gate (and
+ * silence) reads kMinimumLoudness; audio shorter than one 400 ms block gets
+ * its plain K-weighted mean as integrated loudness.
+ */
+class LoudnessMeter {
+public:
+    static constexpr float kMinimumLoudness = -70.0f;   // LUFS, also the absolute gate
+    static constexpr float kMinimumPeak = -100.0f;      // dBTP
+
+    LoudnessMeter();
+
+    /**
+     * Prepare meter (allocates)
+     * @param sampleRate Audio sample rate
+     * @param numChannels Channels to measure (5 or 6 = 5.0 / 5.1 in JUCE order)
+     * @param measureTruePeak False skips the true peak detectors
+     */
+    void prepare(double sampleRate, int numChannels, bool measureTruePeak = true);
+
+    /**
+     * Clear all measurements (keeps the preparation)
+     */
+    void reset();
+
+    /**
+     * Measure audio (RT-safe). Extra channels beyond the prepared ones are ignored
+     */
+    void process(const float* const* channels, int numChannels, int numSamples);
+    void process(const juce::AudioBuffer<float>& buffer) {
+        process(buffer.getArrayOfReadPointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+
+    float getMomentary() const noexcept { return m_momentary; }
+    float getShortTerm() const noexcept { return m_shortTerm; }
+    float getIntegrated() const noexcept { return m_integrated; }
+    float getLoudnessRange() const noexcept { return m_loudnessRange; }
+    float getMaxMomentary() const noexcept { return m_maxMomentary; }
+    float getMaxShortTerm() const noexcept { return m_maxShortTerm; }
+
+    /** True peak since the last reset, dBTP (all channels, or one) */
+    float getTruePeak() const noexcept;
+    float getTruePeak(int channel) const noexcept;
+
+    LoudnessData getLoudnessData() const;
+
+    bool isPrepared() const noexcept { return m_numChannels > 0; }
+    int getNumChannels() const noexcept { return m_numChannels; }
+
+    /**
+     * Measure a whole buffer on several threads
+     * @param numThreads 0 = one per core
+     */
+    static LoudnessData measure(const juce::AudioBuffer<float>& buffer, double sampleRate, int numThreads = 0);
+
+    /**
+     * Measure a whole file; every thread decodes its own section
+     * @return False if the file can't be read
+     */
+    static bool measureFile(const juce::File& file, LoudnessData& result, int numThreads = 0);
+
+    /** BS.1770 K-weighting for one channel: high shelf then high-pass */
+    struct KWeighting {
+        struct Biquad {
+            double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+            double z1 = 0.0, z2 = 0.0;
+
+            double process(double x) noexcept {
+                const double y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                return y;
+            }
+        };
+
+        explicit KWeighting(double sampleRate = 48000.0);
+
+        double process(double x) noexcept { return highPass.process(shelf.process(x)); }
+        void reset() noexcept { shelf.z1 = shelf.z2 = highPass.z1 = highPass.z2 = 0.0; }
+
+        Biquad shelf, highPass;
+    };
+
+private:
+    /**
+     * Block loudness distribution, 0.01 LU bins from the absolute gate up
+     * (fixed size: no allocation however long the measurement runs)
+     */
+    class GatingHistogram {
+    public:
+        GatingHistogram();
+        void clear();
+        void add(double meanSquare);
+        float gatedLoudness(float relativeGate) const;   // Integrated (-10 LU)
+        float range(float relativeGate) const;           // LRA (-20 LU), 10th to 95th percentile
+
+    private:
+        int findGateBin(float relativeGate) const;
+        static float binLoudness(int bin);
+
+        std::vector<uint32_t> m_counts;
+        std::vector<double> m_energies;
+        uint64_t m_totalCount = 0;
+        double m_totalEnergy = 0.0;
+    };
+
+    struct Section;
+    static std::vector<Section> makeSections(int64_t length, double sampleRate, int numThreads);
+    template <typename Source>
+    static void measureSection(Source& source, double sampleRate, int numChannels, Section& section);
+    static LoudnessData mergeSections(std::vector<Section>& sections, double sampleRate, int numChannels);
+
+    static std::vector<float> makeChannelWeights(int numChannels);
+    static double filterEnergy(KWeighting* filters, const float* weights, const float* const* channels,
+                               int numChannels, int offset, int numSamples) noexcept;
+
+    void addStep(double meanSquare) noexcept;
+    void updateGatedValues() noexcept;
+
+    static constexpr int kMomentarySteps = 4;
+    static constexpr int kShortTermSteps = 30;
+    static constexpr int kTruePeakBlockSize = 512;
+
+    double m_sampleRate = 48000.0;
+    int m_numChannels = 0;
+    int m_stepLength = 4800;                // Samples per 100 ms
+
+    std::vector<KWeighting> m_filters;
+    std::vector<float> m_channelWeights;
+
+    // Current step and the last kShortTermSteps completed ones (zeros before the start)
+    double m_stepEnergy = 0.0;
+    int m_stepPosition = 0;
+    std::array<double, kShortTermSteps> m_steps {};
+    int m_stepIndex = 0;
+    int64_t m_numSteps = 0;
+    double m_completedEnergy = 0.0;         // Mean squares of all steps (short audio fallback)
+
+    GatingHistogram m_momentaryBlocks;      // Integrated loudness
+    GatingHistogram m_shortTermBlocks;      // Loudness range
+
+    float m_momentary = kMinimumLoudness;
+    float m_shortTerm = kMinimumLoudness;
+    float m_integrated = kMinimumLoudness;
+    float m_loudnessRange = 0.0f;
+    float m_maxMomentary = kMinimumLoudness;
+    float m_maxShortTerm = kMinimumLoudness;
+
+    bool m_measureTruePeak = true;
+    std::vector<OmegaStudio::TruePeakDetector> m_truePeakDetectors;
+    std::vector<float> m_truePeaks;         // Linear, per channel
+    std::vector<float> m_peakScratch;
+
+    JUCE_LEAK_DETECTOR(LoudnessMeter)
+};
+
+} // namespace Analysis
+} // namespace omega
@@ -8,6 +8,7 @@
 */
 
 #include "ReferenceMatching.h"
+#include "AudioFeatureStore.h"
 #include <cmath>
 #include <algorithm>
 
@@ -56,6 +57,9 @@ void ReferenceTrackMatcher::loadReferenceTrack(const juce::File& audioFile) {
                             static_cast<int>(reader->lengthInSamples));
     reader->read(&referenceBuffer_, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
     
+    // Whole-track features (stored, so loading the same reference again is instant)
+    referenceFeatures_ = AudioFeatureStore::getInstance().getFeatures(audioFile, referenceBuffer_, reader->sampleRate);
+    
     delete reader;
     
     hasReference_ = true;
@@ -64,12 +68,14 @@ void ReferenceTrackMatcher::loadReferenceTrack(const juce::File& audioFile) {
 
 void ReferenceTrackMatcher::setReferenceBuffer(const juce::AudioBuffer<float>& buffer) {
     referenceBuffer_ = buffer;
+    referenceFeatures_ = AudioFeatureStore::getInstance().getFeatures(referenceBuffer_, sampleRate_);
     hasReference_ = true;
     analyzeReferenceTrack();
 }
 
 void ReferenceTrackMatcher::clearReference() {
     referenceBuffer_.setSize(0, 0);
+    referenceFeatures_.reset();
     hasReference_ = false;
     referenceSpectrum_.clear();
 }
@@ -77,7 +83,19 @@ void ReferenceTrackMatcher::clearReference() {
 void ReferenceTrackMatcher::analyzeReferenceTrack() {
     if (!hasReference_ || referenceBuffer_.getNumSamples() == 0) return;
     
-    // Analyze spectrum (use middle section of track)
+    // Long-term spectrum of the whole track when the stored one fits the current settings
+    if (referenceFeatures_ != nullptr
+        && fftSize_ == AudioFeatures::kSpectrumFftSize
+        && windowType_ == juce::dsp::WindowingFunction<float>::hann
+        && referenceFeatures_->summary.sampleRate == sampleRate_
+        && referenceFeatures_->spectrum.size() == static_cast<size_t>(fftSize_ / 2)) {
+        referenceSpectrum_ = SpectrumData(fftSize_, sampleRate_);
+        referenceSpectrum_.magnitudes = referenceFeatures_->spectrum;
+        referenceLoudness_ = analyzeLoudness(referenceBuffer_);
+        return;
+    }
+    
+    // Otherwise analyze spectrum (use middle section of track)
     int startSample = referenceBuffer_.getNumSamples() / 2;
     int numSamples = std::min(fftSize_, referenceBuffer_.getNumSamples() - startSample);
     referenceSpectrum_ = analyzeSpectrum(referenceBuffer_, startSample, numSamples);
@@ -137,64 +155,8 @@ void ReferenceTrackMatcher::performFFT(const juce::AudioBuffer<float>& buffer, S
 }
 
 LoudnessData ReferenceTrackMatcher::analyzeLoudness(const juce::AudioBuffer<float>& buffer) {
-    LoudnessData result;
-    
-    result.integratedLUFS = calculateLUFS(buffer);
-    result.truePeak = calculateTruePeak(buffer);
-    
-    // Simplified loudness range calculation
-    result.loudnessRange = 10.0f; // TODO: Implement proper LRA
-    
-    // Short-term and momentary use same as integrated for now
-    result.shortTermLUFS = result.integratedLUFS;
-    result.momentaryLUFS = result.integratedLUFS;
-    
-    return result;
-}
-
-float ReferenceTrackMatcher::calculateLUFS(const juce::AudioBuffer<float>& buffer) {
-    if (buffer.getNumSamples() == 0) return -70.0f;
-    
-    // Simplified LUFS calculation (ITU-R BS.1770)
-    // Real implementation would use K-weighting filter
-    
-    double sumSquares = 0.0;
-    int numChannels = buffer.getNumChannels();
-    int numSamples = buffer.getNumSamples();
-    
-    for (int ch = 0; ch < numChannels; ++ch) {
-        const float* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            double sample = data[i];
-            sumSquares += sample * sample;
-        }
-    }
-    
-    double meanSquare = sumSquares / (numChannels * numSamples);
-    double rms = std::sqrt(meanSquare);
-    
-    // Convert to LUFS (approximately)
-    float lufs = -23.0f + 20.0f * std::log10(static_cast<float>(rms) + 1e-10f);
-    
-    return juce::jlimit(-70.0f, 0.0f, lufs);
-}
-
-float ReferenceTrackMatcher::calculateTruePeak(const juce::AudioBuffer<float>& buffer) {
-    float maxPeak = 0.0f;
-    
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto* data = buffer.getReadPointer(ch);
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            float absSample = std::abs(data[i]);
-            if (absSample > maxPeak) {
-                maxPeak = absSample;
-            }
-        }
-    }
-    
-    // Convert to dBTP
-    float dBTP = maxPeak > 0.0f ? 20.0f * std::log10(maxPeak) : -100.0f;
-    return dBTP;
+    // Whole-buffer BS.1770 measurement (gated integrated, LRA, true peak)
+    return LoudnessMeter::measure(buffer, sampleRate_);
 }
 
 FrequencyMatchResult ReferenceTrackMatcher::compareToReference(const juce::AudioBuffer<float>& buffer) {
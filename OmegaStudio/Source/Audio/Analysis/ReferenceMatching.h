@@ -10,12 +10,16 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "LoudnessMeter.h"
 #include <vector>
 #include <array>
+#include <memory>
 
 namespace omega {
 namespace Analysis {
 
+struct AudioFeatures;
+
 /**
  * @brief Spectral analysis result from FFT
  */
@@ -41,19 +45,6 @@ struct SpectrumData {
     }
 };
 
-/**
- * @brief Loudness analysis (LUFS)
- */
-struct LoudnessData {
-    float integratedLUFS = -23.0f;   // Overall loudness
-    float shortTermLUFS = -23.0f;    // 3-second window
-    float momentaryLUFS = -23.0f;    // 400ms window
-    float truePeak = -6.0f;          // True peak dBTP
-    float loudnessRange = 10.0f;     // LRA in LU
-    
-    LoudnessData() = default;
-};
-
 /**
  * @brief Frequency response comparison result
  */
@@ -107,9 +98,6 @@ public:
 private:
     void analyzeReferenceTrack();
     void performFFT(const juce::AudioBuffer<float>& buffer, SpectrumData& result, int startSample, int numSamples);
-    float calculateLUFS(const juce::AudioBuffer<float>& buffer);
-    float calculateTruePeak(const juce::AudioBuffer<float>& buffer);
-    void applyKWeighting(std::vector<float>& spectrum);
     
     double sampleRate_ = 48000.0;
     int fftSize_ = 4096;
@@ -122,6 +110,7 @@ private:
     
     // Reference track
     juce::AudioBuffer<float> referenceBuffer_;
+    std::shared_ptr<const AudioFeatures> referenceFeatures_;  // From AudioFeatureStore
     bool hasReference_ = false;
     SpectrumData referenceSpectrum_;
     LoudnessData referenceLoudness_;
@@ -50,13 +50,10 @@ void CorrelationMeter::process(const juce::AudioBuffer<float>& buffer) { if (buf
 void CorrelationMeter::reset() { sumLeft = 0.0f; sumRight = 0.0f; sumProduct = 0.0f; sampleCount = 0; }
 void CorrelationMeter::setIntegrationTime(float seconds) { integrationTime = seconds; }
 
-LUFSMeter::LUFSMeter() : oversampling(2, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR) {}
-void LUFSMeter::prepareToPlay(double sr, int blockSize) { sampleRate = sr; juce::dsp::ProcessSpec spec{sr, static_cast<juce::uint32>(blockSize), 2}; oversampling.initProcessing(blockSize); updateFilters(); }
-void LUFSMeter::process(const juce::AudioBuffer<float>&) {}
-void LUFSMeter::reset() { momentaryLUFS = shortTermLUFS = integratedLUFS = -70.0f; lra = 0.0f; truePeakLeft = truePeakRight = -70.0f; }
-void LUFSMeter::updateFilters() {}
-float LUFSMeter::calculateLoudness(const std::deque<float>&) const { return -23.0f; }
-void LUFSMeter::applyGating() {}
+LUFSMeter::LUFSMeter() {}
+void LUFSMeter::prepareToPlay(double sr, int) { engine.prepare(sr, 2); }
+void LUFSMeter::process(const juce::AudioBuffer<float>& buffer) { engine.process(buffer); }
+void LUFSMeter::reset() { engine.reset(); }
 
 Vectorscope::Vectorscope(int) {}
 void Vectorscope::prepareToPlay(double sr) { sampleRate = sr; }
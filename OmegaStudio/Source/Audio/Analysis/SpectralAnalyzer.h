@@ -17,6 +17,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "LoudnessMeter.h"
 #include <vector>
 #include <deque>
 #include <array>
@@ -151,42 +152,20 @@ public:
     void reset();
     
     // Loudness values
-    float getMomentaryLUFS() const { return momentaryLUFS; }    // 400ms
-    float getShortTermLUFS() const { return shortTermLUFS; }    // 3s
-    float getIntegratedLUFS() const { return integratedLUFS; }  // entire duration
+    float getMomentaryLUFS() const { return engine.getMomentary(); }    // 400ms
+    float getShortTermLUFS() const { return engine.getShortTerm(); }    // 3s
+    float getIntegratedLUFS() const { return engine.getIntegrated(); }  // entire duration
     
     // Loudness Range (LRA)
-    float getLRA() const { return lra; }
+    float getLRA() const { return engine.getLoudnessRange(); }
     
     // True Peak
-    float getTruePeakLeft() const { return truePeakLeft; }
-    float getTruePeakRight() const { return truePeakRight; }
+    float getTruePeakLeft() const { return engine.getTruePeak(0); }
+    float getTruePeakRight() const { return engine.getTruePeak(1); }
     
 private:
-    double sampleRate { 48000.0 };
-    
-    float momentaryLUFS { -70.0f };
-    float shortTermLUFS { -70.0f };
-    float integratedLUFS { -70.0f };
-    float lra { 0.0f };
-    float truePeakLeft { -70.0f };
-    float truePeakRight { -70.0f };
-    
-    // K-weighting filter (IIR)
-    juce::dsp::IIR::Filter<float> preFilterLeft, preFilterRight;
-    juce::dsp::IIR::Filter<float> rlbFilterLeft, rlbFilterRight;
-    
-    // Gating blocks
-    std::deque<float> momentaryBlocks;
-    std::deque<float> shortTermBlocks;
-    std::vector<float> allBlocks;
-    
-    // True peak oversampling
-    juce::dsp::Oversampling<float> oversampling { 2, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR };
-    
-    void updateFilters();
-    float calculateLoudness(const std::deque<float>& blocks) const;
-    void applyGating();
+    // Shared BS.1770 engine: K-weighting, gating histograms, 4x true peak
+    omega::Analysis::LoudnessMeter engine;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LUFSMeter)
 };
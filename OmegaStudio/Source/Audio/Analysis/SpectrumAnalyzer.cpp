@@ -186,7 +186,20 @@ void SpectrumAnalyzer::updateSonogram()
 //==============================================================================
 void SpectrumAnalyzer::setSettings(const Settings& settings)
 {
+    const int previousOrder = settings_.fftOrder;
     settings_ = settings;
+    settings_.fftOrder = juce::jlimit(8, maxFftOrder, settings.fftOrder);
+    
+    // El FFT, la ventana y el FIFO siguen al tamaño elegido
+    if (settings_.fftOrder != previousOrder || fft_.getSize() != (1 << settings_.fftOrder))
+    {
+        const int fftSize = 1 << settings_.fftOrder;
+        fft_ = juce::dsp::FFT(settings_.fftOrder);
+        window_.fillWindowingTables(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann);
+        fifo_.setSize(2, fftSize);
+        fifo_.clear();
+        fifoPos_ = 0;
+    }
     
     magnitudeSpectrum_.resize(settings_.numBands, 0.0f);
     peakSpectrum_.resize(settings_.numBands, -100.0f);
@@ -28,10 +28,41 @@ void TonalBalanceAnalyzer::initialize(double sampleRate, int fftSize) {
     setFFTSize(fftSize);
     bands_ = getStandardOctaveBands();
     setTargetCurve(TargetCurve::Flat);
+    
+    currentResult_.octaveBandLevels.assign(bands_.size(), -100.0f);
+    currentResult_.difference.assign(bands_.size(), 0.0f);
+    designFilterBank();
 }
 
 void TonalBalanceAnalyzer::setSampleRate(double newSampleRate) {
     sampleRate_ = newSampleRate;
+    designFilterBank();
+}
+
+void TonalBalanceAnalyzer::designFilterBank() {
+    // Two identical band-pass stages: each is -1.5 dB at the 1/3 octave edges,
+    // so the pair is -3 dB there. Qstage = sqrt(sqrt(2) - 1) * fc / (fu - fl)
+    const double bandQ = 1.0 / (std::pow(2.0, 1.0 / 6.0) - std::pow(2.0, -1.0 / 6.0));
+    const double stageQ = std::sqrt(std::sqrt(2.0) - 1.0) * bandQ;
+    const int numLanes = OmegaStudio::BiquadCascade::maxLanes;
+    
+    for (int bank = 0; bank < numFilterBanks; ++bank) {
+        auto& cascade = filterBank_[static_cast<size_t>(bank)];
+        cascade.prepare(sampleRate_);
+        
+        for (int lane = 0; lane < numLanes; ++lane) {
+            const size_t band = static_cast<size_t>(bank * numLanes + lane);
+            const auto coeffs = band < bands_.size()
+                ? OmegaStudio::BiquadCoefficients::bandPass(sampleRate_, bands_[band].centerFreq, stageQ)
+                : OmegaStudio::BiquadCoefficients {};
+            cascade.setStageLane(0, lane, coeffs, true);
+            cascade.setStageLane(1, lane, coeffs, true);
+        }
+    }
+    
+    bandEnergy_.fill(0.0);
+    sampleCounter_ = 0;
+    samplesPerUpdate_ = std::max(1, static_cast<int>(sampleRate_ * 0.1));
 }
 
 void TonalBalanceAnalyzer::setFFTSize(int size) {
@@ -218,12 +249,70 @@ juce::String TonalBalanceAnalyzer::getTonalBalanceAssessment() const {
 }
 
 void TonalBalanceAnalyzer::processBlock(const juce::AudioBuffer<float>& buffer) {
-    sampleCounter_ += buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels == 0)
+        return;
+    
+    const int numLanes = OmegaStudio::BiquadCascade::maxLanes;
+    float* lanes[OmegaStudio::BiquadCascade::maxLanes];
+    for (int lane = 0; lane < numLanes; ++lane)
+        lanes[lane] = bandScratch_[static_cast<size_t>(lane)].data();
+    
+    int position = 0;
+    while (position < numSamples) {
+        // Chunks never straddle an update so each report covers exactly samplesPerUpdate_
+        const int chunk = std::min({ filterBankChunk, numSamples - position, samplesPerUpdate_ - sampleCounter_ });
+        
+        // Mix to mono
+        float* mono = monoScratch_.data();
+        juce::FloatVectorOperations::copy(mono, buffer.getReadPointer(0, position), chunk);
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::add(mono, buffer.getReadPointer(ch, position), chunk);
+        juce::FloatVectorOperations::multiply(mono, 1.0f / static_cast<float>(numChannels), chunk);
+        
+        // Each cascade filters the same input through 4 bands at once
+        for (int bank = 0; bank < numFilterBanks; ++bank) {
+            filterBank_[static_cast<size_t>(bank)].processBroadcast(mono, lanes, numLanes, chunk);
+            
+            for (int lane = 0; lane < numLanes; ++lane) {
+                double energy = 0.0;
+                for (int i = 0; i < chunk; ++i)
+                    energy += static_cast<double>(lanes[lane][i]) * lanes[lane][i];
+                bandEnergy_[static_cast<size_t>(bank * numLanes + lane)] += energy;
+            }
+        }
+        
+        position += chunk;
+        sampleCounter_ += chunk;
+        
+        if (sampleCounter_ >= samplesPerUpdate_) {
+            publishFilterBankLevels();
+            sampleCounter_ = 0;
+            bandEnergy_.fill(0.0);
+        }
+    }
+}
+
+void TonalBalanceAnalyzer::publishFilterBankLevels() {
+    // Band RMS in dBFS; vectors were sized in initialize() so nothing allocates here
+    auto& levels = currentResult_.octaveBandLevels;
+    const size_t numBands = std::min(levels.size(), bandEnergy_.size());
+    for (size_t i = 0; i < numBands; ++i) {
+        const double meanSquare = bandEnergy_[i] / static_cast<double>(samplesPerUpdate_);
+        levels[i] = meanSquare > 1.0e-10 ? static_cast<float>(10.0 * std::log10(meanSquare)) : -100.0f;
+    }
+    
+    calculateEnergyDistribution();
     
-    if (sampleCounter_ >= samplesPerUpdate_) {
-        sampleCounter_ = 0;
-        currentResult_ = analyze(buffer);
+    const auto& target = currentResult_.targetCurve;
+    auto& difference = currentResult_.difference;
+    if (target.size() == levels.size() && difference.size() == levels.size()) {
+        for (size_t i = 0; i < levels.size(); ++i)
+            difference[i] = levels[i] - target[i];
     }
+    
+    currentResult_.overallScore = calculateDifferenceScore();
 }
 
 // ============================================================================
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "../DSP/BiquadCascade.h"
 #include <vector>
 #include <array>
 
@@ -77,7 +78,7 @@ public:
     void initialize(double sampleRate, int fftSize = 8192);
     void setSampleRate(double newSampleRate);
     
-    // Analysis
+    // Analysis: analyze() is a one-shot FFT; processBlock() streams through the filter bank
     TonalBalanceResult analyze(const juce::AudioBuffer<float>& buffer);
     void processBlock(const juce::AudioBuffer<float>& buffer);
     const TonalBalanceResult& getCurrentResult() const { return currentResult_; }
@@ -105,6 +106,8 @@ private:
     void performOctaveBandAnalysis(const juce::AudioBuffer<float>& buffer);
     void calculateEnergyDistribution();
     std::vector<float> getTargetCurveData(TargetCurve curve) const;
+    void designFilterBank();
+    void publishFilterBankLevels();
     
     double sampleRate_ = 48000.0;
     int fftSize_ = 8192;
@@ -126,6 +129,17 @@ private:
     // Update rate limiting
     int sampleCounter_ = 0;
     int samplesPerUpdate_ = 4800; // Update every 100ms at 48kHz
+    
+    // Streaming 1/3 octave filter bank: 7 cascades x 4 lanes = 28 bands,
+    // two band-pass stages per band
+    static constexpr int numFilterBanks = 7;
+    static constexpr int numStreamingBands = numFilterBanks * OmegaStudio::BiquadCascade::maxLanes;
+    static constexpr int filterBankChunk = 256;
+    
+    std::array<OmegaStudio::BiquadCascade, numFilterBanks> filterBank_;
+    std::array<double, numStreamingBands> bandEnergy_ {};
+    std::array<float, filterBankChunk> monoScratch_ {};
+    std::array<std::array<float, filterBankChunk>, OmegaStudio::BiquadCascade::maxLanes> bandScratch_ {};
 };
 
 /**
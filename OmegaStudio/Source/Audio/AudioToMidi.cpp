@@ -18,18 +18,10 @@ AudioToMidi::AudioToMidi()
     , minPitchHz_(80.0f)
     , maxPitchHz_(1200.0f)
     , maxPolyphony_(1)
-    , fft_(11)  // 2048-point FFT
     , fftSize_(2048)
     , noteIsActive_(false)
 {
-    fftData_.resize(fftSize_ * 2, 0.0f);
-    
-    // Hanning window
-    window_.resize(fftSize_);
-    for (int i = 0; i < fftSize_; ++i)
-    {
-        window_[i] = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * i / (fftSize_ - 1)));
-    }
+    pitchTracker_.initialize(sampleRate_, getTrackerSettings());
 }
 
 AudioToMidi::~AudioToMidi()
@@ -39,11 +31,13 @@ AudioToMidi::~AudioToMidi()
 void AudioToMidi::initialize(double sampleRate)
 {
     sampleRate_ = sampleRate;
+    pitchTracker_.initialize(sampleRate_, getTrackerSettings());
 }
 
 void AudioToMidi::setSampleRate(double sampleRate)
 {
     sampleRate_ = sampleRate;
+    pitchTracker_.initialize(sampleRate_, getTrackerSettings());
 }
 
 void AudioToMidi::setMonophonic(bool mono)
@@ -75,11 +69,13 @@ void AudioToMidi::setVibratoTolerance(float cents)
 void AudioToMidi::setMinPitchHz(float hz)
 {
     minPitchHz_ = juce::jlimit(20.0f, 2000.0f, hz);
+    pitchTracker_.initialize(sampleRate_, getTrackerSettings());
 }
 
 void AudioToMidi::setMaxPitchHz(float hz)
 {
     maxPitchHz_ = juce::jlimit(100.0f, 5000.0f, hz);
+    pitchTracker_.initialize(sampleRate_, getTrackerSettings());
 }
 
 void AudioToMidi::setPolyphonyLevel(int maxNotes)
@@ -92,33 +88,39 @@ void AudioToMidi::analyzeAudio(const juce::AudioBuffer<float>& audioBuffer)
     detectedNotes_.clear();
     pitchFrames_.clear();
     
-    // Detect onsets first
-    detectOnsets(audioBuffer);
+    // Onsets and tempo first: shared feature store (cached by content)
+    auto features = Analysis::AudioFeatureStore::getInstance().getFeatures(audioBuffer, sampleRate_);
+    
+    onsetTimes_.clear();
+    rhythmInfo_.onsetStrengths.clear();
+    if (features)
+    {
+        for (const auto& onset : features->selectOnsets(onsetThreshold_))
+        {
+            onsetTimes_.push_back(onset.position / sampleRate_);
+            rhythmInfo_.onsetStrengths.push_back(onset.strength);
+        }
+    }
     
-    // Analyze pitch over time
+    // Analyze pitch over time: shared tracker, one frame per hop (75% overlap)
     const float* audioData = audioBuffer.getReadPointer(0);
     int numSamples = audioBuffer.getNumSamples();
     
-    int hopSize = fftSize_ / 4;  // 75% overlap
-    int numFrames = (numSamples - fftSize_) / hopSize;
+    PitchTracker tracker;
+    tracker.initialize(sampleRate_, getTrackerSettings());
+    const int frameSize = tracker.getFrameSize();
     
-    for (int frame = 0; frame < numFrames; ++frame)
+    tracker.push(audioData, numSamples, [&](const PitchEstimate& estimate, int frameEnd)
     {
-        int startSample = frame * hopSize;
-        
-        float frequency = 0.0f;
-        float confidence = 0.0f;
-        detectPitch(audioData + startSample, fftSize_, frequency, confidence);
+        if (frameEnd < frameSize || !estimate.voiced)
+            return;
         
-        if (frequency >= minPitchHz_ && frequency <= maxPitchHz_ && confidence > 0.3f)
-        {
-            PitchFrame pf;
-            pf.time = startSample / sampleRate_;
-            pf.frequency = frequency;
-            pf.confidence = confidence;
-            pitchFrames_.push_back(pf);
-        }
-    }
+        PitchFrame pf;
+        pf.time = (frameEnd - frameSize) / sampleRate_;
+        pf.frequency = estimate.frequency;
+        pf.confidence = estimate.confidence;
+        pitchFrames_.push_back(pf);
+    });
     
     // Segment into notes
     segmentNotes();
@@ -128,80 +130,18 @@ void AudioToMidi::analyzeAudio(const juce::AudioBuffer<float>& audioBuffer)
     
     // Detect rhythm
     rhythmInfo_.onsetTimes = onsetTimes_;
-    // TODO: Implement tempo estimation
-    rhythmInfo_.estimatedTempo = 120.0;
+    rhythmInfo_.estimatedTempo = (features && features->summary.bpm > 0.0f) ? features->summary.bpm : 120.0;
     rhythmInfo_.timeSignatureNum = 4;
     rhythmInfo_.timeSignatureDenom = 4;
 }
 
-void AudioToMidi::detectPitch(const float* audioData, int numSamples, float& frequency, float& confidence)
+PitchTracker::Settings AudioToMidi::getTrackerSettings() const
 {
-    // Use YIN algorithm for pitch detection
-    float yinFreq = yin(audioData, numSamples);
-    
-    if (yinFreq > 0.0f)
-    {
-        frequency = yinFreq;
-        confidence = 0.8f;  // TODO: Calculate actual confidence from YIN
-    }
-    else
-    {
-        frequency = 0.0f;
-        confidence = 0.0f;
-    }
-}
-
-float AudioToMidi::yin(const float* data, int length)
-{
-    std::vector<float> difference(length / 2);
-    
-    // Step 1: Calculate difference function
-    for (int tau = 0; tau < length / 2; ++tau)
-    {
-        float sum = 0.0f;
-        for (int j = 0; j < length / 2; ++j)
-        {
-            float delta = data[j] - data[j + tau];
-            sum += delta * delta;
-        }
-        difference[tau] = sum;
-    }
-    
-    // Step 2: Cumulative mean normalized difference
-    difference[0] = 1.0f;
-    float runningSum = 0.0f;
-    for (int tau = 1; tau < length / 2; ++tau)
-    {
-        runningSum += difference[tau];
-        difference[tau] *= tau / runningSum;
-    }
-    
-    // Step 3: Find first minimum below threshold
-    float threshold = 0.1f;
-    for (int tau = 2; tau < length / 2; ++tau)
-    {
-        if (difference[tau] < threshold)
-        {
-            // Check if it's a local minimum
-            if (tau + 1 < length / 2 && difference[tau] < difference[tau + 1])
-            {
-                // Parabolic interpolation for sub-sample accuracy
-                float betterTau = tau;
-                if (tau > 0 && tau < length / 2 - 1)
-                {
-                    float s0 = difference[tau - 1];
-                    float s1 = difference[tau];
-                    float s2 = difference[tau + 1];
-                    betterTau = tau + (s2 - s0) / (2.0f * (2.0f * s1 - s2 - s0));
-                }
-                
-                float frequency = static_cast<float>(sampleRate_) / betterTau;
-                return frequency;
-            }
-        }
-    }
-    
-    return 0.0f;  // No pitch detected
+    PitchTracker::Settings settings;
+    settings.minFrequency = minPitchHz_;
+    settings.maxFrequency = maxPitchHz_;
+    settings.hopSize = fftSize_ / 4;
+    return settings;
 }
 
 float AudioToMidi::autocorrelation(const float* data, int length, int lag)
@@ -214,69 +154,6 @@ float AudioToMidi::autocorrelation(const float* data, int length, int lag)
     return sum;
 }
 
-void AudioToMidi::detectOnsets(const juce::AudioBuffer<float>& audioBuffer)
-{
-    onsetTimes_.clear();
-    spectralFlux_.clear();
-    
-    const float* audioData = audioBuffer.getReadPointer(0);
-    int numSamples = audioBuffer.getNumSamples();
-    
-    int hopSize = fftSize_ / 4;
-    int numFrames = (numSamples - fftSize_) / hopSize;
-    
-    std::vector<float> prevSpectrum(fftSize_ / 2, 0.0f);
-    
-    for (int frame = 0; frame < numFrames; ++frame)
-    {
-        int startSample = frame * hopSize;
-        
-        // Apply window and copy to FFT buffer
-        for (int i = 0; i < fftSize_; ++i)
-        {
-            fftData_[i] = audioData[startSample + i] * window_[i];
-        }
-        
-        // Perform FFT
-        fft_.performFrequencyOnlyForwardTransform(fftData_.data());
-        
-        // Calculate spectral flux
-        std::vector<float> currentSpectrum(fftSize_ / 2);
-        for (int i = 0; i < fftSize_ / 2; ++i)
-        {
-            currentSpectrum[i] = fftData_[i];
-        }
-        
-        float flux = calculateSpectralFlux(prevSpectrum, currentSpectrum);
-        spectralFlux_.push_back(flux);
-        
-        // Detect onset if flux exceeds threshold
-        if (frame > 2)
-        {
-            float avgFlux = (spectralFlux_[frame - 2] + spectralFlux_[frame - 1] + flux) / 3.0f;
-            if (flux > avgFlux * (1.0f + onsetThreshold_ * 3.0f))
-            {
-                double onsetTime = startSample / sampleRate_;
-                onsetTimes_.push_back(onsetTime);
-            }
-        }
-        
-        prevSpectrum = currentSpectrum;
-    }
-}
-
-float AudioToMidi::calculateSpectralFlux(const std::vector<float>& spectrum1, const std::vector<float>& spectrum2)
-{
-    float flux = 0.0f;
-    for (size_t i = 0; i < spectrum1.size(); ++i)
-    {
-        float diff = spectrum2[i] - spectrum1[i];
-        if (diff > 0.0f)
-            flux += diff;
-    }
-    return flux;
-}
-
 void AudioToMidi::segmentNotes()
 {
     if (pitchFrames_.empty())
@@ -406,17 +283,13 @@ void AudioToMidi::exportToMidiFile(const juce::File& outputFile) const
 
 void AudioToMidi::processBlock(const float* inputData, int numSamples)
 {
-    // Real-time pitch detection for live conversion
-    float frequency = 0.0f;
-    float confidence = 0.0f;
-    
-    if (numSamples >= fftSize_)
+    // Real-time pitch detection for live conversion: one decision per tracker
+    // hop, whatever the host block size
+    pitchTracker_.push(inputData, numSamples, [this](const PitchEstimate& estimate, int)
     {
-        detectPitch(inputData, fftSize_, frequency, confidence);
-        
-        if (frequency >= minPitchHz_ && frequency <= maxPitchHz_ && confidence > 0.5f)
+        if (estimate.voiced)
         {
-            int midiNote = quantizePitch(frequencyToMidi(frequency));
+            int midiNote = quantizePitch(frequencyToMidi(estimate.frequency));
             
             if (!noteIsActive_ || midiNote != currentNote_.midiNote)
             {
@@ -429,7 +302,7 @@ void AudioToMidi::processBlock(const float* inputData, int numSamples)
                 // Start new note
                 currentNote_.midiNote = midiNote;
                 currentNote_.velocity = 0.8f;
-                currentNote_.confidence = confidence;
+                currentNote_.confidence = estimate.confidence;
                 currentNote_.startTime = 0.0;  // Set by caller
                 currentNote_.duration = 0.0;
                 noteIsActive_ = true;
@@ -441,7 +314,7 @@ void AudioToMidi::processBlock(const float* inputData, int numSamples)
             newNotes_.push_back(currentNote_);
             noteIsActive_ = false;
         }
-    }
+    });
 }
 
 bool AudioToMidi::hasNewNote() const
@@ -3,6 +3,8 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <memory>
+#include "DSP/PitchTracker.h"
+#include "Analysis/AudioFeatureStore.h"
 
 namespace omega {
 
@@ -92,11 +94,8 @@ private:
     std::vector<DetectedNote> detectedNotes_;
     RhythmDetection rhythmInfo_;
     
-    // FFT analysis
-    juce::dsp::FFT fft_;
+    // Analysis frame size (pitch tracker hop = fftSize_ / 4)
     int fftSize_;
-    std::vector<float> fftData_;
-    std::vector<float> window_;
     
     // Pitch detection state
     struct PitchFrame {
@@ -105,9 +104,9 @@ private:
         float confidence;
     };
     std::vector<PitchFrame> pitchFrames_;
+    PitchTracker pitchTracker_;         // Real-time detection (prepared by the setters)
     
     // Onset detection state
-    std::vector<float> spectralFlux_;
     std::vector<double> onsetTimes_;
     
     // Real-time state
@@ -116,14 +115,10 @@ private:
     std::vector<DetectedNote> newNotes_;
     
     // Processing methods
-    void detectPitch(const float* audioData, int numSamples, float& frequency, float& confidence);
+    PitchTracker::Settings getTrackerSettings() const;
     float autocorrelation(const float* data, int length, int lag);
-    float yin(const float* data, int length);
     float spectralPeakDetection(const std::vector<float>& spectrum);
     
-    void detectOnsets(const juce::AudioBuffer<float>& audioBuffer);
-    float calculateSpectralFlux(const std::vector<float>& spectrum1, const std::vector<float>& spectrum2);
-    
     void segmentNotes();
     void mergeNotes();
     
@@ -0,0 +1,343 @@
+//==============================================================================
+// BiquadCascade.cpp - Cascaded biquad engine
+//==============================================================================
+
+#include "BiquadCascade.h"
+#include "SIMDProcessor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OmegaStudio {
+
+using Omega::Audio::DSP::Vec4;
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2) {
+    return { static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+             static_cast<float>(a1 / a0), static_cast<float>(a2 / a0) };
+}
+
+struct Prewarp {
+    double cosOmega, sinOmega;
+
+    Prewarp(double sampleRate, double frequency) {
+        const double omega = 2.0 * pi * std::clamp(frequency, 1.0, sampleRate * 0.49) / sampleRate;
+        cosOmega = std::cos(omega);
+        sinOmega = std::sin(omega);
+    }
+};
+
+} // namespace
+
+//==============================================================================
+// BiquadCoefficients
+//==============================================================================
+
+BiquadCoefficients BiquadCoefficients::peak(double sampleRate, double frequency, double Q, double gainDb) {
+    if (gainDb == 0.0)
+        return {};
+
+    const Prewarp w(sampleRate, frequency);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double alpha = w.sinOmega / (2.0 * Q);
+    return normalise(1.0 + alpha * A, -2.0 * w.cosOmega, 1.0 - alpha * A,
+                     1.0 + alpha / A, -2.0 * w.cosOmega, 1.0 - alpha / A);
+}
+
+BiquadCoefficients BiquadCoefficients::lowShelf(double sampleRate, double frequency, double Q, double gainDb) {
+    if (gainDb == 0.0)
+        return {};
+
+    const Prewarp w(sampleRate, frequency);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double beta = std::sqrt(A) / Q * w.sinOmega;
+    return normalise(A * ((A + 1.0) - (A - 1.0) * w.cosOmega + beta),
+                     2.0 * A * ((A - 1.0) - (A + 1.0) * w.cosOmega),
+                     A * ((A + 1.0) - (A - 1.0) * w.cosOmega - beta),
+                     (A + 1.0) + (A - 1.0) * w.cosOmega + beta,
+                     -2.0 * ((A - 1.0) + (A + 1.0) * w.cosOmega),
+                     (A + 1.0) + (A - 1.0) * w.cosOmega - beta);
+}
+
+BiquadCoefficients BiquadCoefficients::highShelf(double sampleRate, double frequency, double Q, double gainDb) {
+    if (gainDb == 0.0)
+        return {};
+
+    const Prewarp w(sampleRate, frequency);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double beta = std::sqrt(A) / Q * w.sinOmega;
+    return normalise(A * ((A + 1.0) + (A - 1.0) * w.cosOmega + beta),
+                     -2.0 * A * ((A - 1.0) + (A + 1.0) * w.cosOmega),
+                     A * ((A + 1.0) + (A - 1.0) * w.cosOmega - beta),
+                     (A + 1.0) - (A - 1.0) * w.cosOmega + beta,
+                     2.0 * ((A - 1.0) - (A + 1.0) * w.cosOmega),
+                     (A + 1.0) - (A - 1.0) * w.cosOmega - beta);
+}
+
+BiquadCoefficients BiquadCoefficients::lowPass(double sampleRate, double frequency, double Q) {
+    const Prewarp w(sampleRate, frequency);
+    const double alpha = w.sinOmega / (2.0 * Q);
+    return normalise((1.0 - w.cosOmega) * 0.5, 1.0 - w.cosOmega, (1.0 - w.cosOmega) * 0.5,
+                     1.0 + alpha, -2.0 * w.cosOmega, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::highPass(double sampleRate, double frequency, double Q) {
+    const Prewarp w(sampleRate, frequency);
+    const double alpha = w.sinOmega / (2.0 * Q);
+    return normalise((1.0 + w.cosOmega) * 0.5, -(1.0 + w.cosOmega), (1.0 + w.cosOmega) * 0.5,
+                     1.0 + alpha, -2.0 * w.cosOmega, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::bandPass(double sampleRate, double frequency, double Q) {
+    const Prewarp w(sampleRate, frequency);
+    const double alpha = w.sinOmega / (2.0 * Q);
+    return normalise(alpha, 0.0, -alpha, 1.0 + alpha, -2.0 * w.cosOmega, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::notch(double sampleRate, double frequency, double Q) {
+    const Prewarp w(sampleRate, frequency);
+    const double alpha = w.sinOmega / (2.0 * Q);
+    return normalise(1.0, -2.0 * w.cosOmega, 1.0, 1.0 + alpha, -2.0 * w.cosOmega, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::allPass(double sampleRate, double frequency, double Q) {
+    const Prewarp w(sampleRate, frequency);
+    const double alpha = w.sinOmega / (2.0 * Q);
+    return normalise(1.0 - alpha, -2.0 * w.cosOmega, 1.0 + alpha, 1.0 + alpha, -2.0 * w.cosOmega, 1.0 - alpha);
+}
+
+std::complex<double> BiquadCoefficients::response(double frequency, double sampleRate) const {
+    const double omega = 2.0 * pi * frequency / sampleRate;
+    const std::complex<double> z1 = std::polar(1.0, -omega);
+    const std::complex<double> z2 = z1 * z1;
+    return (static_cast<double>(b0) + static_cast<double>(b1) * z1 + static_cast<double>(b2) * z2)
+         / (1.0 + static_cast<double>(a1) * z1 + static_cast<double>(a2) * z2);
+}
+
+//==============================================================================
+// BiquadCascade
+//==============================================================================
+
+BiquadCascade::BiquadCascade() {
+    for (int s = 0; s < maxStages; ++s) {
+        auto& stage = stages_[static_cast<size_t>(s)];
+        auto& pending = pending_[static_cast<size_t>(s)];
+        for (int lane = 0; lane < maxLanes; ++lane) {
+            stage.current[0][lane] = stage.target[0][lane] = pending.coeffs[0][lane] = 1.0f;
+            for (int k = 1; k < 5; ++k)
+                stage.current[k][lane] = stage.target[k][lane] = pending.coeffs[k][lane] = 0.0f;
+        }
+    }
+}
+
+void BiquadCascade::prepare(double sampleRate, double rampMs) {
+    sampleRate_ = sampleRate;
+    rampBlocks_ = std::max(1, static_cast<int>(std::ceil(rampMs * 0.001 * sampleRate / controlInterval)));
+    reset();
+}
+
+void BiquadCascade::reset() {
+    for (auto& stage : stages_) {
+        std::fill(std::begin(stage.s1), std::end(stage.s1), 0.0f);
+        std::fill(std::begin(stage.s2), std::end(stage.s2), 0.0f);
+    }
+}
+
+void BiquadCascade::setStage(int stage, const BiquadCoefficients& coefficients, bool immediate) {
+    if (stage < 0 || stage >= maxStages)
+        return;
+
+    Omega::Utils::SpinLockGuard guard(lock_);
+    auto& pending = pending_[static_cast<size_t>(stage)];
+    const float values[5] { coefficients.b0, coefficients.b1, coefficients.b2, coefficients.a1, coefficients.a2 };
+    for (int k = 0; k < 5; ++k)
+        std::fill(std::begin(pending.coeffs[k]), std::end(pending.coeffs[k]), values[k]);
+    pending.dirty = true;
+    pending.immediate = pending.immediate || immediate;
+    hasPending_.store(true, std::memory_order_release);
+}
+
+void BiquadCascade::setStageLane(int stage, int lane, const BiquadCoefficients& coefficients, bool immediate) {
+    if (stage < 0 || stage >= maxStages || lane < 0 || lane >= maxLanes)
+        return;
+
+    Omega::Utils::SpinLockGuard guard(lock_);
+    auto& pending = pending_[static_cast<size_t>(stage)];
+    pending.coeffs[0][lane] = coefficients.b0;
+    pending.coeffs[1][lane] = coefficients.b1;
+    pending.coeffs[2][lane] = coefficients.b2;
+    pending.coeffs[3][lane] = coefficients.a1;
+    pending.coeffs[4][lane] = coefficients.a2;
+    pending.dirty = true;
+    pending.immediate = pending.immediate || immediate;
+    hasPending_.store(true, std::memory_order_release);
+}
+
+void BiquadCascade::applyPending() {
+    // Si el message thread tiene el lock, los cambios esperan al próximo bloque
+    if (!hasPending_.load(std::memory_order_acquire) || !lock_.tryLock())
+        return;
+
+    for (int s = 0; s < maxStages; ++s) {
+        auto& pending = pending_[static_cast<size_t>(s)];
+        if (!pending.dirty)
+            continue;
+
+        auto& stage = stages_[static_cast<size_t>(s)];
+        const bool snap = pending.immediate;
+        for (int k = 0; k < 5; ++k) {
+            for (int lane = 0; lane < maxLanes; ++lane) {
+                stage.target[k][lane] = pending.coeffs[k][lane];
+                stage.start[k][lane] = stage.current[k][lane];
+                if (snap)
+                    stage.current[k][lane] = stage.target[k][lane];
+            }
+        }
+
+        // Una etapa que estaba apagada entra desde la identidad con estado limpio
+        if (stage.identity) {
+            std::fill(std::begin(stage.s1), std::end(stage.s1), 0.0f);
+            std::fill(std::begin(stage.s2), std::end(stage.s2), 0.0f);
+        }
+
+        stage.rampBlocks = stage.rampLength = snap ? 0 : rampBlocks_;
+        pending.dirty = false;
+        pending.immediate = false;
+    }
+
+    hasPending_.store(false, std::memory_order_relaxed);
+    lock_.unlock();
+
+    // Lista de etapas activas: las identidades sin rampa se saltan
+    numActiveStages_ = 0;
+    for (int s = 0; s < maxStages; ++s) {
+        auto& stage = stages_[static_cast<size_t>(s)];
+        bool identity = stage.rampBlocks == 0;
+        for (int lane = 0; lane < maxLanes && identity; ++lane) {
+            identity = stage.current[0][lane] == 1.0f && stage.current[1][lane] == 0.0f && stage.current[2][lane] == 0.0f
+                    && stage.current[3][lane] == 0.0f && stage.current[4][lane] == 0.0f;
+        }
+        stage.identity = identity;
+        if (!identity)
+            activeStages_[numActiveStages_++] = s;
+    }
+}
+
+void BiquadCascade::advanceRamps() {
+    bool finished = false;
+
+    for (int i = 0; i < numActiveStages_; ++i) {
+        auto& stage = stages_[static_cast<size_t>(activeStages_[i])];
+        if (stage.rampBlocks == 0)
+            continue;
+
+        if (--stage.rampBlocks == 0) {
+            std::copy(&stage.target[0][0], &stage.target[0][0] + 5 * maxLanes, &stage.current[0][0]);
+            finished = true;
+        } else {
+            // Desde el origen: el error no se acumula y el punto queda en el segmento
+            const Vec4 t = Vec4::set1(static_cast<float>(stage.rampLength - stage.rampBlocks) / static_cast<float>(stage.rampLength));
+            for (int k = 0; k < 5; ++k) {
+                const Vec4 start = Vec4::load(stage.start[k]);
+                (start + (Vec4::load(stage.target[k]) - start) * t).store(stage.current[k]);
+            }
+        }
+    }
+
+    // Una banda que terminó en plano deja de procesarse
+    if (finished) {
+        int count = 0;
+        for (int i = 0; i < numActiveStages_; ++i) {
+            auto& stage = stages_[static_cast<size_t>(activeStages_[i])];
+            bool identity = stage.rampBlocks == 0;
+            for (int lane = 0; lane < maxLanes && identity; ++lane) {
+                identity = stage.current[0][lane] == 1.0f && stage.current[1][lane] == 0.0f && stage.current[2][lane] == 0.0f
+                        && stage.current[3][lane] == 0.0f && stage.current[4][lane] == 0.0f;
+            }
+            stage.identity = identity;
+            if (!identity)
+                activeStages_[count++] = activeStages_[i];
+        }
+        numActiveStages_ = count;
+    }
+}
+
+void BiquadCascade::runStages(float* frames, int numFrames) {
+    for (int i = 0; i < numActiveStages_; ++i) {
+        auto& stage = stages_[static_cast<size_t>(activeStages_[i])];
+        const Vec4 b0 = Vec4::load(stage.current[0]);
+        const Vec4 b1 = Vec4::load(stage.current[1]);
+        const Vec4 b2 = Vec4::load(stage.current[2]);
+        const Vec4 a1 = Vec4::load(stage.current[3]);
+        const Vec4 a2 = Vec4::load(stage.current[4]);
+        Vec4 s1 = Vec4::load(stage.s1);
+        Vec4 s2 = Vec4::load(stage.s2);
+
+        // TDF-II, un frame (4 lanes) por sample
+        for (int n = 0; n < numFrames; ++n) {
+            float* frame = frames + n * maxLanes;
+            const Vec4 x = Vec4::load(frame);
+            const Vec4 y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            y.store(frame);
+        }
+
+        s1.store(stage.s1);
+        s2.store(stage.s2);
+    }
+}
+
+void BiquadCascade::process(float* const* channels, int numChannels, int numSamples) {
+    applyPending();
+    numChannels = std::min(numChannels, maxLanes);
+
+    for (int offset = 0; offset < numSamples; offset += controlInterval) {
+        const int chunk = std::min(controlInterval, numSamples - offset);
+        advanceRamps();
+        if (numActiveStages_ == 0)
+            continue;
+
+        // Entrelazado: frame n = { ch0[n], ch1[n], ch2[n], ch3[n] }
+        std::fill(frames_, frames_ + chunk * maxLanes, 0.0f);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* src = channels[ch] + offset;
+            for (int n = 0; n < chunk; ++n)
+                frames_[n * maxLanes + ch] = src[n];
+        }
+
+        runStages(frames_, chunk);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* dst = channels[ch] + offset;
+            for (int n = 0; n < chunk; ++n)
+                dst[n] = frames_[n * maxLanes + ch];
+        }
+    }
+}
+
+void BiquadCascade::processBroadcast(const float* input, float* const* outputs, int numOutputs, int numSamples) {
+    applyPending();
+    numOutputs = std::min(numOutputs, maxLanes);
+
+    for (int offset = 0; offset < numSamples; offset += controlInterval) {
+        const int chunk = std::min(controlInterval, numSamples - offset);
+        advanceRamps();
+
+        for (int n = 0; n < chunk; ++n)
+            Vec4::set1(input[offset + n]).store(frames_ + n * maxLanes);
+
+        runStages(frames_, chunk);
+
+        for (int lane = 0; lane < numOutputs; ++lane) {
+            float* dst = outputs[lane] + offset;
+            for (int n = 0; n < chunk; ++n)
+                dst[n] = frames_[n * maxLanes + lane];
+        }
+    }
+}
+
+} // namespace OmegaStudio
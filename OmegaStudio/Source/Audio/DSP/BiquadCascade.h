@@ -0,0 +1,109 @@
+//==============================================================================
+// BiquadCascade.h - Motor de biquads en cascada (4 lanes SIMD)
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#pragma once
+
+#include "../../Utils/Atomic.h"
+#include <array>
+#include <atomic>
+#include <complex>
+
+namespace OmegaStudio {
+
+//==============================================================================
+/** Coeficientes normalizados (a0 = 1) de un biquad, fórmulas RBJ */
+struct BiquadCoefficients {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+
+    bool isIdentity() const {
+        return b0 == 1.0f && b1 == 0.0f && b2 == 0.0f && a1 == 0.0f && a2 == 0.0f;
+    }
+
+    static BiquadCoefficients peak(double sampleRate, double frequency, double Q, double gainDb);
+    static BiquadCoefficients lowShelf(double sampleRate, double frequency, double Q, double gainDb);
+    static BiquadCoefficients highShelf(double sampleRate, double frequency, double Q, double gainDb);
+    static BiquadCoefficients lowPass(double sampleRate, double frequency, double Q);
+    static BiquadCoefficients highPass(double sampleRate, double frequency, double Q);
+    static BiquadCoefficients bandPass(double sampleRate, double frequency, double Q);   // 0 dB en el centro
+    static BiquadCoefficients notch(double sampleRate, double frequency, double Q);
+    static BiquadCoefficients allPass(double sampleRate, double frequency, double Q);
+
+    // Respuesta compleja en una frecuencia (para curvas de la UI)
+    std::complex<double> response(double frequency, double sampleRate) const;
+};
+
+//==============================================================================
+/** Cascada de biquads para hasta 4 canales en un registro SIMD
+ *  - Un lane por canal (estéreo, 4 canales) o por filtro (banco paralelo)
+ *  - Todas las etapas activas en una pasada por bloque de control (32 samples)
+ *  - Las etapas identidad (bandas apagadas o planas) no cuestan nada
+ *  - Cambios de coeficientes interpolados a tasa de control: la región estable
+ *    de (a1, a2) es convexa, así que la interpolación lineal no desestabiliza.
+ *    Cada punto se calcula desde el origen de la rampa: sumando incrementos, con
+ *    polos junto al círculo unidad el de a1 cae bajo la resolución del float, se
+ *    pierde y (a1, a2) sale del triángulo estable durante la rampa
+ *  - setStage() desde cualquier hilo; el audio aplica los cambios con tryLock
+ */
+class BiquadCascade {
+public:
+    static constexpr int maxStages = 32;
+    static constexpr int maxLanes = 4;
+    static constexpr int controlInterval = 32;
+
+    BiquadCascade();
+
+    void prepare(double sampleRate, double rampMs = 20.0);
+    void reset();
+
+    // Etapas (cualquier hilo). immediate = sin rampa (cambio de tipo, carga de preset)
+    void setStage(int stage, const BiquadCoefficients& coefficients, bool immediate = false);
+    void setStageLane(int stage, int lane, const BiquadCoefficients& coefficients, bool immediate = false);
+    void bypassStage(int stage, bool immediate = false) { setStage(stage, {}, immediate); }
+
+    double getSampleRate() const { return sampleRate_; }
+
+    // Audio: cada canal es un lane, in-place (numChannels <= 4)
+    void process(float* const* channels, int numChannels, int numSamples);
+
+    // Audio: la misma entrada en todos los lanes, una salida por lane (bancos de filtros)
+    void processBroadcast(const float* input, float* const* outputs, int numOutputs, int numSamples);
+
+private:
+    struct Stage {
+        alignas(16) float current[5][maxLanes];
+        alignas(16) float start[5][maxLanes];     // Origen de la rampa en curso
+        alignas(16) float target[5][maxLanes];
+        alignas(16) float s1[maxLanes];
+        alignas(16) float s2[maxLanes];
+        int rampBlocks = 0;                       // Bloques de control que faltan
+        int rampLength = 0;
+        bool identity = true;
+    };
+
+    struct Pending {
+        float coeffs[5][maxLanes];
+        bool dirty = false;
+        bool immediate = false;
+    };
+
+    void applyPending();
+    void advanceRamps();
+    void runStages(float* frames, int numFrames);
+
+    std::array<Stage, maxStages> stages_ {};
+    std::array<Pending, maxStages> pending_ {};
+    int activeStages_[maxStages] {};
+    int numActiveStages_ = 0;
+
+    double sampleRate_ = 48000.0;
+    int rampBlocks_ = 30;
+
+    Omega::Utils::SpinLock lock_;
+    std::atomic<bool> hasPending_ { false };
+
+    alignas(16) float frames_[controlInterval * maxLanes] {};
+};
+
+} // namespace OmegaStudio
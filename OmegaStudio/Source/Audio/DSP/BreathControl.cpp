@@ -8,40 +8,46 @@
 namespace omega {
 
 BreathControl::BreathControl() {
+    m_gainFollower.reset(1.0f);
 }
 
 void BreathControl::initialize(double sampleRate, int maxBlockSize) {
     m_sampleRate = sampleRate;
+    m_gainBuffer.assign(static_cast<size_t>(juce::jmax(1, maxBlockSize)), 1.0f);
     updateEnvelope();
 }
 
 void BreathControl::process(float* buffer, int numSamples) {
-    for (int i = 0; i < numSamples; ++i) {
-        float inputLevel = std::abs(buffer[i]);
-        float inputDB = juce::Decibels::gainToDecibels(inputLevel + 0.0001f);
+    const int maxBlock = static_cast<int>(m_gainBuffer.size());
+    if (buffer == nullptr || maxBlock == 0)
+        return;
+    
+    // Threshold and reduction in the linear domain, once per block
+    const float thresholdGain = OmegaStudio::Dynamics::decibelsToGain(m_threshold) - 0.0001f;
+    const float reducedGain = OmegaStudio::Dynamics::decibelsToGain(-m_reduction * m_noiseReduction);
+    float* gains = m_gainBuffer.data();
+    
+    for (int offset = 0; offset < numSamples; offset += maxBlock) {
+        const int chunk = juce::jmin(maxBlock, numSamples - offset);
+        float* data = buffer + offset;
         
         // Detect if current sample is breath/noise
-        bool isBelowThreshold = inputDB < m_threshold;
-        
-        // Update envelope
-        float targetGain = isBelowThreshold ? 
-            juce::Decibels::decibelsToGain(-m_reduction * m_noiseReduction) : 1.0f;
-        
-        float coeff = (targetGain < m_envelopeGain) ? m_attackCoeff : m_releaseCoeff;
-        m_envelopeGain += coeff * (targetGain - m_envelopeGain);
+        for (int i = 0; i < chunk; ++i)
+            gains[i] = std::abs(data[i]) < thresholdGain ? reducedGain : 1.0f;
         
-        // Apply gain
-        buffer[i] *= m_envelopeGain;
+        // Smooth and apply gain
+        m_gainFollower.process(gains, gains, chunk);
+        juce::FloatVectorOperations::multiply(data, gains, chunk);
     }
 }
 
 void BreathControl::reset() {
-    m_envelopeGain = 1.0f;
+    m_gainFollower.reset(1.0f);
 }
 
 void BreathControl::updateEnvelope() {
-    m_attackCoeff = 1.0f - std::exp(-1.0f / (m_attack * 0.001f * m_sampleRate));
-    m_releaseCoeff = 1.0f - std::exp(-1.0f / (m_release * 0.001f * m_sampleRate));
+    // The follower "attacks" on a rising input; for a gain that means the release
+    m_gainFollower.setTimes(m_sampleRate, m_release, m_attack);
 }
 
 bool BreathControl::isBreath(const float* buffer, int numSamples) {
@@ -51,8 +57,7 @@ bool BreathControl::isBreath(const float* buffer, int numSamples) {
     }
     rms = std::sqrt(rms / numSamples);
     
-    float rmsDB = juce::Decibels::gainToDecibels(rms + 0.0001f);
-    return rmsDB < m_threshold;
+    return rms + 0.0001f < OmegaStudio::Dynamics::decibelsToGain(m_threshold);
 }
 
 } // namespace omega
@@ -7,6 +7,8 @@
 
 #include <JuceHeader.h>
 #include "../../Utils/Constants.h"
+#include "DynamicsCore.h"
+#include <vector>
 
 namespace omega {
 
@@ -45,9 +47,9 @@ private:
     float m_release { 100.0f };
     float m_noiseReduction { 0.5f };
     
-    float m_envelopeGain { 1.0f };
-    float m_attackCoeff { 0.0f };
-    float m_releaseCoeff { 0.0f };
+    // Smooths the gate gain: falling gain uses the attack time, rising the release
+    OmegaStudio::Dynamics::EnvelopeFollower m_gainFollower;
+    std::vector<float> m_gainBuffer;
     
     double m_sampleRate { 48000.0 };
 };
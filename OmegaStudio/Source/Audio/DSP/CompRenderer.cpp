@@ -0,0 +1,389 @@
+/**
+ * @file CompRenderer.cpp
+ * @brief Implementation of the segment-list comp renderer
+ */
+
+#include "CompRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace omega {
+
+namespace {
+
+using Range = juce::Range<juce::int64>;
+
+constexpr int kGainChunk = 256;
+
+// Sorted, disjoint union of a list of ranges
+std::vector<Range> mergeRanges(std::vector<Range> ranges) {
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.getStart() < b.getStart(); });
+    std::vector<Range> merged;
+    for (const auto& range : ranges) {
+        if (range.isEmpty())
+            continue;
+        if (!merged.empty() && range.getStart() <= merged.back().getEnd())
+            merged.back() = merged.back().withEnd(juce::jmax(merged.back().getEnd(), range.getEnd()));
+        else
+            merged.push_back(range);
+    }
+    return merged;
+}
+
+bool covers(const std::vector<Range>& merged, juce::int64 t) {
+    auto it = std::upper_bound(merged.begin(), merged.end(), t,
+                               [](juce::int64 value, const Range& r) { return value < r.getStart(); });
+    return it != merged.begin() && std::prev(it)->contains(t);
+}
+
+} // namespace
+
+// ============================================================================
+// CompRenderer Implementation
+// ============================================================================
+
+CompRenderer::CompRenderer() = default;
+CompRenderer::~CompRenderer() = default;
+
+float CompRenderer::fadeGain(float position, FadeCurve curve) {
+    position = juce::jlimit(0.0f, 1.0f, position);
+
+    switch (curve) {
+        case FadeCurve::Linear:
+            return position;
+        case FadeCurve::EqualPower:
+            return std::sin(position * juce::MathConstants<float>::halfPi);
+        case FadeCurve::Logarithmic:
+            // Exponential rise, normalised to reach silence at 0
+            return (std::exp(2.0f * position) - 1.0f) / (std::exp(2.0f) - 1.0f);
+        case FadeCurve::SCurve:
+            return position * position * (3.0f - 2.0f * position);
+    }
+    return position;
+}
+
+void CompRenderer::prepare(int numChannels) {
+    m_numChannels = juce::jmax(1, numChannels);
+    if (m_flattenEnabled) {
+        m_flattened.setSize(m_numChannels, 0);
+        m_dirty.clear();
+        markDirty(0, getLength());
+    }
+}
+
+void CompRenderer::setSources(const std::vector<const juce::AudioBuffer<float>*>& sources) {
+    markChangedSources(sources);
+
+    const juce::SpinLock::ScopedLockType sl(m_lock);
+    m_sources = sources;
+}
+
+void CompRenderer::markChangedSources(const std::vector<const juce::AudioBuffer<float>*>& sources) {
+    for (const auto& piece : m_pieces) {
+        const auto index = static_cast<size_t>(piece.source);
+        if (piece.source < 0)
+            continue;
+        const auto* before = index < m_sources.size() ? m_sources[index] : nullptr;
+        const auto* after = index < sources.size() ? sources[index] : nullptr;
+        if (before != after)
+            markDirty(piece.playStart, piece.playEnd);
+    }
+}
+
+std::vector<CompRenderer::Piece> CompRenderer::resolve(std::vector<Region> regions) {
+    regions.erase(std::remove_if(regions.begin(), regions.end(), [](const Region& r) { return r.end <= r.start; }),
+                  regions.end());
+    std::stable_sort(regions.begin(), regions.end(), [](const Region& a, const Region& b) { return a.start < b.start; });
+
+    // Punch-in: each region replaces whatever earlier pieces it covers
+    std::vector<Piece> pieces;
+    for (const auto& region : regions) {
+        Piece piece;
+        piece.source = region.source;
+        piece.sourceStart = region.sourceStart;
+        piece.gain = region.gain;
+        piece.start = region.start;
+        piece.end = region.end;
+        piece.fadeInCurve = piece.fadeOutCurve = region.curve;
+        piece.fadeInRequest = juce::jmax(0, region.fadeIn);
+        piece.fadeOutRequest = juce::jmax(0, region.fadeOut);
+
+        std::vector<Piece> next;
+        next.reserve(pieces.size() + 2);
+        for (const auto& existing : pieces) {
+            if (existing.end <= piece.start || existing.start >= piece.end) {
+                next.push_back(existing);
+                continue;
+            }
+            if (existing.start < piece.start) {
+                auto left = existing;
+                left.end = piece.start;
+                next.push_back(left);
+            }
+            if (existing.end > piece.end) {
+                auto right = existing;
+                right.start = piece.end;
+                next.push_back(right);
+            }
+        }
+        next.push_back(piece);
+        std::sort(next.begin(), next.end(), [](const Piece& a, const Piece& b) { return a.start < b.start; });
+        pieces = std::move(next);
+    }
+
+    // Free edges fade inside the piece
+    for (auto& piece : pieces) {
+        const juce::int64 half = (piece.end - piece.start) / 2;
+        piece.playStart = piece.start;
+        piece.playEnd = piece.end;
+        piece.fadeInEnd = piece.start + juce::jmin((juce::int64) piece.fadeInRequest, half);
+        piece.fadeOutStart = piece.end - juce::jmin((juce::int64) piece.fadeOutRequest, half);
+    }
+
+    // Touching pieces crossfade across the boundary with complementary curves
+    for (size_t i = 1; i < pieces.size(); ++i) {
+        auto& a = pieces[i - 1];
+        auto& b = pieces[i];
+        if (a.end != b.start)
+            continue;
+
+        juce::int64 length = juce::jmax(a.fadeOutRequest, b.fadeInRequest);
+        length = juce::jmin(length, a.end - a.start, b.end - b.start);
+        const juce::int64 before = length / 2;
+        const juce::int64 after = length - before;
+
+        a.fadeOutStart = b.playStart = b.start - before;
+        a.playEnd = b.fadeInEnd = b.start + after;
+        a.fadeOutCurve = b.fadeInCurve;
+    }
+
+    std::stable_sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) { return a.playStart < b.playStart; });
+    return pieces;
+}
+
+void CompRenderer::setRegions(std::vector<Region> regions) {
+    juce::int64 maxPlayLength = 0;
+    auto pieces = diffPieces(std::move(regions), maxPlayLength);
+
+    const juce::SpinLock::ScopedLockType sl(m_lock);
+    m_pieces.swap(pieces);
+    m_maxPlayLength = maxPlayLength;
+}
+
+void CompRenderer::setComp(std::vector<const juce::AudioBuffer<float>*> sources, std::vector<Region> regions) {
+    markChangedSources(sources);
+    juce::int64 maxPlayLength = 0;
+    auto pieces = diffPieces(std::move(regions), maxPlayLength);
+
+    // The old lists are freed after the lock is released
+    const juce::SpinLock::ScopedLockType sl(m_lock);
+    m_sources.swap(sources);
+    m_pieces.swap(pieces);
+    m_maxPlayLength = maxPlayLength;
+}
+
+std::vector<CompRenderer::Piece> CompRenderer::diffPieces(std::vector<Region> regions, juce::int64& maxPlayLength) {
+    auto pieces = resolve(std::move(regions));
+
+    // Output = sum over (source, offset, gain) of the source times the summed
+    // envelopes. Fade zones differ unless identical; bodies (gain 1) differ
+    // where their coverage differs. A moved boundary invalidates only the
+    // span between its old and new crossfades
+    if (m_flattenEnabled) {
+        using Key = std::tuple<int, juce::int64, float>;
+        using Fade = std::tuple<int, juce::int64, float, juce::int64, juce::int64, int>;
+        std::vector<Fade> oldFades, newFades;
+        std::map<Key, std::pair<std::vector<Range>, std::vector<Range>>> bodies;
+
+        auto collect = [&](const std::vector<Piece>& list, std::vector<Fade>& fades, bool isNew) {
+            for (const auto& piece : list) {
+                if (piece.source < 0 || piece.gain == 0.0f)
+                    continue;
+                const Key key { piece.source, piece.sourceStart, piece.gain };
+                if (piece.fadeInEnd > piece.playStart)
+                    fades.emplace_back(piece.source, piece.sourceStart, piece.gain, piece.playStart, piece.fadeInEnd,
+                                       static_cast<int>(piece.fadeInCurve));
+                if (piece.playEnd > piece.fadeOutStart)
+                    fades.emplace_back(piece.source, piece.sourceStart, piece.gain, piece.fadeOutStart, -piece.playEnd,
+                                       static_cast<int>(piece.fadeOutCurve));
+                auto& body = isNew ? bodies[key].second : bodies[key].first;
+                body.push_back({ piece.fadeInEnd, juce::jmax(piece.fadeInEnd, piece.fadeOutStart) });
+            }
+        };
+        collect(m_pieces, oldFades, false);
+        collect(pieces, newFades, true);
+
+        std::sort(oldFades.begin(), oldFades.end());
+        std::sort(newFades.begin(), newFades.end());
+        std::vector<Fade> changed;
+        std::set_symmetric_difference(oldFades.begin(), oldFades.end(), newFades.begin(), newFades.end(),
+                                      std::back_inserter(changed));
+        for (const auto& fade : changed) {
+            const auto a = std::get<3>(fade), b = std::get<4>(fade);
+            markDirty(a, b < 0 ? -b : b);   // Fade outs store their end negated
+        }
+
+        for (auto& entry : bodies) {
+            const auto before = mergeRanges(entry.second.first);
+            const auto after = mergeRanges(entry.second.second);
+            std::vector<juce::int64> edges;
+            for (const auto* list : { &before, &after })
+                for (const auto& r : *list) {
+                    edges.push_back(r.getStart());
+                    edges.push_back(r.getEnd());
+                }
+            std::sort(edges.begin(), edges.end());
+            for (size_t i = 1; i < edges.size(); ++i) {
+                if (edges[i] > edges[i - 1] && covers(before, edges[i - 1]) != covers(after, edges[i - 1]))
+                    markDirty(edges[i - 1], edges[i]);
+            }
+        }
+    }
+
+    maxPlayLength = 0;
+    for (const auto& piece : pieces)
+        maxPlayLength = juce::jmax(maxPlayLength, piece.playEnd - piece.playStart);
+    return pieces;
+}
+
+void CompRenderer::invalidate(juce::int64 start, juce::int64 end) {
+    markDirty(start, end);
+}
+
+juce::int64 CompRenderer::getLength() const {
+    juce::int64 length = 0;
+    for (const auto& piece : m_pieces)
+        length = juce::jmax(length, piece.playEnd);
+    return length;
+}
+
+void CompRenderer::render(float* const* output, int numChannels, juce::int64 position, int numSamples) const {
+    for (int ch = 0; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::clear(output[ch], numSamples);
+
+    const juce::SpinLock::ScopedLockType sl(m_lock);
+
+    // Pieces starting before position - longest piece cannot reach the block
+    auto it = std::lower_bound(m_pieces.begin(), m_pieces.end(), position - m_maxPlayLength,
+                               [](const Piece& piece, juce::int64 t) { return piece.playStart < t; });
+    for (; it != m_pieces.end() && it->playStart < position + numSamples; ++it) {
+        if (it->playEnd > position)
+            renderPiece(*it, output, numChannels, position, numSamples);
+    }
+}
+
+void CompRenderer::renderPiece(const Piece& piece, float* const* output, int numChannels,
+                               juce::int64 position, int numSamples) const {
+    if (piece.source < 0 || static_cast<size_t>(piece.source) >= m_sources.size() || piece.gain == 0.0f)
+        return;
+    const auto* source = m_sources[static_cast<size_t>(piece.source)];
+    if (source == nullptr || source->getNumChannels() == 0)
+        return;
+
+    // Timeline span that is inside the block, the piece and the take
+    const juce::int64 t0 = juce::jmax(position, piece.playStart, piece.sourceStart);
+    const juce::int64 t1 = juce::jmin(position + numSamples, piece.playEnd,
+                                      piece.sourceStart + source->getNumSamples());
+    if (t1 <= t0)
+        return;
+
+    const int sourceChannels = source->getNumChannels();
+    auto addConstant = [&](juce::int64 from, juce::int64 to) {
+        if (to <= from)
+            return;
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply(output[ch] + (from - position),
+                                                         source->getReadPointer(juce::jmin(ch, sourceChannels - 1),
+                                                                                (int) (from - piece.sourceStart)),
+                                                         piece.gain, (int) (to - from));
+    };
+
+    auto addFaded = [&](juce::int64 from, juce::int64 to) {
+        float gains[kGainChunk];
+        const float fadeInLength = static_cast<float>(piece.fadeInEnd - piece.playStart);
+        const float fadeOutLength = static_cast<float>(piece.playEnd - piece.fadeOutStart);
+
+        for (juce::int64 chunk = from; chunk < to; chunk += kGainChunk) {
+            const int count = (int) juce::jmin((juce::int64) kGainChunk, to - chunk);
+            for (int i = 0; i < count; ++i) {
+                const juce::int64 t = chunk + i;
+                float g = piece.gain;
+                if (t < piece.fadeInEnd)
+                    g *= fadeGain((static_cast<float>(t - piece.playStart) + 0.5f) / fadeInLength, piece.fadeInCurve);
+                if (t >= piece.fadeOutStart)
+                    g *= fadeGain((static_cast<float>(piece.playEnd - t) - 0.5f) / fadeOutLength, piece.fadeOutCurve);
+                gains[i] = g;
+            }
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const float* src = source->getReadPointer(juce::jmin(ch, sourceChannels - 1), (int) (chunk - piece.sourceStart));
+                float* dst = output[ch] + (chunk - position);
+                for (int i = 0; i < count; ++i)
+                    dst[i] += src[i] * gains[i];
+            }
+        }
+    };
+
+    // Fades per sample, the body as one vector operation
+    const juce::int64 bodyStart = juce::jlimit(t0, t1, piece.fadeInEnd);
+    const juce::int64 bodyEnd = juce::jlimit(bodyStart, t1, piece.fadeOutStart);
+    addFaded(t0, bodyStart);
+    addConstant(bodyStart, bodyEnd);
+    addFaded(bodyEnd, t1);
+}
+
+//==============================================================================
+// Flattened render
+//==============================================================================
+
+void CompRenderer::setFlattenEnabled(bool shouldFlatten) {
+    if (shouldFlatten == m_flattenEnabled)
+        return;
+
+    m_flattenEnabled = shouldFlatten;
+    m_dirty.clear();
+    m_flattened.setSize(m_numChannels, 0);
+    if (m_flattenEnabled)
+        markDirty(0, getLength());
+}
+
+void CompRenderer::markDirty(juce::int64 start, juce::int64 end) {
+    if (!m_flattenEnabled || end <= start)
+        return;
+
+    m_dirty.push_back({ start, end });
+    m_dirty = mergeRanges(std::move(m_dirty));
+}
+
+juce::int64 CompRenderer::updateFlattened() {
+    if (!m_flattenEnabled)
+        return 0;
+
+    const juce::int64 length = getLength();
+    const int previous = m_flattened.getNumSamples();
+    if (length != previous) {
+        m_flattened.setSize(m_numChannels, (int) length, true, true);
+        if (length > previous)
+            markDirty(previous, length);
+    }
+
+    std::vector<float*> channels((size_t) m_numChannels);
+    juce::int64 rendered = 0;
+    for (const auto& range : m_dirty) {
+        const juce::int64 start = juce::jmax((juce::int64) 0, range.getStart());
+        const juce::int64 end = juce::jmin(length, range.getEnd());
+        if (end <= start)
+            continue;
+
+        for (int ch = 0; ch < m_numChannels; ++ch)
+            channels[(size_t) ch] = m_flattened.getWritePointer(ch, (int) start);
+        render(channels.data(), m_numChannels, start, (int) (end - start));
+        rendered += end - start;
+    }
+
+    m_dirty.clear();
+    return rendered;
+}
+
+} // namespace omega
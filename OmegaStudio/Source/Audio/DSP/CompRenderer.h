@@ -0,0 +1,130 @@
+/**
+ * @file CompRenderer.h
+ * @brief Comp playback straight from the takes, shared by CompLane and VocalComping
+ *
+ * - A comp is a list of regions (take, timeline span, gain, fades). Later
+ *   regions punch in over earlier ones; where two pieces meet they crossfade
+ *   across the boundary (equal power by default), computed on the fly
+ * - render() plays any timeline range directly from the takes: no comp-length
+ *   buffer is needed for playback
+ * - The optional flattened render is only rebuilt where an edit changed the
+ *   output (setRegions() diffs the old and new piece lists)
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+namespace omega {
+
+/**
+ * @class CompRenderer
+ * @brief Segment-list comp renderer with incremental flattening
+ *
+ * Edits (setSources, setRegions) come from one thread; render() may run on the
+ * audio thread and only contends with the swap at the end of an edit. The
+ * takes' audio must not change while it is playing (invalidate() after an
+ * in-place edit).
+ */
+class CompRenderer {
+public:
+    enum class FadeCurve {
+        Linear,
+        EqualPower,
+        Logarithmic,
+        SCurve
+    };
+
+    struct Region {
+        int source = -1;                    // Index into the sources
+        juce::int64 sourceStart = 0;        // Timeline sample of the source's first sample
+        juce::int64 start = 0;              // Timeline span [start, end)
+        juce::int64 end = 0;
+        int fadeIn = 0;                     // Samples; a boundary uses the longer of both sides
+        int fadeOut = 0;
+        float gain = 1.0f;
+        FadeCurve curve = FadeCurve::EqualPower;
+    };
+
+    CompRenderer();
+    ~CompRenderer();
+
+    /** Output channels; mono sources feed every channel */
+    void prepare(int numChannels);
+
+    /** Takes by index (not owned). Pieces whose source changed are invalidated */
+    void setSources(const std::vector<const juce::AudioBuffer<float>*>& sources);
+
+    /** Replace the comp; only the time ranges whose output changed are invalidated */
+    void setRegions(std::vector<Region> regions);
+
+    /**
+     * Sources and regions in one swap: render() never pairs the new pieces with
+     * the old takes or the reverse. A removed take may be freed once this returns
+     */
+    void setComp(std::vector<const juce::AudioBuffer<float>*> sources, std::vector<Region> regions);
+
+    /** Mark a range as changed (e.g. a take edited in place) */
+    void invalidate(juce::int64 start, juce::int64 end);
+
+    /**
+     * Render [position, position + numSamples) of the timeline, replacing the
+     * output (RT-safe)
+     */
+    void render(float* const* output, int numChannels, juce::int64 position, int numSamples) const;
+
+    /** End of the last piece, crossfade tails included */
+    juce::int64 getLength() const;
+
+    //==========================================================================
+    // Flattened render (optional)
+    //==========================================================================
+
+    /** Off by default; turning it on renders the whole comp at the next update */
+    void setFlattenEnabled(bool shouldFlatten);
+
+    /** Re-render the invalidated ranges; returns the number of samples rendered */
+    juce::int64 updateFlattened();
+
+    const juce::AudioBuffer<float>& getFlattened() const { return m_flattened; }
+    bool isFlattenedValid() const { return m_dirty.empty(); }
+
+    /** Gain of a fade at position 0..1 (1 = fully in) */
+    static float fadeGain(float position, FadeCurve curve);
+
+private:
+    struct Piece {
+        int source = -1;
+        juce::int64 sourceStart = 0;
+        float gain = 1.0f;
+        juce::int64 start = 0, end = 0;             // Owned span
+        juce::int64 playStart = 0, playEnd = 0;     // With crossfade overhangs
+        juce::int64 fadeInEnd = 0;                  // Fade in over [playStart, fadeInEnd)
+        juce::int64 fadeOutStart = 0;               // Fade out over [fadeOutStart, playEnd)
+        FadeCurve fadeInCurve = FadeCurve::EqualPower;
+        FadeCurve fadeOutCurve = FadeCurve::EqualPower;
+        int fadeInRequest = 0, fadeOutRequest = 0;  // From the region, for boundaries
+    };
+
+    static std::vector<Piece> resolve(std::vector<Region> regions);
+    void markChangedSources(const std::vector<const juce::AudioBuffer<float>*>& sources);
+    std::vector<Piece> diffPieces(std::vector<Region> regions, juce::int64& maxPlayLength);
+    void markDirty(juce::int64 start, juce::int64 end);
+    void renderPiece(const Piece& piece, float* const* output, int numChannels,
+                     juce::int64 position, int numSamples) const;
+
+    std::vector<const juce::AudioBuffer<float>*> m_sources;
+    std::vector<Piece> m_pieces;                // Sorted by playStart
+    juce::int64 m_maxPlayLength = 0;
+    int m_numChannels = 2;
+    mutable juce::SpinLock m_lock;              // Guards m_sources, m_pieces against render()
+
+    bool m_flattenEnabled = false;
+    juce::AudioBuffer<float> m_flattened;
+    std::vector<juce::Range<juce::int64>> m_dirty;  // Sorted, disjoint
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompRenderer)
+};
+
+} // namespace omega
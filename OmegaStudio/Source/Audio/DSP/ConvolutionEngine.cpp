@@ -0,0 +1,732 @@
+//==============================================================================
+// ConvolutionEngine.cpp - Convolución particionada no uniforme
+//==============================================================================
+
+#include "ConvolutionEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace OmegaStudio {
+
+namespace {
+
+// Esquema de particiones. Un nivel en el audio necesita offset >= partición
+// (el bloque se calcula al completarse); uno en el hilo de fondo necesita
+// offset >= 2 * partición (un bloque entero de margen para el worker, dos para
+// la parte que no depende del último bloque de entrada)
+struct LevelSpec {
+    int partitionSize;
+    int offset;
+    bool background;
+};
+
+constexpr LevelSpec levelSpecs[] = {
+    { 64,    ConvolutionIR::headLength, false },
+    { 512,   1024,                      false },
+    { 4096,  8192,                      true  },
+    { 16384, 32768,                     true  },
+};
+
+constexpr int numLevelSpecs = static_cast<int>(sizeof(levelSpecs) / sizeof(levelSpecs[0]));
+constexpr int historySize = 65536;      // > 3 bloques del nivel más grande
+constexpr int accumulatorSize = 4096;   // > offset + partición de los niveles del audio
+constexpr int numOutputSlots = 4;
+
+int fftOrderFor(int fftSize) {
+    int order = 0;
+    while ((1 << order) < fftSize)
+        ++order;
+    return order;
+}
+
+// Espectros en formato separado [re(bins) | im(bins)]: el producto complejo
+// se vectoriza sin barajar lanes
+void multiplyAccumulate(float* __restrict acc, const float* __restrict x, const float* __restrict h, int numBins) {
+    float* __restrict accIm = acc + numBins;
+    const float* __restrict xIm = x + numBins;
+    const float* __restrict hIm = h + numBins;
+    for (int b = 0; b < numBins; ++b) {
+        acc[b]   += x[b] * h[b] - xIm[b] * hIm[b];
+        accIm[b] += x[b] * hIm[b] + xIm[b] * h[b];
+    }
+}
+
+// Intercalado (salida de juce::dsp::FFT) <-> separado
+void deinterleave(const float* interleaved, float* split, int numBins) {
+    for (int b = 0; b < numBins; ++b) {
+        split[b] = interleaved[2 * b];
+        split[numBins + b] = interleaved[2 * b + 1];
+    }
+}
+
+void interleave(const float* split, float* interleaved, int numBins) {
+    for (int b = 0; b < numBins; ++b) {
+        interleaved[2 * b] = split[b];
+        interleaved[2 * b + 1] = split[numBins + b];
+    }
+}
+
+// Caminos entrada -> salida de cada layout
+struct PathSpec { int input, output, irChannel; };
+
+int getPaths(ConvolutionIR::Layout layout, PathSpec* paths) {
+    switch (layout) {
+        case ConvolutionIR::Layout::Mono:
+            paths[0] = { 0, 0, 0 };
+            paths[1] = { 1, 1, 0 };
+            return 2;
+        case ConvolutionIR::Layout::Stereo:
+            paths[0] = { 0, 0, 0 };
+            paths[1] = { 1, 1, 1 };
+            return 2;
+        case ConvolutionIR::Layout::TrueStereo:
+            paths[0] = { 0, 0, 0 };
+            paths[1] = { 0, 1, 1 };
+            paths[2] = { 1, 0, 2 };
+            paths[3] = { 1, 1, 3 };
+            return 4;
+    }
+    return 0;
+}
+
+} // namespace
+
+//==============================================================================
+// ConvolutionIR
+//==============================================================================
+
+std::shared_ptr<const ConvolutionIR> ConvolutionIR::create(const juce::AudioBuffer<float>& impulse,
+                                                           double sampleRate, bool normalise) {
+    const int sourceChannels = impulse.getNumChannels();
+    const int length = impulse.getNumSamples();
+    if (sourceChannels == 0 || length == 0)
+        return nullptr;
+
+    std::shared_ptr<ConvolutionIR> ir(new ConvolutionIR());
+    ir->layout_ = sourceChannels >= 4 ? Layout::TrueStereo : sourceChannels >= 2 ? Layout::Stereo : Layout::Mono;
+    ir->numChannels_ = ir->layout_ == Layout::TrueStereo ? 4 : ir->layout_ == Layout::Stereo ? 2 : 1;
+    ir->length_ = length;
+    ir->sampleRate_ = sampleRate;
+
+    // Normalización por energía: la salida más cargada queda a ganancia unitaria
+    float gain = 1.0f;
+    if (normalise) {
+        PathSpec paths[4];
+        const int numPaths = getPaths(ir->layout_, paths);
+        double outputEnergy[2] = { 0.0, 0.0 };
+        for (int p = 0; p < numPaths; ++p) {
+            const float* data = impulse.getReadPointer(paths[p].irChannel);
+            double energy = 0.0;
+            for (int i = 0; i < length; ++i)
+                energy += static_cast<double>(data[i]) * data[i];
+            outputEnergy[paths[p].output] += energy;
+        }
+        const double maxEnergy = std::max(outputEnergy[0], outputEnergy[1]);
+        if (maxEnergy > 0.0)
+            gain = static_cast<float>(1.0 / std::sqrt(maxEnergy));
+    }
+
+    // Cabeza: taps invertidos para un producto escalar contiguo
+    ir->head_.assign(static_cast<size_t>(ir->numChannels_ * headLength), 0.0f);
+    for (int ch = 0; ch < ir->numChannels_; ++ch) {
+        const float* data = impulse.getReadPointer(ch);
+        float* head = ir->head_.data() + ch * headLength;
+        for (int i = 0; i < std::min(length, headLength); ++i)
+            head[headLength - 1 - i] = data[i] * gain;
+    }
+
+    // Niveles: cada uno termina donde empieza el siguiente, el último llega al final
+    std::vector<float> fftBuffer;
+    for (int l = 0; l < numLevelSpecs && levelSpecs[l].offset < length; ++l) {
+        const auto& spec = levelSpecs[l];
+        const int end = l + 1 < numLevelSpecs ? std::min(length, levelSpecs[l + 1].offset) : length;
+
+        Level level;
+        level.partitionSize = spec.partitionSize;
+        level.offset = spec.offset;
+        level.background = spec.background;
+        level.numPartitions = (end - spec.offset + spec.partitionSize - 1) / spec.partitionSize;
+
+        const int fftSize = 2 * spec.partitionSize;
+        const int stride = 2 * (spec.partitionSize + 1);
+        juce::dsp::FFT fft(fftOrderFor(fftSize));
+        fftBuffer.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+        level.spectra.assign(static_cast<size_t>(ir->numChannels_ * level.numPartitions * stride), 0.0f);
+
+        for (int ch = 0; ch < ir->numChannels_; ++ch) {
+            const float* data = impulse.getReadPointer(ch);
+            for (int p = 0; p < level.numPartitions; ++p) {
+                const int start = spec.offset + p * spec.partitionSize;
+                const int count = std::min(spec.partitionSize, end - start);
+
+                std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+                for (int i = 0; i < count; ++i)
+                    fftBuffer[static_cast<size_t>(i)] = data[start + i] * gain;
+                fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+                deinterleave(fftBuffer.data(), const_cast<float*>(level.getSpectrum(ch, p)), spec.partitionSize + 1);
+            }
+        }
+
+        ir->levels_.push_back(std::move(level));
+    }
+
+    return ir;
+}
+
+std::shared_ptr<const ConvolutionIR> ConvolutionIR::loadFile(const juce::File& file, double sampleRate, bool normalise) {
+    static std::mutex cacheMutex;
+    static std::map<juce::String, std::weak_ptr<const ConvolutionIR>> cache;
+
+    const juce::String key = file.getFullPathName() + "|" + juce::String(file.getLastModificationTime().toMilliseconds())
+                           + "|" + juce::String(sampleRate) + (normalise ? "|n" : "|r");
+
+    {
+        std::lock_guard<std::mutex> guard(cacheMutex);
+        if (auto cached = cache[key].lock())
+            return cached;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    const int numChannels = static_cast<int>(std::min<unsigned int>(reader->numChannels, 4));
+    const int fileLength = static_cast<int>(reader->lengthInSamples);
+    juce::AudioBuffer<float> source(numChannels, fileLength);
+    reader->read(&source, 0, fileLength, 0, true, numChannels > 1);
+
+    // Remuestreo al sample rate del proyecto
+    juce::AudioBuffer<float> impulse;
+    const double ratio = reader->sampleRate / sampleRate;
+    if (std::abs(ratio - 1.0) > 1.0e-6) {
+        const int length = static_cast<int>(std::ceil(fileLength / ratio));
+        impulse.setSize(numChannels, length);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            juce::LagrangeInterpolator interpolator;
+            interpolator.process(ratio, source.getReadPointer(ch), impulse.getWritePointer(ch), length,
+                                 fileLength, 0);
+        }
+    } else {
+        impulse = std::move(source);
+    }
+
+    auto ir = create(impulse, sampleRate, normalise);
+
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    if (auto cached = cache[key].lock())
+        return cached;          // Otro hilo la cargó mientras tanto
+    cache[key] = ir;
+    return ir;
+}
+
+//==============================================================================
+// Estado por IR: todo lo que se reserva al cambiar de IR
+//==============================================================================
+
+struct ConvolutionEngine::LevelState {
+    const ConvolutionIR::Level* spec = nullptr;
+    int partitionSize = 0;
+    int offset = 0;
+    int numPartitions = 0;
+    bool background = false;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> fdl[2];          // Espectros de entrada recientes, anillo de numPartitions
+    std::vector<float> work;            // Buffer in-place de la FFT (2 * fftSize)
+    std::vector<float> accumulator;     // Suma espectral por salida
+    std::vector<float> blockOut[2];     // Nivel del audio: resultado del bloque
+    std::vector<float> slots[2];        // Nivel de fondo: numOutputSlots bloques completos por salida
+    std::vector<float> aheadSlots[2];   // Nivel de fondo: solo particiones 1..N-1
+
+    // Trabajos de fondo (un solo hilo los calcula): bloques con la entrada
+    // completa, con la parte adelantada lista y terminados
+    std::atomic<int64_t> requested { 0 };
+    std::atomic<int64_t> aheadDone { 0 };
+    std::atomic<int64_t> done { 0 };
+    int64_t lateBlock = -1;             // Último bloque contado como tardío (solo el audio)
+};
+
+struct ConvolutionEngine::State {
+    std::shared_ptr<const ConvolutionIR> impulse;
+    PathSpec paths[4];
+    int numPaths = 0;
+
+    std::vector<float> history[2];      // Entrada, anillo de historySize
+    std::vector<float> headWindow[2];   // 64 samples previos + bloque actual
+    std::vector<float> accumulator[2];  // Salida futura de los niveles del audio
+    std::vector<std::unique_ptr<LevelState>> levels;
+    int64_t time = 0;
+};
+
+//==============================================================================
+// Hilo de fondo compartido por todos los motores
+//==============================================================================
+
+class ConvolutionEngine::TailWorker : public juce::Thread {
+public:
+    static std::shared_ptr<TailWorker> getInstance() {
+        static std::mutex instanceMutex;
+        static std::weak_ptr<TailWorker> instance;
+
+        std::lock_guard<std::mutex> guard(instanceMutex);
+        auto worker = instance.lock();
+        if (worker == nullptr) {
+            worker = std::make_shared<TailWorker>();
+            instance = worker;
+        }
+        return worker;
+    }
+
+    TailWorker() : juce::Thread("Convolution Tail") {
+        startThread(juce::Thread::Priority::high);
+    }
+
+    ~TailWorker() override {
+        stopThread(1000);
+    }
+
+    void add(ConvolutionEngine* engine) {
+        std::lock_guard<std::mutex> guard(enginesMutex_);
+        engines_.push_back(engine);
+    }
+
+    // Al volver, el worker ya no está usando el motor
+    void remove(ConvolutionEngine* engine) {
+        std::lock_guard<std::mutex> guard(enginesMutex_);
+        engines_.erase(std::remove(engines_.begin(), engines_.end(), engine), engines_.end());
+    }
+
+    void run() override {
+        while (!threadShouldExit()) {
+            // notify() despierta al hilo; el timeout solo cubre la salida
+            wait(10);
+            std::lock_guard<std::mutex> guard(enginesMutex_);
+            for (auto* engine : engines_)
+                engine->runBackgroundJobs();
+        }
+    }
+
+private:
+    std::mutex enginesMutex_;
+    std::vector<ConvolutionEngine*> engines_;
+};
+
+//==============================================================================
+// ConvolutionEngine
+//==============================================================================
+
+ConvolutionEngine::ConvolutionEngine(bool useBackgroundThread)
+    : useBackgroundThread_(useBackgroundThread) {}
+
+ConvolutionEngine::~ConvolutionEngine() {
+    if (worker_ != nullptr)
+        worker_->remove(this);
+}
+
+void ConvolutionEngine::prepare(double sampleRate, int /*maxBlockSize*/) {
+    sampleRate_ = sampleRate;
+    reset();
+}
+
+void ConvolutionEngine::reset() {
+    setImpulseResponse(impulse_);
+}
+
+std::unique_ptr<ConvolutionEngine::State> ConvolutionEngine::createState() const {
+    if (impulse_ == nullptr)
+        return nullptr;
+
+    auto state = std::make_unique<State>();
+    state->impulse = impulse_;
+    state->numPaths = getPaths(impulse_->getLayout(), state->paths);
+
+    for (int ch = 0; ch < 2; ++ch) {
+        state->history[ch].assign(historySize, 0.0f);
+        state->headWindow[ch].assign(2 * ConvolutionIR::headLength, 0.0f);
+        state->accumulator[ch].assign(accumulatorSize, 0.0f);
+    }
+
+    for (const auto& spec : impulse_->getLevels()) {
+        auto level = std::make_unique<LevelState>();
+        level->spec = &spec;
+        level->partitionSize = spec.partitionSize;
+        level->offset = spec.offset;
+        level->numPartitions = spec.numPartitions;
+        level->background = spec.background;
+
+        const int fftSize = 2 * spec.partitionSize;
+        const size_t stride = static_cast<size_t>(2 * (spec.partitionSize + 1));
+        level->fft = std::make_unique<juce::dsp::FFT>(fftOrderFor(fftSize));
+        level->work.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+        level->accumulator.assign(stride, 0.0f);
+
+        for (int ch = 0; ch < 2; ++ch) {
+            level->fdl[ch].assign(stride * static_cast<size_t>(spec.numPartitions), 0.0f);
+            if (spec.background) {
+                level->slots[ch].assign(static_cast<size_t>(numOutputSlots * spec.partitionSize), 0.0f);
+                level->aheadSlots[ch].assign(static_cast<size_t>(numOutputSlots * spec.partitionSize), 0.0f);
+            } else
+                level->blockOut[ch].assign(static_cast<size_t>(spec.partitionSize), 0.0f);
+        }
+
+        state->levels.push_back(std::move(level));
+    }
+
+    return state;
+}
+
+void ConvolutionEngine::setImpulseResponse(std::shared_ptr<const ConvolutionIR> impulse) {
+    impulse_ = std::move(impulse);
+    auto newState = createState();
+
+    // El worker suelta el estado viejo antes del cambio
+    if (worker_ != nullptr)
+        worker_->remove(this);
+
+    {
+        Omega::Utils::SpinLockGuard guard(lock_);
+        std::swap(state_, newState);
+    }
+
+    const bool needsWorker = state_ != nullptr && useBackgroundThread_
+        && std::any_of(state_->levels.begin(), state_->levels.end(),
+                       [](const auto& level) { return level->background; });
+    if (needsWorker) {
+        if (worker_ == nullptr)
+            worker_ = TailWorker::getInstance();
+        worker_->add(this);
+    }
+
+    // newState (el viejo) se libera aquí, fuera del hilo de audio
+}
+
+//==============================================================================
+void ConvolutionEngine::transformInput(State& state, LevelState& level, int64_t block) {
+    const int P = level.partitionSize;
+    const size_t stride = static_cast<size_t>(2 * (P + 1));
+    float* work = level.work.data();
+
+    // Espectro de la ventana [bloque - 1, bloque] de cada entrada (overlap-save).
+    // El worker lee el historial mientras el audio lo escribe: accesos atómicos
+    // relajados, y runTailJobs descarta el espectro si el anillo dio la vuelta
+    const int slot = static_cast<int>(block % level.numPartitions);
+    for (int ch = 0; ch < 2; ++ch) {
+        float* history = state.history[ch].data();
+        const int64_t start = (block - 1) * P;
+        for (int i = 0; i < 2 * P; ++i)
+            work[i] = std::atomic_ref<float>(history[(start + i) & (historySize - 1)]).load(std::memory_order_relaxed);
+        std::fill(work + 2 * P, work + 4 * P, 0.0f);
+
+        level.fft->performRealOnlyForwardTransform(work, true);
+        deinterleave(work, level.fdl[ch].data() + static_cast<size_t>(slot) * stride, P + 1);
+    }
+}
+
+void ConvolutionEngine::accumulateBlock(State& state, LevelState& level, int64_t block, int firstPartition,
+                                        int endPartition, float* left, float* right) {
+    const int P = level.partitionSize;
+    const int numBins = P + 1;
+    const size_t stride = static_cast<size_t>(2 * numBins);
+    float* work = level.work.data();
+    const int slot = static_cast<int>(block % level.numPartitions);
+
+    // Una IFFT por salida con todos sus caminos y particiones acumulados
+    float* outputs[2] = { left, right };
+    for (int out = 0; out < 2; ++out) {
+        float* accumulator = level.accumulator.data();
+        std::fill(accumulator, accumulator + stride, 0.0f);
+
+        for (int p = 0; p < state.numPaths; ++p) {
+            const auto& path = state.paths[p];
+            if (path.output != out)
+                continue;
+
+            for (int j = firstPartition; j < endPartition; ++j) {
+                const int fdlSlot = (slot - j + level.numPartitions) % level.numPartitions;
+                multiplyAccumulate(accumulator,
+                                   level.fdl[path.input].data() + static_cast<size_t>(fdlSlot) * stride,
+                                   level.spec->getSpectrum(path.irChannel, j), numBins);
+            }
+        }
+
+        interleave(accumulator, work, numBins);
+        level.fft->performRealOnlyInverseTransform(work);
+        std::copy(work + P, work + 2 * P, outputs[out]);
+    }
+}
+
+void ConvolutionEngine::computeBlock(State& state, LevelState& level, int64_t block, float* left, float* right) {
+    transformInput(state, level, block);
+    accumulateBlock(state, level, block, 0, level.numPartitions, left, right);
+}
+
+void ConvolutionEngine::runTailJobs(State& state, LevelState& level) {
+    const int P = level.partitionSize;
+
+    // Orden fijo: adelantada(k), completa(k), adelantada(k + 1)... La adelantada
+    // de k solo usa entrada hasta k - 1, así que sale en cuanto termina k - 1
+    for (;;) {
+        const int64_t block = level.done.load(std::memory_order_relaxed);
+        const int64_t requested = level.requested.load(std::memory_order_acquire);
+        const size_t offset = static_cast<size_t>((block % numOutputSlots) * P);
+
+        // El bloque k suena en [k + 2, k + 3) bloques: pasado eso el audio ya no
+        // lo lee y solo se conserva su espectro de entrada
+        const bool audible = requested < block + 3;
+
+        if (level.aheadDone.load(std::memory_order_relaxed) <= block) {
+            float* left = level.aheadSlots[0].data() + offset;
+            float* right = level.aheadSlots[1].data() + offset;
+            if (!audible) {
+                // Nada que calcular
+            } else if (level.numPartitions > 1) {
+                accumulateBlock(state, level, block, 1, level.numPartitions, left, right);
+            } else {
+                std::fill(left, left + P, 0.0f);
+                std::fill(right, right + P, 0.0f);
+            }
+            level.aheadDone.store(block + 1, std::memory_order_release);
+            continue;
+        }
+
+        if (block >= requested)
+            break;
+
+        // La ventana del bloque se sobrescribe en cuanto el audio completa el
+        // bloque k + historySize / P - 1; se comprueba antes y después de leerla
+        const int64_t overwritten = block + historySize / P - 1;
+        bool inputValid = requested < overwritten;
+        if (inputValid) {
+            transformInput(state, level, block);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            inputValid = level.requested.load(std::memory_order_relaxed) < overwritten;
+        }
+
+        if (!inputValid) {
+            // Tan tarde que la entrada ya se sobrescribió: el bloque no aporta cola
+            const size_t stride = static_cast<size_t>(2 * (P + 1));
+            const size_t slot = static_cast<size_t>(block % level.numPartitions) * stride;
+            for (int ch = 0; ch < 2; ++ch)
+                std::fill(level.fdl[ch].begin() + static_cast<std::ptrdiff_t>(slot),
+                          level.fdl[ch].begin() + static_cast<std::ptrdiff_t>(slot + stride), 0.0f);
+        }
+
+        if (audible) {
+            float* left = level.slots[0].data() + offset;
+            float* right = level.slots[1].data() + offset;
+            accumulateBlock(state, level, block, 0, 1, left, right);
+            juce::FloatVectorOperations::add(left, level.aheadSlots[0].data() + offset, P);
+            juce::FloatVectorOperations::add(right, level.aheadSlots[1].data() + offset, P);
+        }
+        level.done.store(block + 1, std::memory_order_release);
+    }
+}
+
+const std::vector<float>* ConvolutionEngine::getTailBlock(LevelState& level, int64_t block) {
+    if (level.done.load(std::memory_order_acquire) > block)
+        return level.slots;
+
+    // Offline se espera al hilo (salida completa); con el audio en tiempo real
+    // por encima del worker en el mismo núcleo, esperar podría no acabar nunca
+    if (nonRealtime_.load(std::memory_order_relaxed)) {
+        while (level.done.load(std::memory_order_acquire) <= block)
+            juce::Thread::yield();
+        return level.slots;
+    }
+
+    if (level.lateBlock != block) {
+        level.lateBlock = block;
+        lateTailBlocks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Sin la partición 0 la cola suena casi entera; sin nada, se omite el bloque
+    if (level.aheadDone.load(std::memory_order_acquire) > block)
+        return level.aheadSlots;
+    return nullptr;
+}
+
+void ConvolutionEngine::runBackgroundJobs() {
+    if (state_ == nullptr)
+        return;
+
+    for (auto& levelPtr : state_->levels) {
+        if (levelPtr->background)
+            runTailJobs(*state_, *levelPtr);
+    }
+}
+
+//==============================================================================
+void ConvolutionEngine::process(const float* const* inputs, int numInputs, float* const* outputs, int numSamples) {
+    if (!lock_.tryLock()) {
+        juce::FloatVectorOperations::clear(outputs[0], numSamples);
+        juce::FloatVectorOperations::clear(outputs[1], numSamples);
+        return;
+    }
+
+    if (state_ == nullptr || numInputs <= 0) {
+        lock_.unlock();
+        juce::FloatVectorOperations::clear(outputs[0], numSamples);
+        juce::FloatVectorOperations::clear(outputs[1], numSamples);
+        return;
+    }
+
+    auto& state = *state_;
+    const int H = ConvolutionIR::headLength;
+    const float* in[2] = { inputs[0], inputs[numInputs > 1 ? 1 : 0] };
+
+    // Trozos alineados a 64: ninguno cruza un límite de bloque de ningún nivel
+    for (int position = 0; position < numSamples;) {
+        const int chunk = std::min(numSamples - position, H - static_cast<int>(state.time % H));
+        const int64_t time = state.time;
+
+        // Entrada: historial de los niveles y ventana de la cabeza
+        for (int ch = 0; ch < 2; ++ch) {
+            float* history = state.history[ch].data();
+            for (int i = 0; i < chunk; ++i)
+                std::atomic_ref<float>(history[(time + i) & (historySize - 1)]).store(in[ch][position + i],
+                                                                                       std::memory_order_relaxed);
+            std::copy(in[ch] + position, in[ch] + position + chunk, state.headWindow[ch].data() + H);
+        }
+
+        // Salida: lo acumulado por los niveles del audio
+        for (int ch = 0; ch < 2; ++ch) {
+            float* accumulator = state.accumulator[ch].data();
+            float* out = outputs[ch] + position;
+            for (int i = 0; i < chunk; ++i) {
+                const size_t index = static_cast<size_t>((time + i) & (accumulatorSize - 1));
+                out[i] = accumulator[index];
+                accumulator[index] = 0.0f;
+            }
+        }
+
+        // Cabeza FIR directa (latencia cero)
+        for (int p = 0; p < state.numPaths; ++p) {
+            const auto& path = state.paths[p];
+            const float* taps = state.impulse->getHead(path.irChannel);
+            const float* window = state.headWindow[path.input].data() + 1;
+            float* out = outputs[path.output] + position;
+            for (int i = 0; i < chunk; ++i) {
+                float sum = 0.0f;
+                for (int q = 0; q < H; ++q)
+                    sum += taps[q] * window[i + q];
+                out[i] += sum;
+            }
+        }
+
+        for (int ch = 0; ch < 2; ++ch) {
+            float* window = state.headWindow[ch].data();
+            std::copy(window + chunk, window + chunk + H, window);
+        }
+
+        // Niveles de fondo: el bloque que cubre este trozo
+        for (auto& levelPtr : state.levels) {
+            auto& level = *levelPtr;
+            if (!level.background || time < level.offset)
+                continue;
+
+            const int64_t block = (time - level.offset) / level.partitionSize;
+            const int offset = static_cast<int>((time - level.offset) % level.partitionSize);
+            const auto* result = getTailBlock(level, block);
+            if (result == nullptr)
+                continue;
+
+            const size_t slot = static_cast<size_t>((block % numOutputSlots) * level.partitionSize + offset);
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::add(outputs[ch] + position, result[ch].data() + slot, chunk);
+        }
+
+        state.time += chunk;
+        position += chunk;
+
+        // Bloques completos: los del audio se calculan ya, los de fondo se encargan
+        if (state.time % H == 0) {
+            bool notify = false;
+            for (auto& levelPtr : state.levels) {
+                auto& level = *levelPtr;
+                if (state.time % level.partitionSize != 0)
+                    continue;
+
+                const int64_t block = state.time / level.partitionSize - 1;
+                if (level.background) {
+                    level.requested.store(block + 1, std::memory_order_release);
+                    // Las escrituras del historial posteriores no se adelantan al
+                    // aviso: si el worker ve una, ve también este requested
+                    std::atomic_thread_fence(std::memory_order_release);
+                    if (useBackgroundThread_)
+                        notify = true;
+                    else
+                        runTailJobs(state, level);   // Sin hilo: la cola se calcula aquí, al completarse
+                    continue;
+                }
+
+                computeBlock(state, level, block, level.blockOut[0].data(), level.blockOut[1].data());
+
+                // El bloque k aporta desde k * P + offset (>= ahora)
+                const int64_t start = block * level.partitionSize + level.offset;
+                for (int ch = 0; ch < 2; ++ch) {
+                    float* accumulator = state.accumulator[ch].data();
+                    const float* result = level.blockOut[ch].data();
+                    for (int i = 0; i < level.partitionSize; ++i)
+                        accumulator[(start + i) & (accumulatorSize - 1)] += result[i];
+                }
+            }
+
+            if (notify && worker_ != nullptr)
+                worker_->notify();
+        }
+    }
+
+    lock_.unlock();
+}
+
+//==============================================================================
+void ConvolutionEngine::render(const juce::AudioBuffer<float>& input, std::shared_ptr<const ConvolutionIR> impulse,
+                               juce::AudioBuffer<float>& output) {
+    if (impulse == nullptr || input.getNumChannels() == 0) {
+        output.setSize(2, 0);
+        return;
+    }
+
+    // Sin hilo de fondo: el propio bucle calcula la cola al llegar cada plazo
+    ConvolutionEngine engine(false);
+    engine.setImpulseResponse(std::move(impulse));
+
+    const int inputLength = input.getNumSamples();
+    const int length = inputLength + engine.getImpulseResponse()->getLength() - 1;
+    output.setSize(2, length);
+
+    const int blockSize = 4096;
+    const int numInputs = std::min(2, input.getNumChannels());
+    std::vector<float> padded[2];
+
+    for (int position = 0; position < length; position += blockSize) {
+        const int count = std::min(blockSize, length - position);
+        const int fromInput = std::max(0, std::min(count, inputLength - position));
+
+        const float* inputs[2];
+        for (int ch = 0; ch < numInputs; ++ch) {
+            if (fromInput == count) {
+                inputs[ch] = input.getReadPointer(ch, position);
+                continue;
+            }
+
+            // Tras el final de la entrada, silencio hasta que se vacía la cola
+            padded[ch].assign(static_cast<size_t>(count), 0.0f);
+            if (fromInput > 0)
+                std::copy(input.getReadPointer(ch, position), input.getReadPointer(ch, position) + fromInput,
+                          padded[ch].begin());
+            inputs[ch] = padded[ch].data();
+        }
+
+        float* outputs[2] = { output.getWritePointer(0, position), output.getWritePointer(1, position) };
+        engine.process(inputs, numInputs, outputs, count);
+    }
+}
+
+} // namespace OmegaStudio
@@ -0,0 +1,143 @@
+//==============================================================================
+// ConvolutionEngine.h - Convolución particionada no uniforme (latencia cero)
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Utils/Atomic.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace OmegaStudio {
+
+//==============================================================================
+/** Respuesta al impulso preparada para convolución particionada
+ *  - Inmutable: los espectros se comparten entre todas las instancias
+ *  - 1 canal (mono), 2 (estéreo) o 4 (true stereo: LL, LR, RL, RR)
+ *  - loadFile() cachea por archivo y sample rate: N reverbs con la misma IR
+ *    comparten una sola copia de los espectros
+ */
+class ConvolutionIR {
+public:
+    enum class Layout { Mono, Stereo, TrueStereo };
+
+    static constexpr int headLength = 64;
+
+    // Nivel de particiones uniformes: cubre [offset, offset + numPartitions * partitionSize)
+    struct Level {
+        int partitionSize = 0;
+        int offset = 0;
+        int numPartitions = 0;
+        bool background = false;         // Calculado en el hilo de fondo
+        std::vector<float> spectra;      // [canal][partición][re | im], partitionSize + 1 bins
+
+        const float* getSpectrum(int channel, int partition) const {
+            const size_t stride = static_cast<size_t>(2 * (partitionSize + 1));
+            return spectra.data() + (static_cast<size_t>(channel) * static_cast<size_t>(numPartitions)
+                                     + static_cast<size_t>(partition)) * stride;
+        }
+    };
+
+    static std::shared_ptr<const ConvolutionIR> create(const juce::AudioBuffer<float>& impulse,
+                                                       double sampleRate, bool normalise = true);
+    static std::shared_ptr<const ConvolutionIR> loadFile(const juce::File& file, double sampleRate,
+                                                         bool normalise = true);
+
+    Layout getLayout() const { return layout_; }
+    int getNumChannels() const { return numChannels_; }
+    int getLength() const { return length_; }
+    double getSampleRate() const { return sampleRate_; }
+
+    const std::vector<Level>& getLevels() const { return levels_; }
+
+    // Primeros headLength taps, invertidos (convolución directa sin latencia)
+    const float* getHead(int channel) const { return head_.data() + channel * headLength; }
+
+private:
+    ConvolutionIR() = default;
+
+    Layout layout_ = Layout::Mono;
+    int numChannels_ = 1;
+    int length_ = 0;
+    double sampleRate_ = 48000.0;
+
+    std::vector<float> head_;
+    std::vector<Level> levels_;
+};
+
+//==============================================================================
+/** Motor de convolución particionada no uniforme
+ *  - Cabeza FIR directa de 64 taps: latencia cero
+ *  - Particiones de 64 y 512 samples en el hilo de audio
+ *  - Cola en particiones de 4096 y 16384 en un hilo de fondo compartido por
+ *    todas las instancias. Cada bloque se parte en dos trabajos: las
+ *    particiones 1..N-1 solo dependen de entrada ya recibida y se calculan una
+ *    partición antes (dos bloques de margen); la partición 0 y la suma final,
+ *    baratas, con un bloque de margen
+ *  - En tiempo real el audio nunca espera ni calcula la cola: si el bloque no
+ *    está completo suena la parte adelantada (o nada, si tampoco está) y se
+ *    cuenta en getNumLateTailBlocks(). En modo no realtime espera al hilo
+ *  - FFT de entrada una vez por canal y nivel; los caminos true stereo se
+ *    acumulan en frecuencia y hay una sola IFFT por salida y bloque
+ */
+class ConvolutionEngine {
+public:
+    explicit ConvolutionEngine(bool useBackgroundThread = true);
+    ~ConvolutionEngine();
+
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+
+    // Hilo de mensajes. El audio nunca espera: durante el cambio sale silencio
+    void setImpulseResponse(std::shared_ptr<const ConvolutionIR> impulse);
+    std::shared_ptr<const ConvolutionIR> getImpulseResponse() const { return impulse_; }
+    bool hasImpulseResponse() const { return impulse_ != nullptr; }
+
+    // Audio: 1-2 entradas, 2 salidas (solo señal húmeda). In-place permitido
+    void process(const float* const* inputs, int numInputs, float* const* outputs, int numSamples);
+    int getLatencySamples() const { return 0; }
+
+    // Render offline: el audio espera siempre al hilo de fondo (salida completa)
+    void setNonRealtime(bool isNonRealtime) { nonRealtime_.store(isNonRealtime, std::memory_order_relaxed); }
+    bool isNonRealtime() const { return nonRealtime_.load(std::memory_order_relaxed); }
+
+    // Bloques de cola que sonaron incompletos porque el hilo de fondo no llegó a tiempo
+    int getNumLateTailBlocks() const { return lateTailBlocks_.load(std::memory_order_relaxed); }
+
+    // Offline: output = input * IR completa (input + IR - 1 samples, 2 canales)
+    static void render(const juce::AudioBuffer<float>& input,
+                       std::shared_ptr<const ConvolutionIR> impulse,
+                       juce::AudioBuffer<float>& output);
+
+private:
+    class TailWorker;
+    struct LevelState;
+    struct State;
+
+    std::unique_ptr<State> createState() const;
+    void transformInput(State& state, LevelState& level, int64_t block);
+    void accumulateBlock(State& state, LevelState& level, int64_t block, int firstPartition, int endPartition,
+                         float* left, float* right);
+    void computeBlock(State& state, LevelState& level, int64_t block, float* left, float* right);
+    void runTailJobs(State& state, LevelState& level);
+    const std::vector<float>* getTailBlock(LevelState& level, int64_t block);
+    void runBackgroundJobs();
+
+    std::shared_ptr<const ConvolutionIR> impulse_;
+    std::unique_ptr<State> state_;
+    std::shared_ptr<TailWorker> worker_;
+    Omega::Utils::SpinLock lock_;
+
+    const bool useBackgroundThread_;
+    double sampleRate_ = 48000.0;
+    std::atomic<bool> nonRealtime_ { false };
+    std::atomic<int> lateTailBlocks_ { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionEngine)
+};
+
+} // namespace OmegaStudio
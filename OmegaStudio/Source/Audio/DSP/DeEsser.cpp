@@ -12,91 +12,90 @@ ProDeEsser::ProDeEsser() {
 
 void ProDeEsser::initialize(double sampleRate, int maxBlockSize) {
     m_sampleRate = sampleRate;
-    m_sibilanceBuffer.setSize(1, maxBlockSize);
-    
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = maxBlockSize;
-    spec.numChannels = 1;
-    
-    m_highPassFilter.prepare(spec);
-    m_bandPassFilter.prepare(spec);
-    m_lowPassFilter.prepare(spec);
+    m_sibilanceBuffer.setSize(3, maxBlockSize);
     
+    m_bandPass.prepare(sampleRate);
     updateFilters();
+    
+    // Fast attack so the first "s" is caught, release short enough not to dull the next word
+    m_detector.prepare(OmegaStudio::Dynamics::DetectorMode::Peak, 2);
+    m_follower.setTimes(sampleRate, 0.5f, 50.0f);
 }
 
 void ProDeEsser::process(float* buffer, int numSamples) {
     if (!buffer || numSamples == 0)
         return;
     
+    numSamples = juce::jmin(numSamples, m_sibilanceBuffer.getNumSamples());
+    
     // Extract sibilance using band-pass filter
-    juce::FloatVectorOperations::copy(m_sibilanceBuffer.getWritePointer(0), buffer, numSamples);
+    float* sibilanceData = m_sibilanceBuffer.getWritePointer(0);
+    juce::FloatVectorOperations::copy(sibilanceData, buffer, numSamples);
+    m_bandPass.process(&sibilanceData, 1, numSamples);
     
-    juce::dsp::AudioBlock<float> block(m_sibilanceBuffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    m_bandPassFilter.process(context);
+    // Detect sibilance level and turn it into a per-sample gain
+    float* gains = m_sibilanceBuffer.getWritePointer(2);
+    m_detector.process(&sibilanceData, 1, gains, numSamples);
+    computeGains(gains, numSamples);
     
-    const float* sibilanceData = m_sibilanceBuffer.getReadPointer(0);
+    applyReduction(buffer, sibilanceData, gains, numSamples);
+}
+
+void ProDeEsser::processStereo(float* leftBuffer, float* rightBuffer, int numSamples) {
+    if (!leftBuffer || !rightBuffer || numSamples == 0)
+        return;
+    
+    numSamples = juce::jmin(numSamples, m_sibilanceBuffer.getNumSamples());
+    
+    // Both channels through the band-pass in one pass
+    float* sibilance[2] = { m_sibilanceBuffer.getWritePointer(0), m_sibilanceBuffer.getWritePointer(1) };
+    juce::FloatVectorOperations::copy(sibilance[0], leftBuffer, numSamples);
+    juce::FloatVectorOperations::copy(sibilance[1], rightBuffer, numSamples);
+    m_bandPass.process(sibilance, 2, numSamples);
     
-    // Detect sibilance level
-    float sibilanceLevel = detectSibilance(sibilanceData, numSamples);
+    // Linked detection keeps the stereo image stable
+    float* gains = m_sibilanceBuffer.getWritePointer(2);
+    m_detector.process(sibilance, 2, gains, numSamples);
+    computeGains(gains, numSamples);
     
-    // Calculate compression
-    float compression = calculateCompression(sibilanceLevel);
-    m_gainReduction = compression;
+    applyReduction(leftBuffer, sibilance[0], gains, numSamples);
+    applyReduction(rightBuffer, sibilance[1], gains, numSamples);
+}
+
+void ProDeEsser::computeGains(float* levels, int numSamples) {
+    OmegaStudio::Dynamics::GainCurve::Parameters curve;
+    curve.threshold = m_threshold;
+    curve.ratio = m_range > 0.0f ? m_ratio : 1.0f;
+    curve.knee = 0.0f;
+    curve.range = m_range;
+    m_curve.setParameters(curve);
     
+    // In place: levels -> envelope -> linear gain
+    m_follower.process(levels, levels, numSamples);
+    m_curve.process(levels, levels, numSamples);
+    m_gainReduction = levels[numSamples - 1];
+}
+
+void ProDeEsser::applyReduction(float* buffer, const float* sibilance, const float* gains, int numSamples) {
     if (m_listenMode) {
         // Output only sibilance band
-        juce::FloatVectorOperations::copy(buffer, sibilanceData, numSamples);
+        juce::FloatVectorOperations::copy(buffer, sibilance, numSamples);
     } else {
-        // Apply compression to sibilance band and subtract from original
-        for (int i = 0; i < numSamples; ++i) {
-            float original = buffer[i];
-            float sibilance = sibilanceData[i];
-            float reducedSibilance = sibilance * compression;
-            buffer[i] = original - sibilance + reducedSibilance;
-        }
+        // original - sibilance + sibilance * gain
+        for (int i = 0; i < numSamples; ++i)
+            buffer[i] += sibilance[i] * (gains[i] - 1.0f);
     }
 }
 
-void ProDeEsser::processStereo(float* leftBuffer, float* rightBuffer, int numSamples) {
-    process(leftBuffer, numSamples);
-    process(rightBuffer, numSamples);
-}
-
 void ProDeEsser::reset() {
-    m_highPassFilter.reset();
-    m_bandPassFilter.reset();
-    m_lowPassFilter.reset();
+    m_bandPass.reset();
+    m_detector.reset();
+    m_follower.reset();
     m_gainReduction = 0.0f;
 }
 
 void ProDeEsser::updateFilters() {
-    auto coeffs = juce::dsp::IIR::Coefficients<float>::makeBandPass(
-        m_sampleRate, m_frequency, 2.0);
-    
-    *m_bandPassFilter.coefficients = *coeffs;
-}
-
-float ProDeEsser::detectSibilance(const float* buffer, int numSamples) {
-    float peak = 0.0f;
-    for (int i = 0; i < numSamples; ++i) {
-        peak = juce::jmax(peak, std::abs(buffer[i]));
-    }
-    
-    return juce::Decibels::gainToDecibels(peak);
-}
-
-float ProDeEsser::calculateCompression(float level) {
-    if (level < m_threshold)
-        return 1.0f;  // No compression
-    
-    float excess = level - m_threshold;
-    float reduction = excess * (1.0f - 1.0f / m_ratio);
-    reduction = juce::jmin(reduction, m_range);
-    
-    return juce::Decibels::decibelsToGain(-reduction);
+    m_bandPass.setStage(0, OmegaStudio::BiquadCoefficients::bandPass(m_sampleRate, m_frequency, 2.0));
 }
 
 } // namespace omega
@@ -15,6 +15,8 @@
 #include <JuceHeader.h>
 #include <memory>
 #include "../../Utils/Constants.h"
+#include "BiquadCascade.h"
+#include "DynamicsCore.h"
 
 namespace omega {
 
@@ -51,12 +53,16 @@ public:
     
 private:
     void updateFilters();
-    float detectSibilance(const float* buffer, int numSamples);
-    float calculateCompression(float level);
+    void computeGains(float* levels, int numSamples);
+    void applyReduction(float* buffer, const float* sibilance, const float* gains, int numSamples);
     
-    juce::dsp::IIR::Filter<float> m_highPassFilter;
-    juce::dsp::IIR::Filter<float> m_bandPassFilter;
-    juce::dsp::IIR::Filter<float> m_lowPassFilter;
+    // Sibilance band-pass; stereo runs L/R as two lanes with independent state
+    OmegaStudio::BiquadCascade m_bandPass;
+    
+    // Per-sample detection: linked peak -> envelope -> gain curve (shared dynamics core)
+    OmegaStudio::Dynamics::LevelDetector m_detector;
+    OmegaStudio::Dynamics::EnvelopeFollower m_follower;
+    OmegaStudio::Dynamics::GainCurve m_curve;
     
     float m_frequency { 6000.0f };
     float m_threshold { -20.0f };
@@ -68,7 +74,7 @@ private:
     float m_gainReduction { 0.0f };
     double m_sampleRate { 48000.0 };
     
-    juce::AudioBuffer<float> m_sibilanceBuffer;
+    juce::AudioBuffer<float> m_sibilanceBuffer;     // L, R sibilance + gain scratch
 };
 
 } // namespace omega
@@ -0,0 +1,242 @@
+//==============================================================================
+// DynamicsCore.cpp - Implementation
+//==============================================================================
+
+#include "DynamicsCore.h"
+#include "SIMDProcessor.h"
+
+namespace OmegaStudio {
+namespace Dynamics {
+
+using Omega::Audio::DSP::Vec4;
+
+//==============================================================================
+void gainToDecibels(const float* gains, float* decibels, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+        decibels[i] = log2ToDecibels * fastLog2(std::max(gains[i], minimumGain));
+}
+
+void decibelsToGain(const float* decibels, float* gains, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+        gains[i] = fastExp2(decibels[i] * decibelsToLog2);
+}
+
+void applyGain(float* const* channels, int numChannels, const float* gains, int numSamples) {
+    for (int ch = 0; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::multiply(channels[ch], gains, numSamples);
+}
+
+//==============================================================================
+// LevelDetector
+//==============================================================================
+void LevelDetector::prepare(DetectorMode mode, int numChannels, int oversamplingFactor, TruePeakQuality quality) {
+    mode_ = mode;
+    numChannels_ = juce::jlimit(1, maxChannels, numChannels);
+
+    if (mode_ == DetectorMode::TruePeak) {
+        for (int ch = 0; ch < numChannels_; ++ch)
+            truePeak_[static_cast<size_t>(ch)].prepare(oversamplingFactor, quality);
+    }
+    reset();
+}
+
+void LevelDetector::reset() {
+    if (mode_ == DetectorMode::TruePeak) {
+        for (int ch = 0; ch < numChannels_; ++ch)
+            truePeak_[static_cast<size_t>(ch)].reset();
+    }
+}
+
+void LevelDetector::process(const float* const* channels, int numChannels, float* levels, int numSamples) {
+    numChannels = juce::jmin(numChannels, mode_ == DetectorMode::TruePeak ? numChannels_ : maxChannels);
+    if (numChannels <= 0) {
+        juce::FloatVectorOperations::clear(levels, numSamples);
+        return;
+    }
+
+    switch (mode_) {
+        case DetectorMode::Peak: {
+            const float* first = channels[0];
+            for (int i = 0; i < numSamples; ++i)
+                levels[i] = std::abs(first[i]);
+
+            for (int ch = 1; ch < numChannels; ++ch) {
+                const float* data = channels[ch];
+                for (int i = 0; i < numSamples; ++i)
+                    levels[i] = std::max(levels[i], std::abs(data[i]));
+            }
+            break;
+        }
+
+        case DetectorMode::RMS: {
+            const float scale = 1.0f / static_cast<float>(numChannels);
+            const float* first = channels[0];
+            for (int i = 0; i < numSamples; ++i)
+                levels[i] = first[i] * first[i];
+
+            for (int ch = 1; ch < numChannels; ++ch) {
+                const float* data = channels[ch];
+                for (int i = 0; i < numSamples; ++i)
+                    levels[i] += data[i] * data[i];
+            }
+
+            if (numChannels > 1)
+                juce::FloatVectorOperations::multiply(levels, scale, numSamples);
+            break;
+        }
+
+        case DetectorMode::TruePeak: {
+            truePeak_[0].process(channels[0], levels, numSamples);
+            for (int ch = 1; ch < numChannels; ++ch)
+                truePeak_[static_cast<size_t>(ch)].processMax(channels[ch], levels, numSamples);
+            break;
+        }
+    }
+}
+
+//==============================================================================
+// EnvelopeFollower
+//==============================================================================
+float EnvelopeFollower::timeToCoefficient(double sampleRate, float ms) {
+    if (ms <= 0.0f || sampleRate <= 0.0)
+        return 0.0f;
+    return static_cast<float>(std::exp(-1.0 / (sampleRate * static_cast<double>(ms) * 0.001)));
+}
+
+void EnvelopeFollower::setTimes(double sampleRate, float attackMs, float releaseMs) {
+    attack_ = timeToCoefficient(sampleRate, attackMs);
+    release_ = timeToCoefficient(sampleRate, releaseMs);
+}
+
+void EnvelopeFollower::process(const float* input, float* envelope, int numSamples) {
+    // Estado en registro; el select compila a cmov / blend
+    float state = state_;
+    const float attack = attack_;
+    const float release = release_;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float x = input[i];
+        const float c = x > state ? attack : release;
+        state = c * (state - x) + x;
+        envelope[i] = state;
+    }
+
+    // Denormales: una envolvente que decae hacia 0 no debe quedarse en subnormales
+    state_ = std::abs(state) < 1.0e-30f ? 0.0f : state;
+}
+
+//==============================================================================
+void EnvelopeFollower4::setTimes(int lane, double sampleRate, float attackMs, float releaseMs) {
+    if (lane < 0 || lane >= 4)
+        return;
+    attack_[static_cast<size_t>(lane)] = EnvelopeFollower::timeToCoefficient(sampleRate, attackMs);
+    release_[static_cast<size_t>(lane)] = EnvelopeFollower::timeToCoefficient(sampleRate, releaseMs);
+}
+
+void EnvelopeFollower4::process(const float* const* inputs, float* const* envelopes, int numSamples) {
+    const float* i0 = inputs[0];
+    const float* i1 = inputs[1];
+    const float* i2 = inputs[2];
+    const float* i3 = inputs[3];
+    float* e0 = envelopes[0];
+    float* e1 = envelopes[1];
+    float* e2 = envelopes[2];
+    float* e3 = envelopes[3];
+
+    const Vec4 attack = Vec4::load(attack_.data());
+    const Vec4 release = Vec4::load(release_.data());
+    Vec4 envelope = Vec4::load(state_.data());
+    alignas(16) float lanes[4];
+
+    for (int i = 0; i < numSamples; ++i) {
+        const Vec4 level = Vec4::set(i0[i], i1[i], i2[i], i3[i]);
+        const Vec4 coeff = Vec4::selectGreater(level, envelope, attack, release);
+        envelope = coeff * (envelope - level) + level;
+
+        envelope.store(lanes);
+        e0[i] = lanes[0];
+        e1[i] = lanes[1];
+        e2[i] = lanes[2];
+        e3[i] = lanes[3];
+    }
+
+    envelope.store(state_.data());
+    for (auto& s : state_)
+        s = std::abs(s) < 1.0e-30f ? 0.0f : s;
+}
+
+//==============================================================================
+// GainCurve
+//==============================================================================
+GainCurve::GainCurve() {
+    rebuild();
+}
+
+void GainCurve::setParameters(const Parameters& parameters) {
+    if (parameters == parameters_)
+        return;
+    parameters_ = parameters;
+    rebuild();
+}
+
+float GainCurve::computeGainReductionDb(float levelDb) const {
+    return computeGainReductionDb(parameters_, levelDb);
+}
+
+float GainCurve::computeGainReductionDb(const Parameters& parameters, float levelDb) {
+    const float slope = 1.0f / std::max(1.0f, parameters.ratio) - 1.0f;
+    const float knee = std::max(parameters.knee, 0.0f);
+    const float halfKnee = 0.5f * knee;
+    const float over = levelDb - parameters.threshold;
+
+    float reduction = 0.0f;
+    if (over > halfKnee) {
+        reduction = slope * over;
+    } else if (knee > 0.0f && over > -halfKnee) {
+        const float inKnee = over + halfKnee;
+        reduction = slope * inKnee * inKnee / (2.0f * knee);
+    }
+
+    if (parameters.range > 0.0f)
+        reduction = std::max(reduction, -parameters.range);
+    return reduction;
+}
+
+float GainCurve::autoMakeup(const Parameters& parameters) {
+    const float slope = 1.0f / std::max(1.0f, parameters.ratio) - 1.0f;
+    float makeup = 0.5f * parameters.threshold * slope;
+    if (parameters.range > 0.0f)
+        makeup = std::min(makeup, 0.5f * parameters.range);
+    return juce::jlimit(0.0f, 24.0f, makeup);
+}
+
+void GainCurve::rebuild() {
+    // Knee mínimo de un paso de tabla: el codo interpolado es exacto
+    auto smoothed = parameters_;
+    smoothed.knee = std::max(parameters_.knee, log2ToDecibels / static_cast<float>(stepsPerOctave));
+
+    for (int i = 0; i < tableSize; ++i) {
+        const float levelDb = log2ToDecibels * (minLog2 + static_cast<float>(i) / static_cast<float>(stepsPerOctave));
+        table_[static_cast<size_t>(i)] = (computeGainReductionDb(smoothed, levelDb) + parameters_.makeup) * decibelsToLog2;
+    }
+}
+
+void GainCurve::process(const float* envelope, float* gains, int numSamples, bool powerDomain) const {
+    // Potencia: log2(amplitud) = log2(potencia) / 2
+    const float levelScale = powerDomain ? 0.5f * stepsPerOctave : static_cast<float>(stepsPerOctave);
+    const float offset = -minLog2 * stepsPerOctave;
+    const float maxPosition = static_cast<float>(tableSize - 2) + 0.999f;
+    const float* table = table_.data();
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float position = std::min(maxPosition, std::max(0.0f,
+            fastLog2(std::max(envelope[i], minimumGain)) * levelScale + offset));
+        const int index = static_cast<int>(position);
+        const float frac = position - static_cast<float>(index);
+        const float y = table[index] + frac * (table[index + 1] - table[index]);
+        gains[i] = fastExp2(y);
+    }
+}
+
+} // namespace Dynamics
+} // namespace OmegaStudio
@@ -0,0 +1,184 @@
+//==============================================================================
+// DynamicsCore.h - Núcleo común de dinámica (detectores, envolventes, curvas)
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TruePeakDetector.h"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace OmegaStudio {
+namespace Dynamics {
+
+//==============================================================================
+// log2 / exp2 rápidos (sin ramas: los bucles de bloque se vectorizan)
+//==============================================================================
+inline float fastLog2(float x) {
+    const auto bits = std::bit_cast<uint32_t>(x);
+    const float exponent = static_cast<float>(static_cast<int>((bits >> 23) & 0xff) - 127);
+    const float m = std::bit_cast<float>((bits & 0x007fffffu) | 0x3f800000u);   // [1, 2)
+
+    // Polinomio de log2(m) en [1, 2) (nodos de Chebyshev), error < 2e-5
+    return exponent + (-2.78792621f + m * (5.04785541f + m * (-3.48987855f + m * (1.58947429f
+                                    + m * (-0.402513394f + m * 0.0430049578f)))));
+}
+
+inline float fastExp2(float x) {
+    x = std::min(126.0f, std::max(-126.0f, x));
+    const float floorX = std::floor(x);
+    const float f = x - floorX;
+
+    // Polinomio de 2^f en [0, 1), error relativo < 4e-6
+    const float p = 1.00000349f + f * (0.692972922f + f * (0.241604357f + f * (0.0517449978f + f * 0.0136703095f)));
+    const auto exponentBits = static_cast<uint32_t>(static_cast<int>(floorX) + 127) << 23;
+    return std::bit_cast<float>(std::bit_cast<uint32_t>(p) + exponentBits - 0x3f800000u);
+}
+
+constexpr float log2ToDecibels = 6.0205999f;        // 20 * log10(2)
+constexpr float log2ToDecibelsPower = 3.0103f;      // 10 * log10(2)
+constexpr float decibelsToLog2 = 0.16609640f;       // log2(10) / 20
+constexpr float minimumGain = 1.0e-10f;             // -200 dB
+
+inline float gainToDecibels(float gain) { return log2ToDecibels * fastLog2(std::max(gain, minimumGain)); }
+inline float decibelsToGain(float decibels) { return fastExp2(decibels * decibelsToLog2); }
+
+// Versiones de bloque (in-place permitido)
+void gainToDecibels(const float* gains, float* decibels, int numSamples);
+void decibelsToGain(const float* decibels, float* gains, int numSamples);
+
+//==============================================================================
+/** Aplica un gain por sample a todos los canales (vectorizado) */
+void applyGain(float* const* channels, int numChannels, const float* gains, int numSamples);
+
+//==============================================================================
+enum class DetectorMode {
+    Peak,           // max |x| entre canales (amplitud)
+    RMS,            // media de x² entre canales (potencia: la envolvente hace de ventana)
+    TruePeak        // pico entre samples (BS.1770), retrasado getLatency() samples
+};
+
+/** Detector de nivel enlazado entre canales
+ *  - Un valor por sample para todos los canales (stereo link)
+ *  - Peak y TruePeak dan amplitud; RMS da potencia (ver isPowerDomain())
+ */
+class LevelDetector {
+public:
+    static constexpr int maxChannels = 8;
+
+    void prepare(DetectorMode mode, int numChannels = 2, int oversamplingFactor = 4,
+                 TruePeakQuality quality = TruePeakQuality::Realtime);
+    void reset();
+
+    void process(const float* const* channels, int numChannels, float* levels, int numSamples);
+
+    DetectorMode getMode() const { return mode_; }
+    bool isPowerDomain() const { return mode_ == DetectorMode::RMS; }
+    int getLatency() const { return mode_ == DetectorMode::TruePeak ? truePeak_[0].getLatency() : 0; }
+
+private:
+    DetectorMode mode_ = DetectorMode::Peak;
+    int numChannels_ = 0;
+    std::array<TruePeakDetector, maxChannels> truePeak_;
+};
+
+//==============================================================================
+/** Seguidor de envolvente de un polo con ataque / release
+ *  - env = c * (env - x) + x, c = exp(-1 / (t * fs)); ataque si x > env
+ *  - Selección sin ramas: solo queda la recurrencia serie de un polo
+ *  - Sirve en cualquier dominio (amplitud, potencia, dB o gain)
+ */
+class EnvelopeFollower {
+public:
+    void setTimes(double sampleRate, float attackMs, float releaseMs);
+    void setCoefficients(float attack, float release) { attack_ = attack; release_ = release; }
+    void reset(float value = 0.0f) { state_ = value; }
+
+    // in-place permitido
+    void process(const float* input, float* envelope, int numSamples);
+    float processSample(float input) {
+        state_ = (input > state_ ? attack_ : release_) * (state_ - input) + input;
+        return state_;
+    }
+
+    float getState() const { return state_; }
+
+    static float timeToCoefficient(double sampleRate, float ms);
+
+private:
+    float attack_ = 0.0f;
+    float release_ = 0.0f;
+    float state_ = 0.0f;
+};
+
+/** Cuatro seguidores independientes en un registro SIMD (un lane por banda o canal) */
+class EnvelopeFollower4 {
+public:
+    void setTimes(int lane, double sampleRate, float attackMs, float releaseMs);
+    void reset(float value = 0.0f) { state_.fill(value); }
+
+    // inputs / envelopes: 4 punteros (pueden coincidir: in-place)
+    void process(const float* const* inputs, float* const* envelopes, int numSamples);
+
+    float getState(int lane) const { return state_[static_cast<size_t>(lane)]; }
+
+private:
+    alignas(16) std::array<float, 4> attack_ {};
+    alignas(16) std::array<float, 4> release_ {};
+    alignas(16) std::array<float, 4> state_ {};
+};
+
+//==============================================================================
+/** Curva estática de compresión en tabla
+ *  - Entrada: envolvente (amplitud o potencia); salida: gain lineal
+ *  - log2 rápido -> tabla interpolada (threshold, ratio, knee, rango y makeup
+ *    ya incluidos) -> exp2 rápido: sin log10 / pow por sample
+ *  - La tabla cubre -120..+24 dB en pasos de ~0.38 dB; el knee mínimo es un paso
+ *  - setParameters() reconstruye la tabla solo si algo cambió (~400 puntos)
+ */
+class GainCurve {
+public:
+    struct Parameters {
+        float threshold = -20.0f;    // dB
+        float ratio = 4.0f;          // 1:1 - inf:1
+        float knee = 6.0f;           // dB (0 = hard)
+        float makeup = 0.0f;         // dB
+        float range = 0.0f;          // Reducción máxima en dB (0 = sin límite)
+
+        bool operator== (const Parameters&) const = default;
+    };
+
+    GainCurve();
+
+    void setParameters(const Parameters& parameters);
+    const Parameters& getParameters() const { return parameters_; }
+
+    // Gain lineal por sample; powerDomain = envolvente en potencia (detector RMS)
+    void process(const float* envelope, float* gains, int numSamples, bool powerDomain = false) const;
+
+    // Curva exacta (UI, valores sueltos): reducción en dB sin makeup
+    float computeGainReductionDb(float levelDb) const;
+    static float computeGainReductionDb(const Parameters& parameters, float levelDb);
+
+    // Makeup automático: la mitad de la reducción a 0 dBFS
+    static float autoMakeup(const Parameters& parameters);
+
+private:
+    static constexpr float minLog2 = -20.0f;         // -120 dB
+    static constexpr float maxLog2 = 4.0f;           // +24 dB
+    static constexpr int stepsPerOctave = 16;
+    static constexpr int tableSize = static_cast<int>((maxLog2 - minLog2) * stepsPerOctave) + 2;
+
+    void rebuild();
+
+    Parameters parameters_;
+    std::array<float, tableSize> table_ {};          // Gain en log2 por cada log2 de nivel
+};
+
+} // namespace Dynamics
+} // namespace OmegaStudio
@@ -4,188 +4,203 @@
 
 #include "LimiterMaximizer.h"
 #include <cmath>
+#include <cstring>
 
 namespace OmegaStudio {
 
 //==============================================================================
-// LookAheadBuffer Implementation
+// LimiterMaximizer Implementation
 //==============================================================================
 
-void LimiterMaximizer::LookAheadBuffer::prepare(int maxSamples) {
-    buffer_.resize(maxSamples, 0.0f);
-    delay_ = maxSamples;
-    writePos_ = 0;
-    readPos_ = 0;
-}
-
-void LimiterMaximizer::LookAheadBuffer::write(float sample) {
-    buffer_[writePos_] = sample;
-}
-
-float LimiterMaximizer::LookAheadBuffer::read() const {
-    return buffer_[readPos_];
-}
-
-void LimiterMaximizer::LookAheadBuffer::advance() {
-    writePos_ = (writePos_ + 1) % buffer_.size();
-    readPos_ = (readPos_ + 1) % buffer_.size();
+namespace {
+    // Margen bajo el ceiling: la modulación de gain genera algo de energía
+    // entre samples que el detector de entrada no puede ver (~0.2 dB medido)
+    constexpr float truePeakMarginDb = -0.2f;
+    constexpr float maxLookAheadMs = 20.0f;
 }
 
-void LimiterMaximizer::LookAheadBuffer::reset() {
-    std::fill(buffer_.begin(), buffer_.end(), 0.0f);
-    writePos_ = 0;
-    readPos_ = 0;
-}
-
-//==============================================================================
-// LimiterMaximizer Implementation
-//==============================================================================
-
 LimiterMaximizer::LimiterMaximizer() {
     resetMetering();
 }
 
 void LimiterMaximizer::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
-    samplesPerBlock_ = samplesPerBlock;
+    samplesPerBlock_ = juce::jmax(1, samplesPerBlock);
+    
+    // Interpolador: factor 1 sin ISP (solo retardo, mismo alineamiento)
+    const int factor = settings_.ispDetection ? static_cast<int>(settings_.oversampling) : 1;
+    const auto quality = settings_.ispDetection ? settings_.quality : TruePeakQuality::Realtime;
+    
+    const int maxWindow = juce::jmax(1, static_cast<int>(maxLookAheadMs * 0.001 * sampleRate));
+    const int window = juce::jlimit(1, maxWindow, static_cast<int>(settings_.lookAhead * 0.001 * sampleRate));
+    gainComputer_.prepare(maxWindow);
+    gainComputer_.setWindow(window);
     
-    // Preparar look-ahead buffers
-    const int lookAheadSamples = static_cast<int>(settings_.lookAhead * 0.001 * sampleRate);
-    lookAheadBuffers_.resize(2);  // Estéreo
-    for (auto& buffer : lookAheadBuffers_) {
-        buffer.prepare(lookAheadSamples);
+    channels_.resize(maxChannels_);
+    for (auto& channel : channels_) {
+        channel.inputDetector.prepare(factor, quality);
+        channel.outputDetector.prepare(juce::jmax(4, factor), settings_.quality);
     }
     
-    // Calcular coeficiente de release
-    const float releaseTime = settings_.release * 0.001f;
-    releaseCoeff_ = std::exp(-1.0f / (static_cast<float>(sampleRate) * releaseTime));
+    latency_ = channels_[0].inputDetector.getLatency() + gainComputer_.getLatency();
+    
+    // Soft clip a frecuencia alta, antes de la detección: retrasa igual audio
+    // y detector, así que su latencia solo se suma a la reportada
+    clipOversampled_ = settings_.softClip;
+    clipOversampler_.prepare(maxChannels_, samplesPerBlock_, settings_.softClipOversampling,
+                             settings_.quality == TruePeakQuality::Offline);
+    clipLatency_ = clipOversampled_ ? clipOversampler_.getLatencySamples() : 0;
+    for (auto& channel : channels_)
+        channel.delayLine.assign(static_cast<size_t>(latency_ + samplesPerBlock_), 0.0f);
     
+    peaks_.assign(static_cast<size_t>(samplesPerBlock_), 0.0f);
+    gains_.assign(static_cast<size_t>(samplesPerBlock_), 1.0f);
+    lufsMeter_.prepare(sampleRate, maxChannels_, false);
+    
+    setRelease(settings_.release);
     reset();
 }
 
 void LimiterMaximizer::reset() {
-    for (auto& buffer : lookAheadBuffers_) {
-        buffer.reset();
+    clipOversampler_.reset();
+    for (auto& channel : channels_) {
+        channel.inputDetector.reset();
+        channel.outputDetector.reset();
+        std::fill(channel.delayLine.begin(), channel.delayLine.end(), 0.0f);
     }
-    envelopeFollower_ = 0.0f;
+    gainComputer_.reset();
     resetMetering();
 }
 
 void LimiterMaximizer::process(juce::AudioBuffer<float>& buffer) {
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(channels_.size()));
     const int numSamples = buffer.getNumSamples();
+    if (numChannels == 0 || numSamples == 0)
+        return;
     
     // Input gain
-    if (settings_.inputGain != 0.0f) {
-        const float inputGainLinear = std::pow(10.0f, settings_.inputGain / 20.0f);
-        buffer.applyGain(inputGainLinear);
-    }
+    if (settings_.inputGain != 0.0f)
+        buffer.applyGain(juce::Decibels::decibelsToGain(settings_.inputGain));
     
     // Auto gain (maximizar al ceiling)
     if (settings_.autoGain) {
-        // Analizar nivel actual
-        float currentPeak = buffer.getMagnitude(0, numSamples);
+        const float currentPeak = buffer.getMagnitude(0, numSamples);
         if (currentPeak > 0.00001f) {
-            const float currentDb = 20.0f * std::log10(currentPeak);
             const float targetDb = settings_.ceiling - 0.5f; // Dejar headroom
-            const float autoGainDb = targetDb - currentDb;
-            const float autoGainLinear = std::pow(10.0f, autoGainDb / 20.0f);
-            buffer.applyGain(autoGainLinear);
+            buffer.applyGain(juce::Decibels::decibelsToGain(targetDb) / currentPeak);
         }
     }
     
-    // Look-ahead processing
-    const float ceilingLinear = std::pow(10.0f, settings_.ceiling / 20.0f);
-    const float thresholdLinear = std::pow(10.0f, settings_.threshold / 20.0f);
+    if (settings_.meteringEnabled)
+        metering_.inputPeak = std::max(metering_.inputPeak, buffer.getMagnitude(0, numSamples));
     
-    for (int i = 0; i < numSamples; ++i) {
-        // Analizar peak de todos los canales
-        float peakSample = 0.0f;
-        for (int ch = 0; ch < numChannels; ++ch) {
-            const float sample = buffer.getSample(ch, i);
-            peakSample = std::max(peakSample, std::abs(sample));
-        }
-        
-        // Calcular gain reduction necesaria
-        float targetGain = 1.0f;
-        if (peakSample > thresholdLinear) {
-            targetGain = ceilingLinear / peakSample;
-        }
-        
-        // Envelope follower (solo ataque instantáneo, release suave)
-        if (targetGain < envelopeFollower_) {
-            envelopeFollower_ = targetGain;
-        } else {
-            envelopeFollower_ = releaseCoeff_ * envelopeFollower_ + (1.0f - releaseCoeff_) * targetGain;
-        }
-        
-        // Aplicar limiting
-        float gain = envelopeFollower_;
-        gain = std::min(gain, 1.0f);
-        
-        for (int ch = 0; ch < numChannels; ++ch) {
-            float sample = buffer.getSample(ch, i);
-            
-            // Soft clip (opcional)
-            if (settings_.softClip) {
-                const float threshold = 0.8f;
-                if (std::abs(sample) > threshold) {
-                    sample = threshold + (sample - threshold * (sample > 0 ? 1 : -1)) * 
-                             settings_.softClipAmount;
-                }
-            }
-            
-            // Aplicar gain
-            sample *= gain;
-            
-            // Hard ceiling (brickwall)
-            sample = juce::jlimit(-ceilingLinear, ceilingLinear, sample);
-            
-            buffer.setSample(ch, i, sample);
-            
-            // Metering
-            if (settings_.meteringEnabled) {
-                metering_.inputPeak = std::max(metering_.inputPeak, std::abs(buffer.getSample(ch, i)));
-                metering_.outputPeak = std::max(metering_.outputPeak, std::abs(sample));
-                
-                if (std::abs(sample) >= ceilingLinear * 0.99f) {
-                    metering_.clippedSamples++;
-                }
-            }
-        }
-        
-        // Calcular gain reduction
-        const float grDb = 20.0f * std::log10(std::max(gain, 0.00001f));
-        metering_.gainReduction = std::min(metering_.gainReduction, grDb);
+    // Bloques del tamaño preparado: el scratch nunca se redimensiona
+    float* channelPointers[maxChannels_] = {};
+    for (int offset = 0; offset < numSamples; offset += samplesPerBlock_) {
+        const int chunk = juce::jmin(samplesPerBlock_, numSamples - offset);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channelPointers[ch] = buffer.getWritePointer(ch, offset);
+        processChunk(channelPointers, numChannels, chunk);
     }
     
-    // Update metering
+    // Update metering (log10 una vez por bloque)
     if (settings_.meteringEnabled) {
-        // True peak (simplificado sin oversampling por ahora)
-        metering_.truePeak = 20.0f * std::log10(std::max(metering_.outputPeak, 0.00001f));
-        
-        // RMS
         float rmsSum = 0.0f;
-        for (int ch = 0; ch < numChannels; ++ch) {
+        for (int ch = 0; ch < numChannels; ++ch)
             rmsSum += buffer.getRMSLevel(ch, 0, numSamples);
-        }
-        metering_.rms = 20.0f * std::log10(std::max(rmsSum / numChannels, 0.00001f));
+        metering_.rms = juce::Decibels::gainToDecibels(rmsSum / numChannels, -100.0f);
         
         // Crest factor
-        const float peakDb = 20.0f * std::log10(std::max(metering_.outputPeak, 0.00001f));
+        const float peakDb = juce::Decibels::gainToDecibels(metering_.outputPeak, -100.0f);
         metering_.crestFactor = peakDb - metering_.rms;
+        
+        // Loudness de la salida (BS.1770)
+        lufsMeter_.process(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+        metering_.lufsMomentary = lufsMeter_.getMomentary();
+        metering_.lufsShortTerm = lufsMeter_.getShortTerm();
+        metering_.lufsIntegrated = lufsMeter_.getIntegrated();
     }
     
     totalSamplesProcessed_ += numSamples;
 }
 
+void LimiterMaximizer::processChunk(float* const* channels, int numChannels, int numSamples) {
+    const float ceilingLinear = juce::Decibels::decibelsToGain(settings_.ceiling);
+    const float thresholdLinear = juce::Decibels::decibelsToGain(settings_.threshold);
+    const float targetLinear = settings_.ispDetection
+        ? ceilingLinear * juce::Decibels::decibelsToGain(truePeakMarginDb)
+        : ceilingLinear;
+    
+    float* peaks = peaks_.data();
+    float* gains = gains_.data();
+    
+    // Soft clip (opcional) antes de la detección. Si estaba activo en prepare()
+    // el oversampler corre siempre (latencia constante); activado después,
+    // funciona a la frecuencia base hasta el siguiente prepare()
+    const bool clip = settings_.softClip;
+    const float clipAmount = settings_.softClipAmount;
+    if (clipOversampled_) {
+        clipOversampler_.process(channels, numChannels, numSamples,
+            [this, clip, clipAmount](float* const* data, int channelCount, int count) {
+                if (!clip)
+                    return;
+                for (int ch = 0; ch < channelCount; ++ch)
+                    for (int i = 0; i < count; ++i)
+                        data[ch][i] = softClip(data[ch][i], clipAmount);
+            });
+    } else if (clip) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                channels[ch][i] = softClip(channels[ch][i], clipAmount);
+    }
+    
+    // 1. Pico (true peak) enlazado entre canales
+    juce::FloatVectorOperations::clear(peaks, numSamples);
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels_[static_cast<size_t>(ch)].inputDetector.processMax(channels[ch], peaks, numSamples);
+    
+    // 2. Curva de gain: hold O(1) + release + suavizado de la ventana look-ahead
+    const float minGain = gainComputer_.process(peaks, gains, numSamples, thresholdLinear, targetLinear);
+    
+    // 3. Retardo + gain + brickwall, vectorizado
+    for (int ch = 0; ch < numChannels; ++ch) {
+        auto& state = channels_[static_cast<size_t>(ch)];
+        float* delay = state.delayLine.data();
+        
+        juce::FloatVectorOperations::copy(delay + latency_, channels[ch], numSamples);
+        juce::FloatVectorOperations::multiply(channels[ch], delay, gains, numSamples);
+        juce::FloatVectorOperations::clip(channels[ch], channels[ch], -ceilingLinear, ceilingLinear, numSamples);
+        std::memmove(delay, delay + numSamples, sizeof(float) * static_cast<size_t>(latency_));
+    }
+    
+    // Metering
+    if (settings_.meteringEnabled) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch], numSamples);
+            metering_.outputPeak = std::max(metering_.outputPeak, std::max(-range.getStart(), range.getEnd()));
+        }
+        
+        // True peak de salida (reutiliza peaks, ya consumido por el gain)
+        juce::FloatVectorOperations::clear(peaks, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels_[static_cast<size_t>(ch)].outputDetector.processMax(channels[ch], peaks, numSamples);
+        const float truePeak = juce::FloatVectorOperations::findMaximum(peaks, numSamples);
+        metering_.truePeak = std::max(metering_.truePeak, juce::Decibels::gainToDecibels(truePeak, -100.0f));
+        
+        metering_.gainReduction = std::min(metering_.gainReduction, juce::Decibels::gainToDecibels(minGain, -100.0f));
+        if (minGain < 1.0f) {
+            for (int i = 0; i < numSamples; ++i)
+                metering_.clippedSamples += gains[i] < 1.0f ? 1 : 0;
+        }
+    }
+}
+
 //==============================================================================
 void LimiterMaximizer::setSettings(const Settings& settings) {
     settings_ = settings;
     
     // Recalcular coeficientes
-    const float releaseTime = settings_.release * 0.001f;
-    releaseCoeff_ = std::exp(-1.0f / (static_cast<float>(sampleRate_) * releaseTime));
+    setRelease(settings_.release);
 }
 
 void LimiterMaximizer::setCeiling(float ceilingDb) {
@@ -200,6 +215,7 @@ void LimiterMaximizer::setRelease(float releaseMs) {
     settings_.release = juce::jlimit(10.0f, 1000.0f, releaseMs);
     const float releaseTime = settings_.release * 0.001f;
     releaseCoeff_ = std::exp(-1.0f / (static_cast<float>(sampleRate_) * releaseTime));
+    gainComputer_.setRelease(releaseCoeff_);
 }
 
 void LimiterMaximizer::setLookAhead(float lookAheadMs) {
@@ -214,6 +230,19 @@ void LimiterMaximizer::setInputGain(float gainDb) {
     settings_.inputGain = juce::jlimit(-24.0f, 24.0f, gainDb);
 }
 
+void LimiterMaximizer::setOversampling(OversamplingFactor factor) {
+    settings_.oversampling = factor;
+}
+
+void LimiterMaximizer::setQuality(TruePeakQuality quality) {
+    settings_.quality = quality;
+}
+
+void LimiterMaximizer::setDithering(DitheringType type, int bitDepth) {
+    settings_.dithering = type;
+    settings_.bitDepth = bitDepth;
+}
+
 void LimiterMaximizer::setSoftClip(bool enabled, float amount) {
     settings_.softClip = enabled;
     settings_.softClipAmount = juce::jlimit(0.0f, 1.0f, amount);
@@ -226,6 +255,10 @@ LimiterMaximizer::MeteringData LimiterMaximizer::getCurrentMetering() const {
 
 void LimiterMaximizer::resetMetering() {
     metering_ = MeteringData();
+    metering_.truePeak = -100.0f;
+    metering_.lufsMomentary = metering_.lufsShortTerm = metering_.lufsIntegrated
+        = omega::Analysis::LoudnessMeter::kMinimumLoudness;
+    lufsMeter_.reset();
     totalSamplesProcessed_ = 0;
 }
 
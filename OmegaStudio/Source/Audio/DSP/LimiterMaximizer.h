@@ -6,6 +6,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "TruePeakDetector.h"
+#include "Oversampler.h"
+#include "../Analysis/LoudnessMeter.h"
 #include <vector>
 #include <algorithm>
 
@@ -14,9 +17,10 @@ namespace OmegaStudio {
 //==============================================================================
 /** Limitador/Maximizer Profesional con Look-Ahead
  *  - True Peak limiting (brickwall)
- *  - Look-ahead buffer para prevención de distorsión
- *  - ISP (Inter-Sample Peak) detection
- *  - Oversampling 2x/4x/8x
+ *  - Look-ahead con ventana deslizante O(1) por sample
+ *  - ISP (Inter-Sample Peak) detection: interpolador polifásico BS.1770
+ *  - Oversampling 2x/4x/8x, calidad Realtime / Offline
+ *  - Soft clip oversampled (factor según la calidad) para no generar aliasing
  *  - Dithering para reducir cuantización
  *  - Ceiling ajustable (-20 dB a 0 dB)
  *  - Auto-gain para maximizar loudness
@@ -50,6 +54,7 @@ public:
         // ISP Detection
         bool ispDetection = true;       // Inter-Sample Peak detection
         OversamplingFactor oversampling = OversamplingFactor::x4;
+        TruePeakQuality quality = TruePeakQuality::Realtime;
         
         // Auto Gain
         bool autoGain = false;          // Maximizar al ceiling automáticamente
@@ -65,6 +70,7 @@ public:
         // Soft Clip
         bool softClip = false;          // Soft clipping antes del ceiling
         float softClipAmount = 0.5f;    // 0.0 - 1.0
+        Oversampler::Settings softClipOversampling;     // Factor Realtime / Offline según quality
     };
     
     //==========================================================================
@@ -78,6 +84,9 @@ public:
     // Processing
     void process(juce::AudioBuffer<float>& buffer);
     
+    // Retardo total (look-ahead + interpolador + soft clip), para compensación de latencia
+    int getLatencySamples() const { return latency_ + clipLatency_; }
+    
     // Settings
     void setSettings(const Settings& settings);
     Settings& getSettings() { return settings_; }
@@ -90,9 +99,10 @@ public:
     void setLookAhead(float lookAheadMs);
     void setAutoGain(bool enabled);
     void setInputGain(float gainDb);
-    void setOversampling(OversamplingFactor factor);
+    void setOversampling(OversamplingFactor factor);     // Look-ahead, oversampling y calidad
+    void setQuality(TruePeakQuality quality);            // se aplican en prepare()
     void setDithering(DitheringType type, int bitDepth);
-    void setSoftClip(bool enabled, float amount);
+    void setSoftClip(bool enabled, float amount);        // Oversampling del clip: en prepare()
     
     // Metering
     struct MeteringData {
@@ -116,70 +126,6 @@ public:
     juce::StringArray getPresetList() const;
     
 private:
-    //==========================================================================
-    // Look-ahead delay line
-    class LookAheadBuffer {
-    public:
-        void prepare(int maxSamples);
-        void write(float sample);
-        float read() const;
-        void advance();
-        void reset();
-        
-    private:
-        std::vector<float> buffer_;
-        int writePos_ = 0;
-        int readPos_ = 0;
-        int delay_ = 0;
-    };
-    
-    //==========================================================================
-    // True Peak detector (con oversampling)
-    class TruePeakDetector {
-    public:
-        void prepare(double sampleRate, OversamplingFactor factor);
-        float detectTruePeak(const float* buffer, int numSamples);
-        void reset();
-        
-    private:
-        juce::dsp::Oversampling<float> oversampler_{1, 2, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR};
-        double sampleRate_ = 48000.0;
-        OversamplingFactor factor_ = OversamplingFactor::x4;
-    };
-    
-    //==========================================================================
-    // LUFS Meter (EBU R128)
-    class LUFSMeter {
-    public:
-        void prepare(double sampleRate);
-        void process(const juce::AudioBuffer<float>& buffer);
-        float getMomentary() const { return momentaryLUFS_; }
-        float getShortTerm() const { return shortTermLUFS_; }
-        float getIntegrated() const { return integratedLUFS_; }
-        void reset();
-        
-    private:
-        double sampleRate_ = 48000.0;
-        
-        // K-weighting filters
-        juce::dsp::IIR::Filter<float> preFilter_;
-        juce::dsp::IIR::Filter<float> highShelfFilter_;
-        
-        // Buffers para windows
-        std::vector<float> momentaryWindow_;  // 400 ms
-        std::vector<float> shortTermWindow_;  // 3 s
-        std::vector<float> integratedBuffer_; // Todo el track
-        
-        float momentaryLUFS_ = -70.0f;
-        float shortTermLUFS_ = -70.0f;
-        float integratedLUFS_ = -70.0f;
-        
-        int windowPos_ = 0;
-        
-        void updateLUFS();
-        float calculateLoudness(const std::vector<float>& samples);
-    };
-    
     //==========================================================================
     // Dithering
     class Ditherer {
@@ -207,18 +153,29 @@ private:
     double sampleRate_ = 48000.0;
     int samplesPerBlock_ = 512;
     
-    // Look-ahead buffers (uno por canal)
-    std::vector<LookAheadBuffer> lookAheadBuffers_;
+    // Por canal: detector de entrada, detector de salida (metering) y línea de retardo lineal
+    struct ChannelState {
+        TruePeakDetector inputDetector;
+        TruePeakDetector outputDetector;
+        std::vector<float> delayLine;   // latency_ samples de historia + un bloque
+    };
     
-    // Envelope follower para gain reduction
-    float envelopeFollower_ = 0.0f;
+    static constexpr int maxChannels_ = 2;
+    std::vector<ChannelState> channels_;
+    
+    // Curva de gain común a todos los canales (stereo link)
+    LookAheadGainComputer gainComputer_;
     float releaseCoeff_ = 0.0f;
+    int latency_ = 0;
+    
+    // Scratch de un bloque (sin allocs en process)
+    std::vector<float> peaks_;
+    std::vector<float> gains_;
     
-    // True peak detection
-    TruePeakDetector truePeakDetector_;
+    void processChunk(float* const* channels, int numChannels, int numSamples);
     
-    // LUFS metering
-    LUFSMeter lufsMeter_;
+    // LUFS metering (EBU R128), salida del limitador; el true peak ya lo miden los outputDetector
+    omega::Analysis::LoudnessMeter lufsMeter_;
     
     // Dithering
     Ditherer ditherer_;
@@ -227,11 +184,11 @@ private:
     MeteringData metering_;
     int totalSamplesProcessed_ = 0;
     
-    // Soft clipping
+    // Soft clipping (oversampled si estaba activo en prepare())
     float softClip(float sample, float amount);
-    
-    // Gain calculation
-    float calculateGainReduction(float peakLevel);
+    Oversampler clipOversampler_;
+    bool clipOversampled_ = false;
+    int clipLatency_ = 0;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LimiterMaximizer)
 };
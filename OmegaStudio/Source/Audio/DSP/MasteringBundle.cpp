@@ -24,50 +24,47 @@ void TransientDesigner::initialize(double sampleRate, int maxBlockSize) {
 }
 
 void TransientDesigner::process(float* buffer, int numSamples) {
-    // Detect envelope
+    const int maxBlock = m_envelopeBuffer.getNumSamples();
+    if (buffer == nullptr || maxBlock == 0)
+        return;
+    
+    // Speed maps to per-sample smoothing factors; the follower takes pole coefficients
+    const float attack = 0.001f + m_speed * 0.01f;
+    const float release = 0.01f + (1.0f - m_speed) * 0.1f;
+    m_follower.setCoefficients(1.0f - attack, 1.0f - release);
+    
+    // Attack / sustain gains once per block, not per sample
+    const float attackGain = OmegaStudio::Dynamics::decibelsToGain(m_attack);
+    const float sustainGain = OmegaStudio::Dynamics::decibelsToGain(m_sustain);
+    const float clipThreshold = 1.0f - m_clip;
+    
     float* envelope = m_envelopeBuffer.getWritePointer(0);
     
-    for (int i = 0; i < numSamples; ++i) {
-        float input = std::abs(buffer[i]);
+    for (int offset = 0; offset < numSamples; offset += maxBlock) {
+        const int chunk = juce::jmin(maxBlock, numSamples - offset);
+        float* data = buffer + offset;
         
-        // Simple envelope follower
-        float attack = 0.001f + m_speed * 0.01f;
-        float release = 0.01f + (1.0f - m_speed) * 0.1f;
-        
-        float coeff = (input > m_lastEnvelope) ? attack : release;
-        m_lastEnvelope += coeff * (input - m_lastEnvelope);
-        envelope[i] = m_lastEnvelope;
-    }
-    
-    // Apply attack/sustain shaping
-    for (int i = 0; i < numSamples; ++i) {
-        float env = envelope[i];
-        float delta = (i > 0) ? env - envelope[i-1] : 0.0f;
+        // Detect envelope
+        juce::FloatVectorOperations::abs(envelope, data, chunk);
+        m_follower.process(envelope, envelope, chunk);
         
         // Transient detection (positive derivative = attack)
-        bool isTransient = delta > 0.001f;
-        
-        float gain = 1.0f;
-        
-        if (isTransient) {
-            // Attack phase
-            gain *= juce::Decibels::decibelsToGain(m_attack);
-        } else {
-            // Sustain phase
-            gain *= juce::Decibels::decibelsToGain(m_sustain);
+        float previous = m_lastEnvelope;
+        for (int i = 0; i < chunk; ++i) {
+            const float delta = envelope[i] - previous;
+            previous = envelope[i];
+            data[i] *= delta > 0.001f ? attackGain : sustainGain;
         }
-        
-        buffer[i] *= gain;
+        m_lastEnvelope = previous;
         
         // Apply clipping
-        if (m_clip > 0.0f) {
-            float threshold = 1.0f - m_clip;
-            buffer[i] = juce::jlimit(-threshold, threshold, buffer[i]);
-        }
+        if (m_clip > 0.0f)
+            juce::FloatVectorOperations::clip(data, data, -clipThreshold, clipThreshold, chunk);
     }
 }
 
 void TransientDesigner::reset() {
+    m_follower.reset();
     m_lastEnvelope = 0.0f;
     m_envelopeBuffer.clear();
 }
@@ -287,20 +284,25 @@ AdvancedMetering::AdvancedMetering() {
     m_peakHistoryR.resize(kHistorySize, 0.0f);
     m_rmsHistoryL.resize(kHistorySize, 0.0f);
     m_rmsHistoryR.resize(kHistorySize, 0.0f);
+    initialize(m_sampleRate);
 }
 
 void AdvancedMetering::initialize(double sampleRate) {
     m_sampleRate = sampleRate;
+    m_loudness.prepare(sampleRate, 2);
 }
 
 void AdvancedMetering::process(const juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
     
+    // LUFS and true peak (same pass)
+    calculateLUFS(buffer);
+    
     if (buffer.getNumChannels() >= 1) {
         const float* left = buffer.getReadPointer(0);
         m_data.peakLeft = buffer.getMagnitude(0, 0, numSamples);
         calculateRMS(left, numSamples, m_data.rmsLeft);
-        calculateTruePeak(left, numSamples, m_data.truePeakLeft);
+        calculateTruePeak(0, m_data.truePeakLeft);
         
         // Add to history
         m_peakHistoryL.erase(m_peakHistoryL.begin());
@@ -313,7 +315,7 @@ void AdvancedMetering::process(const juce::AudioBuffer<float>& buffer) {
         const float* right = buffer.getReadPointer(1);
         m_data.peakRight = buffer.getMagnitude(1, 0, numSamples);
         calculateRMS(right, numSamples, m_data.rmsRight);
-        calculateTruePeak(right, numSamples, m_data.truePeakRight);
+        calculateTruePeak(1, m_data.truePeakRight);
         
         m_peakHistoryR.erase(m_peakHistoryR.begin());
         m_peakHistoryR.push_back(m_data.peakRight);
@@ -321,9 +323,6 @@ void AdvancedMetering::process(const juce::AudioBuffer<float>& buffer) {
         m_rmsHistoryR.push_back(m_data.rmsRight);
     }
     
-    // Calculate LUFS
-    calculateLUFS(buffer);
-    
     // Calculate dynamic range
     calculateDynamicRange();
     
@@ -337,6 +336,7 @@ void AdvancedMetering::reset() {
     std::fill(m_peakHistoryR.begin(), m_peakHistoryR.end(), 0.0f);
     std::fill(m_rmsHistoryL.begin(), m_rmsHistoryL.end(), 0.0f);
     std::fill(m_rmsHistoryR.begin(), m_rmsHistoryR.end(), 0.0f);
+    m_loudness.reset();
 }
 
 void AdvancedMetering::calculateRMS(const float* buffer, int numSamples, float& rms) {
@@ -347,19 +347,17 @@ void AdvancedMetering::calculateRMS(const float* buffer, int numSamples, float&
     rms = std::sqrt(static_cast<float>(sum / numSamples));
 }
 
-void AdvancedMetering::calculateTruePeak(const float* buffer, int numSamples, float& truePeak) {
-    // Simplified - production would use 4x oversampling
-    truePeak = 0.0f;
-    for (int i = 0; i < numSamples; ++i) {
-        truePeak = juce::jmax(truePeak, std::abs(buffer[i]));
-    }
+void AdvancedMetering::calculateTruePeak(int channel, float& truePeak) {
+    // 4x polyphase interpolation, held since reset() (linear)
+    truePeak = juce::Decibels::decibelsToGain(m_loudness.getTruePeak(channel), Analysis::LoudnessMeter::kMinimumPeak);
 }
 
 void AdvancedMetering::calculateLUFS(const juce::AudioBuffer<float>& buffer) {
-    // Simplified LUFS calculation (ITU-R BS.1770)
-    // Production implementation would need K-weighting filter
-    float rms = buffer.getRMSLevel(0, 0, buffer.getNumSamples());
-    m_data.lufsMomentary = -0.691f + 10.0f * std::log10(rms * rms + 0.0001f);
+    // ITU-R BS.1770: K-weighted, 400 ms / 3 s windows, gated integrated
+    m_loudness.process(buffer);
+    m_data.lufsMomentary = m_loudness.getMomentary();
+    m_data.lufsShortTerm = m_loudness.getShortTerm();
+    m_data.lufsIntegrated = m_loudness.getIntegrated();
 }
 
 void AdvancedMetering::calculateDynamicRange() {
@@ -10,6 +10,8 @@
 #include <JuceHeader.h>
 #include <array>
 #include "../../Utils/Constants.h"
+#include "DynamicsCore.h"
+#include "../Analysis/LoudnessMeter.h"
 
 namespace omega {
 
@@ -90,7 +92,8 @@ private:
     float m_clip { 0.0f };
     
     juce::AudioBuffer<float> m_envelopeBuffer;
-    float m_lastEnvelope { 0.0f };
+    OmegaStudio::Dynamics::EnvelopeFollower m_follower;
+    float m_lastEnvelope { 0.0f };      // For the derivative across blocks
     double m_sampleRate { 48000.0 };
 };
 
@@ -235,7 +238,7 @@ public:
     
 private:
     void calculateRMS(const float* buffer, int numSamples, float& rms);
-    void calculateTruePeak(const float* buffer, int numSamples, float& truePeak);
+    void calculateTruePeak(int channel, float& truePeak);
     void calculateLUFS(const juce::AudioBuffer<float>& buffer);
     void calculateDynamicRange();
     
@@ -246,6 +249,8 @@ private:
     
     static constexpr int kHistorySize = 100;
     double m_sampleRate { 48000.0 };
+    
+    Analysis::LoudnessMeter m_loudness;     // LUFS + true peak (4x), held since reset()
 };
 
 } // namespace omega
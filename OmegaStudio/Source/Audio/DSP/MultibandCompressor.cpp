@@ -3,200 +3,164 @@
 //==============================================================================
 
 #include "MultibandCompressor.h"
+#include "SIMDProcessor.h"
 #include <cmath>
 
 namespace OmegaStudio {
 
-//==============================================================================
-// LinkwitzRileyCrossover Implementation
-//==============================================================================
+namespace {
 
-void MultibandCompressor::LinkwitzRileyCrossover::prepare(double sampleRate) {
-    sampleRate_ = sampleRate;
-    updateCoefficients();
-    reset();
-}
+using Omega::Audio::DSP::Vec4;
 
-void MultibandCompressor::LinkwitzRileyCrossover::setCrossoverFrequency(float frequency) {
-    frequency_ = juce::jlimit(20.0f, 20000.0f, frequency);
-    updateCoefficients();
-}
-
-void MultibandCompressor::LinkwitzRileyCrossover::updateCoefficients() {
-    // Butterworth 2nd order lowpass/highpass
-    const float omega = juce::MathConstants<float>::twoPi * frequency_ / static_cast<float>(sampleRate_);
-    const float sinOmega = std::sin(omega);
-    const float cosOmega = std::cos(omega);
-    const float alpha = sinOmega / (2.0f * 0.7071f); // Q = 0.7071 (Butterworth)
-    
-    // Lowpass
-    const float b0_lp = (1.0f - cosOmega) / 2.0f;
-    const float b1_lp = 1.0f - cosOmega;
-    const float b2_lp = (1.0f - cosOmega) / 2.0f;
-    const float a0_lp = 1.0f + alpha;
-    const float a1_lp = -2.0f * cosOmega;
-    const float a2_lp = 1.0f - alpha;
-    
-    coeffsLow_[0] = b0_lp / a0_lp;
-    coeffsLow_[1] = b1_lp / a0_lp;
-    coeffsLow_[2] = b2_lp / a0_lp;
-    coeffsLow_[3] = a1_lp / a0_lp;
-    
-    // Highpass
-    const float b0_hp = (1.0f + cosOmega) / 2.0f;
-    const float b1_hp = -(1.0f + cosOmega);
-    const float b2_hp = (1.0f + cosOmega) / 2.0f;
-    const float a0_hp = 1.0f + alpha;
-    const float a1_hp = -2.0f * cosOmega;
-    const float a2_hp = 1.0f - alpha;
-    
-    coeffsHigh_[0] = b0_hp / a0_hp;
-    coeffsHigh_[1] = b1_hp / a0_hp;
-    coeffsHigh_[2] = b2_hp / a0_hp;
-    coeffsHigh_[3] = a1_hp / a0_hp;
-}
-
-void MultibandCompressor::LinkwitzRileyCrossover::process(const float* input, 
-                                                            float* lowOut, 
-                                                            float* highOut, 
-                                                            int numSamples) {
-    for (int i = 0; i < numSamples; ++i) {
-        const float sample = input[i];
-        
-        // Lowpass (2 passes para LR4)
-        float low = sample;
-        for (int pass = 0; pass < 2; ++pass) {
-            const float output = coeffsLow_[0] * low + stateLow_[pass * 2];
-            stateLow_[pass * 2] = coeffsLow_[1] * low - coeffsLow_[3] * output + stateLow_[pass * 2 + 1];
-            stateLow_[pass * 2 + 1] = coeffsLow_[2] * low - coeffsLow_[3] * output;
-            low = output;
-        }
-        lowOut[i] = low;
-        
-        // Highpass (2 passes para LR4)
-        float high = sample;
-        for (int pass = 0; pass < 2; ++pass) {
-            const float output = coeffsHigh_[0] * high + stateHigh_[pass * 2];
-            stateHigh_[pass * 2] = coeffsHigh_[1] * high - coeffsHigh_[3] * output + stateHigh_[pass * 2 + 1];
-            stateHigh_[pass * 2 + 1] = coeffsHigh_[2] * high - coeffsHigh_[3] * output;
-            high = output;
-        }
-        highOut[i] = high;
+// Biquad TDF-II de 4 lanes con el estado en registros durante el bloque
+struct Section {
+    Vec4 b0, b1, b2, a1, a2, s1, s2;
+    
+    template <typename Coeffs>
+    static Section load(const Coeffs& c) {
+        return { Vec4::load(c.b0), Vec4::load(c.b1), Vec4::load(c.b2), Vec4::load(c.a1), Vec4::load(c.a2),
+                 Vec4::load(c.s1), Vec4::load(c.s2) };
     }
-}
+    
+    template <typename Coeffs>
+    void storeState(Coeffs& c) const { s1.store(c.s1); s2.store(c.s2); }
+    
+    Vec4 process(Vec4 x) {
+        const Vec4 y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        return y;
+    }
+};
+
+// Coeficientes normalizados { b0, b1, b2, a1, a2 } (Q = 1/sqrt(2))
+enum class Response { Lowpass, Highpass, Allpass };
 
-void MultibandCompressor::LinkwitzRileyCrossover::reset() {
-    std::fill(stateLow_.begin(), stateLow_.end(), 0.0f);
-    std::fill(stateHigh_.begin(), stateHigh_.end(), 0.0f);
+std::array<float, 5> butterworth(Response response, float frequency, double sampleRate) {
+    const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    const double cosOmega = std::cos(omega);
+    const double alpha = std::sin(omega) / (2.0 * 0.70710678118654752);
+    const double a0 = 1.0 + alpha;
+    
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    switch (response) {
+        case Response::Lowpass:  b0 = (1.0 - cosOmega) * 0.5; b1 = 1.0 - cosOmega;    b2 = b0; break;
+        case Response::Highpass: b0 = (1.0 + cosOmega) * 0.5; b1 = -(1.0 + cosOmega); b2 = b0; break;
+        case Response::Allpass:  b0 = 1.0 - alpha;            b1 = -2.0 * cosOmega;   b2 = 1.0 + alpha; break;
+    }
+    
+    return { static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+             static_cast<float>(-2.0 * cosOmega / a0), static_cast<float>((1.0 - alpha) / a0) };
+}
+
+template <typename Coeffs>
+void setLanes(Coeffs& section, int firstLane, int numLanes, const std::array<float, 5>& c) {
+    for (int lane = firstLane; lane < firstLane + numLanes; ++lane) {
+        section.b0[lane] = c[0];
+        section.b1[lane] = c[1];
+        section.b2[lane] = c[2];
+        section.a1[lane] = c[3];
+        section.a2[lane] = c[4];
+    }
 }
 
+} // namespace
+
 //==============================================================================
-// BandCompressor Implementation
+// LinkwitzRileyBank Implementation
 //==============================================================================
 
-void MultibandCompressor::BandCompressor::prepare(double sampleRate) {
+void MultibandCompressor::LinkwitzRileyBank::prepare(double sampleRate) {
     sampleRate_ = sampleRate;
-    updateCoefficients();
+    for (int i = 0; i < 3; ++i)
+        updateCoefficients(i);
     reset();
 }
 
-void MultibandCompressor::BandCompressor::setParameters(const BandSettings::Band& params) {
-    params_ = params;
-    updateCoefficients();
-}
-
-void MultibandCompressor::BandCompressor::updateCoefficients() {
-    // Attack coefficient
-    const float attackTime = params_.attack * 0.001f; // ms to seconds
-    attackCoeff_ = std::exp(-1.0f / (static_cast<float>(sampleRate_) * attackTime));
+void MultibandCompressor::LinkwitzRileyBank::setCrossoverFrequency(int index, float frequency) {
+    if (index < 0 || index >= 3)
+        return;
     
-    // Release coefficient
-    const float releaseTime = params_.release * 0.001f;
-    releaseCoeff_ = std::exp(-1.0f / (static_cast<float>(sampleRate_) * releaseTime));
+    frequencies_[static_cast<size_t>(index)] = juce::jlimit(20.0f, 20000.0f, frequency);
+    updateCoefficients(index);
 }
 
-void MultibandCompressor::BandCompressor::process(float* buffer, int numSamples) {
-    if (!params_.enabled) return;
+void MultibandCompressor::LinkwitzRileyBank::updateCoefficients(int index) {
+    const float frequency = juce::jmin(frequencies_[static_cast<size_t>(index)], static_cast<float>(sampleRate_ * 0.45));
+    const auto lowpass = butterworth(Response::Lowpass, frequency, sampleRate_);
+    const auto highpass = butterworth(Response::Highpass, frequency, sampleRate_);
+    
+    // LR4 = dos Butterworth de 2º orden en cascada
+    for (auto& section : crossovers_[static_cast<size_t>(index)]) {
+        setLanes(section, 0, 2, lowpass);
+        setLanes(section, 2, 2, highpass);
+    }
+    
+    // LP4 + HP4 = allpass de 2º orden en la misma frecuencia
+    const auto allpass = butterworth(Response::Allpass, frequency, sampleRate_);
+    if (index == 1)
+        setLanes(allpassLow_, 0, 4, allpass);
+    else if (index == 2)
+        setLanes(allpassLowMid_, 0, 4, allpass);
+}
+
+void MultibandCompressor::LinkwitzRileyBank::reset() {
+    auto clearState = [](Biquad4& section) {
+        std::fill(std::begin(section.s1), std::end(section.s1), 0.0f);
+        std::fill(std::begin(section.s2), std::end(section.s2), 0.0f);
+    };
+    
+    for (auto& crossover : crossovers_)
+        for (auto& section : crossover)
+            clearState(section);
+    clearState(allpassLow_);
+    clearState(allpassLowMid_);
+}
+
+void MultibandCompressor::LinkwitzRileyBank::split(const float* left, const float* right,
+                                                   float* const* bandLeft, float* const* bandRight,
+                                                   int numSamples) {
+    Section low1 = Section::load(crossovers_[0][0]), low2 = Section::load(crossovers_[0][1]);
+    Section mid1 = Section::load(crossovers_[1][0]), mid2 = Section::load(crossovers_[1][1]);
+    Section high1 = Section::load(crossovers_[2][0]), high2 = Section::load(crossovers_[2][1]);
+    Section allpassLow = Section::load(allpassLow_);
+    Section allpassLowMid = Section::load(allpassLowMid_);
+    
+    alignas(16) float lanes[4];
     
     for (int i = 0; i < numSamples; ++i) {
-        const float input = buffer[i];
+        const Vec4 input = Vec4::set(left[i], right[i], left[i], right[i]);
         
-        // Detección de nivel
-        float level = 0.0f;
-        if (params_.detectionMode == DetectionMode::Peak) {
-            level = std::abs(input);
-        } else { // RMS
-            level = input * input;
-        }
+        // { banda 0 L, R, resto L, R } -> { banda 1, resto } -> { banda 2, banda 3 }
+        const Vec4 split1 = low2.process(low1.process(input));
+        const Vec4 split2 = mid2.process(mid1.process(Vec4::highHalf(split1)));
+        const Vec4 split3 = high2.process(high1.process(Vec4::highHalf(split2)));
         
-        // Envelope follower
-        if (level > envelopeFollower_) {
-            envelopeFollower_ = attackCoeff_ * (envelopeFollower_ - level) + level;
-        } else {
-            envelopeFollower_ = releaseCoeff_ * (envelopeFollower_ - level) + level;
-        }
+        // Compensación de fase: banda 0 por el allpass 2 (lanes 2-3 sin uso), luego 0 y 1 por el allpass 3
+        const Vec4 band0 = allpassLow.process(split1);
+        const Vec4 lowBands = allpassLowMid.process(Vec4::lowHalves(band0, split2));
         
-        // Convertir a dB
-        float envelopeDb = 0.0f;
-        if (params_.detectionMode == DetectionMode::RMS) {
-            envelopeDb = 10.0f * std::log10(std::max(envelopeFollower_, 0.00001f));
-        } else {
-            envelopeDb = 20.0f * std::log10(std::max(envelopeFollower_, 0.00001f));
-        }
-        
-        // Calcular ganancia de compresión
-        float gain = computeGain(envelopeDb);
-        
-        // Aplicar ganancia
-        float output = input * gain;
-        
-        // Makeup gain
-        float makeupGain = params_.makeupGain;
-        if (params_.autoMakeup) {
-            // Auto-makeup: compensar la reducción promedio
-            makeupGain = (params_.threshold - envelopeDb) * (1.0f - 1.0f / params_.ratio) * 0.5f;
-            makeupGain = juce::jlimit(0.0f, 24.0f, makeupGain);
-        }
-        
-        output *= std::pow(10.0f, makeupGain / 20.0f);
-        
-        buffer[i] = output;
+        lowBands.store(lanes);
+        bandLeft[0][i] = lanes[0];
+        bandRight[0][i] = lanes[1];
+        bandLeft[1][i] = lanes[2];
+        bandRight[1][i] = lanes[3];
         
-        // Metering
-        inputLevel_ = std::max(inputLevel_ * 0.99f, std::abs(input));
-        outputLevel_ = std::max(outputLevel_ * 0.99f, std::abs(output));
-        gainReduction_ = 20.0f * std::log10(std::max(gain, 0.00001f));
-    }
-}
-
-float MultibandCompressor::BandCompressor::computeGain(float inputLevelDb) {
-    const float threshold = params_.threshold;
-    const float ratio = params_.ratio;
-    const float knee = params_.knee;
-    
-    float gainDb = 0.0f;
-    
-    if (inputLevelDb < (threshold - knee / 2.0f)) {
-        // Por debajo del knee: sin compresión
-        gainDb = 0.0f;
-    } else if (inputLevelDb > (threshold + knee / 2.0f)) {
-        // Por encima del knee: compresión completa
-        gainDb = (threshold - inputLevelDb) + (inputLevelDb - threshold) / ratio;
-    } else {
-        // Dentro del knee: transición suave
-        const float x = inputLevelDb - threshold + knee / 2.0f;
-        gainDb = -x * x / (2.0f * knee);
+        split3.store(lanes);
+        bandLeft[2][i] = lanes[0];
+        bandRight[2][i] = lanes[1];
+        bandLeft[3][i] = lanes[2];
+        bandRight[3][i] = lanes[3];
     }
     
-    // Convertir de dB a linear
-    return std::pow(10.0f, gainDb / 20.0f);
-}
-
-void MultibandCompressor::BandCompressor::reset() {
-    envelopeFollower_ = 0.0f;
-    gainReduction_ = 0.0f;
-    inputLevel_ = 0.0f;
-    outputLevel_ = 0.0f;
+    low1.storeState(crossovers_[0][0]);
+    low2.storeState(crossovers_[0][1]);
+    mid1.storeState(crossovers_[1][0]);
+    mid2.storeState(crossovers_[1][1]);
+    high1.storeState(crossovers_[2][0]);
+    high2.storeState(crossovers_[2][1]);
+    allpassLow.storeState(allpassLow_);
+    allpassLowMid.storeState(allpassLowMid_);
 }
 
 //==============================================================================
@@ -223,128 +187,141 @@ MultibandCompressor::MultibandCompressor() {
 
 void MultibandCompressor::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
-    samplesPerBlock_ = samplesPerBlock;
+    samplesPerBlock_ = juce::jmax(1, samplesPerBlock);
     
     // Preparar crossovers
-    crossovers_[0].prepare(sampleRate);
-    crossovers_[0].setCrossoverFrequency(settings_.crossoverLow);
-    
-    crossovers_[1].prepare(sampleRate);
-    crossovers_[1].setCrossoverFrequency(settings_.crossoverMid);
+    crossoverBank_.prepare(sampleRate);
+    crossoverBank_.setCrossoverFrequency(0, settings_.crossoverLow);
+    crossoverBank_.setCrossoverFrequency(1, settings_.crossoverMid);
+    crossoverBank_.setCrossoverFrequency(2, settings_.crossoverHigh);
     
-    crossovers_[2].prepare(sampleRate);
-    crossovers_[2].setCrossoverFrequency(settings_.crossoverHigh);
-    
-    // Preparar compresores
-    for (int i = 0; i < 4; ++i) {
-        compressors_[i].prepare(sampleRate);
-        compressors_[i].setParameters(settings_.bands[i]);
-        
-        // Alocar buffers de banda
-        bandBuffers_[i].setSize(2, samplesPerBlock);
+    // Preparar compresores y alocar buffers de banda (nunca en process)
+    for (int i = 0; i < numBands_; ++i) {
+        updateBandCoefficients(i);
+        bandBuffers_[i].setSize(maxChannels_, samplesPerBlock_);
     }
+    detectorBuffer_.setSize(numBands_, samplesPerBlock_);
+    gainBuffer_.setSize(numBands_, samplesPerBlock_);
     
     reset();
 }
 
 void MultibandCompressor::reset() {
-    for (auto& crossover : crossovers_) {
-        crossover.reset();
-    }
-    
-    for (auto& compressor : compressors_) {
-        compressor.reset();
-    }
+    crossoverBank_.reset();
     
     for (auto& buffer : bandBuffers_) {
         buffer.clear();
     }
     
+    envelopes_.reset();
     std::fill(bandInputLevels_.begin(), bandInputLevels_.end(), 0.0f);
     std::fill(bandOutputLevels_.begin(), bandOutputLevels_.end(), 0.0f);
+    for (auto& band : settings_.bands)
+        band.gainReduction = 0.0f;
+}
+
+void MultibandCompressor::updateBandCoefficients(int bandIndex) {
+    const auto& band = settings_.bands[static_cast<size_t>(bandIndex)];
+    envelopes_.setTimes(bandIndex, sampleRate_, band.attack, band.release);
+    
+    auto& detector = detectors_[static_cast<size_t>(bandIndex)];
+    const auto mode = band.detectionMode == DetectionMode::Peak ? Dynamics::DetectorMode::Peak
+                                                                : Dynamics::DetectorMode::RMS;
+    if (detector.getMode() != mode)
+        detector.prepare(mode, maxChannels_);
 }
 
 void MultibandCompressor::process(juce::AudioBuffer<float>& buffer) {
-    const int numChannels = buffer.getNumChannels();
+    // Canales a partir del tercero pasan sin procesar (la detección es estéreo enlazada)
+    const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels_);
     const int numSamples = buffer.getNumSamples();
+    if (numChannels == 0 || numSamples == 0 || bandBuffers_[0].getNumSamples() == 0)
+        return;
     
-    // Procesar cada canal
-    for (int ch = 0; ch < numChannels; ++ch) {
-        float* channelData = buffer.getWritePointer(ch);
-        
-        // Buffers temporales
-        std::vector<float> tempBuffers[4];
-        for (int i = 0; i < 4; ++i) {
-            tempBuffers[i].resize(numSamples);
-        }
-        
-        // Crossover 1: Separar Low (band 0) de Rest (bands 1-3)
-        std::vector<float> lowBand(numSamples);
-        std::vector<float> restBand1(numSamples);
-        crossovers_[0].process(channelData, lowBand.data(), restBand1.data(), numSamples);
-        
-        // Crossover 2: Separar LowMid (band 1) de Rest (bands 2-3)
-        std::vector<float> lowMidBand(numSamples);
-        std::vector<float> restBand2(numSamples);
-        crossovers_[1].process(restBand1.data(), lowMidBand.data(), restBand2.data(), numSamples);
-        
-        // Crossover 3: Separar MidHigh (band 2) de High (band 3)
-        std::vector<float> midHighBand(numSamples);
-        std::vector<float> highBand(numSamples);
-        crossovers_[2].process(restBand2.data(), midHighBand.data(), highBand.data(), numSamples);
-        
-        // Copiar a tempBuffers
-        std::copy(lowBand.begin(), lowBand.end(), tempBuffers[0].begin());
-        std::copy(lowMidBand.begin(), lowMidBand.end(), tempBuffers[1].begin());
-        std::copy(midHighBand.begin(), midHighBand.end(), tempBuffers[2].begin());
-        std::copy(highBand.begin(), highBand.end(), tempBuffers[3].begin());
+    float* channelPointers[maxChannels_] = {};
+    for (int offset = 0; offset < numSamples; offset += samplesPerBlock_) {
+        const int chunk = juce::jmin(samplesPerBlock_, numSamples - offset);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channelPointers[ch] = buffer.getWritePointer(ch, offset);
+        processChunk(channelPointers, numChannels, chunk);
+    }
+}
+
+void MultibandCompressor::processChunk(float* const* channels, int numChannels, int numSamples) {
+    const bool stereo = numChannels > 1;
+    
+    // 1. Crossovers: las 4 bandas de L y R en una sola pasada
+    float* bandLeft[numBands_];
+    float* bandRight[numBands_];
+    for (int b = 0; b < numBands_; ++b) {
+        bandLeft[b] = bandBuffers_[b].getWritePointer(0);
+        bandRight[b] = bandBuffers_[b].getWritePointer(1);
+    }
+    crossoverBank_.split(channels[0], stereo ? channels[1] : channels[0], bandLeft, bandRight, numSamples);
+    
+    // 2. Detector enlazado por banda (pico o potencia media), vectorizado sobre el bloque
+    for (int b = 0; b < numBands_; ++b) {
+        const float* bandChannels[2] = { bandLeft[b], bandRight[b] };
+        detectors_[static_cast<size_t>(b)].process(bandChannels, maxChannels_, detectorBuffer_.getWritePointer(b), numSamples);
+    }
+    
+    // 3. Envolventes: una banda por lane (ataque / release según el lane)
+    envelopes_.process(detectorBuffer_.getArrayOfReadPointers(), gainBuffer_.getArrayOfWritePointers(), numSamples);
+    
+    // 4. Curva de gain (tabla con el knee) y vuelta a lineal, in-place sobre la envolvente
+    bool anySolo = false;
+    for (const auto& band : settings_.bands)
+        anySolo = anySolo || band.solo;
+    
+    const float decay = std::pow(0.99f, static_cast<float>(numSamples));
+    
+    for (int b = 0; b < numBands_; ++b) {
+        auto& band = settings_.bands[static_cast<size_t>(b)];
+        float* gain = gainBuffer_.getWritePointer(b);
         
-        // Comprimir cada banda
-        bool anySolo = false;
-        for (int i = 0; i < 4; ++i) {
-            if (settings_.bands[i].solo) {
-                anySolo = true;
-                break;
-            }
-        }
+        // Metering de entrada (máximo con caída, una vez por bloque)
+        const float inputPeak = juce::jmax(juce::FloatVectorOperations::findMaximum(detectorBuffer_.getReadPointer(b), numSamples), 0.0f);
+        bandInputLevels_[static_cast<size_t>(b)] = std::max(bandInputLevels_[static_cast<size_t>(b)] * decay,
+            band.detectionMode == DetectionMode::Peak ? inputPeak : std::sqrt(2.0f * inputPeak));
         
-        for (int i = 0; i < 4; ++i) {
-            // Metering de entrada
-            for (int s = 0; s < numSamples; ++s) {
-                bandInputLevels_[i] = std::max(bandInputLevels_[i] * 0.99f, 
-                                                std::abs(tempBuffers[i][s]));
-            }
-            
-            // Aplicar solo/mute
-            if (anySolo && !settings_.bands[i].solo) {
-                std::fill(tempBuffers[i].begin(), tempBuffers[i].end(), 0.0f);
-                continue;
-            }
-            
-            if (settings_.bands[i].mute) {
-                std::fill(tempBuffers[i].begin(), tempBuffers[i].end(), 0.0f);
-                continue;
-            }
-            
-            // Comprimir
-            compressors_[i].setParameters(settings_.bands[i]);
-            compressors_[i].process(tempBuffers[i].data(), numSamples);
+        const bool silenced = band.mute || (anySolo && !band.solo);
+        if (silenced || !band.enabled) {
+            juce::FloatVectorOperations::fill(gain, silenced ? 0.0f : 1.0f, numSamples);
+            band.gainReduction = 0.0f;
+        } else {
+            Dynamics::GainCurve::Parameters curve;
+            curve.threshold = band.threshold;
+            curve.ratio = band.ratio;
+            curve.knee = band.knee;
             
-            // Metering de salida
-            for (int s = 0; s < numSamples; ++s) {
-                bandOutputLevels_[i] = std::max(bandOutputLevels_[i] * 0.99f, 
-                                                 std::abs(tempBuffers[i][s]));
-            }
+            // Auto-makeup estático: la mitad de la reducción a 0 dBFS
+            curve.makeup = band.autoMakeup ? Dynamics::GainCurve::autoMakeup(curve) : band.makeupGain;
             
-            // Guardar gain reduction
-            settings_.bands[i].gainReduction = compressors_[i].getGainReduction();
+            auto& gainCurve = gainCurves_[static_cast<size_t>(b)];
+            gainCurve.setParameters(curve);
+            gainCurve.process(gain, gain, numSamples, band.detectionMode == DetectionMode::RMS);
+            band.gainReduction = Dynamics::gainToDecibels(gain[numSamples - 1]) - curve.makeup;
         }
+    }
+    
+    // 5. Suma de bandas con su gain (las bandas ya están en fase)
+    for (int ch = 0; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::clear(channels[ch], numSamples);
+    
+    for (int b = 0; b < numBands_; ++b) {
+        const float* gain = gainBuffer_.getReadPointer(b);
+        float outputPeak = 0.0f;
         
-        // Mezclar bandas de vuelta
-        for (int i = 0; i < numSamples; ++i) {
-            channelData[i] = tempBuffers[0][i] + tempBuffers[1][i] + 
-                              tempBuffers[2][i] + tempBuffers[3][i];
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* band = bandBuffers_[b].getWritePointer(ch);
+            juce::FloatVectorOperations::multiply(band, gain, numSamples);
+            juce::FloatVectorOperations::add(channels[ch], band, numSamples);
+            
+            const auto range = juce::FloatVectorOperations::findMinAndMax(band, numSamples);
+            outputPeak = std::max(outputPeak, std::max(-range.getStart(), range.getEnd()));
         }
+        
+        bandOutputLevels_[static_cast<size_t>(b)] = std::max(bandOutputLevels_[static_cast<size_t>(b)] * decay, outputPeak);
     }
 }
 
@@ -353,13 +330,13 @@ void MultibandCompressor::setSettings(const BandSettings& settings) {
     settings_ = settings;
     
     // Actualizar crossovers
-    crossovers_[0].setCrossoverFrequency(settings_.crossoverLow);
-    crossovers_[1].setCrossoverFrequency(settings_.crossoverMid);
-    crossovers_[2].setCrossoverFrequency(settings_.crossoverHigh);
+    crossoverBank_.setCrossoverFrequency(0, settings_.crossoverLow);
+    crossoverBank_.setCrossoverFrequency(1, settings_.crossoverMid);
+    crossoverBank_.setCrossoverFrequency(2, settings_.crossoverHigh);
     
     // Actualizar compresores
     for (int i = 0; i < 4; ++i) {
-        compressors_[i].setParameters(settings_.bands[i]);
+        updateBandCoefficients(i);
     }
 }
 
@@ -385,14 +362,14 @@ void MultibandCompressor::setBandRatio(int bandIndex, float ratio) {
 void MultibandCompressor::setBandAttack(int bandIndex, float attackMs) {
     if (bandIndex >= 0 && bandIndex < 4) {
         settings_.bands[bandIndex].attack = juce::jlimit(0.1f, 100.0f, attackMs);
-        compressors_[bandIndex].setParameters(settings_.bands[bandIndex]);
+        updateBandCoefficients(bandIndex);
     }
 }
 
 void MultibandCompressor::setBandRelease(int bandIndex, float releaseMs) {
     if (bandIndex >= 0 && bandIndex < 4) {
         settings_.bands[bandIndex].release = juce::jlimit(10.0f, 1000.0f, releaseMs);
-        compressors_[bandIndex].setParameters(settings_.bands[bandIndex]);
+        updateBandCoefficients(bandIndex);
     }
 }
 
@@ -417,23 +394,24 @@ void MultibandCompressor::setBandAutoMakeup(int bandIndex, bool autoMakeup) {
 void MultibandCompressor::setBandDetectionMode(int bandIndex, DetectionMode mode) {
     if (bandIndex >= 0 && bandIndex < 4) {
         settings_.bands[bandIndex].detectionMode = mode;
+        updateBandCoefficients(bandIndex);
     }
 }
 
 //==============================================================================
 void MultibandCompressor::setCrossoverLow(float frequency) {
     settings_.crossoverLow = juce::jlimit(20.0f, 1000.0f, frequency);
-    crossovers_[0].setCrossoverFrequency(settings_.crossoverLow);
+    crossoverBank_.setCrossoverFrequency(0, settings_.crossoverLow);
 }
 
 void MultibandCompressor::setCrossoverMid(float frequency) {
     settings_.crossoverMid = juce::jlimit(200.0f, 5000.0f, frequency);
-    crossovers_[1].setCrossoverFrequency(settings_.crossoverMid);
+    crossoverBank_.setCrossoverFrequency(1, settings_.crossoverMid);
 }
 
 void MultibandCompressor::setCrossoverHigh(float frequency) {
     settings_.crossoverHigh = juce::jlimit(2000.0f, 16000.0f, frequency);
-    crossovers_[2].setCrossoverFrequency(settings_.crossoverHigh);
+    crossoverBank_.setCrossoverFrequency(2, settings_.crossoverHigh);
 }
 
 //==============================================================================
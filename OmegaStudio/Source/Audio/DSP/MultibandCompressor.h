@@ -6,13 +6,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DynamicsCore.h"
 #include <array>
 
 namespace OmegaStudio {
 
 //==============================================================================
 /** Compresor Multibanda Profesional de 4 Bandas
- *  - 4 bandas independientes con crossovers Linkwitz-Riley
+ *  - 4 bandas independientes con crossovers Linkwitz-Riley (suma en fase)
+ *  - Detección enlazada L/R por banda, sin allocs en el hilo de audio
  *  - Controles completos por banda: threshold, ratio, attack, release, gain
  *  - Detección RMS o Peak
  *  - Knee ajustable
@@ -116,71 +118,58 @@ public:
     
 private:
     //==========================================================================
-    // Crossover Filter (Linkwitz-Riley 4th order)
-    class LinkwitzRileyCrossover {
+    // Banco de crossovers Linkwitz-Riley (LR4) para 4 bandas
+    // - Cada crossover procesa LP y HP de L y R a la vez: 4 lanes SIMD
+    // - La banda grave pasa por los allpass de los crossovers superiores y la
+    //   media-grave por el último, así la suma de bandas queda en fase (allpass plano)
+    class LinkwitzRileyBank {
     public:
         void prepare(double sampleRate);
-        void setCrossoverFrequency(float frequency);
-        void process(const float* input, float* lowOut, float* highOut, int numSamples);
+        void setCrossoverFrequency(int index, float frequency);
         void reset();
         
-    private:
-        double sampleRate_ = 48000.0;
-        float frequency_ = 1000.0f;
-        
-        // Butterworth 2nd order (cascaded for LR4)
-        std::array<float, 4> coeffsLow_{};
-        std::array<float, 4> coeffsHigh_{};
-        std::array<float, 4> stateLow_{};
-        std::array<float, 4> stateHigh_{};
-        
-        void updateCoefficients();
-    };
-    
-    //==========================================================================
-    // Single Band Compressor
-    class BandCompressor {
-    public:
-        void prepare(double sampleRate);
-        void setParameters(const BandSettings::Band& params);
-        void process(float* buffer, int numSamples);
-        void reset();
-        
-        float getGainReduction() const { return gainReduction_; }
-        float getInputLevel() const { return inputLevel_; }
-        float getOutputLevel() const { return outputLevel_; }
+        // bandLeft/bandRight: 4 buffers planar por canal (mono: right == left)
+        void split(const float* left, const float* right,
+                   float* const* bandLeft, float* const* bandRight, int numSamples);
         
     private:
-        double sampleRate_ = 48000.0;
-        BandSettings::Band params_;
+        struct Biquad4 {
+            float b0[4] {}, b1[4] {}, b2[4] {}, a1[4] {}, a2[4] {};
+            float s1[4] {}, s2[4] {};
+        };
         
-        // Envelope followers
-        float envelopeFollower_ = 0.0f;
-        float gainReduction_ = 0.0f;
-        float inputLevel_ = 0.0f;
-        float outputLevel_ = 0.0f;
+        double sampleRate_ = 48000.0;
+        std::array<float, 3> frequencies_ { 120.0f, 1000.0f, 8000.0f };
         
-        // Coefficients
-        float attackCoeff_ = 0.0f;
-        float releaseCoeff_ = 0.0f;
+        std::array<std::array<Biquad4, 2>, 3> crossovers_;   // lanes { LP L, LP R, HP L, HP R }
+        Biquad4 allpassLow_;                                 // Crossover 2 sobre la banda 0
+        Biquad4 allpassLowMid_;                              // Crossover 3 sobre las bandas 0 y 1
         
-        void updateCoefficients();
-        float computeGain(float inputLevel);
+        void updateCoefficients(int index);
     };
     
     //==========================================================================
+    // Compresión por banda: envolventes de las 4 bandas en 4 lanes, gain en dB vectorizado
+    void updateBandCoefficients(int bandIndex);
+    void processChunk(float* const* channels, int numChannels, int numSamples);
+    
+    static constexpr int numBands_ = 4;
+    static constexpr int maxChannels_ = 2;
+    
     BandSettings settings_;
     double sampleRate_ = 48000.0;
     int samplesPerBlock_ = 512;
     
-    // Crossovers (3 crossovers para 4 bandas)
-    std::array<LinkwitzRileyCrossover, 3> crossovers_;
+    LinkwitzRileyBank crossoverBank_;
     
-    // Compressors (uno por banda)
-    std::array<BandCompressor, 4> compressors_;
+    std::array<Dynamics::LevelDetector, 4> detectors_;
+    std::array<Dynamics::GainCurve, 4> gainCurves_;
+    Dynamics::EnvelopeFollower4 envelopes_;
     
-    // Buffers temporales para bandas
+    // Buffers preasignados en prepare(): bandas (L, R), detector y gain por banda
     juce::AudioBuffer<float> bandBuffers_[4];
+    juce::AudioBuffer<float> detectorBuffer_;
+    juce::AudioBuffer<float> gainBuffer_;
     
     // Análisis
     std::array<float, 4> bandInputLevels_{};
@@ -0,0 +1,288 @@
+/**
+ * @file OnsetDetector.cpp
+ * @brief Implementation of the shared onset detector
+ */
+
+#include "OnsetDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace omega {
+
+namespace {
+
+constexpr float kFluxCompression = 1000.0f;     // log(1 + C * magnitude)
+constexpr float kMinimumFlux = 1.0e-3f;         // Below this nothing is an onset (silence, dither)
+constexpr float kAttackLevel = 0.1f;            // Of the rise above the background
+constexpr int kQuietSearchBlocks = 4;           // Blocks before the attack searched for the background
+constexpr int kMonoChunkSize = 4096;
+
+// Upper band edges in Hz; the last band runs up to Nyquist
+constexpr std::array<float, OnsetDetector::kNumBands - 1> kBandEdgesHz = { 150.0f, 400.0f, 1000.0f, 2500.0f, 6000.0f };
+
+} // namespace
+
+//==============================================================================
+// OnsetList
+//==============================================================================
+
+std::vector<Onset> OnsetList::select(float minStrength, double minSpacing) const {
+    std::vector<Onset> selected;
+
+    for (const auto& onset : onsets) {
+        if (getStrength(onset) < minStrength)
+            continue;
+
+        if (!selected.empty() && onset.position - selected.back().position < minSpacing) {
+            if (onset.flux > selected.back().flux)
+                selected.back() = onset;
+            continue;
+        }
+
+        selected.push_back(onset);
+    }
+
+    return selected;
+}
+
+//==============================================================================
+// OnsetDetector Implementation
+//==============================================================================
+
+OnsetDetector::OnsetDetector() = default;
+OnsetDetector::~OnsetDetector() = default;
+
+void OnsetDetector::initialize(double sampleRate) {
+    initialize(sampleRate, Settings());
+}
+
+void OnsetDetector::initialize(double sampleRate, const Settings& settings) {
+    m_settings = settings;
+    m_sampleRate = sampleRate;
+
+    const int order = juce::jlimit(6, 15, (int) std::round(std::log2((double) juce::jmax(64, settings.fftSize))));
+    m_fftSize = 1 << order;
+    m_hopSize = juce::jlimit(kBlockSize, m_fftSize, juce::nextPowerOfTwo(juce::jmax(kBlockSize, settings.hopSize)));
+    m_settings.fftSize = m_fftSize;
+    m_settings.hopSize = m_hopSize;
+    m_settings.peakRadius = juce::jmax(1, settings.peakRadius);
+
+    m_fft = std::make_unique<juce::dsp::FFT>(order);
+
+    // Normalized JUCE Hann (window sum = size)
+    m_window.resize((size_t) m_fftSize);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(m_window.data(), (size_t) m_fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, true);
+    m_fftBuffer.assign((size_t) m_fftSize * 2, 0.0f);
+
+    const int bins = m_fftSize / 2;
+    m_compressed.assign((size_t) bins, 0.0f);
+    m_previousCompressed.assign((size_t) bins, 0.0f);
+
+    // Every band keeps at least one bin, DC excluded
+    const double binWidth = sampleRate / m_fftSize;
+    m_bandEdges[0] = 1;
+    for (int b = 1; b < kNumBands; ++b) {
+        const int edge = (int) std::round(kBandEdgesHz[(size_t) b - 1] / binWidth);
+        m_bandEdges[(size_t) b] = juce::jlimit(m_bandEdges[(size_t) b - 1] + 1, bins - (kNumBands - b), edge);
+    }
+    m_bandEdges[kNumBands] = bins;
+
+    // The attack search looks back as far as the worst-case latency
+    m_historySize = juce::jmax(m_fftSize, getLatencySamples());
+    m_history.assign((size_t) m_historySize, 0.0f);
+
+    m_meanFrames = juce::jmax(m_settings.peakRadius,
+                              juce::jmax(4, juce::roundToInt(settings.meanWindowSeconds * sampleRate / m_hopSize)));
+    m_flux.assign((size_t) (m_meanFrames + m_settings.peakRadius + 1), 0.0f);
+    m_band.assign(m_flux.size(), 0);
+
+    reset();
+}
+
+void OnsetDetector::reset() {
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    std::fill(m_previousCompressed.begin(), m_previousCompressed.end(), 0.0f);
+    std::fill(m_flux.begin(), m_flux.end(), 0.0f);
+    std::fill(m_band.begin(), m_band.end(), 0);
+    m_hopFill = 0;
+    m_maxFlux = 0.0f;
+    m_numFrames = 0;
+    m_numSamples = 0;
+}
+
+// Log-compressed spectral flux, averaged per band and summed over the bands
+float OnsetDetector::analyseHop() {
+    float* data = m_fftBuffer.data();
+    juce::FloatVectorOperations::multiply(data, m_history.data() + (m_historySize - m_fftSize), m_window.data(), m_fftSize);
+    juce::FloatVectorOperations::clear(data + m_fftSize, m_fftSize);
+    m_fft->performFrequencyOnlyForwardTransform(data);
+
+    // Full-scale sine = magnitude 1
+    const float normalization = 2.0f / (float) m_fftSize;
+    float flux = 0.0f;
+    float strongest = 0.0f;
+    int dominantBand = 0;
+
+    for (int b = 0; b < kNumBands; ++b) {
+        const int first = m_bandEdges[(size_t) b];
+        const int last = m_bandEdges[(size_t) b + 1];
+
+        float sum = 0.0f;
+        for (int k = first; k < last; ++k) {
+            const float compressed = std::log1p(kFluxCompression * data[k] * normalization);
+            sum += juce::jmax(0.0f, compressed - m_previousCompressed[(size_t) k]);
+            m_compressed[(size_t) k] = compressed;
+        }
+
+        const float bandFlux = sum / (float) (last - first);
+        flux += bandFlux;
+        if (bandFlux > strongest) {
+            strongest = bandFlux;
+            dominantBand = b;
+        }
+    }
+    std::swap(m_compressed, m_previousCompressed);
+
+    m_flux[ringIndex(m_numFrames)] = flux;
+    m_band[ringIndex(m_numFrames)] = dominantBand;
+    m_maxFlux = juce::jmax(m_maxFlux, flux);
+    ++m_numFrames;
+    return flux;
+}
+
+void OnsetDetector::advance() {
+    std::copy(m_history.begin() + m_hopSize, m_history.end(), m_history.begin());
+    m_hopFill = 0;
+}
+
+// Local maximum over +-peakRadius hops, above the floor and the moving mean
+bool OnsetDetector::isOnset(juce::int64 frame, juce::int64 lastFrame) const {
+    const float value = m_flux[ringIndex(frame)];
+    if (value < juce::jmax(kMinimumFlux, m_settings.relativeFloor * m_maxFlux))
+        return false;
+
+    const int radius = m_settings.peakRadius;
+    const juce::int64 peakEnd = juce::jmin(lastFrame, frame + radius);
+    for (juce::int64 j = juce::jmax((juce::int64) 0, frame - radius); j <= peakEnd; ++j) {
+        const float other = m_flux[ringIndex(j)];
+        if (j < frame ? other >= value : other > value)
+            return false;
+    }
+
+    const juce::int64 first = juce::jmax((juce::int64) 0, frame - m_meanFrames);
+    float mean = 0.0f;
+    for (juce::int64 j = first; j <= peakEnd; ++j)
+        mean += m_flux[ringIndex(j)];
+    mean /= (float) (peakEnd - first + 1);
+
+    return value > m_settings.threshold * mean;
+}
+
+float OnsetDetector::sampleAt(juce::int64 position) const {
+    // While deciding, the history ends at the end of the newest frame
+    const juce::int64 index = position - (m_numFrames * m_hopSize - m_historySize);
+    return index >= 0 && index < m_historySize ? m_history[(size_t) index] : 0.0f;
+}
+
+// The flux peaks once most of the attack is in the frame, up to a couple of
+// hops late: the attack block is the biggest energy jump in those hops. The
+// onset starts after the quietest block just before it, where the level
+// first rises out of that block's background. Bright onsets are located on
+// the first difference, so a decaying bass note underneath doesn't mask them
+double OnsetDetector::locateAttack(juce::int64 frame, int band) const {
+    const bool bright = band >= 2;
+    auto level = [this, bright](juce::int64 position) {
+        return std::abs(bright ? sampleAt(position) - sampleAt(position - 1) : sampleAt(position));
+    };
+    auto blockEnergy = [&level](juce::int64 block) {
+        float sum = 0.0f;
+        for (int i = 0; i < kBlockSize; ++i) {
+            const float x = level(block * kBlockSize + i);
+            sum += x * x;
+        }
+        return sum;
+    };
+    auto peakLevel = [&level](juce::int64 start, juce::int64 end) {
+        float peak = 0.0f;
+        for (juce::int64 i = start; i < end; ++i)
+            peak = juce::jmax(peak, level(i));
+        return peak;
+    };
+
+    const int blocksPerHop = m_hopSize / kBlockSize;
+    const juce::int64 first = juce::jmax((juce::int64) 1, (frame - 2) * blocksPerHop);
+    const juce::int64 last = (frame + 1) * blocksPerHop - 1;
+
+    juce::int64 attack = juce::jmax((juce::int64) 0, frame * blocksPerHop);
+    float biggestJump = 0.0f;
+    float previous = blockEnergy(first - 1);
+    for (juce::int64 b = first; b <= last; ++b) {
+        const float energy = blockEnergy(b);
+        if (energy - previous > biggestJump) {
+            biggestJump = energy - previous;
+            attack = b;
+        }
+        previous = energy;
+    }
+
+    juce::int64 quiet = attack - 1;
+    float quietEnergy = blockEnergy(quiet);
+    for (juce::int64 b = attack - 2; b >= juce::jmax((juce::int64) -1, attack - kQuietSearchBlocks); --b) {
+        const float energy = blockEnergy(b);
+        if (energy < quietEnergy) {
+            quietEnergy = energy;
+            quiet = b;
+        }
+    }
+
+    const juce::int64 start = (quiet + 1) * kBlockSize;
+    const juce::int64 end = (attack + 1) * kBlockSize;
+    const float background = peakLevel(start - kBlockSize, start);
+    const float peak = peakLevel(start, end);
+    if (peak <= 2.0f * background)
+        return (double) juce::jmax((juce::int64) 0, start);
+
+    const float threshold = background + kAttackLevel * (peak - background);
+    juce::int64 crossing = start;
+    while (crossing < end && level(crossing) < threshold)
+        ++crossing;
+
+    // Down the rise to where it leaves the background, then between samples
+    while (crossing > start - kBlockSize && level(crossing - 1) < level(crossing) && level(crossing - 1) > background)
+        --crossing;
+
+    const float current = level(crossing);
+    const float before = level(crossing - 1);
+    const float fraction = current > before ? juce::jlimit(0.0f, 1.0f, (current - background) / (current - before)) : 0.0f;
+    return juce::jmax(0.0, (double) crossing - fraction);
+}
+
+void OnsetDetector::detect(const juce::AudioBuffer<float>& buffer, OnsetList& result) {
+    result.clear();
+    if (m_fft == nullptr)
+        return;
+
+    reset();
+    auto onOnset = [&result](const Onset& onset) { result.onsets.push_back(onset); };
+
+    const int numChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels > 0) {
+        float mono[kMonoChunkSize];
+        const float channelGain = 1.0f / (float) numChannels;
+
+        for (int offset = 0; offset < numSamples; offset += kMonoChunkSize) {
+            const int count = juce::jmin(kMonoChunkSize, numSamples - offset);
+            juce::FloatVectorOperations::copyWithMultiply(mono, buffer.getReadPointer(0, offset), channelGain, count);
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(mono, buffer.getReadPointer(ch, offset), channelGain, count);
+            push(mono, count, onOnset);
+        }
+    }
+
+    finish(onOnset);
+    result.maxFlux = m_maxFlux;
+}
+
+} // namespace omega
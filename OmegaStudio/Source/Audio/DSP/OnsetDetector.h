@@ -0,0 +1,222 @@
+/**
+ * @file OnsetDetector.h
+ * @brief Shared streaming onset detector (multi-band spectral flux)
+ *
+ * One onset module for every transient consumer (AudioFeatureStore and through
+ * it SampleSlicer, TempoDetector and AudioToMidi; SliceToMIDI, GrooveEngine,
+ * TempoKeyDetector):
+ * - One pass, one FFT plan and every buffer allocated in initialize()
+ * - Log-compressed spectral flux averaged per band, so a kick and a hi-hat
+ *   weigh the same however many bins they cover
+ * - Adaptive threshold: a local maximum over a few hops that clears the
+ *   moving mean and a floor relative to the strongest flux so far
+ * - Each detection is placed on the attack with sub-sample precision
+ * - Streaming (push/finish, fixed latency) and offline (detect) modes run
+ *   the same code, so slice points agree everywhere
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace omega {
+
+/**
+ * @struct Onset
+ * @brief One detected onset
+ */
+struct Onset {
+    double position = 0.0;      // Samples from the start of the stream, at or just before the attack
+    float flux = 0.0f;          // Detection function value (scale-free, compare within a stream)
+    int band = 0;               // Band that contributed most (0 = lowest)
+
+    juce::int64 getSample() const noexcept { return (juce::int64) std::floor(position); }
+};
+
+/**
+ * @struct OnsetList
+ * @brief Offline result, reusable across files (clear() keeps the storage)
+ */
+struct OnsetList {
+    std::vector<Onset> onsets;  // Ascending
+    float maxFlux = 0.0f;       // Largest flux of the whole stream
+
+    void clear() noexcept { onsets.clear(); maxFlux = 0.0f; }
+
+    /** Flux relative to the strongest of the stream, 0-1 */
+    float getStrength(const Onset& onset) const noexcept {
+        return maxFlux > 0.0f ? onset.flux / maxFlux : 0.0f;
+    }
+
+    /**
+     * Onsets at least minStrength strong and minSpacing samples apart
+     * (a stronger onset wins over a weaker one too close before it)
+     */
+    std::vector<Onset> select(float minStrength, double minSpacing = 0.0) const;
+};
+
+/**
+ * @class OnsetDetector
+ * @brief Streaming spectral flux onset detector
+ *
+ * Frame i holds the samples up to (i + 1) * hop. A frame is decided once
+ * peakRadius more hops have arrived; its attack may lie up to two hops
+ * earlier, so an onset is reported at most getLatencySamples() after it
+ * happened. RT-safe after initialize().
+ */
+class OnsetDetector {
+public:
+    static constexpr int kNumBands = 6;
+
+    struct Settings {
+        int fftSize = 2048;                 // Power of 2
+        int hopSize = 512;                  // Power of 2, multiple of 64, at most fftSize
+        int peakRadius = 3;                 // Hops on each side of a peak
+        float threshold = 1.5f;             // Peak over the local mean
+        float relativeFloor = 0.02f;        // Of the largest flux so far
+        double meanWindowSeconds = 0.1;     // Moving mean before the peak
+    };
+
+    OnsetDetector();
+    ~OnsetDetector();
+
+    /** Allocate for a sample rate and settings */
+    void initialize(double sampleRate, const Settings& settings);
+    void initialize(double sampleRate);
+
+    /** Start a new stream (keeps the allocations) */
+    void reset();
+
+    /**
+     * Feed mono samples (RT-safe)
+     * @param onOnset Called as onOnset(const Onset&) for each decided onset
+     * @param onFrame Called as onFrame(float flux) for each analysed hop
+     */
+    template <typename OnOnset, typename OnFrame>
+    void push(const float* samples, int numSamples, OnOnset&& onOnset, OnFrame&& onFrame) {
+        if (m_fft == nullptr)
+            return;
+
+        int offset = 0;
+        while (offset < numSamples) {
+            if (m_hopFill == m_hopSize)
+                advance();
+
+            const int count = juce::jmin(numSamples - offset, m_hopSize - m_hopFill);
+            std::copy(samples + offset, samples + offset + count,
+                      m_history.begin() + (m_historySize - m_hopSize + m_hopFill));
+            m_hopFill += count;
+            m_numSamples += count;
+            offset += count;
+
+            if (m_hopFill == m_hopSize) {
+                onFrame(analyseHop());
+                if (m_numFrames > m_settings.peakRadius)
+                    decide(m_numFrames - 1 - m_settings.peakRadius, onOnset);
+            }
+        }
+    }
+
+    template <typename OnOnset>
+    void push(const float* samples, int numSamples, OnOnset&& onOnset) {
+        push(samples, numSamples, onOnset, [](float) {});
+    }
+
+    /**
+     * End of stream: analyse the last partial hop and decide the frames still
+     * waiting for their lookahead. reset() before reusing the detector
+     */
+    template <typename OnOnset, typename OnFrame>
+    void finish(OnOnset&& onOnset, OnFrame&& onFrame) {
+        if (m_fft == nullptr)
+            return;
+
+        // The newest frame stays in the history: the last decisions refine against it
+        if (m_hopFill > 0 && m_hopFill < m_hopSize) {
+            std::fill(m_history.begin() + (m_historySize - m_hopSize + m_hopFill), m_history.end(), 0.0f);
+            m_hopFill = m_hopSize;
+            onFrame(analyseHop());
+            if (m_numFrames > m_settings.peakRadius)
+                decide(m_numFrames - 1 - m_settings.peakRadius, onOnset);
+        }
+
+        const juce::int64 last = m_numFrames - 1;
+        for (juce::int64 frame = juce::jmax((juce::int64) 0, last - m_settings.peakRadius + 1); frame <= last; ++frame)
+            decide(frame, onOnset, last);
+    }
+
+    template <typename OnOnset>
+    void finish(OnOnset&& onOnset) {
+        finish(onOnset, [](float) {});
+    }
+
+    /**
+     * Whole buffer in one call (mono mix of its channels)
+     * @param result Cleared and filled; reuse it across files to avoid reallocation
+     */
+    void detect(const juce::AudioBuffer<float>& buffer, OnsetList& result);
+
+    int getLatencySamples() const noexcept { return (m_settings.peakRadius + 3) * m_hopSize + kAttackSearchSamples; }
+    int getFftSize() const noexcept { return m_fftSize; }
+    int getHopSize() const noexcept { return m_hopSize; }
+    double getSampleRate() const noexcept { return m_sampleRate; }
+    const Settings& getSettings() const noexcept { return m_settings; }
+
+private:
+    float analyseHop();
+    void advance();
+    bool isOnset(juce::int64 frame, juce::int64 lastFrame) const;
+    double locateAttack(juce::int64 frame, int band) const;
+    float sampleAt(juce::int64 position) const;
+
+    template <typename OnOnset>
+    void decide(juce::int64 frame, OnOnset& onOnset, juce::int64 lastFrame = -1) {
+        if (lastFrame < 0)
+            lastFrame = frame + m_settings.peakRadius;
+        if (!isOnset(frame, lastFrame))
+            return;
+
+        Onset onset;
+        onset.flux = m_flux[ringIndex(frame)];
+        onset.band = m_band[ringIndex(frame)];
+        onset.position = locateAttack(frame, onset.band);
+        if (onset.position < (double) m_numSamples)
+            onOnset(onset);
+    }
+
+    size_t ringIndex(juce::int64 frame) const noexcept { return (size_t) (frame % (juce::int64) m_flux.size()); }
+
+    static constexpr int kBlockSize = 64;   // Attack search resolution
+    static constexpr int kAttackSearchSamples = 6 * kBlockSize;     // Reach before the frame's oldest hop
+
+    std::unique_ptr<juce::dsp::FFT> m_fft;
+    std::vector<float> m_window;
+    std::vector<float> m_fftBuffer;         // 2N floats
+    std::vector<float> m_compressed, m_previousCompressed;
+    std::array<int, kNumBands + 1> m_bandEdges {};
+
+    // Mono history: the newest hop at the end, long enough for the attack search
+    std::vector<float> m_history;
+    int m_historySize = 0;
+    int m_hopFill = 0;
+
+    // Flux and dominant band of the last frames (ring by frame index)
+    std::vector<float> m_flux;
+    std::vector<int> m_band;
+    float m_maxFlux = 0.0f;
+
+    Settings m_settings;
+    double m_sampleRate = 48000.0;
+    int m_fftSize = 2048;
+    int m_hopSize = 512;
+    int m_meanFrames = 4;
+    juce::int64 m_numFrames = 0;
+    juce::int64 m_numSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OnsetDetector)
+};
+
+} // namespace omega
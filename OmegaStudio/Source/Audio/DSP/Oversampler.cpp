@@ -0,0 +1,478 @@
+//==============================================================================
+// Oversampler.cpp - Implementation
+//==============================================================================
+
+#include "Oversampler.h"
+#include "SIMDProcessor.h"
+#include <cmath>
+#include <cstring>
+
+namespace OmegaStudio {
+
+using Omega::Audio::DSP::Vec4;
+
+namespace {
+    constexpr double pi = 3.14159265358979323846;
+
+    // Banda útil hasta 0.45 fs: la primera etapa hace la transición estrecha,
+    // las siguientes solo evitan imágenes / aliasing sobre esa banda
+    constexpr double passband = 0.45;
+
+    double getTransition(int stage) {
+        return 0.5 - 2.0 * passband / static_cast<double>(2 << stage);
+    }
+
+    constexpr double iirAttenuation = 100.0;     // dB
+    constexpr double firAttenuation = 96.0;      // dB
+    constexpr int maxSections = 16;              // Por rama
+}
+
+//==============================================================================
+// Etapa 2x: upsample n -> 2n, downsample 2n -> n
+//==============================================================================
+class Oversampler::Stage {
+public:
+    virtual ~Stage() = default;
+    virtual void reset() = 0;
+    virtual void upsample(const float* const* input, float* const* output, int numChannels, int numSamples) = 0;
+    virtual void downsample(const float* const* input, float* const* output, int numChannels, int numSamples) = 0;
+
+    // Ida y vuelta, en samples de la frecuencia alta
+    virtual float getLatency() const = 0;
+};
+
+//==============================================================================
+/** Half-band IIR polifásico (Valenzuela-Constantinides)
+ *  H(z) = 0.5 * (A0(z²) + z^-1 A1(z²)), Ai = cascada de allpass de primer orden.
+ *  Cada rama corre a la frecuencia baja: y = a * (x - y1) + x1
+ *  Lanes: { canal c rama 0, canal c rama 1, canal c+1 rama 0, canal c+1 rama 1 }
+ */
+class Oversampler::IIRStage : public Oversampler::Stage {
+public:
+    IIRStage(int numChannels, double attenuation, double transition) {
+        auto coefficients = design(attenuation, transition);
+        numSections_ = juce::jmin(maxSections, static_cast<int>(coefficients.size()) / 2);
+
+        // Coeficientes pares a la rama 0, impares a la rama 1
+        coefficients_.resize(static_cast<size_t>(numSections_) * 4);
+        for (int s = 0; s < numSections_; ++s) {
+            const auto a0 = static_cast<float>(coefficients[static_cast<size_t>(2 * s)]);
+            const auto a1 = static_cast<float>(coefficients[static_cast<size_t>(2 * s + 1)]);
+            float* c = coefficients_.data() + s * 4;
+            c[0] = a0; c[1] = a1; c[2] = a0; c[3] = a1;
+        }
+
+        // Retardo de grupo en DC: 2 (1 - a) / (1 + a) por sección en z²
+        double delay0 = 0.0, delay1 = 0.0;
+        for (int s = 0; s < numSections_; ++s) {
+            const double a0 = coefficients[static_cast<size_t>(2 * s)];
+            const double a1 = coefficients[static_cast<size_t>(2 * s + 1)];
+            delay0 += 2.0 * (1.0 - a0) / (1.0 + a0);
+            delay1 += 2.0 * (1.0 - a1) / (1.0 + a1);
+        }
+        const double filterDelay = 0.5 * (delay0 + 1.0 + delay1);
+        latency_ = static_cast<float>(2.0 * filterDelay - 1.0);    // Downsample lee la fase impar: -1
+
+        numPairs_ = (numChannels + 1) / 2;
+        const size_t stateSize = static_cast<size_t>(numPairs_ * numSections_ * 4);
+        upX_.assign(stateSize, 0.0f);
+        upY_.assign(stateSize, 0.0f);
+        downX_.assign(stateSize, 0.0f);
+        downY_.assign(stateSize, 0.0f);
+    }
+
+    void reset() override {
+        std::fill(upX_.begin(), upX_.end(), 0.0f);
+        std::fill(upY_.begin(), upY_.end(), 0.0f);
+        std::fill(downX_.begin(), downX_.end(), 0.0f);
+        std::fill(downY_.begin(), downY_.end(), 0.0f);
+    }
+
+    float getLatency() const override { return latency_; }
+
+    void upsample(const float* const* input, float* const* output, int numChannels, int numSamples) override {
+        for (int c = 0; c < numChannels; c += 2) {
+            const bool hasPair = c + 1 < numChannels;
+            const float* a = input[c];
+            const float* b = hasPair ? input[c + 1] : input[c];
+            float* outA = output[c];
+            float* outB = hasPair ? output[c + 1] : nullptr;
+
+            run(upX_, upY_, c / 2, numSamples,
+                [&](int i) { return Vec4::set(a[i], a[i], b[i], b[i]); },
+                [&](int i, const float* lanes) {
+                    outA[2 * i] = lanes[0];
+                    outA[2 * i + 1] = lanes[1];
+                    if (outB != nullptr) {
+                        outB[2 * i] = lanes[2];
+                        outB[2 * i + 1] = lanes[3];
+                    }
+                });
+        }
+    }
+
+    void downsample(const float* const* input, float* const* output, int numChannels, int numSamples) override {
+        for (int c = 0; c < numChannels; c += 2) {
+            const bool hasPair = c + 1 < numChannels;
+            const float* a = input[c];
+            const float* b = hasPair ? input[c + 1] : input[c];
+            float* outA = output[c];
+            float* outB = hasPair ? output[c + 1] : nullptr;
+
+            // y[n] = 0.5 * (A0(v[2n + 1]) + A1(v[2n]))
+            run(downX_, downY_, c / 2, numSamples,
+                [&](int i) { return Vec4::set(a[2 * i + 1], a[2 * i], b[2 * i + 1], b[2 * i]); },
+                [&](int i, const float* lanes) {
+                    outA[i] = 0.5f * (lanes[0] + lanes[1]);
+                    if (outB != nullptr)
+                        outB[i] = 0.5f * (lanes[2] + lanes[3]);
+                });
+        }
+    }
+
+private:
+    template <typename Load, typename Store>
+    void run(std::vector<float>& xState, std::vector<float>& yState, int pair, int numSamples, Load&& load, Store&& store) {
+        float* xs = xState.data() + pair * numSections_ * 4;
+        float* ys = yState.data() + pair * numSections_ * 4;
+
+        // Estado en registros durante el bloque
+        Vec4 coeff[maxSections], x1[maxSections], y1[maxSections];
+        for (int s = 0; s < numSections_; ++s) {
+            coeff[s] = Vec4::load(coefficients_.data() + s * 4);
+            x1[s] = Vec4::load(xs + s * 4);
+            y1[s] = Vec4::load(ys + s * 4);
+        }
+
+        alignas(16) float lanes[4];
+        for (int i = 0; i < numSamples; ++i) {
+            Vec4 v = load(i);
+            for (int s = 0; s < numSections_; ++s) {
+                const Vec4 y = coeff[s] * (v - y1[s]) + x1[s];
+                x1[s] = v;
+                y1[s] = y;
+                v = y;
+            }
+            v.store(lanes);
+            store(i, lanes);
+        }
+
+        for (int s = 0; s < numSections_; ++s) {
+            x1[s].store(xs + s * 4);
+            y1[s].store(ys + s * 4);
+        }
+
+        // Denormales: en silencio el estado decae hacia 0
+        for (int k = 0; k < numSections_ * 4; ++k) {
+            xs[k] = std::abs(xs[k]) < 1.0e-30f ? 0.0f : xs[k];
+            ys[k] = std::abs(ys[k]) < 1.0e-30f ? 0.0f : ys[k];
+        }
+    }
+
+    //==========================================================================
+    // Diseño elíptico por transformación de Jacobi (número de coeficientes a
+    // partir de atenuación y banda de transición, normalizada a fs alta)
+    static std::vector<double> design(double attenuation, double transition) {
+        double k = std::tan((1.0 - transition * 2.0) * pi / 4.0);
+        k *= k;
+        const double kksqrt = std::pow(1.0 - k * k, 0.25);
+        const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+        const double e2 = e * e;
+        const double e4 = e2 * e2;
+        const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const double attenuationPower = std::pow(10.0, -attenuation / 10.0);
+        const double ratio = attenuationPower / (1.0 - attenuationPower);
+        int order = static_cast<int>(std::ceil(std::log(ratio * ratio / 16.0) / std::log(q)));
+        if (order % 2 == 0)
+            ++order;
+
+        // Número par de coeficientes: las dos ramas tienen las mismas secciones
+        int numCoefficients = (order - 1) / 2;
+        numCoefficients += numCoefficients % 2;
+        numCoefficients = juce::jlimit(2, 2 * maxSections, numCoefficients);
+        order = 2 * numCoefficients + 1;
+
+        std::vector<double> coefficients(static_cast<size_t>(numCoefficients));
+        for (int index = 0; index < numCoefficients; ++index) {
+            const int c = index + 1;
+
+            double numerator = 0.0;
+            for (int i = 0, sign = 1;; ++i, sign = -sign) {
+                const double term = std::pow(q, static_cast<double>(i * (i + 1)))
+                                  * std::sin(static_cast<double>((2 * i + 1) * c) * pi / order) * sign;
+                numerator += term;
+                if (std::abs(term) <= 1.0e-100)
+                    break;
+            }
+            numerator *= std::pow(q, 0.25);
+
+            double denominator = 0.0;
+            for (int i = 1, sign = -1;; ++i, sign = -sign) {
+                const double term = std::pow(q, static_cast<double>(i * i))
+                                  * std::cos(static_cast<double>(2 * i * c) * pi / order) * sign;
+                denominator += term;
+                if (std::abs(term) <= 1.0e-100)
+                    break;
+            }
+            denominator = 0.5 + denominator;
+
+            const double ww = numerator / denominator;
+            const double wwsq = ww * ww;
+            const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+            coefficients[static_cast<size_t>(index)] = (1.0 - x) / (1.0 + x);
+        }
+        return coefficients;
+    }
+
+    int numSections_ = 0;
+    int numPairs_ = 0;
+    float latency_ = 0.0f;
+    std::vector<float> coefficients_;       // [sección][lane]
+    std::vector<float> upX_, upY_, downX_, downY_;
+};
+
+//==============================================================================
+/** Half-band FIR de fase lineal (sinc con ventana Kaiser, 4M - 1 taps)
+ *  - Taps pares del centro nulos: solo la rama par (2M taps, simétrica) se
+ *    convoluciona; la rama impar es el tap central (retardo puro)
+ *  - Convolución con 4 salidas por registro y pares simétricos plegados
+ */
+class Oversampler::FIRStage : public Oversampler::Stage {
+public:
+    FIRStage(int numChannels, int maxInputSamples, double attenuation, double transition) {
+        // Kaiser: N = (A - 7.95) / (14.36 * Δf) + 1, redondeado a 4M - 1
+        const double taps = (attenuation - 7.95) / (14.36 * transition) + 1.0;
+        half_ = juce::jmax(2, static_cast<int>(std::ceil((taps + 1.0) / 4.0)));
+        length_ = 2 * half_;
+
+        const int numTaps = 4 * half_ - 1;
+        const int centre = 2 * half_ - 1;
+        const double beta = 0.1102 * (attenuation - 8.7);
+        const double besselBeta = bessel0(beta);
+
+        // Rama par: g[k] = 2 h[2k], normalizada a ganancia 1 en DC
+        branch_.resize(static_cast<size_t>(length_));
+        double sum = 0.0;
+        for (int k = 0; k < length_; ++k) {
+            const int n = 2 * k;
+            const double offset = static_cast<double>(n - centre);
+            const double sinc = std::sin(0.5 * pi * offset) / (pi * offset);
+            const double r = 2.0 * n / static_cast<double>(numTaps - 1) - 1.0;
+            const double window = bessel0(beta * std::sqrt(juce::jmax(0.0, 1.0 - r * r))) / besselBeta;
+            branch_[static_cast<size_t>(k)] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+        for (auto& g : branch_)
+            g = static_cast<float>(g / sum);
+
+        maxSamples_ = maxInputSamples;
+        const size_t channels = static_cast<size_t>(numChannels);
+        upHistory_.assign(channels, std::vector<float>(static_cast<size_t>(length_ - 1 + maxSamples_), 0.0f));
+        evenHistory_.assign(channels, std::vector<float>(static_cast<size_t>(length_ - 1 + maxSamples_), 0.0f));
+        oddHistory_.assign(channels, std::vector<float>(static_cast<size_t>(half_ + maxSamples_), 0.0f));
+        scratch_.assign(static_cast<size_t>(maxSamples_), 0.0f);
+    }
+
+    void reset() override {
+        for (auto* histories : { &upHistory_, &evenHistory_, &oddHistory_ })
+            for (auto& history : *histories)
+                std::fill(history.begin(), history.end(), 0.0f);
+    }
+
+    // Centro del filtro (2M - 1 samples altos) en cada sentido
+    float getLatency() const override { return static_cast<float>(2 * (2 * half_ - 1)); }
+
+    void upsample(const float* const* input, float* const* output, int numChannels, int numSamples) override {
+        const int history = length_ - 1;
+        float* scratch = scratch_.data();
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* xh = upHistory_[static_cast<size_t>(ch)].data();
+            float* out = output[ch];
+            std::memcpy(xh + history, input[ch], sizeof(float) * static_cast<size_t>(numSamples));
+
+            // y[2n] = sum g[k] x[n - k];  y[2n + 1] = x[n - (M - 1)]
+            convolve(xh, scratch, numSamples);
+            const float* centre = xh + half_;
+            for (int i = 0; i < numSamples; ++i) {
+                out[2 * i] = scratch[i];
+                out[2 * i + 1] = centre[i];
+            }
+
+            std::memmove(xh, xh + numSamples, sizeof(float) * static_cast<size_t>(history));
+        }
+    }
+
+    void downsample(const float* const* input, float* const* output, int numChannels, int numSamples) override {
+        const int history = length_ - 1;
+        float* scratch = scratch_.data();
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* even = evenHistory_[static_cast<size_t>(ch)].data();
+            float* odd = oddHistory_[static_cast<size_t>(ch)].data();
+            const float* in = input[ch];
+            float* out = output[ch];
+
+            for (int i = 0; i < numSamples; ++i) {
+                even[history + i] = in[2 * i];
+                odd[half_ + i] = in[2 * i + 1];
+            }
+
+            // y[n] = 0.5 * (sum g[k] v[2n - 2k] + v[2(n - M) + 1])
+            convolve(even, scratch, numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = 0.5f * (scratch[i] + odd[i]);
+
+            std::memmove(even, even + numSamples, sizeof(float) * static_cast<size_t>(history));
+            std::memmove(odd, odd + numSamples, sizeof(float) * static_cast<size_t>(half_));
+        }
+    }
+
+private:
+    // y[i] = sum_j g[j] xh[i + j], g simétrica: un producto por par de taps
+    void convolve(const float* xh, float* y, int numSamples) const {
+        const float* g = branch_.data();
+        const int last = length_ - 1;
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4) {
+            Vec4 acc = Vec4::set1(0.0f);
+            for (int j = 0; j < half_; ++j)
+                acc = acc + Vec4::set1(g[j]) * (Vec4::load(xh + i + j) + Vec4::load(xh + i + last - j));
+            acc.store(y + i);
+        }
+
+        for (; i < numSamples; ++i) {
+            float acc = 0.0f;
+            for (int j = 0; j < half_; ++j)
+                acc += g[j] * (xh[i + j] + xh[i + last - j]);
+            y[i] = acc;
+        }
+    }
+
+    static double bessel0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < 1.0e-12 * sum)
+                break;
+        }
+        return sum;
+    }
+
+    int half_ = 0;          // M
+    int length_ = 0;        // 2M taps en la rama par
+    int maxSamples_ = 0;
+    std::vector<float> branch_;
+    std::vector<std::vector<float>> upHistory_, evenHistory_, oddHistory_;
+    std::vector<float> scratch_;
+};
+
+//==============================================================================
+// Oversampler
+//==============================================================================
+Oversampler::Oversampler() = default;
+Oversampler::~Oversampler() = default;
+
+void Oversampler::prepare(int numChannels, int maxBlockSize, Factor factor, Phase phase) {
+    numChannels_ = juce::jlimit(1, maxChannels, numChannels);
+    maxBlockSize_ = juce::jmax(1, maxBlockSize);
+    factor_ = static_cast<int>(factor);
+    phase_ = phase;
+
+    numStages_ = 0;
+    while ((1 << numStages_) < factor_ && numStages_ < maxStages)
+        ++numStages_;
+    factor_ = 1 << numStages_;
+
+    latency_ = 0.0f;
+    for (int s = 0; s < maxStages; ++s) {
+        if (s >= numStages_) {
+            stages_[static_cast<size_t>(s)].reset();
+            buffers_[static_cast<size_t>(s)] = {};
+            continue;
+        }
+
+        const int inputSamples = maxBlockSize_ << s;
+        const int outputSamples = inputSamples * 2;
+
+        if (phase_ == Phase::Minimum)
+            stages_[static_cast<size_t>(s)] = std::make_unique<IIRStage>(numChannels_, iirAttenuation, getTransition(s));
+        else
+            stages_[static_cast<size_t>(s)] = std::make_unique<FIRStage>(numChannels_, inputSamples, firAttenuation, getTransition(s));
+
+        // Latencia de la etapa a la frecuencia base
+        latency_ += stages_[static_cast<size_t>(s)]->getLatency() / static_cast<float>(2 << s);
+
+        auto& buffer = buffers_[static_cast<size_t>(s)];
+        buffer.assign(static_cast<size_t>(outputSamples * numChannels_), 0.0f);
+        for (int ch = 0; ch < numChannels_; ++ch)
+            pointers_[static_cast<size_t>(s)][static_cast<size_t>(ch)] = buffer.data() + ch * outputSamples;
+    }
+}
+
+void Oversampler::reset() {
+    for (int s = 0; s < numStages_; ++s)
+        stages_[static_cast<size_t>(s)]->reset();
+}
+
+float* const* Oversampler::upsample(const float* const* input, int numChannels, int numSamples) {
+    numChannels = juce::jmin(numChannels, numChannels_);
+    jassert(numSamples <= maxBlockSize_);
+
+    const float* const* source = input;
+    for (int s = 0; s < numStages_; ++s) {
+        float* const* destination = pointers_[static_cast<size_t>(s)].data();
+        stages_[static_cast<size_t>(s)]->upsample(source, destination, numChannels, numSamples << s);
+        source = destination;
+    }
+    return numStages_ > 0 ? pointers_[static_cast<size_t>(numStages_ - 1)].data() : const_cast<float* const*>(input);
+}
+
+void Oversampler::downsample(float* const* output, int numChannels, int numSamples) {
+    numChannels = juce::jmin(numChannels, numChannels_);
+
+    // Cada etapa baja a la salida de la anterior (ya consumida en upsample)
+    for (int s = numStages_ - 1; s >= 0; --s) {
+        const float* const* source = pointers_[static_cast<size_t>(s)].data();
+        float* const* destination = s > 0 ? pointers_[static_cast<size_t>(s - 1)].data() : output;
+        stages_[static_cast<size_t>(s)]->downsample(source, destination, numChannels, numSamples << s);
+    }
+}
+
+//==============================================================================
+std::vector<Oversampler::BenchmarkResult> Oversampler::benchmark(double sampleRate, int blockSize, double seconds) {
+    std::vector<BenchmarkResult> results;
+
+    const int numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+    std::vector<float> left(static_cast<size_t>(blockSize)), right(static_cast<size_t>(blockSize));
+    for (int i = 0; i < blockSize; ++i) {
+        left[static_cast<size_t>(i)] = 0.5f * std::sin(0.05f * static_cast<float>(i));
+        right[static_cast<size_t>(i)] = 0.5f * std::cos(0.03f * static_cast<float>(i));
+    }
+    float* channels[2] = { left.data(), right.data() };
+
+    for (const auto phase : { Phase::Minimum, Phase::Linear }) {
+        for (const auto factor : { Factor::x2, Factor::x4, Factor::x8, Factor::x16 }) {
+            Oversampler oversampler;
+            oversampler.prepare(2, blockSize, factor, phase);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < numBlocks; ++b)
+                oversampler.process(channels, 2, blockSize, [](float* const*, int, int) {});
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            BenchmarkResult result;
+            result.factor = factor;
+            result.phase = phase;
+            result.latency = oversampler.getLatency();
+            result.cpuLoad = elapsed / (numBlocks * blockSize / sampleRate);
+            results.push_back(result);
+        }
+    }
+    return results;
+}
+
+} // namespace OmegaStudio
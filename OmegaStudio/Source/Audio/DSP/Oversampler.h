@@ -0,0 +1,132 @@
+//==============================================================================
+// Oversampler.h - Oversampling 2x-16x para etapas no lineales
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+namespace OmegaStudio {
+
+//==============================================================================
+/** Oversampler por cascada de filtros half-band polifásicos
+ *  - Factores 1x (bypass), 2x, 4x, 8x y 16x: una etapa 2x por octava
+ *  - Fase mínima: allpass polifásicos IIR (latencia de pocos samples)
+ *    Fase lineal: FIR half-band con ventana Kaiser (latencia mayor, sin
+ *    distorsión de fase)
+ *  - La primera etapa lleva la banda de transición estrecha (hasta 0.45 fs);
+ *    las siguientes solo protegen esa banda y son mucho más cortas
+ *  - Kernels Vec4: IIR con 2 canales x 2 ramas por registro, FIR con 4
+ *    salidas consecutivas por registro
+ *  - Factor distinto para tiempo real y render offline (Settings): el host
+ *    indica el modo en prepare() y la latencia resultante va al PDC
+ */
+class Oversampler {
+public:
+    enum class Factor {
+        x1 = 1,
+        x2 = 2,
+        x4 = 4,
+        x8 = 8,
+        x16 = 16
+    };
+
+    enum class Phase {
+        Minimum,        // IIR polifásico
+        Linear          // FIR half-band
+    };
+
+    struct Settings {
+        Factor realtime = Factor::x2;
+        Factor offline = Factor::x8;
+        Phase phase = Phase::Minimum;
+
+        Factor select(bool nonRealtime) const { return nonRealtime ? offline : realtime; }
+        bool operator== (const Settings&) const = default;
+    };
+
+    static constexpr int maxChannels = 8;
+    static constexpr int maxStages = 4;
+
+    Oversampler();
+    ~Oversampler();
+
+    void prepare(int numChannels, int maxBlockSize, Factor factor, Phase phase = Phase::Minimum);
+    void prepare(int numChannels, int maxBlockSize, const Settings& settings, bool nonRealtime) {
+        prepare(numChannels, maxBlockSize, settings.select(nonRealtime), settings.phase);
+    }
+    void reset();
+
+    int getFactor() const { return factor_; }
+    Phase getPhase() const { return phase_; }
+    int getMaxBlockSize() const { return maxBlockSize_; }
+
+    // Retardo ida y vuelta en samples de la frecuencia base (IIR: a baja frecuencia)
+    float getLatency() const { return latency_; }
+    int getLatencySamples() const { return juce::roundToInt(latency_); }
+
+    // numSamples <= getMaxBlockSize(). upsample() devuelve numSamples * factor
+    // samples por canal; downsample() los lleva de vuelta a output
+    float* const* upsample(const float* const* input, int numChannels, int numSamples);
+    void downsample(float* const* output, int numChannels, int numSamples);
+
+    /** Ejecuta processor(channels, numChannels, numOversampledSamples) a la
+     *  frecuencia alta, en bloques de getMaxBlockSize(). In-place sobre channels */
+    template <typename Processor>
+    void process(float* const* channels, int numChannels, int numSamples, Processor&& processor) {
+        numChannels = juce::jmin(numChannels, numChannels_);
+        float* chunk[maxChannels] = {};
+
+        for (int offset = 0; offset < numSamples; offset += maxBlockSize_) {
+            const int length = juce::jmin(maxBlockSize_, numSamples - offset);
+            for (int ch = 0; ch < numChannels; ++ch)
+                chunk[ch] = channels[ch] + offset;
+
+            if (factor_ == 1) {
+                processor(static_cast<float* const*>(chunk), numChannels, length);
+                continue;
+            }
+
+            float* const* oversampled = upsample(chunk, numChannels, length);
+            processor(oversampled, numChannels, length * factor_);
+            downsample(chunk, numChannels, length);
+        }
+    }
+
+    //==========================================================================
+    // Coste por factor (para elegir el trade-off por insert)
+    struct BenchmarkResult {
+        Factor factor = Factor::x1;
+        Phase phase = Phase::Minimum;
+        float latency = 0.0f;           // samples
+        double cpuLoad = 0.0;           // Fracción de un core (1.0 = tiempo real)
+    };
+
+    // Ida y vuelta estéreo sin proceso intermedio: solo el coste de los filtros
+    static std::vector<BenchmarkResult> benchmark(double sampleRate, int blockSize = 512, double seconds = 1.0);
+
+private:
+    class Stage;
+    class IIRStage;
+    class FIRStage;
+
+    int factor_ = 1;
+    int numStages_ = 0;
+    int numChannels_ = 2;
+    int maxBlockSize_ = 512;
+    Phase phase_ = Phase::Minimum;
+    float latency_ = 0.0f;
+
+    std::array<std::unique_ptr<Stage>, maxStages> stages_;
+
+    // Salida de cada etapa: maxBlockSize * 2^(etapa + 1) samples por canal
+    std::array<std::vector<float>, maxStages> buffers_;
+    std::array<std::array<float*, maxChannels>, maxStages> pointers_ {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Oversampler)
+};
+
+} // namespace OmegaStudio
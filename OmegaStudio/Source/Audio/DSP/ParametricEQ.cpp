@@ -37,21 +37,12 @@ void ParametricEQ::prepare(double sampleRate, int samplesPerBlock) {
     sampleRate_ = sampleRate;
     samplesPerBlock_ = samplesPerBlock;
     
-    // Setup smoothing (20ms ramp)
-    const float rampTime = 0.02f;
-    for (int i = 0; i < 7; ++i) {
-        smoothedGains_[i].reset(sampleRate, rampTime);
-        smoothedFreqs_[i].reset(sampleRate, rampTime);
-        smoothedQs_[i].reset(sampleRate, rampTime);
-        
-        smoothedGains_[i].setCurrentAndTargetValue(bands_[i].gain);
-        smoothedFreqs_[i].setCurrentAndTargetValue(bands_[i].frequency);
-        smoothedQs_[i].setCurrentAndTargetValue(bands_[i].Q);
-    }
+    // Rampa de coeficientes de 20 ms para la automatización
+    cascade_.prepare(sampleRate, 20.0);
     
     // Calcular coeficientes iniciales
     for (int i = 0; i < 7; ++i) {
-        updateCoefficients(i);
+        updateCoefficients(i, true);
     }
     
     reset();
@@ -60,10 +51,13 @@ void ParametricEQ::prepare(double sampleRate, int samplesPerBlock) {
 //==============================================================================
 void ParametricEQ::reset() {
     for (auto& band : bands_) {
-        band.z[0] = 0.0f;
-        band.z[1] = 0.0f;
+        for (auto& z : band.z) {
+            z[0] = 0.0f;
+            z[1] = 0.0f;
+        }
     }
     
+    cascade_.reset();
     std::fill(fftData_.begin(), fftData_.end(), 0.0f);
 }
 
@@ -72,34 +66,10 @@ void ParametricEQ::process(juce::AudioBuffer<float>& buffer) {
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
     
-    // Procesar cada banda habilitada
-    for (int band = 0; band < 7; ++band) {
-        if (!bands_[band].enabled) continue;
-        
-        // Actualizar coeficientes si los parámetros cambiaron
-        if (smoothedGains_[band].isSmoothing() || 
-            smoothedFreqs_[band].isSmoothing() || 
-            smoothedQs_[band].isSmoothing()) {
-            updateCoefficients(band);
-        }
-        
-        // Procesar cada canal
-        for (int ch = 0; ch < numChannels; ++ch) {
-            float* channelData = buffer.getWritePointer(ch);
-            const auto& coeffs = bands_[band].coeffs;
-            auto& z = bands_[band].z;
-            
-            // Biquad filter: Direct Form II Transposed
-            for (int i = 0; i < numSamples; ++i) {
-                const float input = channelData[i];
-                const float output = coeffs[0] * input + z[0];
-                
-                z[0] = coeffs[1] * input - coeffs[3] * output + z[1];
-                z[1] = coeffs[2] * input - coeffs[4] * output;
-                
-                channelData[i] = output;
-            }
-        }
+    // Todas las bandas en una pasada, hasta 4 canales por registro SIMD
+    for (int ch = 0; ch < numChannels; ch += BiquadCascade::maxLanes) {
+        cascade_.process(buffer.getArrayOfWritePointers() + ch,
+                         std::min(BiquadCascade::maxLanes, numChannels - ch), numSamples);
     }
 }
 
@@ -109,12 +79,18 @@ float ParametricEQ::processSample(float sample, int bandIndex) {
         return sample;
     }
     
-    const auto& coeffs = bands_[bandIndex].coeffs;
-    auto& z = bands_[bandIndex].z;
+    auto& band = bands_[bandIndex];
+    float output = sample;
     
-    const float output = coeffs[0] * sample + z[0];
-    z[0] = coeffs[1] * sample - coeffs[3] * output + z[1];
-    z[1] = coeffs[2] * sample - coeffs[4] * output;
+    for (int s = 0; s < band.numSections; ++s) {
+        const auto& c = band.sections[s];
+        auto& z = band.z[s];
+        
+        const float input = output;
+        output = c.b0 * input + z[0];
+        z[0] = c.b1 * input - c.a1 * output + z[1];
+        z[1] = c.b2 * input - c.a2 * output;
+    }
     
     return output;
 }
@@ -123,20 +99,20 @@ float ParametricEQ::processSample(float sample, int bandIndex) {
 void ParametricEQ::setBandEnabled(int bandIndex, bool enabled) {
     if (bandIndex >= 0 && bandIndex < 7) {
         bands_[bandIndex].enabled = enabled;
+        updateCoefficients(bandIndex);
     }
 }
 
 void ParametricEQ::setBandType(int bandIndex, FilterType type) {
     if (bandIndex >= 0 && bandIndex < 7) {
         bands_[bandIndex].type = type;
-        updateCoefficients(bandIndex);
+        updateCoefficients(bandIndex, true);
     }
 }
 
 void ParametricEQ::setBandFrequency(int bandIndex, float frequency) {
     if (bandIndex >= 0 && bandIndex < 7) {
         bands_[bandIndex].frequency = juce::jlimit(20.0f, 20000.0f, frequency);
-        smoothedFreqs_[bandIndex].setTargetValue(bands_[bandIndex].frequency);
         updateCoefficients(bandIndex);
     }
 }
@@ -144,7 +120,6 @@ void ParametricEQ::setBandFrequency(int bandIndex, float frequency) {
 void ParametricEQ::setBandGain(int bandIndex, float gainDb) {
     if (bandIndex >= 0 && bandIndex < 7) {
         bands_[bandIndex].gain = juce::jlimit(-24.0f, 24.0f, gainDb);
-        smoothedGains_[bandIndex].setTargetValue(bands_[bandIndex].gain);
         updateCoefficients(bandIndex);
     }
 }
@@ -152,7 +127,6 @@ void ParametricEQ::setBandGain(int bandIndex, float gainDb) {
 void ParametricEQ::setBandQ(int bandIndex, float Q) {
     if (bandIndex >= 0 && bandIndex < 7) {
         bands_[bandIndex].Q = juce::jlimit(0.1f, 20.0f, Q);
-        smoothedQs_[bandIndex].setTargetValue(bands_[bandIndex].Q);
         updateCoefficients(bandIndex);
     }
 }
@@ -160,174 +134,75 @@ void ParametricEQ::setBandQ(int bandIndex, float Q) {
 void ParametricEQ::setBandSlope(int bandIndex, Slope slope) {
     if (bandIndex >= 0 && bandIndex < 7) {
         bands_[bandIndex].slope = slope;
-        updateCoefficients(bandIndex);
+        updateCoefficients(bandIndex, true);
     }
 }
 
 //==============================================================================
-void ParametricEQ::updateCoefficients(int bandIndex) {
+void ParametricEQ::updateCoefficients(int bandIndex, bool immediate) {
     auto& band = bands_[bandIndex];
     
+    band.sections.fill({});
+    band.numSections = 1;
+    
     switch (band.type) {
         case FilterType::Bell:
-            calculateBellCoeffs(band);
+            band.sections[0] = BiquadCoefficients::peak(sampleRate_, band.frequency, band.Q, band.gain);
             break;
         case FilterType::LowShelf:
-            calculateShelfCoeffs(band, true);
+            band.sections[0] = BiquadCoefficients::lowShelf(sampleRate_, band.frequency, band.Q, band.gain);
             break;
         case FilterType::HighShelf:
-            calculateShelfCoeffs(band, false);
+            band.sections[0] = BiquadCoefficients::highShelf(sampleRate_, band.frequency, band.Q, band.gain);
             break;
         case FilterType::LowCut:
-            calculateCutCoeffs(band, true);
+            calculateCutSections(band, true);
             break;
         case FilterType::HighCut:
-            calculateCutCoeffs(band, false);
+            calculateCutSections(band, false);
             break;
         case FilterType::Notch:
-            calculateNotchCoeffs(band);
+            band.sections[0] = BiquadCoefficients::notch(sampleRate_, band.frequency, band.Q);
             break;
-        default:
+        case FilterType::AllPass:
+            band.sections[0] = BiquadCoefficients::allPass(sampleRate_, band.frequency, band.Q);
             break;
     }
-}
-
-//==============================================================================
-void ParametricEQ::calculateBellCoeffs(Band& band) {
-    const float freq = band.frequency;
-    const float gain = band.gain;
-    const float Q = band.Q;
-    
-    const float omega = juce::MathConstants<float>::twoPi * freq / static_cast<float>(sampleRate_);
-    const float sinOmega = std::sin(omega);
-    const float cosOmega = std::cos(omega);
-    const float alpha = sinOmega / (2.0f * Q);
-    const float A = std::pow(10.0f, gain / 40.0f);
-    
-    const float b0 = 1.0f + alpha * A;
-    const float b1 = -2.0f * cosOmega;
-    const float b2 = 1.0f - alpha * A;
-    const float a0 = 1.0f + alpha / A;
-    const float a1 = -2.0f * cosOmega;
-    const float a2 = 1.0f - alpha / A;
     
-    // Normalizar
-    band.coeffs[0] = b0 / a0;
-    band.coeffs[1] = b1 / a0;
-    band.coeffs[2] = b2 / a0;
-    band.coeffs[3] = a1 / a0;
-    band.coeffs[4] = a2 / a0;
-}
-
-//==============================================================================
-void ParametricEQ::calculateShelfCoeffs(Band& band, bool isLow) {
-    const float freq = band.frequency;
-    const float gain = band.gain;
-    const float Q = band.Q;
-    
-    const float omega = juce::MathConstants<float>::twoPi * freq / static_cast<float>(sampleRate_);
-    const float sinOmega = std::sin(omega);
-    const float cosOmega = std::cos(omega);
-    const float A = std::pow(10.0f, gain / 40.0f);
-    const float beta = std::sqrt(A) / Q;
-    
-    float b0, b1, b2, a0, a1, a2;
-    
-    if (isLow) {
-        b0 = A * ((A + 1.0f) - (A - 1.0f) * cosOmega + beta * sinOmega);
-        b1 = 2.0f * A * ((A - 1.0f) - (A + 1.0f) * cosOmega);
-        b2 = A * ((A + 1.0f) - (A - 1.0f) * cosOmega - beta * sinOmega);
-        a0 = (A + 1.0f) + (A - 1.0f) * cosOmega + beta * sinOmega;
-        a1 = -2.0f * ((A - 1.0f) + (A + 1.0f) * cosOmega);
-        a2 = (A + 1.0f) + (A - 1.0f) * cosOmega - beta * sinOmega;
-    } else {
-        b0 = A * ((A + 1.0f) + (A - 1.0f) * cosOmega + beta * sinOmega);
-        b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cosOmega);
-        b2 = A * ((A + 1.0f) + (A - 1.0f) * cosOmega - beta * sinOmega);
-        a0 = (A + 1.0f) - (A - 1.0f) * cosOmega + beta * sinOmega;
-        a1 = 2.0f * ((A - 1.0f) - (A + 1.0f) * cosOmega);
-        a2 = (A + 1.0f) - (A - 1.0f) * cosOmega - beta * sinOmega;
+    // Banda apagada = etapas identidad, el motor las salta
+    for (int s = 0; s < maxSectionsPerBand; ++s) {
+        const int stage = bandIndex * maxSectionsPerBand + s;
+        if (band.enabled && s < band.numSections) {
+            cascade_.setStage(stage, band.sections[s], immediate);
+        } else {
+            cascade_.bypassStage(stage, immediate);
+        }
     }
-    
-    // Normalizar
-    band.coeffs[0] = b0 / a0;
-    band.coeffs[1] = b1 / a0;
-    band.coeffs[2] = b2 / a0;
-    band.coeffs[3] = a1 / a0;
-    band.coeffs[4] = a2 / a0;
 }
 
 //==============================================================================
-void ParametricEQ::calculateCutCoeffs(Band& band, bool isLow) {
-    const float freq = band.frequency;
-    const float Q = 0.7071f; // Butterworth
-    
-    const float omega = juce::MathConstants<float>::twoPi * freq / static_cast<float>(sampleRate_);
-    const float sinOmega = std::sin(omega);
-    const float cosOmega = std::cos(omega);
-    const float alpha = sinOmega / (2.0f * Q);
-    
-    float b0, b1, b2, a0, a1, a2;
-    
-    if (isLow) {
-        // High-pass filter
-        b0 = (1.0f + cosOmega) / 2.0f;
-        b1 = -(1.0f + cosOmega);
-        b2 = (1.0f + cosOmega) / 2.0f;
-        a0 = 1.0f + alpha;
-        a1 = -2.0f * cosOmega;
-        a2 = 1.0f - alpha;
-    } else {
-        // Low-pass filter
-        b0 = (1.0f - cosOmega) / 2.0f;
-        b1 = 1.0f - cosOmega;
-        b2 = (1.0f - cosOmega) / 2.0f;
-        a0 = 1.0f + alpha;
-        a1 = -2.0f * cosOmega;
-        a2 = 1.0f - alpha;
+void ParametricEQ::calculateCutSections(Band& band, bool isLow) {
+    // Butterworth de orden 2N como N secciones con los Q de sus pares de polos
+    static constexpr float q12[] = { 0.7071f };
+    static constexpr float q24[] = { 0.5412f, 1.3066f };
+    static constexpr float q48[] = { 0.5098f, 0.6013f, 0.9000f, 2.5629f };
+    
+    const float* qs = q12;
+    band.numSections = 1;
+    if (band.slope == Slope::dB24) {
+        qs = q24;
+        band.numSections = 2;
+    } else if (band.slope == Slope::dB48) {
+        qs = q48;
+        band.numSections = 4;
     }
     
-    // Normalizar
-    band.coeffs[0] = b0 / a0;
-    band.coeffs[1] = b1 / a0;
-    band.coeffs[2] = b2 / a0;
-    band.coeffs[3] = a1 / a0;
-    band.coeffs[4] = a2 / a0;
-    
-    // Para slopes mayores, aplicar en cascada (implementación simplificada)
-    if (band.slope == Slope::dB48) {
-        // Doblar el efecto (aproximación)
-        for (int i = 0; i < 5; ++i) {
-            band.coeffs[i] *= 2.0f;
-        }
+    for (int s = 0; s < band.numSections; ++s) {
+        band.sections[s] = isLow ? BiquadCoefficients::highPass(sampleRate_, band.frequency, qs[s])
+                                 : BiquadCoefficients::lowPass(sampleRate_, band.frequency, qs[s]);
     }
 }
 
-//==============================================================================
-void ParametricEQ::calculateNotchCoeffs(Band& band) {
-    const float freq = band.frequency;
-    const float Q = band.Q;
-    
-    const float omega = juce::MathConstants<float>::twoPi * freq / static_cast<float>(sampleRate_);
-    const float sinOmega = std::sin(omega);
-    const float cosOmega = std::cos(omega);
-    const float alpha = sinOmega / (2.0f * Q);
-    
-    const float b0 = 1.0f;
-    const float b1 = -2.0f * cosOmega;
-    const float b2 = 1.0f;
-    const float a0 = 1.0f + alpha;
-    const float a1 = -2.0f * cosOmega;
-    const float a2 = 1.0f - alpha;
-    
-    // Normalizar
-    band.coeffs[0] = b0 / a0;
-    band.coeffs[1] = b1 / a0;
-    band.coeffs[2] = b2 / a0;
-    band.coeffs[3] = a1 / a0;
-    band.coeffs[4] = a2 / a0;
-}
-
 //==============================================================================
 ParametricEQ::FrequencyResponse ParametricEQ::calculateFrequencyResponse(int numPoints) const {
     FrequencyResponse response;
@@ -371,34 +246,23 @@ ParametricEQ::FrequencyResponse ParametricEQ::calculateFrequencyResponse(int num
 //==============================================================================
 float ParametricEQ::getMagnitudeAt(float frequency, int bandIndex) const {
     const auto& band = bands_[bandIndex];
-    const auto& c = band.coeffs;
-    
-    const float omega = juce::MathConstants<float>::twoPi * frequency / static_cast<float>(sampleRate_);
-    const std::complex<float> z = std::exp(std::complex<float>(0.0f, omega));
-    const std::complex<float> z2 = z * z;
     
-    // H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
-    const std::complex<float> numerator = c[0] + c[1] / z + c[2] / z2;
-    const std::complex<float> denominator = 1.0f + c[3] / z + c[4] / z2;
-    
-    const std::complex<float> H = numerator / denominator;
-    return std::abs(H);
+    double magnitude = 1.0;
+    for (int s = 0; s < band.numSections; ++s) {
+        magnitude *= std::abs(band.sections[s].response(frequency, sampleRate_));
+    }
+    return static_cast<float>(magnitude);
 }
 
 //==============================================================================
 float ParametricEQ::getPhaseAt(float frequency, int bandIndex) const {
     const auto& band = bands_[bandIndex];
-    const auto& c = band.coeffs;
-    
-    const float omega = juce::MathConstants<float>::twoPi * frequency / static_cast<float>(sampleRate_);
-    const std::complex<float> z = std::exp(std::complex<float>(0.0f, omega));
-    const std::complex<float> z2 = z * z;
     
-    const std::complex<float> numerator = c[0] + c[1] / z + c[2] / z2;
-    const std::complex<float> denominator = 1.0f + c[3] / z + c[4] / z2;
-    
-    const std::complex<float> H = numerator / denominator;
-    return std::arg(H);
+    double phase = 0.0;
+    for (int s = 0; s < band.numSections; ++s) {
+        phase += std::arg(band.sections[s].response(frequency, sampleRate_));
+    }
+    return static_cast<float>(phase);
 }
 
 //==============================================================================
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BiquadCascade.h"
 #include <array>
 #include <vector>
 #include <complex>
@@ -20,6 +21,8 @@ namespace OmegaStudio {
  *  - Q variable (0.1 - 20.0)
  *  - Gain ±24 dB
  *  - Análisis de frecuencia FFT para feedback visual
+ *  - Motor BiquadCascade: estéreo en un registro SIMD, todas las bandas en una
+ *    pasada, bandas apagadas/planas saltadas, automatización interpolada
  */
 class ParametricEQ {
 public:
@@ -41,6 +44,8 @@ public:
     };
     
     //==========================================================================
+    static constexpr int maxSectionsPerBand = 4;
+    
     struct Band {
         bool enabled = true;
         FilterType type = FilterType::Bell;
@@ -49,11 +54,12 @@ public:
         float Q = 1.0f;                  // 0.1 - 20.0
         Slope slope = Slope::dB24;       // Para filtros cut
         
-        // Coeficientes de filtro IIR (biquad)
-        std::array<float, 5> coeffs{0, 0, 0, 0, 0}; // b0, b1, b2, a1, a2
+        // Secciones biquad (cut 48 dB/oct = 4 secciones Butterworth)
+        std::array<BiquadCoefficients, maxSectionsPerBand> sections{};
+        int numSections = 1;
         
-        // Estado del filtro (para procesamiento)
-        std::array<float, 2> z{0, 0};   // z1, z2
+        // Estado por sección para processSample()
+        std::array<std::array<float, 2>, maxSectionsPerBand> z{};   // z1, z2
     };
     
     //==========================================================================
@@ -99,17 +105,15 @@ public:
     
 private:
     //==========================================================================
-    void updateCoefficients(int bandIndex);
-    void calculateBellCoeffs(Band& band);
-    void calculateShelfCoeffs(Band& band, bool isLow);
-    void calculateCutCoeffs(Band& band, bool isLow);
-    void calculateNotchCoeffs(Band& band);
+    void updateCoefficients(int bandIndex, bool immediate = false);
+    void calculateCutSections(Band& band, bool isLow);
     
     float getMagnitudeAt(float frequency, int bandIndex) const;
     float getPhaseAt(float frequency, int bandIndex) const;
     
     //==========================================================================
     std::array<Band, 7> bands_;
+    BiquadCascade cascade_;     // Etapas band * maxSectionsPerBand + sección
     double sampleRate_ = 48000.0;
     int samplesPerBlock_ = 512;
     
@@ -124,11 +128,6 @@ private:
     std::vector<float> inputSpectrum_;
     std::vector<float> outputSpectrum_;
     
-    // Smooth para cambios de parámetros
-    juce::SmoothedValue<float> smoothedGains_[7];
-    juce::SmoothedValue<float> smoothedFreqs_[7];
-    juce::SmoothedValue<float> smoothedQs_[7];
-    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParametricEQ)
 };
 
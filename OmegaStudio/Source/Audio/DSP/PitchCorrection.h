@@ -3,121 +3,25 @@
  * @brief Real-time pitch correction (Autotune) processor
  * 
  * Professional pitch correction with automatic detection and SIMD optimization.
- * Implements phase vocoder for pitch shifting without time stretching.
+ * Pitch shifting without time stretching runs on the shared SpectralPitchShifter.
  */
 
 #pragma once
 
 #include <JuceHeader.h>
 #include <array>
-#include <complex>
-#include <memory>
+#include "PitchTracker.h"
+#include "SpectralPitchShifter.h"
 #include "../../Utils/Constants.h"
 
 namespace omega {
 
-/**
- * @class PitchDetector
- * @brief High-performance pitch detection using YIN algorithm
- */
-class PitchDetector {
-public:
-    PitchDetector();
-    ~PitchDetector() = default;
-
-    /**
-     * Initialize pitch detector with sample rate
-     * @param sampleRate Audio sample rate
-     * @param bufferSize Analysis buffer size (power of 2)
-     */
-    void initialize(double sampleRate, int bufferSize);
-
-    /**
-     * Detect pitch from audio buffer (RT-safe)
-     * @param buffer Audio samples
-     * @param numSamples Number of samples to analyze
-     * @return Detected frequency in Hz (0.0 if no pitch detected)
-     */
-    float detectPitch(const float* buffer, int numSamples);
-
-    /**
-     * Get confidence level of last detection
-     * @return Confidence (0.0 = no confidence, 1.0 = high confidence)
-     */
-    float getConfidence() const noexcept { return m_confidence; }
-
-private:
-    // YIN algorithm implementation
-    void calculateDifference(const float* buffer, int numSamples);
-    void cumulativeMeanNormalizedDifference();
-    int absoluteThreshold(float threshold);
-    float parabolicInterpolation(int tauEstimate);
-
-    std::vector<float> m_yinBuffer;
-    double m_sampleRate = 48000.0;
-    int m_bufferSize = 2048;
-    float m_confidence = 0.0f;
-    
-    static constexpr float kDefaultThreshold = 0.15f;
-};
-
-/**
- * @class PhaseVocoder
- * @brief Phase vocoder for pitch shifting without time stretching
- */
-class PhaseVocoder {
-public:
-    PhaseVocoder();
-    ~PhaseVocoder() = default;
-
-    /**
-     * Initialize phase vocoder
-     * @param sampleRate Audio sample rate
-     * @param fftSize FFT size (must be power of 2)
-     * @param hopSize Hop size for overlap-add
-     */
-    void initialize(double sampleRate, int fftSize, int hopSize);
-
-    /**
-     * Process audio with pitch shifting (RT-safe)
-     * @param inputBuffer Input audio
-     * @param outputBuffer Output audio
-     * @param numSamples Number of samples to process
-     * @param pitchRatio Pitch shift ratio (2.0 = +1 octave)
-     */
-    void process(const float* inputBuffer, float* outputBuffer, 
-                 int numSamples, float pitchRatio);
-
-    /**
-     * Reset internal state
-     */
-    void reset();
-
-private:
-    void processFrame();
-    void applyWindow(float* buffer, int size);
-    
-    std::unique_ptr<juce::dsp::FFT> m_fft;
-    std::vector<float> m_inputBuffer;
-    std::vector<float> m_outputBuffer;
-    std::vector<float> m_windowBuffer;
-    std::vector<std::complex<float>> m_fftBuffer;
-    std::vector<float> m_lastPhase;
-    std::vector<float> m_sumPhase;
-    
-    double m_sampleRate = 48000.0;
-    int m_fftSize = 2048;
-    int m_hopSize = 512;
-    int m_inputPos = 0;
-    int m_outputPos = 0;
-};
-
 /**
  * @class PitchCorrection
  * @brief Complete auto-tune effect processor
  * 
  * Features:
- * - Real-time pitch detection (YIN algorithm)
+ * - Real-time pitch detection (shared PitchTracker, FFT-based YIN)
  * - Smooth pitch correction with configurable strength
  * - Musical scale quantization (Chromatic, Major, Minor, etc.)
  * - Formant preservation
@@ -261,10 +165,22 @@ public:
      * Get detection confidence
      * @return Confidence level (0.0 to 1.0)
      */
-    float getConfidence() const noexcept { return m_pitchDetector.getConfidence(); }
+    float getConfidence() const noexcept { return m_pitchTracker.getEstimate().confidence; }
+
+    /**
+     * Check if the last analysis frame was voiced
+     */
+    bool isVoiced() const noexcept { return m_pitchTracker.getEstimate().voiced; }
+
+    /**
+     * Processing latency (PDC). Unvoiced input runs through the shifter at
+     * ratio 1, so the delay never changes while the mode is not Off
+     */
+    int getLatencySamples() const noexcept { return m_shifters[0].getLatencySamples(); }
 
 private:
     // Helper functions
+    void applyCorrection(int channel, float* buffer, int numSamples, float pitchRatio);
     void updateScaleNotes();
     float quantizePitch(float detectedFreq);
     float frequencyToMidi(float freq) const noexcept;
@@ -273,8 +189,8 @@ private:
     float calculatePitchRatio(float currentFreq, float targetFreq) const noexcept;
 
     // Processing components
-    PitchDetector m_pitchDetector;
-    PhaseVocoder m_phaseVocoder;
+    PitchTracker m_pitchTracker;
+    std::array<SpectralPitchShifter, 2> m_shifters;    // Left, right
 
     // Parameters
     float m_strength = 0.5f;        // Correction strength
@@ -0,0 +1,210 @@
+/**
+ * @file PitchTracker.cpp
+ * @brief Implementation of the shared streaming pitch tracker
+ */
+
+#include "PitchTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace omega {
+
+// ============================================================================
+// PitchTracker Implementation
+// ============================================================================
+
+PitchTracker::PitchTracker() = default;
+PitchTracker::~PitchTracker() = default;
+
+void PitchTracker::initialize(double sampleRate) {
+    initialize(sampleRate, Settings());
+}
+
+void PitchTracker::initialize(double sampleRate, const Settings& settings) {
+    m_settings = settings;
+    m_sampleRate = sampleRate;
+
+    const float minFrequency = juce::jmax(20.0f, settings.minFrequency);
+    const float maxFrequency = juce::jlimit(minFrequency * 2.0f, static_cast<float>(sampleRate) * 0.25f,
+                                            settings.maxFrequency);
+
+    // The YIN window must hold the longest period plus the interpolation neighbour
+    const int longestLag = static_cast<int>(std::ceil(sampleRate / minFrequency));
+    m_windowSize = juce::nextPowerOfTwo(juce::jmax(64, longestLag + 2));
+    m_frameSize = m_windowSize * 2;
+    m_hopSize = juce::jlimit(32, m_windowSize, juce::nextPowerOfTwo(juce::jmax(1, settings.hopSize)));
+    m_numBlocks = m_frameSize / m_hopSize;
+
+    m_minLag = juce::jmax(2, static_cast<int>(std::floor(sampleRate / maxFrequency)));
+    m_maxLag = juce::jmin(m_windowSize - 2, longestLag);
+    m_silenceLevel = juce::Decibels::decibelsToGain(settings.silenceThreshold);
+
+    int order = 0;
+    while ((1 << order) < m_frameSize)
+        ++order;
+    m_fft = std::make_unique<juce::dsp::FFT>(order);
+
+    const int numBins = m_frameSize / 2 + 1;
+    m_history.assign(static_cast<size_t>(m_frameSize), 0.0f);
+    m_blockSpectra.assign(static_cast<size_t>(m_numBlocks * numBins * 2), 0.0f);
+    m_crossSpectrum.assign(static_cast<size_t>(numBins * 2), 0.0f);
+    m_fftBuffer.assign(static_cast<size_t>(m_frameSize * 2), 0.0f);
+    m_energy.assign(static_cast<size_t>(m_frameSize + 1), 0.0);
+    m_yinBuffer.assign(static_cast<size_t>(m_windowSize), 0.0f);
+
+    // Block spectra are computed at offset 0: shift each one to its position
+    // in the frame, exp(-j 2pi k p hop / N)
+    m_twiddles.resize(static_cast<size_t>(m_numBlocks * numBins * 2));
+    for (int position = 0; position < m_numBlocks; ++position) {
+        float* twiddle = m_twiddles.data() + position * numBins * 2;
+        for (int k = 0; k < numBins; ++k) {
+            const double angle = -2.0 * juce::MathConstants<double>::pi
+                               * static_cast<double>(k) * position * m_hopSize / m_frameSize;
+            twiddle[2 * k] = static_cast<float>(std::cos(angle));
+            twiddle[2 * k + 1] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    reset();
+}
+
+void PitchTracker::reset() {
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    std::fill(m_blockSpectra.begin(), m_blockSpectra.end(), 0.0f);
+    m_newestBlock = 0;
+    m_hopFill = 0;
+    m_estimate = {};
+}
+
+void PitchTracker::analyseHop() {
+    const int numBins = m_frameSize / 2 + 1;
+
+    // Transform only the block that just completed; the older blocks of the
+    // frame keep their spectra from previous hops
+    m_newestBlock = (m_newestBlock + 1) % m_numBlocks;
+    std::fill(m_fftBuffer.begin(), m_fftBuffer.end(), 0.0f);
+    std::copy(m_history.end() - m_hopSize, m_history.end(), m_fftBuffer.begin());
+    m_fft->performRealOnlyForwardTransform(m_fftBuffer.data(), true);
+    std::copy(m_fftBuffer.begin(), m_fftBuffer.begin() + numBins * 2,
+              m_blockSpectra.begin() + m_newestBlock * numBins * 2);
+
+    analyseFrame();
+
+    // Make room for the next hop
+    std::copy(m_history.begin() + m_hopSize, m_history.end(), m_history.begin());
+    m_hopFill = 0;
+}
+
+void PitchTracker::analyseFrame() {
+    // Prefix sums of squares: energy terms of the difference function
+    m_energy[0] = 0.0;
+    for (int i = 0; i < m_frameSize; ++i)
+        m_energy[i + 1] = m_energy[i] + static_cast<double>(m_history[i]) * m_history[i];
+
+    const float rms = static_cast<float>(std::sqrt(m_energy[m_frameSize] / m_frameSize));
+    const bool wasVoiced = m_estimate.voiced;
+    m_estimate = {};
+    m_estimate.rms = rms;
+
+    if (rms < m_silenceLevel)
+        return;
+
+    computeDifference();
+    cumulativeMeanNormalizedDifference();
+
+    const int tauEstimate = absoluteThreshold();
+    const float betterTau = parabolicInterpolation(tauEstimate);
+
+    m_estimate.confidence = juce::jlimit(0.0f, 1.0f, 1.0f - m_yinBuffer[tauEstimate]);
+    m_estimate.frequency = static_cast<float>(m_sampleRate) / betterTau;
+
+    const float voicingThreshold = wasVoiced ? m_settings.voicingThreshold - m_settings.voicingHysteresis
+                                             : m_settings.voicingThreshold;
+    m_estimate.voiced = m_estimate.confidence >= voicingThreshold
+                     && m_estimate.frequency >= m_settings.minFrequency
+                     && m_estimate.frequency <= m_settings.maxFrequency;
+}
+
+void PitchTracker::computeDifference() {
+    // d(tau) = sum_{j<W} (x_j - x_{j+tau})^2 = e(0) + e(tau) - 2 r(tau), with
+    // r(tau) = sum_{j<W} x_j x_{j+tau} the cross-correlation of the first W
+    // samples with the whole frame: r = IFFT(conj(A) X). A and X are sums of
+    // the shifted block spectra; no wrap-around since j + tau < N
+    const int numBins = m_frameSize / 2 + 1;
+    const int windowBlocks = m_windowSize / m_hopSize;
+
+    float* a = m_crossSpectrum.data();
+    float* x = m_fftBuffer.data();
+    std::fill(m_crossSpectrum.begin(), m_crossSpectrum.end(), 0.0f);
+    std::fill(m_fftBuffer.begin(), m_fftBuffer.end(), 0.0f);
+
+    for (int position = 0; position < m_numBlocks; ++position) {
+        const int slot = (m_newestBlock + 1 + position) % m_numBlocks;
+        const float* block = m_blockSpectra.data() + slot * numBins * 2;
+        const float* twiddle = m_twiddles.data() + position * numBins * 2;
+        float* destination = position < windowBlocks ? a : x;
+
+        for (int k = 0; k < numBins; ++k) {
+            const float br = block[2 * k], bi = block[2 * k + 1];
+            const float tr = twiddle[2 * k], ti = twiddle[2 * k + 1];
+            destination[2 * k] += tr * br - ti * bi;
+            destination[2 * k + 1] += tr * bi + ti * br;
+        }
+    }
+
+    for (int k = 0; k < numBins; ++k) {
+        const float ar = a[2 * k], ai = a[2 * k + 1];
+        const float xr = x[2 * k] + ar, xi = x[2 * k + 1] + ai;
+        x[2 * k] = ar * xr + ai * xi;
+        x[2 * k + 1] = ar * xi - ai * xr;
+    }
+
+    m_fft->performRealOnlyInverseTransform(m_fftBuffer.data());
+
+    const double energy0 = m_energy[m_windowSize];
+    const int numLags = juce::jmin(m_windowSize, m_maxLag + 2);
+    for (int tau = 0; tau < numLags; ++tau) {
+        const double energyTau = m_energy[tau + m_windowSize] - m_energy[tau];
+        m_yinBuffer[tau] = juce::jmax(0.0f, static_cast<float>(energy0 + energyTau - 2.0 * m_fftBuffer[tau]));
+    }
+}
+
+void PitchTracker::cumulativeMeanNormalizedDifference() {
+    const int numLags = juce::jmin(m_windowSize, m_maxLag + 2);
+    m_yinBuffer[0] = 1.0f;
+    float runningSum = 0.0f;
+
+    for (int tau = 1; tau < numLags; ++tau) {
+        runningSum += m_yinBuffer[tau];
+        m_yinBuffer[tau] = runningSum > 0.0f ? m_yinBuffer[tau] * tau / runningSum : 1.0f;
+    }
+}
+
+int PitchTracker::absoluteThreshold() const {
+    // First dip below the threshold, followed down to its local minimum
+    for (int tau = m_minLag; tau <= m_maxLag; ++tau) {
+        if (m_yinBuffer[tau] < m_settings.threshold) {
+            while (tau + 1 <= m_maxLag && m_yinBuffer[tau + 1] < m_yinBuffer[tau])
+                ++tau;
+            return tau;
+        }
+    }
+
+    // None: best candidate, its confidence decides the voicing
+    return static_cast<int>(std::min_element(m_yinBuffer.begin() + m_minLag,
+                                             m_yinBuffer.begin() + m_maxLag + 1) - m_yinBuffer.begin());
+}
+
+float PitchTracker::parabolicInterpolation(int tauEstimate) const {
+    const float s0 = m_yinBuffer[tauEstimate - 1];
+    const float s1 = m_yinBuffer[tauEstimate];
+    const float s2 = m_yinBuffer[tauEstimate + 1];
+    const float denominator = 2.0f * (2.0f * s1 - s2 - s0);
+
+    if (std::abs(denominator) < 1.0e-9f)
+        return static_cast<float>(tauEstimate);
+
+    return static_cast<float>(tauEstimate) + juce::jlimit(-0.5f, 0.5f, (s2 - s0) / denominator);
+}
+
+} // namespace omega
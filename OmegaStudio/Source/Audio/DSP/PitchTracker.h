@@ -0,0 +1,147 @@
+/**
+ * @file PitchTracker.h
+ * @brief Shared streaming pitch tracker (FFT-based YIN)
+ *
+ * One pitch tracking module for every pitch consumer (PitchCorrection,
+ * VocalHarmonizer, AIVocalTuner, AudioToMidi, SliceToMIDI):
+ * - YIN difference function from an FFT cross-correlation, O(N log N)
+ *   instead of the O(N^2) double loop
+ * - Incremental hop: each hop block is transformed once and its spectrum is
+ *   reused by every overlapping frame that contains it
+ * - Common result: frequency, confidence and a voicing decision with hysteresis
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+namespace omega {
+
+/**
+ * @struct PitchEstimate
+ * @brief Result of one analysis frame
+ */
+struct PitchEstimate {
+    float frequency = 0.0f;     // Hz (0.0 if nothing was found)
+    float confidence = 0.0f;    // 1 - normalized YIN difference (0.0 to 1.0)
+    float rms = 0.0f;           // Frame level
+    bool voiced = false;        // Voicing decision (confidence, level and range)
+};
+
+/**
+ * @class PitchTracker
+ * @brief Streaming YIN pitch tracker with FFT difference function
+ *
+ * Analyses the last getFrameSize() samples every getHopSize() samples.
+ * The frame is split into hop blocks; each block spectrum is computed once
+ * when the block is complete and combined with the cached spectra of the
+ * older blocks, so a frame costs one forward and one inverse FFT regardless
+ * of the overlap. RT-safe after initialize().
+ */
+class PitchTracker {
+public:
+    struct Settings {
+        float minFrequency = 60.0f;         // Lowest detectable pitch (sets frame size)
+        float maxFrequency = 1500.0f;       // Highest detectable pitch
+        int hopSize = 512;                  // Rounded to a power of 2 dividing the YIN window
+        float threshold = 0.15f;            // YIN absolute threshold
+        float voicingThreshold = 0.7f;      // Minimum confidence for voiced frames
+        float voicingHysteresis = 0.1f;     // Confidence drop tolerated while voiced
+        float silenceThreshold = -60.0f;    // dBFS RMS below which frames are unvoiced
+    };
+
+    PitchTracker();
+    ~PitchTracker();
+
+    /**
+     * Initialize tracker (allocates)
+     * @param sampleRate Audio sample rate
+     * @param settings Frequency range, hop and voicing parameters
+     */
+    void initialize(double sampleRate, const Settings& settings);
+    void initialize(double sampleRate);
+
+    /**
+     * Clear history and the last estimate
+     */
+    void reset();
+
+    /**
+     * Feed samples (RT-safe). A frame is analysed every time a hop completes
+     * @param samples Audio samples
+     * @param numSamples Number of samples
+     * @param onFrame Called as onFrame(const PitchEstimate&, int offset) per frame,
+     *                offset being the index in samples just after the frame's last sample
+     */
+    template <typename Callback>
+    void push(const float* samples, int numSamples, Callback&& onFrame) {
+        if (m_fft == nullptr)
+            return;
+
+        int offset = 0;
+        while (offset < numSamples) {
+            const int count = juce::jmin(numSamples - offset, m_hopSize - m_hopFill);
+            std::copy(samples + offset, samples + offset + count,
+                      m_history.begin() + (m_frameSize - m_hopSize + m_hopFill));
+            m_hopFill += count;
+            offset += count;
+
+            if (m_hopFill == m_hopSize) {
+                analyseHop();
+                onFrame(getEstimate(), offset);
+            }
+        }
+    }
+
+    void push(const float* samples, int numSamples) {
+        push(samples, numSamples, [](const PitchEstimate&, int) {});
+    }
+
+    /**
+     * Get the estimate of the most recent frame
+     */
+    const PitchEstimate& getEstimate() const noexcept { return m_estimate; }
+
+    int getFrameSize() const noexcept { return m_frameSize; }
+    int getHopSize() const noexcept { return m_hopSize; }
+    double getSampleRate() const noexcept { return m_sampleRate; }
+    const Settings& getSettings() const noexcept { return m_settings; }
+
+private:
+    void analyseHop();
+    void analyseFrame();
+    void computeDifference();
+    void cumulativeMeanNormalizedDifference();
+    int absoluteThreshold() const;
+    float parabolicInterpolation(int tauEstimate) const;
+
+    std::unique_ptr<juce::dsp::FFT> m_fft;
+
+    std::vector<float> m_history;       // Last frameSize samples (newest hop at the end)
+    std::vector<float> m_blockSpectra;  // Per hop block: bins 0..N/2, interleaved re/im
+    std::vector<float> m_twiddles;      // Per block position: shift to its offset in the frame
+    std::vector<float> m_crossSpectrum; // Spectrum of the YIN window (first W samples)
+    std::vector<float> m_fftBuffer;     // 2N floats
+    std::vector<double> m_energy;       // Prefix sums of squares over the frame
+    std::vector<float> m_yinBuffer;     // Difference / CMND, one value per lag
+
+    Settings m_settings;
+    double m_sampleRate = 48000.0;
+    int m_frameSize = 2048;             // N
+    int m_windowSize = 1024;            // YIN integration window W = N / 2
+    int m_hopSize = 512;
+    int m_numBlocks = 4;                // N / hop
+    int m_newestBlock = 0;              // Ring index of the newest block spectrum
+    int m_hopFill = 0;
+    int m_minLag = 32;
+    int m_maxLag = 800;
+    float m_silenceLevel = 0.001f;
+
+    PitchEstimate m_estimate;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchTracker)
+};
+
+} // namespace omega
@@ -4,9 +4,9 @@ namespace OmegaStudio {
 // Stub implementations - to be fully implemented
 
 ProReverbEffect::ProReverbEffect() { updateParameters(); }
-void ProReverbEffect::prepareToPlay(double sr, int) { sampleRate = sr; preDelayLine.prepare({sr, 512, 2}); preDelayLine.setMaximumDelayInSamples(static_cast<int>(sr * 0.5)); reverb.setSampleRate(sr); }
+void ProReverbEffect::prepareToPlay(double sr, int blockSize) { sampleRate = sr; preDelayLine.prepare({sr, 512, 2}); preDelayLine.setMaximumDelayInSamples(static_cast<int>(sr * 0.5)); reverb.setSampleRate(sr); wetBuffer.setSize(2, blockSize); convolution.prepare(sr, blockSize); if (impulseFile.existsAsFile()) loadImpulseResponse(impulseFile); }
 void ProReverbEffect::releaseResources() { preDelayLine.reset(); }
-void ProReverbEffect::process(juce::AudioBuffer<float>& buffer) { reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples()); }
+void ProReverbEffect::process(juce::AudioBuffer<float>& buffer) { if (mode == Mode::Convolution) { processConvolution(buffer); return; } reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples()); }
 void ProReverbEffect::setRoomSize(float size) { roomSize = size; updateParameters(); }
 void ProReverbEffect::setDamping(float damp) { damping = damp; updateParameters(); }
 void ProReverbEffect::setWetLevel(float wet) { wetLevel = wet; updateParameters(); }
@@ -15,6 +15,51 @@ void ProReverbEffect::setWidth(float w) { width = w; updateParameters(); }
 void ProReverbEffect::setPreDelay(float ms) { preDelayMs = ms; }
 void ProReverbEffect::updateParameters() { params.roomSize = roomSize; params.damping = damping; params.wetLevel = wetLevel; params.dryLevel = dryLevel; params.width = width; reverb.setParameters(params); }
 
+bool ProReverbEffect::loadImpulseResponse(const juce::File& file) {
+    // loadFile() cachea: N reverbs con el mismo archivo comparten los espectros
+    auto impulse = ConvolutionIR::loadFile(file, sampleRate);
+    if (impulse == nullptr)
+        return false;
+    impulseFile = file;
+    setImpulseResponse(std::move(impulse));
+    return true;
+}
+
+void ProReverbEffect::setImpulseResponse(std::shared_ptr<const ConvolutionIR> impulse) {
+    convolution.setImpulseResponse(std::move(impulse));
+    mode = Mode::Convolution;
+}
+
+void ProReverbEffect::processConvolution(juce::AudioBuffer<float>& buffer) {
+    const int numChannels = juce::jmin(2, buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels == 0)
+        return;
+
+    // Por trozos del tamaño de wetBuffer: sin reservas en el hilo de audio
+    for (int start = 0; start < numSamples;) {
+        const int chunk = juce::jmin(numSamples - start, wetBuffer.getNumSamples());
+        if (chunk <= 0)
+            return;
+
+        const float* inputs[2] = { buffer.getReadPointer(0, start), buffer.getReadPointer(numChannels - 1, start) };
+        convolution.process(inputs, numChannels, wetBuffer.getArrayOfWritePointers(), chunk);
+
+        // Mono: suma L + R de la salida húmeda
+        float wetGain = wetLevel;
+        if (numChannels == 1) {
+            wetBuffer.addFrom(0, 0, wetBuffer, 1, 0, chunk);
+            wetGain *= 0.5f;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            buffer.applyGain(ch, start, chunk, dryLevel);
+            buffer.addFrom(ch, start, wetBuffer, ch, 0, chunk, wetGain);
+        }
+        start += chunk;
+    }
+}
+
 ProDelayEffect::ProDelayEffect() {}
 void ProDelayEffect::prepareToPlay(double sr, int blockSize) { sampleRate = sr; juce::dsp::ProcessSpec spec{sr, static_cast<juce::uint32>(blockSize), 2}; delayLineLeft.prepare(spec); delayLineRight.prepare(spec); delayLineLeft.setMaximumDelayInSamples(static_cast<int>(sr * 2.0)); delayLineRight.setMaximumDelayInSamples(static_cast<int>(sr * 2.0)); }
 void ProDelayEffect::releaseResources() { delayLineLeft.reset(); delayLineRight.reset(); }
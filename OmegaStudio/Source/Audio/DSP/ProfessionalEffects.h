@@ -18,14 +18,17 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "ConvolutionEngine.h"
 #include <array>
 
 namespace OmegaStudio {
 
 //==============================================================================
-/** Reverb Profesional (Algorithmic) */
+/** Reverb Profesional (Algorithmic + Convolution) */
 class ProReverbEffect {
 public:
+    enum class Mode { Algorithmic, Convolution };
+    
     ProReverbEffect();
     
     void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock);
@@ -40,6 +43,12 @@ public:
     void setWidth(float width);           // 0-1
     void setPreDelay(float ms);           // 0-500ms
     
+    // Convolution (hilo de mensajes). IRs del mismo archivo se comparten entre instancias
+    void setMode(Mode newMode) { mode = newMode; }
+    Mode getMode() const { return mode; }
+    bool loadImpulseResponse(const juce::File& file);
+    void setImpulseResponse(std::shared_ptr<const ConvolutionIR> impulse);
+    
     float getRoomSize() const { return roomSize; }
     float getDamping() const { return damping; }
     float getWetLevel() const { return wetLevel; }
@@ -61,7 +70,13 @@ private:
     juce::dsp::DelayLine<float> preDelayLine;
     double sampleRate { 48000.0 };
     
+    std::atomic<Mode> mode { Mode::Algorithmic };
+    ConvolutionEngine convolution;
+    juce::AudioBuffer<float> wetBuffer;
+    juce::File impulseFile;
+    
     void updateParameters();
+    void processConvolution(juce::AudioBuffer<float>& buffer);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProReverbEffect)
 };
@@ -80,4 +80,74 @@ public:
     static void copy(float* dst, const float* src, size_t numSamples);
 };
 
+//==============================================================================
+// Vec4: 4-lane register (SSE / NEON / scalar) for kernels that keep one
+// channel or filter per lane, e.g. stereo LP/HP pairs or 4 biquad channels
+//==============================================================================
+#if defined(OMEGA_X86_SIMD)
+struct Vec4 {
+    __m128 v;
+    
+    static Vec4 load(const float* p) { return { _mm_loadu_ps(p) }; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    static Vec4 set(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+    static Vec4 set1(float x) { return { _mm_set1_ps(x) }; }
+    
+    // { a0, a1, b0, b1 } and { v2, v3, v2, v3 }
+    static Vec4 lowHalves(Vec4 a, Vec4 b) { return { _mm_movelh_ps(a.v, b.v) }; }
+    static Vec4 highHalf(Vec4 a) { return { _mm_movehl_ps(a.v, a.v) }; }
+    
+    friend Vec4 operator+ (Vec4 a, Vec4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    friend Vec4 operator- (Vec4 a, Vec4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    friend Vec4 operator* (Vec4 a, Vec4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+    
+    // (a > b) ? x : y per lane
+    static Vec4 selectGreater(Vec4 a, Vec4 b, Vec4 x, Vec4 y) {
+        const __m128 mask = _mm_cmpgt_ps(a.v, b.v);
+        return { _mm_or_ps(_mm_and_ps(mask, x.v), _mm_andnot_ps(mask, y.v)) };
+    }
+};
+#elif defined(OMEGA_ARM_NEON)
+struct Vec4 {
+    float32x4_t v;
+    
+    static Vec4 load(const float* p) { return { vld1q_f32(p) }; }
+    void store(float* p) const { vst1q_f32(p, v); }
+    static Vec4 set(float a, float b, float c, float d) { const float t[4] { a, b, c, d }; return { vld1q_f32(t) }; }
+    static Vec4 set1(float x) { return { vdupq_n_f32(x) }; }
+    
+    static Vec4 lowHalves(Vec4 a, Vec4 b) { return { vcombine_f32(vget_low_f32(a.v), vget_low_f32(b.v)) }; }
+    static Vec4 highHalf(Vec4 a) { return { vcombine_f32(vget_high_f32(a.v), vget_high_f32(a.v)) }; }
+    
+    friend Vec4 operator+ (Vec4 a, Vec4 b) { return { vaddq_f32(a.v, b.v) }; }
+    friend Vec4 operator- (Vec4 a, Vec4 b) { return { vsubq_f32(a.v, b.v) }; }
+    friend Vec4 operator* (Vec4 a, Vec4 b) { return { vmulq_f32(a.v, b.v) }; }
+    
+    static Vec4 selectGreater(Vec4 a, Vec4 b, Vec4 x, Vec4 y) { return { vbslq_f32(vcgtq_f32(a.v, b.v), x.v, y.v) }; }
+};
+#else
+struct Vec4 {
+    float v[4];
+    
+    static Vec4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    void store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+    static Vec4 set(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+    static Vec4 set1(float x) { return { { x, x, x, x } }; }
+    
+    static Vec4 lowHalves(Vec4 a, Vec4 b) { return { { a.v[0], a.v[1], b.v[0], b.v[1] } }; }
+    static Vec4 highHalf(Vec4 a) { return { { a.v[2], a.v[3], a.v[2], a.v[3] } }; }
+    
+    friend Vec4 operator+ (Vec4 a, Vec4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+    friend Vec4 operator- (Vec4 a, Vec4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+    friend Vec4 operator* (Vec4 a, Vec4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+    
+    static Vec4 selectGreater(Vec4 a, Vec4 b, Vec4 x, Vec4 y) {
+        Vec4 r;
+        for (int i = 0; i < 4; ++i)
+            r.v[i] = a.v[i] > b.v[i] ? x.v[i] : y.v[i];
+        return r;
+    }
+};
+#endif
+
 } // namespace Omega::Audio::DSP
@@ -1,19 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "../Graph/AudioNode.h"
+#include "DynamicsCore.h"
 #include <memory>
 #include <vector>
 
 namespace OmegaStudio {
 namespace Audio {
 
-// Forward declarations
-namespace Graph {
-    class AudioNode;
-    enum class NodeType;
-}
-
 namespace DSP {
 
 /**
@@ -41,15 +35,23 @@ public:
     
     void prepare(double sampleRate, int maxBlockSize) {
         sampleRate_ = sampleRate;
+        maxBlockSize_ = juce::jmax(1, maxBlockSize);
+        
+        // Scratch de un bloque: clave filtrada / envolvente y gain por sample
+        keyBuffer_.assign(static_cast<size_t>(maxBlockSize_), 0.0f);
+        gainBuffer_.assign(static_cast<size_t>(maxBlockSize_), 0.0f);
         
         // Ballistics coefficients
         updateCoefficients();
         
         // Sidechain filters
-        sidechainHPF_.setCoefficients(juce::IIRCoefficients::makeHighPass(sampleRate, 80.0f));
-        sidechainLPF_.setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, 12000.0f));
+        sidechainHPF_.setCoefficients(juce::IIRCoefficients::makeHighPass(sampleRate, params_.sidechainHPF));
+        sidechainLPF_.setCoefficients(juce::IIRCoefficients::makeLowPass(sampleRate, params_.sidechainLPF));
+        sidechainHPF_.reset();
+        sidechainLPF_.reset();
         
-        envelope_ = 0.0f;
+        follower_.reset();
+        envelope_ = -100.0f;
         gainReduction_ = 0.0f;
     }
     
@@ -71,6 +73,8 @@ public:
         
         const int numSamples = mainBuffer.getNumSamples();
         const int numChannels = mainBuffer.getNumChannels();
+        if (numChannels == 0 || keyBuffer_.empty())
+            return;
         
         // Determinar fuente de sidechain
         const juce::AudioBuffer<float>* scSource = 
@@ -78,54 +82,9 @@ public:
             ? sidechainBuffer 
             : &mainBuffer;
         
-        for (int sample = 0; sample < numSamples; ++sample) {
-            // 1. Calcular nivel del sidechain
-            float scLevel = calculateSidechainLevel(*scSource, sample);
-            
-            // 2. Aplicar filtros al sidechain
-            scLevel = sidechainHPF_.processSingleSampleRaw(scLevel);
-            scLevel = sidechainLPF_.processSingleSampleRaw(scLevel);
-            
-            // 3. Detector de envolvente
-            float scLevelDB = juce::Decibels::gainToDecibels(std::abs(scLevel) + 1e-6f);
-            
-            if (scLevelDB > envelope_) {
-                envelope_ += attackCoeff_ * (scLevelDB - envelope_);
-            } else {
-                envelope_ += releaseCoeff_ * (scLevelDB - envelope_);
-            }
-            
-            // 4. Calcular gain reduction
-            float gainReductionDB = 0.0f;
-            
-            if (envelope_ > params_.threshold) {
-                float overshoot = envelope_ - params_.threshold;
-                
-                // Soft knee
-                if (overshoot < params_.knee) {
-                    float kneeScale = overshoot / params_.knee;
-                    gainReductionDB = -overshoot * kneeScale * (1.0f - 1.0f / params_.ratio);
-                } else {
-                    gainReductionDB = -(overshoot - params_.knee * 0.5f) * (1.0f - 1.0f / params_.ratio);
-                }
-            }
-            
-            // Smooth gain reduction
-            gainReduction_ += (gainReductionDB - gainReduction_) * 0.1f;
-            
-            // 5. Calcular gain total
-            float makeupDB = params_.autoMakeup 
-                ? -gainReduction_ * 0.5f 
-                : params_.makeupGain;
-            
-            float totalGainDB = gainReduction_ + makeupDB;
-            float gain = juce::Decibels::decibelsToGain(totalGainDB);
-            
-            // 6. Aplicar ganancia a todas las canales
-            for (int ch = 0; ch < numChannels; ++ch) {
-                float* channelData = mainBuffer.getWritePointer(ch);
-                channelData[sample] *= gain;
-            }
+        for (int offset = 0; offset < numSamples; offset += maxBlockSize_) {
+            const int chunk = juce::jmin(maxBlockSize_, numSamples - offset);
+            processChunk(mainBuffer, *scSource, offset, chunk);
         }
     }
     
@@ -139,27 +98,55 @@ public:
     
 private:
     void updateCoefficients() {
-        attackCoeff_ = 1.0f - std::exp(-1.0f / (params_.attackMs * 0.001f * sampleRate_));
-        releaseCoeff_ = 1.0f - std::exp(-1.0f / (params_.releaseMs * 0.001f * sampleRate_));
+        follower_.setTimes(sampleRate_, params_.attackMs, params_.releaseMs);
+        
+        OmegaStudio::Dynamics::GainCurve::Parameters curve;
+        curve.threshold = params_.threshold;
+        curve.ratio = params_.ratio;
+        curve.knee = params_.knee;
+        curve.makeup = params_.autoMakeup ? OmegaStudio::Dynamics::GainCurve::autoMakeup(curve) : params_.makeupGain;
+        gainCurve_.setParameters(curve);
     }
     
-    float calculateSidechainLevel(const juce::AudioBuffer<float>& buffer, int sample) {
-        float level = 0.0f;
-        int numChannels = buffer.getNumChannels();
+    void processChunk(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuffer<float>& key,
+                      int offset, int numSamples) {
+        float* level = keyBuffer_.data();
+        float* gain = gainBuffer_.data();
         
-        for (int ch = 0; ch < numChannels; ++ch) {
-            level += std::abs(buffer.getSample(ch, sample));
-        }
+        // 1. Clave mono (media de canales), filtrada antes de rectificar
+        const int keyChannels = key.getNumChannels();
+        juce::FloatVectorOperations::copy(level, key.getReadPointer(0, offset), numSamples);
+        for (int ch = 1; ch < keyChannels; ++ch)
+            juce::FloatVectorOperations::add(level, key.getReadPointer(ch, offset), numSamples);
+        if (keyChannels > 1)
+            juce::FloatVectorOperations::multiply(level, 1.0f / static_cast<float>(keyChannels), numSamples);
         
-        return level / numChannels;
+        sidechainHPF_.processSamples(level, numSamples);
+        sidechainLPF_.processSamples(level, numSamples);
+        juce::FloatVectorOperations::abs(level, level, numSamples);
+        
+        // 2. Envolvente y curva de gain (tabla con knee y makeup)
+        follower_.process(level, level, numSamples);
+        gainCurve_.process(level, gain, numSamples);
+        
+        // 3. Gain a todos los canales, vectorizado
+        for (int ch = 0; ch < mainBuffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::multiply(mainBuffer.getWritePointer(ch, offset), gain, numSamples);
+        
+        envelope_ = OmegaStudio::Dynamics::gainToDecibels(follower_.getState());
+        gainReduction_ = OmegaStudio::Dynamics::gainToDecibels(gain[numSamples - 1]) - gainCurve_.getParameters().makeup;
     }
     
     Parameters params_;
     double sampleRate_ { 44100.0 };
+    int maxBlockSize_ { 0 };
+    
+    OmegaStudio::Dynamics::EnvelopeFollower follower_;
+    OmegaStudio::Dynamics::GainCurve gainCurve_;
+    std::vector<float> keyBuffer_;
+    std::vector<float> gainBuffer_;
     
-    float attackCoeff_ { 0.0f };
-    float releaseCoeff_ { 0.0f };
-    float envelope_ { 0.0f };
+    float envelope_ { -100.0f };
     float gainReduction_ { 0.0f };
     
     juce::IIRFilter sidechainHPF_;
@@ -261,19 +248,6 @@ private:
     std::vector<Connection> connections_;
 };
 
-/**
- * @class SidechainCompressorNode
- * @brief Nodo de audio con sidechain support
- * 
- * NOTE: This class is commented out temporarily to avoid forward declaration issues.
- * It can be uncommented when needed by including the full AudioNode header.
- */
-/*
-class SidechainCompressorNode : public OmegaStudio::Audio::Graph::AudioNode {
-    // Implementation available but commented to avoid compilation issues
-};
-*/
-
 /**
  * @class DuckingPreset
  * @brief Presets comunes de ducking
@@ -3,6 +3,8 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <memory>
+#include "OnsetDetector.h"
+#include "PitchTracker.h"
 
 namespace OmegaStudio {
 namespace Audio {
@@ -38,86 +40,21 @@ public:
     void setMinDistance(int samples) { minDistance_ = samples; }
     
     /**
-     * Detecta transientes en buffer de audio
+     * Detecta transientes con el OnsetDetector compartido (flujo espectral por
+     * bandas): onsets con fuerza relativa sobre el umbral, separados al menos
+     * minDistance samples, situados sobre el ataque
      */
     std::vector<int> detectTransients(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-        std::vector<int> transients;
-        
-        const int hopSize = 256;
-        const int numChannels = buffer.getNumChannels();
-        const int numSamples = buffer.getNumSamples();
-        
-        // Calculate spectral flux for transient detection
-        std::vector<float> flux;
-        std::vector<float> prevMagnitudes;
-        
-        juce::dsp::FFT fft(10);  // 1024-point FFT
-        const int fftSize = 1024;
-        std::vector<float> fftData(fftSize * 2, 0.0f);
-        
-        for (int pos = 0; pos < numSamples - fftSize; pos += hopSize) {
-            // Mix down to mono and apply window
-            std::fill(fftData.begin(), fftData.end(), 0.0f);
-            for (int ch = 0; ch < numChannels; ++ch) {
-                const float* data = buffer.getReadPointer(ch, pos);
-                for (int i = 0; i < fftSize; ++i) {
-                    float window = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * i / fftSize));
-                    fftData[i] += data[i] * window / numChannels;
-                }
-            }
-            
-            // Perform FFT
-            fft.performRealOnlyForwardTransform(fftData.data());
-            
-            // Calculate magnitudes
-            std::vector<float> magnitudes(fftSize / 2);
-            for (int i = 0; i < fftSize / 2; ++i) {
-                float real = fftData[i * 2];
-                float imag = fftData[i * 2 + 1];
-                magnitudes[i] = std::sqrt(real * real + imag * imag);
-            }
-            
-            // Calculate spectral flux
-            if (!prevMagnitudes.empty()) {
-                float fluxValue = 0.0f;
-                for (size_t i = 0; i < magnitudes.size(); ++i) {
-                    float diff = magnitudes[i] - prevMagnitudes[i];
-                    if (diff > 0.0f) {
-                        fluxValue += diff;
-                    }
-                }
-                flux.push_back(fluxValue);
-            } else {
-                flux.push_back(0.0f);
-            }
-            
-            prevMagnitudes = magnitudes;
+        if (sampleRate != detector_.getSampleRate() || !prepared_) {
+            detector_.initialize(sampleRate);
+            prepared_ = true;
         }
         
-        // Normalize flux
-        float maxFlux = *std::max_element(flux.begin(), flux.end());
-        if (maxFlux > 0.0f) {
-            for (auto& f : flux) {
-                f /= maxFlux;
-            }
-        }
-        
-        // Peak picking with threshold
-        updateThreshold();
-        int lastTransient = -minDistance_;
+        detector_.detect(buffer, onsets_);
         
-        for (size_t i = 1; i < flux.size() - 1; ++i) {
-            int samplePos = i * hopSize;
-            
-            if (flux[i] > threshold_ &&
-                flux[i] > flux[i - 1] &&
-                flux[i] > flux[i + 1] &&
-                samplePos - lastTransient >= minDistance_) {
-                
-                transients.push_back(samplePos);
-                lastTransient = samplePos;
-            }
-        }
+        std::vector<int> transients;
+        for (const auto& onset : onsets_.select(threshold_, (double) minDistance_))
+            transients.push_back((int) onset.getSample());
         
         return transients;
     }
@@ -128,6 +65,10 @@ private:
         threshold_ = 0.8f - (sensitivity_ * 0.6f);
     }
     
+    omega::OnsetDetector detector_;
+    omega::OnsetList onsets_;      // Reutilizado entre llamadas
+    bool prepared_ { false };
+    
     float sensitivity_ { 0.5f };
     float threshold_ { 0.5f };
     int minDistance_ { 4410 };  // ~100ms at 44.1kHz
@@ -140,42 +81,43 @@ private:
 class PitchDetector {
 public:
     /**
-     * Detecta pitch usando autocorrelación (YIN algorithm simplified)
+     * Detecta pitch con el PitchTracker compartido (YIN por FFT): nota del
+     * frame sonoro más fiable de los primeros 4096 samples
      */
     float detectPitch(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-        if (buffer.getNumSamples() < 2048) return 60.0f;  // Default middle C
-        
-        const float* data = buffer.getReadPointer(0);
-        const int numSamples = std::min(4096, buffer.getNumSamples());
-        
-        // Autocorrelation
-        std::vector<float> correlation(numSamples / 2);
-        
-        for (int tau = 0; tau < numSamples / 2; ++tau) {
-            float sum = 0.0f;
-            for (int i = 0; i < numSamples / 2; ++i) {
-                float diff = data[i] - data[i + tau];
-                sum += diff * diff;
-            }
-            correlation[tau] = sum;
+        if (sampleRate != tracker_.getSampleRate() || !prepared_) {
+            omega::PitchTracker::Settings settings;
+            settings.minFrequency = 50.0f;
+            settings.maxFrequency = 2000.0f;
+            tracker_.initialize(sampleRate, settings);
+            prepared_ = true;
         }
         
-        // Find minimum (best correlation)
-        int minLag = 20;  // ~2.2kHz at 44.1kHz
-        int maxLag = numSamples / 2 - 1;
+        if (buffer.getNumSamples() < tracker_.getFrameSize()) return 60.0f;  // Default middle C
         
-        auto minIt = std::min_element(correlation.begin() + minLag, 
-                                     correlation.begin() + maxLag);
-        int lag = std::distance(correlation.begin(), minIt);
+        const int numSamples = std::min(4096, buffer.getNumSamples());
         
-        // Convert lag to frequency
-        float frequency = sampleRate / lag;
+        tracker_.reset();
+        omega::PitchEstimate best;
+        tracker_.push(buffer.getReadPointer(0), numSamples,
+                      [&](const omega::PitchEstimate& estimate, int frameEnd) {
+            if (frameEnd >= tracker_.getFrameSize() && estimate.voiced
+                && estimate.confidence > best.confidence)
+                best = estimate;
+        });
+        
+        // Sin pitch claro (percusión, ruido): nota por defecto
+        if (!best.voiced) return 60.0f;
         
         // Convert to MIDI note
-        float midiNote = 69.0f + 12.0f * std::log2(frequency / 440.0f);
+        float midiNote = 69.0f + 12.0f * std::log2(best.frequency / 440.0f);
         
         return juce::jlimit(0.0f, 127.0f, midiNote);
     }
+    
+private:
+    omega::PitchTracker tracker_;
+    bool prepared_ { false };
 };
 
 /**
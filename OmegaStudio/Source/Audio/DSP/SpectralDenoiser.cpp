@@ -0,0 +1,291 @@
+/**
+ * @file SpectralDenoiser.cpp
+ * @brief Implementation of the streaming spectral denoiser
+ */
+
+#include "SpectralDenoiser.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace omega {
+
+namespace {
+
+constexpr float kTwoPi = juce::MathConstants<float>::twoPi;
+
+constexpr double kPowerSmoothingSeconds = 0.05;
+constexpr double kGainReleaseSeconds = 0.03;
+constexpr double kPriorSmoothingSeconds = 0.1;
+constexpr double kMinimumSearchSeconds = 1.5;   // Longest stretch of signal without a noise-only moment
+constexpr float kMinimumBias = 1.5f;            // The minimum of smoothed power underestimates the mean
+
+inline float perHop(double seconds, int hopSize, double sampleRate) {
+    return static_cast<float>(std::exp(-static_cast<double>(hopSize) / (seconds * sampleRate)));
+}
+
+} // namespace
+
+// ============================================================================
+// SpectralDenoiser Implementation
+// ============================================================================
+
+SpectralDenoiser::SpectralDenoiser() = default;
+SpectralDenoiser::~SpectralDenoiser() = default;
+
+int SpectralDenoiser::fftSizeForDuration(double sampleRate, double seconds) {
+    return juce::jlimit(64, 8192, juce::nextPowerOfTwo(juce::jmax(1, juce::roundToInt(sampleRate * seconds))));
+}
+
+void SpectralDenoiser::prepare(double sampleRate, int maxChannels, int fftSize) {
+    m_sampleRate = sampleRate;
+    m_fftSize = juce::jlimit(64, 8192, juce::nextPowerOfTwo(juce::jmax(64, fftSize)));
+    m_hopSize = m_fftSize / 4;
+    m_numBins = m_fftSize / 2 + 1;
+
+    int order = 0;
+    while ((1 << order) < m_fftSize)
+        ++order;
+    m_fft = std::make_unique<juce::dsp::FFT>(order);
+
+    // Periodic Hann for analysis and synthesis: the squared windows overlap-add
+    // to 3/8 * N / hop
+    m_window.resize(static_cast<size_t>(m_fftSize));
+    for (int i = 0; i < m_fftSize; ++i)
+        m_window[static_cast<size_t>(i)] = 0.5f * (1.0f - std::cos(kTwoPi * static_cast<float>(i) / static_cast<float>(m_fftSize)));
+    m_outputGain = 1.0f / (0.375f * static_cast<float>(m_fftSize / m_hopSize));
+
+    m_powerSmoothing = perHop(kPowerSmoothingSeconds, m_hopSize, sampleRate);
+    m_gainRelease = perHop(kGainReleaseSeconds, m_hopSize, sampleRate);
+    m_priorSmoothing = perHop(kPriorSmoothingSeconds, m_hopSize, sampleRate);
+    m_subWindowFrames = juce::jmax(1, juce::roundToInt(kMinimumSearchSeconds * sampleRate
+                                                       / (kMinimumWindows * static_cast<double>(m_hopSize))));
+
+    const auto bins = static_cast<size_t>(m_numBins);
+    m_fftBuffer.assign(static_cast<size_t>(m_fftSize * 2), 0.0f);
+    m_power.assign(bins, 0.0f);
+
+    m_channels.resize(static_cast<size_t>(juce::jmax(1, maxChannels)));
+    for (auto& channel : m_channels) {
+        channel.history.assign(static_cast<size_t>(m_fftSize), 0.0f);
+        channel.accumulator.assign(static_cast<size_t>(m_fftSize), 0.0f);
+        channel.ready.assign(static_cast<size_t>(m_hopSize), 0.0f);
+        channel.smoothedPower.assign(bins, 0.0f);
+        channel.currentMinimum.assign(bins, 0.0f);
+        channel.minima.assign(bins * kMinimumWindows, 0.0f);
+        channel.noise.assign(bins, 0.0f);
+        channel.profile.assign(bins, 0.0f);
+        channel.learnSum.assign(bins, 0.0f);
+        channel.gain.assign(bins, 1.0f);
+        channel.prior.assign(bins, 0.0f);
+        channel.hasEstimate = false;
+    }
+
+    // A profile learned at another frame size does not apply
+    m_hasProfile.store(false);
+    m_learning = false;
+    reset();
+}
+
+void SpectralDenoiser::reset() {
+    for (auto& channel : m_channels) {
+        std::fill(channel.history.begin(), channel.history.end(), 0.0f);
+        std::fill(channel.accumulator.begin(), channel.accumulator.end(), 0.0f);
+        std::fill(channel.ready.begin(), channel.ready.end(), 0.0f);
+        std::fill(channel.gain.begin(), channel.gain.end(), 1.0f);
+        std::fill(channel.prior.begin(), channel.prior.end(), 0.0f);
+        if (!m_hasProfile.load())
+            channel.hasEstimate = false;
+        else
+            seedNoise(channel);
+    }
+    m_hopFill = 0;
+    m_subWindowFill = 0;
+}
+
+void SpectralDenoiser::process(float* const* channels, int numChannels, int numSamples, bool bypass) {
+    if (m_fft == nullptr)
+        return;
+
+    numChannels = juce::jmin(numChannels, static_cast<int>(m_channels.size()));
+
+    int offset = 0;
+    while (offset < numSamples) {
+        const int count = juce::jmin(numSamples - offset, m_hopSize - m_hopFill);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto& channel = m_channels[static_cast<size_t>(ch)];
+            float* data = channels[ch] + offset;
+
+            // Input first: the output overwrites it in place
+            std::copy(data, data + count, channel.history.begin() + (m_fftSize - m_hopSize + m_hopFill));
+            std::copy(channel.ready.begin() + m_hopFill, channel.ready.begin() + m_hopFill + count, data);
+        }
+
+        m_hopFill += count;
+        offset += count;
+
+        if (m_hopFill == m_hopSize) {
+            updateLearning();
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto& channel = m_channels[static_cast<size_t>(ch)];
+                processHop(channel, bypass);
+                std::copy(channel.history.begin() + m_hopSize, channel.history.end(), channel.history.begin());
+            }
+
+            if (m_learning)
+                ++m_learnFrames;
+
+            // Rotate the minimum search: the oldest sub-window drops out
+            if (++m_subWindowFill == m_subWindowFrames) {
+                const auto bins = static_cast<size_t>(m_numBins);
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    auto& channel = m_channels[static_cast<size_t>(ch)];
+                    std::copy(channel.currentMinimum.begin(), channel.currentMinimum.end(),
+                              channel.minima.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(m_minimumSlot) * bins));
+                    std::copy(channel.smoothedPower.begin(), channel.smoothedPower.end(), channel.currentMinimum.begin());
+                }
+                m_minimumSlot = (m_minimumSlot + 1) % kMinimumWindows;
+                m_subWindowFill = 0;
+            }
+
+            m_hopFill = 0;
+        }
+    }
+}
+
+void SpectralDenoiser::updateLearning() {
+    if (m_clearRequested.exchange(false)) {
+        m_hasProfile.store(false);
+        for (auto& channel : m_channels)
+            channel.hasEstimate = false;
+    }
+
+    const bool learn = m_learnRequested.load();
+    if (learn && !m_learning) {
+        for (auto& channel : m_channels)
+            std::fill(channel.learnSum.begin(), channel.learnSum.end(), 0.0f);
+        m_learnFrames = 0;
+        m_learning = true;
+    } else if (!learn && m_learning) {
+        m_learning = false;
+        if (m_learnFrames > 0) {
+            const float scale = 1.0f / static_cast<float>(m_learnFrames);
+            for (auto& channel : m_channels) {
+                for (int k = 0; k < m_numBins; ++k)
+                    channel.profile[static_cast<size_t>(k)] = channel.learnSum[static_cast<size_t>(k)] * scale;
+                seedNoise(channel);
+            }
+            m_hasProfile.store(true);
+        }
+    }
+}
+
+void SpectralDenoiser::seedNoise(Channel& channel) {
+    // The tracker starts from the profile: minima stay at it until the
+    // search window has seen quieter audio
+    const float* profile = channel.profile.data();
+    std::copy(channel.profile.begin(), channel.profile.end(), channel.noise.begin());
+    for (int k = 0; k < m_numBins; ++k) {
+        const float minimum = profile[k] / kMinimumBias;
+        channel.smoothedPower[static_cast<size_t>(k)] = profile[k];
+        channel.currentMinimum[static_cast<size_t>(k)] = minimum;
+        for (int w = 0; w < kMinimumWindows; ++w)
+            channel.minima[static_cast<size_t>(w * m_numBins + k)] = minimum;
+    }
+    channel.hasEstimate = true;
+}
+
+void SpectralDenoiser::trackNoise(Channel& channel) {
+    const float* power = m_power.data();
+    float* smoothed = channel.smoothedPower.data();
+    float* current = channel.currentMinimum.data();
+    float* noise = channel.noise.data();
+
+    if (!channel.hasEstimate) {
+        std::copy(m_power.begin(), m_power.end(), channel.smoothedPower.begin());
+        std::copy(m_power.begin(), m_power.end(), channel.currentMinimum.begin());
+        std::fill(channel.minima.begin(), channel.minima.end(), std::numeric_limits<float>::max());
+        channel.hasEstimate = true;
+    }
+
+    const float a = m_powerSmoothing;
+    for (int k = 0; k < m_numBins; ++k) {
+        smoothed[k] = a * smoothed[k] + (1.0f - a) * power[k];
+        current[k] = std::min(current[k], smoothed[k]);
+        noise[k] = current[k];
+    }
+
+    for (int w = 0; w < kMinimumWindows; ++w) {
+        const float* minimum = channel.minima.data() + static_cast<size_t>(w * m_numBins);
+        for (int k = 0; k < m_numBins; ++k)
+            noise[k] = std::min(noise[k], minimum[k]);
+    }
+
+    for (int k = 0; k < m_numBins; ++k)
+        noise[k] *= kMinimumBias;
+}
+
+void SpectralDenoiser::processHop(Channel& channel, bool bypass) {
+    float* buffer = m_fftBuffer.data();
+    for (int i = 0; i < m_fftSize; ++i)
+        buffer[i] = channel.history[static_cast<size_t>(i)] * m_window[static_cast<size_t>(i)];
+
+    m_fft->performRealOnlyForwardTransform(buffer, true);
+
+    float* power = m_power.data();
+    for (int k = 0; k < m_numBins; ++k)
+        power[k] = buffer[2 * k] * buffer[2 * k] + buffer[2 * k + 1] * buffer[2 * k + 1];
+
+    if (m_learning) {
+        float* sum = channel.learnSum.data();
+        for (int k = 0; k < m_numBins; ++k)
+            sum[k] += power[k];
+    } else if (m_params.adaptive) {
+        trackNoise(channel);
+    }
+
+    float* gain = channel.gain.data();
+    const float reduction = juce::jlimit(0.0f, 1.0f, m_params.reduction);
+
+    if (bypass || !channel.hasEstimate || reduction <= 0.0f) {
+        // Unity: gains restart open, so re-enabling fades in
+        std::fill(channel.gain.begin(), channel.gain.end(), 1.0f);
+        std::fill(channel.prior.begin(), channel.prior.end(), 0.0f);
+    } else {
+        // Decision-directed Wiener gain: the a priori SNR blends last hop's
+        // clean estimate with this hop's excess power, which keeps isolated
+        // noise peaks from opening the gain (musical noise)
+        const float floorGain = juce::Decibels::decibelsToGain(-reduction * kMaxAttenuationDb);
+        const float a = m_priorSmoothing;
+        const float release = m_gainRelease;
+        const bool instantAttack = m_params.preserveTransients;
+        const float* noise = channel.noise.data();
+        float* prior = channel.prior.data();
+
+        for (int k = 0; k < m_numBins; ++k) {
+            const float snr = power[k] / std::max(noise[k], 1.0e-20f);
+            const float xi = a * prior[k] + (1.0f - a) * std::max(snr - 1.0f, 0.0f);
+            const float target = std::max(floorGain, xi / (1.0f + xi));
+            const float smoothed = release * gain[k] + (1.0f - release) * target;
+            gain[k] = instantAttack && target > gain[k] ? target : smoothed;
+            prior[k] = gain[k] * gain[k] * snr;
+            buffer[2 * k] *= gain[k];
+            buffer[2 * k + 1] *= gain[k];
+        }
+    }
+
+    m_fft->performRealOnlyInverseTransform(buffer);
+
+    float* accumulator = channel.accumulator.data();
+    for (int i = 0; i < m_fftSize; ++i)
+        accumulator[i] += buffer[i] * m_window[static_cast<size_t>(i)] * m_outputGain;
+
+    // The oldest hop has all its overlapping frames: emit it during the next hop
+    std::copy(channel.accumulator.begin(), channel.accumulator.begin() + m_hopSize, channel.ready.begin());
+    std::copy(channel.accumulator.begin() + m_hopSize, channel.accumulator.end(), channel.accumulator.begin());
+    std::fill(channel.accumulator.end() - m_hopSize, channel.accumulator.end(), 0.0f);
+}
+
+} // namespace omega
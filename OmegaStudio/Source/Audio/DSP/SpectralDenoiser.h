@@ -0,0 +1,133 @@
+/**
+ * @file SpectralDenoiser.h
+ * @brief Streaming STFT noise reduction shared by live inserts and offline cleanup
+ *
+ * - Short-hop STFT (Hann analysis and synthesis, 75% overlap): the
+ *   algorithmic latency is one FFT frame and is reported for PDC
+ * - Noise profile per channel, either tracked continuously (minimum of the
+ *   smoothed power over the last ~1.5 s) or learned from a marked region
+ * - Decision-directed Wiener gains (against musical noise) with a floor set
+ *   by the reduction amount; with preserveTransients the gains open
+ *   instantly and only close smoothly
+ * - Every buffer is allocated in prepare(): process() is RT-safe
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace omega {
+
+/**
+ * @class SpectralDenoiser
+ * @brief Multichannel streaming denoiser with bounded latency
+ *
+ * With reduction 0 (or bypassed) the gains are all 1 and the input is
+ * reproduced exactly, delayed by getLatencySamples().
+ */
+class SpectralDenoiser {
+public:
+    static constexpr float kMaxAttenuationDb = 30.0f;
+
+    struct Parameters {
+        float reduction = 0.8f;             // 0..1, attenuation floor 0..kMaxAttenuationDb
+        bool adaptive = true;               // Track the noise continuously (seeded by a learned profile)
+        bool preserveTransients = true;     // Gains rise at once, fall smoothed
+    };
+
+    SpectralDenoiser();
+    ~SpectralDenoiser();
+
+    /**
+     * Allocate for a channel count and frame size
+     * @param fftSize FFT size (power of 2); the hop is a quarter of it
+     */
+    void prepare(double sampleRate, int maxChannels, int fftSize = 512);
+
+    /** Clear the audio history; a learned profile is kept */
+    void reset();
+
+    /** FFT size whose frame lasts about the given time (latency budget) */
+    static int fftSizeForDuration(double sampleRate, double seconds);
+
+    void setParameters(const Parameters& params) noexcept { m_params = params; }
+    const Parameters& getParameters() const noexcept { return m_params; }
+
+    /**
+     * Learn region: while on, the input power is averaged into the profile;
+     * switching off commits it (thread-safe, applied at the next hop)
+     */
+    void setLearning(bool shouldLearn) noexcept { m_learnRequested.store(shouldLearn); }
+    bool isLearning() const noexcept { return m_learnRequested.load(); }
+    bool hasNoiseProfile() const noexcept { return m_hasProfile.load(); }
+    void clearNoiseProfile() noexcept { m_clearRequested.store(true); }
+
+    /**
+     * Process in place (RT-safe)
+     * @param bypass Unity gains (same latency, the noise tracking goes on)
+     */
+    void process(float* const* channels, int numChannels, int numSamples, bool bypass = false);
+    void process(juce::AudioBuffer<float>& buffer, bool bypass = false) {
+        process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(), bypass);
+    }
+
+    int getLatencySamples() const noexcept { return m_fftSize; }
+    int getFftSize() const noexcept { return m_fftSize; }
+    int getHopSize() const noexcept { return m_hopSize; }
+
+private:
+    struct Channel {
+        std::vector<float> history;         // Last fftSize samples (newest hop at the end)
+        std::vector<float> accumulator;     // Overlap-add, fftSize
+        std::vector<float> ready;           // Finished hop being emitted
+        std::vector<float> smoothedPower;   // Per bin, for the minimum tracker
+        std::vector<float> currentMinimum;  // Per bin, running sub-window
+        std::vector<float> minima;          // kMinimumWindows finished sub-windows x bins
+        std::vector<float> noise;           // Noise power per bin in use
+        std::vector<float> profile;         // Learned noise power per bin
+        std::vector<float> learnSum;        // Learn region power sum
+        std::vector<float> gain;            // Smoothed gain per bin
+        std::vector<float> prior;           // Last hop's clean-to-noise estimate per bin
+        bool hasEstimate = false;
+    };
+
+    static constexpr int kMinimumWindows = 6;
+
+    void processHop(Channel& channel, bool bypass);
+    void trackNoise(Channel& channel);
+    void seedNoise(Channel& channel);
+    void updateLearning();
+
+    std::unique_ptr<juce::dsp::FFT> m_fft;
+    std::vector<Channel> m_channels;
+    std::vector<float> m_window;
+    std::vector<float> m_fftBuffer;         // 2N floats
+    std::vector<float> m_power;             // Bins 0..N/2
+
+    Parameters m_params;
+    std::atomic<bool> m_learnRequested { false };
+    std::atomic<bool> m_clearRequested { false };
+    std::atomic<bool> m_hasProfile { false };
+    bool m_learning = false;
+    int m_learnFrames = 0;
+    int m_subWindowFrames = 1;              // Hops per minimum sub-window
+    int m_subWindowFill = 0;
+    int m_minimumSlot = 0;
+
+    double m_sampleRate = 48000.0;
+    int m_fftSize = 512;
+    int m_hopSize = 128;
+    int m_numBins = 257;
+    int m_hopFill = 0;
+    float m_outputGain = 1.0f;              // Inverse of the summed squared windows
+    float m_powerSmoothing = 0.0f;          // Per hop
+    float m_gainRelease = 0.0f;             // Per hop
+    float m_priorSmoothing = 0.0f;          // Per hop, decision-directed weight
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralDenoiser)
+};
+
+} // namespace omega
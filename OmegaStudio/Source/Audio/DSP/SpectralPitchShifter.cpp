@@ -0,0 +1,288 @@
+/**
+ * @file SpectralPitchShifter.cpp
+ * @brief Implementation of the shared multi-voice pitch shifter
+ */
+
+#include "SpectralPitchShifter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace omega {
+
+namespace {
+
+constexpr float kPi = juce::MathConstants<float>::pi;
+constexpr float kHalfPi = juce::MathConstants<float>::halfPi;
+constexpr float kTwoPi = juce::MathConstants<float>::twoPi;
+constexpr float kInvTwoPi = 1.0f / kTwoPi;
+
+// Branch-free atan2, error < 1e-5 rad (minimax polynomial of atan on [0, 1])
+inline float fastAtan2(float y, float x) {
+    const float ax = std::abs(x);
+    const float ay = std::abs(y);
+    const float a = std::min(ax, ay) / std::max(std::max(ax, ay), 1.0e-30f);
+    const float s = a * a;
+    float r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f
+                  + s * (0.05265332f + s * -0.01172120f)))));
+    r = ay > ax ? kHalfPi - r : r;
+    r = x < 0.0f ? kPi - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+// sin and cos of x in [-pi, pi]: folded to [-pi/2, pi/2], Taylor to x^12 (error < 1e-7)
+inline void fastSinCos(float x, float& sine, float& cosine) {
+    const bool upper = x > kHalfPi;
+    const bool lower = x < -kHalfPi;
+    const float y = upper ? kPi - x : (lower ? -kPi - x : x);
+    const float y2 = y * y;
+
+    sine = y * (1.0f + y2 * (-1.0f / 6.0f + y2 * (1.0f / 120.0f + y2 * (-1.0f / 5040.0f
+              + y2 * (1.0f / 362880.0f + y2 * (-1.0f / 39916800.0f))))));
+    const float c = 1.0f + y2 * (-0.5f + y2 * (1.0f / 24.0f + y2 * (-1.0f / 720.0f + y2 * (1.0f / 40320.0f
+                    + y2 * (-1.0f / 3628800.0f + y2 * (1.0f / 479001600.0f))))));
+    cosine = (upper || lower) ? -c : c;
+}
+
+// Wrap to [-pi, pi)
+inline float wrapPhase(float phase) {
+    return phase - kTwoPi * std::floor(phase * kInvTwoPi + 0.5f);
+}
+
+} // namespace
+
+// ============================================================================
+// SpectralPitchShifter Implementation
+// ============================================================================
+
+SpectralPitchShifter::SpectralPitchShifter() = default;
+SpectralPitchShifter::~SpectralPitchShifter() = default;
+
+void SpectralPitchShifter::initialize(double sampleRate, int numVoices, int fftSize, int hopSize) {
+    m_sampleRate = sampleRate;
+    m_numVoices = juce::jlimit(1, kMaxVoices, numVoices);
+    m_fftSize = juce::nextPowerOfTwo(juce::jmax(64, fftSize));
+    m_hopSize = juce::jlimit(8, m_fftSize / 4, juce::nextPowerOfTwo(juce::jmax(1, hopSize)));
+    m_numBins = m_fftSize / 2 + 1;
+
+    int order = 0;
+    while ((1 << order) < m_fftSize)
+        ++order;
+    m_fft = std::make_unique<juce::dsp::FFT>(order);
+
+    // Periodic Hann for analysis and synthesis: the squared windows overlap-add
+    // to 3/8 * N / hop
+    m_window.resize(static_cast<size_t>(m_fftSize));
+    for (int i = 0; i < m_fftSize; ++i)
+        m_window[static_cast<size_t>(i)] = 0.5f * (1.0f - std::cos(kTwoPi * static_cast<float>(i) / static_cast<float>(m_fftSize)));
+    m_outputGain = 1.0f / (0.375f * static_cast<float>(m_fftSize / m_hopSize));
+
+    const auto bins = static_cast<size_t>(m_numBins);
+    m_history.assign(static_cast<size_t>(m_fftSize), 0.0f);
+    m_fftBuffer.assign(static_cast<size_t>(m_fftSize * 2), 0.0f);
+    m_synthesisBuffer.assign(static_cast<size_t>(m_fftSize * 2), 0.0f);
+    m_magnitude.assign(bins, 0.0f);
+    m_phase.assign(bins, 0.0f);
+    m_lastPhase.assign(bins, 0.0f);
+    m_phaseAdvance.assign(bins, 0.0f);
+    m_peaks.assign(bins, 0);
+    m_regionStart.assign(bins, 0);
+    m_shiftedMagnitude.assign(bins, 0.0f);
+    m_shiftedPhase.assign(bins, 0.0f);
+
+    for (auto& voice : m_voices) {
+        voice.phase.assign(bins, 0.0f);
+        voice.accumulator.assign(static_cast<size_t>(m_fftSize), 0.0f);
+        voice.ready.assign(static_cast<size_t>(m_hopSize), 0.0f);
+    }
+
+    reset();
+}
+
+void SpectralPitchShifter::reset() {
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    std::fill(m_lastPhase.begin(), m_lastPhase.end(), 0.0f);
+    m_hopFill = 0;
+
+    for (auto& voice : m_voices)
+        voice.active = false;
+}
+
+void SpectralPitchShifter::setPitchRatio(int voice, float ratio) noexcept {
+    if (voice >= 0 && voice < kMaxVoices)
+        m_voices[static_cast<size_t>(voice)].ratio = juce::jlimit(0.25f, 4.0f, ratio);
+}
+
+float SpectralPitchShifter::getPitchRatio(int voice) const noexcept {
+    return voice >= 0 && voice < kMaxVoices ? m_voices[static_cast<size_t>(voice)].ratio : 1.0f;
+}
+
+void SpectralPitchShifter::process(const float* input, float* const* outputs, int numSamples) {
+    if (m_fft == nullptr)
+        return;
+
+    int offset = 0;
+    while (offset < numSamples) {
+        const int count = juce::jmin(numSamples - offset, m_hopSize - m_hopFill);
+
+        // Input first: an output aliasing the input is only written afterwards
+        std::copy(input + offset, input + offset + count,
+                  m_history.begin() + (m_fftSize - m_hopSize + m_hopFill));
+
+        for (int v = 0; v < m_numVoices; ++v) {
+            auto& voice = m_voices[static_cast<size_t>(v)];
+            if (outputs[v] == nullptr) {
+                voice.active = false;
+                continue;
+            }
+            if (!voice.active)
+                restart(voice);
+            std::copy(voice.ready.begin() + m_hopFill, voice.ready.begin() + m_hopFill + count, outputs[v] + offset);
+        }
+
+        m_hopFill += count;
+        offset += count;
+
+        if (m_hopFill == m_hopSize) {
+            analyse();
+            for (int v = 0; v < m_numVoices; ++v) {
+                if (m_voices[static_cast<size_t>(v)].active)
+                    synthesise(m_voices[static_cast<size_t>(v)]);
+            }
+
+            std::copy(m_history.begin() + m_hopSize, m_history.end(), m_history.begin());
+            m_hopFill = 0;
+        }
+    }
+}
+
+void SpectralPitchShifter::analyse() {
+    float* buffer = m_fftBuffer.data();
+    for (int i = 0; i < m_fftSize; ++i)
+        buffer[i] = m_history[static_cast<size_t>(i)] * m_window[static_cast<size_t>(i)];
+
+    m_fft->performRealOnlyForwardTransform(buffer, true);
+
+    float* magnitude = m_magnitude.data();
+    float* phase = m_phase.data();
+    for (int k = 0; k < m_numBins; ++k) {
+        const float re = buffer[2 * k];
+        const float im = buffer[2 * k + 1];
+        magnitude[k] = std::sqrt(re * re + im * im);
+        phase[k] = fastAtan2(im, re);
+    }
+
+    // Instantaneous frequency as the phase advance over one hop: the bin's own
+    // advance plus the wrapped deviation from it
+    const float binAdvance = kTwoPi * static_cast<float>(m_hopSize) / static_cast<float>(m_fftSize);
+    float* lastPhase = m_lastPhase.data();
+    float* advance = m_phaseAdvance.data();
+    for (int k = 0; k < m_numBins; ++k) {
+        const float expected = binAdvance * static_cast<float>(k);
+        advance[k] = expected + wrapPhase(phase[k] - lastPhase[k] - expected);
+        lastPhase[k] = phase[k];
+    }
+
+    // Peaks (local maxima over +-2 bins); each region runs from the magnitude
+    // minimum after the previous peak
+    m_numPeaks = 0;
+    for (int k = 2; k < m_numBins - 2; ++k) {
+        const float m = magnitude[k];
+        if (m > magnitude[k - 1] && m > magnitude[k - 2] && m >= magnitude[k + 1] && m >= magnitude[k + 2] && m > 0.0f)
+            m_peaks[static_cast<size_t>(m_numPeaks++)] = k;
+    }
+
+    for (int i = 0; i < m_numPeaks; ++i) {
+        if (i == 0) {
+            m_regionStart[0] = 0;
+            continue;
+        }
+        int lowest = m_peaks[static_cast<size_t>(i - 1)] + 1;
+        for (int k = lowest + 1; k < m_peaks[static_cast<size_t>(i)]; ++k) {
+            if (magnitude[k] < magnitude[lowest])
+                lowest = k;
+        }
+        m_regionStart[static_cast<size_t>(i)] = lowest;
+    }
+}
+
+void SpectralPitchShifter::synthesise(Voice& voice) {
+    float* buffer = m_synthesisBuffer.data();
+
+    if (voice.ratio == 1.0f) {
+        // Unshifted: the analysis spectrum as is (exact reconstruction)
+        std::copy(m_fftBuffer.begin(), m_fftBuffer.begin() + 2 * m_numBins, m_synthesisBuffer.begin());
+        std::copy(m_phase.begin(), m_phase.end(), voice.phase.begin());
+    } else {
+        // Each region moves rigidly to its peak's shifted bin. The peak phase
+        // advances by the shifted instantaneous frequency from the previous
+        // synthesis phase there; the rest of the region keeps its offset to
+        // the peak. Where regions overlap the stronger bin sets the phase
+        std::fill(m_shiftedMagnitude.begin(), m_shiftedMagnitude.end(), 0.0f);
+        std::copy(voice.phase.begin(), voice.phase.end(), m_shiftedPhase.begin());
+
+        const float ratio = voice.ratio;
+        const float invBinAdvance = static_cast<float>(m_fftSize) / (kTwoPi * static_cast<float>(m_hopSize));
+        const float* magnitude = m_magnitude.data();
+        const float* analysisPhase = m_phase.data();
+        float* shiftedMagnitude = m_shiftedMagnitude.data();
+        float* shiftedPhase = m_shiftedPhase.data();
+
+        for (int i = 0; i < m_numPeaks; ++i) {
+            // Shift by whole bins that best move the peak's true frequency
+            const int peak = m_peaks[static_cast<size_t>(i)];
+            const float frequency = m_phaseAdvance[static_cast<size_t>(peak)] * invBinAdvance;
+            const int shift = static_cast<int>(std::floor(frequency * (ratio - 1.0f) + 0.5f));
+            const int target = peak + shift;
+            if (target >= m_numBins)
+                break;
+            if (target < 0)
+                continue;
+
+            const float peakPhase = voice.phase[static_cast<size_t>(target)]
+                                  + m_phaseAdvance[static_cast<size_t>(peak)] * ratio - analysisPhase[peak];
+            const int regionEnd = i + 1 < m_numPeaks ? m_regionStart[static_cast<size_t>(i + 1)] : m_numBins;
+            const int first = juce::jmax(m_regionStart[static_cast<size_t>(i)], -shift);
+            const int last = juce::jmin(regionEnd, m_numBins - shift);
+
+            for (int k = first; k < last; ++k) {
+                const int t = k + shift;
+                if (magnitude[k] > shiftedMagnitude[t])
+                    shiftedPhase[t] = peakPhase + analysisPhase[k];
+                shiftedMagnitude[t] += magnitude[k];
+            }
+        }
+
+        float* phase = voice.phase.data();
+        for (int k = 0; k < m_numBins; ++k) {
+            const float p = wrapPhase(shiftedPhase[k]);
+            phase[k] = p;
+            float sine, cosine;
+            fastSinCos(p, sine, cosine);
+            buffer[2 * k] = shiftedMagnitude[k] * cosine;
+            buffer[2 * k + 1] = shiftedMagnitude[k] * sine;
+        }
+
+        buffer[1] = 0.0f;
+        buffer[2 * m_numBins - 1] = 0.0f;
+    }
+
+    m_fft->performRealOnlyInverseTransform(buffer);
+
+    float* accumulator = voice.accumulator.data();
+    for (int i = 0; i < m_fftSize; ++i)
+        accumulator[i] += buffer[i] * m_window[static_cast<size_t>(i)] * m_outputGain;
+
+    // The oldest hop has all its overlapping frames: emit it during the next hop
+    std::copy(voice.accumulator.begin(), voice.accumulator.begin() + m_hopSize, voice.ready.begin());
+    std::copy(voice.accumulator.begin() + m_hopSize, voice.accumulator.end(), voice.accumulator.begin());
+    std::fill(voice.accumulator.end() - m_hopSize, voice.accumulator.end(), 0.0f);
+}
+
+void SpectralPitchShifter::restart(Voice& voice) {
+    std::fill(voice.phase.begin(), voice.phase.end(), 0.0f);
+    std::fill(voice.accumulator.begin(), voice.accumulator.end(), 0.0f);
+    std::fill(voice.ready.begin(), voice.ready.end(), 0.0f);
+    voice.active = true;
+}
+
+} // namespace omega
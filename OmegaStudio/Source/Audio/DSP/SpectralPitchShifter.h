@@ -0,0 +1,127 @@
+/**
+ * @file SpectralPitchShifter.h
+ * @brief Shared STFT front end with multi-voice pitch-shift resynthesis
+ *
+ * One pitch shifting module for every pitch shifter (PitchCorrection,
+ * VocalHarmonizer, PremiumFX::PitchShifter):
+ * - One analysis per hop: window, forward FFT, magnitude, phase and the
+ *   instantaneous frequency of every bin, computed once for all voices
+ * - Branch-free approximations (atan2, sin/cos) in plain array loops so the
+ *   compiler vectorizes them, instead of atan2/sqrt/std::polar per bin
+ * - Peaks and their regions are also found once; each voice only moves every
+ *   region to its shifted peak (identity phase locking: the region keeps the
+ *   peak's phase relations), advances the peak phases and runs one inverse
+ *   FFT: N voices cost one analysis plus N syntheses
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace omega {
+
+/**
+ * @class SpectralPitchShifter
+ * @brief Streaming phase vocoder pitch shifter (no time stretching) with shared analysis
+ *
+ * Frames of getFftSize() samples are analysed every getHopSize() samples
+ * (Hann analysis and synthesis windows). A voice at ratio 1 resynthesises
+ * the analysis spectrum unchanged, so it reproduces the input exactly,
+ * delayed by getLatencySamples(). RT-safe after initialize().
+ */
+class SpectralPitchShifter {
+public:
+    static constexpr int kMaxVoices = 8;
+
+    SpectralPitchShifter();
+    ~SpectralPitchShifter();
+
+    /**
+     * Initialize shifter (allocates)
+     * @param sampleRate Audio sample rate
+     * @param numVoices Number of resynthesis voices (1 to kMaxVoices)
+     * @param fftSize FFT size (power of 2)
+     * @param hopSize Hop size (power of 2, fftSize / 4 or smaller)
+     */
+    void initialize(double sampleRate, int numVoices, int fftSize = 2048, int hopSize = 512);
+
+    /**
+     * Clear analysis history and every voice
+     */
+    void reset();
+
+    /**
+     * Set the pitch ratio of one voice (RT-safe, applied from the next hop)
+     * @param voice Voice index
+     * @param ratio Pitch shift ratio (2.0 = +1 octave), clamped to [0.25, 4]
+     */
+    void setPitchRatio(int voice, float ratio) noexcept;
+    float getPitchRatio(int voice) const noexcept;
+
+    /**
+     * Process audio (RT-safe)
+     * @param input Mono input
+     * @param outputs One buffer per voice; nullptr skips the voice (no synthesis
+     *                cost, its state restarts when it comes back). Outputs may
+     *                alias the input
+     * @param numSamples Number of samples
+     */
+    void process(const float* input, float* const* outputs, int numSamples);
+
+    /** Single voice convenience: voice 0 into output */
+    void process(const float* input, float* output, int numSamples) {
+        float* outputs[kMaxVoices] = { output };
+        process(input, outputs, numSamples);
+    }
+
+    int getLatencySamples() const noexcept { return m_fftSize; }
+    int getNumVoices() const noexcept { return m_numVoices; }
+    int getFftSize() const noexcept { return m_fftSize; }
+    int getHopSize() const noexcept { return m_hopSize; }
+
+private:
+    struct Voice {
+        float ratio = 1.0f;
+        bool active = false;
+        std::vector<float> phase;           // Synthesis phase per bin
+        std::vector<float> accumulator;     // Overlap-add, fftSize
+        std::vector<float> ready;           // Finished hop being emitted
+    };
+
+    void analyse();
+    void synthesise(Voice& voice);
+    void restart(Voice& voice);
+
+    std::unique_ptr<juce::dsp::FFT> m_fft;
+
+    std::vector<float> m_window;
+    std::vector<float> m_history;           // Last fftSize samples (newest hop at the end)
+    std::vector<float> m_fftBuffer;         // 2N floats, analysis
+    std::vector<float> m_synthesisBuffer;   // 2N floats, synthesis
+    std::vector<float> m_magnitude;         // Bins 0..N/2
+    std::vector<float> m_phase;
+    std::vector<float> m_lastPhase;
+    std::vector<float> m_phaseAdvance;      // Measured phase advance per hop (instantaneous frequency)
+    std::vector<int> m_peaks;               // Spectral peaks, ascending
+    std::vector<int> m_regionStart;         // Per peak: first bin of its region (minimum to the previous peak)
+    std::vector<float> m_shiftedMagnitude;  // Voice scratch
+    std::vector<float> m_shiftedPhase;
+
+    std::array<Voice, kMaxVoices> m_voices;
+
+    double m_sampleRate = 48000.0;
+    int m_numVoices = 1;
+    int m_fftSize = 2048;
+    int m_hopSize = 512;
+    int m_numBins = 1025;
+    int m_hopFill = 0;
+    int m_numPeaks = 0;
+    float m_outputGain = 1.0f;              // Inverse of the summed squared windows
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralPitchShifter)
+};
+
+} // namespace omega
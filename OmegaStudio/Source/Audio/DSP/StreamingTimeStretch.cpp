@@ -0,0 +1,863 @@
+//==============================================================================
+// StreamingTimeStretch.cpp - Time-stretch en streaming para clips warpeados
+//==============================================================================
+
+#include "StreamingTimeStretch.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <mutex>
+
+namespace OmegaStudio {
+namespace Audio {
+namespace DSP {
+
+namespace {
+
+constexpr double seekTolerance = 16.0;          // Samples de la fuente
+constexpr int transientBin = 32;                // ~750 Hz a 48 kHz: la banda que marca ataques
+constexpr float transientFloor = 1.0e-5f;       // ~-70 dBFS en agudos: por debajo no hay ataque
+constexpr float peakFloor = 1.0e-9f;
+constexpr int onsetBlockSize = 32;             // Resolución del ataque (y fundido del enmascarado)
+
+constexpr int stableBlocksBeforeCache = 8;      // Bloques con tempo, warp y posición estables
+constexpr double cacheSeconds = 4.0;
+constexpr double cacheLeadSeconds = 0.25;       // El worker empieza por delante del playhead
+constexpr int cacheChunkSize = 512;
+constexpr int maxChunksPerPass = 32;            // Reparto justo entre clips en cada pasada
+constexpr int crossfadeLength = 256;
+
+float principalArgument(float phase) {
+    return phase - juce::MathConstants<float>::twoPi
+                 * std::floor((phase + juce::MathConstants<float>::pi) / juce::MathConstants<float>::twoPi);
+}
+
+// Posición y ratio en la fuente para un beat del clip. Con loop, la posición
+// no se envuelve (el stretcher ve una fuente continua); LoopedSource la pliega
+struct Location {
+    double position { 0.0 };
+    double rate { 1.0 };
+    double loopStart { 0.0 };
+    double loopLength { 0.0 };
+};
+
+Location locate(const WarpMap& map, double beat, double tempo, double loopLengthBeats, double sampleRate) {
+    Location location;
+    double localBeat = beat;
+    double loops = 0.0;
+
+    if (loopLengthBeats > 0.0) {
+        loops = std::floor(beat / loopLengthBeats);
+        localBeat = beat - loops * loopLengthBeats;
+        location.loopStart = map.getSourcePosition(0.0);
+        location.loopLength = map.getSourcePosition(loopLengthBeats) - location.loopStart;
+    }
+
+    location.position = map.getSourcePosition(localBeat) + loops * location.loopLength;
+    location.rate = map.getSourceSamplesPerBeat(localBeat) * tempo / (60.0 * sampleRate);
+    return location;
+}
+
+} // namespace
+
+//==============================================================================
+// BufferStretchSource
+//==============================================================================
+
+void BufferStretchSource::read(float* const* destination, int numChannels, int64_t start, int count) {
+    const int sourceChannels = buffer_.getNumChannels();
+    const int64_t length = buffer_.getNumSamples();
+    const int64_t first = juce::jlimit<int64_t>(0, count, -start);
+    const int64_t last = juce::jlimit<int64_t>(first, count, length - start);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        float* dest = destination[ch];
+        if (sourceChannels == 0 || last <= first) {
+            juce::FloatVectorOperations::clear(dest, count);
+            continue;
+        }
+
+        const float* src = buffer_.getReadPointer(juce::jmin(ch, sourceChannels - 1));
+        juce::FloatVectorOperations::clear(dest, (int)first);
+        juce::FloatVectorOperations::copy(dest + first, src + start + first, (int)(last - first));
+        juce::FloatVectorOperations::clear(dest + last, (int)(count - last));
+    }
+}
+
+//==============================================================================
+// WarpMap
+//==============================================================================
+
+WarpMap::WarpMap(const std::vector<WarpMarker>& markers, double sourceSamplesPerBeat)
+    : sourceSamplesPerBeat_(sourceSamplesPerBeat > 0.0 ? sourceSamplesPerBeat : 22050.0) {
+    auto sorted = markers;
+    std::sort(sorted.begin(), sorted.end(), [](const WarpMarker& a, const WarpMarker& b) {
+        return a.beatPosition < b.beatPosition;
+    });
+
+    // Solo tramos que avanzan en los dos ejes: el ratio siempre es positivo
+    for (const auto& marker : sorted) {
+        if (markers_.empty() || (marker.beatPosition > markers_.back().beatPosition
+                                 && marker.samplePosition > markers_.back().samplePosition)) {
+            markers_.push_back(marker);
+        }
+    }
+}
+
+int WarpMap::findSegment(double beat) const {
+    const auto next = std::upper_bound(markers_.begin(), markers_.end(), beat,
+                                       [](double b, const WarpMarker& marker) { return b < marker.beatPosition; });
+    return (int)(next - markers_.begin()) - 1;
+}
+
+double WarpMap::getSourcePosition(double beat) const {
+    if (markers_.empty())
+        return beat * sourceSamplesPerBeat_;
+
+    const int segment = findSegment(beat);
+    if (segment < 0)
+        return markers_.front().samplePosition + (beat - markers_.front().beatPosition) * sourceSamplesPerBeat_;
+    if (segment == (int)markers_.size() - 1)
+        return markers_.back().samplePosition + (beat - markers_.back().beatPosition) * sourceSamplesPerBeat_;
+
+    const auto& a = markers_[(size_t)segment];
+    const auto& b = markers_[(size_t)segment + 1];
+    return a.samplePosition + (beat - a.beatPosition) * (b.samplePosition - a.samplePosition)
+                                                     / (b.beatPosition - a.beatPosition);
+}
+
+double WarpMap::getSourceSamplesPerBeat(double beat) const {
+    const int segment = findSegment(beat);
+    if (segment < 0 || segment >= (int)markers_.size() - 1)
+        return sourceSamplesPerBeat_;
+
+    const auto& a = markers_[(size_t)segment];
+    const auto& b = markers_[(size_t)segment + 1];
+    return (b.samplePosition - a.samplePosition) / (b.beatPosition - a.beatPosition);
+}
+
+//==============================================================================
+// StreamingTimeStretcher
+//==============================================================================
+
+void StreamingTimeStretcher::prepare(int numChannels, int maxBlockSize) {
+    numChannels_ = juce::jlimit(1, maxChannels, numChannels);
+    fft_ = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+    // Hann periódica: con hop N/4 la suma de ventanas al cuadrado es 1.5
+    window_.resize(frameSize);
+    for (int i = 0; i < frameSize; ++i)
+        window_[(size_t)i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * i / frameSize);
+
+    const int numBins = frameSize / 2 + 1;
+    const int accumulatorSize = juce::nextPowerOfTwo(frameSize + hopSize + juce::jmax(1, maxBlockSize));
+    accumulatorMask_ = accumulatorSize - 1;
+
+    timeBuffer_.assign(frameSize, {});
+    frequencyBuffer_.assign(frameSize, {});
+    for (int ch = 0; ch < maxChannels; ++ch) {
+        frameInput_[ch].assign(frameSize, 0.0f);
+        analysis_[ch].assign(2 * numBins, 0.0f);
+        previousAnalysis_[ch].assign(2 * numBins, 0.0f);
+        synthesis_[ch].assign(2 * numBins, 0.0f);
+        previousSynthesis_[ch].assign(2 * numBins, 0.0f);
+        accumulator_[ch].assign((size_t)accumulatorSize, 0.0f);
+    }
+    magnitudes_.assign(numBins, 0.0f);
+    peaks_.reserve(numBins);
+
+    reset();
+}
+
+void StreamingTimeStretcher::reset() {
+    for (int ch = 0; ch < maxChannels; ++ch)
+        std::fill(accumulator_[ch].begin(), accumulator_[ch].end(), 0.0f);
+
+    outputPosition_ = 0;
+    nextFrame_ = 0;
+    hasPrevious_ = false;
+    started_ = false;
+    previousHighEnergy_ = 0.0f;
+    drift_ = 0.0;
+    onsetPending_ = false;
+    numTransients_ = 0;
+}
+
+void StreamingTimeStretcher::resync() {
+    // Corte limpio: los frames del pre-roll dejan el overlap-add completo en
+    // outputPosition_; lo que caiga antes se descarta
+    for (int ch = 0; ch < numChannels_; ++ch)
+        std::fill(accumulator_[ch].begin(), accumulator_[ch].end(), 0.0f);
+
+    nextFrame_ = outputPosition_ - frameSize + hopSize;
+    hasPrevious_ = false;
+    started_ = true;
+    previousHighEnergy_ = 0.0f;
+    drift_ = 0.0;
+    onsetPending_ = false;
+}
+
+void StreamingTimeStretcher::process(StretchSource& source, float* const* outputs, int numChannels,
+                                     int numSamples, double sourcePosition, double rate) {
+    if (numSamples <= 0)
+        return;
+
+    if (fft_ == nullptr) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::clear(outputs[ch], numSamples);
+        return;
+    }
+
+    rate = juce::jlimit(minRate, maxRate, rate);
+    if (!started_ || std::abs(sourcePosition - expectedSourcePosition_) > seekTolerance)
+        resync();
+
+    blockSourcePosition_ = sourcePosition;
+    blockRate_ = rate;
+
+    // Todos los frames que tocan el último sample del bloque
+    const int64_t blockEnd = outputPosition_ + numSamples;
+    while (nextFrame_ < blockEnd) {
+        processFrame(source, nextFrame_);
+        nextFrame_ += hopSize;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const float* accumulator = accumulator_[juce::jmin(ch, numChannels_ - 1)].data();
+        float* out = outputs[ch];
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = accumulator[(outputPosition_ + i) & accumulatorMask_];
+    }
+
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        float* accumulator = accumulator_[ch].data();
+        for (int i = 0; i < numSamples; ++i)
+            accumulator[(outputPosition_ + i) & accumulatorMask_] = 0.0f;
+    }
+
+    outputPosition_ = blockEnd;
+    expectedSourcePosition_ = sourcePosition + rate * numSamples;
+}
+
+StreamingTimeStretcher::FrameMode StreamingTimeStretcher::chooseFrame(int64_t frameStart, int64_t& analysisStart) {
+    const int64_t centre = frameStart + frameSize / 2;
+
+    if (onsetPending_) {
+        if (frameStart > onsetOutput_) {
+            // Fin del ataque: seguir desde donde quedó el análisis, la deriva se recupera después
+            onsetPending_ = false;
+            drift_ = (double)(centre + onsetSource_ - onsetOutput_) - mapToSource(centre);
+        } else if (frameStart + frameSize > onsetOutput_) {
+            // Frames que contienen el ataque: a ratio 1, con el ataque en su sitio del timeline
+            analysisStart = frameStart + onsetSource_ - onsetOutput_;
+            return FrameMode::Locked;
+        }
+    }
+
+    // El centro del frame de síntesis cae en la fuente según el mapa del
+    // bloque; la mitad derecha es look-ahead sobre la fuente
+    analysisStart = (int64_t)std::llround(mapToSource(centre) + drift_) - frameSize / 2;
+    return onsetPending_ ? FrameMode::Masked : FrameMode::Normal;
+}
+
+float StreamingTimeStretcher::analyse(StretchSource& source, int64_t analysisStart, bool masked) {
+    const int numBins = frameSize / 2 + 1;
+
+    float* inputs[maxChannels];
+    for (int ch = 0; ch < maxChannels; ++ch)
+        inputs[ch] = frameInput_[ch].data();
+    source.read(inputs, numChannels_, analysisStart, frameSize);
+
+    // Antes del ataque: la ventana no puede adelantarlo (pre-eco)
+    if (masked) {
+        const int64_t cut = onsetSource_ - analysisStart;
+        const int fadeStart = (int)juce::jlimit<int64_t>(0, frameSize, cut - onsetBlockSize);
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            float* input = frameInput_[ch].data();
+            for (int i = fadeStart; i < frameSize; ++i)
+                input[i] *= i >= cut ? 0.0f : (float)(cut - i) / (float)onsetBlockSize;
+        }
+    }
+
+    // Estéreo en una sola FFT compleja (L + iR) y separación por simetría
+    const float* left = frameInput_[0].data();
+    const float* right = frameInput_[numChannels_ - 1].data();
+    for (int i = 0; i < frameSize; ++i)
+        timeBuffer_[(size_t)i] = { left[i] * window_[(size_t)i], numChannels_ > 1 ? right[i] * window_[(size_t)i] : 0.0f };
+    fft_->perform(timeBuffer_.data(), frequencyBuffer_.data(), false);
+
+    // Energía en agudos compartida: los canales resetean juntos y la imagen
+    // estéreo no se mueve
+    float highEnergy = 0.0f;
+    float* l = analysis_[0].data();
+    float* r = analysis_[1].data();
+    for (int k = 0; k < numBins; ++k) {
+        const auto z = frequencyBuffer_[(size_t)k];
+        const auto mirror = std::conj(frequencyBuffer_[(size_t)((frameSize - k) & (frameSize - 1))]);
+        const auto a = 0.5f * (z + mirror);
+        const auto b = 0.5f * (z - mirror);
+        l[2 * k] = a.real();
+        l[2 * k + 1] = a.imag();
+        r[2 * k] = b.imag();
+        r[2 * k + 1] = -b.real();
+
+        if (k >= transientBin)
+            highEnergy += std::norm(a) + (numChannels_ > 1 ? std::norm(b) : 0.0f);
+    }
+    return highEnergy / (float)frameSize;
+}
+
+int64_t StreamingTimeStretcher::findOnset(int64_t analysisStart) const {
+    // Bloque con la mayor subida de energía de la primera diferencia (agudos)
+    // respecto a los anteriores
+    constexpr int numBlocks = frameSize / onsetBlockSize;
+    std::array<float, numBlocks> energy {};
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        const float* input = frameInput_[ch].data();
+        for (int i = 1; i < frameSize; ++i)
+            energy[(size_t)(i / onsetBlockSize)] += juce::square(input[i] - input[i - 1]);
+    }
+
+    int onsetBlock = numBlocks - 1;
+    float bestRise = 0.0f;
+    for (int b = 4; b < numBlocks; ++b) {
+        const float before = 0.25f * (energy[(size_t)b - 1] + energy[(size_t)b - 2] + energy[(size_t)b - 3] + energy[(size_t)b - 4]);
+        const float rise = energy[(size_t)b] / (before + 1.0e-9f);
+        if (rise > bestRise) {
+            bestRise = rise;
+            onsetBlock = b;
+        }
+    }
+    return analysisStart + onsetBlock * onsetBlockSize;
+}
+
+void StreamingTimeStretcher::processFrame(StretchSource& source, int64_t frameStart) {
+    const int numBins = frameSize / 2 + 1;
+
+    // La deriva que dejan los ataques se recupera sin cambiar el hop de
+    // análisis más de la mitad
+    const double maxCorrection = 0.5 * blockRate_ * hopSize;
+    drift_ -= juce::jlimit(-maxCorrection, maxCorrection, drift_);
+
+    int64_t analysisStart = 0;
+    auto mode = chooseFrame(frameStart, analysisStart);
+    float highEnergy = analyse(source, analysisStart, mode == FrameMode::Masked);
+
+    bool resetPhases = mode == FrameMode::Locked;
+    const bool hasHistory = hasPrevious_ && analysisStart > previousAnalysisStart_
+                         && analysisStart - previousAnalysisStart_ <= frameSize;
+
+    // Salto de energía en agudos: ataque. Los frames que lo contienen se
+    // reproducen sin estirar (fases del análisis) y con el ataque donde el
+    // mapa lo pone; los anteriores no lo ven
+    if (mode == FrameMode::Normal && transientPreservation_ && hasHistory
+        && highEnergy > transientFloor && highEnergy > transientRatio_ * previousHighEnergy_) {
+        ++numTransients_;
+        const int64_t onset = findOnset(analysisStart);
+        const int64_t onsetOutput = outputPosition_ + (int64_t)std::llround((double)(onset - blockSourcePosition_) / blockRate_);
+
+        if (onsetOutput >= frameStart) {
+            onsetPending_ = true;
+            onsetSource_ = onset;
+            onsetOutput_ = onsetOutput;
+            mode = chooseFrame(frameStart, analysisStart);
+            highEnergy = analyse(source, analysisStart, mode == FrameMode::Masked);
+            resetPhases = mode == FrameMode::Locked;
+        } else {
+            resetPhases = true;
+        }
+    }
+    previousHighEnergy_ = highEnergy;
+
+    const int64_t analysisHop = analysisStart - previousAnalysisStart_;
+    if (!hasPrevious_ || analysisHop <= 0 || analysisHop > frameSize)
+        resetPhases = true;
+
+    const float olaScale = (float)hopSize / (0.375f * frameSize);
+
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        if (resetPhases) {
+            // Fases del análisis: el frame sale tal como se analizó
+            std::copy(analysis_[ch].begin(), analysis_[ch].end(), synthesis_[ch].begin());
+        } else {
+            lockPhases(ch, analysisHop);
+        }
+
+        // DC y Nyquist reales: si no, un canal se filtra en el otro al empaquetar
+        synthesis_[ch][1] = 0.0f;
+        synthesis_[ch][(size_t)(2 * numBins - 1)] = 0.0f;
+    }
+
+    // Síntesis de los dos canales en una IFFT compleja: L + iR, espectro completo
+    const float* l = synthesis_[0].data();
+    const float* r = synthesis_[numChannels_ - 1].data();
+    const float rightGain = numChannels_ > 1 ? 1.0f : 0.0f;
+    for (int k = 0; k < numBins; ++k)
+        frequencyBuffer_[(size_t)k] = { l[2 * k] - rightGain * r[2 * k + 1], l[2 * k + 1] + rightGain * r[2 * k] };
+    for (int k = numBins; k < frameSize; ++k) {
+        const int m = frameSize - k;
+        frequencyBuffer_[(size_t)k] = { l[2 * m] + rightGain * r[2 * m + 1], -l[2 * m + 1] + rightGain * r[2 * m] };
+    }
+    fft_->perform(frequencyBuffer_.data(), timeBuffer_.data(), true);
+
+    const int first = (int)juce::jlimit<int64_t>(0, frameSize, outputPosition_ - frameStart);
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        float* accumulator = accumulator_[ch].data();
+        for (int i = first; i < frameSize; ++i) {
+            const float value = ch == 0 ? timeBuffer_[(size_t)i].real() : timeBuffer_[(size_t)i].imag();
+            accumulator[(frameStart + i) & accumulatorMask_] += value * window_[(size_t)i] * olaScale;
+        }
+
+        std::swap(synthesis_[ch], previousSynthesis_[ch]);
+        std::swap(analysis_[ch], previousAnalysis_[ch]);
+    }
+
+    previousAnalysisStart_ = analysisStart;
+    hasPrevious_ = true;
+}
+
+void StreamingTimeStretcher::lockPhases(int channel, int64_t analysisHop) {
+    const int numBins = frameSize / 2 + 1;
+    const float* x = analysis_[channel].data();
+    const float* previousX = previousAnalysis_[channel].data();
+    const float* previousY = previousSynthesis_[channel].data();
+    float* y = synthesis_[channel].data();
+
+    for (int k = 0; k < numBins; ++k)
+        magnitudes_[(size_t)k] = x[2 * k] * x[2 * k] + x[2 * k + 1] * x[2 * k + 1];
+
+    peaks_.clear();
+    for (int k = 2; k < numBins - 2; ++k) {
+        const float m = magnitudes_[(size_t)k];
+        if (m > peakFloor && m > magnitudes_[(size_t)k - 1] && m > magnitudes_[(size_t)k - 2]
+            && m >= magnitudes_[(size_t)k + 1] && m >= magnitudes_[(size_t)k + 2])
+            peaks_.push_back(k);
+    }
+
+    if (peaks_.empty()) {
+        std::copy(x, x + 2 * numBins, y);
+        return;
+    }
+
+    // Cada pico propaga su fase con su frecuencia instantánea; los bins de
+    // su región (hasta el mínimo entre picos) giran lo mismo que él
+    const float binFrequency = juce::MathConstants<float>::twoPi / (float)frameSize;
+    int regionStart = 0;
+
+    for (size_t p = 0; p < peaks_.size(); ++p) {
+        const int peak = peaks_[p];
+        int regionEnd = numBins;
+        if (p + 1 < peaks_.size()) {
+            regionEnd = peak + 1;
+            for (int k = peak + 1; k < peaks_[p + 1]; ++k)
+                if (magnitudes_[(size_t)k] < magnitudes_[(size_t)regionEnd])
+                    regionEnd = k;
+        }
+
+        const float analysisPhase = std::atan2(x[2 * peak + 1], x[2 * peak]);
+        const float previousPhase = std::atan2(previousX[2 * peak + 1], previousX[2 * peak]);
+        // Avances esperados módulo N en enteros: omega * hop en float pierde la fase
+        const float expectedAnalysis = binFrequency * (float)((peak * analysisHop) % frameSize);
+        const float expectedSynthesis = binFrequency * (float)((peak * hopSize) % frameSize);
+        const float deviation = principalArgument(analysisPhase - previousPhase - expectedAnalysis);
+        const float synthesisPhase = std::atan2(previousY[2 * peak + 1], previousY[2 * peak])
+                                   + expectedSynthesis + deviation * (float)hopSize / (float)analysisHop;
+
+        const float rotation = synthesisPhase - analysisPhase;
+        const float c = std::cos(rotation), s = std::sin(rotation);
+        for (int k = regionStart; k < regionEnd; ++k) {
+            y[2 * k] = x[2 * k] * c - x[2 * k + 1] * s;
+            y[2 * k + 1] = x[2 * k] * s + x[2 * k + 1] * c;
+        }
+        regionStart = regionEnd;
+    }
+}
+
+//==============================================================================
+// WarpedClipPlayer
+//==============================================================================
+
+struct WarpedClipPlayer::Warp {
+    StretchSource* source { nullptr };
+    WarpMap map;
+    uint32_t version { 0 };
+};
+
+/** Pliega las lecturas dentro del loop del clip */
+class WarpedClipPlayer::LoopedSource : public StretchSource {
+public:
+    void set(StretchSource* source, double loopStart, double loopLength) {
+        source_ = source;
+        loopStart_ = (int64_t)std::llround(loopStart);
+        loopLength_ = (int64_t)std::llround(loopLength);
+    }
+
+    int getNumChannels() const override { return source_->getNumChannels(); }
+    int64_t getLengthInSamples() const override { return source_->getLengthInSamples(); }
+    bool supportsBackgroundReads() const override { return source_->supportsBackgroundReads(); }
+
+    void read(float* const* destination, int numChannels, int64_t start, int count) override {
+        if (loopLength_ <= 0) {
+            source_->read(destination, numChannels, start, count);
+            return;
+        }
+
+        float* shifted[StreamingTimeStretcher::maxChannels];
+        int done = 0;
+        while (done < count) {
+            int64_t offset = (start + done - loopStart_) % loopLength_;
+            if (offset < 0)
+                offset += loopLength_;
+
+            const int chunk = (int)juce::jmin<int64_t>(count - done, loopLength_ - offset);
+            for (int ch = 0; ch < numChannels; ++ch)
+                shifted[ch] = destination[ch] + done;
+            source_->read(shifted, numChannels, loopStart_ + offset, chunk);
+            done += chunk;
+        }
+    }
+
+private:
+    StretchSource* source_ { nullptr };
+    int64_t loopStart_ { 0 };
+    int64_t loopLength_ { 0 };
+};
+
+//==============================================================================
+// Hilo de fondo compartido por todos los clips
+//==============================================================================
+
+class WarpedClipPlayer::CacheWorker : public juce::Thread {
+public:
+    static std::shared_ptr<CacheWorker> getInstance() {
+        static std::mutex instanceMutex;
+        static std::weak_ptr<CacheWorker> instance;
+
+        std::lock_guard<std::mutex> guard(instanceMutex);
+        auto worker = instance.lock();
+        if (worker == nullptr) {
+            worker = std::make_shared<CacheWorker>();
+            instance = worker;
+        }
+        return worker;
+    }
+
+    CacheWorker() : juce::Thread("Warp Cache") {
+        startThread(juce::Thread::Priority::normal);
+    }
+
+    ~CacheWorker() override {
+        stopThread(1000);
+    }
+
+    void add(WarpedClipPlayer* player) {
+        std::lock_guard<std::mutex> guard(playersMutex_);
+        if (std::find(players_.begin(), players_.end(), player) == players_.end())
+            players_.push_back(player);
+    }
+
+    // Al volver, el worker ya no está usando el clip
+    void remove(WarpedClipPlayer* player) {
+        std::lock_guard<std::mutex> guard(playersMutex_);
+        players_.erase(std::remove(players_.begin(), players_.end(), player), players_.end());
+    }
+
+    void run() override {
+        while (!threadShouldExit()) {
+            wait(10);
+            std::lock_guard<std::mutex> guard(playersMutex_);
+            for (auto* player : players_)
+                player->runBackgroundJobs();
+        }
+    }
+
+private:
+    std::mutex playersMutex_;
+    std::vector<WarpedClipPlayer*> players_;
+};
+
+//==============================================================================
+
+WarpedClipPlayer::WarpedClipPlayer(bool useBackgroundThread)
+    : useBackgroundThread_(useBackgroundThread),
+      liveSource_(std::make_unique<LoopedSource>()),
+      cacheSource_(std::make_unique<LoopedSource>()) {}
+
+WarpedClipPlayer::~WarpedClipPlayer() {
+    if (worker_ != nullptr)
+        worker_->remove(this);
+}
+
+void WarpedClipPlayer::prepare(double sampleRate, int maxBlockSize, int numChannels) {
+    if (worker_ != nullptr)
+        worker_->remove(this);
+
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = juce::jmax(1, maxBlockSize);
+    numChannels_ = juce::jlimit(1, StreamingTimeStretcher::maxChannels, numChannels);
+
+    live_.prepare(numChannels_, maxBlockSize_);
+    cacheStretcher_.prepare(numChannels_, cacheChunkSize);
+    liveBuffer_.setSize(numChannels_, maxBlockSize_);
+    cacheBuffer_.setSize(numChannels_, maxBlockSize_);
+    renderBuffer_.setSize(numChannels_, cacheChunkSize);
+
+    // El anillo lo reserva el worker con la primera petición: los clips que
+    // nunca se quedan quietos no pagan la memoria
+    ringSize_ = juce::nextPowerOfTwo((int)(cacheSeconds * sampleRate));
+    ring_.setSize(0, 0);
+
+    publish();
+}
+
+void WarpedClipPlayer::reset() {
+    publish();
+}
+
+void WarpedClipPlayer::setSource(StretchSource* source) {
+    source_ = source;
+    publish();
+}
+
+void WarpedClipPlayer::setWarp(const std::vector<WarpMarker>& markers, double originalTempo, double sourceSampleRate) {
+    markers_ = markers;
+    originalTempo_ = originalTempo > 0.0 ? originalTempo : 120.0;
+    sourceSampleRate_ = sourceSampleRate > 0.0 ? sourceSampleRate : sampleRate_;
+    publish();
+}
+
+void WarpedClipPlayer::publish() {
+    auto warp = std::make_unique<Warp>();
+    warp->source = source_;
+    warp->map = WarpMap(markers_, 60.0 / originalTempo_ * sourceSampleRate_);
+    warp->version = ++version_;
+
+    // El worker suelta el clip antes del cambio
+    if (worker_ != nullptr)
+        worker_->remove(this);
+
+    const bool needsWorker = useBackgroundThread_ && source_ != nullptr && source_->supportsBackgroundReads();
+    auto worker = needsWorker && worker_ == nullptr ? CacheWorker::getInstance() : nullptr;
+
+    {
+        Omega::Utils::SpinLockGuard guard(lock_);
+        std::swap(warp_, warp);
+        if (worker != nullptr)
+            worker_ = worker;
+
+        live_.reset();
+        key_ = {};
+        nextPosition_ = -1;
+        stableBlocks_ = 0;
+        playingFromCache_.store(false);
+        requestEpoch_.store(0);
+    }
+
+    workerEpoch_ = 0;
+    cacheEpoch_.store(0);
+
+    if (needsWorker)
+        worker_->add(this);
+
+    // warp (el viejo) se libera aquí, fuera del hilo de audio
+}
+
+//==============================================================================
+
+void WarpedClipPlayer::renderLive(const Warp& warp, double beat, double tempo, double loopLengthBeats, int numSamples) {
+    const auto location = locate(warp.map, beat, tempo, loopLengthBeats, sampleRate_);
+    liveSource_->set(warp.source, location.loopStart, location.loopLength);
+    live_.process(*liveSource_, liveBuffer_.getArrayOfWritePointers(), numChannels_, numSamples,
+                  location.position, location.rate);
+}
+
+int WarpedClipPlayer::getCachedLength(int64_t start) const {
+    const uint32_t epoch = requestEpoch_.load(std::memory_order_relaxed);
+    if (epoch == 0 || cacheEpoch_.load(std::memory_order_acquire) != epoch)
+        return 0;
+
+    // Lo anterior al playhead puede estar siendo sobrescrito por el worker
+    const int64_t end = cacheEnd_.load(std::memory_order_acquire);
+    const int64_t first = juce::jmax(cacheStart_.load(std::memory_order_relaxed),
+                                     juce::jmax(end - ringSize_, playPosition_.load(std::memory_order_relaxed)));
+    if (start < first || start >= end)
+        return 0;
+
+    return (int)juce::jmin<int64_t>(end - start, maxBlockSize_);
+}
+
+void WarpedClipPlayer::readCache(int64_t start, int count) {
+    const int mask = ringSize_ - 1;
+    const int first = (int)(start & mask);
+    const int firstCount = juce::jmin(count, ringSize_ - first);
+
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        float* dest = cacheBuffer_.getWritePointer(ch);
+        const float* ring = ring_.getReadPointer(ch);
+        juce::FloatVectorOperations::copy(dest, ring + first, firstCount);
+        juce::FloatVectorOperations::copy(dest + firstCount, ring, count - firstCount);
+    }
+}
+
+void WarpedClipPlayer::process(float* const* outputs, int numChannels, int numSamples,
+                               double beat, double tempo, double loopLengthBeats) {
+    jassert(numSamples <= maxBlockSize_);
+    numSamples = juce::jmin(numSamples, maxBlockSize_);
+    if (numSamples <= 0 || tempo <= 0.0 || liveBuffer_.getNumSamples() == 0)
+        return;
+
+    // Cambio de fuente o warp en curso: este bloque sale en silencio
+    if (!lock_.tryLock())
+        return;
+
+    if (warp_ == nullptr || warp_->source == nullptr) {
+        lock_.unlock();
+        return;
+    }
+
+    const Warp& warp = *warp_;
+    const double samplesPerBeat = 60.0 / tempo * sampleRate_;
+    int64_t position = (int64_t)std::llround(beat * samplesPerBeat);
+
+    const bool sameKey = tempo == key_.tempo && loopLengthBeats == key_.loopLengthBeats && warp.version == key_.version;
+    const bool continuous = sameKey && nextPosition_ >= 0 && std::abs(position - nextPosition_) <= 1;
+    if (continuous)
+        position = nextPosition_;
+    stableBlocks_ = continuous ? stableBlocks_ + 1 : 0;
+
+    // Ratio quieto: pedir al worker que renderice por delante
+    const bool canCache = cacheEnabled_.load(std::memory_order_relaxed) && warp.source->supportsBackgroundReads()
+                       && (worker_ != nullptr || !useBackgroundThread_);
+    if (canCache && stableBlocks_ == stableBlocksBeforeCache) {
+        requestPosition_.store(position + (int64_t)(cacheLeadSeconds * sampleRate_), std::memory_order_relaxed);
+        requestTempo_.store(tempo, std::memory_order_relaxed);
+        requestLoopLength_.store(loopLengthBeats, std::memory_order_relaxed);
+        requestVersion_.store(warp.version, std::memory_order_relaxed);
+        if (++nextEpoch_ == 0)
+            ++nextEpoch_;
+        requestEpoch_.store(nextEpoch_, std::memory_order_release);
+        if (worker_ != nullptr)
+            worker_->notify();
+    }
+
+    const bool wasFromCache = playingFromCache_.load(std::memory_order_relaxed);
+    const bool fromCache = canCache && stableBlocks_ >= stableBlocksBeforeCache
+                        && getCachedLength(position) >= numSamples;
+    const juce::AudioBuffer<float>* result = &liveBuffer_;
+
+    if (fromCache) {
+        readCache(position, numSamples);
+        if (!wasFromCache) {
+            // Vivo -> caché: el stretcher en vivo rinde este último bloque para el crossfade
+            renderLive(warp, beat, tempo, loopLengthBeats, numSamples);
+            const int fade = juce::jmin(numSamples, crossfadeLength);
+            for (int ch = 0; ch < numChannels_; ++ch) {
+                const float* live = liveBuffer_.getReadPointer(ch);
+                float* cached = cacheBuffer_.getWritePointer(ch);
+                for (int i = 0; i < fade; ++i) {
+                    const float g = (float)(i + 1) / (float)(fade + 1);
+                    cached[i] = live[i] + g * (cached[i] - live[i]);
+                }
+            }
+        }
+        result = &cacheBuffer_;
+    } else {
+        // Caché -> vivo: la continuación de la caché tapa el arranque del stretcher
+        const int continuation = wasFromCache ? juce::jmin(numSamples, crossfadeLength, getCachedLength(nextPosition_)) : 0;
+        if (continuation > 0)
+            readCache(nextPosition_, continuation);
+        if (wasFromCache)
+            live_.reset();
+
+        renderLive(warp, beat, tempo, loopLengthBeats, numSamples);
+
+        for (int ch = 0; ch < numChannels_ && continuation > 0; ++ch) {
+            const float* cached = cacheBuffer_.getReadPointer(ch);
+            float* live = liveBuffer_.getWritePointer(ch);
+            for (int i = 0; i < continuation; ++i) {
+                const float g = (float)(i + 1) / (float)(continuation + 1);
+                live[i] = cached[i] + g * (live[i] - cached[i]);
+            }
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        juce::FloatVectorOperations::add(outputs[ch], result->getReadPointer(juce::jmin(ch, numChannels_ - 1)), numSamples);
+
+    key_ = { tempo, loopLengthBeats, warp.version };
+    nextPosition_ = position + numSamples;
+    playPosition_.store(nextPosition_, std::memory_order_release);
+    playingFromCache_.store(fromCache, std::memory_order_relaxed);
+
+    lock_.unlock();
+}
+
+//==============================================================================
+
+void WarpedClipPlayer::runBackgroundJobs() {
+    // Nunca corre a la vez que publish(): el worker suelta el clip antes
+    if (warp_ == nullptr || warp_->source == nullptr || !cacheEnabled_.load(std::memory_order_relaxed))
+        return;
+
+    const uint32_t epoch = requestEpoch_.load(std::memory_order_acquire);
+    if (epoch == 0)
+        return;
+
+    if (epoch != workerEpoch_) {
+        const int64_t start = requestPosition_.load(std::memory_order_relaxed);
+        const Key key { requestTempo_.load(std::memory_order_relaxed),
+                        requestLoopLength_.load(std::memory_order_relaxed),
+                        requestVersion_.load(std::memory_order_relaxed) };
+        if (requestEpoch_.load(std::memory_order_acquire) != epoch)
+            return;   // Petición a medias: en la próxima pasada
+
+        workerEpoch_ = epoch;
+        workerKey_ = key;
+        cacheEpoch_.store(0, std::memory_order_release);
+        if (key.version != warp_->version)
+            return;
+
+        if (ring_.getNumSamples() != ringSize_)
+            ring_.setSize(numChannels_, ringSize_);
+        cacheStretcher_.reset();
+        cacheStart_.store(start, std::memory_order_relaxed);
+        cacheEnd_.store(start, std::memory_order_relaxed);
+        cacheEpoch_.store(epoch, std::memory_order_release);
+    }
+
+    if (cacheEpoch_.load(std::memory_order_relaxed) != epoch)
+        return;
+
+    const double samplesPerBeat = 60.0 / workerKey_.tempo * sampleRate_;
+    const int mask = ringSize_ - 1;
+    int64_t end = cacheEnd_.load(std::memory_order_relaxed);
+
+    // Nunca más de un anillo por delante de lo que el audio ya leyó
+    for (int chunk = 0; chunk < maxChunksPerPass; ++chunk) {
+        if (end + cacheChunkSize > playPosition_.load(std::memory_order_acquire) + ringSize_
+            || requestEpoch_.load(std::memory_order_relaxed) != epoch)
+            break;
+
+        const auto location = locate(warp_->map, (double)end / samplesPerBeat, workerKey_.tempo,
+                                     workerKey_.loopLengthBeats, sampleRate_);
+        cacheSource_->set(warp_->source, location.loopStart, location.loopLength);
+        cacheStretcher_.process(*cacheSource_, renderBuffer_.getArrayOfWritePointers(), numChannels_,
+                                cacheChunkSize, location.position, location.rate);
+
+        const int first = (int)(end & mask);
+        const int firstCount = juce::jmin(cacheChunkSize, ringSize_ - first);
+        for (int ch = 0; ch < numChannels_; ++ch) {
+            const float* src = renderBuffer_.getReadPointer(ch);
+            float* ring = ring_.getWritePointer(ch);
+            juce::FloatVectorOperations::copy(ring + first, src, firstCount);
+            juce::FloatVectorOperations::copy(ring, src + firstCount, cacheChunkSize - firstCount);
+        }
+
+        end += cacheChunkSize;
+        cacheEnd_.store(end, std::memory_order_release);
+    }
+}
+
+} // namespace DSP
+} // namespace Audio
+} // namespace OmegaStudio
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Utils/Atomic.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace OmegaStudio {
+namespace Audio {
+namespace DSP {
+
+/**
+ * @struct WarpMarker
+ * @brief Marcador de warp para time-stretching
+ */
+struct WarpMarker {
+    double samplePosition;     // Posición en samples del audio original
+    double beatPosition;       // Posición en el timeline (beats)
+    bool isLocked { false };   // Si está bloqueado, no se mueve con tempo changes
+
+    WarpMarker(double sample = 0.0, double beat = 0.0)
+        : samplePosition(sample), beatPosition(beat) {}
+};
+
+/**
+ * @class StretchSource
+ * @brief Lector de audio para el stretch en streaming
+ *
+ * read() se llama desde el hilo de audio (y desde el hilo de la caché si
+ * supportsBackgroundReads()): no puede bloquear ni reservar memoria. Fuera
+ * de [0, getLengthInSamples()) devuelve silencio.
+ */
+class StretchSource {
+public:
+    virtual ~StretchSource() = default;
+
+    virtual int getNumChannels() const = 0;
+    virtual int64_t getLengthInSamples() const = 0;
+
+    /** Copia count samples desde start. Canales de destino de más repiten el último */
+    virtual void read(float* const* destination, int numChannels, int64_t start, int count) = 0;
+
+    /** Si la caché de fondo puede leer la fuente en paralelo con el audio */
+    virtual bool supportsBackgroundReads() const { return true; }
+};
+
+/**
+ * @class BufferStretchSource
+ * @brief Fuente sobre un buffer en memoria (no lo copia: debe sobrevivir a la fuente)
+ */
+class BufferStretchSource : public StretchSource {
+public:
+    explicit BufferStretchSource(const juce::AudioBuffer<float>& buffer) : buffer_(buffer) {}
+
+    int getNumChannels() const override { return buffer_.getNumChannels(); }
+    int64_t getLengthInSamples() const override { return buffer_.getNumSamples(); }
+    void read(float* const* destination, int numChannels, int64_t start, int count) override;
+
+private:
+    const juce::AudioBuffer<float>& buffer_;
+};
+
+/**
+ * @class WarpMap
+ * @brief Mapa beat del clip -> posición en la fuente, lineal a tramos entre marcadores
+ *
+ * Sin marcadores (o antes del primero / después del último) la fuente avanza a
+ * su tempo original: sourceSamplesPerBeat = 60 / tempoOriginal * sampleRateFuente.
+ */
+class WarpMap {
+public:
+    WarpMap() = default;
+    WarpMap(const std::vector<WarpMarker>& markers, double sourceSamplesPerBeat);
+
+    double getSourcePosition(double beat) const;
+
+    /** Pendiente local: samples de la fuente por beat */
+    double getSourceSamplesPerBeat(double beat) const;
+
+private:
+    int findSegment(double beat) const;
+
+    std::vector<WarpMarker> markers_;   // Ordenados por beat, beats estrictamente crecientes
+    double sourceSamplesPerBeat_ { 22050.0 };
+};
+
+/**
+ * @class StreamingTimeStretcher
+ * @brief Phase vocoder con phase locking y preservación de transitorios, bloque a bloque
+ *
+ * - Ventanas Hann de 2048 con hop de síntesis 512; el hop de análisis sigue al
+ *   ratio de cada frame, así que el ratio puede cambiar en cada bloque
+ * - Identity phase locking (Laroche-Dolson): solo los picos propagan su fase,
+ *   el resto de bins de su región rota con ellos (sin "phasiness")
+ * - Transitorios: un salto de energía en agudos localiza el ataque; los frames
+ *   que lo contienen suenan sin estirar (fases del análisis) con el ataque en
+ *   su sitio del timeline, los anteriores no lo ven (sin pre-eco) y el tiempo
+ *   prestado se devuelve poco a poco después
+ * - Sin latencia: cada frame se centra en su posición de salida leyendo media
+ *   ventana por delante en la fuente (que es un fichero, no una entrada en vivo)
+ * - Un salto de posición (seek) re-sincroniza con un pre-roll de frames: la
+ *   salida en la nueva posición ya tiene el overlap-add completo
+ * RT-safe después de prepare().
+ */
+class StreamingTimeStretcher {
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int frameSize = 1 << fftOrder;
+    static constexpr int hopSize = frameSize / 4;
+    static constexpr int maxChannels = 2;
+    static constexpr double minRate = 0.25;
+    static constexpr double maxRate = 4.0;
+
+    StreamingTimeStretcher() = default;
+
+    void prepare(int numChannels, int maxBlockSize);
+    void reset();
+
+    /**
+     * Genera numSamples de salida (sobrescribe outputs)
+     * @param sourcePosition Posición en la fuente (samples) del primer sample de salida
+     * @param rate Samples de la fuente por sample de salida (1 / stretch)
+     */
+    void process(StretchSource& source, float* const* outputs, int numChannels, int numSamples,
+                 double sourcePosition, double rate);
+
+    /** El look-ahead sobre la fuente sustituye a la latencia: la salida está alineada */
+    int getLatencySamples() const { return 0; }
+
+    void setTransientPreservation(bool enabled) { transientPreservation_ = enabled; }
+    void setTransientThreshold(float decibels) { transientRatio_ = juce::Decibels::decibelsToGain(2.0f * decibels); }
+    int getNumTransients() const { return numTransients_; }
+
+private:
+    enum class FrameMode { Normal, Masked, Locked };
+
+    void resync();
+    void processFrame(StretchSource& source, int64_t frameStart);
+    FrameMode chooseFrame(int64_t frameStart, int64_t& analysisStart);
+    float analyse(StretchSource& source, int64_t analysisStart, bool masked);
+    int64_t findOnset(int64_t analysisStart) const;
+    void lockPhases(int channel, int64_t analysisHop);
+
+    double mapToSource(int64_t outputIndex) const {
+        return blockSourcePosition_ + blockRate_ * (double)(outputIndex - outputPosition_);
+    }
+
+    std::unique_ptr<juce::dsp::FFT> fft_;
+    std::vector<float> window_;
+    std::vector<juce::dsp::Complex<float>> timeBuffer_, frequencyBuffer_;
+    std::vector<float> frameInput_[maxChannels];
+    std::vector<float> analysis_[maxChannels];            // Bins 0..N/2 intercalados re/im
+    std::vector<float> previousAnalysis_[maxChannels];
+    std::vector<float> synthesis_[maxChannels];
+    std::vector<float> previousSynthesis_[maxChannels];
+    std::vector<float> accumulator_[maxChannels];         // Overlap-add, anillo potencia de 2
+    std::vector<float> magnitudes_;
+    std::vector<int> peaks_;
+
+    int numChannels_ { 0 };
+    int accumulatorMask_ { 0 };
+
+    int64_t outputPosition_ { 0 };        // Primer sample no entregado
+    int64_t nextFrame_ { 0 };             // Inicio (en salida) del próximo frame
+    int64_t previousAnalysisStart_ { 0 };
+    bool hasPrevious_ { false };
+    bool started_ { false };
+    float previousHighEnergy_ { 0.0f };
+
+    double blockSourcePosition_ { 0.0 };  // Mapa salida -> fuente del bloque actual
+    double blockRate_ { 1.0 };
+    double expectedSourcePosition_ { 0.0 };
+    double drift_ { 0.0 };                // Análisis - mapa, en samples de la fuente
+
+    bool onsetPending_ { false };         // Ataque detectado aún por reproducir
+    int64_t onsetSource_ { 0 };
+    int64_t onsetOutput_ { 0 };
+
+    bool transientPreservation_ { true };
+    float transientRatio_ { 4.0f };       // +6 dB en agudos de un frame al siguiente
+    int numTransients_ { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamingTimeStretcher)
+};
+
+/**
+ * @class WarpedClipPlayer
+ * @brief Reproducción warpeada de un clip siguiendo el tempo, sin copias renderizadas
+ *
+ * El audio estira en vivo (StreamingTimeStretcher) con el ratio que dan el
+ * tempo actual y los marcadores. Cuando tempo, posición y warp llevan unos
+ * bloques estables, un hilo de fondo compartido por todos los clips renderiza
+ * por delante en una caché circular de unos segundos; el audio pasa a leerla
+ * (con crossfade) y deja de gastar CPU en ese clip. Cualquier cambio de tempo
+ * o salto vuelve al camino en vivo con crossfade, usando la continuación de la
+ * caché. Memoria acotada: un anillo por clip, nunca el clip entero estirado.
+ */
+class WarpedClipPlayer {
+public:
+    explicit WarpedClipPlayer(bool useBackgroundThread = true);
+    ~WarpedClipPlayer();
+
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void reset();
+
+    // Hilo de mensajes. La fuente debe estar al sample rate de la sesión y
+    // sobrevivir hasta el siguiente setSource(). El audio nunca espera
+    void setSource(StretchSource* source);
+    void setWarp(const std::vector<WarpMarker>& markers, double originalTempo, double sourceSampleRate);
+    void setCacheEnabled(bool enabled) { cacheEnabled_.store(enabled); }
+
+    /**
+     * Suma el clip a outputs (hilo de audio)
+     * @param beat Posición del playhead relativa al inicio del clip (beats)
+     * @param tempo Tempo actual (BPM)
+     * @param loopLengthBeats Longitud del loop del clip (0 = sin loop)
+     */
+    void process(float* const* outputs, int numChannels, int numSamples,
+                 double beat, double tempo, double loopLengthBeats = 0.0);
+
+    int getLatencySamples() const { return 0; }
+    bool isPlayingFromCache() const { return playingFromCache_.load(std::memory_order_relaxed); }
+
+    /** Trabajo de la caché. Lo llama el hilo compartido; sin él, el dueño (tests, offline) */
+    void runBackgroundJobs();
+
+private:
+    class CacheWorker;
+    class LoopedSource;
+    struct Warp;
+
+    struct Key {
+        double tempo { 0.0 };
+        double loopLengthBeats { 0.0 };
+        uint32_t version { 0 };
+    };
+
+    void publish();
+    void renderLive(const Warp& warp, double beat, double tempo, double loopLengthBeats, int numSamples);
+    int getCachedLength(int64_t start) const;
+    void readCache(int64_t start, int count);
+
+    std::unique_ptr<Warp> warp_;
+    std::shared_ptr<CacheWorker> worker_;
+    Omega::Utils::SpinLock lock_;
+    const bool useBackgroundThread_;
+
+    double sampleRate_ { 48000.0 };
+    int maxBlockSize_ { 512 };
+    int numChannels_ { 2 };
+    std::vector<WarpMarker> markers_;
+    double originalTempo_ { 120.0 };
+    double sourceSampleRate_ { 48000.0 };
+    StretchSource* source_ { nullptr };
+    uint32_t version_ { 0 };
+
+    // Hilo de audio
+    StreamingTimeStretcher live_;
+    std::unique_ptr<LoopedSource> liveSource_;
+    juce::AudioBuffer<float> liveBuffer_, cacheBuffer_;
+    Key key_;
+    int64_t nextPosition_ { -1 };         // Sample de timeline esperado en el próximo bloque
+    int stableBlocks_ { 0 };
+    uint32_t nextEpoch_ { 0 };
+    std::atomic<bool> playingFromCache_ { false };
+    std::atomic<bool> cacheEnabled_ { true };
+
+    // Caché: el audio pide (requestEpoch_), el worker rellena [cacheStart_, cacheEnd_)
+    StreamingTimeStretcher cacheStretcher_;
+    std::unique_ptr<LoopedSource> cacheSource_;
+    juce::AudioBuffer<float> ring_, renderBuffer_;
+    int ringSize_ { 0 };
+    std::atomic<uint32_t> requestEpoch_ { 0 };
+    std::atomic<uint32_t> cacheEpoch_ { 0 };
+    std::atomic<int64_t> requestPosition_ { 0 };
+    std::atomic<double> requestTempo_ { 120.0 };
+    std::atomic<double> requestLoopLength_ { 0.0 };
+    std::atomic<uint32_t> requestVersion_ { 0 };
+    std::atomic<int64_t> cacheStart_ { 0 };
+    std::atomic<int64_t> cacheEnd_ { 0 };
+    std::atomic<int64_t> playPosition_ { 0 };
+    uint32_t workerEpoch_ { 0 };           // Solo el worker
+    Key workerKey_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WarpedClipPlayer)
+};
+
+} // namespace DSP
+} // namespace Audio
+} // namespace OmegaStudio
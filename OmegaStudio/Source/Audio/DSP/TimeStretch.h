@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "StreamingTimeStretch.h"
+#include "../Analysis/AudioFeatureStore.h"
 #include <vector>
 #include <memory>
 
@@ -8,19 +10,6 @@ namespace OmegaStudio {
 namespace Audio {
 namespace DSP {
 
-/**
- * @struct WarpMarker
- * @brief Marcador de warp para time-stretching
- */
-struct WarpMarker {
-    double samplePosition;     // Posición en samples del audio original
-    double beatPosition;       // Posición en el timeline (beats)
-    bool isLocked { false };   // Si está bloqueado, no se mueve con tempo changes
-    
-    WarpMarker(double sample = 0.0, double beat = 0.0)
-        : samplePosition(sample), beatPosition(beat) {}
-};
-
 /**
  * @class TempoDetector
  * @brief Detecta el tempo de audio usando onset detection
@@ -38,118 +27,21 @@ public:
     Result detectTempo(const juce::AudioBuffer<float>& buffer, double sampleRate) {
         Result result;
         
-        // 1. Spectral flux para onset detection
-        auto onsets = detectOnsets(buffer, sampleRate);
-        result.onsets = onsets;
-        
-        if (onsets.size() < 2) {
-            return result;  // Not enough onsets
-        }
-        
-        // 2. Calculate inter-onset intervals (IOIs)
-        std::vector<double> intervals;
-        for (size_t i = 1; i < onsets.size(); ++i) {
-            intervals.push_back(onsets[i] - onsets[i-1]);
-        }
-        
-        // 3. Find most common interval (using histogram)
-        std::map<int, int> histogram;
-        for (double interval : intervals) {
-            double bpm = 60.0 * sampleRate / interval;
-            // Quantize to nearest BPM
-            int bpmInt = std::round(bpm);
-            
-            // Also check octave multiples/divisions (60, 120, 180, etc.)
-            for (int mult : {1, 2, 3, 4}) {
-                int candidate = bpmInt / mult;
-                if (candidate >= 60 && candidate <= 200) {
-                    histogram[candidate]++;
-                }
-            }
+        // Onsets y tempo del analisis compartido (cacheado por contenido)
+        auto features = omega::Analysis::AudioFeatureStore::getInstance().getFeatures(buffer, sampleRate);
+        if (features == nullptr) {
+            return result;
         }
         
-        // 4. Find peak in histogram
-        int maxCount = 0;
-        int detectedBPM = 120;
-        for (const auto& [bpm, count] : histogram) {
-            if (count > maxCount) {
-                maxCount = count;
-                detectedBPM = bpm;
-            }
+        for (const auto& onset : features->selectOnsets(0.1f)) {
+            result.onsets.push_back(static_cast<double>(onset.position));
         }
         
-        result.bpm = detectedBPM;
-        result.confidence = maxCount / (double)intervals.size();
+        result.bpm = features->summary.bpm;
+        result.confidence = features->summary.bpmConfidence;
         
         return result;
     }
-    
-private:
-    std::vector<double> detectOnsets(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-        std::vector<double> onsets;
-        
-        // Simple energy-based onset detection
-        const int hopSize = 512;
-        const int frameSize = 2048;
-        const float threshold = 0.3f;
-        
-        std::vector<float> spectralFlux;
-        std::vector<float> prevMagnitude(frameSize / 2, 0.0f);
-        
-        juce::dsp::FFT fft(11);  // 2048 points
-        std::vector<float> fftData(frameSize * 2, 0.0f);
-        
-        for (int pos = 0; pos < buffer.getNumSamples() - frameSize; pos += hopSize) {
-            // Get frame (mono mix)
-            for (int i = 0; i < frameSize; ++i) {
-                float sample = 0.0f;
-                for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-                    sample += buffer.getSample(ch, pos + i);
-                }
-                fftData[i] = sample / buffer.getNumChannels();
-            }
-            
-            // Apply Hann window
-            for (int i = 0; i < frameSize; ++i) {
-                float window = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * i / frameSize));
-                fftData[i] *= window;
-            }
-            
-            // FFT
-            fft.performFrequencyOnlyForwardTransform(fftData.data());
-            
-            // Calculate spectral flux
-            float flux = 0.0f;
-            for (int i = 0; i < frameSize / 2; ++i) {
-                float magnitude = fftData[i];
-                float diff = magnitude - prevMagnitude[i];
-                if (diff > 0.0f) {
-                    flux += diff;
-                }
-                prevMagnitude[i] = magnitude;
-            }
-            
-            spectralFlux.push_back(flux);
-        }
-        
-        // Peak picking
-        for (size_t i = 2; i < spectralFlux.size() - 2; ++i) {
-            float localMean = 0.0f;
-            for (int j = -2; j <= 2; ++j) {
-                localMean += spectralFlux[i + j];
-            }
-            localMean /= 5.0f;
-            
-            if (spectralFlux[i] > localMean * (1.0f + threshold) &&
-                spectralFlux[i] > spectralFlux[i-1] &&
-                spectralFlux[i] > spectralFlux[i+1]) {
-                
-                onsets.push_back(i * hopSize);
-            }
-        }
-        
-        return onsets;
-    }
 };
 
 /**
@@ -359,6 +251,7 @@ public:
     WarpEngine() = default;
     
     void loadAudio(const juce::AudioBuffer<float>& buffer, double sampleRate) {
+        player_.setSource(nullptr);   // El player suelta el buffer antes de reemplazarlo
         originalAudio_ = buffer;
         sampleRate_ = sampleRate;
         
@@ -390,16 +283,21 @@ public:
                             (detectedTempo_ / (60.0 * sampleRate));
             markers_.push_back(WarpMarker(buffer.getNumSamples(), lastBeat));
         }
+        
+        player_.setSource(&source_);
+        updatePlayer();
     }
     
     void addMarker(double samplePosition, double beatPosition) {
         markers_.push_back(WarpMarker(samplePosition, beatPosition));
         sortMarkers();
+        updatePlayer();
     }
     
     void removeMarker(int index) {
         if (index >= 0 && index < markers_.size()) {
             markers_.erase(markers_.begin() + index);
+            updatePlayer();
         }
     }
     
@@ -408,6 +306,7 @@ public:
             markers_[index].samplePosition = newSamplePos;
             markers_[index].beatPosition = newBeatPos;
             sortMarkers();
+            updatePlayer();
         }
     }
     
@@ -426,7 +325,27 @@ public:
         return stretcher_.stretch(originalAudio_, ratio, true);
     }
     
+    /**
+     * Reproducción en streaming: sigue al tempo (también automatizado) sin
+     * renderizar copias. El audio cargado debe estar al sample rate de la sesión
+     */
+    void prepareToPlay(double sampleRate, int maxBlockSize) {
+        player_.prepare(sampleRate, maxBlockSize, 2);
+    }
+    
+    /** Suma el audio warpeado a output; beat relativo al inicio del audio */
+    void processBlock(juce::AudioBuffer<float>& output, double beat, double tempo) {
+        player_.process(output.getArrayOfWritePointers(), output.getNumChannels(),
+                        output.getNumSamples(), beat, tempo);
+    }
+    
+    WarpedClipPlayer& getPlayer() { return player_; }
+    
 private:
+    void updatePlayer() {
+        player_.setWarp(markers_, detectedTempo_, sampleRate_);
+    }
+    
     void sortMarkers() {
         std::sort(markers_.begin(), markers_.end(),
             [](const WarpMarker& a, const WarpMarker& b) {
@@ -439,6 +358,8 @@ private:
     double detectedTempo_ { 120.0 };
     std::vector<WarpMarker> markers_;
     ElasticAudioStretcher stretcher_;
+    BufferStretchSource source_ { originalAudio_ };
+    WarpedClipPlayer player_;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WarpEngine)
 };
@@ -0,0 +1,244 @@
+//==============================================================================
+// TruePeakDetector.cpp - Polyphase true-peak detector and look-ahead gain
+//==============================================================================
+
+#include "TruePeakDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OmegaStudio {
+
+namespace {
+
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+} // namespace
+
+//==============================================================================
+// TruePeakDetector
+//==============================================================================
+
+void TruePeakDetector::prepare(int oversamplingFactor, TruePeakQuality quality)
+{
+    factor_ = oversamplingFactor >= 8 ? 8 : oversamplingFactor >= 4 ? 4 : oversamplingFactor >= 2 ? 2 : 1;
+    if (quality == TruePeakQuality::Offline)
+        factor_ = std::max(factor_, 4);
+
+    taps_ = quality == TruePeakQuality::Offline ? 32 : 12;
+    latency_ = taps_ / 2 - 1;
+
+    // Fase p interpola en t = n - latency - p / factor; la ventana se centra en el soporte
+    const double beta = quality == TruePeakQuality::Offline ? 9.0 : 6.0;
+    const double centre = 0.5 / factor_;
+    const double halfSpan = 0.5 * taps_;
+    const double pi = 3.14159265358979323846;
+
+    coefficients_.assign(static_cast<size_t>(taps_ * factor_), 0.0f);
+    for (int p = 0; p < factor_; ++p) {
+        double sum = 0.0;
+        std::vector<double> phase(static_cast<size_t>(taps_));
+        for (int k = 0; k < taps_; ++k) {
+            const double tau = k - latency_ - static_cast<double>(p) / factor_;
+            const double sinc = std::abs(tau) < 1.0e-9 ? 1.0 : std::sin(pi * tau) / (pi * tau);
+            const double r = (tau - centre) / halfSpan;
+            const double window = std::abs(r) >= 1.0 ? 0.0 : besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+            phase[static_cast<size_t>(k)] = sinc * window;
+            sum += sinc * window;
+        }
+        // Ganancia unitaria en DC para cada fase
+        for (int k = 0; k < taps_; ++k)
+            coefficients_[static_cast<size_t>(k * factor_ + p)] = static_cast<float>(phase[static_cast<size_t>(k)] / sum);
+    }
+
+    history_.assign(static_cast<size_t>(2 * taps_), 0.0f);
+    historyPos_ = 0;
+}
+
+void TruePeakDetector::reset()
+{
+    std::fill(history_.begin(), history_.end(), 0.0f);
+    historyPos_ = 0;
+}
+
+template <int Factor, bool Accumulate>
+void TruePeakDetector::run(const float* input, float* peaks, int numSamples)
+{
+    const int taps = taps_;
+    const float* coeffs = coefficients_.data();
+    float* history = history_.data();
+
+    for (int i = 0; i < numSamples; ++i) {
+        // Ventana duplicada: history[pos .. pos + taps) es siempre contigua, más reciente al final
+        history[historyPos_] = history[historyPos_ + taps] = input[i];
+        historyPos_ = historyPos_ + 1 == taps ? 0 : historyPos_ + 1;
+        const float* x = history + historyPos_ + taps - 1;
+
+        // Todas las fases a la vez: el bucle interno es un FMA vectorial de Factor lanes
+        float acc[Factor] = {};
+        for (int k = 0; k < taps; ++k) {
+            const float sample = x[-k];
+            const float* c = coeffs + k * Factor;
+            for (int p = 0; p < Factor; ++p)
+                acc[p] += c[p] * sample;
+        }
+
+        float peak = 0.0f;
+        for (int p = 0; p < Factor; ++p)
+            peak = std::max(peak, std::abs(acc[p]));
+
+        if constexpr (Accumulate)
+            peaks[i] = std::max(peaks[i], peak);
+        else
+            peaks[i] = peak;
+    }
+}
+
+void TruePeakDetector::process(const float* input, float* peaks, int numSamples)
+{
+    switch (factor_) {
+        case 8:  run<8, false>(input, peaks, numSamples); break;
+        case 4:  run<4, false>(input, peaks, numSamples); break;
+        case 2:  run<2, false>(input, peaks, numSamples); break;
+        default: run<1, false>(input, peaks, numSamples); break;
+    }
+}
+
+void TruePeakDetector::processMax(const float* input, float* peaks, int numSamples)
+{
+    switch (factor_) {
+        case 8:  run<8, true>(input, peaks, numSamples); break;
+        case 4:  run<4, true>(input, peaks, numSamples); break;
+        case 2:  run<2, true>(input, peaks, numSamples); break;
+        default: run<1, true>(input, peaks, numSamples); break;
+    }
+}
+
+float TruePeakDetector::measure(const float* data, int numSamples, int oversamplingFactor, TruePeakQuality quality)
+{
+    TruePeakDetector detector;
+    detector.prepare(oversamplingFactor, quality);
+
+    std::vector<float> peaks(static_cast<size_t>(std::max(numSamples, detector.taps_)));
+    detector.process(data, peaks.data(), numSamples);
+    float peak = numSamples > 0 ? *std::max_element(peaks.begin(), peaks.begin() + numSamples) : 0.0f;
+
+    // Cola del filtro: los últimos samples todavía no han salido
+    std::vector<float> silence(static_cast<size_t>(detector.taps_), 0.0f);
+    detector.process(silence.data(), peaks.data(), detector.taps_);
+    for (int i = 0; i < detector.taps_; ++i)
+        peak = std::max(peak, peaks[static_cast<size_t>(i)]);
+
+    return peak;
+}
+
+//==============================================================================
+// SlidingWindowMin
+//==============================================================================
+
+void SlidingWindowMin::prepare(int maxWindow)
+{
+    capacity_ = std::max(1, maxWindow) + 1;
+    values_.assign(static_cast<size_t>(capacity_), 0.0f);
+    indices_.assign(static_cast<size_t>(capacity_), 0);
+    window_ = std::max(1, maxWindow);
+    reset();
+}
+
+void SlidingWindowMin::setWindow(int window)
+{
+    window_ = std::max(1, std::min(window, capacity_ - 1));
+}
+
+void SlidingWindowMin::reset()
+{
+    head_ = 0;
+    count_ = 0;
+    counter_ = 0;
+}
+
+float SlidingWindowMin::push(float value)
+{
+    // Los valores mayores detrás del nuevo ya nunca serán el mínimo
+    while (count_ > 0) {
+        const int back = (head_ + count_ - 1) % capacity_;
+        if (values_[static_cast<size_t>(back)] < value)
+            break;
+        --count_;
+    }
+
+    const int slot = (head_ + count_) % capacity_;
+    values_[static_cast<size_t>(slot)] = value;
+    indices_[static_cast<size_t>(slot)] = counter_;
+    ++count_;
+
+    // El frente caduca al salir de la ventana
+    while (indices_[static_cast<size_t>(head_)] <= counter_ - window_) {
+        head_ = (head_ + 1) % capacity_;
+        --count_;
+    }
+
+    ++counter_;
+    return values_[static_cast<size_t>(head_)];
+}
+
+//==============================================================================
+// LookAheadGainComputer
+//==============================================================================
+
+void LookAheadGainComputer::prepare(int maxWindow)
+{
+    hold_.prepare(std::max(1, maxWindow));
+    boxRing_.assign(static_cast<size_t>(std::max(1, maxWindow)), 1.0f);
+    setWindow(maxWindow);
+}
+
+void LookAheadGainComputer::setWindow(int window)
+{
+    window_ = std::max(1, std::min(window, static_cast<int>(boxRing_.size())));
+    hold_.setWindow(window_);
+    reset();
+}
+
+void LookAheadGainComputer::reset()
+{
+    hold_.reset();
+    std::fill(boxRing_.begin(), boxRing_.end(), 1.0f);
+    boxSum_ = static_cast<double>(window_);
+    boxPos_ = 0;
+    envelope_ = 1.0f;
+}
+
+float LookAheadGainComputer::process(const float* peaks, float* gains, int numSamples, float threshold, float ceiling)
+{
+    const double invWindow = 1.0 / window_;
+    float minGain = 1.0f;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const float peak = peaks[i];
+        const float required = peak > threshold && peak > ceiling ? ceiling / peak : 1.0f;
+        const float held = hold_.push(required);
+
+        // Ataque instantáneo sobre el hold, release exponencial
+        envelope_ = held < envelope_ ? held : held + releaseCoeff_ * (envelope_ - held);
+
+        boxSum_ += static_cast<double>(envelope_) - boxRing_[static_cast<size_t>(boxPos_)];
+        boxRing_[static_cast<size_t>(boxPos_)] = envelope_;
+        boxPos_ = boxPos_ + 1 == window_ ? 0 : boxPos_ + 1;
+
+        const float gain = std::min(1.0f, static_cast<float>(boxSum_ * invWindow));
+        gains[i] = gain;
+        minGain = std::min(minGain, gain);
+    }
+
+    return minGain;
+}
+
+} // namespace OmegaStudio
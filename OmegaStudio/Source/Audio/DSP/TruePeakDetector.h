@@ -0,0 +1,107 @@
+//==============================================================================
+// TruePeakDetector.h - True Peak (ITU-R BS.1770) y ventana look-ahead O(1)
+// FL Studio Killer - Professional DAW
+//==============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace OmegaStudio {
+
+//==============================================================================
+/** Calidad del interpolador polifásico */
+enum class TruePeakQuality {
+    Realtime,       // 12 taps por fase (filtro de referencia de BS.1770)
+    Offline         // 32 taps por fase, factor mínimo 4x
+};
+
+//==============================================================================
+/** Detector de True Peak (ITU-R BS.1770-4, Anexo 2)
+ *  - Interpolador FIR polifásico 2x/4x/8x (sinc con ventana Kaiser)
+ *  - Coeficientes en orden [tap][fase]: todas las fases de un tap en un vector
+ *  - peaks[i] = |máximo| del intervalo del sample i - getLatency()
+ */
+class TruePeakDetector {
+public:
+    void prepare(int oversamplingFactor, TruePeakQuality quality);
+    void reset();
+
+    // Escribe el pico por sample; processMax combina con lo que ya hay (varios canales)
+    void process(const float* input, float* peaks, int numSamples);
+    void processMax(const float* input, float* peaks, int numSamples);
+
+    int getLatency() const { return latency_; }
+    int getFactor() const { return factor_; }
+    int getTapsPerPhase() const { return taps_; }
+
+    // True peak (lineal) de un buffer completo, incluida la cola del filtro
+    static float measure(const float* data, int numSamples,
+                         int oversamplingFactor = 4, TruePeakQuality quality = TruePeakQuality::Offline);
+
+private:
+    template <int Factor, bool Accumulate>
+    void run(const float* input, float* peaks, int numSamples);
+
+    int factor_ = 4;
+    int taps_ = 12;
+    int latency_ = 5;
+
+    std::vector<float> coefficients_;   // taps_ * factor_, [tap][fase]
+    std::vector<float> history_;        // Ventana lineal (2 * taps_) para leer sin wrap
+    int historyPos_ = 0;
+};
+
+//==============================================================================
+/** Mínimo en ventana deslizante: deque monótono, O(1) amortizado por sample */
+class SlidingWindowMin {
+public:
+    void prepare(int maxWindow);
+    void setWindow(int window);
+    void reset();
+
+    float push(float value);
+
+private:
+    std::vector<float> values_;
+    std::vector<int64_t> indices_;
+    int capacity_ = 1;
+    int head_ = 0;
+    int count_ = 0;
+    int window_ = 1;
+    int64_t counter_ = 0;
+};
+
+//==============================================================================
+/** Curva de gain del limitador
+ *  - Gain requerido: ceiling / pico (solo por encima del threshold)
+ *  - Hold de W samples (mínimo en ventana) + release exponencial
+ *  - Media móvil de W samples: el ataque termina justo antes del pico
+ *  Con el audio retrasado getLatency() samples, el gain aplicado nunca supera
+ *  al requerido en ningún sample.
+ */
+class LookAheadGainComputer {
+public:
+    void prepare(int maxWindow);
+    void setWindow(int window);
+    void setRelease(float releaseCoefficient) { releaseCoeff_ = releaseCoefficient; }
+    void reset();
+
+    // gains[i] a partir de peaks[i]; devuelve el gain mínimo del bloque
+    float process(const float* peaks, float* gains, int numSamples, float threshold, float ceiling);
+
+    int getWindow() const { return window_; }
+    int getLatency() const { return window_ - 1; }
+
+private:
+    SlidingWindowMin hold_;
+    std::vector<float> boxRing_;
+    double boxSum_ = 0.0;
+    int boxPos_ = 0;
+    int window_ = 1;
+    float envelope_ = 1.0f;
+    float releaseCoeff_ = 0.999f;
+};
+
+} // namespace OmegaStudio
@@ -9,16 +9,21 @@
 
 namespace omega {
 
+namespace {
+constexpr int kMaxCompChannels = 8;
+}
+
 //==============================================================================
 // VocalCompingEngine Implementation
 //==============================================================================
 
 VocalCompingEngine::VocalCompingEngine() {
+    m_renderer.prepare(2);
 }
 
 void VocalCompingEngine::initialize(double sampleRate) {
     m_sampleRate = sampleRate;
-    m_tempBuffer.setSize(2, static_cast<int>(sampleRate * 10)); // 10 second buffer
+    updateComp();
 }
 
 int VocalCompingEngine::addTake(const juce::AudioBuffer<float>& takeData, const juce::String& takeName) {
@@ -38,20 +43,29 @@ int VocalCompingEngine::addTake(const juce::AudioBuffer<float>& takeData, const
     int takeIndex = static_cast<int>(m_takes.size());
     m_takes.push_back(std::move(take));
     analyzeTakeQuality(takeIndex);
+    updateComp();
     
     return takeIndex;
 }
 
 void VocalCompingEngine::removeTake(int takeIndex) {
     if (takeIndex >= 0 && takeIndex < static_cast<int>(m_takes.size())) {
+        // Freed on return, once the renderer has swapped to the list without it
+        auto removed = std::move(m_takes[static_cast<size_t>(takeIndex)]);
         m_takes.erase(m_takes.begin() + takeIndex);
         
-        // Remove segments referencing this take
+        // Remove segments referencing this take, later takes move down
         m_segments.erase(
             std::remove_if(m_segments.begin(), m_segments.end(),
                 [takeIndex](const CompSegment& seg) { return seg.takeIndex == takeIndex; }),
             m_segments.end()
         );
+        for (auto& segment : m_segments) {
+            if (segment.takeIndex > takeIndex)
+                --segment.takeIndex;
+        }
+        
+        updateComp();
     }
 }
 
@@ -76,12 +90,14 @@ void VocalCompingEngine::addSegment(const CompSegment& segment) {
             [](const CompSegment& a, const CompSegment& b) {
                 return a.startTime < b.startTime;
             });
+        updateComp();
     }
 }
 
 void VocalCompingEngine::removeSegment(int segmentIndex) {
     if (segmentIndex >= 0 && segmentIndex < static_cast<int>(m_segments.size())) {
         m_segments.erase(m_segments.begin() + segmentIndex);
+        updateComp();
     }
 }
 
@@ -99,74 +115,48 @@ const CompSegment* VocalCompingEngine::getSegment(int segmentIndex) const {
 
 void VocalCompingEngine::clearSegments() {
     m_segments.clear();
+    updateComp();
 }
 
-void VocalCompingEngine::compileToBuffer(juce::AudioBuffer<float>& outputBuffer, 
-                                        int startSample, 
-                                        int numSamples) {
-    const double startTime = startSample / m_sampleRate;
-    const double endTime = (startSample + numSamples) / m_sampleRate;
-    
-    // Clear output region
-    for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch) {
-        outputBuffer.clear(ch, startSample, numSamples);
-    }
+void VocalCompingEngine::updateComp() {
+    std::vector<const juce::AudioBuffer<float>*> sources;
+    sources.reserve(m_takes.size());
+    for (const auto& take : m_takes)
+        sources.push_back(&take->audioData);
     
-    // Process each segment that overlaps with the requested range
+    // Takes start at the timeline origin; later segments punch in over earlier ones
+    std::vector<CompRenderer::Region> regions;
+    regions.reserve(m_segments.size());
     for (const auto& segment : m_segments) {
-        if (segment.endTime < startTime || segment.startTime > endTime)
-            continue;  // Segment doesn't overlap
-        
         const VocalTake* take = getTake(segment.takeIndex);
-        if (!take || take->isMuted)
-            continue;
-        
-        // Calculate segment sample range
-        int segmentStartSample = static_cast<int>((segment.startTime - startTime) * m_sampleRate);
-        int segmentEndSample = static_cast<int>((segment.endTime - startTime) * m_sampleRate);
-        
-        segmentStartSample = juce::jmax(0, segmentStartSample);
-        segmentEndSample = juce::jmin(numSamples, segmentEndSample);
-        
-        if (segmentStartSample >= segmentEndSample)
+        if (!segment.isValid() || take == nullptr)
             continue;
         
-        // Calculate source sample position in take
-        int takeStartSample = static_cast<int>(segment.startTime * take->sampleRate);
-        int segmentLength = segmentEndSample - segmentStartSample;
-        
-        // Copy audio from take to output with crossfades
-        for (int ch = 0; ch < juce::jmin(outputBuffer.getNumChannels(), 
-                                         take->audioData.getNumChannels()); ++ch) {
-            const float* srcData = take->audioData.getReadPointer(ch, takeStartSample);
-            float* dstData = outputBuffer.getWritePointer(ch, startSample + segmentStartSample);
-            
-            // Calculate crossfade sample counts
-            int fadeInSamples = static_cast<int>(segment.crossfadeIn * m_sampleRate);
-            int fadeOutSamples = static_cast<int>(segment.crossfadeOut * m_sampleRate);
-            
-            for (int i = 0; i < segmentLength; ++i) {
-                if (takeStartSample + i >= take->audioData.getNumSamples())
-                    break;
-                
-                float gain = take->volume;
-                
-                // Apply fade in
-                if (i < fadeInSamples) {
-                    float fadePos = static_cast<float>(i) / fadeInSamples;
-                    gain *= calculateCrossfadeGain(fadePos, segment.fadeType, true);
-                }
-                
-                // Apply fade out
-                if (i > segmentLength - fadeOutSamples) {
-                    float fadePos = static_cast<float>(segmentLength - i) / fadeOutSamples;
-                    gain *= calculateCrossfadeGain(fadePos, segment.fadeType, true);
-                }
-                
-                dstData[i] += srcData[i] * gain;
-            }
-        }
+        CompRenderer::Region region;
+        region.source = segment.takeIndex;
+        region.start = static_cast<juce::int64>(std::llround(segment.startTime * m_sampleRate));
+        region.end = static_cast<juce::int64>(std::llround(segment.endTime * m_sampleRate));
+        region.fadeIn = static_cast<int>(segment.crossfadeIn * m_sampleRate);
+        region.fadeOut = static_cast<int>(segment.crossfadeOut * m_sampleRate);
+        region.gain = take->isMuted ? 0.0f : take->volume;
+        region.curve = static_cast<CompRenderer::FadeCurve>(segment.fadeType);
+        regions.push_back(region);
     }
+    
+    // One swap: the renderer never sees the new take list with the old segment indices
+    m_renderer.setComp(std::move(sources), std::move(regions));
+}
+
+void VocalCompingEngine::compileToBuffer(juce::AudioBuffer<float>& outputBuffer, 
+                                        int startSample, 
+                                        int numSamples) {
+    // Played straight from the takes, crossfades computed on the fly
+    float* channels[kMaxCompChannels];
+    const int numChannels = juce::jmin(outputBuffer.getNumChannels(), kMaxCompChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[ch] = outputBuffer.getWritePointer(ch, startSample);
+    
+    m_renderer.render(channels, numChannels, startSample, numSamples);
 }
 
 juce::AudioBuffer<float> VocalCompingEngine::exportCompiledComp() {
@@ -174,19 +164,11 @@ juce::AudioBuffer<float> VocalCompingEngine::exportCompiledComp() {
         return juce::AudioBuffer<float>(2, 0);
     }
     
-    // Find total duration
-    double maxEndTime = 0.0;
-    for (const auto& segment : m_segments) {
-        maxEndTime = juce::jmax(maxEndTime, segment.endTime);
-    }
-    
-    int totalSamples = static_cast<int>(maxEndTime * m_sampleRate);
-    juce::AudioBuffer<float> result(2, totalSamples);
-    result.clear();
-    
-    compileToBuffer(result, 0, totalSamples);
+    // Kept between exports: only the ranges edited since the last one re-render
+    m_renderer.setFlattenEnabled(true);
+    m_renderer.updateFlattened();
     
-    return result;
+    return m_renderer.getFlattened();
 }
 
 void VocalCompingEngine::analyzeTakeQuality(int takeIndex) {
@@ -216,7 +198,7 @@ void VocalCompingEngine::autoSelectBestSegments(double segmentDuration) {
     if (m_takes.empty())
         return;
     
-    clearSegments();
+    m_segments.clear();
     
     // Find longest take
     double maxDuration = 0.0;
@@ -253,41 +235,18 @@ void VocalCompingEngine::autoSelectBestSegments(double segmentDuration) {
         segment.crossfadeOut = m_defaultCrossfade;
         segment.fadeType = m_defaultFadeType;
         
-        addSegment(segment);
+        m_segments.push_back(segment);
         
         currentTime = endTime;
     }
+    
+    updateComp();
 }
 
 void VocalCompingEngine::reset() {
     m_takes.clear();
     m_segments.clear();
-}
-
-float VocalCompingEngine::calculateCrossfadeGain(float position, 
-                                                 CompSegment::CrossfadeType type, 
-                                                 bool fadeIn) {
-    position = juce::jlimit(0.0f, 1.0f, position);
-    
-    if (!fadeIn)
-        position = 1.0f - position;
-    
-    switch (type) {
-        case CompSegment::CrossfadeType::Linear:
-            return position;
-            
-        case CompSegment::CrossfadeType::EqualPower:
-            return std::sin(position * juce::MathConstants<float>::halfPi);
-            
-        case CompSegment::CrossfadeType::Logarithmic:
-            return std::exp(position * 2.0f - 2.0f);
-            
-        case CompSegment::CrossfadeType::SCurve:
-            return position * position * (3.0f - 2.0f * position);
-            
-        default:
-            return position;
-    }
+    updateComp();
 }
 
 float VocalCompingEngine::calculateRMS(const float* buffer, int numSamples) {
@@ -6,7 +6,8 @@
  * - Multi-take recording and management
  * - Intelligent selection of best parts
  * - Automatic crossfade creation
- * - Comp compilation and rendering
+ * - Comp compilation and rendering (played straight from the takes through
+ *   CompRenderer; the export is only re-rendered where edits changed it)
  * - Waveform visualization
  */
 
@@ -16,6 +17,7 @@
 #include <vector>
 #include <memory>
 #include "../../Utils/Constants.h"
+#include "CompRenderer.h"
 
 namespace omega {
 
@@ -56,7 +58,7 @@ struct CompSegment {
     float crossfadeOut { 0.01f };
     bool selected { false };
     
-    enum class CrossfadeType {
+    enum class CrossfadeType {     // Same order as CompRenderer::FadeCurve
         Linear,
         EqualPower,
         Logarithmic,
@@ -140,9 +142,15 @@ public:
     void clearSegments();
     
     /**
-     * Compile all segments into final audio
+     * Resync the renderer after editing a take or segment in place
+     * (through getTake/getSegment); only the changed ranges re-render
+     */
+    void updateComp();
+    
+    /**
+     * Compile all segments into final audio (RT-safe)
      * @param outputBuffer Output buffer to write to
-     * @param startSample Starting sample in output
+     * @param startSample Starting sample in output (and on the timeline)
      * @param numSamples Number of samples to render
      */
     void compileToBuffer(juce::AudioBuffer<float>& outputBuffer, 
@@ -182,15 +190,6 @@ public:
     CompSegment::CrossfadeType getDefaultCrossfadeType() const { return m_defaultFadeType; }
     
 private:
-    void applyCrossfade(float* buffer, int numSamples, 
-                       float fadeLevel, 
-                       CompSegment::CrossfadeType type, 
-                       bool fadeIn);
-    
-    float calculateCrossfadeGain(float position, 
-                                CompSegment::CrossfadeType type, 
-                                bool fadeIn);
-    
     // Quality analysis helpers
     float calculateRMS(const float* buffer, int numSamples);
     float analyzePitchStability(const float* buffer, int numSamples);
@@ -199,12 +198,11 @@ private:
     std::vector<std::unique_ptr<VocalTake>> m_takes;
     std::vector<CompSegment> m_segments;
     
+    CompRenderer m_renderer;
+    
     double m_sampleRate { 48000.0 };
     float m_defaultCrossfade { 0.01f };  // 10ms default
     CompSegment::CrossfadeType m_defaultFadeType { CompSegment::CrossfadeType::EqualPower };
-    
-    // Temp buffers
-    juce::AudioBuffer<float> m_tempBuffer;
 };
 
 /**
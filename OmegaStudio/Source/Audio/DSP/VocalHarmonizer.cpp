@@ -90,32 +90,18 @@ HarmonyVoice::HarmonyVoice() {
 
 void HarmonyVoice::initialize(double sampleRate, int maxBlockSize) {
     m_sampleRate = sampleRate;
-    m_pitchShifter.initialize(sampleRate, 2048, 512);
     
     int delaySize = static_cast<int>(sampleRate * 0.1); // 100ms
     m_delayBuffer.setSize(1, delaySize);
     m_delayBuffer.clear();
 }
 
-void HarmonyVoice::process(const float* input, float* output, int numSamples) {
-    if (m_interval == 0) {
-        juce::FloatVectorOperations::copy(output, input, numSamples);
-        juce::FloatVectorOperations::multiply(output, m_level, numSamples);
-        return;
-    }
-    
-    // Calculate pitch ratio
-    float pitchRatio = std::pow(2.0f, m_interval / 12.0f);
-    
-    // Apply pitch shifting
-    m_pitchShifter.process(input, output, numSamples, pitchRatio);
-    
+void HarmonyVoice::process(float* buffer, int numSamples) {
     // Apply level
-    juce::FloatVectorOperations::multiply(output, m_level, numSamples);
+    juce::FloatVectorOperations::multiply(buffer, m_level, numSamples);
 }
 
 void HarmonyVoice::reset() {
-    m_pitchShifter.reset();
     m_delayBuffer.clear();
     m_writePosition = 0;
 }
@@ -142,9 +128,15 @@ void VocalHarmonizer::initialize(double sampleRate, int maxBlockSize) {
     }
     
     m_doubler.initialize(sampleRate, maxBlockSize);
-    m_pitchDetector.initialize(sampleRate, 2048);
+    m_pitchTracker.initialize(sampleRate);
+    m_voicingGain = 0.0f;
+    
+    // Shared analysis for every harmony voice
+    m_shifter.initialize(sampleRate, kMaxVoices, 2048, 512);
+    m_dryDelay.assign(static_cast<size_t>(m_shifter.getLatencySamples()), 0.0f);
+    m_dryDelayPosition = 0;
     
-    m_tempBuffer.setSize(2, maxBlockSize);
+    m_tempBuffer.setSize(kMaxVoices + 1, maxBlockSize);
     
     updateHarmonyVoices();
 }
@@ -154,12 +146,21 @@ void VocalHarmonizer::process(const float* inputBuffer,
                               int numSamples) {
     outputBuffer.clear();
     
+    // Dry path delayed by the shifter latency, aligned with the voices
+    float* dry = m_tempBuffer.getWritePointer(kMaxVoices);
+    const int delaySize = static_cast<int>(m_dryDelay.size());
+    for (int i = 0; i < numSamples; ++i) {
+        dry[i] = m_dryDelay[static_cast<size_t>(m_dryDelayPosition)];
+        m_dryDelay[static_cast<size_t>(m_dryDelayPosition)] = inputBuffer[i];
+        m_dryDelayPosition = (m_dryDelayPosition + 1) % delaySize;
+    }
+    
     // Add dry signal
     float dryGain = 1.0f - m_mix;
     for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch) {
         juce::FloatVectorOperations::addWithMultiply(
             outputBuffer.getWritePointer(ch), 
-            inputBuffer, 
+            dry, 
             dryGain, 
             numSamples
         );
@@ -167,13 +168,32 @@ void VocalHarmonizer::process(const float* inputBuffer,
     
     // Process doubler if enabled
     if (m_doublerEnabled) {
-        m_doubler.process(inputBuffer, 
+        m_doubler.process(dry, 
                          outputBuffer.getWritePointer(0),
                          outputBuffer.getWritePointer(1),
                          numSamples);
         return;
     }
     
+    // Voicing gate: harmonies follow the tracker decision with a 20 ms ramp
+    m_pitchTracker.push(inputBuffer, numSamples);
+    const float gateStart = m_voicingGain;
+    const float gateTarget = m_pitchTracker.getEstimate().voiced ? 1.0f : 0.0f;
+    const float maxChange = static_cast<float>(numSamples / (0.02 * m_sampleRate));
+    m_voicingGain = gateTarget > gateStart ? std::min(gateTarget, gateStart + maxChange)
+                                           : std::max(gateTarget, gateStart - maxChange);
+    const float gateIncrement = (m_voicingGain - gateStart) / static_cast<float>(juce::jmax(1, numSamples));
+    
+    // One analysis of the input, one resynthesis per enabled voice
+    float* voiceOutputs[SpectralPitchShifter::kMaxVoices] = {};
+    for (int v = 0; v < kMaxVoices; ++v) {
+        if (!m_voiceEnabled[v])
+            continue;
+        m_shifter.setPitchRatio(v, m_voices[v]->getPitchRatio());
+        voiceOutputs[v] = m_tempBuffer.getWritePointer(v);
+    }
+    m_shifter.process(inputBuffer, voiceOutputs, numSamples);
+    
     // Process harmony voices
     float wetGain = m_mix * m_harmonyLevel;
     
@@ -181,19 +201,29 @@ void VocalHarmonizer::process(const float* inputBuffer,
         if (!m_voiceEnabled[v])
             continue;
         
-        // Process voice to temp buffer
-        float* tempVoice = m_tempBuffer.getWritePointer(0);
-        m_voices[v]->process(inputBuffer, tempVoice, numSamples);
+        float* tempVoice = voiceOutputs[v];
+        m_voices[v]->process(tempVoice, numSamples);
         
         // Apply pan and add to output
         float pan = m_voices[v]->getPan() * m_width;
         float leftGain = std::cos((pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f) * wetGain;
         float rightGain = std::sin((pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f) * wetGain;
         
-        juce::FloatVectorOperations::addWithMultiply(
-            outputBuffer.getWritePointer(0), tempVoice, leftGain, numSamples);
-        juce::FloatVectorOperations::addWithMultiply(
-            outputBuffer.getWritePointer(1), tempVoice, rightGain, numSamples);
+        if (gateIncrement == 0.0f) {
+            juce::FloatVectorOperations::addWithMultiply(
+                outputBuffer.getWritePointer(0), tempVoice, leftGain * m_voicingGain, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(
+                outputBuffer.getWritePointer(1), tempVoice, rightGain * m_voicingGain, numSamples);
+            continue;
+        }
+        
+        float* left = outputBuffer.getWritePointer(0);
+        float* right = outputBuffer.getWritePointer(1);
+        for (int i = 0; i < numSamples; ++i) {
+            const float gated = tempVoice[i] * (gateStart + gateIncrement * static_cast<float>(i));
+            left[i] += gated * leftGain;
+            right[i] += gated * rightGain;
+        }
     }
 }
 
@@ -202,6 +232,11 @@ void VocalHarmonizer::reset() {
         voice->reset();
     }
     m_doubler.reset();
+    m_pitchTracker.reset();
+    m_shifter.reset();
+    std::fill(m_dryDelay.begin(), m_dryDelay.end(), 0.0f);
+    m_dryDelayPosition = 0;
+    m_voicingGain = 0.0f;
 }
 
 void VocalHarmonizer::updateHarmonyVoices() {
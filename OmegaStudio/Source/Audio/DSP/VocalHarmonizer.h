@@ -15,9 +15,12 @@
 
 #include <JuceHeader.h>
 #include <array>
+#include <cmath>
 #include <vector>
 #include <memory>
 #include "PitchCorrection.h"
+#include "PitchTracker.h"
+#include "SpectralPitchShifter.h"
 #include "../../Utils/Constants.h"
 
 namespace omega {
@@ -109,7 +112,10 @@ private:
 
 /**
  * @class HarmonyVoice
- * @brief Single harmony voice with pitch shifting
+ * @brief Single harmony voice: interval, level and placement
+ *
+ * The shifting itself runs on the harmonizer's SpectralPitchShifter, which
+ * analyses the input once for every voice.
  */
 class HarmonyVoice {
 public:
@@ -117,12 +123,15 @@ public:
     ~HarmonyVoice() = default;
     
     void initialize(double sampleRate, int maxBlockSize);
-    void process(const float* input, float* output, int numSamples);
+    
+    /** Apply the voice level to its shifted signal (in place) */
+    void process(float* buffer, int numSamples);
     void reset();
     
     // Parameters
     void setInterval(int semitones) { m_interval = semitones; }
     int getInterval() const { return m_interval; }
+    float getPitchRatio() const { return std::pow(2.0f, static_cast<float>(m_interval) / 12.0f); }
     
     void setPan(float pan) { m_pan = juce::jlimit(-1.0f, 1.0f, pan); }
     float getPan() const { return m_pan; }
@@ -134,7 +143,6 @@ public:
     float getDelay() const { return m_delay; }
     
 private:
-    PhaseVocoder m_pitchShifter;
     juce::AudioBuffer<float> m_delayBuffer;
     int m_writePosition { 0 };
     
@@ -291,6 +299,28 @@ public:
     void setDoublerEnabled(bool enabled) { m_doublerEnabled = enabled; }
     bool isDoublerEnabled() const { return m_doublerEnabled; }
     
+    // ============ Pitch Tracking ============
+    
+    /**
+     * Detected input pitch in Hz (0.0 when unvoiced)
+     */
+    float getDetectedPitch() const {
+        const auto& estimate = m_pitchTracker.getEstimate();
+        return estimate.voiced ? estimate.frequency : 0.0f;
+    }
+    
+    /**
+     * Harmony voices are faded out while the input is unvoiced
+     * (breaths, sibilants, silence)
+     */
+    bool isVoiced() const { return m_pitchTracker.getEstimate().voiced; }
+    
+    /**
+     * Processing latency (PDC): the dry path is delayed to stay aligned
+     * with the shifted voices
+     */
+    int getLatencySamples() const { return m_shifter.getLatencySamples(); }
+    
 private:
     void updateHarmonyVoices();
     void generateScaleHarmonies(int rootNote);
@@ -300,9 +330,11 @@ private:
     static constexpr int kMaxVoices = 4;
     std::array<std::unique_ptr<HarmonyVoice>, kMaxVoices> m_voices;
     std::array<bool, kMaxVoices> m_voiceEnabled { true, true, false, false };
+    SpectralPitchShifter m_shifter;     // One analysis, one resynthesis per voice
     
     VocalDoubler m_doubler;
-    PitchDetector m_pitchDetector;
+    PitchTracker m_pitchTracker;
+    float m_voicingGain { 0.0f };
     
     Mode m_mode { Mode::ScaleBased };
     Voicing m_voicing { Voicing::Close };
@@ -319,7 +351,9 @@ private:
     
     double m_sampleRate { 48000.0 };
     
-    juce::AudioBuffer<float> m_tempBuffer;
+    juce::AudioBuffer<float> m_tempBuffer;     // One channel per voice plus the delayed dry
+    std::vector<float> m_dryDelay;
+    int m_dryDelayPosition { 0 };
 };
 
 } // namespace omega
@@ -364,24 +364,29 @@ void Vocoder::calculateBandFrequencies(const Params& params) {
 //==============================================================================
 // DistortionSuite Implementation
 //==============================================================================
-void DistortionSuite::prepare(double sr) {
+void DistortionSuite::prepare(double sr, int maxBlockSize, bool nonRealtime) {
     sampleRate = sr;
     lastSample = 0.0f;
+    oversampler.prepare(2, maxBlockSize, oversampling, nonRealtime);
 }
 
 void DistortionSuite::process(juce::AudioBuffer<float>& buffer, const Params& params) {
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-            float input = buffer.getSample(ch, sample);
-            float processed = processSample(input, params);
-            
-            // Mix
-            float output = input * (1.0f - params.mix) + processed * params.mix;
-            output *= params.outputGain;
-            
-            buffer.setSample(ch, sample, output);
-        }
-    }
+    // The shaper runs at the oversampled rate: harmonics above Nyquist are
+    // filtered out on the way down instead of folding back as aliases.
+    // Dry and wet share the resampling, so the mix stays phase-aligned
+    oversampler.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+        [this, &params](float* const* channels, int numChannels, int numSamples) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                float* data = channels[ch];
+                for (int sample = 0; sample < numSamples; ++sample) {
+                    const float input = data[sample];
+                    const float processed = processSample(input, params);
+                    
+                    // Mix
+                    data[sample] = (input * (1.0f - params.mix) + processed * params.mix) * params.outputGain;
+                }
+            }
+        });
 }
 
 float DistortionSuite::processSample(float input, const Params& params) {
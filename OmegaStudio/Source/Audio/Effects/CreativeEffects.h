@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../DSP/Oversampler.h"
 #include <array>
 
 namespace OmegaStudio {
@@ -218,9 +219,14 @@ public:
         float sampleRateReduction = 1.0f; // 1.0 = no reduction
     };
     
-    void prepare(double sampleRate);
+    void prepare(double sampleRate, int maxBlockSize = 512, bool nonRealtime = false);
     void process(juce::AudioBuffer<float>& buffer, const Params& params);
     
+    // Oversampling factors for realtime / offline render, applied in prepare()
+    void setOversampling(const Oversampler::Settings& settings) { oversampling = settings; }
+    const Oversampler::Settings& getOversampling() const { return oversampling; }
+    int getLatencySamples() const { return oversampler.getLatencySamples(); }
+    
 private:
     float processSample(float input, const Params& params);
     float softClip(float x);
@@ -230,6 +236,9 @@ private:
     
     double sampleRate = 44100.0;
     float lastSample = 0.0f;
+    
+    Oversampler::Settings oversampling;
+    Oversampler oversampler;
 };
 
 } // namespace OmegaStudio
@@ -120,59 +120,68 @@ void LuxeVerb::process(juce::AudioBuffer<float>& buffer) {
 
 void PitchShifter::prepare(const juce::dsp::ProcessSpec& spec) {
     sampleRate = spec.sampleRate;
-    for (auto& i : interpolators) i.reset();
+    for (auto& s : shifters) s.initialize(sampleRate, 1);
 }
 
 void PitchShifter::process(juce::AudioBuffer<float>& buffer) {
-    const double ratio = std::pow(2.0, settings.semitones / 12.0);
-    if (ratio == 1.0) return;
+    const float ratio = std::pow(2.0f, settings.semitones / 12.0f);
     const int numSamples = buffer.getNumSamples();
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        juce::AudioBuffer<float> tmp(1, numSamples);
-        auto* src = buffer.getReadPointer(ch);
-        auto* dst = tmp.getWritePointer(0);
-        int outSamples = interpolators[ch].process(ratio, src, dst, numSamples);
-        buffer.copyFrom(ch, 0, tmp, 0, 0, std::min(outSamples, numSamples));
-        if (outSamples < numSamples)
-            buffer.clear(ch, outSamples, numSamples - outSamples);
+    for (int ch = 0; ch < std::min(buffer.getNumChannels(), 2); ++ch) {
+        shifters[ch].setPitchRatio(0, ratio);
+        shifters[ch].process(buffer.getReadPointer(ch), buffer.getWritePointer(ch), numSamples);
     }
 }
 
-void TransientProcessor::prepare(const juce::dsp::ProcessSpec& spec) {
+void TransientProcessor::prepare(const juce::dsp::ProcessSpec& spec, bool nonRealtime) {
     sampleRate = spec.sampleRate;
-    envelope.assign((size_t)spec.maximumBlockSize, 0.0f);
+    oversampler.prepare((int)spec.numChannels, (int)spec.maximumBlockSize, oversampling, nonRealtime);
+    const int factor = oversampler.getFactor();
+    envelope.assign((size_t)spec.maximumBlockSize * (size_t)factor, 0.0f);
+    lastEnvelope = 0.0f;
+    // Same envelope time at any factor
+    smoothing = std::pow(0.9f, 1.0f / (float)factor);
 }
 
 void TransientProcessor::process(juce::AudioBuffer<float>& buffer) {
-    const int numSamples = buffer.getNumSamples();
-    const int numCh = buffer.getNumChannels();
+    oversampler.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+                        [this](float* const* channels, int numCh, int numSamples) {
+                            processOversampled(channels, numCh, numSamples);
+                        });
+}
+
+void TransientProcessor::processOversampled(float* const* channels, int numCh, int numSamples) {
     const float sens = settings.sensitivity;
     const float atk = settings.attack;
     const float sus = settings.sustain;
+    // Per-sample envelope slope shrinks with the factor
+    const float threshold = sens * 0.001f / (float)oversampler.getFactor();
 
+    float previous = lastEnvelope;
     for (int i = 0; i < numSamples; ++i) {
         float env = 0.0f;
         for (int ch = 0; ch < numCh; ++ch)
-            env += std::abs(buffer.getSample(ch, i));
+            env += std::abs(channels[ch][i]);
         env /= (float)numCh;
-        envelope[(size_t)i] = 0.9f * (i > 0 ? envelope[(size_t)(i - 1)] : 0.0f) + 0.1f * env;
+        previous = smoothing * previous + (1.0f - smoothing) * env;
+        envelope[(size_t)i] = previous;
     }
 
-    for (int i = 1; i < numSamples; ++i) {
-        float delta = envelope[(size_t)i] - envelope[(size_t)(i - 1)];
+    for (int i = 0; i < numSamples; ++i) {
+        float delta = envelope[(size_t)i] - (i > 0 ? envelope[(size_t)(i - 1)] : lastEnvelope);
         float gain = 1.0f;
-        if (delta > sens * 0.001f)
+        if (delta > threshold)
             gain = atk;
         else
             gain = sus;
-        for (int ch = 0; ch < numCh; ++ch) {
-            buffer.setSample(ch, i, buffer.getSample(ch, i) * gain);
-        }
+        for (int ch = 0; ch < numCh; ++ch)
+            channels[ch][i] *= gain;
     }
+    lastEnvelope = previous;
 }
 
-void GrossBeatLite::prepare(const juce::dsp::ProcessSpec& spec) {
+void GrossBeatLite::prepare(const juce::dsp::ProcessSpec& spec, bool nonRealtime) {
     sampleRate = spec.sampleRate;
+    oversampler.prepare((int)spec.numChannels, (int)spec.maximumBlockSize, oversampling, nonRealtime);
     if (pattern.empty()) pattern = {1.0f, 0.5f, 1.0f, 0.0f};
 }
 
@@ -182,17 +191,19 @@ void GrossBeatLite::setPattern(const std::vector<float>& patternBeats) {
 
 void GrossBeatLite::process(juce::AudioBuffer<float>& buffer, double bpm) {
     if (pattern.empty()) return;
-    const int numSamples = buffer.getNumSamples();
-    const double samplesPerBeat = (60.0 / bpm) * sampleRate;
-    for (int i = 0; i < numSamples; ++i) {
-        double beatPos = (double)i / samplesPerBeat;
-        int idx = (int)std::fmod(beatPos, (double)pattern.size());
-        float gate = juce::jlimit(0.0f, 1.0f, pattern[(size_t)idx]);
-        float g = 1.0f - settings.gateDepth * (1.0f - gate);
-        g *= settings.rate;
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-            buffer.setSample(ch, i, buffer.getSample(ch, i) * g);
-    }
+    const double samplesPerBeat = (60.0 / bpm) * sampleRate * oversampler.getFactor();
+    oversampler.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+                        [this, samplesPerBeat](float* const* channels, int numCh, int numSamples) {
+        for (int i = 0; i < numSamples; ++i) {
+            double beatPos = (double)i / samplesPerBeat;
+            int idx = (int)std::fmod(beatPos, (double)pattern.size());
+            float gate = juce::jlimit(0.0f, 1.0f, pattern[(size_t)idx]);
+            float g = 1.0f - settings.gateDepth * (1.0f - gate);
+            g *= settings.rate;
+            for (int ch = 0; ch < numCh; ++ch)
+                channels[ch][i] *= g;
+        }
+    });
 }
 
 } // namespace FX
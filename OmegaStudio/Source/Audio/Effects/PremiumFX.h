@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../DSP/Oversampler.h"
+#include "../DSP/SpectralPitchShifter.h"
 
 namespace OmegaStudio {
 namespace FX {
@@ -73,9 +75,11 @@ public:
     void prepare(const juce::dsp::ProcessSpec& spec);
     void setParameters(const PitchShifterSettings& s) { settings = s; }
     void process(juce::AudioBuffer<float>& buffer);
+    // Shared spectral shifter: same length, constant latency (also at 0 semitones)
+    int getLatencySamples() const { return shifters[0].getLatencySamples(); }
 private:
     PitchShifterSettings settings;
-    juce::LagrangeInterpolator interpolators[2];
+    omega::SpectralPitchShifter shifters[2];
     double sampleRate = 44100.0;
 };
 
@@ -87,13 +91,21 @@ struct TransientProcessorSettings {
 
 class TransientProcessor {
 public:
-    void prepare(const juce::dsp::ProcessSpec& spec);
+    void prepare(const juce::dsp::ProcessSpec& spec, bool nonRealtime = false);
     void setParameters(const TransientProcessorSettings& s) { settings = s; }
     void process(juce::AudioBuffer<float>& buffer);
+    // Gain switching runs oversampled; factors apply in prepare()
+    void setOversampling(const Oversampler::Settings& s) { oversampling = s; }
+    int getLatencySamples() const { return oversampler.getLatencySamples(); }
 private:
+    void processOversampled(float* const* channels, int numCh, int numSamples);
     TransientProcessorSettings settings;
     std::vector<float> envelope;
+    float lastEnvelope = 0.0f;
+    float smoothing = 0.9f;
     double sampleRate = 44100.0;
+    Oversampler::Settings oversampling;
+    Oversampler oversampler;
 };
 
 struct GrossBeatSettings {
@@ -103,14 +115,19 @@ struct GrossBeatSettings {
 
 class GrossBeatLite {
 public:
-    void prepare(const juce::dsp::ProcessSpec& spec);
+    void prepare(const juce::dsp::ProcessSpec& spec, bool nonRealtime = false);
     void setPattern(const std::vector<float>& patternBeats); // values 0..1 per step
     void setParameters(const GrossBeatSettings& s) { settings = s; }
     void process(juce::AudioBuffer<float>& buffer, double bpm);
+    // Hard gate edges run oversampled; factors apply in prepare()
+    void setOversampling(const Oversampler::Settings& s) { oversampling = s; }
+    int getLatencySamples() const { return oversampler.getLatencySamples(); }
 private:
     GrossBeatSettings settings;
     std::vector<float> pattern; // one bar
     double sampleRate = 44100.0;
+    Oversampler::Settings oversampling;
+    Oversampler oversampler;
 };
 
 } // namespace FX
@@ -8,6 +8,7 @@
 #include "../Graph/ProcessorNodes.h"
 #include "../Recording/AudioRecorder.h"
 #include "../Plugins/PluginManager.h"
+#include "../../Sequencer/MIDI/MIDIEngine.h"
 #include <juce_audio_devices/juce_audio_devices.h>
 
 namespace Omega::Audio {
@@ -17,6 +18,7 @@ AudioEngine::AudioEngine()
     : deviceManager_(std::make_unique<juce::AudioDeviceManager>())
     , audioGraph_(nullptr)
     , audioMemoryPool_(nullptr)
+    , midiInput_(std::make_unique<OmegaStudio::MIDIInputManager>())
 {
     juce::Logger::writeToLog("OmegaStudio AudioEngine initialized");
 }
@@ -46,6 +48,10 @@ bool AudioEngine::initialize(const AudioEngineConfig& config) {
     // Initialize audio graph and core nodes
     audioGraph_ = std::make_unique<AudioGraph>();
     mixerEngine_ = std::make_unique<OmegaStudio::MixerEngine>();
+    if (!analysisTaps_)
+        analysisTaps_ = std::make_unique<OmegaStudio::AnalysisTapService>();
+    mixerEngine_->setAnalysisTapService(analysisTaps_.get());
+    analysisTaps_->start();
 
     inputNodeId_ = audioGraph_->addNode(std::make_unique<InputNode>(config_.numInputChannels));
     pluginNodeId_ = audioGraph_->addNode(std::make_unique<PluginNode>());
@@ -125,10 +131,13 @@ void AudioEngine::shutdown() {
     }
     
     stop();
+    stopMIDIOutput();
     
     // Remove callback and close device
     deviceManager_->removeAudioCallback(this);
     deviceManager_->closeAudioDevice();
+    if (analysisTaps_)
+        analysisTaps_->stop();
     
     // Cleanup
     audioGraph_.reset();
@@ -195,9 +204,13 @@ void AudioEngine::audioDeviceIOCallbackWithContext(
     // Measure CPU time (for load calculation)
     const auto startTime = juce::Time::getHighResolutionTicks();
     
+    // Callback wake-up time on the same clock used to stamp MIDI input
+    const double callbackTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    
     // Increment statistics
     totalCallbacks_.fetch_add(1, std::memory_order_relaxed);
-    totalSamplesProcessed_.fetch_add(numSamples, std::memory_order_relaxed);
+    const auto blockStartSample = static_cast<int64_t>(
+        totalSamplesProcessed_.fetch_add(numSamples, std::memory_order_relaxed));
     
     // Check if engine is running
     if (state_.load(std::memory_order_acquire) != EngineState::Running) {
@@ -211,7 +224,10 @@ void AudioEngine::audioDeviceIOCallbackWithContext(
     }
     
     // Pull MIDI events from RT queue into buffer
-    pumpMIDIInput(numSamples);
+    pumpMIDIInput(numSamples, callbackTime);
+
+    // Clock/MTC for external gear, stamped against the same filtered block time
+    generateMIDIClock(blockStartSample, numSamples);
 
     // Set external buffers for IO nodes (if present)
     if (audioGraph_) {
@@ -303,6 +319,10 @@ void AudioEngine::audioDeviceAboutToStart(juce::AudioIODevice* device) {
     
     reset();
 
+    midiInputClock_.prepare(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
+    midiClock_.prepare(device->getCurrentSampleRate());
+    midiClock_.setOutputOffsetSeconds(device->getOutputLatencyInSamples() / device->getCurrentSampleRate());
+
     prepareGraph(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
 
     if (recorder_) {
@@ -411,10 +431,37 @@ bool AudioEngine::validateConfig(const AudioEngineConfig& config) const {
     return config.isValid();
 }
 
-void AudioEngine::pumpMIDIInput(int numSamples) {
+void AudioEngine::attachMIDIManager(OmegaStudio::MIDI::MIDIManager* manager) {
+    stopMIDIOutput();
+    midiManager_ = manager;
+    midiInput_->setRealtimeTarget(manager);
+    startMIDIOutput();
+}
+
+void AudioEngine::startMIDIOutput() {
+    if (!midiManager_ || midiOutputThread_) return;
+
+    // Runs without a device too: the queue is drained and the events dropped
+    auto* midiOut = midiManager_->getMIDIOut();
+    midiOutputThread_ = std::make_unique<OmegaStudio::MIDI::MIDIOutputThread>(midiManager_->getOutputQueue());
+    midiOutputThread_->setOutput(midiOut ? midiOut->getMidiOutput() : nullptr);
+    midiOutputThread_->startThread(juce::Thread::Priority::highest);
+}
+
+void AudioEngine::stopMIDIOutput() {
+    if (!midiOutputThread_) return;
+
+    midiOutputThread_->stopThread(1000);
+    midiOutputThread_.reset();
+}
+
+void AudioEngine::pumpMIDIInput(int numSamples, double callbackTime) {
     audioThreadMidi_.clear();
     if (!midiManager_) return;
 
+    // Track the device clock against the hi-res clock every block
+    midiInputClock_.beginBlock(callbackTime, numSamples);
+
     auto& inQueue = midiManager_->getInputQueue();
     auto& outQueue = midiManager_->getOutputQueue();
 
@@ -423,15 +470,35 @@ void AudioEngine::pumpMIDIInput(int numSamples) {
         if (!evOpt.has_value()) break;
 
         auto ev = evOpt.value();
-        const int pos = juce::jlimit(0, juce::jmax(0, numSamples - 1), ev.samplePosition);
-        audioThreadMidi_.addEvent(ev.toMessage(), pos);
 
-        // Echo to output queue for GUI/hardware feedback (non-blocking)
-        outQueue.push(ev);
+        // Stamped live input lands where it was played; untimed events keep their offset
+        const int pos = ev.timestamp > 0.0
+            ? midiInputClock_.toSampleOffset(ev.timestamp)
+            : juce::jlimit(0, juce::jmax(0, numSamples - 1), ev.samplePosition);
+        audioThreadMidi_.addEvent(ev.bytes.data(), static_cast<int>(ev.size), pos);
+
+        // Echo to output queue for GUI/hardware feedback (non-blocking, sent immediately)
+        if (midiThru_.load(std::memory_order_relaxed)) {
+            ev.samplePosition = pos;
+            ev.timestamp = 0.0;
+            outQueue.push(ev);
+        }
     }
 }
 
+void AudioEngine::generateMIDIClock(int64_t blockStartSample, int numSamples) {
+    if (!midiManager_) return;
+
+    midiClock_.process(blockStartSample, numSamples,
+                       midiInputClock_.getBlockTime(),
+                       midiInputClock_.getSecondsPerSample(),
+                       midiManager_->getOutputQueue());
+}
+
 void AudioEngine::prepareGraph(double sampleRate, int blockSize) {
+    // Room for a full input queue so addEvent never allocates on the audio thread
+    audioThreadMidi_.ensureSize(1024 * sizeof(OmegaStudio::MIDI::MIDIManager::RTEvent));
+
     if (!audioGraph_) return;
 
     for (NodeID id : {inputNodeId_, pluginNodeId_, mixerNodeId_, outputNodeId_}) {
@@ -443,6 +510,10 @@ void AudioEngine::prepareGraph(double sampleRate, int blockSize) {
     if (mixerEngine_) {
         mixerEngine_->prepareToPlay(sampleRate, blockSize);
     }
+
+    if (analysisTaps_) {
+        analysisTaps_->prepare(sampleRate);
+    }
 }
 
 bool AudioEngine::addPluginToGraph(const juce::String& pluginUID) {
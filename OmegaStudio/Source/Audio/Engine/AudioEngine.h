@@ -21,11 +21,15 @@
 #include "../Graph/AudioGraph.h"
 #include "../Graph/ProcessorNodes.h"
 #include "../../MIDI/MIDIAdvanced.h"
+#include "../../MIDI/MIDIInputClock.h"
+#include "../../MIDI/MIDIClockGenerator.h"
+#include "../../MIDI/MIDIOutputThread.h"
 #include "../Plugins/PluginManager.h"
 #include "../Mixer/MixerEngine.h"
 
 // Forward declaration of recorder (namespace omega)
 namespace omega { class AudioRecorder; }
+namespace OmegaStudio { class MIDIInputManager; }
 
 namespace Omega::Audio {
 
@@ -125,12 +129,32 @@ public:
     [[nodiscard]] AudioGraph* getAudioGraph() noexcept;
     [[nodiscard]] const AudioGraph* getAudioGraph() const noexcept;
 
+    // Off-audio-thread analysis: the master output and every mixer channel have a
+    // tap here; attach the service's make* analyzers to them and poll the snapshots
+    [[nodiscard]] OmegaStudio::AnalysisTapService* getAnalysisTaps() noexcept { return analysisTaps_.get(); }
+
     // Plugin helpers (convenience wrappers)
     bool addPluginToGraph(const juce::String& pluginUID);
     bool clearGraphPlugins();
 
-    // MIDI Manager attachment (for RT queues)
-    void attachMIDIManager(OmegaStudio::MIDI::MIDIManager* manager) noexcept { midiManager_ = manager; }
+    // MIDI Manager attachment (for RT queues). Live input from getMIDIInput()
+    // is stamped and pushed into the manager's input queue from then on, and
+    // the output thread starts draining its output queue
+    void attachMIDIManager(OmegaStudio::MIDI::MIDIManager* manager);
+
+    // MIDI output thread: sends the output queue to the manager's MIDIOut device at
+    // each event's due time. It keeps the raw device pointer, so stop it before
+    // MIDIOut closes its device and start it again after opening one
+    void startMIDIOutput();
+    void stopMIDIOutput();
+
+    // MIDI input devices; open one here so its notes reach pumpMIDIInput()
+    [[nodiscard]] OmegaStudio::MIDIInputManager& getMIDIInput() noexcept { return *midiInput_; }
+
+    // MIDI clock / MTC / song position, generated sample-accurately into the output queue
+    [[nodiscard]] OmegaStudio::MIDI::MIDIClockGenerator& getMIDIClock() noexcept { return midiClock_; }
+    // Echo live input to the output queue (sent immediately by the MIDI output thread)
+    void setMIDIThru(bool enabled) noexcept { midiThru_.store(enabled, std::memory_order_relaxed); }
 
     //=========================================================================
     // Recording Control (simple arm/record toggle for now)
@@ -174,6 +198,7 @@ private:
     NodeID mixerNodeId_{INVALID_NODE_ID};
     std::unique_ptr<Memory::MemoryPool> audioMemoryPool_;
     std::unique_ptr<omega::AudioRecorder> recorder_;
+    std::unique_ptr<OmegaStudio::AnalysisTapService> analysisTaps_;   // Outlives the mixer's taps
     std::unique_ptr<OmegaStudio::MixerEngine> mixerEngine_;
     
     //==========================================================================
@@ -201,6 +226,11 @@ private:
     Memory::MessageFIFO messageQueue_;  // Audio → GUI messages
     juce::MidiBuffer audioThreadMidi_;
     OmegaStudio::MIDI::MIDIManager* midiManager_ { nullptr }; // non-owning
+    std::unique_ptr<OmegaStudio::MIDIInputManager> midiInput_;
+    std::unique_ptr<OmegaStudio::MIDI::MIDIOutputThread> midiOutputThread_;
+    OmegaStudio::MIDI::MIDIInputClock midiInputClock_;         // audio thread only
+    OmegaStudio::MIDI::MIDIClockGenerator midiClock_;
+    std::atomic<bool> midiThru_{true};
     std::vector<juce::AudioBuffer<float>> channelBuffersStorage_;
     std::vector<juce::AudioBuffer<float>*> channelBufferPtrs_;
     std::vector<juce::MidiBuffer*> midiBufferPtrs_;
@@ -219,7 +249,8 @@ private:
     void updateCpuLoad(double load);
     [[nodiscard]] bool validateConfig(const AudioEngineConfig& config) const;
     void prepareGraph(double sampleRate, int blockSize);
-    void pumpMIDIInput(int numSamples);
+    void pumpMIDIInput(int numSamples, double callbackTime);
+    void generateMIDIClock(int64_t blockStartSample, int numSamples);
 };
 
 } // namespace Omega::Audio
@@ -23,6 +23,7 @@ NodeID AudioGraph::addNode(std::unique_ptr<AudioNode> node) {
     }
     
     const NodeID newId = nextNodeId_++;
+    node->setNonRealtime(nonRealtime_);
     nodes_[newId] = std::move(node);
     adjacency_[newId] = {};
     
@@ -53,6 +54,15 @@ bool AudioGraph::removeNode(NodeID nodeId) {
                 [nodeId](const AudioConnection& c) { return c.destNodeId == nodeId; }),
             edges.end());
     }
+
+    sidechains_.erase(
+        std::remove_if(sidechains_.begin(), sidechains_.end(),
+            [nodeId](const SidechainConnection& c) {
+                return c.sourceNodeId == nodeId || c.destNodeId == nodeId;
+            }),
+        sidechains_.end());
+    nodeBuffers_.erase(nodeId);
+    inputDelays_.erase(nodeId);
     
     nodes_.erase(it);
     rebuildProcessingOrder();
@@ -137,6 +147,64 @@ bool AudioGraph::isConnected(NodeID sourceId, NodeID destId) const {
         });
 }
 
+//==============================================================================
+bool AudioGraph::connectSidechain(NodeID sourceId, NodeID destId) {
+    if (!hasNode(sourceId) || !hasNode(destId) || sourceId == destId) {
+        return false;
+    }
+
+    // One key source per node: reconnecting replaces the previous source
+    auto existing = std::find_if(sidechains_.begin(), sidechains_.end(),
+        [destId](const SidechainConnection& c) { return c.destNodeId == destId; });
+    if (existing != sidechains_.end() && existing->sourceNodeId == sourceId) {
+        return true; // already connected
+    }
+
+    const auto previous = sidechains_;
+    if (existing != sidechains_.end()) {
+        sidechains_.erase(existing);
+    }
+    sidechains_.emplace_back(sourceId, destId);
+
+    // The key must be computed before the consumer: no cycles through sidechains
+    if (detectCycle(sourceId)) {
+        sidechains_ = previous;
+        return false;
+    }
+
+    rebuildProcessingOrder();
+    return true;
+}
+
+//==============================================================================
+bool AudioGraph::disconnectSidechain(NodeID destId) {
+    const auto before = sidechains_.size();
+    sidechains_.erase(
+        std::remove_if(sidechains_.begin(), sidechains_.end(),
+            [destId](const SidechainConnection& c) { return c.destNodeId == destId; }),
+        sidechains_.end());
+
+    if (sidechains_.size() == before) {
+        return false;
+    }
+
+    if (auto* node = getNode(destId)) {
+        node->setSidechainInput(nullptr, 0);
+    }
+    rebuildProcessingOrder();
+    return true;
+}
+
+//==============================================================================
+NodeID AudioGraph::getSidechainSource(NodeID destId) const noexcept {
+    for (const auto& c : sidechains_) {
+        if (c.destNodeId == destId) {
+            return c.sourceNodeId;
+        }
+    }
+    return INVALID_NODE_ID;
+}
+
 //==============================================================================
 void AudioGraph::process(const float* const* inputs, int numInputs,
                         float* const* outputs, int numOutputs,
@@ -160,6 +228,14 @@ void AudioGraph::process(const float* const* inputs, int numInputs,
         }
     }
 
+    // Upstream nodes sum into their destinations while the block runs, so
+    // every buffer (except the preloaded InputNode) is cleared up front
+    for (NodeID nodeId : processingOrder_) {
+        if (nodeId != inputNodeId_) {
+            ensureNodeBuffer(nodeId, channels, numSamples).clear();
+        }
+    }
+
     // Process nodes in topological order
     for (NodeID nodeId : processingOrder_) {
         auto* node = getNode(nodeId);
@@ -167,11 +243,14 @@ void AudioGraph::process(const float* const* inputs, int numInputs,
 
         auto& nodeBuffer = ensureNodeBuffer(nodeId, channels, numSamples);
 
-        // For InputNode buffer already filled; others start cleared
-        if (!dynamic_cast<InputNode*>(node)) {
-            nodeBuffer.clear();
+        // Main input waits for a key that arrives later (PDC on the sidechain)
+        auto inputDelayIt = inputDelays_.find(nodeId);
+        if (inputDelayIt != inputDelays_.end()) {
+            inputDelayIt->second.process(nodeBuffer, nodeBuffer, numSamples);
         }
 
+        bindSidechain(nodeId, *node, channels, numSamples);
+
         // Special handling: OutputNode will copy to external buffers
         node->process(nodeBuffer);
 
@@ -181,6 +260,9 @@ void AudioGraph::process(const float* const* inputs, int numInputs,
             applyLatency(nodeId, nodeBuffer, nodeLatency);
         }
 
+        // Delayed keys are computed once here, whatever the number of consumers
+        runKeyTaps(nodeId, nodeBuffer, numSamples);
+
         // Route to downstream nodes
         auto adjIt = adjacency_.find(nodeId);
         if (adjIt != adjacency_.end()) {
@@ -215,6 +297,14 @@ void AudioGraph::reset() {
     }
 }
 
+void AudioGraph::setNonRealtime(bool isNonRealtime) {
+    nonRealtime_ = isNonRealtime;
+    for (auto& [id, node] : nodes_) {
+        juce::ignoreUnused(id);
+        node->setNonRealtime(isNonRealtime);
+    }
+}
+
 //==============================================================================
 void AudioGraph::clear() {
     nodes_.clear();
@@ -224,7 +314,13 @@ void AudioGraph::clear() {
     nodeBuffers_.clear();
     delayLines_.clear();
     delayIndices_.clear();
+    sidechains_.clear();
+    keyTaps_.clear();
+    sidechainBindings_.clear();
+    tapsBySource_.clear();
+    inputDelays_.clear();
     nextNodeId_ = 1;
+    totalLatency_ = 0;
 }
 
 //==============================================================================
@@ -251,6 +347,9 @@ void AudioGraph::rebuildProcessingOrder() {
     for (const auto& conn : connections_) {
         ++inDegree[conn->destNodeId];
     }
+    for (const auto& sc : sidechains_) {
+        ++inDegree[sc.destNodeId];
+    }
 
     std::queue<NodeID> q;
     for (const auto& [id, deg] : inDegree) {
@@ -264,12 +363,12 @@ void AudioGraph::rebuildProcessingOrder() {
         q.pop();
         processingOrder_.push_back(n);
 
-        for (const auto& edge : adjacency_[n]) {
-            auto it = inDegree.find(edge.destNodeId);
+        forEachSuccessor(n, [&](NodeID dest) {
+            auto it = inDegree.find(dest);
             if (it != inDegree.end() && --(it->second) == 0) {
-                q.push(edge.destNodeId);
+                q.push(dest);
             }
-        }
+        });
     }
 
     // If cycle, fallback to insertion order (already added) to avoid empty order
@@ -280,30 +379,211 @@ void AudioGraph::rebuildProcessingOrder() {
             processingOrder_.push_back(id);
         }
     }
+
+    updateLatencyCompensation();
 }
 
 //==============================================================================
 void AudioGraph::updateLatencyCompensation() {
     totalLatency_ = 0;
-    // Longest-path latency accumulation across the DAG
+    // Longest-path latency accumulation across the DAG. A node's input is as
+    // late as the later of its main input and its key
     std::unordered_map<NodeID, int> latencyByNode;
+    std::unordered_map<NodeID, int> mainInputLatency;
     for (NodeID id : processingOrder_) {
         const auto* node = getNode(id);
         const int nodeLatency = node ? node->getLatencySamples() : 0;
-        int current = nodeLatency;
 
-        // Check predecessors to accumulate longest path to this node
-        for (const auto& [predId, edges] : adjacency_) {
-            for (const auto& e : edges) {
-                if (e.destNodeId == id) {
-                    current = std::max(current, nodeLatency + latencyByNode[predId]);
-                }
-            }
+        int inputLatency = mainInputLatency[id];
+        const NodeID keySource = getSidechainSource(id);
+        if (keySource != INVALID_NODE_ID) {
+            inputLatency = std::max(inputLatency, latencyByNode[keySource]);
         }
 
+        const int current = inputLatency + nodeLatency;
         latencyByNode[id] = current;
         totalLatency_ = std::max(totalLatency_, current);
+
+        auto adjIt = adjacency_.find(id);
+        if (adjIt != adjacency_.end()) {
+            for (const auto& e : adjIt->second) {
+                auto& dest = mainInputLatency[e.destNodeId];
+                dest = std::max(dest, current);
+            }
+        }
     }
+
+    rebuildSidechainPlan(latencyByNode, mainInputLatency);
+}
+
+//==============================================================================
+void AudioGraph::rebuildSidechainPlan(const std::unordered_map<NodeID, int>& outputLatency,
+                                      const std::unordered_map<NodeID, int>& mainInputLatency) {
+    auto latencyOf = [](const std::unordered_map<NodeID, int>& map, NodeID id) {
+        auto it = map.find(id);
+        return it != map.end() ? it->second : 0;
+    };
+
+    // Taps that survive keep their delay state (no click on re-plan)
+    std::vector<KeyTap> previousTaps = std::move(keyTaps_);
+    keyTaps_.clear();
+    sidechainBindings_.clear();
+    tapsBySource_.clear();
+
+    std::unordered_map<NodeID, DelayLine> previousInputDelays = std::move(inputDelays_);
+    inputDelays_.clear();
+
+    for (const auto& sc : sidechains_) {
+        SidechainBinding binding;
+        binding.sourceNodeId = sc.sourceNodeId;
+
+        const int keyLatency = latencyOf(outputLatency, sc.sourceNodeId);
+        const int mainLatency = latencyOf(mainInputLatency, sc.destNodeId);
+        binding.keyDelay = std::max(0, mainLatency - keyLatency);
+        binding.inputDelay = std::max(0, keyLatency - mainLatency);
+
+        if (binding.keyDelay > 0) {
+            // Same source and same delay: same tap, whatever the consumer
+            auto& taps = tapsBySource_[sc.sourceNodeId];
+            auto shared = std::find_if(taps.begin(), taps.end(),
+                [&](int index) { return keyTaps_[static_cast<size_t>(index)].delaySamples == binding.keyDelay; });
+
+            if (shared != taps.end()) {
+                binding.tapIndex = *shared;
+            } else {
+                KeyTap tap;
+                auto old = std::find_if(previousTaps.begin(), previousTaps.end(),
+                    [&](const KeyTap& t) {
+                        return t.sourceNodeId == sc.sourceNodeId && t.delaySamples == binding.keyDelay;
+                    });
+                if (old != previousTaps.end()) {
+                    tap = std::move(*old);
+                } else {
+                    tap.sourceNodeId = sc.sourceNodeId;
+                    tap.delaySamples = binding.keyDelay;
+                    tap.delay.length = binding.keyDelay;
+                }
+
+                // Pre-size with the last block's format so the audio thread doesn't allocate
+                if (scratchChannels_ > 0 && scratchBlockSize_ > 0) {
+                    tap.delay.setSize(scratchChannels_, tap.delaySamples);
+                    if (tap.buffer.getNumChannels() != scratchChannels_ || tap.buffer.getNumSamples() < scratchBlockSize_) {
+                        tap.buffer.setSize(scratchChannels_, scratchBlockSize_, false, true, true);
+                    }
+                }
+
+                binding.tapIndex = static_cast<int>(keyTaps_.size());
+                taps.push_back(binding.tapIndex);
+                keyTaps_.push_back(std::move(tap));
+            }
+        }
+
+        if (binding.inputDelay > 0) {
+            auto old = previousInputDelays.find(sc.destNodeId);
+            auto& line = inputDelays_[sc.destNodeId];
+            if (old != previousInputDelays.end()) {
+                line = std::move(old->second);
+            }
+            if (scratchChannels_ > 0) {
+                line.setSize(scratchChannels_, binding.inputDelay);
+            } else {
+                line.length = binding.inputDelay;
+            }
+        }
+
+        sidechainBindings_[sc.destNodeId] = binding;
+    }
+}
+
+//==============================================================================
+void AudioGraph::bindSidechain(NodeID nodeId, AudioNode& node, int channels, int numSamples) {
+    juce::ignoreUnused(channels);
+
+    auto it = sidechainBindings_.find(nodeId);
+    if (it == sidechainBindings_.end()) {
+        node.setSidechainInput(nullptr, 0);
+        return;
+    }
+
+    const auto& binding = it->second;
+    if (binding.tapIndex >= 0) {
+        node.setSidechainInput(&keyTaps_[static_cast<size_t>(binding.tapIndex)].buffer, numSamples);
+        return;
+    }
+
+    // Aligned already: the consumer reads the source's own buffer
+    auto bufferIt = nodeBuffers_.find(binding.sourceNodeId);
+    node.setSidechainInput(bufferIt != nodeBuffers_.end() ? &bufferIt->second : nullptr, numSamples);
+}
+
+//==============================================================================
+void AudioGraph::runKeyTaps(NodeID sourceId, const juce::AudioBuffer<float>& sourceBuffer, int numSamples) {
+    auto it = tapsBySource_.find(sourceId);
+    if (it == tapsBySource_.end()) {
+        return;
+    }
+
+    const int channels = sourceBuffer.getNumChannels();
+    for (int index : it->second) {
+        auto& tap = keyTaps_[static_cast<size_t>(index)];
+        if (tap.buffer.getNumChannels() != channels || tap.buffer.getNumSamples() < numSamples) {
+            tap.buffer.setSize(channels, numSamples, false, true, true);
+        }
+        tap.delay.process(sourceBuffer, tap.buffer, numSamples);
+    }
+}
+
+//==============================================================================
+int AudioGraph::getSidechainDelay(NodeID destId) const noexcept {
+    auto it = sidechainBindings_.find(destId);
+    return it != sidechainBindings_.end() ? it->second.keyDelay : 0;
+}
+
+//==============================================================================
+int AudioGraph::getInputDelay(NodeID destId) const noexcept {
+    auto it = sidechainBindings_.find(destId);
+    return it != sidechainBindings_.end() ? it->second.inputDelay : 0;
+}
+
+//==============================================================================
+void AudioGraph::DelayLine::setSize(int numChannels, int delaySamples) {
+    const size_t needed = static_cast<size_t>(numChannels) * static_cast<size_t>(delaySamples);
+    if (numChannels == channels && delaySamples == length && data.size() == needed) {
+        return;
+    }
+    channels = numChannels;
+    length = delaySamples;
+    writePos = 0;
+    data.assign(static_cast<size_t>(channels) * static_cast<size_t>(length), 0.0f);
+}
+
+//==============================================================================
+void AudioGraph::DelayLine::process(const juce::AudioBuffer<float>& input,
+                                    juce::AudioBuffer<float>& output, int numSamples) {
+    const int numChannels = juce::jmin(input.getNumChannels(), output.getNumChannels());
+    setSize(numChannels, length);
+    if (length <= 0) {
+        return;
+    }
+
+    // Sample by sample so that input and output may be the same buffer
+    int pos = writePos;
+    for (int ch = 0; ch < channels; ++ch) {
+        const float* in = input.getReadPointer(ch);
+        float* out = output.getWritePointer(ch);
+        float* line = data.data() + static_cast<size_t>(ch) * static_cast<size_t>(length);
+
+        pos = writePos;
+        for (int i = 0; i < numSamples; ++i) {
+            const float current = in[i];
+            out[i] = line[pos];
+            line[pos] = current;
+            if (++pos == length) {
+                pos = 0;
+            }
+        }
+    }
+    writePos = pos;
 }
 
 //==============================================================================
@@ -323,13 +603,12 @@ bool AudioGraph::detectCycle(NodeID startNode) const {
         }
 
         visitState[n] = 1;
-        auto adjIt = adjacency_.find(n);
-        if (adjIt != adjacency_.end()) {
-            for (const auto& edge : adjIt->second) {
-                if (dfs(edge.destNodeId)) {
-                    return true;
-                }
-            }
+        bool cycle = false;
+        forEachSuccessor(n, [&](NodeID dest) {
+            cycle = cycle || dfs(dest);
+        });
+        if (cycle) {
+            return true;
         }
         visitState[n] = 2;
         return false;
@@ -338,6 +617,22 @@ bool AudioGraph::detectCycle(NodeID startNode) const {
     return dfs(startNode);
 }
 
+//==============================================================================
+template <typename Fn>
+void AudioGraph::forEachSuccessor(NodeID nodeId, Fn&& fn) const {
+    auto adjIt = adjacency_.find(nodeId);
+    if (adjIt != adjacency_.end()) {
+        for (const auto& edge : adjIt->second) {
+            fn(edge.destNodeId);
+        }
+    }
+    for (const auto& sc : sidechains_) {
+        if (sc.sourceNodeId == nodeId) {
+            fn(sc.destNodeId);
+        }
+    }
+}
+
 //==============================================================================
 bool AudioGraph::hasNode(NodeID nodeId) const noexcept {
     return nodes_.find(nodeId) != nodes_.end();
@@ -373,8 +668,10 @@ void AudioGraph::ensureScratchBuffer(int channels, int numSamples) {
 
 //==============================================================================
 juce::AudioBuffer<float>& AudioGraph::ensureNodeBuffer(NodeID id, int channels, int numSamples) {
+    // Exactly one block long, so nodes and per-node latency never run past it.
+    // Shrinking keeps the allocation (avoidReallocating)
     auto& buf = nodeBuffers_[id];
-    if (buf.getNumChannels() != channels || buf.getNumSamples() < numSamples) {
+    if (buf.getNumChannels() != channels || buf.getNumSamples() != numSamples) {
         buf.setSize(channels, numSamples, false, false, true);
     }
     return buf;
@@ -7,6 +7,8 @@
 // - Edges represent audio connections
 // - Topological sorting ensures correct processing order
 // - Automatic latency compensation (PDC)
+// - Sidechain edges feed a node's secondary input (key) bus, aligned with
+//   its main input and shared by every consumer of the same source
 //==============================================================================
 
 #pragma once
@@ -46,6 +48,18 @@ struct AudioConnection {
         : sourceNodeId(src), sourceChannel(srcCh), destNodeId(dst), destChannel(dstCh) {}
 };
 
+//==============================================================================
+// SidechainConnection - Key signal from a node's output to another node's
+// secondary input bus
+//==============================================================================
+struct SidechainConnection {
+    NodeID sourceNodeId;
+    NodeID destNodeId;
+    
+    SidechainConnection(NodeID src, NodeID dst)
+        : sourceNodeId(src), destNodeId(dst) {}
+};
+
 //==============================================================================
 // AudioGraph - Manages the audio processing graph
 //==============================================================================
@@ -75,6 +89,18 @@ public:
                                   NodeID destId, int destChannel);
     [[nodiscard]] bool isConnected(NodeID sourceId, NodeID destId) const;
 
+    //==========================================================================
+    // Sidechain Management
+    // A node takes at most one key source. Sources are scheduled before their
+    // consumers and the key is delay-compensated against the consumer's main
+    // input; consumers with the same source and delay read the same buffer
+    //==========================================================================
+    [[nodiscard]] bool connectSidechain(NodeID sourceId, NodeID destId);
+    [[nodiscard]] bool disconnectSidechain(NodeID destId);
+    [[nodiscard]] NodeID getSidechainSource(NodeID destId) const noexcept;
+    [[nodiscard]] size_t getNumSidechainConnections() const noexcept { return sidechains_.size(); }
+    [[nodiscard]] size_t getNumSidechainTaps() const noexcept { return keyTaps_.size(); }
+
     void setInputNodeId(NodeID id) noexcept { inputNodeId_ = id; }
     void setOutputNodeId(NodeID id) noexcept { outputNodeId_ = id; }
     
@@ -90,6 +116,11 @@ public:
     //==========================================================================
     void reset();
     void clear();
+    
+    // Render mode for every node. Re-prepare the nodes and call
+    // updateLatencyCompensation() afterwards: latencies may change
+    void setNonRealtime(bool isNonRealtime);
+    [[nodiscard]] bool isNonRealtime() const noexcept { return nonRealtime_; }
     [[nodiscard]] size_t getNumNodes() const noexcept;
     [[nodiscard]] size_t getNumConnections() const noexcept;
     
@@ -99,7 +130,42 @@ public:
     void updateLatencyCompensation();
     [[nodiscard]] int getTotalLatency() const noexcept;
     
+    // Delay applied to a node's key (sidechain) and main inputs to align them
+    [[nodiscard]] int getSidechainDelay(NodeID destId) const noexcept;
+    [[nodiscard]] int getInputDelay(NodeID destId) const noexcept;
+    
 private:
+    //==========================================================================
+    // Sidechain plan (rebuilt with the latency compensation)
+    //==========================================================================
+    // Circular delay per channel, sized off the audio thread when possible
+    struct DelayLine {
+        std::vector<float> data;
+        int length { 0 };
+        int channels { 0 };
+        int writePos { 0 };
+        
+        void setSize(int numChannels, int delaySamples);
+        void process(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output, int numSamples);
+    };
+    
+    // One delayed copy per (source, delay) pair. Delay 0 needs no tap:
+    // consumers read the source's node buffer directly
+    struct KeyTap {
+        NodeID sourceNodeId { INVALID_NODE_ID };
+        int delaySamples { 0 };
+        DelayLine delay;
+        juce::AudioBuffer<float> buffer;
+    };
+    
+    struct SidechainBinding {
+        NodeID sourceNodeId { INVALID_NODE_ID };
+        int tapIndex { -1 };           // -1 = source node buffer (zero-copy)
+        int keyDelay { 0 };
+        int inputDelay { 0 };          // Main input delayed when the key arrives later
+    };
+    
+
     //==========================================================================
     // Internal State
     //==========================================================================
@@ -119,13 +185,25 @@ private:
     std::unordered_map<NodeID, std::vector<float>> delayLines_;
     std::unordered_map<NodeID, size_t> delayIndices_;
     
+    std::vector<SidechainConnection> sidechains_;
+    std::vector<KeyTap> keyTaps_;
+    std::unordered_map<NodeID, SidechainBinding> sidechainBindings_;
+    std::unordered_map<NodeID, std::vector<int>> tapsBySource_;
+    std::unordered_map<NodeID, DelayLine> inputDelays_;
+    
     NodeID nextNodeId_{1};
     int totalLatency_{0};
+    bool nonRealtime_{false};
     
     //==========================================================================
     // Internal Methods
     //==========================================================================
     void rebuildProcessingOrder();
+    void rebuildSidechainPlan(const std::unordered_map<NodeID, int>& outputLatency,
+                              const std::unordered_map<NodeID, int>& mainInputLatency);
+    void bindSidechain(NodeID nodeId, AudioNode& node, int channels, int numSamples);
+    void runKeyTaps(NodeID sourceId, const juce::AudioBuffer<float>& sourceBuffer, int numSamples);
+    template <typename Fn> void forEachSuccessor(NodeID nodeId, Fn&& fn) const;
     [[nodiscard]] bool detectCycle(NodeID startNode) const;
     [[nodiscard]] bool hasNode(NodeID nodeId) const noexcept;
     [[nodiscard]] bool connectionExists(NodeID sourceId, int sourceChannel,
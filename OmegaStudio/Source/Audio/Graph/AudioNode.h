@@ -55,6 +55,26 @@ public:
     //==========================================================================
     [[nodiscard]] virtual int getLatencySamples() const noexcept { return 0; }
     
+    //==========================================================================
+    // Render mode
+    // Set before prepare(): offline renders may pick costlier settings
+    // (e.g. higher oversampling) and so report a different latency
+    //==========================================================================
+    void setNonRealtime(bool isNonRealtime) noexcept { nonRealtime_ = isNonRealtime; }
+    [[nodiscard]] bool isNonRealtime() const noexcept { return nonRealtime_; }
+    
+    //==========================================================================
+    // Sidechain (secondary input bus)
+    // Bound by AudioGraph before each process() call; nullptr when the node
+    // has no key source. Read-only and shared with other consumers
+    //==========================================================================
+    void setSidechainInput(const juce::AudioBuffer<float>* key, int numSamples) noexcept {
+        sidechain_ = key;
+        sidechainSamples_ = numSamples;
+    }
+    [[nodiscard]] const juce::AudioBuffer<float>* getSidechainInput() const noexcept { return sidechain_; }
+    [[nodiscard]] int getSidechainNumSamples() const noexcept { return sidechainSamples_; }
+    
     //==========================================================================
     // Bypass
     //==========================================================================
@@ -65,6 +85,9 @@ protected:
     NodeType type_;
     std::string name_;
     bool bypassed_{false};
+    bool nonRealtime_{false};
+    const juce::AudioBuffer<float>* sidechain_{nullptr};
+    int sidechainSamples_{0};
 };
 
 } // namespace Omega::Audio
@@ -149,4 +149,90 @@ void MixerNode::reset() {
 	masterBuffer_.clear();
 }
 
+//==============================================================================
+// SidechainCompressorNode
+//==============================================================================
+void SidechainCompressorNode::prepare(double sampleRate, int maxBlockSize) {
+	sampleRate_ = sampleRate;
+	blockSize_ = maxBlockSize;
+	compressor_.prepare(sampleRate_, blockSize_);
+	compressor_.setParameters(params_);
+}
+
+void SidechainCompressorNode::process(juce::AudioBuffer<float>& buffer) {
+	if (bypassed_) {
+		return;
+	}
+
+	// The key is read in place from the source (or its shared delay tap)
+	const auto* key = getSidechainInput();
+	if (key != nullptr && getSidechainNumSamples() < buffer.getNumSamples()) {
+		key = nullptr;
+	}
+
+	if (params_.externalSidechain != (key != nullptr)) {
+		params_.externalSidechain = key != nullptr;
+		compressor_.setParameters(params_);
+	}
+	compressor_.process(buffer, key);
+}
+
+void SidechainCompressorNode::reset() {
+	compressor_.prepare(sampleRate_, blockSize_);
+	compressor_.setParameters(params_);
+}
+
+void SidechainCompressorNode::setParameters(const OmegaStudio::Audio::DSP::SidechainCompressor::Parameters& params) {
+	const bool external = params_.externalSidechain;
+	params_ = params;
+	params_.externalSidechain = external;
+	compressor_.setParameters(params_);
+}
+
+//==============================================================================
+// DistortionNode
+//==============================================================================
+void DistortionNode::prepare(double sampleRate, int maxBlockSize) {
+	sampleRate_ = sampleRate;
+	blockSize_ = maxBlockSize;
+	distortion_.prepare(sampleRate_, blockSize_, isNonRealtime());
+}
+
+void DistortionNode::process(juce::AudioBuffer<float>& buffer) {
+	// Bypassed: dry signal through the same resampling, so the latency
+	// reported to PDC still holds
+	if (bypassed_) {
+		OmegaStudio::DistortionSuite::Params dry = params_;
+		dry.mix = 0.0f;
+		dry.outputGain = 1.0f;
+		distortion_.process(buffer, dry);
+		return;
+	}
+
+	distortion_.process(buffer, params_);
+}
+
+void DistortionNode::reset() {
+	distortion_.prepare(sampleRate_, blockSize_, isNonRealtime());
+}
+
+//==============================================================================
+// DenoiseNode
+//==============================================================================
+void DenoiseNode::prepare(double sampleRate, int maxBlockSize) {
+	sampleRate_ = sampleRate;
+	blockSize_ = maxBlockSize;
+	const double frameSeconds = isNonRealtime() ? kOfflineFrameSeconds : kRealtimeFrameSeconds;
+	denoiser_.prepare(sampleRate_, 2, omega::SpectralDenoiser::fftSizeForDuration(sampleRate_, frameSeconds));
+}
+
+void DenoiseNode::process(juce::AudioBuffer<float>& buffer) {
+	// Bypassed: unity gains through the same STFT, so the PDC latency holds
+	denoiser_.process(buffer, bypassed_);
+}
+
+void DenoiseNode::reset() {
+	denoiser_.reset();
+}
+
 } // namespace Omega::Audio
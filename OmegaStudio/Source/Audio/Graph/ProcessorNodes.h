@@ -9,6 +9,9 @@
 #include "AudioNode.h"
 #include "../Plugins/PluginManager.h"
 #include "../../Mixer/MixerEngine.h"
+#include "../DSP/SidechainCompression.h"
+#include "../Effects/CreativeEffects.h"
+#include "../DSP/SpectralDenoiser.h"
 
 namespace Omega::Audio {
 
@@ -106,4 +109,87 @@ private:
 	int blockSize_ { 512 };
 };
 
+//==============================================================================
+// SidechainCompressorNode - ducks its main input from the graph's key bus
+// (AudioGraph::connectSidechain). Without a key it compresses on itself
+//==============================================================================
+class SidechainCompressorNode : public AudioNode {
+public:
+	SidechainCompressorNode()
+		: AudioNode(NodeType::Effect, "SidechainCompressor") {}
+
+	void prepare(double sampleRate, int maxBlockSize) override;
+	void process(juce::AudioBuffer<float>& buffer) override;
+	void reset() override;
+
+	void setParameters(const OmegaStudio::Audio::DSP::SidechainCompressor::Parameters& params);
+	float getCurrentGainReduction() const { return compressor_.getCurrentGainReduction(); }
+
+private:
+	OmegaStudio::Audio::DSP::SidechainCompressor compressor_;
+	OmegaStudio::Audio::DSP::SidechainCompressor::Parameters params_;
+	double sampleRate_ { 48000.0 };
+	int blockSize_ { 512 };
+};
+
+//==============================================================================
+// DistortionNode - DistortionSuite insert. The shaper runs oversampled at the
+// factor picked for the render mode (setNonRealtime) and the resampling
+// latency is reported to the graph's PDC
+//==============================================================================
+class DistortionNode : public AudioNode {
+public:
+	DistortionNode()
+		: AudioNode(NodeType::Effect, "Distortion") {}
+
+	void prepare(double sampleRate, int maxBlockSize) override;
+	void process(juce::AudioBuffer<float>& buffer) override;
+	void reset() override;
+
+	int getLatencySamples() const noexcept override { return distortion_.getLatencySamples(); }
+
+	void setParameters(const OmegaStudio::DistortionSuite::Params& params) { params_ = params; }
+
+	// Takes effect on the next prepare(); call updateLatencyCompensation() after
+	void setOversampling(const OmegaStudio::Oversampler::Settings& settings) { distortion_.setOversampling(settings); }
+
+private:
+	OmegaStudio::DistortionSuite distortion_;
+	OmegaStudio::DistortionSuite::Params params_;
+	double sampleRate_ { 48000.0 };
+	int blockSize_ { 512 };
+};
+
+//==============================================================================
+// DenoiseNode - streaming noise reduction for live inputs (e.g. vocals while
+// tracking). The noise is tracked continuously or learned from a region
+// (setLearning); the STFT frame is short when tracking, longer for offline
+// renders (setNonRealtime), and its latency is reported to the graph's PDC
+//==============================================================================
+class DenoiseNode : public AudioNode {
+public:
+	DenoiseNode()
+		: AudioNode(NodeType::Effect, "Denoise") {}
+
+	static constexpr double kRealtimeFrameSeconds = 0.008;
+	static constexpr double kOfflineFrameSeconds = 0.04;
+
+	void prepare(double sampleRate, int maxBlockSize) override;
+	void process(juce::AudioBuffer<float>& buffer) override;
+	void reset() override;
+
+	int getLatencySamples() const noexcept override { return denoiser_.getLatencySamples(); }
+
+	void setParameters(const omega::SpectralDenoiser::Parameters& params) { denoiser_.setParameters(params); }
+
+	// Thread-safe: the profile is committed when learning stops
+	void setLearning(bool shouldLearn) noexcept { denoiser_.setLearning(shouldLearn); }
+	bool hasNoiseProfile() const noexcept { return denoiser_.hasNoiseProfile(); }
+
+private:
+	omega::SpectralDenoiser denoiser_;
+	double sampleRate_ { 48000.0 };
+	int blockSize_ { 512 };
+};
+
 } // namespace Omega::Audio
@@ -217,7 +217,7 @@ int SampleManager::scanDirectory(const juce::File& directory,
     }
 
     // Find all audio files
-    std::vector<juce::File> audioFiles;
+    juce::Array<juce::File> audioFiles;
     
     juce::Array<juce::File> files;
     directory.findChildFiles(files,
@@ -227,16 +227,22 @@ int SampleManager::scanDirectory(const juce::File& directory,
 
     for (const auto& file : files) {
         if (isAudioFile(file)) {
-            audioFiles.push_back(file);
+            audioFiles.add(file);
         }
     }
 
+    // Analyse the new files on every core first: the imports below then only
+    // read the feature store
+    if (m_autoAnalysis) {
+        Analysis::AudioFeatureStore::getInstance().analyseFiles(audioFiles);
+    }
+
     // Import files
     int imported = 0;
-    for (size_t i = 0; i < audioFiles.size(); ++i) {
+    for (int i = 0; i < audioFiles.size(); ++i) {
         if (progressCallback) {
-            progressCallback(static_cast<int>(i), 
-                           static_cast<int>(audioFiles.size()),
+            progressCallback(i, 
+                           audioFiles.size(),
                            audioFiles[i].getFileName());
         }
 
@@ -407,24 +413,21 @@ bool SampleManager::analyzeSample(const juce::String& uuid) {
         return false;
     }
 
-    // Load sample if not loaded
-    bool wasLoaded = sample->isLoaded();
-    if (!wasLoaded) {
-        if (!sample->load()) {
-            return false;
-        }
-    }
+    // The store decodes the file only if it was never analysed (a loaded
+    // sample is analysed from memory)
+    auto& store = Analysis::AudioFeatureStore::getInstance();
+    const auto& metadata = sample->getMetadata();
+    const auto* buffer = sample->isLoaded() ? sample->getBuffer() : nullptr;
 
-    // Detect BPM and key
-    bool bpmSuccess = detectBPM(sample.get());
-    bool keySuccess = detectKey(sample.get());
+    auto features = buffer != nullptr
+        ? store.getFeatures(metadata.filePath, *buffer, metadata.sampleRate)
+        : store.getFeatures(metadata.filePath);
 
-    // Unload if we loaded it
-    if (!wasLoaded) {
-        sample->unload();
+    if (!features) {
+        return false;
     }
 
-    return bpmSuccess || keySuccess;
+    return applyFeatures(sample.get(), features->summary);
 }
 
 juce::Image SampleManager::generateThumbnail(const juce::String& uuid, int width, int height) {
@@ -618,6 +621,16 @@ SampleMetadata SampleManager::extractMetadata(const juce::File& file) {
     metadata.filePath = file;
     metadata.dateAdded = juce::Time::getCurrentTime();
 
+    // Known to the feature store: no need to open the file
+    Analysis::AudioFeatureSummary summary;
+    if (Analysis::AudioFeatureStore::getInstance().getCachedSummary(file, summary)) {
+        metadata.sampleRate = summary.sampleRate;
+        metadata.numChannels = summary.numChannels;
+        metadata.lengthInSamples = summary.lengthInSamples;
+        metadata.lengthInSeconds = summary.lengthInSamples / summary.sampleRate;
+        return metadata;
+    }
+
     // Read audio properties
     auto reader = std::unique_ptr<juce::AudioFormatReader>(
         m_formatManager.createReaderFor(file)
@@ -637,41 +650,21 @@ juce::String SampleManager::generateUUID() const {
     return juce::Uuid().toString();
 }
 
-bool SampleManager::detectBPM(Sample* sample) {
-    if (!sample || !sample->isLoaded()) {
-        return false;
-    }
-
-    BPMDetector detector;
-    float bpm = detector.detectBPM(*sample->getBuffer(), sample->getMetadata().sampleRate);
-
-    if (bpm > 0.0f) {
-        SampleMetadata meta = sample->getMetadata();
-        meta.bpm = bpm;
-        sample->updateMetadata(meta);
-        return true;
-    }
-
-    return false;
-}
-
-bool SampleManager::detectKey(Sample* sample) {
-    if (!sample || !sample->isLoaded()) {
+bool SampleManager::applyFeatures(Sample* sample, const Analysis::AudioFeatureSummary& summary) {
+    if (!sample) {
         return false;
     }
 
-    KeyDetector detector;
-    int key = detector.detectKey(*sample->getBuffer(), sample->getMetadata().sampleRate);
+    SampleMetadata meta = sample->getMetadata();
+    meta.bpm = summary.bpm;
+    meta.key = summary.key;
+    meta.keyName = summary.key >= 0 ? summary.getKeyName() : juce::String();
+    meta.peakLevel = juce::Decibels::decibelsToGain(summary.peakDb);
+    meta.rmsLevel = juce::Decibels::decibelsToGain(summary.rmsDb);
+    meta.hasAnalysis = true;
+    sample->updateMetadata(meta);
 
-    if (key >= 0) {
-        SampleMetadata meta = sample->getMetadata();
-        meta.key = key;
-        meta.keyName = KeyDetector::getKeyName(key);
-        sample->updateMetadata(meta);
-        return true;
-    }
-
-    return false;
+    return summary.bpm > 0.0f || summary.key >= 0;
 }
 
 void SampleManager::manageCacheSize() {
@@ -689,83 +682,19 @@ void SampleManager::manageCacheSize() {
 BPMDetector::BPMDetector() = default;
 
 float BPMDetector::detectBPM(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-    // Simplified BPM detection using energy-based onset detection
-    // For production, use librosa or essentia for better accuracy
-
-    const int hopSize = 512;
-    const int numFrames = buffer.getNumSamples() / hopSize;
-    
-    std::vector<float> energy(numFrames);
-
-    // Calculate energy for each frame
-    for (int frame = 0; frame < numFrames; ++frame) {
-        float frameEnergy = 0.0f;
-        int startSample = frame * hopSize;
-
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-            for (int i = 0; i < hopSize && (startSample + i) < buffer.getNumSamples(); ++i) {
-                float sample = buffer.getSample(ch, startSample + i);
-                frameEnergy += sample * sample;
-            }
-        }
-
-        energy[frame] = std::sqrt(frameEnergy / hopSize);
-    }
-
-    // Detect onsets
-    detectOnsets(energy);
-
-    // Calculate BPM from onsets
-    return calculateBPMFromOnsets();
-}
-
-void BPMDetector::detectOnsets(const std::vector<float>& energy) {
-    m_onsets.clear();
-
-    // Simple threshold-based onset detection
-    const float threshold = 0.1f;
-
-    for (size_t i = 1; i < energy.size() - 1; ++i) {
-        float diff = energy[i] - energy[i - 1];
-        if (diff > threshold && energy[i] > energy[i + 1]) {
-            m_onsets.push_back(static_cast<float>(i));
-        }
-    }
-}
-
-float BPMDetector::calculateBPMFromOnsets() {
-    if (m_onsets.size() < 2) {
-        return 0.0f;
-    }
-
-    // Calculate inter-onset intervals
-    std::vector<float> intervals;
-    for (size_t i = 1; i < m_onsets.size(); ++i) {
-        intervals.push_back(m_onsets[i] - m_onsets[i - 1]);
-    }
-
-    // Find median interval
-    std::sort(intervals.begin(), intervals.end());
-    float medianInterval = intervals[intervals.size() / 2];
-
-    // Convert to BPM (assuming 512 hop size at 44100 Hz)
-    float bpm = (60.0f * 44100.0f) / (medianInterval * 512.0f);
-
-    // Clamp to reasonable range
-    return juce::jlimit(kMinBPM, kMaxBPM, bpm);
+    auto features = Analysis::AudioFeatureStore::getInstance().getFeatures(buffer, sampleRate);
+    return features ? features->summary.bpm : 0.0f;
 }
 
 // ============================================================================
 // KeyDetector Implementation
 // ============================================================================
 
-KeyDetector::KeyDetector() {
-    m_chromaProfile.fill(0.0f);
-}
+KeyDetector::KeyDetector() = default;
 
 int KeyDetector::detectKey(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-    calculateChroma(buffer, sampleRate);
-    return findBestKeyMatch();
+    auto features = Analysis::AudioFeatureStore::getInstance().getFeatures(buffer, sampleRate);
+    return features ? features->summary.key : -1;
 }
 
 juce::String KeyDetector::getKeyName(int keyNumber) {
@@ -780,36 +709,4 @@ juce::String KeyDetector::getKeyName(int keyNumber) {
     return "Unknown";
 }
 
-void KeyDetector::calculateChroma(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-    // Simplified chroma calculation
-    // For production, use proper FFT-based chroma extraction
-
-    m_chromaProfile.fill(0.0f);
-
-    // This is a placeholder - real implementation would use FFT
-    // and map frequency bins to pitch classes
-}
-
-int KeyDetector::findBestKeyMatch() const {
-    // Compare with major key profiles using correlation
-    float bestCorrelation = -1.0f;
-    int bestKey = -1;
-
-    for (int key = 0; key < 12; ++key) {
-        float correlation = 0.0f;
-        
-        for (int i = 0; i < 12; ++i) {
-            int noteIndex = (i + key) % 12;
-            correlation += m_chromaProfile[noteIndex] * kMajorProfile[i];
-        }
-
-        if (correlation > bestCorrelation) {
-            bestCorrelation = correlation;
-            bestKey = key;
-        }
-    }
-
-    return bestKey;
-}
-
 } // namespace omega
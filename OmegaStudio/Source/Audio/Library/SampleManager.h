@@ -20,6 +20,7 @@
 #include <set>
 #include <functional>
 #include "../../Utils/Constants.h"
+#include "../Analysis/AudioFeatureStore.h"
 
 namespace omega {
 
@@ -293,7 +294,8 @@ public:
     std::vector<std::shared_ptr<Sample>> globalSearch(const juce::String& query) const;
 
     /**
-     * Analyze sample (BPM, key detection)
+     * Analyze sample (BPM, key detection) through the shared feature store:
+     * files analysed before are not decoded again
      * @param uuid Sample UUID
      * @return True if analysis successful
      */
@@ -357,8 +359,7 @@ private:
     bool isAudioFile(const juce::File& file) const;
     SampleMetadata extractMetadata(const juce::File& file);
     juce::String generateUUID() const;
-    bool detectBPM(Sample* sample);
-    bool detectKey(Sample* sample);
+    bool applyFeatures(Sample* sample, const Analysis::AudioFeatureSummary& summary);
     void manageCacheSize();
 
     // Libraries
@@ -388,7 +389,7 @@ private:
 
 /**
  * @class BPMDetector
- * @brief Automatic BPM detection using onset detection
+ * @brief Automatic BPM detection (tempo of the shared feature store analysis)
  */
 class BPMDetector {
 public:
@@ -402,19 +403,11 @@ public:
      * @return Detected BPM (0.0 if detection failed)
      */
     float detectBPM(const juce::AudioBuffer<float>& buffer, double sampleRate);
-
-private:
-    void detectOnsets(const std::vector<float>& energy);
-    float calculateBPMFromOnsets();
-    
-    std::vector<float> m_onsets;
-    static constexpr float kMinBPM = 60.0f;
-    static constexpr float kMaxBPM = 200.0f;
 };
 
 /**
  * @class KeyDetector
- * @brief Automatic musical key detection using chroma features
+ * @brief Automatic musical key detection (chroma key of the shared feature store analysis)
  */
 class KeyDetector {
 public:
@@ -435,18 +428,6 @@ public:
      * @return Key name (e.g., "C", "F#")
      */
     static juce::String getKeyName(int keyNumber);
-
-private:
-    void calculateChroma(const juce::AudioBuffer<float>& buffer, double sampleRate);
-    int findBestKeyMatch() const;
-    
-    std::array<float, 12> m_chromaProfile;
-    
-    // Major key profiles
-    static constexpr std::array<float, 12> kMajorProfile = {
-        6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f,
-        2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f
-    };
 };
 
 } // namespace omega
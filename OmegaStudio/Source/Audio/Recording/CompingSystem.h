@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../DSP/CompRenderer.h"
 #include <vector>
 #include <memory>
 
@@ -45,22 +46,43 @@ struct CompSegment {
 /**
  * @class CompLane
  * @brief Lane de comping con múltiples takes
+ *
+ * El comp se reproduce directamente desde las takes (omega::CompRenderer):
+ * los crossfades se calculan al vuelo y el render aplanado solo se
+ * regenera en los rangos que cambió la última edición.
  */
 class CompLane {
 public:
     CompLane(const juce::String& name = "Comp Lane")
-        : name_(name) {}
+        : name_(name) {
+        renderer_.prepare(numChannels_);
+    }
+    
+    /** Sample rate de las takes y canales de salida */
+    void prepare(double sampleRate, int numChannels) {
+        sampleRate_ = sampleRate;
+        numChannels_ = numChannels;
+        renderer_.prepare(numChannels);
+        syncRenderer();
+    }
     
     void addTake(std::unique_ptr<Take> take) {
         takes_.push_back(std::move(take));
+        syncRenderer();
     }
     
     void removeTake(const juce::Uuid& takeId) {
-        takes_.erase(
-            std::remove_if(takes_.begin(), takes_.end(),
-                [&takeId](const auto& take) { return take->id == takeId; }),
-            takes_.end()
-        );
+        // La take sale de la lista pero vive hasta que el renderer ya no la referencia
+        std::vector<std::unique_ptr<Take>> removed;
+        for (auto it = takes_.begin(); it != takes_.end();) {
+            if ((*it)->id == takeId) {
+                removed.push_back(std::move(*it));
+                it = takes_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        syncRenderer();
     }
     
     Take* findTake(const juce::Uuid& takeId) {
@@ -71,85 +93,68 @@ public:
     
     const std::vector<std::unique_ptr<Take>>& getTakes() const { return takes_; }
     
+    void setTakeMuted(const juce::Uuid& takeId, bool muted) {
+        if (auto* take = findTake(takeId)) {
+            take->isMuted = muted;
+            syncRenderer();
+        }
+    }
+    
     // Comp segments management
     void addSegment(const CompSegment& segment) {
         segments_.push_back(segment);
         sortSegments();
+        syncRenderer();
+    }
+    
+    void updateSegment(int index, const CompSegment& segment) {
+        if (index >= 0 && index < segments_.size()) {
+            segments_[index] = segment;
+            sortSegments();
+            syncRenderer();
+        }
+    }
+    
+    void setSegments(std::vector<CompSegment> segments) {
+        segments_ = std::move(segments);
+        sortSegments();
+        syncRenderer();
     }
     
     void removeSegment(int index) {
         if (index >= 0 && index < segments_.size()) {
             segments_.erase(segments_.begin() + index);
+            syncRenderer();
         }
     }
     
     void clearSegments() {
         segments_.clear();
+        syncRenderer();
     }
     
     const std::vector<CompSegment>& getSegments() const { return segments_; }
     
     /**
-     * Renderiza el comp final mezclando segmentos seleccionados
+     * Reproduce el comp desde las takes (RT-safe, reemplaza el buffer)
      */
-    juce::AudioBuffer<float> renderComp(double sampleRate, int numChannels) {
-        if (segments_.empty()) {
-            return juce::AudioBuffer<float>(numChannels, 0);
-        }
-        
-        // Calculate total length needed
-        double maxTime = 0.0;
-        for (const auto& seg : segments_) {
-            maxTime = std::max(maxTime, seg.endTime);
-        }
-        
-        int totalSamples = std::ceil(maxTime * sampleRate);
-        juce::AudioBuffer<float> output(numChannels, totalSamples);
-        output.clear();
-        
-        // Render each segment with crossfades
-        for (const auto& segment : segments_) {
-            auto* take = findTake(segment.takeId);
-            if (take == nullptr) continue;
-            
-            int startSample = segment.startTime * sampleRate;
-            int endSample = segment.endTime * sampleRate;
-            int length = endSample - startSample;
-            
-            // Apply crossfade
-            for (int ch = 0; ch < numChannels && ch < take->audioData.getNumChannels(); ++ch) {
-                const float* src = take->audioData.getReadPointer(ch);
-                float* dst = output.getWritePointer(ch);
-                
-                int fadeInSamples = segment.fadeInLength * sampleRate;
-                int fadeOutSamples = segment.fadeOutLength * sampleRate;
-                
-                for (int i = 0; i < length; ++i) {
-                    int srcIdx = startSample + i;
-                    int dstIdx = startSample + i;
-                    
-                    if (srcIdx >= 0 && srcIdx < take->audioData.getNumSamples() &&
-                        dstIdx >= 0 && dstIdx < output.getNumSamples()) {
-                        
-                        float sample = src[srcIdx];
-                        
-                        // Fade in
-                        if (i < fadeInSamples) {
-                            sample *= (float)i / fadeInSamples;
-                        }
-                        
-                        // Fade out
-                        if (i > length - fadeOutSamples) {
-                            sample *= (float)(length - i) / fadeOutSamples;
-                        }
-                        
-                        dst[dstIdx] += sample;  // Mix with existing
-                    }
-                }
-            }
+    void renderBlock(juce::AudioBuffer<float>& buffer, juce::int64 timelineSample) const {
+        renderer_.render(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                         timelineSample, buffer.getNumSamples());
+    }
+    
+    /**
+     * Renderiza el comp final aplanado; solo se recalculan los rangos
+     * modificados desde la última llamada
+     */
+    const juce::AudioBuffer<float>& renderComp(double sampleRate, int numChannels) {
+        if (sampleRate != sampleRate_ || numChannels != numChannels_) {
+            prepare(sampleRate, numChannels);
         }
         
-        return output;
+        renderer_.setFlattenEnabled(true);
+        renderer_.updateFlattened();
+        return renderer_.getFlattened();
     }
     
     const juce::String& getName() const { return name_; }
@@ -157,15 +162,49 @@ public:
     
 private:
     void sortSegments() {
-        std::sort(segments_.begin(), segments_.end(),
+        std::stable_sort(segments_.begin(), segments_.end(),
             [](const CompSegment& a, const CompSegment& b) {
                 return a.startTime < b.startTime;
             });
     }
     
+    juce::int64 toSamples(double seconds) const {
+        return (juce::int64) std::llround(seconds * sampleRate_);
+    }
+    
+    // Las takes se alinean en el inicio del timeline del comp. Takes y regiones
+    // se publican juntas: renderBlock nunca ve índices de una lista con la otra
+    void syncRenderer() {
+        std::vector<const juce::AudioBuffer<float>*> sources;
+        for (const auto& take : takes_) {
+            sources.push_back(&take->audioData);
+        }
+        
+        std::vector<omega::CompRenderer::Region> regions;
+        regions.reserve(segments_.size());
+        for (const auto& segment : segments_) {
+            auto it = std::find_if(takes_.begin(), takes_.end(),
+                [&segment](const auto& take) { return take->id == segment.takeId; });
+            if (it == takes_.end()) continue;
+            
+            omega::CompRenderer::Region region;
+            region.source = (int) std::distance(takes_.begin(), it);
+            region.start = toSamples(segment.startTime);
+            region.end = toSamples(segment.endTime);
+            region.fadeIn = (int) toSamples(segment.fadeInLength);
+            region.fadeOut = (int) toSamples(segment.fadeOutLength);
+            region.gain = (*it)->isMuted ? 0.0f : 1.0f;
+            regions.push_back(region);
+        }
+        renderer_.setComp(std::move(sources), std::move(regions));
+    }
+    
     juce::String name_;
     std::vector<std::unique_ptr<Take>> takes_;
     std::vector<CompSegment> segments_;
+    omega::CompRenderer renderer_;
+    double sampleRate_ { 48000.0 };
+    int numChannels_ { 2 };
 };
 
 /**
@@ -197,10 +236,14 @@ public:
         auto* lane = getLane(laneIndex);
         if (lane == nullptr) return;
         
-        lane->clearSegments();
-        
         const auto& takes = lane->getTakes();
-        if (takes.empty()) return;
+        if (takes.empty()) {
+            lane->clearSegments();
+            return;
+        }
+        
+        // Se aplica de una vez: un solo render incremental
+        std::vector<CompSegment> segments;
         
         // Find loudest segments
         double currentTime = 0.0;
@@ -230,10 +273,12 @@ public:
             seg.endTime = segEnd;
             seg.fadeInLength = 0.01;
             seg.fadeOutLength = 0.01;
-            lane->addSegment(seg);
+            segments.push_back(seg);
             
             currentTime = segEnd;
         }
+        
+        lane->setSegments(std::move(segments));
     }
     
 private:
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Analysis/LoudnessMeter.h"
+#include "Analysis/AnalysisTapService.h"
 #include <vector>
 #include <memory>
 
@@ -70,69 +72,33 @@ private:
 /**
  * @class LUFSMeter
  * @brief Medidor de LUFS (loudness)
+ *
+ * No corre en el hilo de audio: se alimenta desde un tap con
+ * AnalysisTapService::makeLoudnessMeter(), que lo prepara al conectarse.
  */
 class LUFSMeter {
 public:
+    void prepare(double sampleRate, int numChannels = 2) {
+        engine_.prepare(sampleRate, numChannels, false);
+    }
+    
     void reset() {
-        gatingBlocks_.clear();
-        momentary_ = -70.0f;
-        shortTerm_ = -70.0f;
-        integrated_ = -70.0f;
+        engine_.reset();
     }
     
-    void processBlock(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-        // K-weighting filter (simplified)
-        float sum = 0.0f;
-        int numSamples = buffer.getNumSamples();
-        
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-            const float* data = buffer.getReadPointer(ch);
-            for (int i = 0; i < numSamples; ++i) {
-                sum += data[i] * data[i];
-            }
-        }
-        
-        float rms = std::sqrt(sum / (numSamples * buffer.getNumChannels()));
-        float lufs = -0.691f + 10.0f * std::log10(rms + 1e-10f);
-        
-        // Momentary (400ms)
-        momentary_ = momentary_ * 0.95f + lufs * 0.05f;
-        
-        // Short-term (3s)
-        shortTerm_ = shortTerm_ * 0.99f + lufs * 0.01f;
-        
-        // Integrated (gated)
-        if (lufs > -70.0f) {
-            gatingBlocks_.push_back(lufs);
-            if (gatingBlocks_.size() > 100) {
-                gatingBlocks_.erase(gatingBlocks_.begin());
-            }
-            
-            // Calculate gated loudness
-            float sum = 0.0f;
-            int count = 0;
-            for (float block : gatingBlocks_) {
-                if (block > -70.0f) {
-                    sum += std::pow(10.0f, block / 10.0f);
-                    count++;
-                }
-            }
-            
-            if (count > 0) {
-                integrated_ = 10.0f * std::log10(sum / count);
-            }
-        }
+    // Hilo de análisis; sin prepare() no mide nada
+    void process(const juce::AudioBuffer<float>& buffer) {
+        engine_.process(buffer);
     }
     
-    float getMomentary() const { return momentary_; }
-    float getShortTerm() const { return shortTerm_; }
-    float getIntegrated() const { return integrated_; }
+    float getMomentary() const { return engine_.getMomentary(); }
+    float getShortTerm() const { return engine_.getShortTerm(); }
+    float getIntegrated() const { return engine_.getIntegrated(); }
+    float getLoudnessRange() const { return engine_.getLoudnessRange(); }
     
 private:
-    std::vector<float> gatingBlocks_;
-    float momentary_ { -70.0f };
-    float shortTerm_ { -70.0f };
-    float integrated_ { -70.0f };
+    // Motor BS.1770 compartido (K-weighting, ventanas de 400 ms / 3 s, gating)
+    omega::Analysis::LoudnessMeter engine_;
 };
 
 /**
@@ -219,22 +185,7 @@ public:
 private:
     void analyzeTrack() {
         // Calculate LUFS
-        LUFSMeter meter;
-        meter.reset();
-        
-        const int blockSize = 4410;  // ~100ms at 44.1kHz
-        for (int pos = 0; pos < audioBuffer_.getNumSamples(); pos += blockSize) {
-            int samplesThisBlock = std::min(blockSize, audioBuffer_.getNumSamples() - pos);
-            
-            juce::AudioBuffer<float> block(audioBuffer_.getNumChannels(), samplesThisBlock);
-            for (int ch = 0; ch < audioBuffer_.getNumChannels(); ++ch) {
-                block.copyFrom(ch, 0, audioBuffer_, ch, pos, samplesThisBlock);
-            }
-            
-            meter.processBlock(block, sampleRate_);
-        }
-        
-        targetLUFS_ = meter.getIntegrated();
+        targetLUFS_ = omega::Analysis::LoudnessMeter::measure(audioBuffer_, sampleRate_).integratedLUFS;
         
         // Calculate average spectrum
         SpectrumAnalyzer analyzer;
@@ -312,9 +263,40 @@ public:
         addAndMakeVisible(lufsLabel_);
         lufsLabel_.setText("Target LUFS: --", juce::dontSendNotification);
         
+        addAndMakeVisible(mixLufsLabel_);
+        mixLufsLabel_.setText("Mix LUFS: --", juce::dontSendNotification);
+        
         startTimer(50);
     }
     
+    ~ReferenceTrackSystem() override {
+        setMixAnalysis(nullptr, nullptr);
+    }
+    
+    /**
+     * Mide la mezcla desde un tap (normalmente el master): loudness y espectro
+     * se calculan en el hilo de análisis y aquí solo se leen sus snapshots.
+     */
+    void setMixAnalysis(AnalysisTapService* service, AnalysisTap* tap) {
+        if (analysisService_ != nullptr) {
+            analysisService_->detach(mixTap_, mixLoudness_.get());
+            analysisService_->detach(mixTap_, mixSpectrum_.get());
+        }
+        
+        analysisService_ = service;
+        mixTap_ = tap;
+        mixLoudness_.reset();
+        mixSpectrum_.reset();
+        if (service == nullptr || tap == nullptr)
+            return;
+        
+        // Mismo tamaño de FFT que el espectro de la referencia
+        mixLoudness_ = AnalysisTapService::makeLoudnessMeter();
+        mixSpectrum_ = AnalysisTapService::makeSpectrumAnalyzer(10);
+        service->attach(tap, mixLoudness_);
+        service->attach(tap, mixSpectrum_);
+    }
+    
     void paint(juce::Graphics& g) override {
         g.fillAll(juce::Colour(0xff1e1e1e));
         
@@ -348,9 +330,24 @@ public:
             g.strokePath(path, juce::PathStrokeType(2.0f));
         }
         
-        // Draw current mix spectrum (would come from audio engine)
-        g.setColour(juce::Colours::orange.withAlpha(0.7f));
-        // TODO: Draw current mix spectrum
+        // Espectro de la mezcla, del último snapshot del hilo de análisis
+        if (mixSpectrum_ != nullptr) {
+            const auto mix = mixSpectrum_->getLatest();
+            const size_t numBins = std::min(mix.magnitudes.size(), mix.frequencies.size());
+            if (numBins > 1 && mix.frequencies.back() > 0.0f) {
+                juce::Path path;
+                path.startNewSubPath(spectrumBounds.getX(), spectrumBounds.getBottom());
+                
+                for (size_t i = 0; i < numBins; ++i) {
+                    float normDb = juce::jlimit(0.0f, 1.0f, juce::jmap(mix.magnitudes[i], -80.0f, 0.0f, 0.0f, 1.0f));
+                    float x = spectrumBounds.getX() + mix.frequencies[i] / mix.frequencies.back() * spectrumBounds.getWidth();
+                    path.lineTo(x, spectrumBounds.getBottom() - normDb * spectrumBounds.getHeight());
+                }
+                
+                g.setColour(juce::Colours::orange.withAlpha(0.7f));
+                g.strokePath(path, juce::PathStrokeType(2.0f));
+            }
+        }
         
         g.setColour(juce::Colours::white);
         g.drawRect(spectrumBounds, 1.0f);
@@ -376,7 +373,8 @@ public:
         
         bounds.removeFromTop(10);
         auto infoRow = bounds.removeFromTop(30);
-        lufsLabel_.setBounds(infoRow);
+        lufsLabel_.setBounds(infoRow.removeFromLeft(infoRow.getWidth() / 2));
+        mixLufsLabel_.setBounds(infoRow);
     }
     
     void process(juce::AudioBuffer<float>& buffer) {
@@ -410,17 +408,32 @@ private:
     }
     
     void timerCallback() override {
+        if (mixLoudness_ != nullptr && mixLoudness_->getVersion() != mixLoudnessVersion_) {
+            mixLoudnessVersion_ = mixLoudness_->getVersion();
+            const auto loudness = mixLoudness_->getLatest();
+            mixLufsLabel_.setText("Mix LUFS: " + juce::String(loudness.shortTerm, 1) + " short-term, "
+                                      + juce::String(loudness.integrated, 1) + " integrated",
+                                  juce::dontSendNotification);
+        }
+        
         repaint();
     }
     
     std::unique_ptr<ReferenceTrack> referenceTrack_;
     
+    AnalysisTapService* analysisService_ { nullptr };
+    AnalysisTap* mixTap_ { nullptr };
+    std::shared_ptr<SnapshotAnalyzer<LoudnessSnapshot>> mixLoudness_;
+    std::shared_ptr<SnapshotAnalyzer<SpectrumSnapshot>> mixSpectrum_;
+    juce::uint64 mixLoudnessVersion_ { 0 };
+    
     juce::TextButton loadButton_;
     juce::TextButton playButton_;
     juce::TextButton abToggle_;
     juce::Slider gainSlider_;
     juce::Label gainLabel_;
     juce::Label lufsLabel_;
+    juce::Label mixLufsLabel_;
 };
 
 } // namespace Audio
@@ -1,9 +1,18 @@
 #include "SampleSlicer.h"
+#include "DSP/StreamingTimeStretch.h"
 #include <algorithm>
 #include <cmath>
 
 namespace omega {
 
+namespace {
+
+constexpr size_t kDefaultStretchCacheBytes = 64 * 1024 * 1024;
+constexpr float kStretchFactorTolerance = 1.0e-4f;     // Relative: same tempo, same render
+constexpr int kStretchBlockSize = 512;
+
+} // namespace
+
 //==============================================================================
 // SampleSlicer Implementation
 //==============================================================================
@@ -12,11 +21,18 @@ SampleSlicer::SampleSlicer()
     : sampleRate_(44100.0)
     , transientSensitivity_(0.5f)
     , transientThreshold_(0.1f)
+    , stretchCacheSamples_(0)
+    , stretchCacheLimit_(kDefaultStretchCacheBytes / sizeof(float))
+    , stretchClock_(0)
+    , targetStretch_(0.0f)
+    , stretchQuality_(StretchQuality::High)
+    , stretchGeneration_(0)
 {
 }
 
 SampleSlicer::~SampleSlicer()
 {
+    cancelStretchRenders();
 }
 
 void SampleSlicer::loadAudioFile(const juce::File& file)
@@ -28,6 +44,7 @@ void SampleSlicer::loadAudioFile(const juce::File& file)
     if (!reader)
         return;
     
+    cancelStretchRenders();
     sampleRate_ = reader->sampleRate;
     
     audioBuffer_ = std::make_unique<juce::AudioBuffer<float>>(
@@ -37,13 +54,17 @@ void SampleSlicer::loadAudioFile(const juce::File& file)
     
     reader->read(audioBuffer_.get(), 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
     
+    features_ = Analysis::AudioFeatureStore::getInstance().getFeatures(file, *audioBuffer_, sampleRate_);
+    
     clearSlices();
 }
 
 void SampleSlicer::loadAudioBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate)
 {
+    cancelStretchRenders();
     audioBuffer_ = std::make_unique<juce::AudioBuffer<float>>(buffer);
     sampleRate_ = sampleRate;
+    features_.reset();
     clearSlices();
 }
 
@@ -55,117 +76,34 @@ void SampleSlicer::detectTransients(float sensitivity, float threshold)
     if (!audioBuffer_ || audioBuffer_->getNumSamples() == 0)
         return;
     
-    // Calculate envelope from audio
-    const float* data = audioBuffer_->getReadPointer(0);
-    int numSamples = audioBuffer_->getNumSamples();
+    // Onsets come from the shared feature store (already there for a loaded file)
+    if (!features_)
+        features_ = Analysis::AudioFeatureStore::getInstance().getFeatures(*audioBuffer_, sampleRate_);
+    if (!features_)
+        return;
     
-    auto envelope = calculateEnvelope(data, numSamples);
+    int numSamples = audioBuffer_->getNumSamples();
     
-    // Find peaks in envelope
-    auto peaks = findPeaks(envelope, threshold);
+    // Minimum distance between transients: 20ms window scaled by sensitivity
+    auto minSpacing = static_cast<int64_t>(sampleRate_ * 0.02 * sensitivity);
+    auto onsets = features_->selectOnsets(threshold, minSpacing);
     
     // Clear existing slices
     clearSlices();
     
-    // Create slices from peaks
-    for (size_t i = 0; i < peaks.size(); ++i)
+    // Create slices from onsets
+    for (size_t i = 0; i < onsets.size(); ++i)
     {
         Slice slice;
-        slice.startSample = peaks[i];
-        slice.endSample = (i + 1 < peaks.size()) ? peaks[i + 1] : numSamples;
-        slice.transientStrength = calculateTransientStrength(peaks[i], envelope);
+        slice.startSample = static_cast<int>(onsets[i].position);
+        slice.endSample = (i + 1 < onsets.size()) ? static_cast<int>(onsets[i + 1].position) : numSamples;
+        slice.transientStrength = onsets[i].strength;
         slice.name = juce::String("Slice ") + juce::String(i + 1);
         
         slices_.push_back(slice);
     }
-}
-
-std::vector<float> SampleSlicer::calculateEnvelope(const float* data, int numSamples)
-{
-    std::vector<float> envelope;
-    envelope.reserve(numSamples);
-    
-    // Window size for envelope following (about 10ms)
-    int windowSize = static_cast<int>(sampleRate_ * 0.01);
-    
-    float sum = 0.0f;
-    for (int i = 0; i < numSamples; ++i)
-    {
-        // Add new sample
-        float absValue = std::abs(data[i]);
-        sum += absValue;
-        
-        // Remove old sample
-        if (i >= windowSize)
-            sum -= std::abs(data[i - windowSize]);
-        
-        // Average
-        float avg = sum / static_cast<float>(windowSize);
-        envelope.push_back(avg);
-    }
-    
-    return envelope;
-}
-
-std::vector<int> SampleSlicer::findPeaks(const std::vector<float>& envelope, float threshold)
-{
-    std::vector<int> peaks;
-    
-    // Find local maxima above threshold
-    int lookAhead = static_cast<int>(sampleRate_ * 0.02 * transientSensitivity_);  // 20ms window scaled by sensitivity
-    
-    for (size_t i = lookAhead; i < envelope.size() - lookAhead; ++i)
-    {
-        bool isPeak = true;
-        float currentValue = envelope[i];
-        
-        // Check if it's a local maximum
-        for (int j = -lookAhead; j <= lookAhead; ++j)
-        {
-            if (j != 0 && envelope[i + j] >= currentValue)
-            {
-                isPeak = false;
-                break;
-            }
-        }
-        
-        // Check if above threshold
-        if (isPeak && currentValue > threshold)
-        {
-            peaks.push_back(static_cast<int>(i));
-            
-            // Skip ahead to avoid multiple peaks in same area
-            i += lookAhead;
-        }
-    }
     
-    return peaks;
-}
-
-float SampleSlicer::calculateTransientStrength(int position, const std::vector<float>& envelope)
-{
-    if (position >= static_cast<int>(envelope.size()))
-        return 0.0f;
-    
-    // Calculate strength as ratio of peak to surrounding average
-    int windowSize = static_cast<int>(sampleRate_ * 0.05);  // 50ms window
-    
-    float peakValue = envelope[position];
-    
-    // Calculate average before peak
-    float avgBefore = 0.0f;
-    int count = 0;
-    for (int i = std::max(0, position - windowSize); i < position; ++i)
-    {
-        avgBefore += envelope[i];
-        ++count;
-    }
-    if (count > 0) avgBefore /= count;
-    
-    // Strength is ratio
-    float strength = (avgBefore > 0.0f) ? (peakValue / avgBefore) : 1.0f;
-    
-    return juce::jlimit(0.0f, 1.0f, strength / 10.0f);  // Normalize to 0-1
+    scheduleStretchRenders();
 }
 
 void SampleSlicer::setTransientSensitivity(float sensitivity)
@@ -198,6 +136,8 @@ void SampleSlicer::addSlice(int position)
         else
             slices_[i].endSample = audioBuffer_ ? audioBuffer_->getNumSamples() : 0;
     }
+    
+    scheduleStretchRenders();
 }
 
 void SampleSlicer::removeSlice(int index)
@@ -214,6 +154,8 @@ void SampleSlicer::removeSlice(int index)
             else
                 slices_[i].endSample = audioBuffer_ ? audioBuffer_->getNumSamples() : 0;
         }
+        
+        scheduleStretchRenders();
     }
 }
 
@@ -235,12 +177,15 @@ void SampleSlicer::moveSlice(int index, int newPosition)
             else
                 slices_[i].endSample = audioBuffer_ ? audioBuffer_->getNumSamples() : 0;
         }
+        
+        scheduleStretchRenders();
     }
 }
 
 void SampleSlicer::clearSlices()
 {
     slices_.clear();
+    scheduleStretchRenders();
 }
 
 void SampleSlicer::autoSliceByTransients(int minSliceLength)
@@ -251,6 +196,8 @@ void SampleSlicer::autoSliceByTransients(int minSliceLength)
     slices_.erase(std::remove_if(slices_.begin(), slices_.end(),
         [minSliceLength](const Slice& slice) { return slice.getLength() < minSliceLength; }),
         slices_.end());
+    
+    scheduleStretchRenders();
 }
 
 void SampleSlicer::autoSliceByGrid(int numSlices)
@@ -276,6 +223,8 @@ void SampleSlicer::autoSliceByGrid(int numSlices)
     // Ensure last slice goes to end
     if (!slices_.empty())
         slices_.back().endSample = totalSamples;
+    
+    scheduleStretchRenders();
 }
 
 void SampleSlicer::autoSliceByBeats(double bpm, int beatsPerSlice)
@@ -304,6 +253,8 @@ void SampleSlicer::autoSliceByBeats(double bpm, int beatsPerSlice)
         position += samplesPerSlice;
         ++sliceNum;
     }
+    
+    scheduleStretchRenders();
 }
 
 const SampleSlicer::Slice& SampleSlicer::getSlice(int index) const
@@ -374,29 +325,57 @@ void SampleSlicer::renderSliceWithTimeStretch(int sliceIndex, juce::AudioBuffer<
     
     const auto& slice = slices_[sliceIndex];
     
-    // Create temp buffer for slice
-    int sliceLength = slice.getLength();
-    juce::AudioBuffer<float> sliceBuffer(audioBuffer_->getNumChannels(), sliceLength);
-    
-    for (int ch = 0; ch < audioBuffer_->getNumChannels(); ++ch)
+    // Prepared in the background: just copy. A writer only holds the lock
+    // for a swap; if it is that moment, this block takes the fallback below
+    if (stretchLock_.tryLock())
     {
-        sliceBuffer.copyFrom(ch, 0, *audioBuffer_, ch, slice.startSample, sliceLength);
+        const auto* entry = findStretched(stretchCache_, slice.startSample, slice.endSample,
+                                          stretchFactor, stretchQuality_.load());
+        if (entry != nullptr)
+        {
+            entry->lastUsed.store(++stretchClock_);
+            const auto& stretched = *entry->audio;
+            
+            int samplesToWrite = std::min(stretched.getNumSamples(), outputBuffer.getNumSamples() - startSample);
+            for (int ch = 0; ch < std::min(stretched.getNumChannels(), outputBuffer.getNumChannels()); ++ch)
+            {
+                outputBuffer.copyFrom(ch, startSample, stretched, ch, 0, samplesToWrite);
+                
+                if (gain != 1.0f)
+                    outputBuffer.applyGain(ch, startSample, samplesToWrite, gain);
+            }
+        }
+        stretchLock_.unlock();
+        
+        if (entry != nullptr)
+            return;
     }
     
-    // Create stretched buffer
-    int stretchedLength = static_cast<int>(sliceLength * stretchFactor);
-    juce::AudioBuffer<float> stretchedBuffer(audioBuffer_->getNumChannels(), stretchedLength);
+    // Not ready: the same linear interpolation as timeStretchSlice(), read
+    // from the loaded audio and written in place. It costs about a copy, and
+    // unlike the unstretched slice keeps the slice at the project tempo
+    const int sliceLength = slice.getLength();
+    const int stretchedLength = static_cast<int>(sliceLength * stretchFactor);
+    const int samplesToWrite = std::min(stretchedLength, outputBuffer.getNumSamples() - startSample);
     
-    timeStretchSlice(sliceBuffer, stretchedBuffer, stretchFactor);
-    
-    // Copy to output
-    int samplesToWrite = std::min(stretchedLength, outputBuffer.getNumSamples() - startSample);
-    for (int ch = 0; ch < std::min(stretchedBuffer.getNumChannels(), outputBuffer.getNumChannels()); ++ch)
+    for (int ch = 0; ch < std::min(audioBuffer_->getNumChannels(), outputBuffer.getNumChannels()); ++ch)
     {
-        outputBuffer.copyFrom(ch, startSample, stretchedBuffer, ch, 0, samplesToWrite);
+        const float* inputData = audioBuffer_->getReadPointer(ch, slice.startSample);
+        float* outputData = outputBuffer.getWritePointer(ch, startSample);
         
-        if (gain != 1.0f)
-            outputBuffer.applyGain(ch, startSample, samplesToWrite, gain);
+        for (int i = 0; i < samplesToWrite; ++i)
+        {
+            float sourcePos = i / stretchFactor;
+            int index1 = static_cast<int>(sourcePos);
+            int index2 = std::min(index1 + 1, sliceLength - 1);
+            float frac = sourcePos - index1;
+            
+            float value = 0.0f;
+            if (index1 < sliceLength)
+                value = inputData[index1] * (1.0f - frac) + inputData[index2] * frac;
+            
+            outputData[i] = gain != 1.0f ? value * gain : value;
+        }
     }
 }
 
@@ -428,6 +407,242 @@ void SampleSlicer::timeStretchSlice(const juce::AudioBuffer<float>& input,
     }
 }
 
+//==============================================================================
+// Stretched slice cache
+//==============================================================================
+
+void SampleSlicer::setProjectTempo(double projectBpm, double sliceBpm)
+{
+    if (projectBpm > 0.0 && sliceBpm > 0.0)
+        prepareStretchedSlices(static_cast<float>(sliceBpm / projectBpm));
+}
+
+void SampleSlicer::prepareStretchedSlices(float stretchFactor)
+{
+    // Same range as the streaming stretcher's rate
+    targetStretch_ = juce::jlimit(static_cast<float>(1.0 / OmegaStudio::Audio::DSP::StreamingTimeStretcher::maxRate),
+                                  static_cast<float>(1.0 / OmegaStudio::Audio::DSP::StreamingTimeStretcher::minRate),
+                                  stretchFactor);
+    scheduleStretchRenders();
+}
+
+void SampleSlicer::setStretchQuality(StretchQuality quality)
+{
+    if (stretchQuality_.exchange(quality) != quality)
+        scheduleStretchRenders();
+}
+
+void SampleSlicer::setStretchCacheSize(size_t maxBytes)
+{
+    stretchCacheLimit_ = maxBytes / sizeof(float);
+    scheduleStretchRenders();
+}
+
+bool SampleSlicer::isStretchedSliceReady(int sliceIndex, float stretchFactor) const
+{
+    if (sliceIndex < 0 || sliceIndex >= static_cast<int>(slices_.size()))
+        return false;
+    
+    const auto& slice = slices_[sliceIndex];
+    const juce::ScopedLock writeLock(stretchWriteLock_);
+    return findStretched(stretchCache_, slice.startSample, slice.endSample, stretchFactor, stretchQuality_.load()) != nullptr;
+}
+
+bool SampleSlicer::waitForStretchedSlices(int timeoutMs)
+{
+    const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+    while (stretchPool_ && stretchPool_->getNumJobs() > 0)
+    {
+        if (juce::Time::getMillisecondCounter() >= deadline)
+            return false;
+        juce::Thread::sleep(1);
+    }
+    return true;
+}
+
+const SampleSlicer::StretchedSlice* SampleSlicer::findStretched(const StretchCache& cache, int startSample, int endSample,
+                                                                float stretchFactor, StretchQuality quality)
+{
+    for (const auto& entry : cache)
+    {
+        if (entry->startSample == startSample && entry->endSample == endSample && entry->quality == quality
+            && std::abs(entry->stretchFactor - stretchFactor) <= kStretchFactorTolerance * stretchFactor)
+            return entry.get();
+    }
+    return nullptr;
+}
+
+// The only place the audio thread's list changes: the old one comes back in
+// `cache` and is released by the caller, outside the spin lock
+void SampleSlicer::publishStretchCache(StretchCache& cache)
+{
+    Omega::Utils::SpinLockGuard guard(stretchLock_);
+    stretchCache_.swap(cache);
+}
+
+// Message thread, after any change of slices, tempo or quality: drops the
+// renders that no longer apply and queues the missing ones
+void SampleSlicer::scheduleStretchRenders()
+{
+    const uint32_t generation = ++stretchGeneration_;
+    const float stretchFactor = targetStretch_;
+    const auto quality = stretchQuality_.load();
+    
+    auto isCurrent = [&](const StretchedSlice& entry)
+    {
+        if (stretchFactor <= 0.0f || entry.quality != quality
+            || std::abs(entry.stretchFactor - stretchFactor) > kStretchFactorTolerance * stretchFactor)
+            return false;
+        return std::any_of(slices_.begin(), slices_.end(), [&entry](const Slice& slice)
+        {
+            return slice.startSample == entry.startSample && slice.endSample == entry.endSample;
+        });
+    };
+    
+    std::vector<std::pair<int, int>> pending;
+    {
+        const juce::ScopedLock writeLock(stretchWriteLock_);
+        
+        StretchCache kept;
+        kept.reserve(stretchCache_.size());
+        for (const auto& entry : stretchCache_)
+        {
+            if (isCurrent(*entry))
+                kept.push_back(entry);
+            else
+                stretchCacheSamples_ -= static_cast<size_t>(entry->audio->getNumSamples() * entry->audio->getNumChannels());
+        }
+        
+        if (stretchFactor > 0.0f && audioBuffer_)
+        {
+            for (const auto& slice : slices_)
+            {
+                if (slice.getLength() > 0
+                    && findStretched(kept, slice.startSample, slice.endSample, stretchFactor, quality) == nullptr)
+                    pending.emplace_back(slice.startSample, slice.endSample);
+            }
+        }
+        
+        // The evicted renders go with the old list when kept goes out of scope
+        publishStretchCache(kept);
+    }
+    
+    if (pending.empty())
+        return;
+    
+    if (!stretchPool_)
+        stretchPool_ = std::make_unique<juce::ThreadPool>(1);
+    
+    stretchPool_->addJob([this, pending, stretchFactor, quality, generation]
+    {
+        for (const auto& [startSample, endSample] : pending)
+        {
+            auto entry = std::make_shared<StretchedSlice>();
+            entry->startSample = startSample;
+            entry->endSample = endSample;
+            entry->stretchFactor = stretchFactor;
+            entry->quality = quality;
+            entry->audio = renderStretched(startSample, endSample, stretchFactor, quality, generation);
+            
+            // Cancelled mid-render: audioBuffer_ may be about to change
+            if (entry->audio == nullptr)
+                return;
+            
+            storeStretched(std::move(entry), generation);
+        }
+    });
+}
+
+// Before audioBuffer_ changes or goes away: stops the renders reading it.
+// renderStretched() checks the generation between blocks, so the running
+// job ends within one block; the wait has no deadline to be sure of that
+void SampleSlicer::cancelStretchRenders()
+{
+    ++stretchGeneration_;
+    if (stretchPool_)
+    {
+        while (!stretchPool_->removeAllJobs(true, 100))
+        {
+        }
+    }
+    
+    StretchCache evicted;
+    const juce::ScopedLock writeLock(stretchWriteLock_);
+    publishStretchCache(evicted);
+    stretchCacheSamples_ = 0;
+}
+
+// Render thread. Returns nullptr once `generation` is no longer current
+std::unique_ptr<juce::AudioBuffer<float>> SampleSlicer::renderStretched(int startSample, int endSample, float stretchFactor,
+                                                                        StretchQuality quality, uint32_t generation)
+{
+    using OmegaStudio::Audio::DSP::StreamingTimeStretcher;
+    
+    if (stretchGeneration_.load() != generation)
+        return nullptr;
+    
+    const int numChannels = audioBuffer_->getNumChannels();
+    const int sliceLength = endSample - startSample;
+    juce::AudioBuffer<float> sliceBuffer(numChannels, sliceLength);
+    for (int ch = 0; ch < numChannels; ++ch)
+        sliceBuffer.copyFrom(ch, 0, *audioBuffer_, ch, startSample, sliceLength);
+    
+    auto stretched = std::make_unique<juce::AudioBuffer<float>>(numChannels, static_cast<int>(sliceLength * stretchFactor));
+    
+    // The phase vocoder is stereo at most; wider files keep the fast path
+    if (quality == StretchQuality::Fast || numChannels > StreamingTimeStretcher::maxChannels)
+    {
+        timeStretchSlice(sliceBuffer, *stretched, stretchFactor);
+        return stretched;
+    }
+    
+    // Reading from the slice alone: the neighbouring slices never bleed in
+    OmegaStudio::Audio::DSP::BufferStretchSource source(sliceBuffer);
+    StreamingTimeStretcher stretcher;
+    stretcher.prepare(numChannels, kStretchBlockSize);
+    
+    const double rate = 1.0 / stretchFactor;
+    for (int position = 0; position < stretched->getNumSamples(); position += kStretchBlockSize)
+    {
+        if (stretchGeneration_.load() != generation)
+            return nullptr;
+        
+        const int count = std::min(kStretchBlockSize, stretched->getNumSamples() - position);
+        float* outputs[StreamingTimeStretcher::maxChannels] = {};
+        for (int ch = 0; ch < numChannels; ++ch)
+            outputs[ch] = stretched->getWritePointer(ch, position);
+        
+        stretcher.process(source, outputs, numChannels, count, position * rate, rate);
+    }
+    return stretched;
+}
+
+void SampleSlicer::storeStretched(std::shared_ptr<StretchedSlice> entry, uint32_t generation)
+{
+    StretchCache updated;
+    const juce::ScopedLock writeLock(stretchWriteLock_);
+    
+    // The slices or the tempo changed while rendering
+    if (stretchGeneration_.load() != generation)
+        return;
+    
+    stretchCacheSamples_ += static_cast<size_t>(entry->audio->getNumSamples() * entry->audio->getNumChannels());
+    entry->lastUsed.store(++stretchClock_);
+    updated = stretchCache_;
+    updated.push_back(std::move(entry));
+    
+    // Over budget: least recently played first, never the one just added
+    while (stretchCacheSamples_ > stretchCacheLimit_ && updated.size() > 1)
+    {
+        auto oldest = std::min_element(updated.begin(), updated.end() - 1,
+            [](const auto& a, const auto& b) { return a->lastUsed.load() < b->lastUsed.load(); });
+        stretchCacheSamples_ -= static_cast<size_t>((*oldest)->audio->getNumSamples() * (*oldest)->audio->getNumChannels());
+        updated.erase(oldest);
+    }
+    
+    publishStretchCache(updated);
+}
+
 void SampleSlicer::exportSlice(int sliceIndex, const juce::File& outputFile)
 {
     if (!audioBuffer_ || sliceIndex < 0 || sliceIndex >= static_cast<int>(slices_.size()))
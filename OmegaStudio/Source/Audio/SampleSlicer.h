@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Analysis/AudioFeatureStore.h"
+#include "../Utils/Atomic.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 
@@ -11,6 +14,11 @@ namespace omega {
  */
 class SampleSlicer {
 public:
+    enum class StretchQuality {
+        Fast,       // Linear interpolation (varispeed: pitch follows the tempo)
+        High        // Phase vocoder (StreamingTimeStretcher): pitch preserved
+    };
+    
     struct Slice {
         int startSample;
         int endSample;
@@ -65,6 +73,19 @@ public:
     void renderSliceWithTimeStretch(int sliceIndex, juce::AudioBuffer<float>& outputBuffer,
                                     int startSample, float stretchFactor, float gain = 1.0f);
     
+    // Stretched slice cache: every slice is rendered once at the project tempo
+    // on a background thread; renderSliceWithTimeStretch() then only copies.
+    // A new tempo or quality drops the old renders. A slice that is not ready
+    // yet (or a block that finds the cache being swapped) plays the linear
+    // interpolation straight into the output: no allocation, no vocoder
+    void setProjectTempo(double projectBpm, double sliceBpm);
+    void prepareStretchedSlices(float stretchFactor);
+    void setStretchQuality(StretchQuality quality);
+    StretchQuality getStretchQuality() const { return stretchQuality_.load(); }
+    void setStretchCacheSize(size_t maxBytes);
+    bool isStretchedSliceReady(int sliceIndex, float stretchFactor) const;
+    bool waitForStretchedSlices(int timeoutMs);
+    
     // Export
     void exportSlice(int sliceIndex, const juce::File& outputFile);
     void exportAllSlices(const juce::File& outputDirectory, const juce::String& prefix);
@@ -86,16 +107,48 @@ private:
     float transientSensitivity_;
     float transientThreshold_;
     
-    // Transient detection helpers
-    std::vector<float> calculateEnvelope(const float* data, int numSamples);
-    std::vector<int> findPeaks(const std::vector<float>& envelope, float threshold);
-    float calculateTransientStrength(int position, const std::vector<float>& envelope);
+    // Analysis of the loaded audio (onsets for transient detection)
+    std::shared_ptr<const Analysis::AudioFeatures> features_;
     
     // Time-stretching helpers
     void timeStretchSlice(const juce::AudioBuffer<float>& input, 
                          juce::AudioBuffer<float>& output,
                          float stretchFactor);
     
+    // Stretched slice cache, keyed by (slice range, stretch factor, quality)
+    struct StretchedSlice {
+        int startSample { 0 };
+        int endSample { 0 };
+        float stretchFactor { 1.0f };
+        StretchQuality quality { StretchQuality::High };
+        std::unique_ptr<juce::AudioBuffer<float>> audio;
+        mutable std::atomic<uint64_t> lastUsed { 0 };   // Touched by the audio thread
+    };
+    using StretchCache = std::vector<std::shared_ptr<StretchedSlice>>;
+    
+    void scheduleStretchRenders();
+    void cancelStretchRenders();
+    std::unique_ptr<juce::AudioBuffer<float>> renderStretched(int startSample, int endSample, float stretchFactor,
+                                                              StretchQuality quality, uint32_t generation);
+    void storeStretched(std::shared_ptr<StretchedSlice> entry, uint32_t generation);
+    void publishStretchCache(StretchCache& cache);
+    static const StretchedSlice* findStretched(const StretchCache& cache, int startSample, int endSample,
+                                               float stretchFactor, StretchQuality quality);
+    
+    // Writers (message thread, render thread) build the new list under
+    // stretchWriteLock_ and only swap it in under stretchLock_, which the
+    // audio thread just tries
+    StretchCache stretchCache_;
+    mutable Omega::Utils::SpinLock stretchLock_;
+    juce::CriticalSection stretchWriteLock_;
+    size_t stretchCacheSamples_;                    // Guarded by stretchWriteLock_
+    size_t stretchCacheLimit_;                      // In samples (all channels)
+    std::atomic<uint64_t> stretchClock_;
+    float targetStretch_;                           // 0 = no cache
+    std::atomic<StretchQuality> stretchQuality_;
+    std::atomic<uint32_t> stretchGeneration_;
+    std::unique_ptr<juce::ThreadPool> stretchPool_;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleSlicer)
 };
 
@@ -81,7 +81,10 @@ public:
     
 protected:
     void prepareSynth(const juce::dsp::ProcessSpec& spec) override {
+        // Offline render picks the higher distortion oversampling
+        synth.setNonRealtime(isNonRealtime());
         synth.prepare(spec);
+        setLatencySamples(synth.getLatencySamples());
     }
     
     void renderSynth(juce::AudioBuffer<float>& buffer, 
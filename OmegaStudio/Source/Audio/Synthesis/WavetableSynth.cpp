@@ -85,7 +85,7 @@ void WavetableSynth::prepare(const juce::dsp::ProcessSpec& spec) {
     setCurrentPlaybackSampleRate(spec.sampleRate);
     
     chorus.prepare(spec.sampleRate, (int)spec.maximumBlockSize);
-    distortion.prepare(spec.sampleRate);
+    distortion.prepare((int)spec.maximumBlockSize, distortionOversampling, nonRealtime);
 }
 
 void WavetableSynth::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
@@ -101,9 +101,10 @@ void WavetableSynth::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
         chorus.process(outputBuffer, params.chorusMix);
     }
     
-    if (params.distortionEnabled && params.distortionAmount > 0.0f) {
-        distortion.process(outputBuffer, params.distortionAmount);
-    }
+    // Distortion always goes through the oversampler: constant latency for
+    // PDC and no click when it is switched on
+    const float distortionAmount = params.distortionEnabled ? params.distortionAmount : 0.0f;
+    distortion.process(outputBuffer, startSample, numSamples, distortionAmount);
     
     // Apply master volume
     outputBuffer.applyGain(params.masterVolume);
@@ -588,20 +589,31 @@ void WavetableSynth::ChorusEffect::reset() {
     chorus.reset();
 }
 
-void WavetableSynth::DistortionEffect::prepare(double sampleRate) {
-    // Nothing to prepare
+void WavetableSynth::DistortionEffect::prepare(int maxBlockSize, const Oversampler::Settings& settings, bool nonRealtime) {
+    oversampler.prepare(2, maxBlockSize, settings, nonRealtime);
 }
 
-void WavetableSynth::DistortionEffect::process(juce::AudioBuffer<float>& buffer, float amount) {
+void WavetableSynth::DistortionEffect::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float amount) {
+    if (amount <= 0.0f && oversampler.getFactor() == 1)
+        return;
+    
+    float* channels[2] = {};
+    const int numChannels = juce::jmin(2, buffer.getNumChannels());
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[ch] = buffer.getWritePointer(ch, startSample);
+    
     float drive = 1.0f + amount * 9.0f; // 1-10x
     
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        for (int i = 0; i < buffer.getNumSamples(); ++i) {
-            float sample = buffer.getSample(ch, i);
-            float processed = processSample(sample, drive);
-            buffer.setSample(ch, i, processed);
-        }
-    }
+    // tanh at the oversampled rate: the harmonics it generates above the
+    // base Nyquist are filtered on the way down instead of aliasing
+    oversampler.process(channels, numChannels, numSamples,
+        [this, amount, drive](float* const* data, int channelCount, int count) {
+            if (amount <= 0.0f)
+                return;
+            for (int ch = 0; ch < channelCount; ++ch)
+                for (int i = 0; i < count; ++i)
+                    data[ch][i] = processSample(data[ch][i], drive);
+        });
 }
 
 float WavetableSynth::DistortionEffect::processSample(float input, float drive) {
@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../DSP/Oversampler.h"
 #include <array>
 #include <vector>
 #include <atomic>
@@ -183,6 +184,11 @@ public:
     void setMaxPolyphony(int voices);
     int getActiveVoiceCount() const;
     double getCPUUsage() const { return cpuUsage.load(); }
+    
+    // Distortion oversampling: realtime / offline factors, applied in prepare()
+    void setDistortionOversampling(const Oversampler::Settings& settings) { distortionOversampling = settings; }
+    void setNonRealtime(bool isNonRealtime) { nonRealtime = isNonRealtime; }
+    int getLatencySamples() const { return distortion.getLatencySamples(); }
 
 private:
     //==============================================================================
@@ -279,11 +285,14 @@ private:
     
     class DistortionEffect {
     public:
-        void prepare(double sampleRate);
-        void process(juce::AudioBuffer<float>& buffer, float amount);
+        void prepare(int maxBlockSize, const Oversampler::Settings& settings, bool nonRealtime);
+        void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples, float amount);
+        int getLatencySamples() const { return oversampler.getLatencySamples(); }
         
     private:
         float processSample(float input, float drive);
+        
+        Oversampler oversampler;
     };
     
     //==============================================================================
@@ -293,6 +302,8 @@ private:
     // Built-in effects
     ChorusEffect chorus;
     DistortionEffect distortion;
+    Oversampler::Settings distortionOversampling;
+    bool nonRealtime = false;
     
     // Performance monitoring
     std::atomic<double> cpuUsage{0.0};
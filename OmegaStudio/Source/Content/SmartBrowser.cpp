@@ -1,4 +1,5 @@
 #include "SmartBrowser.h"
+#include "../Audio/Analysis/AudioFeatureStore.h"
 #include <algorithm>
 #include <cmath>
 
@@ -14,6 +15,9 @@ void SmartBrowser::scanDirectory(const juce::File& directory, bool recursive) {
         return;
     }
     
+    auto& featureStore = omega::Analysis::AudioFeatureStore::getInstance();
+    juce::Array<juce::File> toAnalyse;
+    
     juce::Array<juce::File> files;
     int flags = juce::File::findFiles;
     if (recursive) {
@@ -43,6 +47,17 @@ void SmartBrowser::scanDirectory(const juce::File& directory, bool recursive) {
             continue; // Skip unknown types
         }
         
+        // BPM & key: straight from the feature store index, no decoding
+        if (item.type == ContentType::Sample) {
+            omega::Analysis::AudioFeatureSummary summary;
+            if (featureStore.getCachedSummary(file, summary)) {
+                item.bpm = summary.bpm;
+                item.key = summary.getKeyName();
+            } else {
+                toAnalyse.add(file);
+            }
+        }
+        
         // Auto-generate tags
         item.tags = autoGenerateTags(item);
         
@@ -55,6 +70,34 @@ void SmartBrowser::scanDirectory(const juce::File& directory, bool recursive) {
         
         addItem(item);
     }
+    
+    // First time in this folder: analyse on every core
+    featureStore.analyseInBackground(toAnalyse);
+}
+
+int SmartBrowser::updateAnalysis() {
+    auto& featureStore = omega::Analysis::AudioFeatureStore::getInstance();
+    int updated = 0;
+    
+    for (auto& item : database) {
+        if (item.type != ContentType::Sample || item.bpm > 0.0f || !item.key.isEmpty()) {
+            continue;
+        }
+        
+        omega::Analysis::AudioFeatureSummary summary;
+        if (featureStore.getCachedSummary(juce::File(item.path), summary)
+            && (summary.bpm > 0.0f || summary.key >= 0)) {
+            item.bpm = summary.bpm;
+            item.key = summary.getKeyName();
+            ++updated;
+        }
+    }
+    
+    return updated;
+}
+
+bool SmartBrowser::isAnalysing() const {
+    return omega::Analysis::AudioFeatureStore::getInstance().isAnalysing();
 }
 
 void SmartBrowser::addItem(const ContentItem& item) {
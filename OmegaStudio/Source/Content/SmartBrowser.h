@@ -72,7 +72,13 @@ public:
     ~SmartBrowser();
     
     // Content management
+    // Samples take BPM/key from the feature store; files it doesn't know yet
+    // are analysed in the background (see updateAnalysis())
     void scanDirectory(const juce::File& directory, bool recursive = true);
+    
+    // Pull finished background analyses into the database, returns items updated
+    int updateAnalysis();
+    bool isAnalysing() const;
     void addItem(const ContentItem& item);
     void removeItem(const juce::String& path);
     void clearDatabase();
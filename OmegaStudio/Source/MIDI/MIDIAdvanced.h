@@ -6,6 +6,7 @@
 #include <array>
 #include <cstring>
 #include "../Memory/LockFreeFIFO.h"
+#include "../Utils/Atomic.h"
 
 namespace OmegaStudio {
 namespace MIDI {
@@ -24,6 +25,7 @@ public:
     void closeDevice();
     bool isDeviceOpen() const { return deviceOpen; }
     juce::String getCurrentDevice() const { return currentDevice; }
+    juce::MidiOutput* getMidiOutput() const { return midiOutput.get(); }
     static juce::StringArray getAvailableDevices();
     
     // Send MIDI messages
@@ -277,6 +279,7 @@ public:
         uint8_t size { 0 };
         int samplePosition { 0 }; // position within current block
         bool isSysEx { false };
+        double timestamp { 0.0 }; // hi-res arrival time in seconds; 0 = place at samplePosition
 
         static RTEvent fromMessage(const juce::MidiMessage& msg, int samplePos = 0) {
             RTEvent ev;
@@ -296,6 +299,12 @@ public:
     // Lock-free queues (audio thread consumes)
     Memory::LockFreeFIFO<RTEvent, 1024>& getInputQueue() { return inputQueue; }
     Memory::LockFreeFIFO<RTEvent, 1024>& getOutputQueue() { return outputQueue; }
+
+    // Serialises producers (MIDI driver thread, scripts) so the input queue stays single-producer
+    bool pushInput(const RTEvent& event) {
+        Omega::Utils::SpinLockGuard guard(inputProducerLock);
+        return inputQueue.push(event);
+    }
     
     // MIDI Out
     MIDIOut* getMIDIOut() { return midiOut.get(); }
@@ -329,7 +338,8 @@ private:
     bool midiLearnActive = false;
     juce::String midiLearnTarget;
 
-    Memory::LockFreeFIFO<RTEvent, 1024> inputQueue;   // GUI → Audio (scripted)
+    Memory::LockFreeFIFO<RTEvent, 1024> inputQueue;   // MIDI in / GUI → Audio
+    Omega::Utils::SpinLock inputProducerLock;
     Memory::LockFreeFIFO<RTEvent, 1024> outputQueue;  // Audio → GUI / hardware send
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MIDIManager)
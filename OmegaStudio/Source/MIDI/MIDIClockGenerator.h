@@ -0,0 +1,443 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include "MIDIAdvanced.h"
+#include "../Composition/CompositionTools.h"
+#include "../Memory/LockFreeFIFO.h"
+#include "../Utils/Atomic.h"
+
+namespace OmegaStudio {
+namespace MIDI {
+
+using RTEventQueue = Omega::Memory::LockFreeFIFO<MIDIManager::RTEvent, 1024>;
+
+/**
+ * @brief Clock Tempo Map - RT-safe copy of the tempo map
+ *
+ * A piecewise list of segments whose tempo is linear in beats, so both
+ * directions have a closed form:
+ *   bpm(b)     = bpm0 + slope * (b - b0)
+ *   seconds(b) = s0 + 60 / slope * ln(bpm(b) / bpm0)      (60 * (b - b0) / bpm0 if slope == 0)
+ * Fixed capacity and trivially copyable, so the audio thread can take a new
+ * copy without touching the heap.
+ */
+class ClockTempoMap
+{
+public:
+    static constexpr int kMaxSegments = 256;
+
+    struct Segment {
+        double startBeat = 0.0;
+        double startSeconds = 0.0;
+        double startBpm = 120.0;
+        double slope = 0.0;   // bpm per beat; 0 = constant tempo
+    };
+
+    explicit ClockTempoMap(double bpm = 120.0) { setConstant(bpm); }
+
+    void setConstant(double bpm)
+    {
+        numSegments = 1;
+        segments[0] = { 0.0, 0.0, juce::jmax(1.0, bpm), 0.0 };
+    }
+
+    /** Appends a ramp from the current tempo to targetBpm over rampBeats (0 = jump). */
+    bool addChange(double beat, double targetBpm, double rampBeats = 0.0)
+    {
+        targetBpm = juce::jmax(1.0, targetBpm);
+        const auto& last = segments[(size_t) numSegments - 1];
+        if (beat < last.startBeat || numSegments + 2 > kMaxSegments) return false;
+
+        const double bpmAtChange = tempoIn(last, beat);
+        if (rampBeats > 0.0) {
+            pushSegment(beat, bpmAtChange, (targetBpm - bpmAtChange) / rampBeats);
+            pushSegment(beat + rampBeats, targetBpm, 0.0);
+        } else {
+            pushSegment(beat, targetBpm, 0.0);
+        }
+        return true;
+    }
+
+    /**
+     * Builds the map from the arrangement TempoMap. Linear changes become ramps;
+     * exponential/logarithmic curves are approximated by linear ramps of the same
+     * length. Call off the audio thread.
+     */
+    static ClockTempoMap fromTempoMap(const TempoMap& map)
+    {
+        ClockTempoMap result(map.getGlobalTempo());
+        for (int i = 0; i < map.getNumTempoChanges(); ++i) {
+            const auto& change = map.getTempoChange(i);
+            const bool ramp = change.curve != TempoMap::TempoChange::Curve::Instant && change.curveDuration > 0.0;
+            result.addChange(change.position, change.bpm, ramp ? change.curveDuration : 0.0);
+        }
+        return result;
+    }
+
+    double getTempoAtBeat(double beat) const
+    {
+        return tempoIn(segments[(size_t) findByBeat(beat)], beat);
+    }
+
+    double beatToSeconds(double beat) const
+    {
+        const auto& s = segments[(size_t) findByBeat(beat)];
+        const double db = beat - s.startBeat;
+        if (s.slope == 0.0)
+            return s.startSeconds + 60.0 * db / s.startBpm;
+        return s.startSeconds + 60.0 / s.slope * std::log(tempoIn(s, beat) / s.startBpm);
+    }
+
+    double secondsToBeat(double seconds) const
+    {
+        int index = 0;
+        for (int lo = 0, hi = numSegments - 1; lo <= hi;) {
+            const int mid = (lo + hi) / 2;
+            if (segments[(size_t) mid].startSeconds <= seconds) { index = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+
+        const auto& s = segments[(size_t) index];
+        const double dt = seconds - s.startSeconds;
+        if (s.slope == 0.0)
+            return s.startBeat + dt * s.startBpm / 60.0;
+        return s.startBeat + s.startBpm * (std::exp(s.slope * dt / 60.0) - 1.0) / s.slope;
+    }
+
+    int getNumSegments() const { return numSegments; }
+
+private:
+    static double tempoIn(const Segment& s, double beat)
+    {
+        return juce::jmax(1.0, s.startBpm + s.slope * (beat - s.startBeat));
+    }
+
+    int findByBeat(double beat) const
+    {
+        int index = 0;
+        for (int lo = 0, hi = numSegments - 1; lo <= hi;) {
+            const int mid = (lo + hi) / 2;
+            if (segments[(size_t) mid].startBeat <= beat) { index = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+        return index;
+    }
+
+    void pushSegment(double beat, double bpm, double slope)
+    {
+        auto& last = segments[(size_t) numSegments - 1];
+        if (beat <= last.startBeat) {
+            // Replaces a segment that would have zero length
+            const double seconds = last.startSeconds;
+            last = { beat, seconds, bpm, slope };
+            return;
+        }
+        const double seconds = beatToSeconds(beat);
+        segments[(size_t) numSegments++] = { beat, seconds, bpm, slope };
+    }
+
+    std::array<Segment, kMaxSegments> segments {};
+    int numSegments = 1;
+};
+
+/**
+ * @brief MIDI Clock Generator - clock, MTC and song position from the audio thread
+ *
+ * Every block the generator works out which 24 PPQN clock ticks and MTC
+ * quarter frames fall inside it, using the tempo map in closed form (ramps
+ * included), and pushes them into the output queue stamped with the wall-clock
+ * time at which that sample will leave the speakers. The MIDIOutputThread then
+ * sends them at that time, so external gear follows the audio instead of the
+ * callback jitter.
+ *
+ * Transport requests (start / stop / locate) come from any thread through a
+ * small lock-free command FIFO and take effect at the start of the next block.
+ */
+class MIDIClockGenerator
+{
+public:
+    enum class MTCRate { Fps24 = 0, Fps25 = 1, Fps2997Drop = 2, Fps30 = 3 };
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        playing = false;
+        playingFlag.store(false, std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    // Configuration (message thread)
+    void setClockEnabled(bool enabled) { clockEnabled.store(enabled, std::memory_order_relaxed); }
+    void setMTCEnabled(bool enabled) { mtcEnabled.store(enabled, std::memory_order_relaxed); }
+    void setMTCRate(MTCRate rate) { mtcRate.store(rate, std::memory_order_relaxed); }
+
+    /** Output latency added to every stamp (device latency, external gear offset). */
+    void setOutputOffsetSeconds(double seconds) { outputOffset.store(seconds, std::memory_order_relaxed); }
+
+    void setTempoMap(const ClockTempoMap& map)
+    {
+        Omega::Utils::SpinLockGuard guard(tempoLock);
+        pendingTempoMap = map;
+        tempoMapDirty = true;
+    }
+
+    //==========================================================================
+    // Transport (any thread)
+    void start(double fromBeat = 0.0) { pushCommand({ Command::Start, fromBeat }); }
+    void stop() { pushCommand({ Command::Stop, 0.0 }); }
+    void locate(double beat) { pushCommand({ Command::Locate, beat }); }
+
+    bool isPlaying() const { return playingFlag.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    /**
+     * Audio thread. blockTime is the wall-clock time of the first sample of the
+     * block and secondsPerSample the measured sample period (see MIDIInputClock).
+     */
+    void process(int64_t blockStartSample, int numSamples, double blockTime,
+                 double secondsPerSample, RTEventQueue& queue)
+    {
+        pullTempoMap();
+
+        blockStart = blockStartSample;
+        blockWallTime = blockTime + outputOffset.load(std::memory_order_relaxed);
+        wallSecondsPerSample = secondsPerSample;
+
+        while (auto command = commands.pop())
+            handleCommand(*command, queue);
+
+        if (!playing || numSamples <= 0) return;
+
+        const int64_t blockEnd = blockStartSample + numSamples;
+
+        if (clockEnabled.load(std::memory_order_relaxed)) {
+            for (;;) {
+                const int64_t sample = sampleForSeconds(tempoMap.beatToSeconds((double) nextTick / kPPQN));
+                if (sample >= blockEnd) break;
+
+                const uint8_t tick = 0xf8;
+                push(queue, &tick, 1, sample);
+                ++nextTick;
+            }
+        }
+
+        if (mtcEnabled.load(std::memory_order_relaxed)) {
+            const double quarterFrame = 1.0 / (4.0 * framesPerSecond());
+            for (;;) {
+                const int64_t sample = sampleForSeconds((double) nextQuarterFrame * quarterFrame);
+                if (sample >= blockEnd) break;
+
+                const uint8_t message[2] = { 0xf1, quarterFrameData(nextQuarterFrame) };
+                push(queue, message, 2, sample);
+                ++nextQuarterFrame;
+            }
+        }
+    }
+
+    int getDroppedEvents() const { return droppedEvents.load(std::memory_order_relaxed); }
+
+    static constexpr int kPPQN = 24;
+
+private:
+    struct Command {
+        enum Type : int { Start, Stop, Locate } type = Start;
+        double beat = 0.0;
+    };
+
+    void pushCommand(const Command& command)
+    {
+        Omega::Utils::SpinLockGuard guard(commandLock);
+        if (!commands.push(command))
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void pullTempoMap()
+    {
+        if (!tempoLock.tryLock()) return;
+        if (tempoMapDirty) {
+            // Keep the current song position across the tempo change
+            const double beat = playing ? tempoMap.secondsToBeat(secondsForSample(blockStart)) : 0.0;
+            tempoMap = pendingTempoMap;
+            tempoMapDirty = false;
+            if (playing) anchor(beat, blockStart);
+        }
+        tempoLock.unlock();
+    }
+
+    void handleCommand(const Command& command, RTEventQueue& queue)
+    {
+        switch (command.type) {
+            case Command::Start: {
+                const double beat = snapToSixteenth(command.beat);
+                anchor(beat, blockStart);
+                sendPosition(beat, queue);
+                const uint8_t message = beat > 0.0 ? 0xfb : 0xfa;  // Continue / Start
+                push(queue, &message, 1, blockStart);
+                playing = true;
+                break;
+            }
+            case Command::Stop: {
+                if (playing) {
+                    const uint8_t message = 0xfc;
+                    push(queue, &message, 1, blockStart);
+                }
+                playing = false;
+                break;
+            }
+            case Command::Locate: {
+                const double beat = snapToSixteenth(command.beat);
+                anchor(beat, blockStart);
+                sendPosition(beat, queue);
+                break;
+            }
+        }
+        playingFlag.store(playing, std::memory_order_relaxed);
+    }
+
+    /** The transport plays song time `beat` at absolute sample `atSample`. */
+    void anchor(double beat, int64_t atSample)
+    {
+        anchorSample = atSample;
+        anchorSeconds = tempoMap.beatToSeconds(beat);
+        nextTick = (int64_t) std::ceil(beat * kPPQN - 1.0e-9);
+        nextQuarterFrame = (int64_t) std::ceil(anchorSeconds * 4.0 * framesPerSecond() - 1.0e-9);
+        nextQuarterFrame = (nextQuarterFrame + 7) / 8 * 8;  // MTC groups start on piece 0
+    }
+
+    double secondsForSample(int64_t sample) const
+    {
+        return anchorSeconds + (double) (sample - anchorSample) / sampleRate;
+    }
+
+    int64_t sampleForSeconds(double seconds) const
+    {
+        return anchorSample + (int64_t) std::llround((seconds - anchorSeconds) * sampleRate);
+    }
+
+    // Song Position Pointer counts sixteenth notes, so positions snap up to the next one
+    static double snapToSixteenth(double beat)
+    {
+        return std::ceil(juce::jmax(0.0, beat) * 4.0 - 1.0e-9) / 4.0;
+    }
+
+    void sendPosition(double beat, RTEventQueue& queue)
+    {
+        const int sixteenths = juce::jlimit(0, 0x3fff, (int) std::llround(beat * 4.0));
+        const uint8_t spp[3] = { 0xf2, (uint8_t) (sixteenths & 0x7f), (uint8_t) ((sixteenths >> 7) & 0x7f) };
+        push(queue, spp, 3, blockStart);
+
+        if (mtcEnabled.load(std::memory_order_relaxed)) {
+            // Full-frame MTC message so receivers jump instead of chasing quarter frames
+            int h, m, s, f;
+            timecodeForFrame((int64_t) std::floor(anchorSeconds * framesPerSecond()), h, m, s, f);
+            const uint8_t fullFrame[10] = { 0xf0, 0x7f, 0x7f, 0x01, 0x01,
+                                            (uint8_t) ((rateBits() << 5) | (h & 0x1f)),
+                                            (uint8_t) m, (uint8_t) s, (uint8_t) f, 0xf7 };
+            push(queue, fullFrame, 10, blockStart);
+        }
+    }
+
+    void push(RTEventQueue& queue, const uint8_t* data, int size, int64_t sample)
+    {
+        MIDIManager::RTEvent event;
+        std::memcpy(event.bytes.data(), data, (size_t) size);
+        event.size = (uint8_t) size;
+        event.isSysEx = data[0] == 0xf0;
+        event.samplePosition = (int) (sample - blockStart);
+        event.timestamp = blockWallTime + (double) (sample - blockStart) * wallSecondsPerSample;
+
+        if (!queue.push(event))
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    // MTC helpers
+    double framesPerSecond() const
+    {
+        switch (mtcRate.load(std::memory_order_relaxed)) {
+            case MTCRate::Fps24:       return 24.0;
+            case MTCRate::Fps25:       return 25.0;
+            case MTCRate::Fps2997Drop: return 30000.0 / 1001.0;
+            case MTCRate::Fps30:       return 30.0;
+        }
+        return 30.0;
+    }
+
+    int rateBits() const { return (int) mtcRate.load(std::memory_order_relaxed); }
+
+    void timecodeForFrame(int64_t frame, int& hours, int& minutes, int& seconds, int& frames) const
+    {
+        int nominal = (int) std::lround(framesPerSecond());
+
+        if (mtcRate.load(std::memory_order_relaxed) == MTCRate::Fps2997Drop) {
+            // Drop-frame: skip labels 0 and 1 every minute except each tenth minute
+            const int64_t framesPer10Min = 17982;
+            const int64_t framesPerMin = 1798;
+            const int64_t tens = frame / framesPer10Min;
+            const int64_t rem = frame % framesPer10Min;
+            frame += 18 * tens + (rem > 1 ? 2 * ((rem - 2) / framesPerMin) : 0);
+            nominal = 30;
+        }
+
+        frames = (int) (frame % nominal);
+        const int64_t totalSeconds = frame / nominal;
+        seconds = (int) (totalSeconds % 60);
+        minutes = (int) ((totalSeconds / 60) % 60);
+        hours = (int) ((totalSeconds / 3600) % 24);
+    }
+
+    uint8_t quarterFrameData(int64_t quarterFrame) const
+    {
+        // Each group of 8 pieces describes the frame at which the group started
+        const int piece = (int) (quarterFrame & 7);
+        int h, m, s, f;
+        timecodeForFrame((quarterFrame - piece) / 4, h, m, s, f);
+
+        int nibble = 0;
+        switch (piece) {
+            case 0: nibble = f & 0x0f; break;
+            case 1: nibble = (f >> 4) & 0x01; break;
+            case 2: nibble = s & 0x0f; break;
+            case 3: nibble = (s >> 4) & 0x03; break;
+            case 4: nibble = m & 0x0f; break;
+            case 5: nibble = (m >> 4) & 0x03; break;
+            case 6: nibble = h & 0x0f; break;
+            case 7: nibble = ((h >> 4) & 0x01) | (rateBits() << 1); break;
+        }
+        return (uint8_t) ((piece << 4) | nibble);
+    }
+
+    //==========================================================================
+    double sampleRate = 44100.0;
+
+    // Audio-thread state
+    ClockTempoMap tempoMap;
+    bool playing = false;
+    int64_t anchorSample = 0;
+    double anchorSeconds = 0.0;
+    int64_t nextTick = 0;
+    int64_t nextQuarterFrame = 0;
+    int64_t blockStart = 0;
+    double blockWallTime = 0.0;
+    double wallSecondsPerSample = 1.0 / 44100.0;
+
+    // Shared with the message thread
+    Omega::Utils::SpinLock tempoLock;
+    ClockTempoMap pendingTempoMap;
+    bool tempoMapDirty = false;
+
+    Omega::Utils::SpinLock commandLock;
+    Omega::Memory::LockFreeFIFO<Command, 32> commands;
+
+    std::atomic<bool> clockEnabled { true };
+    std::atomic<bool> mtcEnabled { false };
+    std::atomic<MTCRate> mtcRate { MTCRate::Fps25 };
+    std::atomic<double> outputOffset { 0.0 };
+    std::atomic<bool> playingFlag { false };
+    std::atomic<int> droppedEvents { 0 };
+};
+
+} // namespace MIDI
+} // namespace OmegaStudio
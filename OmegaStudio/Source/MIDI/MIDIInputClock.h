@@ -0,0 +1,127 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+
+namespace OmegaStudio {
+namespace MIDI {
+
+/**
+ * @brief MIDI Input Clock - maps arrival timestamps to sample offsets
+ *
+ * Live MIDI arrives on the driver thread, stamped with
+ * Time::getMillisecondCounterHiRes() * 0.001. The audio callback runs on a
+ * different clock (the sound card crystal) and its wake-up time jitters by up
+ * to a buffer. A second-order delay-locked loop filters the measured callback
+ * times into a smooth estimate of when each block really started, which also
+ * tracks the drift between both clocks.
+ *
+ * Events stamped inside the previous filtered block period [start, end) are
+ * placed proportionally inside the current block. Every event is delayed by
+ * exactly one block, so latency is constant and jitter stays well under 1 ms
+ * instead of one buffer.
+ *
+ * beginBlock() / toSampleOffset() are called only from the audio thread.
+ */
+class MIDIInputClock
+{
+public:
+    void prepare(double newSampleRate, int blockSize, double bandwidthHz = 0.5)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        expectedBlockSize = juce::jmax(1, blockSize);
+        bandwidth = juce::jmax(0.01, bandwidthHz);
+        reset();
+    }
+
+    /** Forces the loop to relock on the next block (device restart, xrun...). */
+    void reset() { locked = false; }
+
+    /** Call once per audio callback with the hi-res time taken at callback entry. */
+    void beginBlock(double callbackTimeSeconds, int numSamples)
+    {
+        numSamples = juce::jmax(1, numSamples);
+        const double period = numSamples / sampleRate;
+
+        if (!locked || numSamples != lockedBlockSize
+            || std::abs(callbackTimeSeconds - t1) > kRelockPeriods * period)
+        {
+            lock(callbackTimeSeconds, numSamples, period);
+            return;
+        }
+
+        const double error = callbackTimeSeconds - t1;
+        windowStart = t0;
+        t0 = t1;
+        t1 += b * error + e2;
+        e2 += c * error;
+        windowEnd = t0;
+        currentBlockSize = numSamples;
+        lastError = error;
+    }
+
+    /** Offset inside the current block for an event stamped at the given time. */
+    int toSampleOffset(double timestampSeconds) const
+    {
+        const double span = windowEnd - windowStart;
+        if (span <= 0.0) return 0;
+
+        const double position = (timestampSeconds - windowStart) / span * currentBlockSize;
+        return juce::jlimit(0, currentBlockSize - 1, (int) std::floor(position));
+    }
+
+    /** Inverse mapping: arrival time that corresponds to an offset in the current block. */
+    double toTimestamp(int sampleOffset) const
+    {
+        return windowStart + (windowEnd - windowStart) * (double) sampleOffset / (double) currentBlockSize;
+    }
+
+    /** Filtered start time of the current block and the measured length of one sample. */
+    double getBlockTime() const { return windowEnd; }
+    double getSecondsPerSample() const { return e2 > 0.0 ? e2 / lockedBlockSize : 1.0 / sampleRate; }
+
+    bool isLocked() const { return locked; }
+
+    /** Sample rate as seen from the hi-res clock (reveals crystal drift). */
+    double getMeasuredSampleRate() const { return e2 > 0.0 ? lockedBlockSize / e2 : sampleRate; }
+
+    /** Last raw callback error against the prediction, in seconds. */
+    double getLastErrorSeconds() const { return lastError; }
+
+    /** Constant latency added to live input so it can be placed without jitter. */
+    int getLatencySamples() const { return expectedBlockSize; }
+
+private:
+    static constexpr double kRelockPeriods = 4.0;
+
+    void lock(double now, int numSamples, double period)
+    {
+        // Loop coefficients for a critically damped 2nd-order DLL
+        const double omega = juce::MathConstants<double>::twoPi * bandwidth * period;
+        b = std::sqrt(2.0) * omega;
+        c = omega * omega;
+
+        e2 = period;
+        t0 = now;
+        t1 = now + period;
+        windowStart = now - period;
+        windowEnd = now;
+        lockedBlockSize = currentBlockSize = numSamples;
+        lastError = 0.0;
+        locked = true;
+    }
+
+    double sampleRate = 44100.0;
+    double bandwidth = 0.5;
+    int expectedBlockSize = 512;
+
+    bool locked = false;
+    int lockedBlockSize = 512;
+    int currentBlockSize = 512;
+    double b = 0.0, c = 0.0;
+    double t0 = 0.0, t1 = 0.0, e2 = 0.0;
+    double windowStart = 0.0, windowEnd = 0.0;
+    double lastError = 0.0;
+};
+
+} // namespace MIDI
+} // namespace OmegaStudio
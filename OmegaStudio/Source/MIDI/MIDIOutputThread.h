@@ -0,0 +1,160 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include <cmath>
+#include <functional>
+#include "MIDIClockGenerator.h"
+
+namespace OmegaStudio {
+namespace MIDI {
+
+/**
+ * @brief MIDI Output Thread - sends timestamped events at their wall-clock time
+ *
+ * Drains MIDIManager's output queue (filled by the audio thread) into a small
+ * time-ordered pending list and sends each event when its timestamp is due:
+ * it sleeps while the next event is far away and yields for the last
+ * millisecond so the OS scheduler granularity does not add jitter. Events
+ * with timestamp 0 (MIDI thru, immediate sends) go out at once.
+ *
+ * Lateness of every sent event is accumulated so drift and jitter can be
+ * checked against real hardware or a loopback port.
+ */
+class MIDIOutputThread : public juce::Thread
+{
+public:
+    using SendCallback = std::function<void(const juce::MidiMessage&, double dueTime)>;
+
+    struct Stats {
+        int64_t eventsSent = 0;
+        double meanLatenessMs = 0.0;
+        double stdDevLatenessMs = 0.0;
+        double maxLatenessMs = 0.0;
+    };
+
+    explicit MIDIOutputThread(RTEventQueue& queueToDrain)
+        : juce::Thread("MIDI Output"), queue(queueToDrain)
+    {
+        pending.reserve(kMaxPending);
+    }
+
+    ~MIDIOutputThread() override { stopThread(1000); }
+
+    /** Destination device; set before startThread(). */
+    void setOutput(juce::MidiOutput* output) { midiOutput = output; }
+
+    /** Alternative sink (tests, virtual routing); set before startThread(). */
+    void setSendCallback(SendCallback callback) { sendCallback = std::move(callback); }
+
+    Stats getStats() const
+    {
+        const juce::ScopedLock sl(statsLock);
+        Stats stats;
+        stats.eventsSent = count;
+        if (count > 0) {
+            stats.meanLatenessMs = sum / (double) count * 1000.0;
+            const double variance = juce::jmax(0.0, sumSquares / (double) count - (sum / (double) count) * (sum / (double) count));
+            stats.stdDevLatenessMs = std::sqrt(variance) * 1000.0;
+            stats.maxLatenessMs = maxLateness * 1000.0;
+        }
+        return stats;
+    }
+
+    void resetStats()
+    {
+        const juce::ScopedLock sl(statsLock);
+        count = 0;
+        sum = sumSquares = maxLateness = 0.0;
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit()) {
+            drainQueue();
+
+            if (pending.empty()) {
+                wait(1);
+                continue;
+            }
+
+            const double due = pending.front().timestamp;
+            const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+            const double remaining = due - now;
+
+            if (remaining > kSpinWindow) {
+                // Wake a little early; the queue is re-checked on every pass
+                wait(juce::jlimit(1, 10, (int) ((remaining - kSpinWindow) * 1000.0)));
+                continue;
+            }
+
+            while (juce::Time::getMillisecondCounterHiRes() * 0.001 < due && !threadShouldExit())
+                juce::Thread::yield();
+
+            sendDue();
+        }
+    }
+
+private:
+    static constexpr size_t kMaxPending = 2048;
+    static constexpr double kSpinWindow = 0.0015;
+
+    void drainQueue()
+    {
+        while (pending.size() < kMaxPending) {
+            auto event = queue.pop();
+            if (!event.has_value()) break;
+
+            // Immediate events keep their arrival order at the front
+            if (event->timestamp <= 0.0)
+                event->timestamp = juce::Time::getMillisecondCounterHiRes() * 0.001;
+
+            auto it = pending.end();
+            while (it != pending.begin() && (it - 1)->timestamp > event->timestamp) --it;
+            pending.insert(it, *event);
+        }
+    }
+
+    void sendDue()
+    {
+        const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+        size_t sent = 0;
+
+        while (sent < pending.size() && pending[sent].timestamp <= now) {
+            const auto& event = pending[sent];
+            const auto message = event.toMessage();
+
+            if (sendCallback)
+                sendCallback(message, event.timestamp);
+            else if (midiOutput != nullptr)
+                midiOutput->sendMessageNow(message);
+
+            record(juce::Time::getMillisecondCounterHiRes() * 0.001 - event.timestamp);
+            ++sent;
+        }
+
+        pending.erase(pending.begin(), pending.begin() + (std::ptrdiff_t) sent);
+    }
+
+    void record(double lateness)
+    {
+        const juce::ScopedLock sl(statsLock);
+        ++count;
+        sum += lateness;
+        sumSquares += lateness * lateness;
+        maxLateness = juce::jmax(maxLateness, std::abs(lateness));
+    }
+
+    RTEventQueue& queue;
+    std::vector<MIDIManager::RTEvent> pending;   // capacity fixed in the constructor
+    juce::MidiOutput* midiOutput = nullptr;      // non-owning
+    SendCallback sendCallback;
+
+    juce::CriticalSection statsLock;
+    int64_t count = 0;
+    double sum = 0.0, sumSquares = 0.0, maxLateness = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MIDIOutputThread)
+};
+
+} // namespace MIDI
+} // namespace OmegaStudio
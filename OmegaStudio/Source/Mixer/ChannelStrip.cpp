@@ -27,61 +27,25 @@ void ChannelStrip::initialize(double sampleRate, int /* maxBlockSize */)
     sampleRate_ = sampleRate;
     
     // Initialize filters
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = 512;
-    spec.numChannels = 1;
-    
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        lowShelf_[ch].prepare(spec);
-        lowMid_[ch].prepare(spec);
-        highMid_[ch].prepare(spec);
-        highShelf_[ch].prepare(spec);
-    }
-    
-    updateFilters();
+    eq_.prepare(sampleRate);
+    updateFilters(true);
 }
 
 void ChannelStrip::setSettings(const Settings& settings)
 {
     settings_ = settings;
-    updateFilters();
+    updateFilters(false);
 }
 
-void ChannelStrip::updateFilters()
+void ChannelStrip::updateFilters(bool immediate)
 {
-    // Low shelf
-    auto lowShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        sampleRate_, settings_.lowShelfFreq, 0.707f, 
-        juce::Decibels::decibelsToGain(settings_.lowShelfGain)
-    );
-    
-    // Low mid bell
-    auto lowMidCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate_, settings_.lowMidFreq, settings_.lowMidQ,
-        juce::Decibels::decibelsToGain(settings_.lowMidGain)
-    );
-    
-    // High mid bell
-    auto highMidCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate_, settings_.highMidFreq, settings_.highMidQ,
-        juce::Decibels::decibelsToGain(settings_.highMidGain)
-    );
-    
-    // High shelf
-    auto highShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        sampleRate_, settings_.highShelfFreq, 0.707f,
-        juce::Decibels::decibelsToGain(settings_.highShelfGain)
-    );
+    using OmegaStudio::BiquadCoefficients;
     
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        *lowShelf_[ch].coefficients = *lowShelfCoeffs;
-        *lowMid_[ch].coefficients = *lowMidCoeffs;
-        *highMid_[ch].coefficients = *highMidCoeffs;
-        *highShelf_[ch].coefficients = *highShelfCoeffs;
-    }
+    // Flat bands become identity stages and are skipped by the cascade
+    eq_.setStage(0, BiquadCoefficients::lowShelf(sampleRate_, settings_.lowShelfFreq, 0.707, settings_.lowShelfGain), immediate);
+    eq_.setStage(1, BiquadCoefficients::peak(sampleRate_, settings_.lowMidFreq, settings_.lowMidQ, settings_.lowMidGain), immediate);
+    eq_.setStage(2, BiquadCoefficients::peak(sampleRate_, settings_.highMidFreq, settings_.highMidQ, settings_.highMidGain), immediate);
+    eq_.setStage(3, BiquadCoefficients::highShelf(sampleRate_, settings_.highShelfFreq, 0.707, settings_.highShelfGain), immediate);
 }
 
 void ChannelStrip::process(juce::AudioBuffer<float>& buffer)
@@ -97,7 +61,26 @@ void ChannelStrip::process(juce::AudioBuffer<float>& buffer)
     }
     inputLevel_ /= numChannels;
     
-    for (int ch = 0; ch < numChannels && ch < 2; ++ch)
+    const int numProcessed = std::min(numChannels, 2);
+    
+    // Gate
+    if (settings_.gateEnabled)
+    {
+        for (int ch = 0; ch < numProcessed; ++ch)
+        {
+            float* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = processGate(data[i]);
+        }
+    }
+    
+    // EQ: both channels in one cascade pass
+    if (settings_.eqEnabled)
+    {
+        eq_.process(buffer.getArrayOfWritePointers(), numProcessed, numSamples);
+    }
+    
+    for (int ch = 0; ch < numProcessed; ++ch)
     {
         float* data = buffer.getWritePointer(ch);
         
@@ -105,21 +88,6 @@ void ChannelStrip::process(juce::AudioBuffer<float>& buffer)
         {
             float sample = data[i];
             
-            // Gate
-            if (settings_.gateEnabled)
-            {
-                sample = processGate(sample);
-            }
-            
-            // EQ
-            if (settings_.eqEnabled)
-            {
-                sample = lowShelf_[ch].processSample(sample);
-                sample = lowMid_[ch].processSample(sample);
-                sample = highMid_[ch].processSample(sample);
-                sample = highShelf_[ch].processSample(sample);
-            }
-            
             // Compressor
             if (settings_.compEnabled)
             {
@@ -230,13 +198,7 @@ void ChannelStrip::reset()
     compEnvelope_ = 1.0f;
     gainReduction_ = 0.0f;
     
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        lowShelf_[ch].reset();
-        lowMid_[ch].reset();
-        highMid_[ch].reset();
-        highShelf_[ch].reset();
-    }
+    eq_.reset();
 }
 
 //==============================================================================
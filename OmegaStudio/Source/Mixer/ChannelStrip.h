@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../Audio/DSP/BiquadCascade.h"
 #include <memory>
 
 namespace omega {
@@ -68,11 +69,8 @@ private:
     // Gate
     float gateEnvelope_;
     
-    // EQ filters
-    juce::dsp::IIR::Filter<float> lowShelf_[2];
-    juce::dsp::IIR::Filter<float> lowMid_[2];
-    juce::dsp::IIR::Filter<float> highMid_[2];
-    juce::dsp::IIR::Filter<float> highShelf_[2];
+    // EQ: 4 stages (low shelf, low mid, high mid, high shelf), one lane per channel
+    OmegaStudio::BiquadCascade eq_;
     
     // Compressor state
     float compEnvelope_;
@@ -82,7 +80,7 @@ private:
     float inputLevel_;
     float outputLevel_;
     
-    void updateFilters();
+    void updateFilters(bool immediate);
     float processGate(float input);
     float processCompressor(float input);
     
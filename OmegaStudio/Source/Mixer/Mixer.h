@@ -1,5 +1,6 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../Audio/DSP/BiquadCascade.h"
 #include <memory>
 #include <vector>
 #include <map>
@@ -162,7 +163,7 @@ private:
     // Built-in EQ
     bool eqEnabled = false;
     std::array<EQBand, NumEQBands> eqBands;
-    std::array<juce::dsp::IIR::Filter<float>, NumEQBands> eqFilters;
+    BiquadCascade eqCascade;    // One stage per band, stereo in one SIMD register
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerChannel)
 };
@@ -7,6 +7,7 @@
 
 #include "MixerEngine.h"
 #include <cmath>
+#include <utility>
 
 namespace OmegaStudio {
 
@@ -67,14 +68,32 @@ void LevelMeter::process(const juce::AudioBuffer<float>& buffer) {
     const int numSamples = buffer.getNumSamples();
     const int numChannels = juce::jmin(buffer.getNumChannels(), 2);
     
+    // Peak y RMS en una sola pasada
+    StripKernel::Levels levels;
     for (int ch = 0; ch < numChannels; ++ch) {
         const float* channelData = buffer.getReadPointer(ch);
         
-        // Peak
         float peak = 0.0f;
-        for (int i = 0; i < numSamples; ++i)
+        float sum = 0.0f;
+        for (int i = 0; i < numSamples; ++i) {
             peak = juce::jmax(peak, std::abs(channelData[i]));
+            sum += channelData[i] * channelData[i];
+        }
         
+        levels.peak[ch] = peak;
+        levels.sumSquares[ch] = sum;
+    }
+    
+    pushLevels(levels, numChannels, numSamples);
+}
+
+void LevelMeter::pushLevels(const StripKernel::Levels& levels, int numChannels, int numSamples) {
+    if (numSamples <= 0)
+        return;
+    
+    numChannels = juce::jmin(numChannels, 2);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const float peak = levels.peak[ch];
         peakLevels[ch] = peak;
         
         // Peak hold
@@ -86,16 +105,10 @@ void LevelMeter::process(const juce::AudioBuffer<float>& buffer) {
             peakHold[ch] = peak;
         }
         
-        // RMS
-        float sum = 0.0f;
-        for (int i = 0; i < numSamples; ++i)
-            sum += channelData[i] * channelData[i];
-        
-        float rms = std::sqrt(sum / numSamples);
-        rmsLevels[ch] = rms;
+        rmsLevels[ch] = std::sqrt(levels.sumSquares[ch] / numSamples);
     }
     
-    currentTime += numSamples / 48000.0; // Approximate
+    currentTime += numSamples / sampleRate;
 }
 
 float LevelMeter::getPeakLevel(int channel) const {
@@ -142,11 +155,14 @@ void ChannelStrip::setGain(float newGainDb) {
 
 void ChannelStrip::addSend(const BusSend& send) {
     sends.push_back(send);
+    sendRampIds.push_back(nextSendRampId++);
 }
 
 void ChannelStrip::removeSend(int index) {
-    if (index >= 0 && index < getNumSends())
+    if (index >= 0 && index < getNumSends()) {
         sends.erase(sends.begin() + index);
+        sendRampIds.erase(sendRampIds.begin() + index);
+    }
 }
 
 void ChannelStrip::setSendLevel(int sendIndex, float level) {
@@ -154,103 +170,189 @@ void ChannelStrip::setSendLevel(int sendIndex, float level) {
         sends[sendIndex].level = juce::jlimit(0.0f, 1.0f, level);
 }
 
-void ChannelStrip::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
-    if (buffer.getNumChannels() == 0 || buffer.getNumSamples() == 0)
+void ChannelStrip::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
+                           juce::AudioBuffer<float>* destination,
+                           const SendTap* sendTaps, int numSendTaps) {
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+    if (numChannels == 0 || numSamples == 0)
         return;
     
-    // Input metering
-    inputMeter.process(buffer);
+    const bool hasPlugins = pluginChain.getNumPlugins() > 0;
+    const float trim = getTrimGain();
     
-    // Mute
-    if (muted) {
-        buffer.clear();
-        return;
+    // Sin plugins, trim y polaridad se pliegan en la matriz de salida
+    const auto target = computeOutputMatrix(numChannels, hasPlugins ? 1.0f : trim);
+    
+    // Los canales por encima del par estéreo no pasan por la matriz (ni pan ni fader,
+    // como antes del kernel), pero sí llevan trim, polaridad y mute
+    const float extraGain = muted ? 0.0f : (hasPlugins ? 1.0f : trim);
+    
+    // Gains de los sends; un send inactivo vuelve a entrar con rampa desde 0
+    const int numSends = sendTaps != nullptr ? juce::jlimit(0, StripKernel::kMaxTaps, numSendTaps) : 0;
+    std::array<float, StripKernel::kMaxTaps> sendGains {};
+    for (int k = 0; k < numSends; ++k) {
+        const auto& send = sendTaps[k];
+        if (send.destination == nullptr || muted)
+            continue;
+        // Pre-fader: la entrada de la matriz aún no lleva el trim si este va plegado
+        sendGains[(size_t) k] = send.preFader && !hasPlugins ? send.level * trim : send.level;
     }
     
-    // Trim gain
-    if (gainDb != 0.0f) {
-        float gain = dbToGain(gainDb);
-        buffer.applyGain(gain);
+    // Primer bloque: sin rampas
+    const bool firstBlock = !rampsPrimed;
+    if (firstBlock) {
+        lastMatrix = target;
+        lastTrim = trim;
+        lastExtraGain = extraGain;
+        rampsPrimed = true;
     }
     
-    // Phase inversion
-    if (phaseInverted) {
-        buffer.applyGain(-1.0f);
+    // Cada rampa continúa desde el gain que tenía su send (por rampId, no por posición):
+    // borrar un send no desplaza las rampas de los demás, y uno nuevo entra desde 0
+    std::array<float, StripKernel::kMaxTaps> fromSendGains {};
+    bool sendsSilent = true;
+    for (int k = 0; k < numSends; ++k) {
+        float from = firstBlock ? sendGains[(size_t) k] : 0.0f;
+        for (int j = 0; j < lastNumSends && !firstBlock; ++j) {
+            if (lastSendRampIds[(size_t) j] == sendTaps[k].rampId)
+                from = lastSendGains[(size_t) j];
+        }
+        fromSendGains[(size_t) k] = from;
+        if (from != 0.0f || sendGains[(size_t) k] != 0.0f)
+            sendsSilent = false;
     }
     
-    // Plugin chain
-    pluginChain.process(buffer, midiMessages);
+    StripKernel::Levels inLevels, outLevels;
+    const int meteredChannels = juce::jmin(numChannels, 2);
+    
+    // Mute ya completado: medir la entrada y silenciar en una sola pasada
+    if (muted && lastMatrix.isZero() && sendsSilent) {
+        for (int ch = 0; ch < meteredChannels; ++ch)
+            StripKernel::measureAndScale(buffer.getWritePointer(ch), numSamples, 0.0f, 0.0f, inLevels, ch);
+        for (int ch = meteredChannels; ch < numChannels; ++ch)
+            buffer.clear(ch, 0, numSamples);
+        lastExtraGain = extraGain;
+        inputMeter.pushLevels(inLevels, meteredChannels, numSamples);
+        outputMeter.pushLevels(outLevels, meteredChannels, numSamples);
+        for (int k = 0; k < numSends; ++k)
+            lastSendRampIds[(size_t) k] = sendTaps[k].rampId;
+        lastSendGains = sendGains;
+        lastNumSends = numSends;
+        if (auto* tap = analysisTap.load())
+            tap->push(buffer);
+        return;
+    }
+    
+    bool inputMeasured = false;
+    if (hasPlugins) {
+        // Antes de la cadena: medidor de entrada + trim/polaridad en la misma pasada
+        for (int ch = 0; ch < meteredChannels; ++ch)
+            StripKernel::measureAndScale(buffer.getWritePointer(ch), numSamples, lastTrim, trim, inLevels, ch);
+        for (int ch = meteredChannels; ch < numChannels; ++ch)
+            buffer.applyGainRamp(ch, 0, numSamples, lastTrim, trim);
+        inputMeasured = true;
+        
+        pluginChain.process(buffer, midiMessages);
+    }
+    lastTrim = trim;
+    
+    const bool sumStereo = destination != nullptr && destination->getNumChannels() >= 2
+                           && destination->getNumSamples() >= numSamples;
+    const bool sumMono = destination != nullptr && destination->getNumChannels() >= 1
+                         && destination->getNumSamples() >= numSamples;
+    
+    // Sends como taps del kernel: pre-fader lee la entrada de la matriz, post-fader la salida
+    std::array<StripKernel::Tap, StripKernel::kMaxTaps> taps;
+    int numTaps = 0;
+    for (int k = 0; k < numSends; ++k) {
+        const float from = fromSendGains[(size_t) k];
+        const float to = sendGains[(size_t) k];
+        auto* sendBuffer = sendTaps[k].destination;
+        if ((from == 0.0f && to == 0.0f) || sendBuffer == nullptr
+            || sendBuffer->getNumChannels() == 0 || sendBuffer->getNumSamples() < numSamples)
+            continue;
+        
+        auto& tap = taps[(size_t) numTaps++];
+        tap.destL = sendBuffer->getWritePointer(0);
+        tap.destR = sendBuffer->getNumChannels() >= 2 ? sendBuffer->getWritePointer(1) : nullptr;
+        tap.fromGain = from;
+        tap.toGain = to;
+        tap.preFader = sendTaps[k].preFader;
+    }
+    
+    if (numChannels >= 2) {
+        // Pan, modo de ruteo, fader, medidores, sends y suma al bus: una lectura y una escritura
+        StripKernel::processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), numSamples,
+                                   lastMatrix, target,
+                                   sumStereo ? destination->getWritePointer(0) : nullptr,
+                                   sumStereo ? destination->getWritePointer(1) : nullptr,
+                                   inputMeasured ? nullptr : &inLevels, outLevels,
+                                   taps.data(), numTaps);
+        
+        if (!sumStereo && sumMono)
+            destination->addFrom(0, 0, buffer, 0, 0, numSamples);
+    }
+    else {
+        StripKernel::processMono(buffer.getWritePointer(0), numSamples, lastMatrix.a00, target.a00,
+                                 sumMono ? destination->getWritePointer(0) : nullptr,
+                                 inputMeasured ? nullptr : &inLevels, outLevels, 0,
+                                 taps.data(), numTaps);
+    }
+    for (int ch = 2; ch < numChannels; ++ch)
+        buffer.applyGainRamp(ch, 0, numSamples, lastExtraGain, extraGain);
+    lastExtraGain = extraGain;
     
-    // Apply gain and pan
-    applyGainAndPan(buffer);
+    lastMatrix = target;
+    for (int k = 0; k < numSends; ++k)
+        lastSendRampIds[(size_t) k] = sendTaps[k].rampId;
+    lastSendGains = sendGains;
+    lastNumSends = numSends;
     
-    // Routing
-    applyRouting(buffer);
+    inputMeter.pushLevels(inLevels, meteredChannels, numSamples);
+    outputMeter.pushLevels(outLevels, meteredChannels, numSamples);
     
-    // Output metering
-    outputMeter.process(buffer);
+    if (auto* tap = analysisTap.load())
+        tap->push(buffer);
 }
 
-void ChannelStrip::applyGainAndPan(juce::AudioBuffer<float>& buffer) {
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
+float ChannelStrip::getTrimGain() const {
+    const float trim = gainDb != 0.0f ? dbToGain(gainDb) : 1.0f;
+    return phaseInverted ? -trim : trim;
+}
+
+StripKernel::Matrix ChannelStrip::computeOutputMatrix(int numChannels, float trim) const {
+    StripKernel::Matrix m;
+    if (muted) {
+        m.a00 = m.a01 = m.a10 = m.a11 = 0.0f;
+        return m;
+    }
     
-    if (numChannels == 1) {
+    if (numChannels < 2) {
         // Mono: just apply volume
-        buffer.applyGain(0, 0, numSamples, volume);
+        m.a00 = volume * trim;
+        return m;
     }
-    else if (numChannels >= 2) {
-        // Stereo: apply volume and pan
-        float leftGain = volume * (pan <= 0.0f ? 1.0f : 1.0f - pan);
-        float rightGain = volume * (pan >= 0.0f ? 1.0f : 1.0f + pan);
-        
-        buffer.applyGain(0, 0, numSamples, leftGain);
-        buffer.applyGain(1, 0, numSamples, rightGain);
-    }
-}
-
-void ChannelStrip::applyRouting(juce::AudioBuffer<float>& buffer) {
+    
+    // Pan (balance) y fader
+    const float gl = trim * volume * (pan <= 0.0f ? 1.0f : 1.0f - pan);
+    const float gr = trim * volume * (pan >= 0.0f ? 1.0f : 1.0f + pan);
+    
+    // Modo de ruteo como matriz aplicada tras el pan: out = R * diag(gl, gr) * in
+    float r00 = 1.0f, r01 = 0.0f, r10 = 0.0f, r11 = 1.0f;
     switch (routingMode) {
-        case RoutingMode::Stereo:
-            // Normal stereo - no change
-            break;
-            
-        case RoutingMode::Mono:
-            if (buffer.getNumChannels() >= 2) {
-                // Sum L+R to mono
-                buffer.addFrom(0, 0, buffer, 1, 0, buffer.getNumSamples());
-                buffer.applyGain(0, 0, buffer.getNumSamples(), 0.5f);
-                buffer.copyFrom(1, 0, buffer, 0, 0, buffer.getNumSamples());
-            }
-            break;
-            
-        case RoutingMode::Left:
-            if (buffer.getNumChannels() >= 2) {
-                buffer.copyFrom(1, 0, buffer, 0, 0, buffer.getNumSamples());
-            }
-            break;
-            
-        case RoutingMode::Right:
-            if (buffer.getNumChannels() >= 2) {
-                buffer.copyFrom(0, 0, buffer, 1, 0, buffer.getNumSamples());
-            }
-            break;
-            
-        case RoutingMode::MidSide:
-            if (buffer.getNumChannels() >= 2) {
-                // Convert L/R to M/S
-                auto* left = buffer.getWritePointer(0);
-                auto* right = buffer.getWritePointer(1);
-                
-                for (int i = 0; i < buffer.getNumSamples(); ++i) {
-                    float l = left[i];
-                    float r = right[i];
-                    left[i] = (l + r) * 0.5f;  // Mid
-                    right[i] = (l - r) * 0.5f; // Side
-                }
-            }
-            break;
+        case RoutingMode::Stereo:  break;
+        case RoutingMode::Mono:    r00 = r01 = r10 = r11 = 0.5f; break;           // Sum L+R to mono
+        case RoutingMode::Left:    r00 = 1.0f; r01 = 0.0f; r10 = 1.0f; r11 = 0.0f; break;
+        case RoutingMode::Right:   r00 = 0.0f; r01 = 1.0f; r10 = 0.0f; r11 = 1.0f; break;
+        case RoutingMode::MidSide: r00 = r01 = r10 = 0.5f; r11 = -0.5f; break;    // Mid / Side
     }
+    
+    m.a00 = r00 * gl;
+    m.a01 = r01 * gr;
+    m.a10 = r10 * gl;
+    m.a11 = r11 * gr;
+    return m;
 }
 
 void ChannelStrip::prepareToPlay(double newSampleRate, int maximumExpectedSamplesPerBlock) {
@@ -258,8 +360,12 @@ void ChannelStrip::prepareToPlay(double newSampleRate, int maximumExpectedSample
     blockSize = maximumExpectedSamplesPerBlock;
     
     pluginChain.prepareToPlay(sampleRate, blockSize);
+    inputMeter.prepare(sampleRate);
+    outputMeter.prepare(sampleRate);
     inputMeter.reset();
     outputMeter.reset();
+    rampsPrimed = false;
+    lastNumSends = 0;
 }
 
 void ChannelStrip::releaseResources() {
@@ -306,7 +412,7 @@ std::unique_ptr<ChannelStrip> ChannelStrip::fromVar(const juce::var& v) {
         
         if (auto* sendsArray = obj->getProperty("sends").getArray()) {
             for (const auto& sendVar : *sendsArray)
-                channel->sends.push_back(BusSend::fromVar(sendVar));
+                channel->addSend(BusSend::fromVar(sendVar));
         }
         
         channel->pluginChain.setState(obj->getProperty("pluginChain"));
@@ -350,6 +456,7 @@ void MixerBus::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiM
 
 void MixerBus::prepareToPlay(double newSampleRate, int maximumExpectedSamplesPerBlock) {
     pluginChain.prepareToPlay(newSampleRate, maximumExpectedSamplesPerBlock);
+    meter.prepare(newSampleRate);
     meter.reset();
 }
 
@@ -364,6 +471,7 @@ juce::var MixerBus::toVar() const {
     obj->setProperty("volume", volume);
     obj->setProperty("pan", pan);
     obj->setProperty("muted", muted);
+    obj->setProperty("outputBusIndex", outputBusIndex);
     obj->setProperty("pluginChain", pluginChain.getState());
     return juce::var(obj.get());
 }
@@ -377,6 +485,7 @@ std::unique_ptr<MixerBus> MixerBus::fromVar(const juce::var& v) {
         bus->volume = obj->getProperty("volume");
         bus->pan = obj->getProperty("pan");
         bus->muted = obj->getProperty("muted");
+        bus->outputBusIndex = obj->getProperty("outputBusIndex");
         bus->pluginChain.setState(obj->getProperty("pluginChain"));
     }
     
@@ -389,21 +498,69 @@ std::unique_ptr<MixerBus> MixerBus::fromVar(const juce::var& v) {
 
 MixerEngine::MixerEngine() {
     masterBus = std::make_unique<MixerBus>("Master", MixerBus::Type::Master);
+    rebuildTopology();
 }
 
-MixerEngine::~MixerEngine() = default;
+MixerEngine::~MixerEngine() {
+    liveGraph.store(nullptr);
+}
 
 void MixerEngine::addChannel(std::unique_ptr<ChannelStrip> channel) {
+    if (prepared)
+        channel->prepareToPlay(sampleRate, blockSize);
+    
+    registerAnalysisTap(*channel);
     channels.push_back(std::move(channel));
+    rebuildTopology();
 }
 
 void MixerEngine::removeChannel(int index) {
-    if (index >= 0 && index < getNumChannels())
-        channels.erase(channels.begin() + index);
+    if (index < 0 || index >= getNumChannels())
+        return;
+    
+    // Se libera al salir, cuando el hilo de audio ya usa el grafo sin él
+    auto removed = std::move(channels[(size_t) index]);
+    channels.erase(channels.begin() + index);
+    releaseAnalysisTap(*removed);
+    rebuildTopology();
 }
 
 void MixerEngine::clearChannels() {
-    channels.clear();
+    std::vector<std::unique_ptr<ChannelStrip>> removed;
+    removed.swap(channels);
+    for (auto& channel : removed)
+        releaseAnalysisTap(*channel);
+    rebuildTopology();
+}
+
+void MixerEngine::setAnalysisTapService(AnalysisTapService* service) {
+    if (service == analysisTaps)
+        return;
+    
+    for (auto& channel : channels)
+        releaseAnalysisTap(*channel);
+    if (analysisTaps != nullptr)
+        analysisTaps->removeTap(masterTap.exchange(nullptr));
+    
+    analysisTaps = service;
+    if (analysisTaps == nullptr)
+        return;
+    
+    masterTap.store(analysisTaps->createTap("Master"));
+    for (auto& channel : channels)
+        registerAnalysisTap(*channel);
+}
+
+void MixerEngine::registerAnalysisTap(ChannelStrip& channel) {
+    if (analysisTaps != nullptr)
+        channel.setAnalysisTap(analysisTaps->createTap(channel.getName()));
+}
+
+void MixerEngine::releaseAnalysisTap(ChannelStrip& channel) {
+    // El servicio mantiene vivo el tap: el hilo de audio puede estar empujando todavía
+    if (analysisTaps != nullptr)
+        analysisTaps->removeTap(channel.getAnalysisTap());
+    channel.setAnalysisTap(nullptr);
 }
 
 ChannelStrip* MixerEngine::getChannel(int index) {
@@ -415,12 +572,40 @@ const ChannelStrip* MixerEngine::getChannel(int index) const {
 }
 
 void MixerEngine::addBus(std::unique_ptr<MixerBus> bus) {
+    if (prepared)
+        bus->prepareToPlay(sampleRate, blockSize);
+    
     buses.push_back(std::move(bus));
+    rebuildTopology();
 }
 
 void MixerEngine::removeBus(int index) {
-    if (index >= 0 && index < getNumBuses())
-        buses.erase(buses.begin() + index);
+    if (index < 0 || index >= getNumBuses())
+        return;
+    
+    // Índices de ruteo posteriores al bus eliminado se desplazan; los que apuntaban a él van a master
+    const int removedIndex = index + 1;
+    auto remap = [removedIndex](int busIndex) {
+        if (busIndex == removedIndex) return 0;
+        return busIndex > removedIndex ? busIndex - 1 : busIndex;
+    };
+    
+    // Solo cambia el modelo: el audio sigue con el grafo compilado (que aún
+    // referencia el bus, vivo hasta salir) hasta que se publica el nuevo
+    auto removed = std::move(buses[(size_t) index]);
+    buses.erase(buses.begin() + index);
+    
+    for (auto& channel : channels) {
+        channel->setOutputBus(remap(channel->getOutputBus()));
+        for (int k = 0; k < channel->getNumSends(); ++k) {
+            auto& send = channel->getSend(k);
+            send.busIndex = send.busIndex == removedIndex ? -1 : remap(send.busIndex);
+        }
+    }
+    for (auto& bus : buses)
+        bus->setOutputBus(remap(bus->getOutputBus()));
+    
+    rebuildTopology();
 }
 
 MixerBus* MixerEngine::getBus(int index) {
@@ -431,6 +616,152 @@ const MixerBus* MixerEngine::getBus(int index) const {
     return (index >= 0 && index < getNumBuses()) ? buses[index].get() : nullptr;
 }
 
+void MixerEngine::setBusOutput(int index, int outputBusIndex) {
+    if (auto* bus = getBus(index)) {
+        bus->setOutputBus(outputBusIndex);
+        rebuildTopology();
+    }
+}
+
+void MixerEngine::setChannelOutput(int channelIndex, int outputBusIndex) {
+    if (auto* channel = getChannel(channelIndex)) {
+        channel->setOutputBus(outputBusIndex);
+        rebuildTopology();
+    }
+}
+
+void MixerEngine::addChannelSend(int channelIndex, const BusSend& send) {
+    if (auto* channel = getChannel(channelIndex)) {
+        channel->addSend(send);
+        rebuildTopology();
+    }
+}
+
+void MixerEngine::removeChannelSend(int channelIndex, int sendIndex) {
+    if (auto* channel = getChannel(channelIndex)) {
+        channel->removeSend(sendIndex);
+        rebuildTopology();
+    }
+}
+
+void MixerEngine::setChannelSendLevel(int channelIndex, int sendIndex, float level) {
+    if (auto* channel = getChannel(channelIndex)) {
+        channel->setSendLevel(sendIndex, level);
+        rebuildTopology();
+    }
+}
+
+int MixerEngine::compileBusIndex(int busIndex) const {
+    if (busIndex == 0)
+        return -1;
+    return (busIndex >= 1 && busIndex <= getNumBuses()) ? busIndex - 1 : -2;
+}
+
+void MixerEngine::rebuildTopology() {
+    auto compiled = std::make_unique<Graph>();
+    for (auto& channel : channels)
+        compiled->channels.push_back(channel.get());
+    for (auto& bus : buses)
+        compiled->buses.push_back(bus.get());
+    compiled->master = masterBus.get();
+    compiled->workerPool = workerPool.get();
+    
+    // Ruteo de los canales: el audio no vuelve a leer salida ni sends del strip
+    compiled->channelRoutes.resize(channels.size());
+    for (size_t c = 0; c < channels.size(); ++c) {
+        const auto& channel = *channels[c];
+        auto& route = compiled->channelRoutes[c];
+        
+        // Una salida que no existe va a master
+        route.output = juce::jmax(-1, compileBusIndex(channel.getOutputBus()));
+        
+        route.numSends = juce::jmin(channel.getNumSends(), StripKernel::kMaxTaps);
+        for (int k = 0; k < route.numSends; ++k) {
+            const auto& send = channel.getSend(k);
+            route.sendBuses[(size_t) k] = compileBusIndex(send.busIndex);
+            
+            auto& tap = route.sends[(size_t) k];
+            tap.level = send.muted ? 0.0f : send.level;
+            tap.preFader = send.preFader;
+            tap.rampId = channel.getSendRampId(k);
+        }
+    }
+    
+    // Cada bus tiene una única salida: el grafo es un bosque salvo ciclos
+    const int numBuses = getNumBuses();
+    bool cycle = false;
+    compiled->busOutputs.resize((size_t) numBuses, -1);
+    
+    for (int b = 0; b < numBuses; ++b) {
+        const int output = buses[(size_t) b]->getOutputBus();
+        compiled->busOutputs[(size_t) b] = (output >= 1 && output <= numBuses) ? output - 1 : -1;
+    }
+    
+    // Romper ciclos: el bus que se alcanza a sí mismo sale a master
+    for (int b = 0; b < numBuses; ++b) {
+        int current = compiled->busOutputs[(size_t) b];
+        for (int steps = 0; current >= 0 && current != b && steps < numBuses; ++steps)
+            current = compiled->busOutputs[(size_t) current];
+        
+        if (current == b) {
+            compiled->busOutputs[(size_t) b] = -1;
+            cycle = true;
+        }
+    }
+    
+    // Kahn por niveles: cada nivel solo depende de los anteriores
+    std::vector<int> pendingInputs((size_t) numBuses, 0);
+    for (int b = 0; b < numBuses; ++b) {
+        if (compiled->busOutputs[(size_t) b] >= 0)
+            ++pendingInputs[(size_t) compiled->busOutputs[(size_t) b]];
+    }
+    
+    for (int b = 0; b < numBuses; ++b) {
+        if (pendingInputs[(size_t) b] == 0)
+            compiled->busOrder.push_back(b);
+    }
+    
+    size_t levelStart = 0;
+    while (levelStart < compiled->busOrder.size()) {
+        const size_t levelEnd = compiled->busOrder.size();
+        compiled->levelStarts.push_back((int) levelStart);
+        
+        for (size_t i = levelStart; i < levelEnd; ++i) {
+            const int output = compiled->busOutputs[(size_t) compiled->busOrder[i]];
+            if (output >= 0 && --pendingInputs[(size_t) output] == 0)
+                compiled->busOrder.push_back(output);
+        }
+        levelStart = levelEnd;
+    }
+    compiled->levelStarts.push_back((int) compiled->busOrder.size());
+    
+    compiled->busBuffers.resize((size_t) numBuses);
+    compiled->busMidi.resize((size_t) numBuses);
+    for (auto& buffer : compiled->busBuffers)
+        buffer.setSize(2, blockSize, false, true, true);
+    
+    cycleDetected = cycle;
+    publishGraph(std::move(compiled));
+}
+
+void MixerEngine::publishGraph(std::unique_ptr<Graph> compiled) {
+    liveGraph.store(compiled.get());
+    std::swap(graph, compiled);
+    
+    // Un bloque que empezó con el grafo anterior termina con él; los siguientes
+    // ya toman el nuevo (ver process)
+    while (compiled != nullptr && activeGraph.load() == compiled.get())
+        juce::Thread::yield();
+    
+    // compiled (el anterior) se libera aquí, en el message thread
+}
+
+void MixerEngine::setNumWorkerThreads(int numThreads) {
+    auto pool = numThreads > 0 ? std::make_unique<MixerWorkerPool>(numThreads) : nullptr;
+    std::swap(workerPool, pool);
+    rebuildTopology();
+}
+
 bool MixerEngine::isAnySolo() const {
     for (const auto& channel : channels) {
         if (channel->isSoloed())
@@ -449,11 +780,38 @@ void MixerEngine::process(std::vector<juce::AudioBuffer<float>*>& channelBuffers
                           juce::AudioBuffer<float>& masterOutput) {
     masterOutput.clear();
     
-    bool anySolo = isAnySolo();
+    // Anunciar el grafo antes de usarlo y confirmar que sigue publicado: si el
+    // message thread publicó entre medias, no esperó por este y hay que tomar
+    // el nuevo (seq_cst en ambos lados)
+    Graph* current = liveGraph.load();
+    for (;;) {
+        activeGraph.store(current);
+        Graph* latest = liveGraph.load();
+        if (latest == current)
+            break;
+        current = latest;
+    }
+    
+    if (current == nullptr) {
+        activeGraph.store(nullptr);
+        return;
+    }
+    
+    auto& g = *current;
+    const int numSamples = masterOutput.getNumSamples();
+    const int numBuses = static_cast<int>(g.buses.size());
+    for (int b = 0; b < numBuses; ++b) {
+        g.busBuffers[(size_t) b].setSize(2, numSamples, false, false, true);
+        g.busBuffers[(size_t) b].clear();
+    }
+    
+    bool anySolo = false;
+    for (auto* channel : g.channels)
+        anySolo = anySolo || channel->isSoloed();
     
     // Process each channel
-    for (size_t i = 0; i < channels.size() && i < channelBuffers.size(); ++i) {
-        auto& channel = channels[i];
+    for (size_t i = 0; i < g.channels.size() && i < channelBuffers.size(); ++i) {
+        auto* channel = g.channels[i];
         auto* buffer = channelBuffers[i];
         auto* midiBuffer = (i < midiBuffers.size()) ? midiBuffers[i] : nullptr;
         
@@ -463,19 +821,75 @@ void MixerEngine::process(std::vector<juce::AudioBuffer<float>*>& channelBuffers
         if (anySolo && !channel->isSoloed())
             continue;
         
-        // Process channel
-        juce::MidiBuffer emptyMidi;
-        channel->process(*buffer, midiBuffer ? *midiBuffer : emptyMidi);
+        const auto& route = g.channelRoutes[i];
+        auto* output = resolveBusBuffer(g, route.output, masterOutput);
+        
+        for (int k = 0; k < route.numSends; ++k) {
+            sendTaps[(size_t) k] = route.sends[(size_t) k];
+            sendTaps[(size_t) k].destination = resolveBusBuffer(g, route.sendBuses[(size_t) k], masterOutput);
+        }
+        
+        // Process channel, sends and sum into its bus in the same pass
+        if (!midiBuffer)
+            emptyMidi.clear();
+        channel->process(*buffer, midiBuffer ? *midiBuffer : emptyMidi, output, sendTaps.data(), route.numSends);
+    }
+    
+    // Buses por niveles de dependencia: los de un mismo nivel son independientes
+    for (size_t level = 0; level + 1 < g.levelStarts.size(); ++level) {
+        const int first = g.levelStarts[level];
+        const int count = g.levelStarts[level + 1] - first;
+        
+        g.currentLevelStart = first;
+        if (g.workerPool != nullptr && count > 1)
+            g.workerPool->run(count, &MixerEngine::processBusJob, &g);
+        else
+            for (int j = 0; j < count; ++j)
+                processBus(g, g.busOrder[(size_t) (first + j)]);
         
-        // Add to master
-        for (int ch = 0; ch < juce::jmin(buffer->getNumChannels(), masterOutput.getNumChannels()); ++ch) {
-            masterOutput.addFrom(ch, 0, *buffer, ch, 0, buffer->getNumSamples());
+        // La suma al destino es serie: varios buses pueden compartir destino
+        for (int j = 0; j < count; ++j) {
+            const int b = g.busOrder[(size_t) (first + j)];
+            const int output = g.busOutputs[(size_t) b];
+            auto& dest = output >= 0 ? g.busBuffers[(size_t) output] : masterOutput;
+            const auto& source = g.busBuffers[(size_t) b];
+            for (int ch = 0; ch < juce::jmin(dest.getNumChannels(), source.getNumChannels()); ++ch)
+                dest.addFrom(ch, 0, source, ch, 0, numSamples);
         }
     }
     
     // Process master bus
-    juce::MidiBuffer emptyMidi;
-    masterBus->process(masterOutput, emptyMidi);
+    emptyMidi.clear();
+    g.master->process(masterOutput, emptyMidi);
+    
+    if (auto* tap = masterTap.load())
+        tap->push(masterOutput);
+    
+    activeGraph.store(nullptr);
+}
+
+juce::AudioBuffer<float>* MixerEngine::resolveBusBuffer(Graph& graph, int graphBus, juce::AudioBuffer<float>& masterOutput) {
+    if (graphBus == -1)
+        return &masterOutput;
+    
+    if (graphBus >= 0 && graphBus < static_cast<int>(graph.busBuffers.size()))
+        return &graph.busBuffers[(size_t) graphBus];
+    
+    return nullptr;
+}
+
+void MixerEngine::processBus(Graph& graph, int index) {
+    if (index < 0 || index >= static_cast<int>(graph.buses.size()))
+        return;
+    
+    auto& midi = graph.busMidi[(size_t) index];
+    midi.clear();
+    graph.buses[(size_t) index]->process(graph.busBuffers[(size_t) index], midi);
+}
+
+void MixerEngine::processBusJob(void* context, int jobIndex) {
+    auto& graph = *static_cast<Graph*>(context);
+    processBus(graph, graph.busOrder[(size_t) (graph.currentLevelStart + jobIndex)]);
 }
 
 void MixerEngine::prepareToPlay(double newSampleRate, int maximumExpectedSamplesPerBlock) {
@@ -490,13 +904,18 @@ void MixerEngine::prepareToPlay(double newSampleRate, int maximumExpectedSamples
     
     masterBus->prepareToPlay(sampleRate, blockSize);
     
-    // Prepare bus buffers
-    busBuffers.resize(buses.size() + 1); // +1 for master
-    for (auto& buffer : busBuffers)
-        buffer.setSize(2, blockSize);
+    // Buffers de los buses al nuevo tamaño de bloque
+    if (workerPool == nullptr)
+        setNumWorkerThreads(juce::jlimit(0, 3, juce::SystemStats::getNumCpus() - 2));
+    else
+        rebuildTopology();
+    
+    prepared = true;
 }
 
 void MixerEngine::releaseResources() {
+    prepared = false;
+    
     for (auto& channel : channels)
         channel->releaseResources();
     
@@ -525,15 +944,23 @@ juce::var MixerEngine::toVar() const {
 }
 
 void MixerEngine::loadFromVar(const juce::var& v) {
-    channels.clear();
-    buses.clear();
+    // Lo anterior se libera al salir, cuando el grafo nuevo ya está en uso
+    std::vector<std::unique_ptr<ChannelStrip>> oldChannels;
+    std::vector<std::unique_ptr<MixerBus>> oldBuses;
+    oldChannels.swap(channels);
+    oldBuses.swap(buses);
+    std::unique_ptr<MixerBus> oldMaster;
+    for (auto& channel : oldChannels)
+        releaseAnalysisTap(*channel);
     
     if (auto* obj = v.getDynamicObject()) {
         if (auto* channelsArray = obj->getProperty("channels").getArray()) {
             for (const auto& channelVar : *channelsArray) {
                 auto channel = ChannelStrip::fromVar(channelVar);
-                if (channel)
+                if (channel) {
+                    registerAnalysisTap(*channel);
                     channels.push_back(std::move(channel));
+                }
             }
         }
         
@@ -545,16 +972,10 @@ void MixerEngine::loadFromVar(const juce::var& v) {
             }
         }
         
-        masterBus = MixerBus::fromVar(obj->getProperty("masterBus"));
+        oldMaster = std::exchange(masterBus, MixerBus::fromVar(obj->getProperty("masterBus")));
     }
-}
-
-void MixerEngine::processSends(ChannelStrip& channel, const juce::AudioBuffer<float>& buffer) {
-    // TODO: Implement send processing to buses
-}
-
-void MixerEngine::routeToBuses() {
-    // TODO: Implement bus routing
+    
+    rebuildTopology();
 }
 
 } // namespace OmegaStudio
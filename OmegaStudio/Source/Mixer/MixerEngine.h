@@ -20,6 +20,12 @@
 
 #include <JuceHeader.h>
 #include "../Audio/Plugins/PluginManager.h"
+#include "StripKernel.h"
+#include "MixerWorkerPool.h"
+#include "../Audio/Analysis/AnalysisTapService.h"
+#include "../Utils/Atomic.h"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <map>
@@ -37,7 +43,10 @@ enum class RoutingMode {
 };
 
 //==============================================================================
-/** Send to bus */
+/**
+ * Send to bus
+ * Índices de bus (sends y salidas): 0 = master, n = MixerEngine::getBus(n - 1)
+ */
 struct BusSend {
     int busIndex { -1 };
     float level { 0.0f };        // 0.0 - 1.0
@@ -54,9 +63,13 @@ class LevelMeter {
 public:
     LevelMeter();
     
+    void prepare(double newSampleRate) { sampleRate = newSampleRate; }
     void reset();
     void process(const juce::AudioBuffer<float>& buffer);
     
+    // Publica niveles ya acumulados por el kernel del strip (sin releer el buffer)
+    void pushLevels(const StripKernel::Levels& levels, int numChannels, int numSamples);
+    
     // Peak levels (-inf to 0 dB)
     float getPeakLevel(int channel) const;
     float getPeakLevelDb(int channel) const;
@@ -77,6 +90,7 @@ private:
     
     double holdTime { 2.0 };
     double currentTime { 0.0 };
+    double sampleRate { 48000.0 };
     
     static constexpr float MIN_DB = -60.0f;
     
@@ -126,6 +140,9 @@ public:
     void setRoutingMode(RoutingMode mode) { routingMode = mode; }
     RoutingMode getRoutingMode() const { return routingMode; }
     
+    // Salida y sends son modelo: el audio solo ve lo que compila MixerEngine::rebuildTopology.
+    // Con el strip ya en un mixer, usar MixerEngine::setChannelOutput / addChannelSend /
+    // removeChannelSend / setChannelSendLevel, que recompilan y publican
     void setOutputBus(int busIndex) { outputBusIndex = busIndex; }
     int getOutputBus() const { return outputBusIndex; }
     
@@ -137,6 +154,17 @@ public:
     const BusSend& getSend(int index) const { return sends[index]; }
     BusSend& getSend(int index) { return sends[index]; }
     
+    // Identidad estable de un send (no cambia al borrar otros): clave de su rampa de gain
+    juce::uint32 getSendRampId(int index) const { return sendRampIds[(size_t) index]; }
+    
+    // Send ya compilado, tal como lo recibe process()
+    struct SendTap {
+        juce::AudioBuffer<float>* destination { nullptr };  // Nulo = send inactivo
+        float level { 0.0f };                               // Ya a 0 si el send está muteado
+        bool preFader { false };
+        juce::uint32 rampId { 0 };
+    };
+    
     // Plugin Chain
     PluginChain& getPluginChain() { return pluginChain; }
     const PluginChain& getPluginChain() const { return pluginChain; }
@@ -145,8 +173,17 @@ public:
     const LevelMeter& getInputMeter() const { return inputMeter; }
     const LevelMeter& getOutputMeter() const { return outputMeter; }
     
+    // Tap de análisis post-fader (espectro, goniómetro...): el audio solo copia
+    void setAnalysisTap(AnalysisTap* tap) { analysisTap.store(tap); }
+    AnalysisTap* getAnalysisTap() const { return analysisTap.load(); }
+    
     // Processing (RT-safe)
-    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
+    // Si destination no es nulo, la salida del strip se suma ahí en la misma pasada.
+    // Los sends llegan compilados (no se leen los del modelo) y se suman como taps
+    // del kernel, sin copias intermedias; cada rampa sigue a su rampId
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
+                 juce::AudioBuffer<float>* destination = nullptr,
+                 const SendTap* sendTaps = nullptr, int numSendTaps = 0);
     
     // Prepare
     void prepareToPlay(double sampleRate, int maximumExpectedSamplesPerBlock);
@@ -173,16 +210,28 @@ private:
     int outputBusIndex { 0 }; // Master bus by default
     
     std::vector<BusSend> sends;
+    std::vector<juce::uint32> sendRampIds;   // En paralelo a sends
+    juce::uint32 nextSendRampId { 1 };
     PluginChain pluginChain;
     
     LevelMeter inputMeter;
     LevelMeter outputMeter;
+    std::atomic<AnalysisTap*> analysisTap { nullptr };
     
     double sampleRate { 48000.0 };
     int blockSize { 512 };
     
-    void applyGainAndPan(juce::AudioBuffer<float>& buffer);
-    void applyRouting(juce::AudioBuffer<float>& buffer);
+    // Estado de las rampas de gain (valores aplicados al final del bloque anterior)
+    StripKernel::Matrix lastMatrix;
+    float lastTrim { 1.0f };
+    float lastExtraGain { 1.0f };   // Canales 3+: fuera de la matriz, solo trim/polaridad y mute
+    std::array<juce::uint32, StripKernel::kMaxTaps> lastSendRampIds {};
+    std::array<float, StripKernel::kMaxTaps> lastSendGains {};
+    int lastNumSends { 0 };
+    bool rampsPrimed { false };
+    
+    float getTrimGain() const;
+    StripKernel::Matrix computeOutputMatrix(int numChannels, float trim) const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelStrip)
 };
@@ -217,6 +266,10 @@ public:
     void setMuted(bool shouldBeMuted) { muted = shouldBeMuted; }
     bool isMuted() const { return muted; }
     
+    // Routing (usar MixerEngine::setBusOutput para recompilar la topología)
+    void setOutputBus(int busIndex) { outputBusIndex = busIndex; }
+    int getOutputBus() const { return outputBusIndex; }
+    
     // Plugin Chain
     PluginChain& getPluginChain() { return pluginChain; }
     const PluginChain& getPluginChain() const { return pluginChain; }
@@ -242,6 +295,7 @@ private:
     float volume { 0.8f };
     float pan { 0.0f };
     bool muted { false };
+    int outputBusIndex { 0 }; // Master bus by default
     
     PluginChain pluginChain;
     LevelMeter meter;
@@ -276,6 +330,34 @@ public:
     MixerBus* getMasterBus() { return masterBus.get(); }
     const MixerBus* getMasterBus() const { return masterBus.get(); }
     
+    // Tap de análisis de la salida master (analizadores a pantalla completa)
+    void setMasterAnalysisTap(AnalysisTap* tap) { masterTap.store(tap); }
+    AnalysisTap* getMasterAnalysisTap() const { return masterTap.load(); }
+    
+    // Registra en el servicio un tap para master y uno por canal; los canales que
+    // lleguen después reciben el suyo y los que se quitan lo devuelven. El servicio
+    // no es del mixer y debe vivir más que él (el audio puede seguir empujando)
+    void setAnalysisTapService(AnalysisTapService* service);
+    
+    // Routing entre buses: 0 = master, n = getBus(n - 1). Recompila la topología.
+    void setBusOutput(int index, int outputBusIndex);
+    
+    // Salida y sends de un canal (mismos índices de bus). Recompilan la topología.
+    void setChannelOutput(int channelIndex, int outputBusIndex);
+    void addChannelSend(int channelIndex, const BusSend& send);
+    void removeChannelSend(int channelIndex, int sendIndex);
+    void setChannelSendLevel(int channelIndex, int sendIndex, float level);
+    
+    // Recompila la topología (orden de dependencias entre buses). Message thread.
+    void rebuildTopology();
+    
+    // true si la última compilación encontró un ciclo (esos buses salen a master)
+    bool hasRoutingCycle() const { return cycleDetected; }
+    
+    // Hilos que procesan en paralelo los buses independientes (0 = todo en el hilo de audio)
+    void setNumWorkerThreads(int numThreads);
+    int getNumWorkerThreads() const { return workerPool ? workerPool->getNumThreads() : 0; }
+    
     // Solo management
     bool isAnySolo() const;
     void clearAllSolos();
@@ -304,12 +386,58 @@ private:
     
     double sampleRate { 48000.0 };
     int blockSize { 512 };
+    bool prepared { false };
+    
+    // Salida y sends de un canal, resueltos a índices del grafo (-1 = master)
+    struct ChannelRoute {
+        int output { -1 };
+        int numSends { 0 };
+        std::array<int, StripKernel::kMaxTaps> sendBuses {};     // -2 = send sin bus
+        std::array<ChannelStrip::SendTap, StripKernel::kMaxTaps> sends {};
+    };
+    
+    // Lo que ve el hilo de audio, compilado en el message thread: punteros a
+    // canales y buses, ruteo de cada canal, orden de dependencias y buffers de
+    // los buses. No cambia una vez publicado (salvo los buffers, scratch del bloque en curso)
+    struct Graph {
+        std::vector<ChannelStrip*> channels;
+        std::vector<ChannelRoute> channelRoutes;
+        std::vector<MixerBus*> buses;
+        MixerBus* master { nullptr };
+        MixerWorkerPool* workerPool { nullptr };
+        
+        std::vector<int> busOrder;      // Índices en `buses`, en orden de dependencias
+        std::vector<int> levelStarts;   // busOrder[levelStarts[l] .. levelStarts[l + 1]) son independientes
+        std::vector<int> busOutputs;    // Destino efectivo de cada bus (-1 = master)
+        
+        std::vector<juce::AudioBuffer<float>> busBuffers;   // Uno por bus; master usa la salida
+        std::vector<juce::MidiBuffer> busMidi;
+        int currentLevelStart { 0 };
+    };
+    
+    // Publica `compiled` y espera a que el hilo de audio suelte el anterior
+    // (como mucho un bloque). Después se puede liberar lo que solo usaba aquel
+    void publishGraph(std::unique_ptr<Graph> compiled);
+    
+    std::unique_ptr<Graph> graph;                   // El publicado; message thread
+    std::atomic<Graph*> liveGraph { nullptr };      // El que toma el próximo bloque
+    std::atomic<Graph*> activeGraph { nullptr };    // El que usa el bloque en curso
+    bool cycleDetected { false };
+    
+    juce::MidiBuffer emptyMidi;
+    std::array<ChannelStrip::SendTap, StripKernel::kMaxTaps> sendTaps {};
+    
+    std::unique_ptr<MixerWorkerPool> workerPool;
+    std::atomic<AnalysisTap*> masterTap { nullptr };
+    AnalysisTapService* analysisTaps { nullptr };
     
-    // Buffers for routing
-    std::vector<juce::AudioBuffer<float>> busBuffers;
+    void registerAnalysisTap(ChannelStrip& channel);
+    void releaseAnalysisTap(ChannelStrip& channel);
     
-    void processSends(ChannelStrip& channel, const juce::AudioBuffer<float>& buffer);
-    void routeToBuses();
+    int compileBusIndex(int busIndex) const;
+    static juce::AudioBuffer<float>* resolveBusBuffer(Graph& graph, int graphBus, juce::AudioBuffer<float>& masterOutput);
+    static void processBus(Graph& graph, int index);
+    static void processBusJob(void* context, int jobIndex);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerEngine)
 };
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+    MixerWorkerPool.cpp
+  ==============================================================================
+*/
+
+#include "MixerWorkerPool.h"
+
+namespace OmegaStudio {
+
+//==============================================================================
+MixerWorkerPool::Worker::Worker(MixerWorkerPool& owner, int index)
+    : juce::Thread("Mixer Worker " + juce::String(index + 1)), pool(owner) {}
+
+void MixerWorkerPool::Worker::run() {
+    while (!threadShouldExit()) {
+        // notify() despierta al hilo; el timeout solo cubre la salida
+        wait(10);
+        pool.helpWithJobs();
+    }
+}
+
+//==============================================================================
+MixerWorkerPool::MixerWorkerPool(int numThreads) {
+    for (int i = 0; i < numThreads; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+MixerWorkerPool::~MixerWorkerPool() {
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+    for (auto& worker : workers)
+        worker->stopThread(1000);
+}
+
+void MixerWorkerPool::run(int numJobs, Job job, void* context) {
+    if (numJobs <= 0 || job == nullptr)
+        return;
+
+    if (workers.empty() || numJobs == 1) {
+        for (int i = 0; i < numJobs; ++i)
+            job(context, i);
+        return;
+    }
+
+    currentJob.store(job);
+    currentContext.store(context);
+    numJobsInBatch.store(numJobs);
+    nextJob.store(0);
+    pendingJobs.store(numJobs);
+    active.store(true);
+
+    const int toWake = juce::jmin(numJobs - 1, getNumThreads());
+    for (int i = 0; i < toWake; ++i)
+        workers[(size_t) i]->notify();
+
+    // El hilo llamante reparte trabajo con los workers
+    for (int i = nextJob.fetch_add(1); i < numJobs; i = nextJob.fetch_add(1)) {
+        job(context, i);
+        pendingJobs.fetch_sub(1);
+    }
+
+    while (pendingJobs.load() > 0)
+        juce::Thread::yield();
+
+    // Ningún worker puede seguir leyendo este lote cuando volvemos
+    active.store(false);
+    while (busyWorkers.load() > 0)
+        juce::Thread::yield();
+}
+
+void MixerWorkerPool::helpWithJobs() {
+    busyWorkers.fetch_add(1);
+
+    if (active.load()) {
+        const Job job = currentJob.load();
+        void* context = currentContext.load();
+        const int numJobs = numJobsInBatch.load();
+
+        for (int i = nextJob.fetch_add(1); i < numJobs; i = nextJob.fetch_add(1)) {
+            job(context, i);
+            pendingJobs.fetch_sub(1);
+        }
+    }
+
+    busyWorkers.fetch_sub(1);
+}
+
+} // namespace OmegaStudio
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+    MixerWorkerPool.h
+
+    Hilos de trabajo del mixer:
+    - Ejecuta N trabajos independientes (buses de un mismo nivel) en paralelo
+    - El hilo de audio también trabaja y espera al último trabajo en curso
+    - Sin locks ni allocations en run(); los trabajos se reparten con un atómico
+
+    Pensado para lotes cortos dentro del callback de audio (reverb, delay).
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace OmegaStudio {
+
+//==============================================================================
+class MixerWorkerPool {
+public:
+    using Job = void (*)(void* context, int jobIndex);
+
+    explicit MixerWorkerPool(int numThreads);
+    ~MixerWorkerPool();
+
+    int getNumThreads() const { return static_cast<int>(workers.size()); }
+
+    /**
+     * Ejecuta job(context, i) para i en [0, numJobs) y vuelve cuando todos han
+     * terminado. Llamar siempre desde el mismo hilo (el de audio).
+     */
+    void run(int numJobs, Job job, void* context);
+
+private:
+    class Worker : public juce::Thread {
+    public:
+        Worker(MixerWorkerPool& owner, int index);
+        void run() override;
+
+    private:
+        MixerWorkerPool& pool;
+    };
+
+    void helpWithJobs();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Lote actual (publicado antes de `active`)
+    std::atomic<Job> currentJob { nullptr };
+    std::atomic<void*> currentContext { nullptr };
+    std::atomic<int> numJobsInBatch { 0 };
+    std::atomic<int> nextJob { 0 };
+    std::atomic<int> pendingJobs { 0 };
+    std::atomic<int> busyWorkers { 0 };
+    std::atomic<bool> active { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerWorkerPool)
+};
+
+} // namespace OmegaStudio
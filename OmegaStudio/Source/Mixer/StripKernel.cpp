@@ -0,0 +1,355 @@
+/*
+  ==============================================================================
+    StripKernel.cpp
+    Kernel fusionado del channel strip (AVX2 / NEON / escalar)
+  ==============================================================================
+*/
+
+#include "StripKernel.h"
+#include "../Audio/DSP/SIMDProcessor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OmegaStudio {
+namespace StripKernel {
+
+namespace {
+
+//==============================================================================
+// Envoltorio mínimo de registro SIMD: el kernel se escribe una vez sobre Vec
+//==============================================================================
+#if defined(OMEGA_X86_SIMD) && defined(__AVX2__)
+struct Vec {
+    static constexpr int size = 8;
+    __m256 v;
+
+    static Vec load(const float* p) { return { _mm256_loadu_ps(p) }; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+    static Vec set1(float x) { return { _mm256_set1_ps(x) }; }
+    static Vec zero() { return { _mm256_setzero_ps() }; }
+    static Vec iota() { return { _mm256_setr_ps(1, 2, 3, 4, 5, 6, 7, 8) }; }
+
+    friend Vec operator+ (Vec a, Vec b) { return { _mm256_add_ps(a.v, b.v) }; }
+    friend Vec operator* (Vec a, Vec b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    static Vec fma(Vec a, Vec b, Vec c) { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+    static Vec max(Vec a, Vec b) { return { _mm256_max_ps(a.v, b.v) }; }
+    static Vec abs(Vec a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+
+    float hmax() const {
+        alignas(32) float t[8];
+        _mm256_store_ps(t, v);
+        return *std::max_element(t, t + 8);
+    }
+    float hsum() const {
+        alignas(32) float t[8];
+        _mm256_store_ps(t, v);
+        return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+    }
+};
+#elif defined(OMEGA_ARM_NEON)
+struct Vec {
+    static constexpr int size = 4;
+    float32x4_t v;
+
+    static Vec load(const float* p) { return { vld1q_f32(p) }; }
+    void store(float* p) const { vst1q_f32(p, v); }
+    static Vec set1(float x) { return { vdupq_n_f32(x) }; }
+    static Vec zero() { return { vdupq_n_f32(0.0f) }; }
+    static Vec iota() { const float t[4] { 1, 2, 3, 4 }; return { vld1q_f32(t) }; }
+
+    friend Vec operator+ (Vec a, Vec b) { return { vaddq_f32(a.v, b.v) }; }
+    friend Vec operator* (Vec a, Vec b) { return { vmulq_f32(a.v, b.v) }; }
+    static Vec fma(Vec a, Vec b, Vec c) { return { vmlaq_f32(c.v, a.v, b.v) }; }
+    static Vec max(Vec a, Vec b) { return { vmaxq_f32(a.v, b.v) }; }
+    static Vec abs(Vec a) { return { vabsq_f32(a.v) }; }
+
+    float hmax() const {
+        float t[4];
+        vst1q_f32(t, v);
+        return std::max(std::max(t[0], t[1]), std::max(t[2], t[3]));
+    }
+    float hsum() const {
+        float t[4];
+        vst1q_f32(t, v);
+        return (t[0] + t[1]) + (t[2] + t[3]);
+    }
+};
+#else
+struct Vec {
+    static constexpr int size = 1;
+    float v;
+
+    static Vec load(const float* p) { return { *p }; }
+    void store(float* p) const { *p = v; }
+    static Vec set1(float x) { return { x }; }
+    static Vec zero() { return { 0.0f }; }
+    static Vec iota() { return { 1.0f }; }
+
+    friend Vec operator+ (Vec a, Vec b) { return { a.v + b.v }; }
+    friend Vec operator* (Vec a, Vec b) { return { a.v * b.v }; }
+    static Vec fma(Vec a, Vec b, Vec c) { return { a.v * b.v + c.v }; }
+    static Vec max(Vec a, Vec b) { return { std::max(a.v, b.v) }; }
+    static Vec abs(Vec a) { return { std::abs(a.v) }; }
+
+    float hmax() const { return v; }
+    float hsum() const { return v; }
+};
+#endif
+
+//==============================================================================
+template <bool MeasureInput, bool Accumulate>
+void stereoKernel(float* left, float* right, int numSamples,
+                  const Matrix& from, const Matrix& to,
+                  float* destL, float* destR,
+                  Levels* inputLevels, Levels& outputLevels,
+                  const Tap* taps, int numTaps)
+{
+    // La rampa llega exactamente a `to` en el último sample del bloque
+    const float inv = 1.0f / (float) numSamples;
+
+    float tapDelta[kMaxTaps];
+    for (int k = 0; k < numTaps; ++k)
+        tapDelta[k] = (taps[k].toGain - taps[k].fromGain) * inv;
+    const float d00 = (to.a00 - from.a00) * inv, d01 = (to.a01 - from.a01) * inv;
+    const float d10 = (to.a10 - from.a10) * inv, d11 = (to.a11 - from.a11) * inv;
+
+    const Vec vf00 = Vec::set1(from.a00), vf01 = Vec::set1(from.a01);
+    const Vec vf10 = Vec::set1(from.a10), vf11 = Vec::set1(from.a11);
+    const Vec vd00 = Vec::set1(d00), vd01 = Vec::set1(d01);
+    const Vec vd10 = Vec::set1(d10), vd11 = Vec::set1(d11);
+    const Vec iota = Vec::iota();
+
+    Vec inPeakL = Vec::zero(), inPeakR = Vec::zero(), inSqL = Vec::zero(), inSqR = Vec::zero();
+    Vec outPeakL = Vec::zero(), outPeakR = Vec::zero(), outSqL = Vec::zero(), outSqR = Vec::zero();
+
+    const int vectorised = numSamples - numSamples % Vec::size;
+    int i = 0;
+    for (; i < vectorised; i += Vec::size) {
+        const Vec t = Vec::set1((float) i) + iota;
+        const Vec a00 = Vec::fma(t, vd00, vf00), a01 = Vec::fma(t, vd01, vf01);
+        const Vec a10 = Vec::fma(t, vd10, vf10), a11 = Vec::fma(t, vd11, vf11);
+
+        const Vec l = Vec::load(left + i);
+        const Vec r = Vec::load(right + i);
+
+        if constexpr (MeasureInput) {
+            inPeakL = Vec::max(inPeakL, Vec::abs(l));
+            inPeakR = Vec::max(inPeakR, Vec::abs(r));
+            inSqL = Vec::fma(l, l, inSqL);
+            inSqR = Vec::fma(r, r, inSqR);
+        }
+
+        const Vec outL = Vec::fma(a01, r, a00 * l);
+        const Vec outR = Vec::fma(a11, r, a10 * l);
+        outL.store(left + i);
+        outR.store(right + i);
+
+        if constexpr (Accumulate) {
+            (Vec::load(destL + i) + outL).store(destL + i);
+            (Vec::load(destR + i) + outR).store(destR + i);
+        }
+
+        for (int k = 0; k < numTaps; ++k) {
+            const Tap& tap = taps[k];
+            const Vec g = Vec::fma(t, Vec::set1(tapDelta[k]), Vec::set1(tap.fromGain));
+            const Vec srcL = tap.preFader ? l : outL;
+            const Vec srcR = tap.preFader ? r : outR;
+            if (tap.destR != nullptr) {
+                Vec::fma(g, srcL, Vec::load(tap.destL + i)).store(tap.destL + i);
+                Vec::fma(g, srcR, Vec::load(tap.destR + i)).store(tap.destR + i);
+            } else {
+                Vec::fma(g, srcL + srcR, Vec::load(tap.destL + i)).store(tap.destL + i);
+            }
+        }
+
+        outPeakL = Vec::max(outPeakL, Vec::abs(outL));
+        outPeakR = Vec::max(outPeakR, Vec::abs(outR));
+        outSqL = Vec::fma(outL, outL, outSqL);
+        outSqR = Vec::fma(outR, outR, outSqR);
+    }
+
+    float ipL = inPeakL.hmax(), ipR = inPeakR.hmax(), isL = inSqL.hsum(), isR = inSqR.hsum();
+    float opL = outPeakL.hmax(), opR = outPeakR.hmax(), osL = outSqL.hsum(), osR = outSqR.hsum();
+
+    for (; i < numSamples; ++i) {
+        const float t = (float) (i + 1);
+        const float l = left[i], r = right[i];
+
+        if constexpr (MeasureInput) {
+            ipL = std::max(ipL, std::abs(l));
+            ipR = std::max(ipR, std::abs(r));
+            isL += l * l;
+            isR += r * r;
+        }
+
+        const float outL = (from.a00 + d00 * t) * l + (from.a01 + d01 * t) * r;
+        const float outR = (from.a10 + d10 * t) * l + (from.a11 + d11 * t) * r;
+        left[i] = outL;
+        right[i] = outR;
+
+        if constexpr (Accumulate) {
+            destL[i] += outL;
+            destR[i] += outR;
+        }
+
+        for (int k = 0; k < numTaps; ++k) {
+            const Tap& tap = taps[k];
+            const float g = tap.fromGain + tapDelta[k] * t;
+            const float srcL = tap.preFader ? l : outL;
+            const float srcR = tap.preFader ? r : outR;
+            if (tap.destR != nullptr) {
+                tap.destL[i] += g * srcL;
+                tap.destR[i] += g * srcR;
+            } else {
+                tap.destL[i] += g * (srcL + srcR);
+            }
+        }
+
+        opL = std::max(opL, std::abs(outL));
+        opR = std::max(opR, std::abs(outR));
+        osL += outL * outL;
+        osR += outR * outR;
+    }
+
+    if constexpr (MeasureInput) {
+        inputLevels->peak[0] = std::max(inputLevels->peak[0], ipL);
+        inputLevels->peak[1] = std::max(inputLevels->peak[1], ipR);
+        inputLevels->sumSquares[0] += isL;
+        inputLevels->sumSquares[1] += isR;
+    }
+    outputLevels.peak[0] = std::max(outputLevels.peak[0], opL);
+    outputLevels.peak[1] = std::max(outputLevels.peak[1], opR);
+    outputLevels.sumSquares[0] += osL;
+    outputLevels.sumSquares[1] += osR;
+}
+
+//==============================================================================
+template <bool MeasureInput, bool Accumulate>
+void monoKernel(float* data, int numSamples, float fromGain, float toGain,
+                float* dest, Levels* inputLevels, Levels& outputLevels, int channel,
+                const Tap* taps, int numTaps)
+{
+    const float delta = (toGain - fromGain) / (float) numSamples;
+
+    float tapDelta[kMaxTaps];
+    for (int k = 0; k < numTaps; ++k)
+        tapDelta[k] = (taps[k].toGain - taps[k].fromGain) / (float) numSamples;
+    const Vec vFrom = Vec::set1(fromGain), vDelta = Vec::set1(delta), iota = Vec::iota();
+
+    Vec inPeak = Vec::zero(), inSq = Vec::zero(), outPeak = Vec::zero(), outSq = Vec::zero();
+
+    const int vectorised = numSamples - numSamples % Vec::size;
+    int i = 0;
+    for (; i < vectorised; i += Vec::size) {
+        const Vec t = Vec::set1((float) i) + iota;
+        const Vec g = Vec::fma(t, vDelta, vFrom);
+        const Vec x = Vec::load(data + i);
+
+        if constexpr (MeasureInput) {
+            inPeak = Vec::max(inPeak, Vec::abs(x));
+            inSq = Vec::fma(x, x, inSq);
+        }
+
+        const Vec y = g * x;
+        y.store(data + i);
+        if constexpr (Accumulate)
+            (Vec::load(dest + i) + y).store(dest + i);
+
+        for (int k = 0; k < numTaps; ++k) {
+            const Tap& tap = taps[k];
+            const Vec tg = Vec::fma(t, Vec::set1(tapDelta[k]), Vec::set1(tap.fromGain));
+            const Vec src = tap.preFader ? x : y;
+            Vec::fma(tg, src, Vec::load(tap.destL + i)).store(tap.destL + i);
+            if (tap.destR != nullptr)
+                Vec::fma(tg, src, Vec::load(tap.destR + i)).store(tap.destR + i);
+        }
+
+        outPeak = Vec::max(outPeak, Vec::abs(y));
+        outSq = Vec::fma(y, y, outSq);
+    }
+
+    float ip = inPeak.hmax(), is = inSq.hsum(), op = outPeak.hmax(), os = outSq.hsum();
+
+    for (; i < numSamples; ++i) {
+        const float x = data[i];
+        if constexpr (MeasureInput) {
+            ip = std::max(ip, std::abs(x));
+            is += x * x;
+        }
+
+        const float y = (fromGain + delta * (float) (i + 1)) * x;
+        data[i] = y;
+        if constexpr (Accumulate)
+            dest[i] += y;
+
+        for (int k = 0; k < numTaps; ++k) {
+            const Tap& tap = taps[k];
+            const float tg = tap.fromGain + tapDelta[k] * (float) (i + 1);
+            const float src = tap.preFader ? x : y;
+            tap.destL[i] += tg * src;
+            if (tap.destR != nullptr)
+                tap.destR[i] += tg * src;
+        }
+
+        op = std::max(op, std::abs(y));
+        os += y * y;
+    }
+
+    if constexpr (MeasureInput) {
+        inputLevels->peak[channel] = std::max(inputLevels->peak[channel], ip);
+        inputLevels->sumSquares[channel] += is;
+    }
+    outputLevels.peak[channel] = std::max(outputLevels.peak[channel], op);
+    outputLevels.sumSquares[channel] += os;
+}
+
+} // namespace
+
+//==============================================================================
+void processStereo(float* left, float* right, int numSamples,
+                   const Matrix& from, const Matrix& to,
+                   float* destL, float* destR,
+                   Levels* inputLevels, Levels& outputLevels,
+                   const Tap* taps, int numTaps)
+{
+    if (numSamples <= 0) return;
+
+    numTaps = taps != nullptr ? std::min(numTaps, kMaxTaps) : 0;
+    const bool accumulate = destL != nullptr && destR != nullptr;
+    if (inputLevels != nullptr) {
+        if (accumulate) stereoKernel<true, true>(left, right, numSamples, from, to, destL, destR, inputLevels, outputLevels, taps, numTaps);
+        else            stereoKernel<true, false>(left, right, numSamples, from, to, destL, destR, inputLevels, outputLevels, taps, numTaps);
+    } else {
+        if (accumulate) stereoKernel<false, true>(left, right, numSamples, from, to, destL, destR, inputLevels, outputLevels, taps, numTaps);
+        else            stereoKernel<false, false>(left, right, numSamples, from, to, destL, destR, inputLevels, outputLevels, taps, numTaps);
+    }
+}
+
+void processMono(float* data, int numSamples, float fromGain, float toGain,
+                 float* dest, Levels* inputLevels, Levels& outputLevels, int channel,
+                 const Tap* taps, int numTaps)
+{
+    if (numSamples <= 0) return;
+
+    numTaps = taps != nullptr ? std::min(numTaps, kMaxTaps) : 0;
+    if (inputLevels != nullptr) {
+        if (dest != nullptr) monoKernel<true, true>(data, numSamples, fromGain, toGain, dest, inputLevels, outputLevels, channel, taps, numTaps);
+        else                 monoKernel<true, false>(data, numSamples, fromGain, toGain, dest, inputLevels, outputLevels, channel, taps, numTaps);
+    } else {
+        if (dest != nullptr) monoKernel<false, true>(data, numSamples, fromGain, toGain, dest, inputLevels, outputLevels, channel, taps, numTaps);
+        else                 monoKernel<false, false>(data, numSamples, fromGain, toGain, dest, inputLevels, outputLevels, channel, taps, numTaps);
+    }
+}
+
+void measureAndScale(float* data, int numSamples, float fromGain, float toGain,
+                     Levels& levels, int channel)
+{
+    if (numSamples <= 0) return;
+
+    // El "output" del kernel mono es la señal escalada; aquí interesa la entrada
+    Levels scaled;
+    monoKernel<true, false>(data, numSamples, fromGain, toGain, nullptr, &levels, scaled, channel, nullptr, 0);
+}
+
+} // namespace StripKernel
+} // namespace OmegaStudio
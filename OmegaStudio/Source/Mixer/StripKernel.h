@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+    StripKernel.h
+
+    Kernel fusionado del channel strip:
+    - Trim, polaridad, pan, modo de ruteo y fader en una matriz 2x2
+    - Rampa lineal de la matriz por bloque (sin zipper noise)
+    - Peak/RMS de entrada y salida acumulados en la misma pasada
+    - Suma directa al bus destino
+    - Sends pre/post fader como taps dentro de la misma pasada
+
+    Una sola lectura y una escritura por sample en lugar de 8-10 pasadas.
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace OmegaStudio {
+namespace StripKernel {
+
+//==============================================================================
+/** Matriz de salida: outL = a00*L + a01*R, outR = a10*L + a11*R */
+struct Matrix {
+    float a00 { 1.0f }, a01 { 0.0f };
+    float a10 { 0.0f }, a11 { 1.0f };
+
+    bool isZero() const { return a00 == 0.0f && a01 == 0.0f && a10 == 0.0f && a11 == 0.0f; }
+    bool operator== (const Matrix& o) const {
+        return a00 == o.a00 && a01 == o.a01 && a10 == o.a10 && a11 == o.a11;
+    }
+};
+
+//==============================================================================
+/** Peak y suma de cuadrados por canal, acumulados durante el kernel */
+struct Levels {
+    float peak[2] { 0.0f, 0.0f };
+    float sumSquares[2] { 0.0f, 0.0f };
+};
+
+//==============================================================================
+/**
+ * Send: suma la señal pre-fader (entrada de la matriz) o post-fader (salida)
+ * a un bus con su propio gain en rampa. Sin copias intermedias.
+ */
+struct Tap {
+    float* destL { nullptr };
+    float* destR { nullptr };   // Puede ser nulo si el bus es mono
+    float fromGain { 0.0f };
+    float toGain { 0.0f };
+    bool preFader { false };
+};
+
+static constexpr int kMaxTaps = 8;
+
+//==============================================================================
+/**
+ * Procesa un par estéreo in-place. La matriz va de `from` a `to` a lo largo
+ * del bloque. Si destL/destR no son nulos, la salida se suma ahí también.
+ * inputLevels (opcional) mide la señal antes de la matriz; outputLevels después.
+ */
+void processStereo(float* left, float* right, int numSamples,
+                   const Matrix& from, const Matrix& to,
+                   float* destL, float* destR,
+                   Levels* inputLevels, Levels& outputLevels,
+                   const Tap* taps = nullptr, int numTaps = 0);
+
+/** Versión mono: un único gain con rampa. Los taps suman la señal a ambos lados del bus. */
+void processMono(float* data, int numSamples,
+                 float fromGain, float toGain,
+                 float* dest,
+                 Levels* inputLevels, Levels& outputLevels, int channel = 0,
+                 const Tap* taps = nullptr, int numTaps = 0);
+
+/**
+ * Mide un canal y aplica un gain con rampa en la misma pasada
+ * (entrada del strip cuando hay plugins: trim + polaridad antes de la cadena).
+ */
+void measureAndScale(float* data, int numSamples, float fromGain, float toGain,
+                     Levels& levels, int channel);
+
+} // namespace StripKernel
+} // namespace OmegaStudio
@@ -215,23 +215,99 @@ std::vector<juce::String> ChannelRackEngine::getAvailablePatterns() const {
 void ChannelRackEngine::prepareToPlay(double sampleRate, int blockSize) {
     sampleRate_ = sampleRate;
     blockSize_ = blockSize;
+    
+    scheduler_.prepare(sampleRate_, tempo_);
+    scheduler_.setPatternLength(stepLength_);
+    
+    // Hasta 4 notas solapadas por canal (incluye layers) sin realocar en el callback
+    pendingNoteOffs_.reserve(juce::jmax<size_t>(256, channels_.size() * 4));
 }
 
 void ChannelRackEngine::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) {
-    // Process MIDI for each channel
-    for (auto& channel : channels_) {
-        if (channel->isMuted) continue;
+    const int numSamples = buffer.getNumSamples();
+    
+    // Peticiones de la UI: se aplican aquí, en el sample en que empieza el bloque
+    if (restartRequested_.exchange(false)) {
+        samplePosition_ = 0;
+        currentStep_ = 0;
+        scheduler_.resetPosition();
+    }
+    scheduler_.applyPendingTempo(samplePosition_);
+    for (int advances = stepAdvancesRequested_.exchange(0); advances > 0; --advances) {
+        // Mueve el playhead al inicio del siguiente step de la rejilla
+        const auto next = (int64_t)std::floor(scheduler_.getStepPositionAt(samplePosition_)) + 1;
+        samplePosition_ = juce::jmax(samplePosition_, scheduler_.getStepStartSample(next));
+        currentStep_ = (int)(next % stepLength_);
+    }
+    
+    if (isPlaying_.load()) {
+        // Una sola pasada: cada límite de step del bloque dispara todos los canales
+        scheduler_.forEachStepInBlock(samplePosition_, numSamples,
+            [&](const StepScheduler::StepEvent& e) {
+                currentStep_ = e.stepIndex;
+                
+                for (auto& channel : channels_) {
+                    if (channel->isMuted) continue;
+                    
+                    if (currentStep_ < (int)channel->steps.size() && channel->steps[currentStep_]) {
+                        int velocity = currentStep_ < (int)channel->velocities.size()
+                                     ? channel->velocities[currentStep_] : 100;
+                        velocity = juce::jlimit(1, 127, juce::roundToInt(velocity * e.velocityScale));
+                        triggerChannelNote(channel.get(), velocity, midi, e.sampleOffset);
+                    }
+                }
+            });
         
-        // Check if current step is active
-        if (currentStep_ < channel->steps.size() && channel->steps[currentStep_]) {
-            int velocity = channel->velocities[currentStep_];
-            triggerChannelNote(channel.get(), velocity, midi, 0);
-        }
+        samplePosition_ += numSamples;
+    }
+    
+    emitPendingNoteOffs(midi, numSamples);
+    
+    // Los note-offs del próximo bloque son relativos a la nueva posición
+    for (auto& off : pendingNoteOffs_) {
+        off.offSample -= numSamples;
     }
 }
 
 void ChannelRackEngine::advanceStep() {
-    currentStep_ = (currentStep_ + 1) % stepLength_;
+    ++stepAdvancesRequested_;
+}
+
+void ChannelRackEngine::start() {
+    restartRequested_.store(true);
+    isPlaying_.store(true);
+}
+
+void ChannelRackEngine::stop() {
+    isPlaying_.store(false);
+}
+
+void ChannelRackEngine::setTempo(double bpm) {
+    tempo_ = bpm;
+    scheduler_.requestTempo(bpm);
+}
+
+void ChannelRackEngine::setSwing(float swing) {
+    scheduler_.setSwing(swing);
+}
+
+void ChannelRackEngine::setGroove(const GrooveTemplate& groove, float amount) {
+    scheduler_.setGroove(groove, amount);
+}
+
+void ChannelRackEngine::emitPendingNoteOffs(juce::MidiBuffer& midi, int numSamples) {
+    // offSample es relativo al inicio del bloque actual
+    for (size_t i = 0; i < pendingNoteOffs_.size();) {
+        const auto off = pendingNoteOffs_[i];
+        if (off.offSample < numSamples || !isPlaying_.load()) {
+            midi.addEvent(juce::MidiMessage::noteOff(off.midiChannel, off.noteNumber),
+                          (int)juce::jlimit((int64_t)0, (int64_t)numSamples - 1, off.offSample));
+            pendingNoteOffs_[i] = pendingNoteOffs_.back();
+            pendingNoteOffs_.pop_back();
+        } else {
+            ++i;
+        }
+    }
 }
 
 void ChannelRackEngine::routeMidiToChannel(int channelId, const juce::MidiMessage& message) {
@@ -271,6 +347,10 @@ void ChannelRackEngine::triggerChannelNote(Channel* channel, int velocity,
         return;
     }
     
+    // Sin hueco para su note-off la nota se descarta: mejor perderla que dejarla colgada
+    if (pendingNoteOffs_.size() >= pendingNoteOffs_.capacity())
+        return;
+    
     // Create MIDI note
     juce::MidiMessage noteOn = juce::MidiMessage::noteOn(
         channel->midiChannel + 1,
@@ -280,13 +360,10 @@ void ChannelRackEngine::triggerChannelNote(Channel* channel, int velocity,
     
     midi.addEvent(noteOn, sampleOffset);
     
-    // Schedule note off (e.g., 1/16th note later)
-    int noteLength = static_cast<int>(sampleRate_ * 0.1);  // 100ms
-    juce::MidiMessage noteOff = juce::MidiMessage::noteOff(
-        channel->midiChannel + 1,
-        channel->rootNote
-    );
-    midi.addEvent(noteOff, sampleOffset + noteLength);
+    // El note-off cae en un bloque futuro casi siempre: se agenda con offset relativo
+    const auto noteLength = (int64_t)juce::jmax(1.0, scheduler_.getStepLengthSamples() * gate_);
+    pendingNoteOffs_.push_back({ channel->midiChannel + 1, channel->rootNote,
+                                 (int64_t)sampleOffset + noteLength });
 }
 
 //==============================================================================
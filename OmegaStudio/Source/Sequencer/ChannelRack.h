@@ -3,6 +3,8 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include "StepScheduler.h"
 
 namespace OmegaStudio {
 namespace Sequencer {
@@ -93,9 +95,19 @@ public:
     // Playback
     void prepareToPlay(double sampleRate, int blockSize);
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi);
-    void advanceStep();  // Called on each 16th note
+    void advanceStep();  // Salta al siguiente step en el próximo bloque (el scheduler avanza solo)
     int getCurrentStep() const { return currentStep_; }
-    void setStepLength(int steps) { stepLength_ = steps; }  // 16, 32, 64, etc.
+    void setStepLength(int steps) { stepLength_ = steps; scheduler_.setPatternLength(steps); }  // 16, 32, 64, etc.
+    
+    // Transport / timing. Posición y rejilla son del audio thread: start, advanceStep
+    // y setTempo solo dejan la petición, que processBlock aplica al empezar el bloque
+    void start();
+    void stop();
+    bool isPlaying() const { return isPlaying_.load(); }
+    void setTempo(double bpm);
+    void setSwing(float swing);
+    void setGroove(const GrooveTemplate& groove, float amount = 1.0f);
+    void setGate(float gate) { gate_ = juce::jlimit(0.05f, 1.0f, gate); }
     
     // MIDI routing
     void routeMidiToChannel(int channelId, const juce::MidiMessage& message);
@@ -118,12 +130,28 @@ private:
     int stepLength_{16};
     double sampleRate_{44100.0};
     int blockSize_{512};
+    double tempo_{120.0};
+    float gate_{0.5f};           // Note length as fraction of a step
+    std::atomic<bool> isPlaying_{false};
+    std::atomic<bool> restartRequested_{false};
+    std::atomic<int> stepAdvancesRequested_{0};
+    int64_t samplePosition_{0};  // Absolute transport position in samples (audio thread)
+    StepScheduler scheduler_;
+    
+    // Note-offs pendientes en tiempo absoluto; capacidad reservada en prepareToPlay
+    struct PendingNoteOff {
+        int midiChannel;
+        int noteNumber;
+        int64_t offSample;
+    };
+    std::vector<PendingNoteOff> pendingNoteOffs_;
     
     // Step patterns library
     std::map<juce::String, std::vector<bool>> stepPatterns_;
     
     void initializePatterns();
     void triggerChannelNote(Channel* channel, int velocity, juce::MidiBuffer& midi, int sampleOffset);
+    void emitPendingNoteOffs(juce::MidiBuffer& midi, int numSamples);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelRackEngine)
 };
@@ -4,6 +4,8 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include "MIDIEventBuffer.h"
+#include "../Audio/DSP/OnsetDetector.h"
 
 namespace OmegaStudio {
 namespace Sequencer {
@@ -204,6 +206,8 @@ public:
     void setAmount(float amount) { amount_ = juce::jlimit(0.0f, 1.0f, amount); }
     float getAmount() const { return amount_; }
     
+    const GrooveTemplate& getCurrentGroove() const { return currentGroove_; }
+    
     /**
      * Aplica groove a MIDI buffer
      */
@@ -248,6 +252,44 @@ public:
         buffer.swapWith(processed);
     }
     
+    /**
+     * Versión in-place para MIDIFXChain. Usa la posición absoluta del bloque
+     * para elegir el step del groove; los retrasos que salen del bloque se agendan.
+     */
+    void processEvents(MIDIFX::MidiEventBuffer& events, const MIDIFX::BlockContext& ctx) {
+        if (!enabled_ || amount_ <= 0.0f || currentGroove_.steps <= 0) return;
+        
+        const double samplesPerStep = ctx.samplesPerBeat() / (currentGroove_.steps / 4.0);
+        
+        for (auto& e : events) {
+            if (!e.isNoteOnOrOff()) continue;
+            
+            const int64_t absolute = ctx.blockStartSample + e.samplePosition;
+            const int64_t grid = (int64_t)std::floor(absolute / samplesPerStep);
+            const size_t step = (size_t)(((grid % currentGroove_.steps) + currentGroove_.steps) % currentGroove_.steps);
+            
+            // Un template con menos valores que steps deja neutros los que faltan
+            if (e.isNoteOn()) {
+                float velMultiplier = step < currentGroove_.velocity.size() ? currentGroove_.velocity[step] : 1.0f;
+                e.setVelocity((int)(e.getVelocity() * (1.0f + (velMultiplier - 1.0f) * amount_)));
+            }
+            
+            const float timingMs = step < currentGroove_.timing.size() ? currentGroove_.timing[step] : 0.0f;
+            const int timingOffset = (int)(timingMs * 0.001 * ctx.sampleRate * amount_);
+            const int newPosition = std::max(0, e.samplePosition + timingOffset);
+            if (newPosition >= ctx.numSamples) {
+                delayed_.schedule(e, ctx.blockStartSample + newPosition);
+                e.flags |= MIDIFX::MidiEvent::kRemove;
+            } else {
+                e.samplePosition = newPosition;
+            }
+        }
+        
+        events.commitStage();
+        events.sortByTime();
+        delayed_.release(events, ctx);
+    }
+    
     /**
      * Extrae groove de audio mediante onset detection
      */
@@ -256,7 +298,6 @@ public:
                                          double estimatedTempo) {
         GrooveTemplate extracted("Extracted", 16);
         
-        // Simple onset detection
         std::vector<int> onsets = detectOnsets(buffer, sampleRate);
         
         if (onsets.size() < 2) return extracted;
@@ -303,28 +344,18 @@ private:
         grooves_["Shuffle"] = GrooveLibrary::createShuffle();
     }
     
+    // Onsets del OnsetDetector compartido, con fuerza relativa >= 0.3
     std::vector<int> detectOnsets(const juce::AudioBuffer<float>& buffer, double sampleRate) {
-        std::vector<int> onsets;
+        if (sampleRate != onsetDetector_.getSampleRate() || !onsetDetectorReady_) {
+            onsetDetector_.initialize(sampleRate);
+            onsetDetectorReady_ = true;
+        }
         
-        const int hopSize = 512;
-        const float threshold = 0.3f;
+        onsetDetector_.detect(buffer, onsetList_);
         
-        // Simple energy-based detection
-        for (int pos = 0; pos < buffer.getNumSamples() - hopSize; pos += hopSize) {
-            float energy = 0.0f;
-            for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-                const float* data = buffer.getReadPointer(ch);
-                for (int i = 0; i < hopSize; ++i) {
-                    energy += std::abs(data[pos + i]);
-                }
-            }
-            
-            energy /= (hopSize * buffer.getNumChannels());
-            
-            if (energy > threshold) {
-                onsets.push_back(pos);
-            }
-        }
+        std::vector<int> onsets;
+        for (const auto& onset : onsetList_.select(0.3f))
+            onsets.push_back((int) onset.getSample());
         
         return onsets;
     }
@@ -333,6 +364,11 @@ private:
     GrooveTemplate currentGroove_;
     bool enabled_ { false };
     float amount_ { 1.0f };  // 0.0 - 1.0
+    MIDIFX::ScheduledEventQueue delayed_ { 512 };
+    
+    omega::OnsetDetector onsetDetector_;
+    omega::OnsetList onsetList_;
+    bool onsetDetectorReady_ { false };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrooveEngine)
 };
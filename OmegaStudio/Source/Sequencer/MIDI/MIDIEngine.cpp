@@ -6,7 +6,9 @@
 */
 
 #include "MIDIEngine.h"
+#include "../../MIDI/MIDIAdvanced.h"
 #include <random>
+#include <cmath>
 
 namespace OmegaStudio {
 
@@ -373,14 +375,15 @@ void MIDIEngine::renderMIDI(juce::MidiBuffer& buffer,
     }
 }
 
-void MIDIEngine::startRecording(int trackIndex) {
+void MIDIEngine::startRecording(int trackIndex, double startTime) {
     if (trackIndex < 0 || trackIndex >= getNumTracks())
         return;
     
     recording = true;
     recordingTrackIndex = trackIndex;
     recordingClip = std::make_unique<MIDIClip>("Recorded Clip");
-    recordStartTime = juce::Time::getMillisecondCounterHiRes() / 1000.0;
+    recordStartTime = startTime >= 0.0 ? startTime
+                                       : juce::Time::getMillisecondCounterHiRes() * 0.001;
 }
 
 void MIDIEngine::stopRecording() {
@@ -401,7 +404,11 @@ void MIDIEngine::recordMIDIMessage(const juce::MidiMessage& message, double time
     if (!recording || !recordingClip)
         return;
     
-    double relativeBeat = (timestamp - recordStartTime) * (120.0 / 60.0); // Assume 120 BPM
+    // Usar la hora de llegada sellada por el driver, no la de esta llamada
+    if (timestamp < 0.0)
+        timestamp = message.getTimeStamp();
+    
+    double relativeBeat = juce::jmax(0.0, timestamp - recordStartTime) * (recordTempo / 60.0);
     
     if (message.isNoteOn()) {
         MIDINote note;
@@ -550,7 +557,28 @@ void MIDIInputManager::removeListener(Listener* listener) {
 }
 
 void MIDIInputManager::handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) {
-    listeners.call([&](Listener& l) { l.handleIncomingMidiMessage(message); });
+    juce::ignoreUnused(source);
+    
+    // JUCE sella con getMillisecondCounterHiRes() * 0.001; si el driver no lo hizo
+    // (o el valor no es plausible) se usa la hora de llegada
+    const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    double stamp = message.getTimeStamp();
+    if (stamp <= 0.0 || std::abs(stamp - now) > 1.0)
+        stamp = now;
+    
+    if (auto* manager = realtimeTarget.load(std::memory_order_acquire)) {
+        auto event = MIDI::MIDIManager::RTEvent::fromMessage(message);
+        event.timestamp = stamp;
+        if (!manager->pushInput(event))
+            droppedRealtimeEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    if (listeners.isEmpty())
+        return;
+    
+    juce::MidiMessage stamped(message);
+    stamped.setTimeStamp(stamp);
+    listeners.call([&](Listener& l) { l.handleIncomingMidiMessage(stamped); });
 }
 
 //==============================================================================
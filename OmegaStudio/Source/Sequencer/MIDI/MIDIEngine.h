@@ -21,9 +21,12 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <atomic>
 
 namespace OmegaStudio {
 
+namespace MIDI { class MIDIManager; }
+
 //==============================================================================
 /** Nota MIDI */
 struct MIDINote {
@@ -248,9 +251,12 @@ public:
                     double bpm, int sampleRate) const;
     
     // Recording
-    void startRecording(int trackIndex);
+    // startTime en segundos del reloj hi-res (Time::getMillisecondCounterHiRes() * 0.001);
+    // negativo = ahora. Así se puede alinear con el inicio real del transporte.
+    void startRecording(int trackIndex, double startTime = -1.0);
     void stopRecording();
     bool isRecording() const { return recording; }
+    void setRecordingTempo(double bpm) { recordTempo = juce::jmax(1.0, bpm); }
     
     // Stats
     int getClipCount() const {
@@ -269,7 +275,8 @@ public:
     }
     int getRecordingTrack() const { return recordingTrackIndex; }
     
-    void recordMIDIMessage(const juce::MidiMessage& message, double timestamp);
+    // timestamp en el mismo reloj hi-res; negativo = usar message.getTimeStamp()
+    void recordMIDIMessage(const juce::MidiMessage& message, double timestamp = -1.0);
     
     // Editing operations (aplicar a selección)
     void quantizeNotes(const std::vector<MIDINote*>& notes, const QuantizeSettings& settings);
@@ -288,6 +295,7 @@ private:
     int recordingTrackIndex { -1 };
     std::unique_ptr<MIDIClip> recordingClip;
     double recordStartTime { 0.0 };
+    double recordTempo { 120.0 };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MIDIEngine)
 };
@@ -314,12 +322,19 @@ public:
     void addListener(Listener* listener);
     void removeListener(Listener* listener);
     
+    // Cola RT: los mensajes se sellan al llegar y van a la input queue del
+    // MIDIManager; el audio callback los coloca con precisión de sample.
+    void setRealtimeTarget(MIDI::MIDIManager* manager) { realtimeTarget.store(manager, std::memory_order_release); }
+    int getDroppedRealtimeEvents() const { return droppedRealtimeEvents.load(std::memory_order_relaxed); }
+    
     // MidiInputCallback override
     void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
     
 private:
     std::unique_ptr<juce::MidiInput> currentDevice;
     juce::ListenerList<Listener> listeners;
+    std::atomic<MIDI::MIDIManager*> realtimeTarget { nullptr }; // non-owning
+    std::atomic<int> droppedRealtimeEvents { 0 };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MIDIInputManager)
 };
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+namespace OmegaStudio {
+namespace Sequencer {
+namespace MIDIFX {
+
+/**
+ * @struct MidiEvent
+ * @brief Mensaje MIDI corto (3 bytes) con posición en samples dentro del bloque
+ *
+ * Trivialmente copiable para poder moverse dentro de arrays preasignados sin
+ * tocar el heap (a diferencia de juce::MidiMessage / juce::MidiBuffer).
+ */
+struct MidiEvent {
+    int32_t samplePosition { 0 };
+    uint8_t status { 0 };
+    uint8_t data1 { 0 };
+    uint8_t data2 { 0 };
+    uint8_t flags { 0 };  // Marcas internas de los stages; no se serializan
+
+    enum : uint8_t {
+        kGenerated = 1 << 0,  // Creado por el stage en curso: no volver a procesarlo
+        kRemove    = 1 << 1   // Pendiente de eliminar al final del stage
+    };
+
+    static MidiEvent noteOn(int channel, int note, uint8_t velocity, int position) {
+        return { position, (uint8_t)(0x90 | ((channel - 1) & 0x0f)), (uint8_t)(note & 0x7f), (uint8_t)(velocity & 0x7f), 0 };
+    }
+
+    MidiEvent generated() const { MidiEvent e = *this; e.flags = kGenerated; return e; }
+
+    static MidiEvent noteOff(int channel, int note, int position) {
+        return { position, (uint8_t)(0x80 | ((channel - 1) & 0x0f)), (uint8_t)(note & 0x7f), 0, 0 };
+    }
+
+    bool isNoteOn() const { return (status & 0xf0) == 0x90 && data2 > 0; }
+    bool isNoteOff() const { return (status & 0xf0) == 0x80 || ((status & 0xf0) == 0x90 && data2 == 0); }
+    bool isNoteOnOrOff() const { return isNoteOn() || isNoteOff(); }
+    int getChannel() const { return (status & 0x0f) + 1; }
+    int getNoteNumber() const { return data1; }
+    uint8_t getVelocity() const { return data2; }
+
+    void setNoteNumber(int note) { data1 = (uint8_t)juce::jlimit(0, 127, note); }
+    void setVelocity(int velocity) { data2 = (uint8_t)juce::jlimit(1, 127, velocity); }
+};
+
+/**
+ * @struct BlockContext
+ * @brief Información de transporte que recibe cada stage de MIDI FX
+ */
+struct BlockContext {
+    double sampleRate { 44100.0 };
+    double tempo { 120.0 };
+    int numSamples { 0 };
+    int64_t blockStartSample { 0 };  // Posición absoluta del transporte
+
+    double samplesPerBeat() const { return (60.0 / tempo) * sampleRate; }
+};
+
+/**
+ * @class MidiEventBuffer
+ * @brief Array de eventos de capacidad fija, siempre ordenado por tiempo
+ *
+ * La memoria se reserva una sola vez (constructor o prepare). Las inserciones
+ * mantienen el orden con una búsqueda desde el final, que es O(1) para el caso
+ * típico de eventos que llegan en orden. Cada stage de la cadena tiene además
+ * un presupuesto de eventos: lo que exceda presupuesto o capacidad se descarta
+ * y se contabiliza en lugar de crecer.
+ */
+class MidiEventBuffer {
+public:
+    explicit MidiEventBuffer(size_t capacity = 512) {
+        prepare(capacity);
+    }
+
+    /** Reserva la capacidad. No llamar desde el audio thread. */
+    void prepare(size_t capacity) {
+        events_.assign(capacity, MidiEvent{});
+        size_ = 0;
+        endStage();
+    }
+
+    void clear() { size_ = 0; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return events_.size(); }
+    bool isEmpty() const { return size_ == 0; }
+    bool isFull() const { return size_ >= events_.size(); }
+
+    MidiEvent& operator[](size_t index) { return events_[index]; }
+    const MidiEvent& operator[](size_t index) const { return events_[index]; }
+    MidiEvent* begin() { return events_.data(); }
+    MidiEvent* end() { return events_.data() + size_; }
+    const MidiEvent* begin() const { return events_.data(); }
+    const MidiEvent* end() const { return events_.data() + size_; }
+
+    /** Inserta manteniendo el orden (estable para timestamps iguales). */
+    bool add(const MidiEvent& event) {
+        if (size_ >= events_.size() || addedThisStage_ >= stageBudget_) {
+            ++droppedEvents_;
+            return false;
+        }
+
+        size_t pos = size_;
+        while (pos > 0 && events_[pos - 1].samplePosition > event.samplePosition) {
+            events_[pos] = events_[pos - 1];
+            --pos;
+        }
+        events_[pos] = event;
+        ++size_;
+        ++addedThisStage_;
+        return true;
+    }
+
+    /** Elimina en sitio los eventos que cumplen el predicado, conservando el orden. */
+    template <typename Predicate>
+    void removeIf(Predicate&& predicate) {
+        size_t write = 0;
+        for (size_t read = 0; read < size_; ++read) {
+            if (!predicate(events_[read])) {
+                if (write != read) events_[write] = events_[read];
+                ++write;
+            }
+        }
+        size_ = write;
+    }
+
+    /** Cierra un stage: elimina lo marcado kRemove y limpia las marcas. */
+    void commitStage() {
+        removeIf([](const MidiEvent& e) { return (e.flags & MidiEvent::kRemove) != 0; });
+        for (size_t i = 0; i < size_; ++i) events_[i].flags = 0;
+    }
+
+    /** Reordena tras modificar timestamps en sitio (insertion sort: casi ordenado, sin heap). */
+    void sortByTime() {
+        for (size_t i = 1; i < size_; ++i) {
+            const MidiEvent e = events_[i];
+            size_t j = i;
+            while (j > 0 && events_[j - 1].samplePosition > e.samplePosition) {
+                events_[j] = events_[j - 1];
+                --j;
+            }
+            events_[j] = e;
+        }
+    }
+
+    // Presupuesto por stage: lo fija la cadena antes de ejecutar cada stage
+    void beginStage(int budget) {
+        stageBudget_ = budget;
+        addedThisStage_ = 0;
+    }
+
+    void endStage() {
+        stageBudget_ = std::numeric_limits<int>::max();
+        addedThisStage_ = 0;
+    }
+
+    int getDroppedEvents() const { return droppedEvents_; }
+    void resetDroppedEvents() { droppedEvents_ = 0; }
+
+    // Conversión con juce::MidiBuffer en los bordes de la cadena (sólo mensajes cortos)
+    void readFrom(const juce::MidiBuffer& buffer, int channelFilter = 0) {
+        clear();
+        for (const auto metadata : buffer) {
+            const auto* raw = metadata.data;
+            if (metadata.numBytes < 1 || metadata.numBytes > 3 || raw[0] < 0x80 || raw[0] >= 0xf0) continue;
+            if (channelFilter > 0 && (raw[0] & 0x0f) + 1 != channelFilter) continue;
+
+            MidiEvent e;
+            e.samplePosition = metadata.samplePosition;
+            e.status = raw[0];
+            e.data1 = metadata.numBytes > 1 ? raw[1] : 0;
+            e.data2 = metadata.numBytes > 2 ? raw[2] : 0;
+            add(e);
+        }
+    }
+
+    void writeTo(juce::MidiBuffer& buffer) const {
+        for (size_t i = 0; i < size_; ++i) {
+            const auto& e = events_[i];
+            const int type = e.status & 0xf0;
+            const int numBytes = (type == 0xc0 || type == 0xd0) ? 2 : 3;
+            buffer.addEvent(&e.status, numBytes, e.samplePosition);
+        }
+    }
+
+private:
+    std::vector<MidiEvent> events_;  // Tamaño fijo tras prepare()
+    size_t size_ { 0 };
+    int stageBudget_ { std::numeric_limits<int>::max() };
+    int addedThisStage_ { 0 };
+    int droppedEvents_ { 0 };
+};
+
+/**
+ * @class ScheduledEventQueue
+ * @brief Eventos agendados en tiempo absoluto que caen en bloques futuros
+ *
+ * La usan los stages que generan material retrasado (note-offs del arpegiador,
+ * repeticiones, ecos, groove). Capacidad fija; nunca realoca.
+ */
+class ScheduledEventQueue {
+public:
+    explicit ScheduledEventQueue(size_t capacity = 256) {
+        prepare(capacity);
+    }
+
+    void prepare(size_t capacity) {
+        slots_.assign(capacity, Slot{});
+        size_ = 0;
+    }
+
+    void clear() { size_ = 0; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+
+    bool schedule(const MidiEvent& event, int64_t absoluteSample) {
+        if (size_ >= slots_.size()) return false;
+        slots_[size_++] = { event, absoluteSample };
+        return true;
+    }
+
+    /** Mueve al buffer los eventos que caen dentro del bloque actual. */
+    void release(MidiEventBuffer& buffer, const BlockContext& ctx) {
+        const int64_t blockEnd = ctx.blockStartSample + ctx.numSamples;
+
+        for (size_t i = 0; i < size_;) {
+            if (slots_[i].time < blockEnd) {
+                MidiEvent e = slots_[i].event;
+                e.samplePosition = (int32_t)juce::jmax((int64_t)0, slots_[i].time - ctx.blockStartSample);
+                buffer.add(e);
+                slots_[i] = slots_[--size_];
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    /** Emite inmediatamente los note-offs pendientes (stop / reset). */
+    void flushNoteOffs(MidiEventBuffer& buffer) {
+        for (size_t i = 0; i < size_; ++i) {
+            if (slots_[i].event.isNoteOff()) {
+                MidiEvent e = slots_[i].event;
+                e.samplePosition = 0;
+                buffer.add(e);
+            }
+        }
+        size_ = 0;
+    }
+
+private:
+    struct Slot {
+        MidiEvent event;
+        int64_t time { 0 };
+    };
+
+    std::vector<Slot> slots_;
+    size_t size_ { 0 };
+};
+
+} // namespace MIDIFX
+} // namespace Sequencer
+} // namespace OmegaStudio
@@ -6,6 +6,9 @@
 #include <array>
 #include <random>
 #include <algorithm>
+#include <map>
+#include <set>
+#include "MIDIEventBuffer.h"
 
 namespace OmegaStudio {
 namespace Sequencer {
@@ -50,13 +53,18 @@ public:
     }
     
     void reset() {
-        heldNotes_.clear();
+        heldVelocity_.fill(0);
+        numHeld_ = 0;
+        sequenceLength_ = 0;
         currentStep_ = 0;
         lastOutputTime_ = 0.0;
+        samplesToNextStep_ = 0.0;
+        pendingNoteOffs_.clear();
     }
     
     void noteOn(int noteNumber, uint8_t velocity) {
-        heldNotes_[noteNumber] = velocity;
+        if (heldVelocity_[noteNumber & 0x7f] == 0) ++numHeld_;
+        heldVelocity_[noteNumber & 0x7f] = juce::jmax((uint8_t)1, velocity);
         
         if (!params_.latch) {
             generateArpSequence();
@@ -65,37 +73,31 @@ public:
     
     void noteOff(int noteNumber) {
         if (!params_.latch) {
-            heldNotes_.erase(noteNumber);
+            if (heldVelocity_[noteNumber & 0x7f] != 0) --numHeld_;
+            heldVelocity_[noteNumber & 0x7f] = 0;
             generateArpSequence();
         }
     }
     
     void allNotesOff() {
         if (!params_.latch) {
-            heldNotes_.clear();
-            arpSequence_.clear();
+            heldVelocity_.fill(0);
+            numHeld_ = 0;
+            sequenceLength_ = 0;
         }
     }
     
     void process(juce::MidiBuffer& midiMessages, double currentTime, double tempo) {
-        if (heldNotes_.empty()) return;
+        if (numHeld_ == 0) return;
         
         double beatsPerSecond = tempo / 60.0;
         double stepDuration = params_.rate / beatsPerSecond;
         
         // Check if it's time for next step
         if (currentTime - lastOutputTime_ >= stepDuration) {
-            if (!arpSequence_.empty()) {
-                int noteIndex = currentStep_ % arpSequence_.size();
-                auto [note, velocity] = arpSequence_[noteIndex];
-                
-                // Apply velocity mode
-                uint8_t outputVel = velocity;
-                if (params_.velocityMode == 1) {
-                    outputVel = params_.fixedVelocity;
-                } else if (params_.velocityMode == 2) {
-                    outputVel = juce::jlimit(1, 127, 64 + (currentStep_ % 8) * 8);
-                }
+            if (sequenceLength_ > 0) {
+                auto [note, velocity] = arpSequence_[currentStep_ % sequenceLength_];
+                uint8_t outputVel = getOutputVelocity(velocity);
                 
                 // Note On
                 midiMessages.addEvent(juce::MidiMessage::noteOn(1, note, outputVel), 0);
@@ -112,82 +114,128 @@ public:
         }
     }
     
+    /**
+     * Versión in-place para MIDIFXChain: consume note on/off del bloque,
+     * genera los pasos del arpegio en su offset exacto y agenda los note-offs
+     * en una cola fija. No toca el heap.
+     */
+    void process(MidiEventBuffer& events, const BlockContext& ctx) {
+        for (const auto& e : events) {
+            if (e.isNoteOn()) { noteOn(e.getNoteNumber(), e.getVelocity()); channel_ = e.getChannel(); }
+            else if (e.isNoteOff()) noteOff(e.getNoteNumber());
+        }
+        events.removeIf([](const MidiEvent& e) { return e.isNoteOnOrOff(); });
+        
+        pendingNoteOffs_.release(events, ctx);
+        
+        if (sequenceLength_ == 0) {
+            samplesToNextStep_ = 0.0;
+            return;
+        }
+        
+        const double stepSamples = juce::jmax(1.0, params_.rate * ctx.samplesPerBeat());
+        while (samplesToNextStep_ < ctx.numSamples) {
+            const int offset = (int)samplesToNextStep_;
+            auto [note, velocity] = arpSequence_[currentStep_ % sequenceLength_];
+            
+            if (events.add(MidiEvent::noteOn(channel_, note, getOutputVelocity(velocity), offset))) {
+                pendingNoteOffs_.schedule(MidiEvent::noteOff(channel_, note, 0),
+                                          ctx.blockStartSample + offset + (int64_t)(stepSamples * params_.gate));
+            }
+            
+            currentStep_++;
+            samplesToNextStep_ += stepSamples;
+        }
+        samplesToNextStep_ -= ctx.numSamples;
+        
+        // Note-offs que caen dentro de este mismo bloque
+        pendingNoteOffs_.release(events, ctx);
+    }
+    
 private:
+    static constexpr int kMaxSequenceLength = 128 * 4;
+    
+    uint8_t getOutputVelocity(uint8_t velocity) const {
+        if (params_.velocityMode == 1) {
+            return params_.fixedVelocity;
+        } else if (params_.velocityMode == 2) {
+            return (uint8_t)juce::jlimit(1, 127, 64 + (currentStep_ % 8) * 8);
+        }
+        return velocity;
+    }
+    
+    void appendToSequence(int note, uint8_t velocity) {
+        if (sequenceLength_ < kMaxSequenceLength) {
+            arpSequence_[sequenceLength_++] = { note, velocity };
+        }
+    }
+    
     void generateArpSequence() {
-        arpSequence_.clear();
-        
-        if (heldNotes_.empty()) return;
+        sequenceLength_ = 0;
         
-        // Convert map to vector
-        std::vector<std::pair<int, uint8_t>> notes(heldNotes_.begin(), heldNotes_.end());
+        if (numHeld_ == 0) return;
         
-        // Sort by note number
-        std::sort(notes.begin(), notes.end());
+        // Notas ordenadas por número (el array de 128 ya está ordenado)
+        std::array<std::pair<int, uint8_t>, 128> notes;
+        int numNotes = 0;
+        for (int n = 0; n < 128; ++n) {
+            if (heldVelocity_[n] > 0) notes[numNotes++] = { n, heldVelocity_[n] };
+        }
         
         // Generate pattern
         switch (params_.pattern) {
             case Pattern::Up:
-                arpSequence_ = notes;
+            case Pattern::Chord:
+            case Pattern::AsPlayed:
+                for (int i = 0; i < numNotes; ++i) appendToSequence(notes[i].first, notes[i].second);
                 break;
                 
             case Pattern::Down:
-                arpSequence_ = notes;
-                std::reverse(arpSequence_.begin(), arpSequence_.end());
+                for (int i = numNotes - 1; i >= 0; --i) appendToSequence(notes[i].first, notes[i].second);
                 break;
                 
             case Pattern::UpDown:
-                arpSequence_ = notes;
-                for (int i = notes.size() - 2; i >= 1; --i) {
-                    arpSequence_.push_back(notes[i]);
-                }
+                for (int i = 0; i < numNotes; ++i) appendToSequence(notes[i].first, notes[i].second);
+                for (int i = numNotes - 2; i >= 1; --i) appendToSequence(notes[i].first, notes[i].second);
                 break;
                 
             case Pattern::DownUp:
-                arpSequence_ = notes;
-                std::reverse(arpSequence_.begin(), arpSequence_.end());
-                for (int i = notes.size() - 2; i >= 1; --i) {
-                    arpSequence_.push_back(notes[notes.size() - 1 - i]);
-                }
+                for (int i = numNotes - 1; i >= 0; --i) appendToSequence(notes[i].first, notes[i].second);
+                for (int i = 1; i <= numNotes - 2; ++i) appendToSequence(notes[i].first, notes[i].second);
                 break;
                 
             case Pattern::Random:
-                arpSequence_ = notes;
-                std::shuffle(arpSequence_.begin(), arpSequence_.end(), 
+                for (int i = 0; i < numNotes; ++i) appendToSequence(notes[i].first, notes[i].second);
+                std::shuffle(arpSequence_.begin(), arpSequence_.begin() + sequenceLength_, 
                             std::default_random_engine{});
                 break;
-                
-            case Pattern::Chord:
-                arpSequence_ = notes;
-                break;
-                
-            case Pattern::AsPlayed:
-                arpSequence_ = notes;
-                break;
         }
         
-        // Apply octave mode
-        if (params_.octaveMode != OctaveMode::Single) {
-            std::vector<std::pair<int, uint8_t>> extended;
-            int octaves = static_cast<int>(params_.octaveMode);
-            
-            for (int oct = 0; oct < octaves; ++oct) {
-                for (const auto& [note, vel] : arpSequence_) {
-                    int transposed = note + oct * 12;
+        // Apply octave mode (in place, de la última octava a la primera)
+        int octaves = static_cast<int>(params_.octaveMode) + 1;
+        if (octaves > 1) {
+            const int baseLength = sequenceLength_;
+            for (int oct = 1; oct < octaves; ++oct) {
+                for (int i = 0; i < baseLength; ++i) {
+                    int transposed = arpSequence_[i].first + oct * 12;
                     if (transposed <= 127) {
-                        extended.push_back({transposed, vel});
+                        appendToSequence(transposed, arpSequence_[i].second);
                     }
                 }
             }
-            
-            arpSequence_ = extended;
         }
     }
     
     Parameters params_;
-    std::map<int, uint8_t> heldNotes_;
-    std::vector<std::pair<int, uint8_t>> arpSequence_;
+    std::array<uint8_t, 128> heldVelocity_ {};     // 0 = no pulsada
+    int numHeld_ { 0 };
+    int channel_ { 1 };                            // Canal del último note-on; los pasos siguientes salen por él
+    std::array<std::pair<int, uint8_t>, kMaxSequenceLength> arpSequence_ {};
+    int sequenceLength_ { 0 };
     int currentStep_ { 0 };
     double lastOutputTime_ { 0.0 };
+    double samplesToNextStep_ { 0.0 };
+    ScheduledEventQueue pendingNoteOffs_ { 256 };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Arpeggiator)
 };
@@ -226,35 +274,13 @@ public:
     }
     
     void processNoteOn(int rootNote, uint8_t velocity, juce::MidiBuffer& output) {
-        auto intervals = getIntervals(params_.type);
-        
-        // Apply inversion
-        if (params_.inversion > 0) {
-            std::rotate(intervals.begin(), 
-                       intervals.begin() + std::min(params_.inversion, (int)intervals.size()), 
-                       intervals.end());
-            // Transpose inverted notes up an octave
-            for (int i = 0; i < params_.inversion && i < intervals.size(); ++i) {
-                intervals[i] += 12;
-            }
-        }
+        auto chord = buildChord(rootNote);
         
         // Generate chord notes
-        for (int interval : intervals) {
-            int note = rootNote + interval + params_.octaveSpread * 12;
-            
-            if (note >= 0 && note <= 127) {
-                // Apply velocity spread
-                uint8_t vel = velocity;
-                if (params_.velocitySpread > 0.0f) {
-                    float random = juce::Random::getSystemRandom().nextFloat() - 0.5f;
-                    vel = juce::jlimit(1, 127, 
-                        (int)(velocity + random * params_.velocitySpread * 127));
-                }
-                
-                output.addEvent(juce::MidiMessage::noteOn(1, note, vel), 0);
-                activeNotes_.insert(note);
-            }
+        for (int i = 0; i < chord.count; ++i) {
+            int note = chord.notes[i];
+            output.addEvent(juce::MidiMessage::noteOn(1, note, spreadVelocity(velocity)), 0);
+            activeNotes_.insert(note);
         }
     }
     
@@ -273,27 +299,97 @@ public:
         activeNotes_.clear();
     }
     
+    /**
+     * Versión in-place: cada note-on raíz se sustituye por su acorde y el
+     * note-off de la raíz libera exactamente las notas que generó.
+     */
+    void process(MidiEventBuffer& events, const BlockContext&) {
+        for (size_t i = 0; i < events.size(); ++i) {
+            const MidiEvent e = events[i];  // Copia: add() desplaza eventos posteriores
+            if ((e.flags & MidiEvent::kGenerated) || !e.isNoteOnOrOff()) continue;
+            
+            events[i].flags |= MidiEvent::kRemove;
+            const int root = e.getNoteNumber();
+            auto& chord = heldChords_[root];
+            
+            if (e.isNoteOn()) {
+                chord = buildChord(root);
+                for (int n = 0; n < chord.count; ++n) {
+                    events.add(MidiEvent::noteOn(e.getChannel(), chord.notes[n],
+                                                 spreadVelocity(e.getVelocity()), e.samplePosition).generated());
+                }
+            } else {
+                for (int n = 0; n < chord.count; ++n) {
+                    events.add(MidiEvent::noteOff(e.getChannel(), chord.notes[n], e.samplePosition).generated());
+                }
+                chord.count = 0;
+            }
+        }
+        events.commitStage();
+    }
+    
 private:
-    std::vector<int> getIntervals(ChordType type) {
+    struct Chord {
+        std::array<int, 5> notes {};
+        int count { 0 };
+    };
+    
+    Chord buildChord(int rootNote) const {
+        auto intervals = getIntervals(params_.type);
+        
+        // Apply inversion
+        if (params_.inversion > 0) {
+            std::rotate(intervals.values.begin(), 
+                       intervals.values.begin() + std::min(params_.inversion, intervals.count), 
+                       intervals.values.begin() + intervals.count);
+            // Transpose inverted notes up an octave
+            for (int i = 0; i < params_.inversion && i < intervals.count; ++i) {
+                intervals.values[intervals.count - 1 - i] += 12;
+            }
+        }
+        
+        Chord chord;
+        for (int i = 0; i < intervals.count; ++i) {
+            int note = rootNote + intervals.values[i] + params_.octaveSpread * 12;
+            if (note >= 0 && note <= 127) {
+                chord.notes[chord.count++] = note;
+            }
+        }
+        return chord;
+    }
+    
+    uint8_t spreadVelocity(uint8_t velocity) const {
+        if (params_.velocitySpread <= 0.0f) return velocity;
+        float random = juce::Random::getSystemRandom().nextFloat() - 0.5f;
+        return (uint8_t)juce::jlimit(1, 127, (int)(velocity + random * params_.velocitySpread * 127));
+    }
+    
+    struct Intervals {
+        std::array<int, 5> values {};
+        int count { 0 };
+    };
+    
+    static Intervals getIntervals(ChordType type) {
         switch (type) {
-            case ChordType::Major:       return {0, 4, 7};
-            case ChordType::Minor:       return {0, 3, 7};
-            case ChordType::Diminished:  return {0, 3, 6};
-            case ChordType::Augmented:   return {0, 4, 8};
-            case ChordType::Major7:      return {0, 4, 7, 11};
-            case ChordType::Minor7:      return {0, 3, 7, 10};
-            case ChordType::Dominant7:   return {0, 4, 7, 10};
-            case ChordType::Suspended2:  return {0, 2, 7};
-            case ChordType::Suspended4:  return {0, 5, 7};
-            case ChordType::Power5:      return {0, 7, 12};
-            case ChordType::Major9:      return {0, 4, 7, 11, 14};
-            case ChordType::Minor9:      return {0, 3, 7, 10, 14};
-            default:                     return {0, 4, 7};
+            case ChordType::Major:       return {{0, 4, 7}, 3};
+            case ChordType::Minor:       return {{0, 3, 7}, 3};
+            case ChordType::Diminished:  return {{0, 3, 6}, 3};
+            case ChordType::Augmented:   return {{0, 4, 8}, 3};
+            case ChordType::Major7:      return {{0, 4, 7, 11}, 4};
+            case ChordType::Minor7:      return {{0, 3, 7, 10}, 4};
+            case ChordType::Dominant7:   return {{0, 4, 7, 10}, 4};
+            case ChordType::Suspended2:  return {{0, 2, 7}, 3};
+            case ChordType::Suspended4:  return {{0, 5, 7}, 3};
+            case ChordType::Power5:      return {{0, 7, 12}, 3};
+            case ChordType::Major9:      return {{0, 4, 7, 11, 14}, 5};
+            case ChordType::Minor9:      return {{0, 3, 7, 10, 14}, 5};
+            default:                     return {{0, 4, 7}, 3};
         }
     }
     
     Parameters params_;
     std::set<int> activeNotes_;
+    std::array<Chord, 128> heldChords_ {};  // Acorde generado por cada raíz (ruta in-place)
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChordGenerator)
 };
@@ -373,6 +469,15 @@ public:
         buffer.swapWith(mapped);
     }
     
+    /** Versión in-place: sólo reescribe el número de nota, sin copiar eventos. */
+    void process(MidiEventBuffer& events, const BlockContext&) {
+        for (auto& e : events) {
+            if (e.isNoteOnOrOff()) {
+                e.setNoteNumber(mapToScale(e.getNoteNumber()));
+            }
+        }
+    }
+    
 private:
     void generateScaleNotes() {
         scaleIntervals_ = getScaleIntervals(scale_);
@@ -430,8 +535,64 @@ public:
         // Similar to arpeggiator but repeats held notes
     }
     
+    /**
+     * Versión in-place: mientras una nota está pulsada se re-dispara a la
+     * velocidad configurada; cada repetición lleva su note-off agendado.
+     */
+    void process(MidiEventBuffer& events, const BlockContext& ctx) {
+        if (!params_.enabled) return;
+        
+        for (const auto& e : events) {
+            const int note = e.getNoteNumber();
+            if (e.isNoteOn()) {
+                held_[note] = { e.getVelocity(), (uint8_t)e.getChannel(), 0,
+                                ctx.blockStartSample + e.samplePosition };
+            } else if (e.isNoteOff()) {
+                held_[note].velocity = 0;
+            }
+        }
+        
+        pending_.release(events, ctx);
+        
+        const double rateSamples = juce::jmax(1.0, params_.rate * ctx.samplesPerBeat());
+        const int64_t blockEnd = ctx.blockStartSample + ctx.numSamples;
+        
+        for (int note = 0; note < 128; ++note) {
+            auto& h = held_[note];
+            if (h.velocity == 0) continue;
+            
+            // La nota original suena en noteStart; las repeticiones siguen la rejilla de rate
+            int64_t next = h.noteStart + (int64_t)std::ceil((h.repeats + 1) * rateSamples);
+            while (next < blockEnd) {
+                ++h.repeats;
+                const float decay = 1.0f - juce::jmin(1.0f, h.repeats * params_.velocityDecay * 0.01f);
+                const int velocity = juce::roundToInt(h.velocity * decay);
+                if (velocity < 1) { h.velocity = 0; break; }
+                
+                const int offset = (int)juce::jmax((int64_t)0, next - ctx.blockStartSample);
+                // Cerrar la nota anterior justo antes de re-dispararla
+                events.add(MidiEvent::noteOff(h.channel, note, offset));
+                if (!events.add(MidiEvent::noteOn(h.channel, note, (uint8_t)velocity, offset))) break;
+                pending_.schedule(MidiEvent::noteOff(h.channel, note, 0), next + (int64_t)(rateSamples * params_.gate));
+                
+                next = h.noteStart + (int64_t)std::ceil((h.repeats + 1) * rateSamples);
+            }
+        }
+        
+        pending_.release(events, ctx);
+    }
+    
 private:
+    struct HeldNote {
+        uint8_t velocity { 0 };   // 0 = no pulsada
+        uint8_t channel { 1 };
+        int repeats { 0 };
+        int64_t noteStart { 0 };
+    };
+    
     Parameters params_;
+    std::array<HeldNote, 128> held_ {};
+    ScheduledEventQueue pending_ { 256 };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NoteRepeat)
 };
@@ -503,8 +664,73 @@ public:
         buffer.swapWith(randomized);
     }
     
+    /**
+     * Versión in-place. El note-off usa la misma transposición que recibió su
+     * note-on, y los eventos retrasados fuera del bloque se agendan.
+     */
+    void process(MidiEventBuffer& events, const BlockContext& ctx) {
+        auto& rand = juce::Random::getSystemRandom();
+        
+        for (auto& e : events) {
+            const int key = ((e.getChannel() - 1) << 7) | e.getNoteNumber();
+            
+            if (e.isNoteOn()) {
+                // Probability check
+                if (rand.nextFloat() > params_.probability) {
+                    e.flags |= MidiEvent::kRemove;
+                    transposed_[key] = kDropped;
+                    continue;
+                }
+                
+                if (params_.velocityAmount > 0.0f) {
+                    int velOffset = (rand.nextFloat() - 0.5f) * params_.velocityAmount * 127;
+                    e.setVelocity(e.getVelocity() + velOffset);
+                }
+                
+                int newNote = e.getNoteNumber();
+                if (params_.pitchRange > 0) {
+                    newNote = juce::jlimit(0, 127, newNote + rand.nextInt(
+                        juce::Range<int>(-params_.pitchRange, params_.pitchRange + 1)));
+                }
+                transposed_[key] = (int8_t)newNote;
+                e.setNoteNumber(newNote);
+            } else if (e.isNoteOff()) {
+                const int8_t mapped = transposed_[key];
+                if (mapped == kDropped) { e.flags |= MidiEvent::kRemove; }
+                else if (mapped >= 0) { e.setNoteNumber(mapped); }
+                transposed_[key] = -1;
+            }
+            
+            // Randomize timing
+            if (params_.timingAmount > 0.0f && !(e.flags & MidiEvent::kRemove)) {
+                int sampleOffset = (rand.nextFloat() - 0.5f) * params_.timingAmount * 0.001 * ctx.sampleRate;
+                const int newPosition = std::max(0, e.samplePosition + sampleOffset);
+                if (newPosition >= ctx.numSamples) {
+                    delayed_.schedule(e, ctx.blockStartSample + newPosition);
+                    e.flags |= MidiEvent::kRemove;
+                } else {
+                    e.samplePosition = newPosition;
+                }
+            }
+        }
+        
+        events.commitStage();
+        events.sortByTime();
+        delayed_.release(events, ctx);
+    }
+    
 private:
+    static constexpr int8_t kDropped = -2;
+    
     Parameters params_;
+    std::array<int8_t, 16 * 128> transposed_ = makeIdentityMap();  // -1 = sin nota activa
+    ScheduledEventQueue delayed_ { 256 };
+    
+    static std::array<int8_t, 16 * 128> makeIdentityMap() {
+        std::array<int8_t, 16 * 128> map {};
+        map.fill(-1);
+        return map;
+    }
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MIDIRandomizer)
 };
@@ -561,8 +787,56 @@ public:
         buffer.swapWith(echoed);
     }
     
+    /**
+     * Versión in-place: los ecos (note on y su note-off) se agendan en tiempo
+     * absoluto y se insertan en el bloque en que caen.
+     */
+    void process(MidiEventBuffer& events, const BlockContext& ctx) {
+        if (!params_.enabled) return;
+        
+        const int64_t delaySamples = (int64_t)(params_.delayTime * ctx.samplesPerBeat());
+        const size_t numInput = events.size();
+        
+        for (size_t i = 0; i < numInput; ++i) {
+            const auto& e = events[i];
+            if (!e.isNoteOnOrOff()) continue;
+            
+            const int64_t time = ctx.blockStartSample + e.samplePosition;
+            auto& owed = echoedNotes_[(size_t)((e.getChannel() - 1) * 128 + e.getNoteNumber())];
+            
+            if (e.isNoteOn()) {
+                float velocity = e.getVelocity();
+                for (int repeat = 1; repeat <= params_.numRepeats; ++repeat) {
+                    velocity *= params_.velocityDecay;
+                    if (velocity < 1.0f) break;
+                    
+                    // Cada eco reserva el hueco de su note-off: si el par no cabe,
+                    // el eco no suena
+                    if (echoes_.size() + reservedNoteOffs_ + 2 > echoes_.capacity()) break;
+                    
+                    MidiEvent echo = e;
+                    echo.setVelocity((int)velocity);
+                    echoes_.schedule(echo, time + delaySamples * repeat);
+                    ++reservedNoteOffs_;
+                    ++owed;
+                }
+            } else {
+                // Tantos note-offs como ecos de note-on quedaron sin cerrar en esa nota
+                for (int repeat = 1; owed > 0; ++repeat, --owed) {
+                    echoes_.schedule(e, time + delaySamples * repeat);
+                    --reservedNoteOffs_;
+                }
+            }
+        }
+        
+        echoes_.release(events, ctx);
+    }
+    
 private:
     Parameters params_;
+    ScheduledEventQueue echoes_ { 1024 };
+    std::array<uint16_t, 16 * 128> echoedNotes_ {};  // Ecos de note-on sin note-off, por canal y nota
+    size_t reservedNoteOffs_ { 0 };                   // Huecos de echoes_ apartados para esos note-offs
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MIDIEcho)
 };
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include "MIDIEventBuffer.h"
+#include "MIDIFX.h"
+#include "GrooveEngine.h"
+#include "../Utils/Atomic.h"
+
+namespace OmegaStudio {
+namespace Sequencer {
+namespace MIDIFX {
+
+/**
+ * @class ChainStage
+ * @brief Stage de una cadena de MIDI FX que trabaja in-place sobre MidiEventBuffer
+ */
+class ChainStage {
+public:
+    virtual ~ChainStage() = default;
+
+    virtual juce::String getName() const = 0;
+    virtual void process(MidiEventBuffer& events, const BlockContext& ctx) = 0;
+    virtual void reset() {}
+
+    /** Máximo de eventos que el stage puede añadir por bloque. */
+    void setEventBudget(int budget) { eventBudget_ = juce::jmax(0, budget); }
+    int getEventBudget() const { return eventBudget_; }
+
+    void setBypassed(bool bypassed) { bypassed_.store(bypassed, std::memory_order_relaxed); }
+    bool isBypassed() const { return bypassed_.load(std::memory_order_relaxed); }
+
+private:
+    int eventBudget_ { 128 };
+    std::atomic<bool> bypassed_ { false };
+};
+
+/**
+ * @class EffectStage
+ * @brief Adapta cualquier efecto de MIDIFX con process(MidiEventBuffer&, const BlockContext&)
+ */
+template <typename Effect>
+class EffectStage : public ChainStage {
+public:
+    explicit EffectStage(juce::String name) : name_(std::move(name)) {}
+
+    juce::String getName() const override { return name_; }
+    void process(MidiEventBuffer& events, const BlockContext& ctx) override { effect_.process(events, ctx); }
+
+    Effect& getEffect() { return effect_; }
+
+private:
+    juce::String name_;
+    Effect effect_;
+};
+
+/**
+ * @class GrooveStage
+ * @brief GrooveEngine como stage de la cadena
+ */
+class GrooveStage : public ChainStage {
+public:
+    juce::String getName() const override { return "Groove"; }
+    void process(MidiEventBuffer& events, const BlockContext& ctx) override { groove_.processEvents(events, ctx); }
+
+    GrooveEngine& getGrooveEngine() { return groove_; }
+
+private:
+    GrooveEngine groove_;
+};
+
+using ArpeggiatorStage = EffectStage<Arpeggiator>;
+using ChordStage       = EffectStage<ChordGenerator>;
+using ScaleStage       = EffectStage<ScaleMapper>;
+using NoteRepeatStage  = EffectStage<NoteRepeat>;
+using RandomizerStage  = EffectStage<MIDIRandomizer>;
+using EchoStage        = EffectStage<MIDIEcho>;
+
+/**
+ * @class MIDIFXChain
+ * @brief Cadena de stages por canal; el mismo buffer pasa por todos in-place
+ *
+ * Insertar/quitar stages ocurre en el message thread bajo un SpinLock muy corto
+ * (sólo se mueven punteros). El audio thread usa tryLock: si la cadena se está
+ * editando, ese bloque pasa sin procesar en lugar de esperar. Los stages
+ * retirados se devuelven al llamador para destruirlos fuera del audio thread.
+ */
+class MIDIFXChain {
+public:
+    static constexpr int kMaxStages = 8;
+
+    bool insertStage(int index, std::unique_ptr<ChainStage> stage) {
+        Omega::Utils::SpinLockGuard guard(lock_);
+        if (numStages_ >= kMaxStages || !stage) return false;
+
+        index = juce::jlimit(0, numStages_, index);
+        for (int i = numStages_; i > index; --i) {
+            stages_[i] = std::move(stages_[i - 1]);
+        }
+        stages_[index] = std::move(stage);
+        ++numStages_;
+        return true;
+    }
+
+    bool addStage(std::unique_ptr<ChainStage> stage) {
+        return insertStage(kMaxStages, std::move(stage));
+    }
+
+    std::unique_ptr<ChainStage> removeStage(int index) {
+        Omega::Utils::SpinLockGuard guard(lock_);
+        if (index < 0 || index >= numStages_) return nullptr;
+
+        auto removed = std::move(stages_[index]);
+        for (int i = index; i < numStages_ - 1; ++i) {
+            stages_[i] = std::move(stages_[i + 1]);
+        }
+        --numStages_;
+        return removed;
+    }
+
+    ChainStage* getStage(int index) const {
+        return (index >= 0 && index < numStages_) ? stages_[index].get() : nullptr;
+    }
+
+    int getNumStages() const { return numStages_; }
+
+    void process(MidiEventBuffer& events, const BlockContext& ctx) {
+        if (!lock_.tryLock()) return;
+
+        for (int i = 0; i < numStages_; ++i) {
+            auto& stage = *stages_[i];
+            if (stage.isBypassed()) continue;
+
+            events.beginStage(stage.getEventBudget());
+            stage.process(events, ctx);
+        }
+        events.endStage();
+
+        lock_.unlock();
+    }
+
+    void reset() {
+        Omega::Utils::SpinLockGuard guard(lock_);
+        for (int i = 0; i < numStages_; ++i) stages_[i]->reset();
+    }
+
+private:
+    std::array<std::unique_ptr<ChainStage>, kMaxStages> stages_;
+    int numStages_ { 0 };
+    Omega::Utils::SpinLock lock_;
+};
+
+/**
+ * @class MIDIFXRack
+ * @brief Una MIDIFXChain por canal MIDI con buffers de eventos preasignados
+ *
+ * processBlock reparte el juce::MidiBuffer de entrada por canal, ejecuta cada
+ * cadena sobre su buffer fijo y devuelve el resultado intercambiando buffers.
+ * Todo el almacenamiento se reserva en prepare().
+ */
+class MIDIFXRack {
+public:
+    static constexpr int kNumChannels = 16;
+
+    void prepare(double sampleRate, int maxBlockSize, size_t eventsPerChannel = 512) {
+        sampleRate_ = sampleRate;
+        for (auto& buffer : buffers_) buffer.prepare(eventsPerChannel);
+        scratchBytes_ = (size_t)kNumChannels * eventsPerChannel * 4;
+        scratch_.ensureSize(scratchBytes_);
+        juce::ignoreUnused(maxBlockSize);
+    }
+
+    void setTempo(double bpm) { tempo_ = bpm; }
+
+    /** channel en 1..16 */
+    MIDIFXChain& getChain(int channel) { return chains_[(size_t)juce::jlimit(1, kNumChannels, channel) - 1]; }
+
+    void processBlock(juce::MidiBuffer& midi, int numSamples, int64_t blockStartSample) {
+        BlockContext ctx { sampleRate_, tempo_, numSamples, blockStartSample };
+
+        for (auto& buffer : buffers_) buffer.clear();
+        for (const auto metadata : midi) {
+            const auto* raw = metadata.data;
+            if (metadata.numBytes < 1 || metadata.numBytes > 3 || raw[0] < 0x80 || raw[0] >= 0xf0) continue;
+
+            MidiEvent e;
+            e.samplePosition = metadata.samplePosition;
+            e.status = raw[0];
+            e.data1 = metadata.numBytes > 1 ? raw[1] : 0;
+            e.data2 = metadata.numBytes > 2 ? raw[2] : 0;
+            buffers_[raw[0] & 0x0f].add(e);
+        }
+
+        // SysEx y mensajes de sistema pasan sin tocar
+        scratch_.clear();
+        for (const auto metadata : midi) {
+            if (metadata.numBytes > 3 || metadata.data[0] >= 0xf0)
+                scratch_.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+        }
+
+        for (int ch = 0; ch < kNumChannels; ++ch) {
+            chains_[(size_t)ch].process(buffers_[(size_t)ch], ctx);
+            buffers_[(size_t)ch].writeTo(scratch_);
+        }
+
+        // Intercambio en vez de copia: copiar haría crecer el buffer del host en el
+        // audio thread. scratch_ hereda el almacenamiento del host y solo reserva
+        // si es menor que el de prepare(); como el host reutiliza su buffer, los
+        // dos almacenamientos se alternan y eso ocurre a lo sumo en el primer bloque
+        midi.swapWith(scratch_);
+        scratch_.ensureSize(scratchBytes_);
+    }
+
+    int getDroppedEvents() const {
+        int dropped = 0;
+        for (const auto& buffer : buffers_) dropped += buffer.getDroppedEvents();
+        return dropped;
+    }
+
+private:
+    std::array<MIDIFXChain, kNumChannels> chains_;
+    std::array<MidiEventBuffer, kNumChannels> buffers_;
+    juce::MidiBuffer scratch_;
+    size_t scratchBytes_ { 0 };
+    double sampleRate_ { 44100.0 };
+    double tempo_ { 120.0 };
+};
+
+} // namespace MIDIFX
+} // namespace Sequencer
+} // namespace OmegaStudio
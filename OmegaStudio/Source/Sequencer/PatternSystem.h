@@ -4,10 +4,27 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include "../Utils/Atomic.h"
+#include "../Audio/DSP/StreamingTimeStretch.h"
 
 namespace OmegaStudio {
 namespace Sequencer {
 
+/**
+ * @brief Estado de carga de un clip para lanzarlo sin tocar disco
+ */
+enum class LaunchReadiness {
+    Empty,      // Slot sin clip
+    NotLoaded,  // Clip en disco, todavía no precargado
+    Loading,    // Precarga en curso en el loader
+    Ready,      // Cabeza del clip en memoria: lanzable sin latencia
+    Error       // No se pudo abrir el archivo
+};
+
 /**
  * @class Clip
  * @brief Clip de audio o MIDI reutilizable
@@ -48,6 +65,8 @@ public:
                                  double playheadPosition,
                                  double tempo) = 0;
     
+    virtual LaunchReadiness getLaunchReadiness() const { return LaunchReadiness::Ready; }
+    
 protected:
     juce::String name_;
     Type type_;
@@ -136,6 +155,16 @@ private:
 /**
  * @class AudioClip
  * @brief Clip de audio
+ *
+ * Puede sostener el audio completo en memoria (setAudioBuffer) o apuntar a un
+ * archivo (setSourceFile). En el segundo caso ClipPrefetcher carga en segundo
+ * plano los primeros segundos en memoria y deja el resto en un
+ * BufferingAudioReader con timeout 0: el callback nunca lee de disco y, si el
+ * stream no llegó a tiempo, rinde silencio en lugar de bloquear.
+ *
+ * Con warp activo el clip sigue al tempo sin cambiar el pitch: un
+ * WarpedClipPlayer estira en streaming en lugar de pre-renderizar copias.
+ * Lo configuran el message thread y el loader; warpLock_ serializa esas llamadas.
  */
 class AudioClip : public Clip {
 public:
@@ -144,23 +173,149 @@ public:
     }
     
     void setAudioBuffer(const juce::AudioBuffer<float>& buffer, double sampleRate) {
+        const std::lock_guard<std::mutex> warpGuard(warpLock_);
+        warpPlayer_.setSource(nullptr);   // El player suelta el buffer antes de reemplazarlo
         audioBuffer_.makeCopyOf(buffer);
         audioSampleRate_ = sampleRate;
+        warpPlayer_.setSource(&bufferSource_);
+        warpPlayer_.setWarp(warpMarkers_, warpTempo_, sampleRate);
+    }
+    
+    /**
+     * Warp: el clip sigue al tempo de la sesión sin cambiar el pitch.
+     * Requiere el audio al sample rate de la sesión; si no, el clip sigue en
+     * modo varispeed.
+     * @param originalTempo Tempo del audio (BPM)
+     * @param markers Marcadores sample -> beat (vacío: tempo constante)
+     */
+    void setWarp(bool enabled, double originalTempo, const std::vector<Audio::DSP::WarpMarker>& markers = {}) {
+        const std::lock_guard<std::mutex> warpGuard(warpLock_);
+        warpTempo_ = originalTempo;
+        warpMarkers_ = markers;
+        warpPlayer_.setWarp(warpMarkers_, warpTempo_, audioSampleRate_);
+        warpEnabled_.store(enabled);
+    }
+    
+    bool isWarpEnabled() const { return warpEnabled_.load(); }
+    
+    /** Clip respaldado por archivo; la precarga la hace ClipPrefetcher. */
+    void setSourceFile(const juce::File& file) {
+        std::unique_ptr<StreamedSource> old;
+        {
+            Omega::Utils::SpinLockGuard guard(streamLock_);
+            old = std::move(stream_);
+        }
+        sourceFile_ = file;
+        readiness_.store(file.existsAsFile() ? LaunchReadiness::NotLoaded : LaunchReadiness::Error);
+    }
+    
+    const juce::File& getSourceFile() const { return sourceFile_; }
+    bool isStreamed() const { return sourceFile_ != juce::File(); }
+    
+    LaunchReadiness getLaunchReadiness() const override {
+        return isStreamed() ? readiness_.load() : LaunchReadiness::Ready;
+    }
+    
+    /** Marca el clip como en carga; false si ya estaba cargando o listo. */
+    bool beginPrefetch() {
+        auto expected = LaunchReadiness::NotLoaded;
+        return readiness_.compare_exchange_strong(expected, LaunchReadiness::Loading);
+    }
+    
+    /**
+     * Ejecutado en el thread del loader: abre el archivo, lee headSeconds en
+     * memoria y deja el resto en streaming sobre streamThread.
+     */
+    void prefetch(juce::AudioFormatManager& formats, juce::TimeSliceThread& streamThread, double headSeconds) {
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(sourceFile_));
+        if (reader == nullptr) {
+            readiness_.store(LaunchReadiness::Error);
+            return;
+        }
+        
+        auto source = std::make_unique<StreamedSource>();
+        source->sampleRate = reader->sampleRate;
+        source->totalSamples = reader->lengthInSamples;
+        
+        const int headSamples = (int)juce::jmin<juce::int64>(reader->lengthInSamples,
+                                                             (juce::int64)(headSeconds * reader->sampleRate));
+        source->head.setSize((int)juce::jmax(1u, reader->numChannels), juce::jmax(1, headSamples));
+        reader->read(&source->head, 0, headSamples, 0, true, true);
+        source->headSamples = headSamples;
+        
+        // El stream empieza a bufferizar justo donde termina la cabeza
+        auto* buffering = new juce::BufferingAudioReader(reader.release(), streamThread,
+                                                         (int)(kStreamBufferSeconds * source->sampleRate));
+        buffering->setReadTimeout(0);
+        source->tail.reset(buffering);
+        if (headSamples < source->totalSamples) {
+            juce::AudioBuffer<float> warmup(source->head.getNumChannels(), 1);
+            source->tail->read(&warmup, 0, 1, headSamples, true, true);
+        }
+        
+        // Marcadores y tempo los puede estar cambiando setWarp en el message thread
+        std::unique_ptr<StreamedSource> old;
+        {
+            const std::lock_guard<std::mutex> warpGuard(warpLock_);
+            {
+                Omega::Utils::SpinLockGuard guard(streamLock_);
+                old = std::move(stream_);
+                stream_ = std::move(source);
+                audioSampleRate_ = stream_->sampleRate;
+            }
+            warpPlayer_.setSource(&streamSource_);
+            warpPlayer_.setWarp(warpMarkers_, warpTempo_, audioSampleRate_);
+        }
+        readiness_.store(LaunchReadiness::Ready);
+    }
+    
+    /** Libera la cabeza y el stream (por ejemplo, al salir de la ventana de escenas). */
+    void releasePrefetch() {
+        std::unique_ptr<StreamedSource> old;
+        {
+            Omega::Utils::SpinLockGuard guard(streamLock_);
+            old = std::move(stream_);
+        }
+        if (isStreamed()) readiness_.store(LaunchReadiness::NotLoaded);
     }
     
     void prepareToPlay(double sampleRate, int samplesPerBlock) override {
         playbackSampleRate_ = sampleRate;
         readPosition_ = 0.0;
+        
+        // Ventana de lectura para el modo streaming (ratio de resampling hasta 4x)
+        scratch_.setSize(juce::jmax(2, audioBuffer_.getNumChannels()), samplesPerBlock * 4 + 4);
+        const std::lock_guard<std::mutex> warpGuard(warpLock_);
+        warpPlayer_.prepare(sampleRate, samplesPerBlock, 2);
     }
     
     void renderNextBlock(juce::AudioBuffer<float>& buffer, 
                         juce::MidiBuffer& /*midiMessages*/,
                         double playheadPosition,
                         double tempo) override {
-        if (muted_ || audioBuffer_.getNumSamples() == 0) return;
+        if (muted_) return;
+        
+        if (isStreamed()) {
+            // Nunca esperar al loader en el audio thread
+            if (!streamLock_.tryLock()) return;
+            if (stream_ != nullptr) {
+                if (canWarp(stream_->sampleRate))
+                    renderWarped(buffer, playheadPosition, tempo);
+                else
+                    renderStreamed(buffer, *stream_, playheadPosition, tempo);
+            }
+            streamLock_.unlock();
+            return;
+        }
+        
+        if (audioBuffer_.getNumSamples() == 0) return;
+        
+        if (canWarp(audioSampleRate_)) {
+            renderWarped(buffer, playheadPosition, tempo);
+            return;
+        }
         
         double samplesPerBeat = (60.0 / tempo) * playbackSampleRate_;
-        double clipLengthSamples = lengthBeats_ * samplesPerBeat;
         
         // Calculate clip position
         double clipPosition = std::fmod(playheadPosition - startOffset_, lengthBeats_);
@@ -197,10 +352,151 @@ public:
     }
     
 private:
+    static constexpr double kStreamBufferSeconds = 4.0;
+    
+    struct StreamedSource {
+        juce::AudioBuffer<float> head;                    // Primeros segundos en memoria
+        int headSamples { 0 };
+        std::unique_ptr<juce::AudioFormatReader> tail;    // BufferingAudioReader, timeout 0
+        juce::int64 totalSamples { 0 };
+        double sampleRate { 44100.0 };
+    };
+    
+    /** Lee el clip en streaming (cabeza + stream) para el stretcher; solo bajo streamLock_ */
+    class StreamStretchSource : public Audio::DSP::StretchSource {
+    public:
+        explicit StreamStretchSource(AudioClip& owner) : owner_(owner) {}
+        
+        int getNumChannels() const override {
+            return owner_.stream_ != nullptr ? owner_.stream_->head.getNumChannels() : 1;
+        }
+        
+        int64_t getLengthInSamples() const override {
+            return owner_.stream_ != nullptr ? owner_.stream_->totalSamples : 0;
+        }
+        
+        void read(float* const* destination, int numChannels, int64_t start, int count) override {
+            owner_.readStream(destination, numChannels, start, count);
+        }
+        
+        // El stream solo se lee desde el audio (bajo streamLock_): sin caché de fondo
+        bool supportsBackgroundReads() const override { return false; }
+        
+    private:
+        AudioClip& owner_;
+    };
+    
+    bool canWarp(double sourceSampleRate) const {
+        return warpEnabled_.load(std::memory_order_relaxed) && sourceSampleRate == playbackSampleRate_;
+    }
+    
+    void renderWarped(juce::AudioBuffer<float>& buffer, double playheadPosition, double tempo) {
+        // El loop del clip es su longitud en beats, como en el modo varispeed
+        warpPlayer_.process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples(),
+                            playheadPosition - startOffset_, tempo, lengthBeats_);
+    }
+    
+    void readStream(float* const* destination, int numChannels, int64_t start, int count) {
+        const int window = scratch_.getNumSamples();
+        int done = 0;
+        
+        // Los frames del stretcher pueden superar scratch_: por trozos
+        while (done < count) {
+            const juce::int64 pos = start + done;
+            int chunk = window > 0 ? juce::jmin(count - done, window) : count - done;
+            
+            if (pos < 0 || stream_ == nullptr || window == 0) {
+                if (pos < 0) chunk = (int)juce::jmin<juce::int64>(chunk, -pos);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::clear(destination[ch] + done, chunk);
+            } else {
+                fetchSource(*stream_, pos, chunk, false);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::copy(destination[ch] + done,
+                                                      scratch_.getReadPointer(juce::jmin(ch, scratch_.getNumChannels() - 1)), chunk);
+            }
+            done += chunk;
+        }
+    }
+    
+    void renderStreamed(juce::AudioBuffer<float>& buffer, StreamedSource& source,
+                        double playheadPosition, double tempo) {
+        if (source.totalSamples <= 0) return;
+        
+        const double samplesPerBeat = (60.0 / tempo) * playbackSampleRate_;
+        double clipPosition = std::fmod(playheadPosition - startOffset_, lengthBeats_);
+        if (clipPosition < 0.0) clipPosition += lengthBeats_;
+        
+        const double ratio = source.sampleRate / playbackSampleRate_;
+        const double srcPosition = clipPosition * samplesPerBeat * ratio;
+        const auto srcStart = (juce::int64)srcPosition;
+        const int numSamples = buffer.getNumSamples();
+        const int srcCount = juce::jmin(scratch_.getNumSamples(), (int)std::ceil(numSamples * ratio) + 2);
+        
+        fetchSource(source, srcStart, srcCount, loopEnabled_);
+        
+        const int numChannels = juce::jmin(buffer.getNumChannels(), scratch_.getNumChannels());
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* src = scratch_.getReadPointer(ch);
+            float* dst = buffer.getWritePointer(ch);
+            double pos = srcPosition - (double)srcStart;
+            
+            for (int i = 0; i < numSamples; ++i, pos += ratio) {
+                const int index = (int)pos;
+                if (index + 1 >= srcCount) break;
+                const float fraction = (float)(pos - index);
+                dst[i] += src[index] + fraction * (src[index + 1] - src[index]);
+            }
+        }
+    }
+    
+    /** Copia count samples de la fuente a scratch_ desde memoria (cabeza) o el stream bufferizado. */
+    void fetchSource(StreamedSource& source, juce::int64 start, int count, bool wrap) {
+        const int srcChannels = source.head.getNumChannels();
+        int written = 0;
+        
+        while (written < count) {
+            juce::int64 pos = start + written;
+            if (wrap) pos %= source.totalSamples;
+            if (pos >= source.totalSamples) break;
+            
+            int chunk = (int)juce::jmin<juce::int64>(count - written, source.totalSamples - pos);
+            
+            if (pos < source.headSamples) {
+                chunk = juce::jmin(chunk, source.headSamples - (int)pos);
+                for (int ch = 0; ch < scratch_.getNumChannels(); ++ch)
+                    scratch_.copyFrom(ch, written, source.head, juce::jmin(ch, srcChannels - 1), (int)pos, chunk);
+            } else if (source.tail != nullptr) {
+                // Timeout 0: si el stream no está listo devuelve silencio, no lee de disco
+                source.tail->read(&scratch_, written, chunk, pos, true, true);
+            } else {
+                scratch_.clear(written, chunk);
+            }
+            written += chunk;
+        }
+        
+        if (written < count) scratch_.clear(written, count - written);
+    }
+    
     juce::AudioBuffer<float> audioBuffer_;
     double audioSampleRate_ { 44100.0 };
     double playbackSampleRate_ { 44100.0 };
     double readPosition_ { 0.0 };
+    
+    juce::File sourceFile_;
+    std::atomic<LaunchReadiness> readiness_ { LaunchReadiness::Ready };
+    std::unique_ptr<StreamedSource> stream_;
+    Omega::Utils::SpinLock streamLock_;
+    juce::AudioBuffer<float> scratch_;
+    
+    // Warp: el player se destruye primero y suelta las fuentes
+    std::atomic<bool> warpEnabled_ { false };
+    std::mutex warpLock_;   // warpTempo_, warpMarkers_ y toda llamada de configuración al player
+    double warpTempo_ { 120.0 };
+    std::vector<Audio::DSP::WarpMarker> warpMarkers_;
+    Audio::DSP::BufferStretchSource bufferSource_ { audioBuffer_ };
+    StreamStretchSource streamSource_ { *this };
+    Audio::DSP::WarpedClipPlayer warpPlayer_;
 };
 
 /**
@@ -217,15 +513,38 @@ public:
     
     std::shared_ptr<Clip> getClip() { return clip_; }
     
+    LaunchReadiness getReadiness() const {
+        return clip_ != nullptr ? clip_->getLaunchReadiness() : LaunchReadiness::Empty;
+    }
+    
+    void prepareToPlay(double sampleRate, int samplesPerBlock) {
+        sampleRate_ = sampleRate;
+        sectionMidi_.ensureSize(1024);
+        if (clip_ != nullptr) clip_->prepareToPlay(sampleRate, samplesPerBlock);
+    }
+    
     void trigger() {
+        triggerAt(0);
+    }
+    
+    /** Arranca el clip en un offset exacto del próximo bloque procesado. */
+    void triggerAt(int sampleOffset) {
         if (clip_ != nullptr) {
             isPlaying_ = true;
             playheadPosition_ = 0.0;
+            startOffset_ = juce::jmax(0, sampleOffset);
+            stopOffset_ = -1;
         }
     }
     
     void stop() {
         isPlaying_ = false;
+        stopOffset_ = -1;
+    }
+    
+    /** Detiene el clip en un offset exacto del próximo bloque procesado. */
+    void stopAt(int sampleOffset) {
+        if (isPlaying_) stopOffset_ = juce::jmax(0, sampleOffset);
     }
     
     bool isPlaying() const { return isPlaying_; }
@@ -233,11 +552,32 @@ public:
     void process(juce::AudioBuffer<float>& buffer, 
                 juce::MidiBuffer& midiMessages,
                 double tempo) {
-        if (isPlaying_ && clip_ != nullptr) {
-            clip_->renderNextBlock(buffer, midiMessages, playheadPosition_, tempo);
+        if (!isPlaying_ || clip_ == nullptr) return;
+        
+        const int numSamples = buffer.getNumSamples();
+        const int begin = juce::jmin(startOffset_, numSamples);
+        const int end = stopOffset_ >= 0 ? juce::jlimit(begin, numSamples, stopOffset_) : numSamples;
+        
+        if (end > begin) {
+            if (begin == 0 && end == numSamples) {
+                clip_->renderNextBlock(buffer, midiMessages, playheadPosition_, tempo);
+            } else {
+                // Vista sobre el tramo del bloque: sin copias ni heap (JUCE usa espacio preasignado)
+                juce::AudioBuffer<float> section(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                                 begin, end - begin);
+                sectionMidi_.clear();
+                clip_->renderNextBlock(section, sectionMidi_, playheadPosition_, tempo);
+                midiMessages.addEvents(sectionMidi_, 0, -1, begin);
+            }
             
-            double samplesPerBeat = (60.0 / tempo) * 44100.0;  // TODO: Get actual sample rate
-            playheadPosition_ += buffer.getNumSamples() / samplesPerBeat;
+            double samplesPerBeat = (60.0 / tempo) * sampleRate_;
+            playheadPosition_ += (end - begin) / samplesPerBeat;
+        }
+        
+        startOffset_ = 0;
+        if (stopOffset_ >= 0) {
+            isPlaying_ = false;
+            stopOffset_ = -1;
         }
     }
     
@@ -245,6 +585,10 @@ private:
     std::shared_ptr<Clip> clip_;
     bool isPlaying_ { false };
     double playheadPosition_ { 0.0 };
+    double sampleRate_ { 44100.0 };
+    int startOffset_ { 0 };   // Inicio dentro del próximo bloque
+    int stopOffset_ { -1 };   // Fin dentro del próximo bloque (-1 = sigue sonando)
+    juce::MidiBuffer sectionMidi_;
 };
 
 /**
@@ -269,10 +613,16 @@ public:
     
     int getNumSlots() const { return slots_.size(); }
     
-    void triggerAll() {
+    void prepareToPlay(double sampleRate, int samplesPerBlock) {
+        for (auto& slot : slots_) {
+            slot.prepareToPlay(sampleRate, samplesPerBlock);
+        }
+    }
+    
+    void triggerAll(int sampleOffset = 0) {
         for (auto& slot : slots_) {
             if (slot.getClip() != nullptr) {
-                slot.trigger();
+                slot.triggerAt(sampleOffset);
             }
         }
     }
@@ -283,6 +633,22 @@ public:
         }
     }
     
+    void stopAllAt(int sampleOffset) {
+        for (auto& slot : slots_) {
+            slot.stopAt(sampleOffset);
+        }
+    }
+    
+    /** Clips de audio de la escena (para la precarga). */
+    template <typename Callback>
+    void forEachAudioClip(Callback&& callback) {
+        for (auto& slot : slots_) {
+            if (auto clip = std::dynamic_pointer_cast<AudioClip>(slot.getClip())) {
+                callback(clip);
+            }
+        }
+    }
+    
 private:
     juce::String name_;
     std::vector<ClipSlot> slots_;
@@ -324,14 +690,26 @@ public:
         return nullptr;
     }
     
+    void prepareToPlay(double sampleRate, int samplesPerBlock) {
+        for (auto& scene : scenes_) {
+            scene->prepareToPlay(sampleRate, samplesPerBlock);
+        }
+    }
+    
     void triggerScene(int sceneIndex) {
+        launchSceneAt(sceneIndex, 0);
+    }
+    
+    /** Cambia de escena en un offset exacto del próximo bloque (audio thread). */
+    void launchSceneAt(int sceneIndex, int sampleOffset) {
         if (sceneIndex >= 0 && sceneIndex < (int)scenes_.size()) {
             // Stop currently playing scene
-            if (currentScene_ >= 0 && currentScene_ < (int)scenes_.size()) {
-                scenes_[currentScene_]->stopAll();
+            if (currentScene_ >= 0 && currentScene_ < (int)scenes_.size() && currentScene_ != sceneIndex) {
+                scenes_[currentScene_]->stopAllAt(sampleOffset);
+                stoppingScene_ = currentScene_;
             }
             
-            scenes_[sceneIndex]->triggerAll();
+            scenes_[sceneIndex]->triggerAll(sampleOffset);
             currentScene_ = sceneIndex;
         }
     }
@@ -341,13 +719,232 @@ public:
             scene->stopAll();
         }
         currentScene_ = -1;
+        stoppingScene_ = -1;
     }
     
     int getCurrentScene() const { return currentScene_; }
     
+    /** Escena que termina de sonar en este bloque tras un cambio cuantizado. */
+    int getStoppingScene() const { return stoppingScene_; }
+    void clearStoppingScene() { stoppingScene_ = -1; }
+    
 private:
     std::vector<std::unique_ptr<Scene>> scenes_;
     int currentScene_ { -1 };
+    int stoppingScene_ { -1 };
+};
+
+/**
+ * @class ClipPrefetcher
+ * @brief Loader en segundo plano para clips de audio respaldados por archivo
+ *
+ * Un ThreadPool lee la cabeza de cada clip; un TimeSliceThread alimenta los
+ * BufferingAudioReader del resto. Nada de esto corre en el audio thread.
+ * Lleva la cuenta de los clips precargados para soltar los que salen del
+ * horizonte de lanzamiento (releaseOutside); si no, cada clip lanzado alguna
+ * vez seguiría ocupando su cabeza y su stream.
+ */
+class ClipPrefetcher {
+public:
+    ClipPrefetcher() : pool_(1), streamThread_("Clip Streaming") {
+        formats_.registerBasicFormats();
+        streamThread_.startThread(juce::Thread::Priority::high);
+    }
+    
+    ~ClipPrefetcher() {
+        pool_.removeAllJobs(true, 5000);
+        streamThread_.stopThread(2000);
+    }
+    
+    void setHeadSeconds(double seconds) { headSeconds_ = juce::jmax(0.5, seconds); }
+    double getHeadSeconds() const { return headSeconds_; }
+    
+    /** Encola la precarga si el clip no está cargado ni cargándose (message thread). */
+    void prefetch(std::shared_ptr<AudioClip> clip) {
+        if (clip == nullptr || !clip->isStreamed() || !clip->beginPrefetch()) return;
+        
+        resident_.push_back(clip);
+        pool_.addJob([this, clip] {
+            clip->prefetch(formats_, streamThread_, headSeconds_);
+        });
+    }
+    
+    /**
+     * Suelta la precarga de los clips que no están en horizon (message thread).
+     * Los que aún se están cargando esperan a la próxima llamada: soltarlos
+     * ahora dejaría que el loader los marcase listos sin que nadie los siguiera.
+     */
+    void releaseOutside(const std::vector<std::shared_ptr<AudioClip>>& horizon) {
+        auto keep = std::partition(resident_.begin(), resident_.end(), [&](const std::shared_ptr<AudioClip>& clip) {
+            return clip->getLaunchReadiness() == LaunchReadiness::Loading
+                || std::find(horizon.begin(), horizon.end(), clip) != horizon.end();
+        });
+        for (auto it = keep; it != resident_.end(); ++it) {
+            (*it)->releasePrefetch();
+        }
+        resident_.erase(keep, resident_.end());
+    }
+    
+    int getNumPendingJobs() const { return pool_.getNumJobs(); }
+    int getNumResidentClips() const { return (int)resident_.size(); }
+    
+private:
+    juce::AudioFormatManager formats_;
+    juce::ThreadPool pool_;
+    juce::TimeSliceThread streamThread_;
+    double headSeconds_ { 8.0 };
+    std::vector<std::shared_ptr<AudioClip>> resident_;   // Precargados o cargándose
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipPrefetcher)
+};
+
+/**
+ * @class ClipLaunchScheduler
+ * @brief Lanzamiento cuantizado y sample-accurate de escenas/clips
+ *
+ * queueScene() (message thread) precarga la escena pedida y sus vecinas y deja
+ * la petición en un atómico. process() (audio thread) resuelve el próximo
+ * límite de cuantización sobre la rejilla de tempo y, si cae dentro del bloque,
+ * cambia de escena en ese sample exacto.
+ *
+ * El horizonte de precarga es la escena pedida y sus vecinas, más la que suena
+ * y la que sigue en cola; los clips de fuera se liberan en cada prefetchAround().
+ */
+class ClipLaunchScheduler {
+public:
+    enum class Quantization { None, Beat, Bar, TwoBars, FourBars };
+    
+    ClipLaunchScheduler(SessionView& session, ClipPrefetcher& prefetcher)
+        : session_(session), prefetcher_(prefetcher) {
+    }
+    
+    void setQuantization(Quantization q, int beatsPerBar = 4) {
+        quantization_ = q;
+        beatsPerBar_ = juce::jmax(1, beatsPerBar);
+    }
+    
+    /** Escenas a cada lado de la pedida que también se precargan. */
+    void setPrefetchNeighbours(int count) { neighbours_ = juce::jmax(0, count); }
+    
+    void prepareToPlay(double sampleRate, int samplesPerBlock) {
+        sampleRate_ = sampleRate;
+        session_.prepareToPlay(sampleRate, samplesPerBlock);
+    }
+    
+    void queueScene(int sceneIndex) {
+        if (session_.getScene(sceneIndex) == nullptr) return;
+        
+        prefetchAround(sceneIndex);
+        pendingScene_.store(sceneIndex, std::memory_order_release);
+    }
+    
+    /**
+     * Precarga la escena y sus vecinas sin lanzarla (p.ej. al seleccionarla en
+     * la UI) y libera los clips que quedan fuera del horizonte.
+     */
+    void prefetchAround(int sceneIndex) {
+        std::vector<std::shared_ptr<AudioClip>> horizon;
+        auto collect = [&](int index) {
+            if (auto* scene = session_.getScene(index)) {
+                scene->forEachAudioClip([&](std::shared_ptr<AudioClip> clip) {
+                    horizon.push_back(clip);
+                });
+            }
+        };
+        
+        for (int i = sceneIndex - neighbours_; i <= sceneIndex + neighbours_; ++i) {
+            collect(i);
+        }
+        for (auto& clip : horizon) {
+            prefetcher_.prefetch(clip);
+        }
+        
+        // La cola antes que la que suena: process() publica la escena lanzada
+        // antes de vaciar la cola, así que una de las dos la incluye
+        collect(pendingScene_.load(std::memory_order_acquire));
+        collect(playingScene_.load(std::memory_order_acquire));
+        prefetcher_.releaseOutside(horizon);
+    }
+    
+    int getQueuedScene() const { return pendingScene_.load(std::memory_order_acquire); }
+    
+    LaunchReadiness getSlotReadiness(int track, int scene) {
+        auto* slot = session_.getClipSlot(track, scene);
+        return slot != nullptr ? slot->getReadiness() : LaunchReadiness::Empty;
+    }
+    
+    /** true si todos los clips de la escena pueden lanzarse sin tocar disco. */
+    bool isSceneReady(int sceneIndex) {
+        auto* scene = session_.getScene(sceneIndex);
+        if (scene == nullptr) return false;
+        
+        for (int i = 0; i < scene->getNumSlots(); ++i) {
+            auto readiness = scene->getSlot(i).getReadiness();
+            if (readiness != LaunchReadiness::Ready && readiness != LaunchReadiness::Empty) return false;
+        }
+        return true;
+    }
+    
+    double getQuantizationBeats() const {
+        switch (quantization_) {
+            case Quantization::Beat:     return 1.0;
+            case Quantization::Bar:      return beatsPerBar_;
+            case Quantization::TwoBars:  return beatsPerBar_ * 2.0;
+            case Quantization::FourBars: return beatsPerBar_ * 4.0;
+            case Quantization::None:
+            default:                     return 0.0;
+        }
+    }
+    
+    /** Próximo límite de cuantización en o después de beat. */
+    double getNextLaunchBeat(double beat) const {
+        const double q = getQuantizationBeats();
+        if (q <= 0.0) return beat;
+        return std::ceil(beat / q - 1.0e-9) * q;
+    }
+    
+    /** Audio thread: resuelve lanzamientos pendientes y procesa los slots activos. */
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
+                 double transportBeat, double tempo) {
+        const int numSamples = buffer.getNumSamples();
+        const double samplesPerBeat = (60.0 / tempo) * sampleRate_;
+        
+        const int pending = pendingScene_.load(std::memory_order_acquire);
+        if (pending >= 0) {
+            const double launchBeat = getNextLaunchBeat(transportBeat);
+            const double offset = (launchBeat - transportBeat) * samplesPerBeat;
+            
+            if (offset < numSamples) {
+                session_.launchSceneAt(pending, (int)std::llround(juce::jmax(0.0, offset)));
+                playingScene_.store(pending, std::memory_order_release);
+                int expected = pending;
+                pendingScene_.compare_exchange_strong(expected, -1, std::memory_order_acq_rel);
+            }
+        }
+        
+        if (auto* stopping = session_.getScene(session_.getStoppingScene())) {
+            for (int i = 0; i < stopping->getNumSlots(); ++i) {
+                stopping->getSlot(i).process(buffer, midiMessages, tempo);
+            }
+            session_.clearStoppingScene();
+        }
+        
+        if (auto* scene = session_.getScene(session_.getCurrentScene())) {
+            for (int i = 0; i < scene->getNumSlots(); ++i) {
+                scene->getSlot(i).process(buffer, midiMessages, tempo);
+            }
+        }
+    }
+    
+private:
+    SessionView& session_;
+    ClipPrefetcher& prefetcher_;
+    Quantization quantization_ { Quantization::Bar };
+    int beatsPerBar_ { 4 };
+    int neighbours_ { 1 };
+    double sampleRate_ { 44100.0 };
+    std::atomic<int> pendingScene_ { -1 };
+    std::atomic<int> playingScene_ { -1 };    // Última escena lanzada por process()
 };
 
 /**
@@ -434,6 +1031,15 @@ public:
     
     SessionView& getSessionView() { return sessionView_; }
     ArrangementView& getArrangementView() { return arrangementView_; }
+    ClipLaunchScheduler& getLaunchScheduler() { return launcher_; }
+    ClipPrefetcher& getPrefetcher() { return prefetcher_; }
+    
+    void prepareToPlay(double sampleRate, int samplesPerBlock) {
+        launcher_.prepareToPlay(sampleRate, samplesPerBlock);
+        for (auto& clip : clips_) {
+            clip->prepareToPlay(sampleRate, samplesPerBlock);
+        }
+    }
     
     void process(juce::AudioBuffer<float>& buffer, 
                 juce::MidiBuffer& midiMessages,
@@ -441,15 +1047,8 @@ public:
                 double tempo) {
         
         if (viewMode_ == ViewMode::Session) {
-            // Process session view
-            if (sessionView_.getCurrentScene() >= 0) {
-                auto* scene = sessionView_.getScene(sessionView_.getCurrentScene());
-                if (scene != nullptr) {
-                    for (int i = 0; i < scene->getNumSlots(); ++i) {
-                        scene->getSlot(i).process(buffer, midiMessages, tempo);
-                    }
-                }
-            }
+            // Process session view (lanzamientos cuantizados incluidos)
+            launcher_.process(buffer, midiMessages, playheadPosition, tempo);
         } else {
             // Process arrangement view
             arrangementView_.process(buffer, midiMessages, playheadPosition, tempo);
@@ -473,6 +1072,8 @@ private:
     SessionView sessionView_;
     ArrangementView arrangementView_;
     std::vector<std::shared_ptr<Clip>> clips_;
+    ClipPrefetcher prefetcher_;
+    ClipLaunchScheduler launcher_ { sessionView_, prefetcher_ };
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatternSystem)
 };
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include "GrooveEngine.h"
+
+namespace OmegaStudio {
+namespace Sequencer {
+
+/**
+ * @class StepScheduler
+ * @brief Scheduler aritmético de steps con precisión de sample
+ *
+ * La posición de cada step se calcula en forma cerrada:
+ *   inicio(n) = anchorSample + (n - anchorStep) * stepLength + swing(n) + groove(n)
+ * Así el coste de un bloque depende del número de steps que caen dentro de él,
+ * no del tamaño del buffer, y los offsets son exactos aunque el bloque sea de 32 samples.
+ *
+ * Los cambios de tempo re-anclan la rejilla en el sample donde ocurren, de modo
+ * que la fase del step en curso se conserva. La rejilla es del audio thread: la
+ * UI pide el tempo con requestTempo() y el bloque siguiente lo aplica al empezar,
+ * re-anclando en su propio sample. Un step que la rejilla vieja aún no había
+ * emitido nunca se pierde ni se repite por el redondeo del nuevo anclaje.
+ *
+ * Swing y groove se editan desde la UI mientras el audio thread programa steps:
+ * los offsets precalculados viven en dos copias y se publican con un índice
+ * atómico, así el bloque en curso nunca ve una tabla a medio reconstruir.
+ */
+class StepScheduler {
+public:
+    struct StepEvent {
+        int64_t stepNumber { 0 };    // Step absoluto desde el inicio del transporte
+        int stepIndex { 0 };         // stepNumber % patternLength
+        int sampleOffset { 0 };      // Offset dentro del bloque [0, numSamples)
+        float velocityScale { 1.0f };// Multiplicador de velocity del groove
+    };
+
+    StepScheduler() = default;
+
+    void prepare(double sampleRate, double tempo, int stepsPerBeat = 4) {
+        sampleRate_ = sampleRate;
+        stepsPerBeat_ = juce::jmax(1, stepsPerBeat);
+        tempo_.store(juce::jmax(1.0, tempo));
+        pendingTempo_.store(0.0);
+        stepLength_ = computeStepLength(tempo_.load());
+        anchorStep_ = 0.0;
+        anchorSample_ = 0.0;
+        nextStep_ = -1;
+        reanchored_ = false;
+        rebuildOffsets();
+    }
+
+    /**
+     * Cambia el tempo conservando la fase del step en el sample indicado.
+     * Hilo de audio (o sin bloques en curso); desde la UI, requestTempo().
+     */
+    void setTempo(double bpm, int64_t atSample = 0) {
+        bpm = juce::jmax(1.0, bpm);
+        if (bpm == tempo_.load()) return;
+
+        anchorStep_ = getStepPositionAt(atSample);
+        anchorSample_ = (double)atSample;
+        reanchored_ = true;
+        tempo_.store(bpm);
+        stepLength_ = computeStepLength(bpm);
+    }
+
+    /** Cualquier hilo: el tempo se aplica al inicio del próximo bloque. */
+    void requestTempo(double bpm) { pendingTempo_.store(juce::jmax(1.0, bpm)); }
+
+    /** Hilo de audio, al inicio del bloque: aplica el último tempo pedido. */
+    void applyPendingTempo(int64_t blockStart) {
+        const double bpm = pendingTempo_.exchange(0.0);
+        if (bpm > 0.0)
+            setTempo(bpm, blockStart);
+    }
+
+    /** Hilo de audio: el step 0 vuelve a caer en el sample 0 (reinicio del transporte). */
+    void resetPosition() {
+        anchorStep_ = 0.0;
+        anchorSample_ = 0.0;
+        nextStep_ = -1;
+        reanchored_ = false;
+    }
+
+    /** Swing estilo MPC: los steps impares se retrasan swing * stepLength / 2. */
+    void setSwing(float swing) {
+        swing_ = juce::jlimit(0.0f, 1.0f, swing);
+        rebuildOffsets();
+    }
+
+    /** Copia el template de groove; timing en ms y velocity se aplican escalados por amount. */
+    void setGroove(const GrooveTemplate& groove, float amount = 1.0f) {
+        groove_ = groove;
+        grooveAmount_ = juce::jlimit(0.0f, 1.0f, amount);
+        hasGroove_ = groove_.steps > 0;
+        rebuildOffsets();
+    }
+
+    void clearGroove() {
+        hasGroove_ = false;
+        rebuildOffsets();
+    }
+
+    void setPatternLength(int steps) { patternLength_ = juce::jmax(1, steps); }
+    int getPatternLength() const { return patternLength_; }
+
+    double getTempo() const { return tempo_.load(); }
+    double getStepLengthSamples() const { return stepLength_; }
+
+    /** Posición fraccional (en steps, sin swing ni groove) de un sample absoluto. */
+    double getStepPositionAt(int64_t sample) const {
+        return anchorStep_ + ((double)sample - anchorSample_) / stepLength_;
+    }
+
+    /** Sample absoluto en que suena el step n, con swing y groove aplicados. */
+    int64_t getStepStartSample(int64_t stepNumber) const {
+        const auto start = getStepStartSample(stepNumber, acquireOffsets());
+        releaseOffsets();
+        return start;
+    }
+
+    /**
+     * Invoca callback(const StepEvent&) para cada step cuyo inicio cae en
+     * [blockStart, blockStart + numSamples). Devuelve el número de steps emitidos.
+     * Aplica antes el tempo pendiente, así que es del hilo de audio.
+     */
+    template <typename Callback>
+    int forEachStepInBlock(int64_t blockStart, int numSamples, Callback&& callback) {
+        applyPendingTempo(blockStart);
+        if (numSamples <= 0 || stepLength_ <= 0.0) return 0;
+
+        const auto& offsets = acquireOffsets();
+        const double blockEnd = (double)(blockStart + numSamples);
+        // El inicio se redondea al sample: un step medio sample antes del bloque suena en él
+        const auto first = (int64_t)std::ceil(anchorStep_ + ((double)blockStart - 0.5 - anchorSample_) / stepLength_
+                                              - offsets.swingSteps - offsets.maxLate / stepLength_);
+        const auto last = (int64_t)std::floor(anchorStep_ + (blockEnd - anchorSample_) / stepLength_
+                                              + offsets.maxEarly / stepLength_);
+
+        // Tras re-anclar, un step que la rejilla vieja dejaba para este bloque puede
+        // redondear antes de él con el tempo nuevo: suena en su primer sample
+        const bool catchUp = std::exchange(reanchored_, false) && nextStep_ >= 0;
+
+        int emitted = 0;
+        for (int64_t n = juce::jmax((int64_t)0, catchUp ? first - 1 : first, nextStep_); n <= last; ++n) {
+            const int64_t start = getStepStartSample(n, offsets);
+            if ((start < blockStart && !catchUp) || (double)start >= blockEnd) continue;
+
+            StepEvent event;
+            event.stepNumber = n;
+            event.stepIndex = (int)(n % patternLength_);
+            event.sampleOffset = (int)juce::jmax((int64_t)0, start - blockStart);
+            event.velocityScale = getVelocityScale(n, offsets);
+            callback(event);
+            nextStep_ = n + 1;
+            ++emitted;
+        }
+        releaseOffsets();
+        return emitted;
+    }
+
+private:
+    // Todo lo que el bucle de bloque necesita además de la rejilla. No depende
+    // del tempo (swing en steps, groove en samples): un cambio de tempo no la reconstruye
+    struct Offsets {
+        double swingSteps { 0.0 };
+        std::vector<double> groove;     // Vacío = sin groove
+        std::vector<float> velocity;
+        float grooveAmount { 1.0f };
+        double maxLate { 0.0 };         // Mayor retraso del groove (samples)
+        double maxEarly { 0.0 };        // Mayor adelanto del groove (samples)
+    };
+
+    // Anuncia la copia que se va a leer y confirma que sigue publicada; si la
+    // UI publicó entre medias no esperó por esta, así que se toma la nueva
+    const Offsets& acquireOffsets() const {
+        int current = liveOffsets_.load();
+        for (;;) {
+            readingOffsets_.store(current);
+            const int latest = liveOffsets_.load();
+            if (latest == current) break;
+            current = latest;
+        }
+        return offsets_[(size_t)current];
+    }
+
+    void releaseOffsets() const { readingOffsets_.store(-1); }
+
+    double computeStepLength(double bpm) const {
+        return (60.0 / bpm) * sampleRate_ / (double)stepsPerBeat_;
+    }
+
+    double getGridSample(int64_t stepNumber) const {
+        return anchorSample_ + ((double)stepNumber - anchorStep_) * stepLength_;
+    }
+
+    int64_t getStepStartSample(int64_t stepNumber, const Offsets& offsets) const {
+        return (int64_t)std::llround(getGridSample(stepNumber) + getStepOffset(stepNumber, offsets));
+    }
+
+    double getStepOffset(int64_t stepNumber, const Offsets& offsets) const {
+        double offset = (stepNumber & 1) ? offsets.swingSteps * stepLength_ : 0.0;
+        if (!offsets.groove.empty())
+            offset += offsets.groove[(size_t)(stepNumber % (int64_t)offsets.groove.size())];
+        return offset;
+    }
+
+    static float getVelocityScale(int64_t stepNumber, const Offsets& offsets) {
+        if (offsets.groove.empty() || offsets.velocity.empty()) return 1.0f;
+        const float v = offsets.velocity[(size_t)(stepNumber % (int64_t)offsets.velocity.size())];
+        return 1.0f + (v - 1.0f) * offsets.grooveAmount;
+    }
+
+    // Precalcula los offsets en samples para que el bucle de bloque sea sólo
+    // aritmética. Se escribe la copia que no está publicada (esperando, si
+    // hace falta, a que el bloque que aún la lee termine) y luego se publica
+    void rebuildOffsets() {
+        const int next = 1 - liveOffsets_.load();
+        while (readingOffsets_.load() == next)
+            juce::Thread::yield();
+
+        auto& offsets = offsets_[(size_t)next];
+        offsets.swingSteps = swing_ * 0.5;
+        offsets.groove.clear();
+        offsets.velocity.clear();
+        offsets.grooveAmount = grooveAmount_;
+
+        if (hasGroove_ && !groove_.timing.empty()) {
+            for (float ms : groove_.timing)
+                offsets.groove.push_back(ms * 0.001 * sampleRate_ * grooveAmount_);
+            offsets.velocity = groove_.velocity;
+        } else {
+            hasGroove_ = false;
+        }
+
+        double late = 0.0, early = 0.0;
+        for (double o : offsets.groove) {
+            late = juce::jmax(late, o);
+            early = juce::jmax(early, -o);
+        }
+        offsets.maxLate = late;
+        offsets.maxEarly = early;
+
+        liveOffsets_.store(next);
+    }
+
+    double sampleRate_ { 44100.0 };
+    std::atomic<double> tempo_ { 120.0 };
+    std::atomic<double> pendingTempo_ { 0.0 };    // 0 = nada pendiente
+    int stepsPerBeat_ { 4 };
+    int patternLength_ { 16 };
+    double stepLength_ { 5512.5 };
+
+    // Rejilla anclada: el step anchorStep_ cae exactamente en anchorSample_.
+    // Solo la escribe el hilo de audio (o prepare, sin bloques en curso)
+    double anchorStep_ { 0.0 };
+    double anchorSample_ { 0.0 };
+    bool reanchored_ { false };
+    int64_t nextStep_ { -1 };      // Primer step sin emitir; -1 = transporte recién puesto a 0
+
+    // Parámetros tal como los dejó la UI
+    float swing_ { 0.0f };
+    GrooveTemplate groove_;
+    float grooveAmount_ { 1.0f };
+    bool hasGroove_ { false };
+
+    // Lo que lee el audio thread: offsets_[liveOffsets_]
+    std::array<Offsets, 2> offsets_ {};
+    std::atomic<int> liveOffsets_ { 0 };
+    mutable std::atomic<int> readingOffsets_ { -1 };
+};
+
+} // namespace Sequencer
+} // namespace OmegaStudio
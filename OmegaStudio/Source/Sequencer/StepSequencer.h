@@ -3,8 +3,10 @@
 #include <JuceHeader.h>
 #include <vector>
 #include <array>
+#include <atomic>
 #include <memory>
 #include <functional>
+#include "StepScheduler.h"
 
 namespace OmegaStudio {
 namespace Sequencer {
@@ -205,6 +207,10 @@ private:
 /**
  * @class StepSequencerEngine
  * @brief Motor del step sequencer con swing, humanización y playback
+ *
+ * Los límites de step se obtienen de StepScheduler en forma cerrada; las notas
+ * (ratchets y note-offs incluidos) se guardan con tiempo absoluto en samples y
+ * se emiten en el offset exacto del bloque en que caen.
  */
 class StepSequencerEngine {
 public:
@@ -219,21 +225,31 @@ public:
     
     void prepare(const Config& config) {
         config_ = config;
+        scheduler_.prepare(config_.sampleRate, config_.tempo, juce::jmax(1, config_.subdivision / 4));
+        scheduler_.setSwing(swing_);
         calculateStepLength();
+        pendingNotes_.reserve(kMaxPendingNotes);
         reset();
     }
     
     void setPattern(std::shared_ptr<StepPattern> pattern) {
         pattern_ = pattern;
+        if (pattern_) scheduler_.setPatternLength(pattern_->getNumSteps());
     }
     
+    // Se aplica al inicio del próximo bloque, en el sample del audio thread
     void setTempo(double tempo) {
         config_.tempo = tempo;
-        calculateStepLength();
+        scheduler_.requestTempo(tempo);
     }
     
     void setSwing(float swing) {
         swing_ = juce::jlimit(0.0f, 1.0f, swing);
+        scheduler_.setSwing(swing_);
+    }
+    
+    void setGroove(const GrooveTemplate& groove, float amount = 1.0f) {
+        scheduler_.setGroove(groove, amount);
     }
     
     void setHumanize(float amount) {
@@ -248,37 +264,49 @@ public:
         currentStep_ = 0;
         samplePosition_ = 0;
         isPlaying_ = false;
+        restartRequested_ = false;
+        pendingNotes_.clear();
     }
     
+    // El transporte vuelve a 0 al inicio del próximo bloque: la posición es del audio thread
     void start() {
+        restartRequested_ = true;
         isPlaying_ = true;
-        currentStep_ = 0;
     }
     
+    // Las notas que suenan se cortan en el próximo bloque: la cola es del audio thread
     void stop() {
         isPlaying_ = false;
-        sendAllNotesOff();
+        notesOffRequested_ = true;
     }
     
     // Process audio block y generar MIDI events
     void process(juce::MidiBuffer& midiMessages, int numSamples) {
-        if (!isPlaying_ || !pattern_) return;
+        const bool flushNotes = notesOffRequested_.exchange(false);
+        if (!flushNotes && (!isPlaying_ || !pattern_)) return;
         
         midiMessages.clear();
+        if (flushNotes)
+            sendAllNotesOff(midiMessages);
         
-        for (int sample = 0; sample < numSamples; ++sample) {
-            // Check if we hit a step
-            if (samplePosition_ >= stepLengthSamples_) {
-                triggerCurrentStep(midiMessages, sample);
-                advanceStep();
-                samplePosition_ = 0;
-            }
-            
-            samplePosition_++;
+        if (!isPlaying_ || !pattern_) return;
+        
+        if (restartRequested_.exchange(false)) {
+            currentStep_ = 0;
+            samplePosition_ = 0;
+            scheduler_.resetPosition();
         }
+        scheduler_.applyPendingTempo(samplePosition_);
+        calculateStepLength();
+        scheduler_.forEachStepInBlock(samplePosition_, numSamples,
+            [&](const StepScheduler::StepEvent& e) {
+                currentStep_ = e.stepIndex % pattern_->getNumSteps();
+                triggerCurrentStep(samplePosition_ + e.sampleOffset, e.velocityScale);
+                listeners_.call([this](Listener& l) { l.stepChanged(currentStep_); });
+            });
         
-        // Note offs
-        processNoteOffs(midiMessages, numSamples);
+        emitPendingNotes(midiMessages, numSamples);
+        samplePosition_ += numSamples;
     }
     
     int getCurrentStep() const { return currentStep_; }
@@ -299,34 +327,24 @@ public:
     }
     
 private:
-    void calculateStepLength() {
-        // Samples per quarter note
-        double samplesPerQuarter = (60.0 / config_.tempo) * config_.sampleRate;
-        // Samples per 16th note
-        stepLengthSamples_ = samplesPerQuarter / 4.0;
-    }
+    static constexpr size_t kMaxPendingNotes = 1024;
     
-    void advanceStep() {
-        currentStep_ = (currentStep_ + 1) % pattern_->getNumSteps();
-        listeners_.call([this](Listener& l) { l.stepChanged(currentStep_); });
+    void calculateStepLength() {
+        stepLengthSamples_ = scheduler_.getStepLengthSamples();
     }
     
-    void triggerCurrentStep(juce::MidiBuffer& buffer, int sampleOffset) {
+    void triggerCurrentStep(int64_t stepSample, float velocityScale) {
         for (int track = 0; track < pattern_->getNumTracks(); ++track) {
             const auto& step = pattern_->getStep(track, currentStep_);
             
             if (step.shouldTrigger()) {
-                triggerStep(buffer, track, step, sampleOffset);
+                triggerStep(step, stepSample, velocityScale);
             }
         }
     }
     
-    void triggerStep(juce::MidiBuffer& buffer, int track, const Step& step, int offset) {
-        // Apply swing
-        int swingOffset = 0;
-        if (currentStep_ % 2 == 1) {  // Odd steps get swing
-            swingOffset = swing_ * stepLengthSamples_ * 0.5;
-        }
+    void triggerStep(const Step& step, int64_t stepSample, float velocityScale) {
+        // Swing y groove ya vienen aplicados por el scheduler
         
         // Apply humanize
         int humanizeOffset = 0;
@@ -341,81 +359,89 @@ private:
         // Apply micro-timing
         int microOffset = step.microTiming;
         
-        int finalOffset = offset + swingOffset + humanizeOffset + microOffset;
-        finalOffset = std::max(0, finalOffset);
+        // Nunca antes del inicio del step: ese bloque ya fue emitido
+        int64_t noteStart = stepSample + std::max(0, humanizeOffset + microOffset);
         
-        // Note On
-        uint8_t velocity = step.getVelocity();
-        buffer.addEvent(juce::MidiMessage::noteOn(
-            config_.midiChannel, 
-            step.noteNumber, 
-            velocity
-        ), finalOffset);
+        float velocity = juce::jlimit(1.0f, 127.0f, step.getVelocity() * velocityScale);
         
-        // Schedule Note Off
-        int noteLength = stepLengthSamples_ * gate_;
         if (step.ratcheting > 1) {
             // Ratcheting: trigger múltiples veces
-            int ratchetLength = stepLengthSamples_ / step.ratcheting;
+            int64_t ratchetLength = (int64_t)(stepLengthSamples_ / step.ratcheting);
             for (int r = 0; r < step.ratcheting; ++r) {
-                int ratchetOffset = finalOffset + r * ratchetLength;
-                buffer.addEvent(juce::MidiMessage::noteOn(
-                    config_.midiChannel,
-                    step.noteNumber,
-                    velocity * (1.0f - r * 0.1f)  // Decay velocity
-                ), ratchetOffset);
-                
-                scheduleNoteOff(step.noteNumber, ratchetOffset + ratchetLength * gate_);
+                int64_t ratchetStart = noteStart + r * ratchetLength;
+                scheduleNote(step.noteNumber,
+                             (uint8_t)juce::jmax(1.0f, velocity * (1.0f - r * 0.1f)),  // Decay velocity
+                             ratchetStart,
+                             ratchetStart + (int64_t)(ratchetLength * gate_));
             }
         } else {
-            scheduleNoteOff(step.noteNumber, finalOffset + noteLength);
+            scheduleNote(step.noteNumber, (uint8_t)velocity, noteStart,
+                         noteStart + (int64_t)(stepLengthSamples_ * gate_));
         }
     }
     
-    void scheduleNoteOff(uint8_t noteNumber, int timeStamp) {
-        activeNotes_.push_back({noteNumber, timeStamp});
+    void scheduleNote(uint8_t noteNumber, uint8_t velocity, int64_t onSample, int64_t offSample) {
+        if (pendingNotes_.size() >= kMaxPendingNotes) return;  // Nunca realocar en el audio thread
+        pendingNotes_.push_back({ noteNumber, velocity, onSample, std::max(onSample + 1, offSample), false });
     }
     
-    void processNoteOffs(juce::MidiBuffer& buffer, int numSamples) {
-        for (auto it = activeNotes_.begin(); it != activeNotes_.end();) {
-            it->timeRemaining -= numSamples;
-            if (it->timeRemaining <= 0) {
-                buffer.addEvent(juce::MidiMessage::noteOff(
-                    config_.midiChannel,
-                    it->noteNumber
-                ), 0);
-                it = activeNotes_.erase(it);
+    void emitPendingNotes(juce::MidiBuffer& buffer, int numSamples) {
+        const int64_t blockEnd = samplePosition_ + numSamples;
+        
+        for (size_t i = 0; i < pendingNotes_.size();) {
+            auto& note = pendingNotes_[i];
+            
+            if (!note.started && note.onSample < blockEnd) {
+                buffer.addEvent(juce::MidiMessage::noteOn(config_.midiChannel, note.noteNumber, note.velocity),
+                                (int)juce::jmax((int64_t)0, note.onSample - samplePosition_));
+                note.started = true;
+            }
+            
+            if (note.started && note.offSample < blockEnd) {
+                buffer.addEvent(juce::MidiMessage::noteOff(config_.midiChannel, note.noteNumber),
+                                (int)juce::jmax((int64_t)0, note.offSample - samplePosition_));
+                // Swap-and-pop: el orden en el MidiBuffer lo da el timestamp
+                note = pendingNotes_.back();
+                pendingNotes_.pop_back();
             } else {
-                ++it;
+                ++i;
             }
         }
     }
     
-    void sendAllNotesOff() {
-        for (const auto& note : activeNotes_) {
-            // Send note off immediately
+    // Note-off al inicio del bloque para cada nota ya emitida; las no empezadas se descartan
+    void sendAllNotesOff(juce::MidiBuffer& buffer) {
+        for (const auto& note : pendingNotes_) {
+            if (note.started)
+                buffer.addEvent(juce::MidiMessage::noteOff(config_.midiChannel, note.noteNumber), 0);
         }
-        activeNotes_.clear();
+        pendingNotes_.clear();
     }
     
-    struct ActiveNote {
+    struct PendingNote {
         uint8_t noteNumber;
-        int timeRemaining;
+        uint8_t velocity;
+        int64_t onSample;   // Tiempo absoluto en samples
+        int64_t offSample;
+        bool started;
     };
     
     Config config_;
     std::shared_ptr<StepPattern> pattern_;
+    StepScheduler scheduler_;
     
     int currentStep_ { 0 };
     int64_t samplePosition_ { 0 };
     double stepLengthSamples_ { 0.0 };
-    bool isPlaying_ { false };
+    std::atomic<bool> isPlaying_ { false };
+    std::atomic<bool> restartRequested_ { false };
     
     float swing_ { 0.0f };
     float humanize_ { 0.0f };
     float gate_ { 0.8f };
     
-    std::vector<ActiveNote> activeNotes_;
+    std::vector<PendingNote> pendingNotes_;
+    std::atomic<bool> notesOffRequested_ { false };
     juce::ListenerList<Listener> listeners_;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StepSequencerEngine)
@@ -0,0 +1,299 @@
+#include <JuceHeader.h>
+#include "../Audio/Analysis/AnalysisTapService.h"
+#include <chrono>
+#include <thread>
+
+using namespace OmegaStudio;
+
+class AnalysisTapServiceTest : public juce::UnitTest {
+public:
+    AnalysisTapServiceTest() : juce::UnitTest("AnalysisTapService", "DSP") {}
+
+    void runTest() override {
+        // Sample n carries n (left) and -n (right), modulo 2^23 so floats stay exact
+        constexpr juce::uint64 period = 1 << 23;
+        auto valueAt = [](juce::uint64 n) { return (float) (n % period); };
+
+        auto makeRamp = [&](juce::uint64 first, int numSamples) {
+            juce::AudioBuffer<float> block(2, juce::jmax(1, numSamples));
+            for (int i = 0; i < numSamples; ++i) {
+                block.setSample(0, i, valueAt(first + (juce::uint64) i));
+                block.setSample(1, i, -valueAt(first + (juce::uint64) i));
+            }
+            return block;
+        };
+
+        // The service only activates a tap once something listens to it; it is never
+        // started, so the test thread is the tap's only consumer
+        auto activate = [](AnalysisTapService& service, AnalysisTap* tap) {
+            service.attach(tap, std::make_shared<SnapshotAnalyzer<int>>(nullptr,
+                                                                        [](const juce::AudioBuffer<float>&) {},
+                                                                        [](int&) {}));
+        };
+
+        beginTest("Ring wraps, and resyncs to half a ring behind the writer after an overrun");
+        {
+            AnalysisTapService service;
+            auto* tap = service.createTap("Ring", 2, 4096);
+            const int capacity = 4096, margin = capacity / 4;
+
+            juce::AudioBuffer<float> dest(2, 8192);
+            juce::uint64 written = 0, expected = 0;
+
+            // Nothing listens yet: push() copies nothing
+            tap->push(makeRamp(0, 512));
+            expectEquals(tap->read(dest, 8192), 0);
+            activate(service, tap);
+
+            auto push = [&](int numSamples) {
+                tap->push(makeRamp(written, numSamples));
+                written += (juce::uint64) numSamples;
+            };
+
+            // Reads continue exactly where the last one stopped, also across the wrap
+            auto readAll = [&](int maxSamples) {
+                int total = 0;
+                for (int count = tap->read(dest, maxSamples); count > 0; count = tap->read(dest, maxSamples)) {
+                    bool contiguous = true;
+                    for (int i = 0; i < count; ++i) {
+                        contiguous = contiguous && dest.getSample(0, i) == valueAt(expected + (juce::uint64) i)
+                                                && dest.getSample(1, i) == -valueAt(expected + (juce::uint64) i);
+                    }
+                    expect(contiguous, "Read of " + juce::String(count) + " at " + juce::String((juce::int64) expected));
+                    expected += (juce::uint64) count;
+                    total += count;
+                }
+                return total;
+            };
+
+            for (int round = 0; round < 20; ++round) {
+                push(700);
+                push(333);
+                readAll(517);
+            }
+            expectEquals((juce::int64) expected, (juce::int64) written);
+            expectEquals((juce::int64) tap->getDroppedSamples(), (juce::int64) 0);
+
+            // A backlog of capacity - margin is still readable in full
+            for (int i = 0; i < (capacity - margin) / 512; ++i)
+                push(512);
+            expectEquals(readAll(8192), capacity - margin);
+            expectEquals((juce::int64) tap->getDroppedSamples(), (juce::int64) 0);
+
+            // One sample more and the reader jumps to half a ring behind the writer
+            for (int i = 0; i < (capacity - margin) / 512; ++i)
+                push(512);
+            push(1);
+            const auto dropped = written - (juce::uint64) (capacity / 2) - expected;
+            expected = written - (juce::uint64) (capacity / 2);
+            expectEquals(readAll(8192), capacity / 2);
+            expectEquals((juce::int64) tap->getDroppedSamples(), (juce::int64) dropped);
+
+            // A block larger than the ring keeps only its end
+            const auto before = tap->getDroppedSamples();
+            tap->push(makeRamp(written, 3 * capacity + 100));
+            written += (juce::uint64) (3 * capacity + 100);
+            expected = written - (juce::uint64) (capacity / 2);
+            expectEquals(readAll(8192), capacity / 2);
+            expectEquals((juce::int64) (tap->getDroppedSamples() - before), (juce::int64) (capacity / 2));
+
+            // Mono into a stereo tap fills both channels
+            juce::AudioBuffer<float> mono(1, 64);
+            for (int i = 0; i < 64; ++i)
+                mono.setSample(0, i, 0.25f);
+            tap->push(mono);
+            expectEquals(tap->read(dest, 8192), 64);
+            expectEquals(dest.getSample(0, 63), 0.25f);
+            expectEquals(dest.getSample(1, 63), 0.25f);
+        }
+
+        beginTest("Concurrent producer: every block read is contiguous, every lost sample is counted");
+        {
+            AnalysisTapService service;
+            auto* tap = service.createTap("Concurrent", 2, 4096);
+            activate(service, tap);
+            const int capacity = 4096, margin = capacity / 4;
+            const juce::uint64 total = 4000000;
+
+            // The consumer asks for a stall and waits; the producer answers with two rings
+            // of audio in a row, so the reader is overrun once per request
+            enum { running, stallRequested, finished };
+            std::atomic<int> state { running };
+            std::atomic<juce::uint64> written { 0 }, consumed { 0 };
+            std::thread audio([&] {
+                juce::Random random(33);
+                int nextBlock = margin;
+                juce::AudioBuffer<float> block(2, margin);
+                auto push = [&](int numSamples) {
+                    for (int i = 0; i < numSamples; ++i) {
+                        block.setSample(0, i, valueAt(written + (juce::uint64) i));
+                        block.setSample(1, i, -valueAt(written + (juce::uint64) i));
+                    }
+                    tap->push(block.getArrayOfReadPointers(), 2, numSamples);
+                    written += (juce::uint64) numSamples;
+                };
+
+                for (;;) {
+                    if (state.load() == stallRequested) {
+                        for (int i = 0; i < 2 * capacity / margin; ++i)
+                            push(margin);
+                        state.store(running);
+                    }
+
+                    if (written >= total) {
+                        int expectedState = running;
+                        if (state.compare_exchange_strong(expectedState, finished))
+                            break;
+                        continue;
+                    }
+
+                    // Blocks up to the margin, as the audio thread's blocks are, kept just
+                    // under the overrun line whatever the number of cores
+                    if (written + (juce::uint64) nextBlock - consumed.load() > (juce::uint64) (capacity - margin)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    push(nextBlock);
+                    nextBlock = 1 + random.nextInt(margin);
+                }
+            });
+
+            juce::Random random(34);
+            juce::AudioBuffer<float> dest(2, 2048);
+            juce::uint64 expected = 0, lastDropped = 0;
+            int reads = 0, stalls = 0, tornBlocks = 0, miscounted = 0;
+            for (;;) {
+                const bool producerFinished = state.load() == finished;
+                const int count = tap->read(dest, 1 + random.nextInt(2048));
+                expected += tap->getDroppedSamples() - lastDropped;
+                lastDropped = tap->getDroppedSamples();
+
+                if (count == 0) {
+                    if (producerFinished)
+                        break;
+                    continue;
+                }
+
+                ++reads;
+                if (dest.getSample(0, 0) != valueAt(expected))
+                    ++miscounted;
+                const auto first = (juce::uint64) dest.getSample(0, 0);
+                for (int i = 0; i < count; ++i) {
+                    if (dest.getSample(0, i) != valueAt(first + (juce::uint64) i)
+                        || dest.getSample(1, i) != -valueAt(first + (juce::uint64) i)) {
+                        ++tornBlocks;
+                        break;
+                    }
+                }
+                expected += (juce::uint64) count;
+                consumed.store(first + (juce::uint64) count);
+
+                int expectedState = running;
+                if (reads % 64 == 0 && stalls < 32 && state.compare_exchange_strong(expectedState, stallRequested)) {
+                    ++stalls;
+                    while (state.load() == stallRequested)
+                        std::this_thread::yield();
+                }
+            }
+            audio.join();
+
+            logMessage(juce::String(reads) + " reads, " + juce::String(stalls) + " forced overruns, "
+                       + juce::String((juce::int64) lastDropped) + " samples dropped");
+            expectEquals(tornBlocks, 0);
+            expectEquals(miscounted, 0, "A jump in the data must match the dropped count");
+            expectGreaterThan(stalls, 0);
+            expectGreaterOrEqual((juce::int64) lastDropped, (juce::int64) (stalls * capacity));
+            expectEquals((juce::int64) expected, (juce::int64) written.load());
+        }
+
+        beginTest("Double-buffered snapshot: readers never see a half-published result");
+        {
+            // Large enough that filling or copying a frame spans a thread switch, even on one core
+            struct Frame { std::vector<juce::int64> values = std::vector<juce::int64>(1 << 16); };
+            DoubleBufferedSnapshot<Frame> snapshot;
+
+            // The analysis thread keeps publishing until the readers have raced it enough
+            const int minReads = 3000;
+            std::atomic<bool> done { false };
+            std::atomic<int> torn { 0 }, backwards { 0 }, reads { 0 };
+            int published = 0, skipped = 0;
+
+            std::thread analysis([&] {
+                for (juce::int64 n = 1; reads.load() < minReads; ++n) {
+                    if (snapshot.publish([n](Frame& frame) { std::fill(frame.values.begin(), frame.values.end(), n); }))
+                        ++published;
+                    else if (++skipped % 64 == 0)
+                        std::this_thread::yield();
+                }
+                done.store(true);
+            });
+
+            std::vector<std::thread> readers;
+            for (int r = 0; r < 3; ++r) {
+                readers.emplace_back([&] {
+                    juce::int64 last = 0;
+                    while (!done.load()) {
+                        const auto frame = snapshot.read();
+                        const auto value = frame.values.front();
+                        if (std::any_of(frame.values.begin(), frame.values.end(), [value](juce::int64 v) { return v != value; }))
+                            ++torn;
+                        if (value < last)
+                            ++backwards;
+                        last = value;
+                        ++reads;
+                    }
+                });
+            }
+
+            analysis.join();
+            for (auto& reader : readers)
+                reader.join();
+
+            logMessage(juce::String(published) + " published, " + juce::String(skipped) + " skipped while read, "
+                       + juce::String(reads.load()) + " reads");
+            expectEquals(torn.load(), 0);
+            expectEquals(backwards.load(), 0, "Readers must never go back to an older result");
+            expectEquals((juce::int64) snapshot.getVersion(), (juce::int64) published);
+
+            // With no readers left, the next publication always lands and is what a read returns
+            expect(snapshot.publish([](Frame& frame) { std::fill(frame.values.begin(), frame.values.end(), -1); }));
+            expectEquals(snapshot.read().values.back(), (juce::int64) -1);
+        }
+
+        beginTest("Tap list edits never wait for an analysis pass");
+        {
+            AnalysisTapService service;
+            service.prepare(48000.0);
+            auto* tap = service.createTap("Slow", 2, 4096);
+
+            // 300 ms per block, like a huge FFT on a loaded machine
+            std::atomic<bool> analysing { false };
+            std::atomic<int> blocks { 0 };
+            auto slowBlock = [&](const juce::AudioBuffer<float>&) {
+                analysing.store(true);
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                ++blocks;
+                analysing.store(false);
+            };
+            service.attach(tap, std::make_shared<SnapshotAnalyzer<int>>(nullptr, slowBlock, [](int&) {}));
+            service.start();
+            tap->push(makeRamp(0, 512));
+            while (!analysing.load())
+                std::this_thread::yield();
+
+            // Message thread: a new tap with its analyzer while that block is analysed
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            auto* other = service.createTap("Other");
+            activate(service, other);
+            const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - start;
+            const bool overlapped = analysing.load();
+            service.stop();
+
+            expect(overlapped, "The edits must overlap the analysis pass");
+            expectLessThan(elapsedMs, 150.0);
+            expectEquals(blocks.load(), 1);
+        }
+    }
+};
+
+static AnalysisTapServiceTest analysisTapServiceTest;
@@ -0,0 +1,198 @@
+#include <JuceHeader.h>
+#include "../Audio/Analysis/AudioFeatureStore.h"
+
+using namespace omega::Analysis;
+
+class AudioFeatureStoreTest : public juce::UnitTest {
+public:
+    AudioFeatureStoreTest() : juce::UnitTest("AudioFeatureStore", "DSP") {}
+
+    void runTest() override {
+        beginTest("Tempo and onsets of click tracks");
+        {
+            const struct { double sampleRate; double bpm; } cases[] = { { 44100.0, 120.0 }, { 48000.0, 95.0 } };
+
+            for (const auto& c : cases) {
+                const int numClicks = 16;
+                const int interval = juce::roundToInt(60.0 / c.bpm * c.sampleRate);
+                const int start = 1000;
+                juce::AudioBuffer<float> buffer(2, start + numClicks * interval);
+                buffer.clear();
+                for (int n = 0; n < numClicks; ++n)
+                    addBurst(buffer, start + n * interval, c.sampleRate, 2000.0, 0.8f);
+
+                const auto begin = juce::Time::getHighResolutionTicks();
+                const auto features = AudioFeatureStore::analyse(buffer, c.sampleRate);
+                const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - begin);
+                logMessage(juce::String(c.bpm) + " BPM: detected " + juce::String(features.summary.bpm, 2)
+                           + ", analysis at " + juce::String(buffer.getNumSamples() / c.sampleRate / seconds, 0) + "x real time");
+
+                expect(std::abs(features.summary.bpm - c.bpm) < 0.5, "Tempo " + juce::String(features.summary.bpm, 2));
+
+                const auto onsets = features.selectOnsets(0.3f, interval / 2);
+                expectEquals((int) onsets.size(), numClicks, "Onset count");
+                for (size_t n = 0; n < onsets.size() && n < (size_t) numClicks; ++n) {
+                    const int64_t click = start + (int64_t) n * interval;
+                    // 64-sample blocks: at most two blocks early
+                    expect(onsets[n].position <= click && click - onsets[n].position < 128,
+                           "Onset " + juce::String((int) n) + " at " + juce::String((juce::int64) onsets[n].position)
+                           + ", click at " + juce::String((juce::int64) click));
+                }
+            }
+        }
+
+        beginTest("Key from chord progressions");
+        {
+            const double sampleRate = 44100.0;
+            // A minor: Am Dm E Am, C major: C F G C (MIDI notes)
+            const std::vector<std::vector<int>> minorChords = { { 57, 60, 64 }, { 62, 65, 69 }, { 64, 68, 71 }, { 57, 60, 64 } };
+            const std::vector<std::vector<int>> majorChords = { { 60, 64, 67 }, { 65, 69, 72 }, { 67, 71, 74 }, { 60, 64, 67 } };
+
+            const auto minor = AudioFeatureStore::analyse(makeChords(minorChords, sampleRate), sampleRate);
+            expect(minor.summary.getKeyName() == "Am", "Detected " + minor.summary.getKeyName());
+
+            const auto major = AudioFeatureStore::analyse(makeChords(majorChords, sampleRate), sampleRate);
+            expect(major.summary.getKeyName() == "C", "Detected " + major.summary.getKeyName());
+
+            // No tonal content, no key
+            juce::AudioBuffer<float> clicks(1, (int) sampleRate * 4);
+            clicks.clear();
+            for (int n = 0; n < 8; ++n)
+                clicks.setSample(0, n * (int) sampleRate / 2, 1.0f);
+            expectEquals(AudioFeatureStore::analyse(clicks, sampleRate).summary.key, -1, "Key of clicks");
+        }
+
+        beginTest("Integrated loudness of a stereo sine");
+        {
+            const double sampleRate = 48000.0;
+            juce::AudioBuffer<float> buffer(2, (int) sampleRate * 5);
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                const float sample = 0.1f * (float) std::sin(juce::MathConstants<double>::twoPi * 997.0 * i / sampleRate);
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+            }
+
+            const auto features = AudioFeatureStore::analyse(buffer, sampleRate);
+            expect(std::abs(features.summary.integratedLoudness + 20.0f) < 0.1f,
+                   "Loudness " + juce::String(features.summary.integratedLoudness, 2) + " LUFS");
+            expect(std::abs(features.summary.peakDb + 20.0f) < 0.01f, "Peak " + juce::String(features.summary.peakDb, 2));
+            expect(std::abs(features.summary.rmsDb + 23.01f) < 0.01f, "RMS " + juce::String(features.summary.rmsDb, 2));
+        }
+
+        beginTest("Content hash lookups, in memory and from disk");
+        {
+            const double sampleRate = 44100.0;
+            auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                 .getNonexistentChildFile("FeatureStoreTest", "", false);
+
+            juce::AudioBuffer<float> buffer(2, (int) sampleRate * 4);
+            buffer.clear();
+            for (int n = 0; n < 8; ++n)
+                addBurst(buffer, 2000 + n * (int) sampleRate / 2, sampleRate, 1000.0, 0.5f);
+
+            auto numFeatureFiles = [&] {
+                return directory.findChildFiles(juce::File::findFiles, false, "*.features").size();
+            };
+
+            // The same audio as a file (32-bit float, decodes to the same samples)
+            auto source = directory.getChildFile("source.wav");
+            std::shared_ptr<const AudioFeatures> first;
+            {
+                AudioFeatureStore store(directory);
+                first = store.getFeatures(buffer, sampleRate);
+                expect(first != nullptr);
+                expect(store.getFeatures(buffer, sampleRate) == first, "Second query must hit the memory cache");
+
+                juce::AudioBuffer<float> changed;
+                changed.makeCopyOf(buffer);
+                changed.setSample(1, 100, 1.0e-3f);
+                expect(AudioFeatureStore::hashContent(changed, sampleRate) != first->summary.contentHash);
+                expect(AudioFeatureStore::hashContent(buffer, 48000.0) != first->summary.contentHash);
+
+                // Audio only in memory is never written: nothing on disk could find it again
+                expect(store.getFeatures(changed, sampleRate) != nullptr);
+                expectEquals(numFeatureFiles(), 0);
+
+                {
+                    juce::WavAudioFormat wav;
+                    std::unique_ptr<juce::FileOutputStream> stream(source.createOutputStream());
+                    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+                    expect(writer != nullptr);
+                    stream.release();
+                    writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+                }
+
+                // Once a file decodes to it, the analysis done in memory is persisted
+                expect(store.getFeatures(source) == first, "The file must reuse the in-memory analysis");
+                expectEquals(numFeatureFiles(), 1);
+
+                // A feature file no indexed file refers to
+                auto stored = directory.findChildFiles(juce::File::findFiles, false, "*.features")[0];
+                expect(stored.copyFileTo(directory.getChildFile("00000000deadbeef.features")));
+            }
+
+            // A new store (next session) drops the orphan and reads the analysis back instead of recomputing it
+            AudioFeatureStore store(directory);
+            expectEquals(numFeatureFiles(), 1);
+            expect(!directory.getChildFile("00000000deadbeef.features").existsAsFile());
+
+            AudioFeatureSummary summary;
+            expect(store.getCachedSummary(source, summary));
+            expectEquals(summary.contentHash, first->summary.contentHash);
+
+            const auto loaded = store.getFeatures(buffer, sampleRate);
+            expect(loaded != nullptr && loaded != first);
+            if (loaded != nullptr) {
+                expectEquals(loaded->summary.contentHash, first->summary.contentHash);
+                expectEquals(loaded->summary.bpm, first->summary.bpm);
+                expectEquals(loaded->summary.key, first->summary.key);
+                expectEquals(loaded->onsets.size(), first->onsets.size());
+                for (size_t n = 0; n < loaded->onsets.size() && n < first->onsets.size(); ++n) {
+                    expectEquals(loaded->onsets[n].position, first->onsets[n].position);
+                    expect(std::abs(loaded->onsets[n].strength - first->onsets[n].strength) < 1.0e-4f);
+                }
+
+                float maxError = 0.0f;
+                for (size_t k = 0; k < loaded->spectrum.size(); ++k)
+                    maxError = juce::jmax(maxError, std::abs(loaded->spectrum[k] - first->spectrum[k]));
+                expect(loaded->spectrum.size() == first->spectrum.size() && maxError <= 0.005f,
+                       "Stored spectrum differs by " + juce::String(maxError) + " dB");
+            }
+
+            store.clear();
+            directory.deleteRecursively();
+        }
+    }
+
+private:
+    // Decaying tone burst (~20 ms)
+    static void addBurst(juce::AudioBuffer<float>& buffer, int position, double sampleRate, double frequency, float amplitude) {
+        const int length = juce::jmin((int) (0.02 * sampleRate), buffer.getNumSamples() - position);
+        for (int i = 0; i < length; ++i) {
+            const float sample = amplitude * std::exp(-5.0f * (float) i / (float) length)
+                               * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, position + i, buffer.getSample(ch, position + i) + sample);
+        }
+    }
+
+    // One second per chord, sine partials
+    static juce::AudioBuffer<float> makeChords(const std::vector<std::vector<int>>& chords, double sampleRate) {
+        const int chordLength = (int) sampleRate;
+        juce::AudioBuffer<float> buffer(1, chordLength * (int) chords.size());
+        buffer.clear();
+        for (size_t c = 0; c < chords.size(); ++c) {
+            for (int note : chords[c]) {
+                const double frequency = 440.0 * std::pow(2.0, (note - 69) / 12.0);
+                for (int i = 0; i < chordLength; ++i) {
+                    const int index = (int) c * chordLength + i;
+                    buffer.setSample(0, index, buffer.getSample(0, index)
+                                     + 0.2f * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+                }
+            }
+        }
+        return buffer;
+    }
+};
+
+static AudioFeatureStoreTest audioFeatureStoreTest;
@@ -0,0 +1,277 @@
+#include <JuceHeader.h>
+#include "../Audio/Graph/AudioGraph.h"
+#include "../Audio/Graph/AudioNode.h"
+
+using namespace Omega::Audio;
+
+namespace {
+
+// Unit impulses at fixed absolute sample positions; ignores its input
+class ImpulseNode : public AudioNode {
+public:
+    explicit ImpulseNode(std::vector<int64_t> positions)
+        : AudioNode(NodeType::Instrument, "Impulses"), positions_(std::move(positions)) {}
+
+    void prepare(double, int) override {}
+    void reset() override {}
+
+    void process(juce::AudioBuffer<float>& buffer) override {
+        const int numSamples = buffer.getNumSamples();
+        buffer.clear();
+        for (const int64_t position : positions_)
+            if (position >= time_ && position < time_ + numSamples)
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    buffer.setSample(ch, (int) (position - time_), 1.0f);
+        time_ += numSamples;
+    }
+
+private:
+    std::vector<int64_t> positions_;
+    int64_t time_ { 0 };
+};
+
+// Passes its input through and reports a latency, which the graph applies
+class LatencyNode : public AudioNode {
+public:
+    explicit LatencyNode(int latency) : AudioNode(NodeType::Effect, "Latency"), latency_(latency) {}
+
+    void prepare(double, int) override {}
+    void reset() override {}
+    void process(juce::AudioBuffer<float>&) override {}
+    int getLatencySamples() const noexcept override { return latency_; }
+
+private:
+    int latency_;
+};
+
+// Records its main input, its key bus and when it ran
+class ProbeNode : public AudioNode {
+public:
+    explicit ProbeNode(const std::string& name = "Probe", std::vector<std::string>* order = nullptr)
+        : AudioNode(NodeType::Effect, name), order_(order) {}
+
+    void prepare(double, int) override {}
+    void reset() override {}
+
+    void process(juce::AudioBuffer<float>& buffer) override {
+        if (order_ != nullptr)
+            order_->push_back(getName());
+
+        const auto* key = getSidechainInput();
+        keyBuffer = key;
+        keyLengthMismatches += key != nullptr && getSidechainNumSamples() != buffer.getNumSamples() ? 1 : 0;
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            main.push_back(buffer.getSample(0, i));
+            this->key.push_back(key != nullptr ? key->getSample(0, i) : 0.0f);
+        }
+    }
+
+    std::vector<float> main, key;
+    const juce::AudioBuffer<float>* keyBuffer { nullptr };
+    int keyLengthMismatches { 0 };
+
+private:
+    std::vector<std::string>* order_;
+};
+
+std::vector<int64_t> nonZeroPositions(const std::vector<float>& signal) {
+    std::vector<int64_t> positions;
+    for (size_t i = 0; i < signal.size(); ++i)
+        if (signal[i] != 0.0f)
+            positions.push_back((int64_t) i);
+    return positions;
+}
+
+std::vector<int64_t> shifted(std::vector<int64_t> positions, int64_t delay) {
+    for (auto& position : positions)
+        position += delay;
+    return positions;
+}
+
+} // namespace
+
+class AudioGraphTest : public juce::UnitTest {
+public:
+    AudioGraphTest() : juce::UnitTest("AudioGraph", "Mixer") {}
+
+    void runTest() override {
+        const std::vector<int64_t> impulses { 100, 1000, 2047, 2048, 3333 };
+
+        // Random block sizes, so impulses and delays straddle block boundaries
+        auto run = [](AudioGraph& graph, int totalSamples, int seed) {
+            juce::Random random(seed);
+            juce::AudioBuffer<float> output(2, 512);
+            float* outputs[2] = { output.getWritePointer(0), output.getWritePointer(1) };
+            for (int done = 0; done < totalSamples;) {
+                const int numSamples = juce::jmin(totalSamples - done, 1 + random.nextInt(300));
+                graph.process(nullptr, 0, outputs, 2, numSamples);
+                done += numSamples;
+            }
+        };
+
+        beginTest("Upstream signal reaches its destinations");
+        {
+            // Destinations added first: the order comes from the edges, not insertion
+            AudioGraph graph;
+            auto* mixProbe = new ProbeNode("Mix");
+            auto* endProbe = new ProbeNode("End");
+            const NodeID mix = graph.addNode(std::unique_ptr<AudioNode>(mixProbe));
+            const NodeID end = graph.addNode(std::unique_ptr<AudioNode>(endProbe));
+            const NodeID a = graph.addNode(std::make_unique<ImpulseNode>(std::vector<int64_t> { 10, 500 }));
+            const NodeID b = graph.addNode(std::make_unique<ImpulseNode>(std::vector<int64_t> { 20, 777 }));
+
+            expect(graph.connect(a, 0, mix, 0));
+            expect(graph.connect(b, 0, mix, 0));
+            expect(graph.connect(mix, 0, end, 0));
+            run(graph, 1000, 1);
+
+            const std::vector<int64_t> expected { 10, 20, 500, 777 };
+            expect(nonZeroPositions(mixProbe->main) == expected);
+            expect(nonZeroPositions(endProbe->main) == expected);
+            expectEquals((int) endProbe->main.size(), 1000);
+        }
+
+        beginTest("Key sources run before their consumers");
+        {
+            std::vector<std::string> order;
+            AudioGraph graph;
+            const NodeID consumer = graph.addNode(std::make_unique<ProbeNode>("Consumer", &order));
+            const NodeID key = graph.addNode(std::make_unique<ProbeNode>("Key", &order));
+            const NodeID keyOfKey = graph.addNode(std::make_unique<ProbeNode>("KeyOfKey", &order));
+            const NodeID upstream = graph.addNode(std::make_unique<ProbeNode>("Upstream", &order));
+
+            expect(graph.connect(upstream, 0, keyOfKey, 0));
+            expect(graph.connectSidechain(keyOfKey, key));
+            expect(graph.connectSidechain(key, consumer));
+
+            juce::AudioBuffer<float> output(2, 64);
+            float* outputs[2] = { output.getWritePointer(0), output.getWritePointer(1) };
+            graph.process(nullptr, 0, outputs, 2, 64);
+
+            auto indexOf = [&](const std::string& name) {
+                return (int) (std::find(order.begin(), order.end(), name) - order.begin());
+            };
+            expectEquals((int) order.size(), 4);
+            expectLessThan(indexOf("Upstream"), indexOf("KeyOfKey"));
+            expectLessThan(indexOf("KeyOfKey"), indexOf("Key"));
+            expectLessThan(indexOf("Key"), indexOf("Consumer"));
+        }
+
+        beginTest("Early key is delayed to the main input, sample-exact");
+        {
+            // Main: A -> latency 37 -> C. Key: K -> C with no latency
+            AudioGraph graph;
+            auto* probe = new ProbeNode();
+            const NodeID consumer = graph.addNode(std::unique_ptr<AudioNode>(probe));
+            const NodeID main = graph.addNode(std::make_unique<ImpulseNode>(impulses));
+            const NodeID latency = graph.addNode(std::make_unique<LatencyNode>(37));
+            const NodeID key = graph.addNode(std::make_unique<ImpulseNode>(impulses));
+
+            expect(graph.connect(main, 0, latency, 0));
+            expect(graph.connect(latency, 0, consumer, 0));
+            expect(graph.connectSidechain(key, consumer));
+            expectEquals(graph.getSidechainDelay(consumer), 37);
+            expectEquals(graph.getInputDelay(consumer), 0);
+
+            run(graph, 4000, 3);
+            expect(nonZeroPositions(probe->main) == shifted(impulses, 37));
+            expect(nonZeroPositions(probe->key) == shifted(impulses, 37));
+            expectEquals(probe->keyLengthMismatches, 0);
+        }
+
+        beginTest("Late key delays the main input, sample-exact");
+        {
+            // Key: K -> latency 53 -> C. Main: A -> C with no latency
+            AudioGraph graph;
+            auto* probe = new ProbeNode();
+            const NodeID consumer = graph.addNode(std::unique_ptr<AudioNode>(probe));
+            const NodeID main = graph.addNode(std::make_unique<ImpulseNode>(impulses));
+            const NodeID key = graph.addNode(std::make_unique<ImpulseNode>(impulses));
+            const NodeID latency = graph.addNode(std::make_unique<LatencyNode>(53));
+
+            expect(graph.connect(main, 0, consumer, 0));
+            expect(graph.connect(key, 0, latency, 0));
+            expect(graph.connectSidechain(latency, consumer));
+            expectEquals(graph.getSidechainDelay(consumer), 0);
+            expectEquals(graph.getInputDelay(consumer), 53);
+            expectEquals(graph.getTotalLatency(), 53);
+
+            run(graph, 4000, 4);
+            expect(nonZeroPositions(probe->main) == shifted(impulses, 53));
+            expect(nonZeroPositions(probe->key) == shifted(impulses, 53));
+        }
+
+        beginTest("Consumers with the same source and delay share one tap");
+        {
+            // Four consumers 20 samples late, one aligned (no tap), one 45 late (own tap)
+            AudioGraph graph;
+            const NodeID main = graph.addNode(std::make_unique<ImpulseNode>(impulses));
+            const NodeID key = graph.addNode(std::make_unique<ImpulseNode>(impulses));
+            const NodeID latency20 = graph.addNode(std::make_unique<LatencyNode>(20));
+            const NodeID latency45 = graph.addNode(std::make_unique<LatencyNode>(45));
+            expect(graph.connect(main, 0, latency20, 0));
+            expect(graph.connect(main, 0, latency45, 0));
+
+            struct Consumer { ProbeNode* probe; NodeID id; int delay; };
+            std::vector<Consumer> consumers;
+            auto addConsumer = [&](NodeID from, int delay) {
+                auto* probe = new ProbeNode();
+                const NodeID id = graph.addNode(std::unique_ptr<AudioNode>(probe));
+                expect(graph.connect(from, 0, id, 0));
+                expect(graph.connectSidechain(key, id));
+                consumers.push_back({ probe, id, delay });
+            };
+            for (int i = 0; i < 4; ++i)
+                addConsumer(latency20, 20);
+            addConsumer(main, 0);
+            addConsumer(latency45, 45);
+
+            expectEquals((int) graph.getNumSidechainConnections(), 6);
+            expectEquals((int) graph.getNumSidechainTaps(), 2);
+
+            run(graph, 4000, 5);
+            for (const auto& consumer : consumers) {
+                expectEquals(graph.getSidechainDelay(consumer.id), consumer.delay);
+                expect(nonZeroPositions(consumer.probe->key) == shifted(impulses, consumer.delay));
+                expect(nonZeroPositions(consumer.probe->main) == shifted(impulses, consumer.delay));
+            }
+
+            const auto* shared = consumers[0].probe->keyBuffer;
+            expect(shared != nullptr);
+            for (int i = 1; i < 4; ++i)
+                expect(consumers[(size_t) i].probe->keyBuffer == shared);
+            expect(consumers[4].probe->keyBuffer != shared);
+            expect(consumers[5].probe->keyBuffer != shared);
+        }
+
+        beginTest("Sidechain cycles are rejected");
+        {
+            AudioGraph graph;
+            const NodeID a = graph.addNode(std::make_unique<ProbeNode>("A"));
+            const NodeID b = graph.addNode(std::make_unique<ProbeNode>("B"));
+            const NodeID c = graph.addNode(std::make_unique<ProbeNode>("C"));
+            const NodeID d = graph.addNode(std::make_unique<ProbeNode>("D"));
+
+            // Self key and key from a downstream node
+            expect(!graph.connectSidechain(a, a));
+            expect(graph.connect(a, 0, b, 0));
+            expect(!graph.connectSidechain(b, a));
+            expect(graph.getSidechainSource(a) == INVALID_NODE_ID);
+
+            // Main edge closing a loop through a key
+            expect(graph.connectSidechain(c, d));
+            expect(!graph.connect(d, 0, c, 0));
+            expect(!graph.isConnected(d, c));
+
+            // A rejected replacement keeps the previous source
+            expect(graph.connect(d, 0, a, 0));
+            expect(!graph.connectSidechain(b, d));
+            expect(graph.getSidechainSource(d) == c);
+            expectEquals((int) graph.getNumSidechainConnections(), 1);
+
+            run(graph, 256, 6);
+        }
+    }
+};
+
+static AudioGraphTest audioGraphTest;
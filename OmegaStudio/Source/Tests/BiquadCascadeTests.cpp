@@ -0,0 +1,357 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/BiquadCascade.h"
+#include "../Audio/DSP/ParametricEQ.h"
+
+using namespace OmegaStudio;
+
+class BiquadCascadeTest : public juce::UnitTest {
+public:
+    BiquadCascadeTest() : juce::UnitTest("BiquadCascade", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const double pi = juce::MathConstants<double>::pi;
+
+        // Steady-state gain at an integer frequency: half a second to settle, then
+        // one second (a whole number of cycles) correlated against sin and cos.
+        // processBlock filters a block of the signal in place
+        auto measureGain = [&](auto&& processBlock, double frequency) {
+            const int settle = (int) sampleRate / 2;
+            const int length = (int) sampleRate;
+            std::vector<float> signal((size_t) (settle + length));
+            for (size_t i = 0; i < signal.size(); ++i)
+                signal[i] = (float) (0.5 * std::sin(2.0 * pi * frequency * (double) i / sampleRate));
+
+            for (int offset = 0; offset < (int) signal.size(); offset += 512)
+                processBlock(signal.data() + offset, juce::jmin(512, (int) signal.size() - offset));
+
+            double re = 0.0, im = 0.0;
+            for (int i = settle; i < settle + length; ++i) {
+                const double phase = 2.0 * pi * frequency * (double) i / sampleRate;
+                re += signal[(size_t) i] * std::sin(phase);
+                im += signal[(size_t) i] * std::cos(phase);
+            }
+            return 2.0 * std::sqrt(re * re + im * im) / (double) length / 0.5;
+        };
+
+        auto toDecibels = [](double gain) -> double { return juce::Decibels::gainToDecibels(gain, -200.0); };
+
+        // Within tolerance in dB, or 1e-4 absolute at a zero of the response
+        auto expectGain = [&](double measured, double expected, double toleranceDb, const juce::String& what) {
+            const bool close = std::abs(measured - expected) < 1.0e-4
+                            || std::abs(toDecibels(measured) - toDecibels(expected)) < toleranceDb;
+            expect(close, what + ": measured " + juce::String(toDecibels(measured), 3)
+                          + " dB, expected " + juce::String(toDecibels(expected), 3) + " dB");
+        };
+
+        struct Filter { const char* name; BiquadCoefficients coefficients; };
+        const std::vector<Filter> filters {
+            { "peak",       BiquadCoefficients::peak(sampleRate, 1000.0, 2.0, 9.0) },
+            { "low shelf",  BiquadCoefficients::lowShelf(sampleRate, 300.0, 0.707, -12.0) },
+            { "high shelf", BiquadCoefficients::highShelf(sampleRate, 6000.0, 0.707, 6.0) },
+            { "low pass",   BiquadCoefficients::lowPass(sampleRate, 2000.0, 0.707) },
+            { "high pass",  BiquadCoefficients::highPass(sampleRate, 150.0, 1.5) },
+            { "band pass",  BiquadCoefficients::bandPass(sampleRate, 1000.0, 4.0) },
+            { "notch",      BiquadCoefficients::notch(sampleRate, 1000.0, 4.0) },
+            { "all pass",   BiquadCoefficients::allPass(sampleRate, 1000.0, 0.7) },
+        };
+        const double frequencies[] { 40.0, 150.0, 300.0, 1000.0, 2000.0, 6000.0, 15000.0 };
+
+        beginTest("Measured magnitude matches response() for every filter type");
+        {
+            for (const auto& filter : filters) {
+                for (const double frequency : frequencies) {
+                    BiquadCascade cascade;
+                    cascade.prepare(sampleRate);
+                    cascade.setStage(0, filter.coefficients, true);
+
+                    const double measured = measureGain([&](float* data, int n) {
+                        float* channels[1] = { data };
+                        cascade.process(channels, 1, n);
+                    }, frequency);
+                    expectGain(measured, std::abs(filter.coefficients.response(frequency, sampleRate)), 0.02,
+                               juce::String(filter.name) + " at " + juce::String(frequency) + " Hz");
+                }
+            }
+        }
+
+        beginTest("Filter bank: each lane follows its own response");
+        {
+            // Four different filters on the lanes of one stage, same input in all
+            for (int lane = 0; lane < BiquadCascade::maxLanes; ++lane) {
+                const auto& filter = filters[(size_t) lane + 4];
+                for (const double frequency : frequencies) {
+                    BiquadCascade bank;
+                    bank.prepare(sampleRate);
+                    for (int l = 0; l < BiquadCascade::maxLanes; ++l)
+                        bank.setStageLane(0, l, filters[(size_t) l + 4].coefficients, true);
+
+                    std::vector<float> outputs[BiquadCascade::maxLanes];
+                    const double measured = measureGain([&](float* data, int n) {
+                        float* lanes[BiquadCascade::maxLanes];
+                        for (int l = 0; l < BiquadCascade::maxLanes; ++l) {
+                            outputs[l].resize((size_t) n);
+                            lanes[l] = outputs[l].data();
+                        }
+                        bank.processBroadcast(data, lanes, BiquadCascade::maxLanes, n);
+                        std::copy(outputs[lane].begin(), outputs[lane].end(), data);
+                    }, frequency);
+                    expectGain(measured, std::abs(filter.coefficients.response(frequency, sampleRate)), 0.02,
+                               "Lane " + juce::String(lane) + " (" + filter.name + ") at " + juce::String(frequency) + " Hz");
+                }
+            }
+        }
+
+        beginTest("Identity stages are bit-transparent");
+        {
+            juce::Random random(36);
+            const int length = 4000;
+            std::vector<float> source[BiquadCascade::maxLanes];
+            for (auto& channel : source) {
+                channel.resize((size_t) length);
+                for (auto& sample : channel)
+                    sample = random.nextFloat() * 2.0f - 1.0f;
+            }
+
+            // Odd block sizes, so control blocks straddle host blocks
+            auto run = [&](BiquadCascade& cascade, int numChannels) {
+                std::vector<float> buffers[BiquadCascade::maxLanes];
+                for (int ch = 0; ch < numChannels; ++ch)
+                    buffers[ch] = source[ch];
+                for (int offset = 0; offset < length; offset += 77) {
+                    float* channels[BiquadCascade::maxLanes];
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        channels[ch] = buffers[ch].data() + offset;
+                    cascade.process(channels, numChannels, juce::jmin(77, length - offset));
+                }
+                return std::vector<std::vector<float>>(buffers, buffers + numChannels);
+            };
+
+            {
+                BiquadCascade cascade;
+                cascade.prepare(sampleRate);
+                const auto output = run(cascade, 4);
+                for (int ch = 0; ch < 4; ++ch)
+                    expect(output[(size_t) ch] == source[ch], "Fresh cascade, channel " + juce::String(ch));
+            }
+
+            {
+                // Flat bands and bypassed stages
+                BiquadCascade cascade;
+                cascade.prepare(sampleRate);
+                cascade.setStage(0, BiquadCoefficients::peak(sampleRate, 1000.0, 1.0, 0.0));
+                cascade.setStage(5, BiquadCoefficients::lowShelf(sampleRate, 100.0, 0.7, 0.0));
+                cascade.setStage(9, BiquadCoefficients::lowPass(sampleRate, 500.0, 0.7), true);
+                cascade.bypassStage(9, true);
+                const auto output = run(cascade, 2);
+                for (int ch = 0; ch < 2; ++ch)
+                    expect(output[(size_t) ch] == source[ch], "Flat and bypassed stages, channel " + juce::String(ch));
+            }
+
+            {
+                // A filter on lane 0 only: the other lanes pass through untouched
+                BiquadCascade cascade;
+                cascade.prepare(sampleRate);
+                cascade.setStageLane(3, 0, BiquadCoefficients::highPass(sampleRate, 2000.0, 0.7), true);
+                const auto output = run(cascade, 4);
+                expect(output[0] != source[0]);
+                for (int ch = 1; ch < 4; ++ch)
+                    expect(output[(size_t) ch] == source[ch], "Unfiltered lane " + juce::String(ch));
+
+                std::vector<float> outputs[BiquadCascade::maxLanes];
+                float* lanes[BiquadCascade::maxLanes];
+                for (int l = 0; l < BiquadCascade::maxLanes; ++l) {
+                    outputs[l].resize((size_t) length);
+                    lanes[l] = outputs[l].data();
+                }
+                cascade.reset();
+                cascade.processBroadcast(source[0].data(), lanes, BiquadCascade::maxLanes, length);
+                for (int l = 1; l < BiquadCascade::maxLanes; ++l)
+                    expect(outputs[l] == source[0], "Broadcast, unfiltered lane " + juce::String(l));
+            }
+
+            {
+                // A band ramped down to flat stops being processed once the ramp ends
+                BiquadCascade cascade;
+                cascade.prepare(sampleRate, 20.0);
+                cascade.setStage(2, BiquadCoefficients::peak(sampleRate, 1000.0, 1.0, 12.0), true);
+                run(cascade, 2);
+                cascade.bypassStage(2);
+
+                std::vector<float> left = source[0], right = source[1];
+                float* channels[2] = { left.data(), right.data() };
+                cascade.process(channels, 2, length);
+
+                // 20 ms = 30 control blocks of 32 samples; from then on the stage is skipped
+                const int rampEnd = 30 * BiquadCascade::controlInterval;
+                expect(std::equal(left.begin() + rampEnd, left.end(), source[0].begin() + rampEnd));
+                expect(std::equal(right.begin() + rampEnd, right.end(), source[1].begin() + rampEnd));
+            }
+        }
+
+        beginTest("Coefficient ramps stay bounded and stable and end on the target");
+        {
+            // Resonant targets at both ends of the band. Linear interpolation keeps
+            // the poles inside the unit circle, but mid-ramp the zeros no longer
+            // cancel them, so the gain can peak well above both ends of a ramp
+            const std::vector<BiquadCoefficients> targets {
+                BiquadCoefficients::lowPass(sampleRate, 30.0, 20.0),
+                BiquadCoefficients::highPass(sampleRate, 18000.0, 20.0),
+                BiquadCoefficients::peak(sampleRate, 60.0, 20.0, 24.0),
+                BiquadCoefficients::allPass(sampleRate, 40.0, 20.0),
+                BiquadCoefficients::peak(sampleRate, 16000.0, 0.1, -24.0),
+                BiquadCoefficients::bandPass(sampleRate, 20000.0, 20.0),
+                BiquadCoefficients::notch(sampleRate, 25.0, 20.0),
+                BiquadCoefficients::lowShelf(sampleRate, 20.0, 2.0, 24.0),
+            };
+            const auto finalTarget = BiquadCoefficients::peak(sampleRate, 1000.0, 1.0, 6.0);
+
+            // Sum of |h| of a frozen filter: the most any input within +-1 can produce
+            auto impulseResponseSum = [&](const BiquadCoefficients& c) {
+                double s1 = 0.0, s2 = 0.0, sum = 0.0;
+                for (int n = 0; n < (int) sampleRate * 5; ++n) {
+                    const double x = n == 0 ? 1.0 : 0.0;
+                    const double y = c.b0 * x + s1;
+                    s1 = c.b1 * x - c.a1 * y + s2;
+                    s2 = c.b2 * x - c.a2 * y;
+                    sum += std::abs(y);
+                }
+                return sum;
+            };
+
+            auto lerp = [](const BiquadCoefficients& a, const BiquadCoefficients& b, float t) {
+                return BiquadCoefficients { a.b0 + (b.b0 - a.b0) * t, a.b1 + (b.b1 - a.b1) * t, a.b2 + (b.b2 - a.b2) * t,
+                                            a.a1 + (b.a1 - a.a1) * t, a.a2 + (b.a2 - a.a2) * t };
+            };
+
+            // Worst frozen filter on every ramp of the sequence (each one completes)
+            double worstSum = 0.0;
+            for (size_t i = 0; i < targets.size(); ++i) {
+                const auto& from = targets[(i + targets.size() - 1) % targets.size()];
+                for (int k = 0; k <= 32; ++k)
+                    worstSum = juce::jmax(worstSum, impulseResponseSum(lerp(from, targets[i], (float) k / 32.0f)));
+            }
+
+            for (const double rampMs : { 20.0, 500.0 }) {
+                BiquadCascade cascade;
+                cascade.prepare(sampleRate, rampMs);
+                cascade.setStage(0, targets.back(), true);
+
+                // Complete ramps with a hold after each, then retargets every 7919
+                // samples, mid-ramp, then the final target and two seconds on it
+                const int rampSamples = (int) std::ceil(rampMs * 0.001 * sampleRate / BiquadCascade::controlInterval)
+                                      * BiquadCascade::controlInterval;
+                const int period = rampSamples + (int) sampleRate / 10;
+                const int completeRamps = period * (int) targets.size();
+                const int automated = completeRamps + (int) sampleRate * 2;
+                const int length = automated + (int) sampleRate * 2;
+
+                juce::Random random(rampMs == 20.0 ? 1 : 2);
+                const float amplitude = 0.25f;
+                std::vector<float> input((size_t) length), output((size_t) length);
+                for (auto& sample : input)
+                    sample = (random.nextFloat() * 2.0f - 1.0f) * amplitude;
+
+                const int block = BiquadCascade::controlInterval;
+                float peak = 0.0f;
+                bool finite = true;
+                size_t next = 0;
+                for (int offset = 0; offset < length; offset += block) {
+                    if (offset < completeRamps ? offset % period == 0 : offset < automated && offset / 7919 != (offset + block) / 7919)
+                        cascade.setStage(0, targets[next++ % targets.size()]);
+                    else if (offset == automated)
+                        cascade.setStage(0, finalTarget);
+
+                    std::copy(input.begin() + offset, input.begin() + offset + block, output.begin() + offset);
+                    float* channels[1] = { output.data() + offset };
+                    cascade.process(channels, 1, block);
+
+                    for (int i = offset; i < offset + block; ++i) {
+                        finite = finite && std::isfinite(output[(size_t) i]);
+                        if (i < completeRamps)
+                            peak = juce::jmax(peak, std::abs(output[(size_t) i]));
+                    }
+                }
+
+                // The coefficients move slowly next to the impulse responses, so the
+                // frozen-filter bound holds up to a small margin for the variation
+                const juce::String name = "Ramp " + juce::String(rampMs) + " ms";
+                expect(finite, name + ": output must stay finite");
+                expect(peak < 1.5 * amplitude * worstSum, name + ": peak " + juce::String(peak)
+                       + ", bound " + juce::String(amplitude * worstSum));
+
+                // After the last ramp the cascade is the target filter: once the
+                // state from the automation has decayed it matches a reference run
+                BiquadCascade reference;
+                reference.prepare(sampleRate);
+                reference.setStage(0, finalTarget, true);
+                std::vector<float> expected(input.begin() + automated, input.end());
+                float* channels[1] = { expected.data() };
+                reference.process(channels, 1, (int) expected.size());
+
+                const int settled = rampSamples + (int) sampleRate;
+                float error = 0.0f;
+                for (int i = settled; i < (int) expected.size(); ++i)
+                    error = juce::jmax(error, std::abs(output[(size_t) (automated + i)] - expected[(size_t) i]));
+                expectLessThan(error, 1.0e-5f);
+            }
+        }
+
+        beginTest("LowCut and HighCut are Butterworth at 12, 24 and 48 dB/oct");
+        {
+            // RBJ sections with the pole-pair Qs of a Butterworth are its bilinear
+            // transform: |H|^2 = 1 / (1 + (tan(pi f / fs) / tan(pi fc / fs))^(+-2N))
+            const double cutoff = 1000.0;
+            auto butterworth = [&](double frequency, int order, bool lowCut) {
+                const double ratio = std::tan(pi * frequency / sampleRate) / std::tan(pi * cutoff / sampleRate);
+                return 1.0 / std::sqrt(1.0 + std::pow(lowCut ? 1.0 / ratio : ratio, 2.0 * order));
+            };
+
+            struct SlopeCase { ParametricEQ::Slope slope; int order; };
+            for (const auto& slopeCase : { SlopeCase { ParametricEQ::Slope::dB12, 2 },
+                                           SlopeCase { ParametricEQ::Slope::dB24, 4 },
+                                           SlopeCase { ParametricEQ::Slope::dB48, 8 } }) {
+                for (const bool lowCut : { true, false }) {
+                    ParametricEQ eq;
+                    eq.prepare(sampleRate, 512);
+                    eq.setBandType(2, lowCut ? ParametricEQ::FilterType::LowCut : ParametricEQ::FilterType::HighCut);
+                    eq.setBandFrequency(2, (float) cutoff);
+                    eq.setBandSlope(2, slopeCase.slope);
+                    eq.setBandEnabled(2, true);
+
+                    auto measure = [&](double frequency) {
+                        eq.reset();
+                        juce::AudioBuffer<float> buffer(1, 512);
+                        return measureGain([&](float* data, int n) {
+                            buffer.setSize(1, n, false, false, true);
+                            std::copy(data, data + n, buffer.getWritePointer(0));
+                            eq.process(buffer);
+                            std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + n, data);
+                        }, frequency);
+                    };
+
+                    const juce::String name = juce::String(lowCut ? "LowCut " : "HighCut ") + juce::String(6 * slopeCase.order) + " dB/oct";
+
+                    // -3 dB at the cutoff, flat passband, the closed form everywhere
+                    expectWithinAbsoluteError(toDecibels(measure(cutoff)), -3.0103, 0.02);
+                    for (const double octaves : { -2.0, -1.0, -0.5, 0.5, 1.0, 2.0, 3.0 }) {
+                        const double frequency = cutoff * std::pow(2.0, lowCut ? octaves : -octaves);
+                        expectGain(measure(frequency), butterworth(frequency, slopeCase.order, lowCut), 0.05,
+                                   name + " at " + juce::String(frequency, 1) + " Hz");
+                    }
+
+                    const double passband = measure(lowCut ? cutoff * 8.0 : cutoff / 8.0);
+                    expectWithinAbsoluteError(toDecibels(passband), 0.0, 0.01);
+
+                    // One octave further into the stopband is another 6N dB down
+                    const double oneOctave = measure(lowCut ? cutoff / 2.0 : cutoff * 2.0);
+                    const double twoOctaves = measure(lowCut ? cutoff / 4.0 : cutoff * 4.0);
+                    expectWithinAbsoluteError(toDecibels(oneOctave) - toDecibels(twoOctaves), 6.0 * slopeCase.order,
+                                              lowCut ? 0.5 : 2.0, name);
+                }
+            }
+        }
+    }
+};
+
+static BiquadCascadeTest biquadCascadeTest;
@@ -0,0 +1,215 @@
+#include <JuceHeader.h>
+#include "../Sequencer/PatternSystem.h"
+
+using namespace OmegaStudio::Sequencer;
+
+class ClipLaunchSchedulerTest : public juce::UnitTest {
+public:
+    ClipLaunchSchedulerTest() : juce::UnitTest("ClipLaunchScheduler", "Sequencer") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+
+        // Two seconds of DC: a launched clip shows up sample for sample
+        auto writeDcClip = [&](const juce::File& file) {
+            juce::AudioBuffer<float> dc(2, (int) sampleRate * 2);
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::fill(dc.getWritePointer(ch), 0.5f, dc.getNumSamples());
+
+            juce::WavAudioFormat wav;
+            std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+            std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+            expect(writer != nullptr);
+            stream.release();
+            writer->writeFromAudioSampleBuffer(dc, 0, dc.getNumSamples());
+        };
+
+        beginTest("Launch readiness follows the prefetch horizon");
+        {
+            auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                 .getNonexistentChildFile("ClipLaunchTest", "", false);
+            directory.createDirectory();
+
+            auto source = directory.getChildFile("clip.wav");
+            writeDcClip(source);
+
+            SessionView session;
+            ClipPrefetcher prefetcher;
+            ClipLaunchScheduler scheduler(session, prefetcher);
+            scheduler.setQuantization(ClipLaunchScheduler::Quantization::Bar);
+            scheduler.setPrefetchNeighbours(1);
+
+            // Track 0: a streamed clip in every scene. Scene 2 also has a clip whose
+            // file is missing, scene 0 a clip held in memory
+            std::vector<std::shared_ptr<AudioClip>> streamed;
+            for (int scene = 0; scene < session.getNumScenes(); ++scene) {
+                auto clip = std::make_shared<AudioClip>("Streamed " + juce::String(scene));
+                clip->setSourceFile(source);
+                session.getClipSlot(0, scene)->setClip(clip);
+                streamed.push_back(clip);
+            }
+
+            auto missing = std::make_shared<AudioClip>("Missing");
+            missing->setSourceFile(directory.getChildFile("missing.wav"));
+            session.getClipSlot(1, 2)->setClip(missing);
+
+            auto inMemory = std::make_shared<AudioClip>("In memory");
+            juce::AudioBuffer<float> held(2, 4800);
+            held.clear();
+            inMemory->setAudioBuffer(held, sampleRate);
+            session.getClipSlot(1, 0)->setClip(inMemory);
+
+            scheduler.prepareToPlay(sampleRate, blockSize);
+
+            auto waitForLoader = [&] {
+                const auto deadline = juce::Time::getMillisecondCounter() + 10000;
+                while (prefetcher.getNumPendingJobs() > 0 && juce::Time::getMillisecondCounter() < deadline)
+                    juce::Thread::sleep(1);
+                expectEquals(prefetcher.getNumPendingJobs(), 0, "Loader timed out");
+            };
+
+            auto expectTrack0 = [&](std::initializer_list<int> ready) {
+                for (int scene = 0; scene < session.getNumScenes(); ++scene) {
+                    const bool shouldBeReady = std::find(ready.begin(), ready.end(), scene) != ready.end();
+                    expect(scheduler.getSlotReadiness(0, scene) == (shouldBeReady ? LaunchReadiness::Ready : LaunchReadiness::NotLoaded),
+                           "Scene " + juce::String(scene) + (shouldBeReady ? " should be ready" : " should not be loaded"));
+                }
+            };
+
+            // Nothing loaded yet
+            expectTrack0({});
+            expect(scheduler.getSlotReadiness(1, 0) == LaunchReadiness::Ready);
+            expect(scheduler.getSlotReadiness(1, 2) == LaunchReadiness::Error);
+            expect(scheduler.getSlotReadiness(2, 0) == LaunchReadiness::Empty);
+            expect(scheduler.getSlotReadiness(0, 99) == LaunchReadiness::Empty);
+            expect(!scheduler.isSceneReady(0));
+            expect(!scheduler.isSceneReady(99));
+
+            // Queued scene and its neighbours load; empty and in-memory slots never hold a scene back
+            scheduler.queueScene(0);
+            expectEquals(scheduler.getQueuedScene(), 0);
+            waitForLoader();
+            expectTrack0({ 0, 1 });
+            expect(scheduler.isSceneReady(0));
+            expect(scheduler.isSceneReady(1));
+            expectEquals(prefetcher.getNumResidentClips(), 2);
+
+            // A missing file keeps its scene from reporting ready and is never retried
+            scheduler.prefetchAround(2);
+            waitForLoader();
+            expectTrack0({ 0, 1, 2, 3 });
+            expect(!scheduler.isSceneReady(2));
+            expect(scheduler.getSlotReadiness(1, 2) == LaunchReadiness::Error);
+            expectEquals(prefetcher.getNumResidentClips(), 4);
+
+            // Launch on the next bar, 240 samples into the block (120 BPM: 24000 samples per beat)
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            buffer.clear();
+            scheduler.process(buffer, midi, 3.5, 120.0);
+            expectEquals(scheduler.getQueuedScene(), 0, "The bar line is not in this block");
+            expectEquals(session.getCurrentScene(), -1);
+
+            buffer.clear();
+            scheduler.process(buffer, midi, 3.99, 120.0);
+            expectEquals(scheduler.getQueuedScene(), -1);
+            expectEquals(session.getCurrentScene(), 0);
+            expectEquals(buffer.getSample(0, 239), 0.0f);
+            expectEquals(buffer.getSample(0, 240), 0.5f);
+            expectEquals(buffer.getSample(1, blockSize - 1), 0.5f);
+
+            // Scene 0 keeps playing while 5 is queued: scenes 1-3 leave the horizon and are released
+            scheduler.queueScene(5);
+            waitForLoader();
+            expectTrack0({ 0, 4, 5, 6 });
+            expectEquals(prefetcher.getNumResidentClips(), 4);
+
+            // Still queued, 5 stays loaded while the horizon moves on
+            scheduler.prefetchAround(7);
+            waitForLoader();
+            expectTrack0({ 0, 5, 6, 7 });
+            expect(scheduler.isSceneReady(5));
+
+            // The playing clip still renders from memory
+            buffer.clear();
+            scheduler.process(buffer, midi, 4.1, 120.0);
+            expectEquals(buffer.getSample(0, 0), 0.5f);
+
+            // A released clip loads again when it comes back into the horizon
+            scheduler.prefetchAround(1);
+            waitForLoader();
+            expectTrack0({ 0, 1, 2, 5 });
+
+            directory.deleteRecursively();
+        }
+
+        beginTest("Warp edits while the loader prefetches the clip");
+        {
+            auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                 .getNonexistentChildFile("ClipWarpTest", "", false);
+            directory.createDirectory();
+            auto source = directory.getChildFile("clip.wav");
+            writeDcClip(source);
+
+            ClipPrefetcher prefetcher;
+            auto clip = std::make_shared<AudioClip>("Warped");
+            clip->setSourceFile(source);
+            clip->prepareToPlay(sampleRate, blockSize);
+
+            // The loader configures the warp player while this thread changes the warp
+            juce::Random random(42);
+            int loads = 0;
+            for (int edit = 0; edit < 400; ++edit) {
+                if (clip->getLaunchReadiness() == LaunchReadiness::Ready) {
+                    clip->releasePrefetch();
+                    ++loads;
+                }
+                prefetcher.prefetch(clip);
+
+                std::vector<OmegaStudio::Audio::DSP::WarpMarker> markers;
+                for (int m = 0; m < random.nextInt(8); ++m)
+                    markers.emplace_back(m * 12000.0, m * 0.5 + random.nextDouble() * 0.1);
+                clip->setWarp(edit % 2 == 0, 90.0 + random.nextInt(60), markers);
+            }
+
+            const auto deadline = juce::Time::getMillisecondCounter() + 10000;
+            while (prefetcher.getNumPendingJobs() > 0 && juce::Time::getMillisecondCounter() < deadline)
+                juce::Thread::sleep(1);
+            expectGreaterThan(loads, 0);
+            expect(clip->getLaunchReadiness() == LaunchReadiness::Ready);
+
+            // Settled on the last edit (warp off): the clip still plays
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            buffer.clear();
+            clip->renderNextBlock(buffer, midi, 0.0, 120.0);
+            expectGreaterThan(buffer.getMagnitude(0, 0, blockSize), 0.25f);
+
+            clip->releasePrefetch();
+            directory.deleteRecursively();
+        }
+
+        beginTest("Next launch beat on the quantization grid");
+        {
+            SessionView session;
+            ClipPrefetcher prefetcher;
+            ClipLaunchScheduler scheduler(session, prefetcher);
+
+            scheduler.setQuantization(ClipLaunchScheduler::Quantization::Bar, 3);
+            expectEquals(scheduler.getNextLaunchBeat(0.0), 0.0);
+            expectEquals(scheduler.getNextLaunchBeat(0.01), 3.0);
+            expectEquals(scheduler.getNextLaunchBeat(3.0), 3.0);
+            expectEquals(scheduler.getNextLaunchBeat(5.99), 6.0);
+
+            scheduler.setQuantization(ClipLaunchScheduler::Quantization::FourBars);
+            expectEquals(scheduler.getNextLaunchBeat(1.0), 16.0);
+            expectEquals(scheduler.getNextLaunchBeat(16.0 + 1.0e-12), 16.0);
+
+            scheduler.setQuantization(ClipLaunchScheduler::Quantization::None);
+            expectEquals(scheduler.getNextLaunchBeat(2.37), 2.37);
+        }
+    }
+};
+
+static ClipLaunchSchedulerTest clipLaunchSchedulerTest;
@@ -0,0 +1,243 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/CompRenderer.h"
+#include "../Audio/Recording/CompingSystem.h"
+#include <atomic>
+#include <thread>
+
+using namespace omega;
+
+class CompRendererTest : public juce::UnitTest {
+public:
+    CompRendererTest() : juce::UnitTest("CompRenderer", "DSP") {}
+
+    void runTest() override {
+        const int takeLength = 48000;
+
+        auto makeTake = [&](float value, int channels = 1) {
+            juce::AudioBuffer<float> take(channels, takeLength);
+            for (int ch = 0; ch < channels; ++ch)
+                for (int i = 0; i < takeLength; ++i)
+                    take.setSample(ch, i, value);
+            return take;
+        };
+
+        auto region = [](int source, juce::int64 start, juce::int64 end, int fade) {
+            CompRenderer::Region r;
+            r.source = source;
+            r.start = start;
+            r.end = end;
+            r.fadeIn = r.fadeOut = fade;
+            return r;
+        };
+
+        auto renderRange = [](const CompRenderer& renderer, juce::int64 position, int numSamples, int block) {
+            juce::AudioBuffer<float> output(2, numSamples);
+            for (int offset = 0; offset < numSamples; offset += block) {
+                float* pointers[2] = { output.getWritePointer(0, offset), output.getWritePointer(1, offset) };
+                renderer.render(pointers, 2, position + offset, juce::jmin(block, numSamples - offset));
+            }
+            return output;
+        };
+
+        beginTest("Boundary crossfade keeps constant power");
+        {
+            auto one = makeTake(1.0f);
+            auto silence = makeTake(0.0f);
+
+            // Gain of each side measured with the other side silent
+            auto sideGain = [&](bool first) {
+                CompRenderer renderer;
+                renderer.prepare(2);
+                renderer.setSources({ first ? &one : &silence, first ? &silence : &one });
+                renderer.setRegions({ region(0, 0, 24000, 480), region(1, 24000, 48000, 480) });
+                return renderRange(renderer, 0, 48000, 512);
+            };
+            const auto a = sideGain(true);
+            const auto b = sideGain(false);
+
+            float maxError = 0.0f;
+            for (int i = 0; i < 48000; ++i) {
+                const float power = a.getSample(0, i) * a.getSample(0, i) + b.getSample(0, i) * b.getSample(0, i);
+                if (i >= 480 && i < 48000 - 480)
+                    maxError = juce::jmax(maxError, std::abs(power - 1.0f));
+            }
+            expectLessThan(maxError, 1.0e-5f);
+
+            // The crossfade straddles the boundary
+            expectGreaterThan(a.getSample(0, 24000 + 100), 0.0f);
+            expectGreaterThan(b.getSample(0, 24000 - 100), 0.0f);
+            expectEquals(a.getSample(0, 24000 + 240), 0.0f);
+            expectEquals(b.getSample(0, 24000 - 241), 0.0f);
+        }
+
+        beginTest("Later regions punch in over earlier ones");
+        {
+            auto one = makeTake(1.0f, 2);
+            auto two = makeTake(2.0f);
+
+            CompRenderer renderer;
+            renderer.prepare(2);
+            renderer.setSources({ &one, &two });
+            renderer.setRegions({ region(0, 0, 48000, 0), region(1, 10000, 20000, 0) });
+            const auto output = renderRange(renderer, 0, 48000, 1000);
+
+            expectEquals(output.getSample(0, 9999), 1.0f);
+            expectEquals(output.getSample(0, 10000), 2.0f);
+            expectEquals(output.getSample(1, 19999), 2.0f);   // Mono take feeds both channels
+            expectEquals(output.getSample(1, 20000), 1.0f);
+            expect(renderer.getLength() == 48000);
+        }
+
+        beginTest("Block size does not change the output");
+        {
+            juce::Random random(7);
+            std::vector<juce::AudioBuffer<float>> takes;
+            for (int t = 0; t < 3; ++t) {
+                juce::AudioBuffer<float> take(2, takeLength);
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < takeLength; ++i)
+                        take.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+                takes.push_back(take);
+            }
+
+            CompRenderer renderer;
+            renderer.prepare(2);
+            renderer.setSources({ &takes[0], &takes[1], &takes[2] });
+            renderer.setRegions({ region(0, 0, 20000, 300), region(1, 20000, 30000, 700), region(2, 30000, 48000, 100) });
+
+            const auto small = renderRange(renderer, 0, 48000, 37);
+            const auto large = renderRange(renderer, 0, 48000, 4096);
+            bool identical = true;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 48000 && identical; ++i)
+                    identical = small.getSample(ch, i) == large.getSample(ch, i);
+            expect(identical);
+        }
+
+        beginTest("Edits re-render only the changed range");
+        {
+            juce::Random random(11);
+            std::vector<juce::AudioBuffer<float>> takes;
+            std::vector<const juce::AudioBuffer<float>*> sources;
+            for (int t = 0; t < 20; ++t) {
+                juce::AudioBuffer<float> take(1, takeLength);
+                for (int i = 0; i < takeLength; ++i)
+                    take.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+                takes.push_back(take);
+            }
+            for (auto& take : takes)
+                sources.push_back(&take);
+
+            std::vector<CompRenderer::Region> regions;
+            for (int s = 0; s < 20; ++s)
+                regions.push_back(region(s, s * 2400, (s + 1) * 2400, 240));
+
+            CompRenderer renderer;
+            renderer.prepare(2);
+            renderer.setSources(sources);
+            renderer.setRegions(regions);
+            renderer.setFlattenEnabled(true);
+            expectEquals(renderer.updateFlattened(), (juce::int64) 48000);
+            expect(renderer.isFlattenedValid());
+
+            // Move one boundary by 100 samples
+            regions[5].end += 100;
+            regions[6].start += 100;
+            renderer.setRegions(regions);
+            expect(!renderer.isFlattenedValid());
+            const auto rendered = renderer.updateFlattened();
+            expectGreaterThan(rendered, (juce::int64) 0);
+            expectLessOrEqual(rendered, (juce::int64) (100 + 240));
+
+            // Same regions again: nothing to do
+            renderer.setRegions(regions);
+            expectEquals(renderer.updateFlattened(), (juce::int64) 0);
+
+            // The incremental result matches a full render
+            const auto full = renderRange(renderer, 0, 48000, 4096);
+            const auto& flattened = renderer.getFlattened();
+            expectEquals(flattened.getNumSamples(), 48000);
+            float maxError = 0.0f;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < 48000; ++i)
+                    maxError = juce::jmax(maxError, std::abs(flattened.getSample(ch, i) - full.getSample(ch, i)));
+            expectEquals(maxError, 0.0f);
+
+            // A changed take only invalidates its own pieces
+            juce::AudioBuffer<float> replacement(1, takeLength);
+            sources[3] = &replacement;
+            renderer.setSources(sources);
+            expectLessOrEqual(renderer.updateFlattened(), (juce::int64) (2400 + 240));
+        }
+
+        beginTest("Removing takes while the comp plays");
+        {
+            using namespace OmegaStudio::Audio::Recording;
+            const double sampleRate = 48000.0;
+            CompLane lane;
+            lane.prepare(sampleRate, 2);
+
+            // Every take is DC at 0.5: whatever the comp plays is 0.5 or a crossfade of it
+            auto makeLaneTake = [&] {
+                auto take = std::make_unique<Take>();
+                take->audioData = makeTake(0.5f);
+                take->duration = takeLength / sampleRate;
+                return take;
+            };
+
+            std::atomic<bool> stop { false };
+            std::atomic<int> blocks { 0 }, wildBlocks { 0 };
+            std::thread audio([&] {
+                juce::AudioBuffer<float> buffer(2, 512);
+                for (juce::int64 position = 0; !stop.load(); position = (position + 512) % takeLength) {
+                    lane.renderBlock(buffer, position);
+                    const float magnitude = buffer.getMagnitude(0, 512);
+                    if (!std::isfinite(magnitude) || magnitude > 0.5f * 1.5f)
+                        ++wildBlocks;
+                    ++blocks;
+                }
+            });
+
+            std::vector<juce::Uuid> ids;
+            for (int edit = 0; edit < 300; ++edit) {
+                auto take = makeLaneTake();
+                ids.push_back(take->id);
+                lane.addTake(std::move(take));
+
+                // One segment per take, a quarter of the timeline each
+                std::vector<CompSegment> segments;
+                for (size_t t = 0; t < ids.size(); ++t) {
+                    CompSegment segment;
+                    segment.takeId = ids[t];
+                    segment.startTime = (double) (t % 4) * 0.25;
+                    segment.endTime = segment.startTime + 0.25;
+                    segments.push_back(segment);
+                }
+                lane.setSegments(segments);
+
+                // The oldest take goes while its segment still points at it
+                if (ids.size() > 3) {
+                    lane.removeTake(ids.front());
+                    ids.erase(ids.begin());
+                }
+            }
+            stop.store(true);
+            audio.join();
+
+            expectGreaterThan(blocks.load(), 0);
+            expectEquals(wildBlocks.load(), 0);
+            expectEquals((int) lane.getTakes().size(), 3);
+
+            // Settled: the remaining takes cover three quarters of the timeline
+            juce::AudioBuffer<float> buffer(2, 512);
+            int covered = 0;
+            for (juce::int64 position = 0; position < takeLength; position += 512) {
+                lane.renderBlock(buffer, position);
+                covered += buffer.getSample(0, 256) > 0.49f ? 1 : 0;
+            }
+            expectWithinAbsoluteError(covered / (double) ((takeLength + 511) / 512), 0.75, 0.05);
+        }
+    }
+};
+
+static CompRendererTest compRendererTest;
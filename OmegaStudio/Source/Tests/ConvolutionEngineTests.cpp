@@ -0,0 +1,180 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/ConvolutionEngine.h"
+#include <thread>
+
+using namespace OmegaStudio;
+
+class ConvolutionEngineTest : public juce::UnitTest {
+public:
+    ConvolutionEngineTest() : juce::UnitTest("ConvolutionEngine", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        juce::Random random(37);
+
+        // Long enough to reach every partition level (the last one starts at 32768)
+        auto makeImpulse = [&](int numChannels, int length) {
+            juce::AudioBuffer<float> impulse(numChannels, length);
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < length; ++i)
+                    impulse.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * std::exp(-3.0f * (float) i / (float) length));
+            return impulse;
+        };
+
+        // Sparse input: noise bursts and lone impulses straddling the level boundaries,
+        // different per channel, so the direct reference stays cheap with a long IR
+        juce::AudioBuffer<float> input(2, 50000);
+        input.clear();
+        for (int ch = 0; ch < 2; ++ch) {
+            for (const int start : { 0, 4000 + 700 * ch, 16300, 32700 + 90 * ch })
+                for (int i = start; i < start + 160; ++i)
+                    input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+            for (const int position : { 1023, 8191 + ch, 24576, 49999 - ch })
+                input.setSample(ch, position, ch == 0 ? 0.8f : -0.6f);
+        }
+
+        // Direct convolution over the layout's paths (in -> out through IR channel)
+        auto directConvolution = [](const juce::AudioBuffer<float>& in, const juce::AudioBuffer<float>& impulse) {
+            struct Path { int input, output, irChannel; };
+            std::vector<Path> paths;
+            switch (impulse.getNumChannels()) {
+                case 1:  paths = { { 0, 0, 0 }, { 1, 1, 0 } }; break;
+                case 2:  paths = { { 0, 0, 0 }, { 1, 1, 1 } }; break;
+                default: paths = { { 0, 0, 0 }, { 0, 1, 1 }, { 1, 0, 2 }, { 1, 1, 3 } }; break;
+            }
+
+            const int length = in.getNumSamples() + impulse.getNumSamples() - 1;
+            std::vector<double> sums[2] = { std::vector<double>((size_t) length), std::vector<double>((size_t) length) };
+            for (const auto& path : paths) {
+                const float* x = in.getReadPointer(path.input);
+                const float* h = impulse.getReadPointer(path.irChannel);
+                for (int n = 0; n < in.getNumSamples(); ++n) {
+                    if (x[n] == 0.0f)
+                        continue;
+                    for (int k = 0; k < impulse.getNumSamples(); ++k)
+                        sums[path.output][(size_t) (n + k)] += (double) x[n] * h[k];
+                }
+            }
+
+            juce::AudioBuffer<float> output(2, length);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < length; ++i)
+                    output.setSample(ch, i, (float) sums[ch][(size_t) i]);
+            return output;
+        };
+
+        // Worst sample error relative to the reference peak
+        auto relativeError = [](const juce::AudioBuffer<float>& result, const juce::AudioBuffer<float>& reference) {
+            float peak = 0.0f, error = 0.0f;
+            for (int ch = 0; ch < 2; ++ch) {
+                for (int i = 0; i < reference.getNumSamples(); ++i) {
+                    const float value = i < result.getNumSamples() ? result.getSample(ch, i) : 0.0f;
+                    peak = juce::jmax(peak, std::abs(reference.getSample(ch, i)));
+                    error = juce::jmax(error, std::abs(value - reference.getSample(ch, i)));
+                }
+            }
+            return peak > 0.0f ? error / peak : error;
+        };
+
+        // Input followed by silence until the tail has rung out
+        auto processInBlocks = [&](ConvolutionEngine& engine, int length, int blockSize) {
+            juce::AudioBuffer<float> padded(2, length);
+            padded.clear();
+            for (int ch = 0; ch < 2; ++ch)
+                padded.copyFrom(ch, 0, input, ch, 0, input.getNumSamples());
+
+            juce::AudioBuffer<float> output(2, length);
+            for (int position = 0; position < length; position += blockSize) {
+                const int count = juce::jmin(blockSize, length - position);
+                const float* inputs[2] = { padded.getReadPointer(0, position), padded.getReadPointer(1, position) };
+                float* outputs[2] = { output.getWritePointer(0, position), output.getWritePointer(1, position) };
+                engine.process(inputs, 2, outputs, count);
+            }
+            return output;
+        };
+
+        const int irLength = 40000;
+        const juce::AudioBuffer<float> impulses[] = { makeImpulse(1, irLength), makeImpulse(2, irLength), makeImpulse(4, irLength) };
+        const char* layoutNames[] = { "mono", "stereo", "true stereo" };
+
+        beginTest("process() matches direct convolution for every layout and block size");
+        {
+            for (int layout = 0; layout < 3; ++layout) {
+                const auto& impulse = impulses[layout];
+                const auto reference = directConvolution(input, impulse);
+                auto ir = ConvolutionIR::create(impulse, sampleRate, false);
+
+                for (const bool background : { false, true }) {
+                    for (const int blockSize : { 1, 40, 64, 400, 5000 }) {
+                        ConvolutionEngine engine(background);
+                        engine.prepare(sampleRate, blockSize);
+                        engine.setImpulseResponse(ir);
+
+                        // The worker may be busy on a block the audio needs: offline, wait for it
+                        engine.setNonRealtime(true);
+
+                        const auto output = processInBlocks(engine, reference.getNumSamples(), blockSize);
+                        expectLessThan(relativeError(output, reference), 1.0e-5f);
+                        expectEquals(engine.getNumLateTailBlocks(), 0,
+                                     juce::String(layoutNames[layout]) + (background ? ", background" : ", inline")
+                                     + ", block " + juce::String(blockSize));
+                    }
+                }
+            }
+        }
+
+        beginTest("render() matches direct convolution");
+        {
+            for (int layout = 0; layout < 3; ++layout) {
+                const auto reference = directConvolution(input, impulses[layout]);
+
+                juce::AudioBuffer<float> output;
+                ConvolutionEngine::render(input, ConvolutionIR::create(impulses[layout], sampleRate, false), output);
+                expectEquals(output.getNumSamples(), reference.getNumSamples());
+                expectLessThan(relativeError(output, reference), 1.0e-5f);
+            }
+        }
+
+        beginTest("A saturated worker never stalls process(): late tail blocks play what is ready and are counted");
+        {
+            // Enough engines with a long true-stereo IR that one worker cannot keep
+            // up when every "audio" thread runs flat out. process() never waits for
+            // the worker; an engine with no late blocks is exact
+            const auto longImpulse = makeImpulse(4, 120000);
+            auto ir = ConvolutionIR::create(longImpulse, sampleRate, false);
+            const auto reference = directConvolution(input, longImpulse);
+
+            const int numEngines = 6;
+            std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+            std::vector<juce::AudioBuffer<float>> outputs((size_t) numEngines);
+            for (int e = 0; e < numEngines; ++e) {
+                engines.push_back(std::make_unique<ConvolutionEngine>(true));
+                engines.back()->prepare(sampleRate, 250);
+                engines.back()->setImpulseResponse(ir);
+            }
+
+            std::vector<std::thread> threads;
+            for (int e = 0; e < numEngines; ++e)
+                threads.emplace_back([&, e] { outputs[(size_t) e] = processInBlocks(*engines[(size_t) e], reference.getNumSamples(), 250); });
+            for (auto& thread : threads)
+                thread.join();
+
+            int late = 0;
+            for (int e = 0; e < numEngines; ++e) {
+                const auto& output = outputs[(size_t) e];
+                bool finite = true;
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < output.getNumSamples(); ++i)
+                        finite = finite && std::isfinite(output.getSample(ch, i));
+                expect(finite);
+
+                late += engines[(size_t) e]->getNumLateTailBlocks();
+                if (engines[(size_t) e]->getNumLateTailBlocks() == 0)
+                    expectLessThan(relativeError(output, reference), 1.0e-5f);
+            }
+            logMessage("Late tail blocks across " + juce::String(numEngines) + " engines: " + juce::String(late));
+        }
+    }
+};
+
+static ConvolutionEngineTest convolutionEngineTest;
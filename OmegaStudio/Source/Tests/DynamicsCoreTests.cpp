@@ -0,0 +1,120 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/DynamicsCore.h"
+#include "../Audio/DSP/SidechainCompression.h"
+
+using namespace OmegaStudio;
+
+class DynamicsCoreTest : public juce::UnitTest {
+public:
+    DynamicsCoreTest() : juce::UnitTest("DynamicsCore", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+
+        beginTest("Fast log2 / exp2 against the standard library");
+        {
+            float maxLogError = 0.0f;
+            for (float x = 1.0e-6f; x < 100.0f; x *= 1.001f)
+                maxLogError = juce::jmax(maxLogError, std::abs(Dynamics::fastLog2(x) - std::log2(x)));
+
+            float maxExpError = 0.0f;
+            for (float x = -30.0f; x < 10.0f; x += 0.001f)
+                maxExpError = juce::jmax(maxExpError, std::abs(Dynamics::fastExp2(x) / std::exp2(x) - 1.0f));
+
+            expect(maxLogError < 5.0e-5f, "log2 error " + juce::String(maxLogError));
+            expect(maxExpError < 1.0e-5f, "exp2 relative error " + juce::String(maxExpError));
+        }
+
+        beginTest("Table gain curve matches the exact soft-knee curve");
+        {
+            Dynamics::GainCurve::Parameters parameters;
+            parameters.threshold = -18.0f;
+            parameters.ratio = 4.0f;
+            parameters.knee = 6.0f;
+            parameters.makeup = 3.0f;
+
+            Dynamics::GainCurve curve;
+            curve.setParameters(parameters);
+
+            float maxError = 0.0f;
+            for (float levelDb = -100.0f; levelDb < 20.0f; levelDb += 0.01f) {
+                const float amplitude = juce::Decibels::decibelsToGain(levelDb, -200.0f);
+                const float power = amplitude * amplitude;
+                float gain = 0.0f, powerGain = 0.0f;
+                curve.process(&amplitude, &gain, 1);
+                curve.process(&power, &powerGain, 1, true);
+
+                const float expected = Dynamics::GainCurve::computeGainReductionDb(parameters, levelDb) + parameters.makeup;
+                maxError = juce::jmax(maxError, std::abs(juce::Decibels::gainToDecibels(gain) - expected),
+                                      std::abs(juce::Decibels::gainToDecibels(powerGain) - expected));
+            }
+            expect(maxError < 0.01f, "Curve error " + juce::String(maxError) + " dB");
+        }
+
+        beginTest("Envelope follower time constants");
+        {
+            Dynamics::EnvelopeFollower follower;
+            follower.setTimes(sampleRate, 1.0f, 100.0f);
+
+            std::vector<float> step(4800, 1.0f), envelope(4800);
+            follower.process(step.data(), envelope.data(), (int) step.size());
+            expectWithinAbsoluteError(envelope[47], 1.0f - std::exp(-1.0f), 1.0e-3f);
+
+            // The same follower in each of the four SIMD lanes gives the same result
+            Dynamics::EnvelopeFollower4 followers;
+            for (int lane = 0; lane < 4; ++lane)
+                followers.setTimes(lane, sampleRate, 1.0f, 100.0f);
+
+            std::vector<float> lanes(4 * step.size());
+            const float* inputs[4] = { step.data(), step.data(), step.data(), step.data() };
+            float* outputs[4];
+            for (int lane = 0; lane < 4; ++lane)
+                outputs[lane] = lanes.data() + (size_t) lane * step.size();
+            followers.process(inputs, outputs, (int) step.size());
+
+            for (int lane = 0; lane < 4; ++lane)
+                expectWithinAbsoluteError(outputs[lane][47], envelope[47], 1.0e-6f);
+        }
+
+        beginTest("Benchmark: 100 stereo sidechain compressors");
+        {
+            const int blockSize = 256;
+            const int numBlocks = 1875;              // 10 s
+            const int numChannels = 100;
+
+            // 0.5 s of programme, looped: the input is built outside the timed loop
+            juce::AudioBuffer<float> programme(2, blockSize * 94);
+            juce::Random random(7);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < programme.getNumSamples(); ++i)
+                    programme.setSample(ch, i, 0.5f * std::sin(0.05f * (float) i + (float) ch) + 0.01f * random.nextFloat());
+
+            std::vector<std::unique_ptr<Audio::DSP::SidechainCompressor>> compressors;
+            for (int i = 0; i < numChannels; ++i) {
+                compressors.push_back(std::make_unique<Audio::DSP::SidechainCompressor>());
+                compressors.back()->prepare(sampleRate, blockSize);
+                compressors.back()->setParameters({});
+            }
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < numBlocks; ++b) {
+                const int offset = (b % 94) * blockSize;
+                for (auto& compressor : compressors) {
+                    for (int ch = 0; ch < 2; ++ch)
+                        block.copyFrom(ch, 0, programme, ch, offset, blockSize);
+                    compressor->process(block);
+                }
+            }
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            const double seconds = numBlocks * blockSize / sampleRate;
+
+            logMessage(juce::String(numChannels) + " compressors: " + juce::String(elapsed * 1000.0, 1) + " ms for "
+                       + juce::String(seconds, 1) + " s (" + juce::String(elapsed / seconds * 100.0, 2) + "% of one core)");
+
+            expect(compressors.front()->getCurrentGainReduction() < -1.0f);
+        }
+    }
+};
+
+static DynamicsCoreTest dynamicsCoreTest;
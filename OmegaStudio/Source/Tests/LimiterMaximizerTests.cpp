@@ -0,0 +1,152 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/LimiterMaximizer.h"
+
+using namespace OmegaStudio;
+
+class LimiterMaximizerTest : public juce::UnitTest {
+public:
+    LimiterMaximizerTest() : juce::UnitTest("LimiterMaximizer", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+
+        beginTest("True-peak detector against reference sines");
+        {
+            // Sine with a short fade-in so the interpolator's start-up ringing doesn't count
+            auto makeSine = [&](double frequency, double phase, float amplitude) {
+                std::vector<float> signal((size_t) sampleRate);
+                for (size_t i = 0; i < signal.size(); ++i) {
+                    const double fade = juce::jmin(1.0, (double) i / 2000.0, (double) (signal.size() - 1 - i) / 2000.0);
+                    signal[i] = (float) (amplitude * fade * std::sin(juce::MathConstants<double>::twoPi * frequency * (double) i / sampleRate + phase));
+                }
+                return signal;
+            };
+
+            // fs/4 at 45 degrees: every sample sits at -3.01 dB of the true peak
+            auto quarter = makeSine(sampleRate / 4.0, juce::MathConstants<double>::pi / 4.0, 0.5f);
+            const float quarterSamplePeak = juce::FloatVectorOperations::findMaximum(quarter.data(), (int) quarter.size());
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(quarterSamplePeak / 0.5f), -3.01f, 0.01f);
+
+            const float offlineQuarter = TruePeakDetector::measure(quarter.data(), (int) quarter.size(), 4, TruePeakQuality::Offline);
+            expectWithinAbsoluteError(juce::Decibels::gainToDecibels(offlineQuarter / 0.5f), 0.0f, 0.05f);
+
+            for (const double frequency : { 997.0, 5000.0, 12000.0, 17000.0, 19000.0 }) {
+                const auto sine = makeSine(frequency, 0.3, 0.5f);
+                const int n = (int) sine.size();
+
+                for (const int factor : { 4, 8 }) {
+                    const float offline = TruePeakDetector::measure(sine.data(), n, factor, TruePeakQuality::Offline);
+                    const float realtime = TruePeakDetector::measure(sine.data(), n, factor, TruePeakQuality::Realtime);
+
+                    expectWithinAbsoluteError(juce::Decibels::gainToDecibels(offline / 0.5f), 0.0f, 0.05f,
+                                              "Offline " + juce::String(factor) + "x at " + juce::String(frequency) + " Hz");
+                    expectWithinAbsoluteError(juce::Decibels::gainToDecibels(realtime / 0.5f), 0.0f, 0.3f,
+                                              "Realtime " + juce::String(factor) + "x at " + juce::String(frequency) + " Hz");
+                }
+            }
+        }
+
+        beginTest("Sliding-window minimum matches brute force");
+        {
+            juce::Random random(42);
+            SlidingWindowMin window;
+            window.prepare(64);
+            window.setWindow(37);
+
+            std::vector<float> values(2000);
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = random.nextFloat();
+                const float result = window.push(values[i]);
+                const size_t first = i >= 36 ? i - 36 : 0;
+                expectEquals(result, *std::min_element(values.begin() + (long) first, values.begin() + (long) i + 1));
+            }
+        }
+
+        // Band-limited programme material ~7 dB over the ceiling
+        const int blockSize = 512;
+        const int numBlocks = 940;
+        juce::AudioBuffer<float> programme(2, blockSize * numBlocks);
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < programme.getNumSamples(); ++i) {
+                const double t = i / sampleRate;
+                const double twoPi = juce::MathConstants<double>::twoPi;
+                programme.setSample(ch, i, (float) (0.7 * std::sin(twoPi * 60.0 * t + ch)
+                                                    + 0.5 * std::sin(twoPi * 997.0 * t)
+                                                    + 0.4 * std::sin(twoPi * 11025.0 * t + 0.3 * ch)
+                                                    + 0.3 * std::sin(twoPi * 15000.0 * t) * std::sin(twoPi * 3.0 * t)));
+            }
+        }
+
+        auto runLimiter = [&](LimiterMaximizer& limiter, juce::AudioBuffer<float>& output) {
+            output.makeCopyOf(programme);
+            for (int block = 0; block < numBlocks; ++block) {
+                juce::AudioBuffer<float> view(output.getArrayOfWritePointers(), 2, block * blockSize, blockSize);
+                limiter.process(view);
+            }
+        };
+
+        auto makeSettings = [](TruePeakQuality quality, LimiterMaximizer::OversamplingFactor factor) {
+            LimiterMaximizer::Settings settings;
+            settings.ceiling = -1.0f;
+            settings.threshold = -6.0f;
+            settings.release = 50.0f;
+            settings.lookAhead = 5.0f;
+            settings.quality = quality;
+            settings.oversampling = factor;
+            return settings;
+        };
+
+        beginTest("Brickwall holds the true-peak ceiling");
+        {
+            for (const auto quality : { TruePeakQuality::Realtime, TruePeakQuality::Offline }) {
+                LimiterMaximizer limiter;
+                limiter.setSettings(makeSettings(quality, LimiterMaximizer::OversamplingFactor::x4));
+                limiter.prepare(sampleRate, blockSize);
+
+                juce::AudioBuffer<float> output;
+                runLimiter(limiter, output);
+
+                // Skip the look-ahead delay and the release of the start-up transient
+                const int start = limiter.getLatencySamples() + 4800;
+                const int length = output.getNumSamples() - start;
+                for (int ch = 0; ch < 2; ++ch) {
+                    const float samplePeak = output.getMagnitude(ch, start, length);
+                    const float truePeak = TruePeakDetector::measure(output.getReadPointer(ch, start), length, 8, TruePeakQuality::Offline);
+                    expect(juce::Decibels::gainToDecibels(samplePeak) <= -1.0f + 1.0e-4f, "Sample peak over the ceiling");
+                    expect(juce::Decibels::gainToDecibels(truePeak) <= -1.0f + 0.1f, "True peak over the ceiling");
+                }
+
+                const auto metering = limiter.getCurrentMetering();
+                expect(metering.gainReduction < -3.0f);
+                expect(metering.truePeak <= -0.9f);
+            }
+        }
+
+        beginTest("Benchmark: realtime vs offline quality at 2x/4x/8x");
+        {
+            const double seconds = programme.getNumSamples() / sampleRate;
+
+            for (const auto quality : { TruePeakQuality::Realtime, TruePeakQuality::Offline }) {
+                for (const auto factor : { LimiterMaximizer::OversamplingFactor::x2,
+                                           LimiterMaximizer::OversamplingFactor::x4,
+                                           LimiterMaximizer::OversamplingFactor::x8 }) {
+                    LimiterMaximizer limiter;
+                    limiter.setSettings(makeSettings(quality, factor));
+                    limiter.prepare(sampleRate, blockSize);
+
+                    juce::AudioBuffer<float> output;
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    runLimiter(limiter, output);
+                    const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+                    logMessage(juce::String(quality == TruePeakQuality::Realtime ? "Realtime " : "Offline ")
+                               + juce::String((int) factor) + "x: " + juce::String(elapsed * 1000.0, 1) + " ms for "
+                               + juce::String(seconds, 1) + " s stereo (" + juce::String(elapsed / seconds * 100.0, 2)
+                               + "% of real time), latency " + juce::String(limiter.getLatencySamples()) + " samples");
+                }
+            }
+        }
+    }
+};
+
+static LimiterMaximizerTest limiterMaximizerTest;
@@ -0,0 +1,137 @@
+#include <JuceHeader.h>
+#include "../Audio/Analysis/LoudnessMeter.h"
+
+using namespace omega::Analysis;
+
+class LoudnessMeterTest : public juce::UnitTest {
+public:
+    LoudnessMeterTest() : juce::UnitTest("LoudnessMeter", "DSP") {}
+
+    void runTest() override {
+        beginTest("Stereo 997 Hz sine at -20 dBFS reads -20 LUFS");
+        {
+            for (double sampleRate : { 44100.0, 48000.0, 96000.0 }) {
+                auto buffer = makeSine(sampleRate, 10.0, 997.0, { { 0.0, -20.0f } });
+
+                const auto offline = LoudnessMeter::measure(buffer, sampleRate);
+                expectWithinAbsoluteError(offline.integratedLUFS, -20.0f, 0.05f);
+
+                LoudnessMeter meter;
+                meter.prepare(sampleRate, 2);
+                feed(meter, buffer, 512);
+                expectWithinAbsoluteError(meter.getIntegrated(), -20.0f, 0.05f);
+                expectWithinAbsoluteError(meter.getMomentary(), -20.0f, 0.05f);
+                expectWithinAbsoluteError(meter.getShortTerm(), -20.0f, 0.05f);
+            }
+        }
+
+        beginTest("Relative gate ignores the quiet part");
+        {
+            // 10 s at -23 dBFS then 10 s at -40 dBFS: the quiet blocks fall under the -10 LU gate
+            const double sampleRate = 48000.0;
+            auto buffer = makeSine(sampleRate, 20.0, 1000.0, { { 0.0, -23.0f }, { 10.0, -40.0f } });
+            expectWithinAbsoluteError(LoudnessMeter::measure(buffer, sampleRate).integratedLUFS, -23.0f, 0.1f);
+
+            // Below the absolute gate nothing counts
+            auto silent = makeSine(sampleRate, 5.0, 1000.0, { { 0.0, -80.0f } });
+            expectEquals(LoudnessMeter::measure(silent, sampleRate).integratedLUFS, LoudnessMeter::kMinimumLoudness);
+        }
+
+        beginTest("Loudness range of a 10 dB step (EBU Tech 3342)");
+        {
+            const double sampleRate = 48000.0;
+            auto buffer = makeSine(sampleRate, 40.0, 1000.0, { { 0.0, -20.0f }, { 20.0, -30.0f } });
+            const auto result = LoudnessMeter::measure(buffer, sampleRate);
+            expectWithinAbsoluteError(result.loudnessRange, 10.0f, 1.0f);
+            expectWithinAbsoluteError(result.maxShortTermLUFS, -20.0f, 0.1f);
+        }
+
+        beginTest("True peak between samples");
+        {
+            // fs/4 at 45 degrees: every sample at 0.707, the waveform reaches 1.0
+            const double sampleRate = 48000.0;
+            juce::AudioBuffer<float> buffer(2, (int) sampleRate);
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                const float sample = (float) std::sin(juce::MathConstants<double>::halfPi * i + juce::MathConstants<double>::pi / 4.0);
+                buffer.setSample(0, i, sample);
+                buffer.setSample(1, i, sample);
+            }
+
+            expectWithinAbsoluteError(LoudnessMeter::measure(buffer, sampleRate).truePeak, 0.0f, 0.2f);
+
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            feed(meter, buffer, 480);
+            expectWithinAbsoluteError(meter.getTruePeak(), 0.0f, 0.3f);
+        }
+
+        beginTest("Parallel measurement matches one streaming pass");
+        {
+            const double sampleRate = 44100.0;
+            const int length = (int) (sampleRate * 150.0) + 1234;
+            juce::AudioBuffer<float> buffer(2, length);
+            juce::Random random(42);
+            float level = 0.1f;
+            for (int i = 0; i < length; ++i) {
+                // Noise with a slowly wandering level, so gating and LRA have work to do
+                if (i % 22050 == 0)
+                    level = juce::jlimit(0.001f, 0.5f, level * std::exp(random.nextFloat() - 0.5f));
+                buffer.setSample(0, i, level * (random.nextFloat() * 2.0f - 1.0f));
+                buffer.setSample(1, i, level * (random.nextFloat() * 2.0f - 1.0f));
+            }
+
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2, false);
+            feed(meter, buffer, 1000);
+
+            const auto single = LoudnessMeter::measure(buffer, sampleRate, 1);
+            const auto parallel = LoudnessMeter::measure(buffer, sampleRate, 4);
+
+            expectWithinAbsoluteError(single.integratedLUFS, meter.getIntegrated(), 1.0e-4f);
+            expectWithinAbsoluteError(parallel.integratedLUFS, single.integratedLUFS, 1.0e-4f);
+            expectWithinAbsoluteError(parallel.loudnessRange, single.loudnessRange, 1.0e-4f);
+            expectWithinAbsoluteError(parallel.maxMomentaryLUFS, single.maxMomentaryLUFS, 1.0e-4f);
+            expectEquals(parallel.truePeak, single.truePeak);
+
+            const float reference = juce::jmax(
+                OmegaStudio::TruePeakDetector::measure(buffer.getReadPointer(0), length),
+                OmegaStudio::TruePeakDetector::measure(buffer.getReadPointer(1), length));
+            expectEquals(parallel.truePeak, juce::Decibels::gainToDecibels(reference, LoudnessMeter::kMinimumPeak));
+
+            const auto begin = juce::Time::getHighResolutionTicks();
+            LoudnessMeter::measure(buffer, sampleRate);
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - begin);
+            logMessage("Whole-buffer measurement at " + juce::String(length / sampleRate / seconds, 0) + "x real time");
+        }
+    }
+
+private:
+    struct Segment { double start; float levelDb; };
+
+    // Same sine in both channels, level changing at each segment start
+    static juce::AudioBuffer<float> makeSine(double sampleRate, double seconds, double frequency,
+                                             std::vector<Segment> segments) {
+        juce::AudioBuffer<float> buffer(2, (int) (sampleRate * seconds));
+        size_t segment = 0;
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            while (segment + 1 < segments.size() && i >= segments[segment + 1].start * sampleRate)
+                ++segment;
+            const float sample = juce::Decibels::decibelsToGain(segments[segment].levelDb)
+                               * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+            buffer.setSample(0, i, sample);
+            buffer.setSample(1, i, sample);
+        }
+        return buffer;
+    }
+
+    static void feed(LoudnessMeter& meter, const juce::AudioBuffer<float>& buffer, int blockSize) {
+        const float* channels[2];
+        for (int start = 0; start < buffer.getNumSamples(); start += blockSize) {
+            for (int ch = 0; ch < 2; ++ch)
+                channels[ch] = buffer.getReadPointer(ch, start);
+            meter.process(channels, 2, juce::jmin(blockSize, buffer.getNumSamples() - start));
+        }
+    }
+};
+
+static LoudnessMeterTest loudnessMeterTest;
@@ -0,0 +1,233 @@
+#include <JuceHeader.h>
+#include <atomic>
+#include <cmath>
+#include "../MIDI/MIDIClockGenerator.h"
+#include "../MIDI/MIDIInputClock.h"
+#include "../MIDI/MIDIOutputThread.h"
+
+using namespace OmegaStudio::MIDI;
+
+class MIDIClockTest : public juce::UnitTest {
+public:
+    MIDIClockTest() : juce::UnitTest("MIDIClock", "MIDI") {}
+
+    void runTest() override {
+        beginTest("Clock ticks follow a tempo ramp in closed form");
+        {
+            const double sampleRate = 48000.0;
+            ClockTempoMap map(120.0);
+            map.addChange(4.0, 140.0, 8.0);  // 120 -> 140 BPM over beats 4..12
+
+            MIDIClockGenerator clock;
+            clock.prepare(sampleRate);
+            clock.setTempoMap(map);
+            clock.start(0.0);
+
+            RTEventQueue queue;
+            std::vector<int64_t> tickSamples;
+            int starts = 0;
+            const int blockSize = 256;
+
+            for (int64_t block = 0; block < 2000; ++block) {
+                const int64_t blockStart = block * blockSize;
+                clock.process(blockStart, blockSize, (double) blockStart / sampleRate, 1.0 / sampleRate, queue);
+
+                while (auto ev = queue.pop()) {
+                    if (ev->bytes[0] == 0xfa) ++starts;
+                    if (ev->bytes[0] == 0xf8) tickSamples.push_back(blockStart + ev->samplePosition);
+                    expectWithinAbsoluteError(ev->timestamp, (double) (blockStart + ev->samplePosition) / sampleRate, 1.0e-9);
+                }
+            }
+
+            expectEquals(starts, 1);
+            expect(tickSamples.size() > (size_t) (16 * MIDIClockGenerator::kPPQN), "Should cover the whole ramp");
+
+            int worst = 0;
+            for (size_t n = 0; n < tickSamples.size(); ++n) {
+                const double expected = map.beatToSeconds((double) n / MIDIClockGenerator::kPPQN) * sampleRate;
+                worst = juce::jmax(worst, (int) std::abs((double) tickSamples[n] - expected));
+            }
+            expect(worst <= 1, "Ticks must land within one sample of the tempo map, got " + juce::String(worst));
+
+            // Beat 12 ends the ramp: 4 beats at 120 BPM + 60 / 2.5 * ln(140 / 120) for the ramp
+            expectWithinAbsoluteError(map.beatToSeconds(12.0), 2.0 + 24.0 * std::log(140.0 / 120.0), 1.0e-9);
+            expectWithinAbsoluteError(map.secondsToBeat(map.beatToSeconds(7.3)), 7.3, 1.0e-9);
+        }
+
+        beginTest("Locate sends song position and continue");
+        {
+            MIDIClockGenerator clock;
+            clock.prepare(44100.0);
+            clock.start(2.1);  // snaps to the next sixteenth: 2.25 beats = 9 sixteenths
+
+            RTEventQueue queue;
+            clock.process(0, 512, 0.0, 1.0 / 44100.0, queue);
+
+            auto spp = queue.pop();
+            expect(spp.has_value() && spp->bytes[0] == 0xf2 && spp->bytes[1] == 9 && spp->bytes[2] == 0);
+            auto cont = queue.pop();
+            expect(cont.has_value() && cont->bytes[0] == 0xfb);
+        }
+
+        beginTest("Input clock maps arrival times to sample offsets one block late");
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 256;
+            const double drift = 1.0e-4;                         // Sound card 100 ppm slow
+            const double period = blockSize / sampleRate * (1.0 + drift);
+            const double maxWakeDelay = 0.002;
+            const double meanWakeDelay = 0.5 * maxWakeDelay;
+
+            MIDIInputClock clock;
+            clock.prepare(sampleRate, blockSize);
+
+            // Callbacks wake up 0..2 ms late; the loop settles on the mean delay,
+            // which is a constant latency, so events are stamped relative to it
+            juce::Random random(29);
+            const double t0 = 1000.0;
+            std::vector<double> errors;
+            double measuredRate = 0.0;
+            for (int block = 0; block < 6000; ++block) {
+                const double blockStart = t0 + block * period;
+                clock.beginBlock(blockStart + random.nextDouble() * maxWakeDelay, blockSize);
+
+                // Played during the previous block period, placed inside this one
+                // (away from the edges, where the offset is clamped)
+                const int expected = 16 + random.nextInt(blockSize - 32);
+                const double stamp = blockStart + meanWakeDelay - period + (expected + 0.5) / blockSize * period;
+                if (block >= 3000) {  // Loop settled
+                    errors.push_back(clock.toSampleOffset(stamp) - expected);
+                    measuredRate += clock.getMeasuredSampleRate();
+                }
+            }
+
+            double sum = 0.0, sumSquares = 0.0;
+            for (double e : errors) { sum += e; sumSquares += e * e; }
+            const double mean = sum / (double) errors.size();
+            const double stdDev = std::sqrt(juce::jmax(0.0, sumSquares / (double) errors.size() - mean * mean));
+
+            expect(clock.isLocked());
+
+            // Raw wake-up times would scatter notes by ~28 samples (std)
+            expectLessThan(stdDev, 6.0);
+            expectWithinAbsoluteError(mean, 0.0, 2.0);
+
+            // Per block the estimate wanders by a few Hz; on average it finds the drift
+            measuredRate /= (double) errors.size();
+            expectWithinAbsoluteError(measuredRate, sampleRate / (1.0 + drift), 1.0);
+            expectEquals(clock.getLatencySamples(), blockSize);
+        }
+
+        beginTest("Loopback: ticks leave the output thread at their computed due times");
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 256;
+            const double blockSeconds = blockSize / sampleRate;
+
+            RTEventQueue queue;
+            MIDIOutputThread output(queue);
+
+            std::atomic<int> received { 0 };
+            juce::CriticalSection resultsLock;
+            std::vector<double> errors, dues;
+            errors.reserve(4096);
+            dues.reserve(4096);
+
+            auto record = [&](double receivedAt, double due) {
+                const juce::ScopedLock sl(resultsLock);
+                errors.push_back(receivedAt - due);
+                ++received;
+            };
+
+            // Virtual port where the platform supports it, otherwise an in-process sink
+            struct Loopback : juce::MidiInputCallback {
+                std::function<void(const juce::MidiMessage&)> onMessage;
+                void handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& m) override { onMessage(m); }
+            } loopback;
+
+            std::unique_ptr<juce::MidiOutput> virtualOut = juce::MidiOutput::createNewDevice("OmegaStudio Clock Loopback");
+            std::unique_ptr<juce::MidiInput> loopIn;
+            std::atomic<double> lastDue { 0.0 };
+
+            if (virtualOut != nullptr) {
+                for (const auto& device : juce::MidiInput::getAvailableDevices()) {
+                    if (device.name.contains("OmegaStudio Clock Loopback")) {
+                        loopIn = juce::MidiInput::openDevice(device.identifier, &loopback);
+                        break;
+                    }
+                }
+            }
+
+            if (loopIn != nullptr) {
+                loopback.onMessage = [&](const juce::MidiMessage& m) {
+                    if (m.getRawData()[0] == 0xf8) record(m.getTimeStamp(), lastDue.load());
+                };
+                output.setSendCallback([&](const juce::MidiMessage& m, double due) {
+                    lastDue.store(due);
+                    if (m.getRawData()[0] == 0xf8) { const juce::ScopedLock sl(resultsLock); dues.push_back(due); }
+                    virtualOut->sendMessageNow(m);
+                });
+                loopIn->start();
+                logMessage("Loopback through virtual MIDI port");
+            } else {
+                output.setSendCallback([&](const juce::MidiMessage& m, double due) {
+                    if (m.getRawData()[0] == 0xf8) {
+                        record(juce::Time::getMillisecondCounterHiRes() * 0.001, due);
+                        const juce::ScopedLock sl(resultsLock);
+                        dues.push_back(due);
+                    }
+                });
+                logMessage("Virtual MIDI ports unavailable, measuring in-process");
+            }
+
+            output.startThread(juce::Thread::Priority::highest);
+
+            MIDIClockGenerator clock;
+            clock.prepare(sampleRate);
+            clock.setTempoMap(ClockTempoMap(125.0));
+            clock.setOutputOffsetSeconds(0.010);  // lookahead, as a device output latency would be
+            clock.start(0.0);
+
+            // Simulated audio callback: paced in real time with scheduler jitter
+            const double t0 = juce::Time::getMillisecondCounterHiRes() * 0.001;
+            const int numBlocks = (int) (2.0 / blockSeconds);
+            for (int block = 0; block < numBlocks; ++block) {
+                const double blockTime = t0 + block * blockSeconds;
+                while (juce::Time::getMillisecondCounterHiRes() * 0.001 < blockTime)
+                    juce::Thread::sleep(1);
+                clock.process((int64_t) block * blockSize, blockSize, blockTime, 1.0 / sampleRate, queue);
+            }
+            juce::Thread::sleep(100);
+
+            output.stopThread(1000);
+            if (loopIn != nullptr) loopIn->stop();
+
+            const juce::ScopedLock sl(resultsLock);
+            double sum = 0.0, sumSquares = 0.0, worst = 0.0;
+            for (double e : errors) { sum += e; sumSquares += e * e; worst = juce::jmax(worst, std::abs(e)); }
+            const double n = juce::jmax<double>(1.0, (double) errors.size());
+            const double mean = sum / n;
+            const double stdDev = std::sqrt(juce::jmax(0.0, sumSquares / n - mean * mean));
+
+            logMessage("MIDI clock loopback: " + juce::String(received.load()) + " ticks, mean "
+                       + juce::String(mean * 1000.0, 3) + " ms, jitter (std) " + juce::String(stdDev * 1000.0, 3)
+                       + " ms, max " + juce::String(worst * 1000.0, 3) + " ms");
+
+            // Arrival jitter depends on the OS scheduler and is only reported. What the
+            // engine controls is the due time: every tick sent, in order, on the tempo
+            // grid offset by the lookahead (2 s at 125 BPM = 100 ticks, minus the tail)
+            const double tickSeconds = 60.0 / (125.0 * 24.0);
+            expect(received.load() >= 95, "Ticks should arrive through the loopback");
+            expect(dues.size() >= 95, "Ticks should leave the output thread");
+
+            int offGrid = 0;
+            for (size_t i = 0; i < dues.size(); ++i) {
+                const double ticks = (dues[i] - t0 - 0.010) / tickSeconds;
+                offGrid += std::abs(ticks - (double) i) > 1.0e-4 ? 1 : 0;
+            }
+            expectEquals(offGrid, 0);
+        }
+    }
+};
+
+static MIDIClockTest midiClockTest;
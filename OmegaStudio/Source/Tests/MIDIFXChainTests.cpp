@@ -0,0 +1,213 @@
+#include <JuceHeader.h>
+#include "../Sequencer/MIDIFXChain.h"
+
+using namespace OmegaStudio::Sequencer::MIDIFX;
+
+class MIDIFXChainTest : public juce::UnitTest {
+public:
+    MIDIFXChainTest() : juce::UnitTest("MIDIFXChain", "MIDI") {}
+
+    void runTest() override {
+        beginTest("Event buffer stays sorted and respects stage budget");
+        {
+            MidiEventBuffer events(8);
+            events.add(MidiEvent::noteOn(1, 60, 100, 40));
+            events.add(MidiEvent::noteOn(1, 62, 100, 10));
+            events.add(MidiEvent::noteOn(1, 64, 100, 25));
+            expect(events[0].samplePosition == 10 && events[1].samplePosition == 25 && events[2].samplePosition == 40,
+                   "Events should be time-sorted on insert");
+
+            events.beginStage(1);
+            expect(events.add(MidiEvent::noteOff(1, 60, 50)), "First event within budget");
+            expect(!events.add(MidiEvent::noteOff(1, 62, 60)), "Second event exceeds budget");
+            events.endStage();
+            expectEquals(events.getDroppedEvents(), 1);
+        }
+
+        beginTest("Chord stage replaces root with chord and releases it");
+        {
+            MIDIFXChain chain;
+            chain.addStage(std::make_unique<ChordStage>("Chord"));
+
+            MidiEventBuffer events(64);
+            BlockContext ctx { 48000.0, 120.0, 256, 0 };
+            events.add(MidiEvent::noteOn(1, 60, 100, 0));
+            events.add(MidiEvent::noteOff(1, 60, 128));
+            chain.process(events, ctx);
+
+            int ons = 0, offs = 0;
+            for (const auto& e : events) { ons += e.isNoteOn() ? 1 : 0; offs += e.isNoteOff() ? 1 : 0; }
+            expectEquals(ons, 3);
+            expectEquals(offs, 3);
+        }
+
+        beginTest("Arpeggiator keeps the note-on channel across blocks");
+        {
+            Arpeggiator arp;
+            Arpeggiator::Parameters params;
+            params.rate = 0.25f;
+            params.gate = 1.5f;
+            arp.setParameters(params);
+
+            MidiEventBuffer events(64);
+            int steps = 0, wrongChannel = 0;
+            for (int block = 0; block < 16; ++block) {
+                events.clear();
+                if (block == 0)
+                    events.add(MidiEvent::noteOn(5, 60, 100, 0));
+
+                arp.process(events, BlockContext { 48000.0, 120.0, 512, (int64_t)block * 512 });
+                for (const auto& e : events) {
+                    steps += e.isNoteOn() ? 1 : 0;
+                    wrongChannel += e.getChannel() != 5 ? 1 : 0;
+                }
+            }
+            expectGreaterThan(steps, 1);
+            expectEquals(wrongChannel, 0);
+        }
+
+        beginTest("Echo never leaves an echoed note-on without its note-off");
+        {
+            MIDIEcho echo;
+            MIDIEcho::Parameters params;
+            params.enabled = true;
+            params.numRepeats = 8;
+            params.velocityDecay = 1.0f;
+            echo.setParameters(params);
+
+            // 200 notas x 8 ecos desbordan la cola de 1024: los note-ons que no
+            // caben se pierden, pero ninguno de los que suenan queda sin note-off
+            MidiEventBuffer events(4096);
+            std::array<int, 16 * 128> sounding {};
+            int echoedOns = 0;
+            for (int block = 0; block < 400; ++block) {
+                events.clear();
+                for (int n = 0; n < 200; ++n) {
+                    if (block == 0)
+                        events.add(MidiEvent::noteOn(1 + n / 100, n % 100, 100, n));
+                    else if (block == 10)
+                        events.add(MidiEvent::noteOff(1 + n / 100, n % 100, n));
+                }
+
+                echo.process(events, BlockContext { 48000.0, 120.0, 512, (int64_t)block * 512 });
+                for (const auto& e : events) {
+                    auto& count = sounding[(size_t)((e.getChannel() - 1) * 128 + e.getNoteNumber())];
+                    if (e.isNoteOn()) {
+                        ++count;
+                        echoedOns += block > 0 ? 1 : 0;
+                    } else if (e.isNoteOff()) {
+                        --count;
+                    }
+                }
+            }
+
+            int unbalanced = 0;
+            for (int count : sounding)
+                unbalanced += count != 0 ? 1 : 0;
+            expectGreaterThan(echoedOns, 0);
+            expectEquals(unbalanced, 0);
+        }
+
+        beginTest("Rack hands every event back through the swapped buffer");
+        {
+            MIDIFXRack rack;
+            rack.prepare(48000.0, 256);
+
+            const juce::uint8 sysex[] = { 0xf0, 0x7e, 0x7f, 0x06, 0x01, 0xf7 };
+            juce::MidiBuffer midi;
+            int wrong = 0;
+            for (int block = 0; block < 8; ++block) {
+                midi.clear();
+                for (int i = 0; i < 3 + block; ++i)
+                    midi.addEvent(juce::MidiMessage::noteOn(1 + i % 16, 40 + i, (juce::uint8)100), i * 10);
+                midi.addEvent(sysex, (int)sizeof(sysex), 5);
+
+                rack.processBlock(midi, 256, (int64_t)block * 256);
+
+                int notes = 0, sysexes = 0;
+                for (const auto metadata : midi) {
+                    const auto message = metadata.getMessage();
+                    if (message.isNoteOn()) {
+                        ++notes;
+                        wrong += metadata.samplePosition != (message.getNoteNumber() - 40) * 10 ? 1 : 0;
+                    }
+                    sysexes += message.isSysEx() ? 1 : 0;
+                }
+                wrong += notes != 3 + block ? 1 : 0;
+                wrong += sysexes != 1 ? 1 : 0;
+            }
+            expectEquals(wrong, 0);
+        }
+
+        beginTest("Benchmark: 6-stage chain on 16 channels");
+        {
+            MIDIFXRack rack;
+            rack.prepare(48000.0, 128);
+            rack.setTempo(128.0);
+
+            for (int ch = 1; ch <= MIDIFXRack::kNumChannels; ++ch) {
+                auto& chain = rack.getChain(ch);
+
+                auto scale = std::make_unique<ScaleStage>("Scale");
+                scale->getEffect().setScale(ScaleMapper::Scale::Minor, 60);
+                chain.addStage(std::move(scale));
+                chain.addStage(std::make_unique<ChordStage>("Chord"));
+
+                auto arp = std::make_unique<ArpeggiatorStage>("Arp");
+                Arpeggiator::Parameters arpParams;
+                arpParams.rate = 0.125f;
+                arp->getEffect().setParameters(arpParams);
+                chain.addStage(std::move(arp));
+
+                auto repeat = std::make_unique<NoteRepeatStage>("Repeat");
+                NoteRepeat::Parameters repeatParams;
+                repeatParams.enabled = true;
+                repeat->getEffect().setParameters(repeatParams);
+                chain.addStage(std::move(repeat));
+
+                auto random = std::make_unique<RandomizerStage>("Random");
+                MIDIRandomizer::Parameters randomParams;
+                randomParams.velocityAmount = 0.2f;
+                random->getEffect().setParameters(randomParams);
+                chain.addStage(std::move(random));
+
+                auto echo = std::make_unique<EchoStage>("Echo");
+                MIDIEcho::Parameters echoParams;
+                echoParams.enabled = true;
+                echo->getEffect().setParameters(echoParams);
+                chain.addStage(std::move(echo));
+            }
+
+            const int blockSize = 128;
+            const int numBlocks = 4000;
+            juce::MidiBuffer midi;
+            midi.ensureSize(64 * 1024);
+            int64_t eventsOut = 0;
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int block = 0; block < numBlocks; ++block) {
+                midi.clear();
+                if (block % 16 == 0) {
+                    for (int ch = 1; ch <= MIDIFXRack::kNumChannels; ++ch)
+                        midi.addEvent(juce::MidiMessage::noteOn(ch, 48 + ch, (juce::uint8)100), ch);
+                } else if (block % 16 == 8) {
+                    for (int ch = 1; ch <= MIDIFXRack::kNumChannels; ++ch)
+                        midi.addEvent(juce::MidiMessage::noteOff(ch, 48 + ch), ch);
+                }
+
+                rack.processBlock(midi, blockSize, (int64_t)block * blockSize);
+                eventsOut += midi.getNumEvents();
+            }
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            const double audioSeconds = (double)numBlocks * blockSize / 48000.0;
+
+            logMessage("MIDIFXChain: " + juce::String((double)eventsOut / juce::jmax(1.0e-9, seconds), 0)
+                       + " events/sec, " + juce::String(seconds / audioSeconds * 100.0, 3)
+                       + "% of realtime, dropped " + juce::String(rack.getDroppedEvents()));
+
+            expect(eventsOut > 0, "Chain should produce events");
+        }
+    }
+};
+
+static MIDIFXChainTest midiFXChainTest;
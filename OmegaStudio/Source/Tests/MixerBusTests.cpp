@@ -0,0 +1,332 @@
+#include <JuceHeader.h>
+#include "../Mixer/MixerEngine.h"
+#include <atomic>
+#include <thread>
+
+using namespace OmegaStudio;
+
+class MixerBusTest : public juce::UnitTest {
+public:
+    MixerBusTest() : juce::UnitTest("MixerBus", "Mixer") {}
+
+    void runTest() override {
+        beginTest("Group routing and pre/post-fader sends");
+        {
+            const int blockSize = 256;
+            MixerEngine mixer;
+            mixer.setNumWorkerThreads(0);
+            mixer.getMasterBus()->setVolume(1.0f);
+
+            mixer.addBus(std::make_unique<MixerBus>("Group", MixerBus::Type::Group));
+            mixer.addBus(std::make_unique<MixerBus>("Reverb", MixerBus::Type::SendReturn));
+            mixer.addBus(std::make_unique<MixerBus>("Delay", MixerBus::Type::SendReturn));
+            for (int b = 0; b < mixer.getNumBuses(); ++b)
+                mixer.getBus(b)->setVolume(1.0f);
+
+            auto channel = std::make_unique<ChannelStrip>("Lead");
+            channel->setVolume(0.5f);
+            channel->setOutputBus(1);                    // Group -> master
+            channel->addSend({ 2, 0.25f, true, false }); // Reverb, pre-fader
+            channel->addSend({ 3, 0.5f, false, false }); // Delay, post-fader
+            mixer.addChannel(std::move(channel));
+            mixer.prepareToPlay(48000.0, blockSize);
+
+            juce::AudioBuffer<float> input(2, blockSize), master(2, blockSize);
+            std::vector<juce::AudioBuffer<float>*> buffers { &input };
+            std::vector<juce::MidiBuffer*> midi;
+
+            auto runBlock = [&] {
+                for (int ch = 0; ch < 2; ++ch)
+                    juce::FloatVectorOperations::fill(input.getWritePointer(ch), 1.0f, blockSize);
+                mixer.process(buffers, midi, master);
+            };
+
+            // Fader 0.5 -> group 0.5, reverb 1.0 * 0.25, delay 0.5 * 0.5
+            runBlock();
+            expectWithinAbsoluteError(master.getSample(0, blockSize - 1), 1.0f, 1.0e-5f);
+            expectWithinAbsoluteError(master.getSample(1, 10), 1.0f, 1.0e-5f);
+
+            // Fader down: only the pre-fader send survives once the ramp has finished
+            mixer.getChannel(0)->setVolume(0.0f);
+            runBlock();
+            runBlock();
+            expectWithinAbsoluteError(master.getSample(0, 0), 0.25f, 1.0e-5f);
+            expectWithinAbsoluteError(master.getSample(1, blockSize - 1), 0.25f, 1.0e-5f);
+
+            // Removing the group sends the channel to master and shifts the send indices
+            mixer.getChannel(0)->setVolume(0.5f);
+            mixer.removeBus(0);
+            expectEquals(mixer.getChannel(0)->getOutputBus(), 0);
+            expectEquals(mixer.getChannel(0)->getSend(0).busIndex, 1);
+            runBlock();
+            runBlock();
+            expectWithinAbsoluteError(master.getSample(0, blockSize - 1), 1.0f, 1.0e-5f);
+            
+            // Removing the reverb send leaves the delay send's ramp where it was:
+            // 0.5 direct + 0.5 * 0.5 delay from the first sample
+            mixer.removeChannelSend(0, 0);
+            expectEquals(mixer.getChannel(0)->getNumSends(), 1);
+            runBlock();
+            expectWithinAbsoluteError(master.getSample(0, 0), 0.75f, 1.0e-5f);
+            expectWithinAbsoluteError(master.getSample(1, blockSize - 1), 0.75f, 1.0e-5f);
+            
+            // Edits on the strip alone are model only until the engine recompiles
+            mixer.getChannel(0)->setSendLevel(0, 0.0f);
+            runBlock();
+            expectWithinAbsoluteError(master.getSample(0, blockSize - 1), 0.75f, 1.0e-5f);
+            mixer.setChannelSendLevel(0, 0, 0.0f);
+            runBlock();
+            runBlock();
+            expectWithinAbsoluteError(master.getSample(0, blockSize - 1), 0.5f, 1.0e-5f);
+        }
+
+        beginTest("Bus chains run in dependency order and cycles are broken");
+        {
+            const int blockSize = 128;
+            MixerEngine mixer;
+            mixer.setNumWorkerThreads(2);
+            mixer.getMasterBus()->setVolume(1.0f);
+
+            for (int b = 0; b < 3; ++b) {
+                mixer.addBus(std::make_unique<MixerBus>("Bus " + juce::String(b + 1), MixerBus::Type::Group));
+                mixer.getBus(b)->setVolume(0.5f);
+            }
+            mixer.setBusOutput(0, 2);   // Bus 1 -> Bus 2 -> Bus 3 -> master
+            mixer.setBusOutput(1, 3);
+            expect(!mixer.hasRoutingCycle());
+
+            auto channel = std::make_unique<ChannelStrip>("Source");
+            channel->setVolume(1.0f);
+            channel->setOutputBus(1);
+            mixer.addChannel(std::move(channel));
+            mixer.prepareToPlay(48000.0, blockSize);
+
+            juce::AudioBuffer<float> input(2, blockSize), master(2, blockSize);
+            std::vector<juce::AudioBuffer<float>*> buffers { &input };
+            std::vector<juce::MidiBuffer*> midi;
+            input.clear();
+            input.setSample(0, 0, 1.0f);
+            mixer.process(buffers, midi, master);
+            expectWithinAbsoluteError(master.getSample(0, 0), 0.125f, 1.0e-6f);
+
+            mixer.setBusOutput(2, 1);   // Bus 3 -> Bus 1 closes a loop
+            expect(mixer.hasRoutingCycle());
+            input.clear();
+            input.setSample(0, 0, 1.0f);
+            mixer.process(buffers, midi, master);
+            expect(std::isfinite(master.getSample(0, 0)));
+            expect(master.getSample(0, 0) > 0.0f, "A broken cycle must still reach master");
+        }
+
+        beginTest("Routing edits never drop a block");
+        {
+            const int blockSize = 64;
+            MixerEngine mixer;
+            mixer.setNumWorkerThreads(0);
+            mixer.getMasterBus()->setVolume(1.0f);
+
+            auto channel = std::make_unique<ChannelStrip>("Source");
+            channel->setVolume(1.0f);
+            mixer.addChannel(std::move(channel));
+            mixer.prepareToPlay(48000.0, blockSize);
+
+            // Audio thread: constant input straight to master while the message thread
+            // edits buses and the channel's sends
+            std::atomic<bool> stop { false };
+            std::atomic<int> silentBlocks { 0 }, wildBlocks { 0 }, blocks { 0 };
+            std::thread audio([&] {
+                juce::AudioBuffer<float> input(2, blockSize), master(2, blockSize);
+                std::vector<juce::AudioBuffer<float>*> buffers { &input };
+                std::vector<juce::MidiBuffer*> midi;
+                while (!stop.load()) {
+                    for (int ch = 0; ch < 2; ++ch)
+                        juce::FloatVectorOperations::fill(input.getWritePointer(ch), 1.0f, blockSize);
+                    mixer.process(buffers, midi, master);
+                    const float magnitude = master.getMagnitude(0, 0, blockSize);
+                    if (magnitude < 0.5f)
+                        ++silentBlocks;
+                    // Direct path plus at most four sends at 0.5 through buses at 0.8 or less
+                    if (!std::isfinite(magnitude) || magnitude > 3.0f + 1.0e-3f)
+                        ++wildBlocks;
+                    ++blocks;
+                }
+            });
+
+            juce::Random random(32);
+            for (int edit = 0; edit < 200; ++edit) {
+                mixer.addBus(std::make_unique<MixerBus>("Bus", MixerBus::Type::Group));
+                mixer.setBusOutput(mixer.getNumBuses() - 1, edit % 2 == 0 ? 0 : 1);
+                
+                mixer.addChannelSend(0, { 1 + random.nextInt(mixer.getNumBuses()), 0.5f, edit % 2 == 0, false });
+                mixer.setChannelSendLevel(0, random.nextInt(mixer.getChannel(0)->getNumSends()), random.nextFloat() * 0.5f);
+                if (mixer.getChannel(0)->getNumSends() > 3)
+                    mixer.removeChannelSend(0, random.nextInt(mixer.getChannel(0)->getNumSends()));
+                mixer.setChannelOutput(0, edit % 3 == 0 ? 0 : mixer.getNumBuses());
+                
+                if (mixer.getNumBuses() > 4)
+                    mixer.removeBus(0);
+            }
+            stop.store(true);
+            audio.join();
+
+            expectGreaterThan(blocks.load(), 0);
+            expectEquals(silentBlocks.load(), 0);
+            expectEquals(wildBlocks.load(), 0);
+        }
+
+        beginTest("Analysis taps: master and every channel get one, removed channels give theirs back");
+        {
+            const int blockSize = 256;
+            AnalysisTapService service; // never started: the test drains the taps itself
+            MixerEngine mixer;
+            mixer.setNumWorkerThreads(0);
+            mixer.getMasterBus()->setVolume(1.0f);
+            mixer.addChannel(std::make_unique<ChannelStrip>("Kick"));
+            mixer.setAnalysisTapService(&service);
+            mixer.addChannel(std::make_unique<ChannelStrip>("Bass"));
+            for (int i = 0; i < mixer.getNumChannels(); ++i)
+                mixer.getChannel(i)->setVolume(0.5f);
+            mixer.prepareToPlay(48000.0, blockSize);
+
+            auto* masterTap = mixer.getMasterAnalysisTap();
+            auto* kickTap = mixer.getChannel(0)->getAnalysisTap();
+            auto* bassTap = mixer.getChannel(1)->getAnalysisTap();
+            expect(masterTap != nullptr && kickTap != nullptr && bassTap != nullptr);
+            expect(kickTap != bassTap && kickTap != masterTap);
+            expect(masterTap->getName() == "Master");
+            expect(bassTap->getName() == "Bass");
+
+            // Nothing attached yet: the taps cost nothing and stay inactive
+            expect(!masterTap->isActive());
+            service.attach(masterTap, std::make_shared<SnapshotAnalyzer<int>>(nullptr, [](const juce::AudioBuffer<float>&) {}, [](int&) {}));
+            service.attach(kickTap, std::make_shared<SnapshotAnalyzer<int>>(nullptr, [](const juce::AudioBuffer<float>&) {}, [](int&) {}));
+            expect(masterTap->isActive() && kickTap->isActive());
+
+            juce::AudioBuffer<float> kickIn(2, blockSize), bassIn(2, blockSize), master(2, blockSize);
+            std::vector<juce::AudioBuffer<float>*> buffers { &kickIn, &bassIn };
+            std::vector<juce::MidiBuffer*> midi;
+            kickIn.clear();
+            bassIn.clear();
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::fill(kickIn.getWritePointer(ch), 1.0f, blockSize);
+            mixer.process(buffers, midi, master);
+
+            juce::AudioBuffer<float> read(2, blockSize * 2);
+            expectEquals(masterTap->read(read, blockSize * 2), blockSize);
+            expectWithinAbsoluteError(read.getSample(0, blockSize - 1), master.getSample(0, blockSize - 1), 1.0e-6f);
+            expectEquals(kickTap->read(read, blockSize * 2), blockSize);
+
+            mixer.removeChannel(0);
+            expect(!kickTap->isActive());
+            expect(mixer.getChannel(0)->getAnalysisTap() == bassTap);
+
+            // Detaching the service hands back the master tap too
+            mixer.setAnalysisTapService(nullptr);
+            expect(mixer.getMasterAnalysisTap() == nullptr);
+            expect(!masterTap->isActive());
+            expect(mixer.getChannel(0)->getAnalysisTap() == nullptr);
+        }
+
+        beginTest("Channels above the stereo pair keep trim, polarity and mute");
+        {
+            const int blockSize = 64;
+            ChannelStrip strip("Surround");
+            strip.prepareToPlay(48000.0, blockSize);
+            strip.setGain(-6.0f);
+            strip.setPhaseInverted(true);
+            strip.setVolume(0.5f);
+
+            juce::AudioBuffer<float> buffer(4, blockSize);
+            juce::MidiBuffer midi;
+            auto runBlock = [&] {
+                for (int ch = 0; ch < 4; ++ch)
+                    juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), 1.0f, blockSize);
+                strip.process(buffer, midi);
+            };
+
+            // No plugins: trim and polarity but neither pan nor fader, as before the fused kernel
+            const float trim = -std::pow(10.0f, -6.0f / 20.0f);
+            runBlock();
+            for (int ch = 2; ch < 4; ++ch) {
+                expectWithinAbsoluteError(buffer.getSample(ch, 0), trim, 1.0e-5f);
+                expectWithinAbsoluteError(buffer.getSample(ch, blockSize - 1), trim, 1.0e-5f);
+            }
+            expectWithinAbsoluteError(buffer.getSample(0, 0), 0.5f * trim, 1.0e-5f);
+
+            // Mute ramps in alongside the stereo pair and then stays silent
+            strip.setMuted(true);
+            runBlock();
+            expectWithinAbsoluteError(buffer.getSample(0, blockSize - 1), 0.0f, 1.0e-6f);
+            expect(std::abs(buffer.getSample(2, blockSize - 1)) < std::abs(trim) * 0.1f);
+            runBlock();
+            runBlock();
+            for (int ch = 0; ch < 4; ++ch)
+                expectEquals(buffer.getMagnitude(ch, 0, blockSize), 0.0f);
+        }
+
+        beginTest("Benchmark: 64 channels x 4 sends vs direct-to-master");
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 512;
+            const int numChannels = 64;
+            const int numBlocks = 400;
+
+            juce::Random random(1234);
+            std::vector<juce::AudioBuffer<float>> inputs((size_t) numChannels, juce::AudioBuffer<float>(2, blockSize));
+            std::vector<juce::AudioBuffer<float>*> buffers;
+            for (auto& input : inputs) {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+                buffers.push_back(&input);
+            }
+            std::vector<juce::MidiBuffer*> midi;
+            juce::AudioBuffer<float> master(2, blockSize);
+
+            // Unity faders so the in-place strips don't decay the test signal
+            auto makeMixer = [&](bool withSends) {
+                auto mixer = std::make_unique<MixerEngine>();
+                if (withSends) {
+                    for (int b = 0; b < 4; ++b)
+                        mixer->addBus(std::make_unique<MixerBus>("Return " + juce::String(b + 1), MixerBus::Type::SendReturn));
+                }
+                for (int c = 0; c < numChannels; ++c) {
+                    auto channel = std::make_unique<ChannelStrip>("Ch " + juce::String(c + 1));
+                    channel->setVolume(1.0f);
+                    if (withSends) {
+                        for (int b = 0; b < 4; ++b)
+                            channel->addSend({ b + 1, 0.2f, b < 2, false });
+                    }
+                    mixer->addChannel(std::move(channel));
+                }
+                mixer->prepareToPlay(sampleRate, blockSize);
+                return mixer;
+            };
+
+            auto measure = [&](MixerEngine& mixer) {
+                mixer.process(buffers, midi, master);   // warm-up, primes ramps
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (int block = 0; block < numBlocks; ++block)
+                    mixer.process(buffers, midi, master);
+                const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                return elapsed / numBlocks;
+            };
+
+            auto direct = makeMixer(false);
+            auto withSends = makeMixer(true);
+            const double directSeconds = measure(*direct);
+            const double sendSeconds = measure(*withSends);
+            const double blockSeconds = blockSize / sampleRate;
+
+            logMessage("Mixer 64 ch direct-to-master: " + juce::String(directSeconds * 1.0e6, 1) + " us/block ("
+                       + juce::String(directSeconds / blockSeconds * 100.0, 2) + "% of real time)");
+            logMessage("Mixer 64 ch x 4 sends + 4 returns: " + juce::String(sendSeconds * 1.0e6, 1) + " us/block ("
+                       + juce::String(sendSeconds / blockSeconds * 100.0, 2) + "% of real time), "
+                       + juce::String(sendSeconds / juce::jmax(1.0e-9, directSeconds), 2) + "x direct, "
+                       + juce::String(withSends->getNumWorkerThreads()) + " workers");
+
+        }
+    }
+};
+
+static MixerBusTest mixerBusTest;
@@ -0,0 +1,202 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/MultibandCompressor.h"
+
+using namespace OmegaStudio;
+
+class MultibandCompressorTest : public juce::UnitTest {
+public:
+    MultibandCompressorTest() : juce::UnitTest("MultibandCompressor", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const double pi = juce::MathConstants<double>::pi;
+
+        // Runs the compressor over planar channels in host blocks of the given sizes
+        auto run = [](MultibandCompressor& compressor, std::vector<std::vector<float>> channels, const std::vector<int>& blockSizes) {
+            const int numSamples = (int) channels[0].size();
+            juce::AudioBuffer<float> block((int) channels.size(), 1);
+            size_t next = 0;
+            for (int offset = 0; offset < numSamples;) {
+                const int n = juce::jmin(blockSizes[next++ % blockSizes.size()], numSamples - offset);
+                block.setSize((int) channels.size(), n, false, false, true);
+                for (size_t ch = 0; ch < channels.size(); ++ch)
+                    std::copy(channels[ch].begin() + offset, channels[ch].begin() + offset + n, block.getWritePointer((int) ch));
+                compressor.process(block);
+                for (size_t ch = 0; ch < channels.size(); ++ch)
+                    std::copy(block.getReadPointer((int) ch), block.getReadPointer((int) ch) + n, channels[ch].begin() + offset);
+                offset += n;
+            }
+            return channels;
+        };
+
+        // Steady-state gain of a sine on every channel (the one furthest from unity):
+        // half a second to settle, then one second (a whole number of cycles)
+        // correlated against sin and cos
+        auto measureGain = [&](MultibandCompressor& compressor, int numChannels, double frequency, float amplitude) {
+            const int settle = (int) sampleRate / 2;
+            const int length = (int) sampleRate;
+            std::vector<float> sine((size_t) (settle + length));
+            for (size_t i = 0; i < sine.size(); ++i)
+                sine[i] = amplitude * (float) std::sin(2.0 * pi * frequency * (double) i / sampleRate);
+
+            const auto output = run(compressor, std::vector<std::vector<float>>((size_t) numChannels, sine), { 512 });
+
+            double worst = 1.0;
+            for (const auto& channel : output) {
+                double re = 0.0, im = 0.0;
+                for (int i = settle; i < settle + length; ++i) {
+                    const double phase = 2.0 * pi * frequency * (double) i / sampleRate;
+                    re += channel[(size_t) i] * std::sin(phase);
+                    im += channel[(size_t) i] * std::cos(phase);
+                }
+                const double gain = 2.0 * std::sqrt(re * re + im * im) / (double) length / amplitude;
+                worst = std::abs(gain - 1.0) > std::abs(worst - 1.0) ? gain : worst;
+            }
+            return worst;
+        };
+
+        auto toDecibels = [](double gain) -> double { return juce::Decibels::gainToDecibels(gain, -200.0); };
+
+        auto makeNoise = [](int numSamples, int seed, float amplitude) {
+            juce::Random random(seed);
+            std::vector<float> noise((size_t) numSamples);
+            for (auto& sample : noise)
+                sample = (random.nextFloat() * 2.0f - 1.0f) * amplitude;
+            return noise;
+        };
+
+        const double frequencies[] { 20.0, 60.0, 120.0, 400.0, 1000.0, 3000.0, 8000.0, 12000.0, 20000.0 };
+
+        beginTest("Bands sum flat when no band applies gain");
+        {
+            // Disabled bands, and enabled bands far below their threshold, at the
+            // default crossovers and at moved ones: the LR4 sum is an allpass
+            for (const bool enabled : { false, true }) {
+                for (const bool moved : { false, true }) {
+                    for (const int numChannels : { 1, 2 }) {
+                        for (const double frequency : frequencies) {
+                            MultibandCompressor compressor;
+                            if (moved) {
+                                compressor.setCrossoverLow(60.0f);
+                                compressor.setCrossoverMid(700.0f);
+                                compressor.setCrossoverHigh(12000.0f);
+                            }
+                            for (int b = 0; b < 4; ++b) {
+                                compressor.setBandEnabled(b, enabled);
+                                compressor.setBandThreshold(b, 0.0f);
+                            }
+                            compressor.prepare(sampleRate, 512);
+
+                            const double gain = measureGain(compressor, numChannels, frequency, 0.01f);
+                            expectWithinAbsoluteError(toDecibels(gain), 0.0, 0.01,
+                                                      juce::String(enabled ? "Enabled" : "Disabled") + " bands, "
+                                                      + (moved ? "moved" : "default") + " crossovers, "
+                                                      + juce::String(numChannels) + " ch, " + juce::String(frequency) + " Hz");
+                        }
+                    }
+                }
+            }
+
+            // Each LR4 band is -6 dB at its crossovers
+            for (int b = 0; b < 4; ++b) {
+                for (const double frequency : { 120.0, 1000.0, 8000.0 }) {
+                    const bool edge = (b == 0 && frequency == 120.0) || (b == 1 && frequency != 8000.0)
+                                   || (b == 2 && frequency != 120.0) || (b == 3 && frequency == 8000.0);
+                    if (!edge)
+                        continue;
+
+                    MultibandCompressor compressor;
+                    for (int other = 0; other < 4; ++other)
+                        compressor.setBandEnabled(other, false);
+                    compressor.setBandSolo(b, true);
+                    compressor.prepare(sampleRate, 512);
+                    expectWithinAbsoluteError(toDecibels(measureGain(compressor, 2, frequency, 0.01f)), -6.02, 0.1,
+                                              "Band " + juce::String(b) + " at " + juce::String(frequency) + " Hz");
+                }
+            }
+        }
+
+        beginTest("Left and right keep independent filter state");
+        {
+            const int length = 24000;
+            const auto x = makeNoise(length, 1, 0.5f);
+            const auto y = makeNoise(length, 2, 0.5f);
+            const std::vector<float> silence((size_t) length, 0.0f);
+            const std::vector<int> blocks { 256 };
+
+            // Unity bands: stereo is two mono compressors, bit for bit
+            auto unity = [&](MultibandCompressor& compressor) {
+                for (int b = 0; b < 4; ++b)
+                    compressor.setBandEnabled(b, false);
+                compressor.prepare(sampleRate, 256);
+            };
+
+            MultibandCompressor stereo, monoX, monoY;
+            unity(stereo);
+            unity(monoX);
+            unity(monoY);
+            const auto both = run(stereo, { x, y }, blocks);
+            expect(both[0] == run(monoX, { x }, blocks)[0], "Left must not see the right channel");
+            expect(both[1] == run(monoY, { y }, blocks)[0], "Right must not see the left channel");
+
+            // Compressing, peak detection: a silent side contributes nothing to the
+            // linked detector, so the other side matches mono and the silent side stays silent
+            auto compressing = [&](MultibandCompressor& compressor) {
+                for (int b = 0; b < 4; ++b) {
+                    compressor.setBandDetectionMode(b, MultibandCompressor::DetectionMode::Peak);
+                    compressor.setBandThreshold(b, -30.0f);
+                    compressor.setBandRatio(b, 8.0f);
+                    compressor.setBandAttack(b, 1.0f);
+                }
+                compressor.prepare(sampleRate, 256);
+            };
+
+            MultibandCompressor mono, leftOnly, rightOnly;
+            compressing(mono);
+            compressing(leftOnly);
+            compressing(rightOnly);
+            const auto reference = run(mono, { x }, blocks)[0];
+            const auto left = run(leftOnly, { x, silence }, blocks);
+            const auto right = run(rightOnly, { silence, x }, blocks);
+
+            expect(reference != x, "The bands should be compressing");
+            expect(left[0] == reference);
+            expect(left[1] == silence);
+            expect(right[0] == silence);
+            expect(right[1] == reference);
+        }
+
+        beginTest("Host blocks larger than the prepared size are processed in prepared-size chunks");
+        {
+            // The band buffers are sized in prepare(); process() must walk a larger
+            // host block in chunks instead of growing them on the audio thread
+            const int length = 96000;
+            const auto x = makeNoise(length, 3, 0.7f);
+            const auto y = makeNoise(length, 4, 0.7f);
+
+            juce::Random random(35);
+            std::vector<int> hostBlocks;
+            for (int i = 0; i < 64; ++i)
+                hostBlocks.push_back(1 + random.nextInt(3000));
+
+            auto configure = [&](MultibandCompressor& compressor, int preparedBlock) {
+                compressor.loadPreset("Mastering Aggressive");
+                compressor.prepare(sampleRate, preparedBlock);
+            };
+
+            MultibandCompressor small, large;
+            configure(small, 64);
+            configure(large, 4096);
+            const auto chunked = run(small, { x, y }, hostBlocks);
+            const auto whole = run(large, { x, y }, hostBlocks);
+
+            expect(chunked[0] != x, "The bands should be compressing");
+            expect(chunked[0] == whole[0]);
+            expect(chunked[1] == whole[1]);
+            for (int b = 0; b < 4; ++b)
+                expectLessThan(small.getBandGainReduction(b), 0.0f);
+        }
+    }
+};
+
+static MultibandCompressorTest multibandCompressorTest;
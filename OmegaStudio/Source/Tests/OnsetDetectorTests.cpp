@@ -0,0 +1,117 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/OnsetDetector.h"
+
+using namespace omega;
+
+class OnsetDetectorTest : public juce::UnitTest {
+public:
+    OnsetDetectorTest() : juce::UnitTest("OnsetDetector", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 44100.0;
+        const int interval = 11025;
+        const int numHits = 12;
+        const int start = 777;
+
+        // Loud low kicks with a quiet bright hat halfway between them
+        juce::AudioBuffer<float> beat(2, start + numHits * interval);
+        beat.clear();
+        juce::Random random(3);
+        for (int n = 0; n < numHits; ++n) {
+            addBurst(beat, start + n * interval, sampleRate, 60.0, 0.9f, 0.15);
+            addNoiseBurst(beat, start + n * interval + interval / 2, 0.05f, 0.03 * sampleRate, random);
+        }
+
+        OnsetDetector detector;
+        detector.initialize(sampleRate);
+
+        beginTest("Kicks and hats are found on their attacks");
+        {
+            OnsetList result;
+            detector.detect(beat, result);
+            const auto onsets = result.select(0.02f, interval / 4.0);
+            expectEquals((int) onsets.size(), 2 * numHits, "Onset count");
+
+            double maxError = 0.0;
+            for (size_t i = 0; i < onsets.size() && i < (size_t) (2 * numHits); ++i) {
+                const double truth = start + (double) (i / 2) * interval + (i % 2 == 1 ? interval / 2 : 0);
+                maxError = juce::jmax(maxError, std::abs(onsets[i].position - truth));
+                // Kicks are reported in the lowest band, hats in the top ones
+                expect(i % 2 == 0 ? onsets[i].band <= 1 : onsets[i].band >= OnsetDetector::kNumBands - 2,
+                       "Band " + juce::String(onsets[i].band));
+            }
+            expectLessThan(maxError, 2.0);
+        }
+
+        beginTest("Streaming matches offline, within the latency");
+        {
+            OnsetList offline;
+            detector.detect(beat, offline);
+
+            OnsetDetector streaming;
+            streaming.initialize(sampleRate);
+            std::vector<Onset> streamed;
+            juce::int64 pushed = 0;     // Before the current block
+            bool inTime = true;
+            auto onOnset = [&](const Onset& onset) {
+                inTime = inTime && pushed - onset.position <= streaming.getLatencySamples();
+                streamed.push_back(onset);
+            };
+
+            const float* mono = beat.getReadPointer(0);
+            for (int offset = 0, block = 1; offset < beat.getNumSamples(); offset += block, block = block * 7 % 997 + 1) {
+                const int count = juce::jmin(block, beat.getNumSamples() - offset);
+                streaming.push(mono + offset, count, onOnset);
+                pushed += count;
+            }
+            streaming.finish(onOnset);
+
+            expect(inTime);
+            expectEquals(streamed.size(), offline.onsets.size());
+            bool identical = streamed.size() == offline.onsets.size();
+            for (size_t i = 0; i < streamed.size() && identical; ++i)
+                identical = streamed[i].position == offline.onsets[i].position && streamed[i].flux == offline.onsets[i].flux;
+            expect(identical);
+        }
+
+        beginTest("Silence and a reused result");
+        {
+            OnsetList result;
+            detector.detect(beat, result);
+            expect(!result.onsets.empty());
+
+            juce::AudioBuffer<float> silence(1, 44100);
+            silence.clear();
+            detector.detect(silence, result);
+            expect(result.onsets.empty());
+            expectEquals(result.maxFlux, 0.0f);
+        }
+    }
+
+private:
+    static void addBurst(juce::AudioBuffer<float>& buffer, int position, double sampleRate,
+                         double frequency, float amplitude, double seconds) {
+        const int length = juce::jmin((int) (seconds * sampleRate), buffer.getNumSamples() - position);
+        for (int i = 0; i < length; ++i) {
+            const float sample = amplitude * std::exp(-5.0f * (float) i / (float) length)
+                               * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, position + i, buffer.getSample(ch, position + i) + sample);
+        }
+    }
+
+    // Noise through a first difference: most of its energy is near Nyquist
+    static void addNoiseBurst(juce::AudioBuffer<float>& buffer, int position, float amplitude,
+                              double length, juce::Random& random) {
+        float previous = 0.0f;
+        for (int i = 0; i < (int) length && position + i < buffer.getNumSamples(); ++i) {
+            const float noise = random.nextFloat() * 2.0f - 1.0f;
+            const float sample = amplitude * std::exp(-5.0f * (float) i / (float) length) * 0.5f * (noise - previous);
+            previous = noise;
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, position + i, buffer.getSample(ch, position + i) + sample);
+        }
+    }
+};
+
+static OnsetDetectorTest onsetDetectorTest;
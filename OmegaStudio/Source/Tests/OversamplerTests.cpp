@@ -0,0 +1,113 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/Oversampler.h"
+
+using namespace OmegaStudio;
+
+class OversamplerTest : public juce::UnitTest {
+public:
+    OversamplerTest() : juce::UnitTest("Oversampler", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const int blockSize = 256;
+        const int numSamples = blockSize * 200;
+
+        const auto phases = { Oversampler::Phase::Minimum, Oversampler::Phase::Linear };
+        const auto factors = { Oversampler::Factor::x2, Oversampler::Factor::x4,
+                               Oversampler::Factor::x8, Oversampler::Factor::x16 };
+
+        // Amplitude and phase of one frequency over the second half (past the start-up transient)
+        auto fit = [&](const std::vector<float>& signal, double frequency, double& amplitude, double& phase) {
+            const double w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            double s = 0.0, c = 0.0;
+            const int start = (int) signal.size() / 2;
+            for (int i = start; i < (int) signal.size(); ++i) {
+                s += signal[(size_t) i] * std::sin(w * i);
+                c += signal[(size_t) i] * std::cos(w * i);
+            }
+            const double scale = 2.0 / (double) (signal.size() - (size_t) start);
+            amplitude = std::hypot(s * scale, c * scale);
+            phase = std::atan2(c, s);
+        };
+
+        // Stereo sine through up/process/down in fixed blocks
+        auto run = [&](Oversampler& oversampler, double frequency, auto&& processor) {
+            std::vector<float> left((size_t) numSamples), right((size_t) numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                left[(size_t) i] = right[(size_t) i] = 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+
+            oversampler.reset();
+            for (int b = 0; b < numSamples / blockSize; ++b) {
+                float* channels[2] = { left.data() + b * blockSize, right.data() + b * blockSize };
+                oversampler.process(channels, 2, blockSize, processor);
+            }
+            return right;
+        };
+
+        auto passThrough = [](float* const*, int, int) {};
+
+        beginTest("Flat passband and reported latency");
+        {
+            for (const auto phase : phases) {
+                for (const auto factor : factors) {
+                    Oversampler oversampler;
+                    oversampler.prepare(2, blockSize, factor, phase);
+
+                    for (const double frequency : { 1000.0, 20000.0 }) {
+                        double amplitude = 0.0, measuredPhase = 0.0;
+                        fit(run(oversampler, frequency, passThrough), frequency, amplitude, measuredPhase);
+                        expectWithinAbsoluteError((float) juce::Decibels::gainToDecibels(amplitude / 0.5), 0.0f, 0.01f);
+                    }
+
+                    // Delay at 1 kHz (modulo one period): matches the reported latency
+                    double amplitude = 0.0, measuredPhase = 0.0;
+                    fit(run(oversampler, 1000.0, passThrough), 1000.0, amplitude, measuredPhase);
+                    const double period = sampleRate / 1000.0;
+                    const double measured = std::fmod(-measuredPhase / juce::MathConstants<double>::twoPi * period + 2.0 * period, period);
+                    const double expected = std::fmod((double) oversampler.getLatency(), period);
+                    expectWithinAbsoluteError(measured, expected, 0.05);
+                }
+            }
+        }
+
+        beginTest("Content above the base Nyquist does not alias back");
+        {
+            for (const auto phase : phases) {
+                for (const auto factor : factors) {
+                    Oversampler oversampler;
+                    oversampler.prepare(2, blockSize, factor, phase);
+                    const double highRate = sampleRate * oversampler.getFactor();
+
+                    // Replace the oversampled signal with a tone at fs - 5 kHz: at the
+                    // base rate it would fold to 5 kHz
+                    int64_t position = 0;
+                    auto tone = [&](float* const* channels, int numChannels, int count) {
+                        for (int ch = 0; ch < numChannels; ++ch)
+                            for (int i = 0; i < count; ++i)
+                                channels[ch][i] = 0.5f * (float) std::sin(juce::MathConstants<double>::twoPi * (sampleRate - 5000.0)
+                                                                          * (double) (position + i) / highRate);
+                        position += count;
+                    };
+
+                    double amplitude = 0.0, measuredPhase = 0.0;
+                    fit(run(oversampler, 1000.0, tone), 5000.0, amplitude, measuredPhase);
+                    expect(juce::Decibels::gainToDecibels(amplitude / 0.5, -200.0) < -90.0,
+                           "Alias at " + juce::String(juce::Decibels::gainToDecibels(amplitude / 0.5, -200.0), 1) + " dB");
+                }
+            }
+        }
+
+        beginTest("Benchmark: CPU per factor");
+        {
+            for (const auto& result : Oversampler::benchmark(sampleRate, 512, 2.0)) {
+                logMessage(juce::String(result.phase == Oversampler::Phase::Minimum ? "Minimum phase " : "Linear phase ")
+                           + juce::String((int) result.factor) + "x: " + juce::String(result.cpuLoad * 100.0, 3)
+                           + "% of one core (stereo), latency " + juce::String(result.latency, 2) + " samples");
+
+                expect(result.cpuLoad < 0.05, "Resampling alone must stay well under 5% of one core");
+            }
+        }
+    }
+};
+
+static OversamplerTest oversamplerTest;
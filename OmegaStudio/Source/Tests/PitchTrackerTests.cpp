@@ -0,0 +1,154 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/PitchTracker.h"
+
+using namespace omega;
+
+class PitchTrackerTest : public juce::UnitTest {
+public:
+    PitchTrackerTest() : juce::UnitTest("PitchTracker", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const int numSamples = 48000;
+
+        // Voice-like tone: three harmonics plus a little noise
+        auto makeTone = [&](double frequency, juce::Random& random) {
+            std::vector<float> signal((size_t) numSamples);
+            for (int i = 0; i < numSamples; ++i) {
+                const double phase = juce::MathConstants<double>::twoPi * frequency * i / sampleRate;
+                signal[(size_t) i] = (float) (0.3 * std::sin(phase) + 0.15 * std::sin(2.0 * phase + 0.3)
+                                            + 0.08 * std::sin(3.0 * phase + 1.0)) + 0.01f * (random.nextFloat() - 0.5f);
+            }
+            return signal;
+        };
+
+        // Reference YIN with the O(N^2) difference function over one frame
+        auto bruteForce = [&](const float* frame, int frameSize, int minLag, int maxLag, float& frequency, float& confidence) {
+            const int window = frameSize / 2;
+            std::vector<float> difference((size_t) window);
+            for (int tau = 0; tau < window; ++tau) {
+                double sum = 0.0;
+                for (int j = 0; j < window; ++j)
+                    sum += juce::square((double) frame[j] - frame[j + tau]);
+                difference[(size_t) tau] = (float) sum;
+            }
+
+            difference[0] = 1.0f;
+            float runningSum = 0.0f;
+            for (int tau = 1; tau < window; ++tau) {
+                runningSum += difference[(size_t) tau];
+                difference[(size_t) tau] *= tau / runningSum;
+            }
+
+            int estimate = -1;
+            for (int tau = minLag; tau <= maxLag && estimate < 0; ++tau) {
+                if (difference[(size_t) tau] < 0.15f) {
+                    while (tau + 1 <= maxLag && difference[(size_t) tau + 1] < difference[(size_t) tau])
+                        ++tau;
+                    estimate = tau;
+                }
+            }
+            if (estimate < 0)
+                estimate = (int) (std::min_element(difference.begin() + minLag, difference.begin() + maxLag + 1) - difference.begin());
+
+            const float s0 = difference[(size_t) estimate - 1], s1 = difference[(size_t) estimate], s2 = difference[(size_t) estimate + 1];
+            frequency = (float) sampleRate / (estimate + (s2 - s0) / (2.0f * (2.0f * s1 - s2 - s0)));
+            confidence = 1.0f - s1;
+        };
+
+        beginTest("FFT difference function matches brute-force YIN across block sizes");
+        {
+            juce::Random random(3);
+            PitchTracker tracker;
+            tracker.initialize(sampleRate);
+            const int frameSize = tracker.getFrameSize();
+            const int minLag = (int) std::floor(sampleRate / tracker.getSettings().maxFrequency);
+            const int maxLag = (int) std::ceil(sampleRate / tracker.getSettings().minFrequency);
+
+            for (const double frequency : { 82.4, 220.0, 440.0, 987.8, 1400.0 }) {
+                for (const int blockSize : { 64, 480, 1024 }) {
+                    const auto signal = makeTone(frequency, random);
+                    tracker.reset();
+
+                    float maxFrequencyError = 0.0f, maxConfidenceError = 0.0f, maxPitchError = 0.0f;
+                    int numFrames = 0, numVoiced = 0;
+
+                    for (int offset = 0; offset < numSamples; offset += blockSize) {
+                        const int length = juce::jmin(blockSize, numSamples - offset);
+                        tracker.push(signal.data() + offset, length, [&](const PitchEstimate& estimate, int frameEnd) {
+                            const int end = offset + frameEnd;
+                            if (end < frameSize)
+                                return;
+
+                            float expectedFrequency = 0.0f, expectedConfidence = 0.0f;
+                            bruteForce(signal.data() + end - frameSize, frameSize, minLag, maxLag, expectedFrequency, expectedConfidence);
+
+                            maxFrequencyError = juce::jmax(maxFrequencyError, std::abs(estimate.frequency / expectedFrequency - 1.0f));
+                            maxConfidenceError = juce::jmax(maxConfidenceError, std::abs(estimate.confidence - expectedConfidence));
+                            maxPitchError = juce::jmax(maxPitchError, std::abs(1200.0f * std::log2(estimate.frequency / (float) frequency)));
+                            ++numFrames;
+                            numVoiced += estimate.voiced ? 1 : 0;
+                        });
+                    }
+
+                    expect(maxFrequencyError < 1.0e-4f, "Frequency differs from brute force by " + juce::String(maxFrequencyError));
+                    expect(maxConfidenceError < 1.0e-3f, "Confidence differs from brute force by " + juce::String(maxConfidenceError));
+                    expect(maxPitchError < 5.0f, juce::String(frequency) + " Hz off by " + juce::String(maxPitchError) + " cents");
+                    expectEquals(numVoiced, numFrames);
+                }
+            }
+        }
+
+        beginTest("Noise and silence are unvoiced");
+        {
+            juce::Random random(5);
+            PitchTracker tracker;
+            tracker.initialize(sampleRate);
+
+            std::vector<float> noise((size_t) numSamples), silence((size_t) numSamples, 0.0f);
+            for (auto& sample : noise)
+                sample = 0.6f * (random.nextFloat() - 0.5f);
+
+            int numVoiced = 0;
+            tracker.push(noise.data(), numSamples, [&](const PitchEstimate& estimate, int) { numVoiced += estimate.voiced ? 1 : 0; });
+            expectEquals(numVoiced, 0);
+
+            tracker.reset();
+            tracker.push(silence.data(), numSamples, [&](const PitchEstimate& estimate, int) { numVoiced += estimate.voiced ? 1 : 0; });
+            expectEquals(numVoiced, 0);
+            expectEquals(tracker.getEstimate().frequency, 0.0f);
+        }
+
+        beginTest("Benchmark: 6 backing vocal tracks");
+        {
+            const int blockSize = 512;
+            const int numBlocks = 938;               // 10 s
+            const int numTracks = 6;
+
+            juce::Random random(11);
+            const auto signal = makeTone(220.0, random);
+
+            std::vector<std::unique_ptr<PitchTracker>> trackers;
+            for (int i = 0; i < numTracks; ++i) {
+                trackers.push_back(std::make_unique<PitchTracker>());
+                trackers.back()->initialize(sampleRate);
+            }
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < numBlocks; ++b) {
+                const int offset = (b * blockSize) % (numSamples - blockSize);
+                for (auto& tracker : trackers)
+                    tracker->push(signal.data() + offset, blockSize);
+            }
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            const double seconds = numBlocks * blockSize / sampleRate;
+
+            logMessage(juce::String(numTracks) + " trackers: " + juce::String(elapsed * 1000.0, 1) + " ms for "
+                       + juce::String(seconds, 1) + " s (" + juce::String(elapsed / seconds * 100.0, 2) + "% of one core)");
+
+            expect(trackers.front()->getEstimate().voiced);
+        }
+    }
+};
+
+static PitchTrackerTest pitchTrackerTest;
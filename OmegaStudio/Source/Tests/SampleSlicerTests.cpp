@@ -0,0 +1,131 @@
+#include <JuceHeader.h>
+#include "../Audio/SampleSlicer.h"
+
+using namespace omega;
+
+class SampleSlicerTest : public juce::UnitTest {
+public:
+    SampleSlicerTest() : juce::UnitTest("SampleSlicer", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 44100.0;
+        const int numSlices = 8;
+
+        juce::AudioBuffer<float> loop(2, 8 * 5512);
+        juce::Random random(5);
+        for (int ch = 0; ch < loop.getNumChannels(); ++ch)
+            for (int i = 0; i < loop.getNumSamples(); ++i)
+                loop.setSample(ch, i, 0.5f * (random.nextFloat() * 2.0f - 1.0f));
+
+        auto renderAll = [&](SampleSlicer& slicer, float stretchFactor) {
+            std::vector<juce::AudioBuffer<float>> renders;
+            for (int i = 0; i < slicer.getNumSlices(); ++i) {
+                juce::AudioBuffer<float> output(2, 8192);
+                output.clear();
+                slicer.renderSliceWithTimeStretch(i, output, 0, stretchFactor, 0.5f);
+                renders.push_back(output);
+            }
+            return renders;
+        };
+
+        auto identical = [](const std::vector<juce::AudioBuffer<float>>& a,
+                            const std::vector<juce::AudioBuffer<float>>& b) {
+            if (a.size() != b.size())
+                return false;
+            for (size_t s = 0; s < a.size(); ++s)
+                for (int ch = 0; ch < a[s].getNumChannels(); ++ch)
+                    for (int i = 0; i < a[s].getNumSamples(); ++i)
+                        if (a[s].getSample(ch, i) != b[s].getSample(ch, i))
+                            return false;
+            return true;
+        };
+
+        beginTest("Cached renders match stretching on the spot");
+        {
+            SampleSlicer slicer;
+            slicer.loadAudioBuffer(loop, sampleRate);
+            slicer.autoSliceByGrid(numSlices);
+            slicer.setStretchQuality(SampleSlicer::StretchQuality::Fast);
+
+            const auto live = renderAll(slicer, 0.8f);
+            expect(!slicer.isStretchedSliceReady(0, 0.8f));
+
+            slicer.setProjectTempo(125.0, 100.0);
+            expect(slicer.waitForStretchedSlices(10000));
+            for (int i = 0; i < numSlices; ++i)
+                expect(slicer.isStretchedSliceReady(i, 0.8f), "Slice " + juce::String(i));
+
+            expect(identical(renderAll(slicer, 0.8f), live));
+        }
+
+        beginTest("Tempo, quality and slice edits invalidate");
+        {
+            SampleSlicer slicer;
+            slicer.loadAudioBuffer(loop, sampleRate);
+            slicer.autoSliceByGrid(numSlices);
+            slicer.prepareStretchedSlices(0.8f);
+            expect(slicer.waitForStretchedSlices(10000));
+            expect(slicer.isStretchedSliceReady(3, 0.8f));
+
+            // Phase vocoder render: stretched length, not silent
+            juce::AudioBuffer<float> output(2, 8192);
+            output.clear();
+            slicer.renderSliceWithTimeStretch(3, output, 0, 0.8f);
+            expectGreaterThan(output.getRMSLevel(0, 0, 4000), 0.05f);
+            expectEquals(output.getRMSLevel(0, 4410, 8192 - 4410), 0.0f);
+
+            slicer.prepareStretchedSlices(1.25f);
+            expect(!slicer.isStretchedSliceReady(3, 0.8f));
+            expect(slicer.waitForStretchedSlices(10000));
+            expect(slicer.isStretchedSliceReady(3, 1.25f));
+
+            slicer.moveSlice(3, slicer.getSlice(3).startSample + 100);
+            expect(slicer.isStretchedSliceReady(0, 1.25f));
+            expect(slicer.waitForStretchedSlices(10000));
+            expect(slicer.isStretchedSliceReady(2, 1.25f));
+
+            slicer.setStretchQuality(SampleSlicer::StretchQuality::Fast);
+            expect(!slicer.isStretchedSliceReady(0, 1.25f));
+        }
+
+        beginTest("Cache size is bounded");
+        {
+            SampleSlicer slicer;
+            slicer.loadAudioBuffer(loop, sampleRate);
+            slicer.autoSliceByGrid(numSlices);
+            slicer.setStretchQuality(SampleSlicer::StretchQuality::Fast);
+
+            // Room for three stereo slices at 1.0
+            slicer.setStretchCacheSize(3 * 2 * 5512 * sizeof(float));
+            slicer.prepareStretchedSlices(1.0f);
+            expect(slicer.waitForStretchedSlices(10000));
+
+            int ready = 0;
+            for (int i = 0; i < numSlices; ++i)
+                ready += slicer.isStretchedSliceReady(i, 1.0f) ? 1 : 0;
+            expectEquals(ready, 3);
+            expect(slicer.isStretchedSliceReady(numSlices - 1, 1.0f));
+        }
+
+        beginTest("Reloading stops a running render");
+        {
+            // One long High-quality slice: the render is still running when the audio is replaced
+            juce::AudioBuffer<float> longLoop(2, 20 * 44100);
+            for (int ch = 0; ch < longLoop.getNumChannels(); ++ch)
+                for (int i = 0; i < longLoop.getNumSamples(); ++i)
+                    longLoop.setSample(ch, i, 0.5f * (random.nextFloat() * 2.0f - 1.0f));
+
+            SampleSlicer slicer;
+            slicer.loadAudioBuffer(longLoop, sampleRate);
+            slicer.autoSliceByGrid(1);
+            slicer.prepareStretchedSlices(2.0f);
+
+            slicer.loadAudioBuffer(loop, sampleRate);
+            slicer.autoSliceByGrid(numSlices);
+            expect(slicer.waitForStretchedSlices(10000));
+            expect(slicer.isStretchedSliceReady(0, 2.0f));
+        }
+    }
+};
+
+static SampleSlicerTest sampleSlicerTest;
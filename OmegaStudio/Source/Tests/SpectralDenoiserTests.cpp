@@ -0,0 +1,158 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/SpectralDenoiser.h"
+#include "../Audio/AI/DenoiseService.h"
+
+using namespace omega;
+
+class SpectralDenoiserTest : public juce::UnitTest {
+public:
+    SpectralDenoiserTest() : juce::UnitTest("SpectralDenoiser", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const int numSamples = 4 * 48000;
+        const int blockSize = 300;
+
+        // Steady noise, a tone gated on for the second and fourth seconds
+        juce::Random random(42);
+        juce::AudioBuffer<float> noisy(2, numSamples);
+        std::vector<bool> toneOn((size_t) numSamples);
+        for (int i = 0; i < numSamples; ++i) {
+            toneOn[(size_t) i] = (i / 48000) % 2 == 1;
+            const float tone = toneOn[(size_t) i] ? 0.3f * (float) std::sin(juce::MathConstants<double>::twoPi * 440.0 * i / sampleRate) : 0.0f;
+            for (int ch = 0; ch < 2; ++ch)
+                noisy.setSample(ch, i, tone + 0.01f * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        auto run = [&](SpectralDenoiser& denoiser, const juce::AudioBuffer<float>& input, int block, bool bypass = false) {
+            juce::AudioBuffer<float> output;
+            output.makeCopyOf(input);
+            for (int offset = 0; offset < input.getNumSamples(); offset += block) {
+                float* pointers[2] = { output.getWritePointer(0, offset), output.getWritePointer(1, offset) };
+                denoiser.process(pointers, 2, juce::jmin(block, input.getNumSamples() - offset), bypass);
+            }
+            return output;
+        };
+
+        // Energy over [start, end) of the input timeline (output shifted by the latency)
+        auto energy = [&](const juce::AudioBuffer<float>& buffer, int latency, int start, int end) {
+            double sum = 0.0;
+            for (int i = start; i < end; ++i)
+                sum += (double) buffer.getSample(0, i + latency) * buffer.getSample(0, i + latency);
+            return sum;
+        };
+
+        beginTest("Frame size follows the latency budget");
+        {
+            expectEquals(SpectralDenoiser::fftSizeForDuration(48000.0, 0.008), 512);
+            expectEquals(SpectralDenoiser::fftSizeForDuration(96000.0, 0.008), 1024);
+
+            SpectralDenoiser denoiser;
+            denoiser.prepare(sampleRate, 2, 512);
+            expectEquals(denoiser.getLatencySamples(), 512);
+            expectEquals(denoiser.getHopSize(), 128);
+        }
+
+        beginTest("No reduction reproduces the input after the latency");
+        {
+            for (bool bypass : { false, true }) {
+                SpectralDenoiser denoiser;
+                denoiser.prepare(sampleRate, 2, 512);
+                SpectralDenoiser::Parameters params;
+                params.reduction = bypass ? 0.8f : 0.0f;
+                denoiser.setParameters(params);
+
+                const auto output = run(denoiser, noisy, blockSize, bypass);
+                const int latency = denoiser.getLatencySamples();
+                float maxError = 0.0f;
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < numSamples - latency; ++i)
+                        maxError = juce::jmax(maxError, std::abs(output.getSample(ch, i + latency) - noisy.getSample(ch, i)));
+                expectLessThan(maxError, 1.0e-4f);
+            }
+        }
+
+        beginTest("Adaptive tracking removes the noise and keeps the tone");
+        {
+            SpectralDenoiser denoiser;
+            denoiser.prepare(sampleRate, 2, 512);
+            const auto output = run(denoiser, noisy, blockSize);
+            const int latency = denoiser.getLatencySamples();
+
+            // Third second: noise only, after the tracker has seen both
+            const double noiseBefore = energy(noisy, 0, 2 * 48000 + 4800, 3 * 48000);
+            const double noiseAfter = energy(output, latency, 2 * 48000 + 4800, 3 * 48000);
+            expectLessThan(10.0 * std::log10(noiseAfter / noiseBefore), -12.0);
+
+            const double toneBefore = energy(noisy, 0, 3 * 48000 + 4800, 4 * 48000 - latency);
+            const double toneAfter = energy(output, latency, 3 * 48000 + 4800, 4 * 48000 - latency);
+            expectWithinAbsoluteError(10.0 * std::log10(toneAfter / toneBefore), 0.0, 1.0);
+        }
+
+        beginTest("Learned profile without tracking");
+        {
+            SpectralDenoiser denoiser;
+            denoiser.prepare(sampleRate, 2, 512);
+            SpectralDenoiser::Parameters params;
+            params.adaptive = false;
+            denoiser.setParameters(params);
+
+            // Learn over the first (noise only) second, then process the rest
+            juce::AudioBuffer<float> region(2, 48000);
+            for (int ch = 0; ch < 2; ++ch)
+                region.copyFrom(ch, 0, noisy, ch, 0, 48000);
+            denoiser.setLearning(true);
+            run(denoiser, region, blockSize);
+            expect(!denoiser.hasNoiseProfile());
+            denoiser.setLearning(false);
+            denoiser.reset();
+
+            const auto output = run(denoiser, noisy, blockSize);
+            expect(denoiser.hasNoiseProfile());
+            const int latency = denoiser.getLatencySamples();
+            const double noiseBefore = energy(noisy, 0, 2 * 48000 + 4800, 3 * 48000);
+            const double noiseAfter = energy(output, latency, 2 * 48000 + 4800, 3 * 48000);
+            expectLessThan(10.0 * std::log10(noiseAfter / noiseBefore), -12.0);
+        }
+
+        beginTest("Block size does not change the output");
+        {
+            SpectralDenoiser a, b;
+            a.prepare(sampleRate, 2, 1024);
+            b.prepare(sampleRate, 2, 1024);
+            const auto small = run(a, noisy, 37);
+            const auto large = run(b, noisy, 4096);
+            bool identical = true;
+            for (int i = 0; i < numSamples && identical; ++i)
+                identical = small.getSample(1, i) == large.getSample(1, i);
+            expect(identical);
+        }
+
+        beginTest("DenoiseService output is aligned with its input");
+        {
+            omega::AI::DenoiseService service;
+            omega::AI::DenoiseConfig config;
+            config.sampleRate = sampleRate;
+            config.reductionAmount = 0.0f;
+            service.setConfig(config);
+
+            auto result = service.processAudio(noisy);
+            expect(result.success);
+            expectEquals(result.denoisedAudio.getNumSamples(), numSamples);
+            float maxError = 0.0f;
+            for (int i = 0; i < numSamples; ++i)
+                maxError = juce::jmax(maxError, std::abs(result.denoisedAudio.getSample(0, i) - noisy.getSample(0, i)));
+            expectLessThan(maxError, 1.0e-4f);
+
+            config.reductionAmount = 0.8f;
+            service.setConfig(config);
+            result = service.processAudio(noisy);
+            expect(result.success);
+            expectLessThan(result.noiseReductionDb, 0.0f);
+            expectLessThan(energy(result.denoisedAudio, 0, 2 * 48000 + 4800, 3 * 48000),
+                           0.1 * energy(noisy, 0, 2 * 48000 + 4800, 3 * 48000));
+        }
+    }
+};
+
+static SpectralDenoiserTest spectralDenoiserTest;
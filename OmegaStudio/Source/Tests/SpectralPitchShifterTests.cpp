@@ -0,0 +1,131 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/SpectralPitchShifter.h"
+
+using namespace omega;
+
+class SpectralPitchShifterTest : public juce::UnitTest {
+public:
+    SpectralPitchShifterTest() : juce::UnitTest("SpectralPitchShifter", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const int numSamples = 48000;
+        const int blockSize = 480;
+
+        auto makeTone = [&](double frequency, float amplitude) {
+            std::vector<float> signal((size_t) numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                signal[(size_t) i] = amplitude * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+            return signal;
+        };
+
+        // Amplitude of one frequency over the second half (past the start-up)
+        auto fit = [&](const std::vector<float>& signal, double frequency) {
+            const double w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            double s = 0.0, c = 0.0;
+            const int start = (int) signal.size() / 2;
+            for (int i = start; i < (int) signal.size(); ++i) {
+                s += signal[(size_t) i] * std::sin(w * i);
+                c += signal[(size_t) i] * std::cos(w * i);
+            }
+            return 2.0 * std::hypot(s, c) / (double) (signal.size() - (size_t) start);
+        };
+
+        // Every voice of one shifter, block by block
+        auto run = [&](SpectralPitchShifter& shifter, const std::vector<float>& input) {
+            std::vector<std::vector<float>> outputs((size_t) shifter.getNumVoices(), std::vector<float>((size_t) numSamples));
+            for (int offset = 0; offset < numSamples; offset += blockSize) {
+                float* pointers[SpectralPitchShifter::kMaxVoices] = {};
+                for (int v = 0; v < shifter.getNumVoices(); ++v)
+                    pointers[v] = outputs[(size_t) v].data() + offset;
+                shifter.process(input.data() + offset, pointers, juce::jmin(blockSize, numSamples - offset));
+            }
+            return outputs;
+        };
+
+        beginTest("Unity ratio reproduces the input after the reported latency");
+        {
+            juce::Random random(5);
+            std::vector<float> input((size_t) numSamples);
+            for (int i = 0; i < numSamples; ++i)
+                input[(size_t) i] = 0.3f * (float) std::sin(juce::MathConstants<double>::twoPi * 330.0 * i / sampleRate)
+                                  + 0.2f * (random.nextFloat() - 0.5f);
+
+            SpectralPitchShifter shifter;
+            shifter.initialize(sampleRate, 1);
+            const auto output = run(shifter, input).front();
+            const int latency = shifter.getLatencySamples();
+
+            float maxError = 0.0f;
+            for (int i = latency; i < numSamples; ++i)
+                maxError = juce::jmax(maxError, std::abs(output[(size_t) i] - input[(size_t) (i - latency)]));
+            expect(maxError < 1.0e-4f, "Unity output differs from the delayed input by " + juce::String(maxError));
+        }
+
+        beginTest("Harmony voices land on their intervals and match single-voice shifters");
+        {
+            const auto input = makeTone(220.0, 0.5f);
+            const int intervals[] = { 3, 7, 12, -5 };
+
+            SpectralPitchShifter shared;
+            shared.initialize(sampleRate, 4);
+            for (int v = 0; v < 4; ++v)
+                shared.setPitchRatio(v, std::pow(2.0f, intervals[v] / 12.0f));
+            const auto voices = run(shared, input);
+
+            for (int v = 0; v < 4; ++v) {
+                const double target = 220.0 * std::pow(2.0, intervals[v] / 12.0);
+                const double level = juce::Decibels::gainToDecibels(fit(voices[(size_t) v], target) / 0.5);
+                const double original = juce::Decibels::gainToDecibels(fit(voices[(size_t) v], 220.0) / 0.5, -200.0);
+                expect(std::abs(level) < 1.5, juce::String(intervals[v]) + " st: target at " + juce::String(level, 2) + " dB");
+                expect(original < -30.0, juce::String(intervals[v]) + " st: input pitch left at " + juce::String(original, 1) + " dB");
+
+                // The shared analysis feeds each voice exactly what its own vocoder would
+                SpectralPitchShifter single;
+                single.initialize(sampleRate, 1);
+                single.setPitchRatio(0, shared.getPitchRatio(v));
+                const auto reference = run(single, input).front();
+
+                float maxError = 0.0f;
+                for (int i = 0; i < numSamples; ++i)
+                    maxError = juce::jmax(maxError, std::abs(reference[(size_t) i] - voices[(size_t) v][(size_t) i]));
+                expect(maxError < 1.0e-6f, "Voice " + juce::String(v) + " differs from a single shifter by " + juce::String(maxError));
+            }
+        }
+
+        beginTest("Benchmark: 4-voice harmony, shared analysis vs one vocoder per voice");
+        {
+            juce::Random random(9);
+            std::vector<float> input((size_t) numSamples);
+            for (auto& sample : input)
+                sample = 0.5f * (random.nextFloat() - 0.5f);
+
+            const int numPasses = 5;                 // 5 s
+            auto time = [&](auto&& body) {
+                const auto start = juce::Time::getHighResolutionTicks();
+                for (int pass = 0; pass < numPasses; ++pass)
+                    body();
+                return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            };
+
+            SpectralPitchShifter shared;
+            shared.initialize(sampleRate, 4);
+            std::vector<std::unique_ptr<SpectralPitchShifter>> separate;
+            for (int v = 0; v < 4; ++v) {
+                shared.setPitchRatio(v, 1.2f + 0.1f * v);
+                separate.push_back(std::make_unique<SpectralPitchShifter>());
+                separate.back()->initialize(sampleRate, 1);
+                separate.back()->setPitchRatio(0, 1.2f + 0.1f * v);
+            }
+
+            const double sharedTime = time([&] { run(shared, input); });
+            const double separateTime = time([&] { for (auto& shifter : separate) run(*shifter, input); });
+            const double seconds = numPasses * numSamples / sampleRate;
+
+            logMessage("4 voices: shared analysis " + juce::String(sharedTime / seconds * 100.0, 2) + "% of one core, "
+                       + "separate vocoders " + juce::String(separateTime / seconds * 100.0, 2) + "%");
+        }
+    }
+};
+
+static SpectralPitchShifterTest spectralPitchShifterTest;
@@ -0,0 +1,237 @@
+#include <JuceHeader.h>
+#include "../Audio/AI/StemSeparationPipeline.h"
+#include <atomic>
+#include <thread>
+
+using namespace omega::AI;
+
+namespace {
+// Each stem is a fixed share of the input: the stems must add back up to the mix
+class GainModel : public StemInferenceModel {
+public:
+    explicit GainModel(std::vector<float> gainsToUse, int callDelayMs = 0)
+        : gains(std::move(gainsToUse)), delayMs(callDelayMs) {}
+
+    int getNumStems() const override { return (int) gains.size(); }
+
+    bool separate(const float* input, int batchSize, int numChannels, int numSamples, float* output) override {
+        const int running = ++active;
+        int seen = maxActive.load();
+        while (running > seen && !maxActive.compare_exchange_weak(seen, running)) {}
+        if (delayMs > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+
+        const size_t windowSize = (size_t) numChannels * (size_t) numSamples;
+        for (int b = 0; b < batchSize; ++b)
+            for (size_t stem = 0; stem < gains.size(); ++stem)
+                for (size_t i = 0; i < windowSize; ++i)
+                    output[((size_t) b * gains.size() + stem) * windowSize + i] = input[(size_t) b * windowSize + i] * gains[stem];
+
+        ++calls;
+        --active;
+        return true;
+    }
+
+    std::vector<float> gains;
+    int delayMs;
+    std::atomic<int> active { 0 }, maxActive { 0 }, calls { 0 };
+};
+
+juce::AudioBuffer<float> makeSignal(int numChannels, int numSamples) {
+    juce::AudioBuffer<float> buffer(numChannels, numSamples);
+    juce::Random random(1234);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample(ch, i, 0.5f * std::sin(0.01f * (float) i * (float) (ch + 1)) + 0.1f * (random.nextFloat() - 0.5f));
+    return buffer;
+}
+}
+
+class StemSeparationPipelineTest : public juce::UnitTest {
+public:
+    StemSeparationPipelineTest() : juce::UnitTest("StemSeparationPipeline", "AI") {}
+
+    void runTest() override {
+        const double sampleRate = 1000.0;
+        const auto input = makeSignal(2, 5321);
+
+        beginTest("Overlapping windows reconstruct each stem");
+        {
+            struct Case { double window, overlap; int batch, inFlight; };
+            for (auto c : { Case { 1.0, 0.0, 1, 1 }, Case { 1.0, 0.25, 1, 2 }, Case { 0.5, 0.25, 3, 2 },
+                            Case { 2.0, 0.5, 2, 4 }, Case { 10.0, 1.0, 1, 2 } }) {
+                GainModel model({ 0.5f, 0.3f, 0.2f });
+                StemPipelineConfig config;
+                config.windowSeconds = c.window;
+                config.overlapSeconds = c.overlap;
+                config.batchSize = c.batch;
+                config.maxBatchesInFlight = c.inFlight;
+
+                StemSeparationPipeline pipeline(model, config);
+                std::map<juce::String, juce::AudioBuffer<float>> stems;
+                const auto result = pipeline.separateBuffer(input, sampleRate, stems);
+                expect(result.success);
+                expectEquals((int) stems.size(), 3);
+
+                float maxError = 0.0f;
+                for (int stem = 0; stem < 3; ++stem) {
+                    const auto& buffer = stems[model.getStemName(stem)];
+                    expectEquals(buffer.getNumSamples(), input.getNumSamples());
+                    for (int ch = 0; ch < 2; ++ch)
+                        for (int i = 0; i < input.getNumSamples(); ++i)
+                            maxError = juce::jmax(maxError, std::abs(buffer.getSample(ch, i) - model.gains[(size_t) stem] * input.getSample(ch, i)));
+                }
+                expectLessThan(maxError, 1.0e-5f);
+                expectLessOrEqual(model.maxActive.load(), c.inFlight);
+            }
+        }
+
+        beginTest("Batching and concurrency do not change the output");
+        {
+            auto separate = [&](int batch, int inFlight) {
+                GainModel model({ 0.7f, 0.3f });
+                StemPipelineConfig config;
+                config.windowSeconds = 0.8;
+                config.overlapSeconds = 0.3;
+                config.batchSize = batch;
+                config.maxBatchesInFlight = inFlight;
+                std::map<juce::String, juce::AudioBuffer<float>> stems;
+                StemSeparationPipeline(model, config).separateBuffer(input, sampleRate, stems);
+                return stems;
+            };
+
+            const auto reference = separate(1, 1);
+            for (auto [batch, inFlight] : { std::pair { 4, 1 }, std::pair { 1, 3 }, std::pair { 2, 3 } }) {
+                auto stems = separate(batch, inFlight);
+                bool identical = stems.size() == reference.size();
+                for (const auto& [name, buffer] : reference)
+                    for (int ch = 0; ch < 2 && identical; ++ch)
+                        for (int i = 0; i < buffer.getNumSamples() && identical; ++i)
+                            identical = stems[name].getSample(ch, i) == buffer.getSample(ch, i);
+                expect(identical);
+            }
+        }
+
+        beginTest("Working memory does not grow with the track");
+        {
+            GainModel model({ 0.5f, 0.5f });
+            StemPipelineConfig config;
+            config.maxMemoryBytes = 64u << 20;
+            config.batchSize = 4;
+            config.maxBatchesInFlight = 8;
+            StemSeparationPipeline pipeline(model, config);
+
+            // Ten-second stereo windows at 48 kHz, four of them per batch, fit only a couple of times
+            const auto bytes = pipeline.getWorkingMemoryBytes(2, 48000.0);
+            expectLessOrEqual(bytes, config.maxMemoryBytes);
+            expectGreaterThan(bytes, (size_t) 0);
+
+            GainModel small({ 0.5f, 0.5f });
+            StemPipelineConfig smallConfig;
+            smallConfig.windowSeconds = 0.5;
+            smallConfig.maxMemoryBytes = 1u << 20;
+            StemSeparationPipeline shortTrack(small, smallConfig), longTrack(small, smallConfig);
+            std::map<juce::String, juce::AudioBuffer<float>> stems;
+            expect(shortTrack.separateBuffer(makeSignal(2, 1000), sampleRate, stems).success);
+            expect(longTrack.separateBuffer(makeSignal(2, 50000), sampleRate, stems).success);
+            expectEquals(shortTrack.getWorkingMemoryBytes(2, sampleRate), longTrack.getWorkingMemoryBytes(2, sampleRate));
+        }
+
+        beginTest("Mono models get a downmix");
+        {
+            struct MonoModel : GainModel {
+                MonoModel() : GainModel({ 1.0f }) {}
+                int getNumChannels() const override { return 1; }
+            } model;
+            std::map<juce::String, juce::AudioBuffer<float>> stems;
+            expect(StemSeparationPipeline(model).separateBuffer(input, sampleRate, stems).success);
+            const auto& vocals = stems["vocals"];
+            expectEquals(vocals.getNumChannels(), 1);
+            expectWithinAbsoluteError(vocals.getSample(0, 100), 0.5f * (input.getSample(0, 100) + input.getSample(1, 100)), 1.0e-5f);
+        }
+
+        beginTest("Cancelling a queued separation stops it");
+        {
+            GainModel model({ 0.5f, 0.5f }, 20);
+            StemPipelineConfig config;
+            config.windowSeconds = 0.1;
+            config.overlapSeconds = 0.0;
+            StemSeparationPipeline pipeline(model, config);
+
+            AIJobQueue queue(1);
+            juce::WaitableEvent finished;
+            StemPipelineResult result;
+            auto job = queue.addJob([&](AIJobContext& context) {
+                std::map<juce::String, juce::AudioBuffer<float>> stems;
+                result = pipeline.separateBuffer(makeSignal(2, 20000), sampleRate, stems, &context);
+                finished.signal();
+            }, AIJobPriority::High);
+
+            while (model.calls.load() < 2)
+                juce::Thread::sleep(1);
+            job->cancel();
+            expect(finished.wait(5000));
+            expect(result.cancelled);
+            expect(!result.success);
+            expectLessThan(model.calls.load(), 200);
+            expectLessThan(job->getProgress(), 1.0f);
+        }
+
+        beginTest("Queue runs higher priorities first");
+        {
+            AIJobQueue queue(1);
+            juce::WaitableEvent gate, done;
+            std::vector<int> order;
+            queue.addJob([&](AIJobContext&) { gate.wait(5000); });
+            queue.addJob([&](AIJobContext&) { order.push_back(0); }, AIJobPriority::Low);
+            queue.addJob([&](AIJobContext&) { order.push_back(1); });
+            auto last = queue.addJob([&](AIJobContext&) { order.push_back(2); }, AIJobPriority::High);
+            queue.addJob([&](AIJobContext&) { done.signal(); }, AIJobPriority::Low);
+            gate.signal();
+            expect(done.wait(5000));
+            expect(order == std::vector<int> { 2, 1, 0 });
+            expect(last->isFinished());
+        }
+
+        beginTest("Stems are streamed to files");
+        {
+            auto dir = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("OmegaStemPipelineTest");
+            dir.deleteRecursively();
+            dir.createDirectory();
+            auto source = dir.getChildFile("mix.wav");
+            {
+                juce::WavAudioFormat wav;
+                std::unique_ptr<juce::FileOutputStream> stream(source.createOutputStream());
+                std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+                expect(writer != nullptr);
+                stream.release();
+                writer->writeFromAudioSampleBuffer(input, 0, input.getNumSamples());
+            }
+
+            GainModel model({ 0.25f, 0.75f });
+            StemPipelineConfig config;
+            config.windowSeconds = 1.0;
+            config.overlapSeconds = 0.2;
+            config.bitsPerSample = 32;
+            StemSeparationPipeline pipeline(model, config);
+            const auto result = pipeline.separateFile(source, dir.getChildFile("stems"));
+            expect(result.success);
+            expectEquals((int) result.stemFiles.size(), 2);
+
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+            std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(result.stemFiles.at("drums")));
+            expect(reader != nullptr);
+            if (reader != nullptr) {
+                expectEquals((int) reader->lengthInSamples, input.getNumSamples());
+                juce::AudioBuffer<float> drums(2, input.getNumSamples());
+                reader->read(&drums, 0, drums.getNumSamples(), 0, true, true);
+                expectWithinAbsoluteError(drums.getSample(1, 3000), 0.75f * input.getSample(1, 3000), 1.0e-5f);
+            }
+            reader.reset();
+            dir.deleteRecursively();
+        }
+    }
+};
+
+static StemSeparationPipelineTest stemSeparationPipelineTest;
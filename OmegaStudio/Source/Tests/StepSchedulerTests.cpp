@@ -0,0 +1,369 @@
+#include <JuceHeader.h>
+#include "../Sequencer/StepSequencer.h"
+#include "../Sequencer/ChannelRack.h"
+#include <thread>
+
+using namespace OmegaStudio::Sequencer;
+
+class StepSchedulerTest : public juce::UnitTest {
+public:
+    StepSchedulerTest() : juce::UnitTest("StepScheduler", "MIDI") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+
+        beginTest("Closed-form steps match a per-sample clock across blocks and tempo changes");
+        {
+            // Tempo en vigor desde cada sample (cambios siempre en el borde de un bloque)
+            struct TempoChange { int64_t atSample; double bpm; };
+            const std::vector<TempoChange> tempoMap {
+                { 0, 120.0 }, { 30011, 97.3 }, { 71234, 171.9 }, { 150001, 133.0 }, { 201777, 60.5 }
+            };
+            const int64_t totalSamples = 300000;
+
+            // Referencia: fase en steps integrada sample a sample; el step n suena
+            // en el sample más cercano al instante exacto en que la fase lo cruza
+            std::vector<int64_t> expected;
+            {
+                double phase = 0.0;
+                size_t change = 0;
+                double rate = 0.0;
+                for (int64_t s = 0; s < totalSamples; ++s) {
+                    while (change < tempoMap.size() && tempoMap[change].atSample == s)
+                        rate = tempoMap[change++].bpm / 60.0 * 4.0 / sampleRate;
+
+                    for (auto n = (int64_t)expected.size(); (double)n < phase + rate; ++n)
+                        expected.push_back((int64_t)std::llround((double)s + ((double)n - phase) / rate));
+                    phase += rate;
+                }
+            }
+
+            StepScheduler scheduler;
+            scheduler.prepare(sampleRate, tempoMap.front().bpm, 4);
+
+            juce::Random random(26);
+            std::vector<int64_t> scheduled;
+            size_t change = 1;
+            for (int64_t blockStart = 0; blockStart < totalSamples;) {
+                int numSamples = 1 + random.nextInt(1024);
+                if (change < tempoMap.size())
+                    numSamples = (int)juce::jmin((int64_t)numSamples, tempoMap[change].atSample - blockStart);
+                numSamples = (int)juce::jmin((int64_t)numSamples, totalSamples - blockStart);
+
+                scheduler.forEachStepInBlock(blockStart, numSamples, [&](const StepScheduler::StepEvent& e) {
+                    expectEquals(e.stepNumber, (int64_t)scheduled.size());
+                    scheduled.push_back(blockStart + e.sampleOffset);
+                });
+                blockStart += numSamples;
+
+                if (change < tempoMap.size() && tempoMap[change].atSample == blockStart)
+                    scheduler.setTempo(tempoMap[change++].bpm, blockStart);
+            }
+
+            // El último step de la referencia puede caer justo después del final
+            while (!expected.empty() && expected.back() >= totalSamples)
+                expected.pop_back();
+
+            expectEquals((int)scheduled.size(), (int)expected.size());
+            int mismatches = 0;
+            for (size_t i = 0; i < juce::jmin(scheduled.size(), expected.size()); ++i)
+                mismatches += scheduled[i] != expected[i] ? 1 : 0;
+            expectEquals(mismatches, 0);
+        }
+
+        beginTest("Swing and groove: every step once, at its closed-form sample, whatever the block size");
+        {
+            GrooveTemplate groove("Test", 16);
+            for (int i = 0; i < 16; ++i)
+                groove.timing[(size_t)i] = (float)((i * 7) % 11 - 5) * 3.0f;
+
+            StepScheduler reference;
+            reference.prepare(sampleRate, 128.0, 4);
+            reference.setSwing(0.4f);
+            reference.setGroove(groove, 0.75f);
+
+            for (int maxBlock : { 1, 32, 441, 4096 }) {
+                StepScheduler scheduler;
+                scheduler.prepare(sampleRate, 128.0, 4);
+                scheduler.setSwing(0.4f);
+                scheduler.setGroove(groove, 0.75f);
+
+                // Un step adelantado por el groove antes del sample 0 no suena nunca
+                juce::Random random(maxBlock);
+                int64_t nextStep = reference.getStepStartSample(0) < 0 ? 1 : 0;
+                int wrong = 0;
+                for (int64_t blockStart = 0; blockStart < 200000;) {
+                    const int numSamples = 1 + random.nextInt(maxBlock);
+                    scheduler.forEachStepInBlock(blockStart, numSamples, [&](const StepScheduler::StepEvent& e) {
+                        if (e.stepNumber != nextStep++
+                            || blockStart + e.sampleOffset != reference.getStepStartSample(e.stepNumber))
+                            ++wrong;
+                    });
+                    blockStart += numSamples;
+                }
+                expectGreaterThan((int)nextStep, 30);
+                expectEquals(wrong, 0, "Block size up to " + juce::String(maxBlock));
+            }
+        }
+
+        beginTest("A requested tempo applies at the next block start, phase preserved");
+        {
+            StepScheduler requested, reference;
+            requested.prepare(sampleRate, 120.0, 4);
+            reference.prepare(sampleRate, 120.0, 4);
+
+            juce::Random random(126);
+            std::vector<int64_t> a, b;
+            for (int64_t blockStart = 0; blockStart < 2000000;) {
+                const int numSamples = 1 + random.nextInt(700);
+                requested.forEachStepInBlock(blockStart, numSamples, [&](const StepScheduler::StepEvent& e) {
+                    a.push_back(blockStart + e.sampleOffset);
+                });
+                reference.forEachStepInBlock(blockStart, numSamples, [&](const StepScheduler::StepEvent& e) {
+                    b.push_back(blockStart + e.sampleOffset);
+                });
+                blockStart += numSamples;
+
+                // Solo cuenta la última petición antes del bloque
+                if (random.nextInt(20) == 0) {
+                    const double bpm = 60.0 + random.nextInt(140);
+                    requested.requestTempo(bpm * 0.5);
+                    requested.requestTempo(bpm);
+                    expectEquals(requested.getTempo(), reference.getTempo(), "Not applied before the block");
+                    reference.setTempo(bpm, blockStart);
+                }
+            }
+            expectGreaterThan((int)a.size(), 100);
+            expect(a == b);
+
+            // Un tempo nuevo en cada bloque (muy corto): el re-anclaje no pierde ni repite steps
+            StepScheduler everyBlock;
+            everyBlock.prepare(sampleRate, 120.0, 4);
+            int64_t nextStep = 0;
+            int wrong = 0;
+            for (int64_t blockStart = 0; blockStart < 4000000;) {
+                const int numSamples = 1 + random.nextInt(8);
+                everyBlock.requestTempo(60.0 + random.nextDouble() * 140.0);
+                everyBlock.forEachStepInBlock(blockStart, numSamples, [&](const StepScheduler::StepEvent& e) {
+                    wrong += e.stepNumber != nextStep++ ? 1 : 0;
+                });
+                blockStart += numSamples;
+            }
+            expectGreaterThan((int)nextStep, 100);
+            expectEquals(wrong, 0);
+        }
+
+        beginTest("Tempo requests racing the audio thread never tear the grid");
+        {
+            GrooveTemplate groove("Test", 16);
+            for (int i = 0; i < 16; ++i)
+                groove.timing[(size_t)i] = (float)((i * 5) % 7 - 3) * 2.0f;
+
+            StepScheduler scheduler;
+            scheduler.prepare(sampleRate, 120.0, 4);
+            scheduler.setSwing(0.2f);
+            scheduler.setGroove(groove, 1.0f);
+
+            // 60-200 BPM: un step dura entre 3600 y 12000 samples, mezcle los tempos que mezcle;
+            // swing y groove lo acortan o alargan como mucho en un 20 % de step y unos ms
+            std::atomic<bool> stop { false };
+            std::thread ui([&] {
+                juce::Random random(226);
+                while (!stop.load()) {
+                    scheduler.requestTempo(60.0 + random.nextDouble() * 140.0);
+                    std::this_thread::yield();
+                }
+            });
+
+            juce::Random random(326);
+            int64_t nextStep = scheduler.getStepStartSample(0) < 0 ? 1 : 0, lastStart = -1;
+            int wrong = 0;
+            for (int64_t blockStart = 0; blockStart < 20000000;) {
+                const int numSamples = 1 + random.nextInt(256);
+                scheduler.forEachStepInBlock(blockStart, numSamples, [&](const StepScheduler::StepEvent& e) {
+                    const int64_t start = blockStart + e.sampleOffset;
+                    if (e.stepNumber != nextStep++
+                        || (lastStart >= 0 && (start - lastStart < 2000 || start - lastStart > 15000)))
+                        ++wrong;
+                    lastStart = start;
+                });
+                blockStart += numSamples;
+            }
+            stop.store(true);
+            ui.join();
+
+            expectGreaterThan((int)nextStep, 1000);
+            expectEquals(wrong, 0);
+        }
+
+        beginTest("Channel rack: steps on the grid, tempo and skips applied at the block start");
+        {
+            const int blockSize = 512;
+            ChannelRackEngine rack;
+            const int id = rack.addChannel("Kick", Channel::Type::Instrument);
+            auto* kick = rack.getChannel(id);
+            std::fill(kick->steps.begin(), kick->steps.end(), true);
+            rack.prepareToPlay(sampleRate, blockSize);
+            rack.setTempo(120.0);
+            rack.start();
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            int64_t position = 0;
+            std::vector<int64_t> noteOns;
+            auto runBlocks = [&](int numBlocks) {
+                for (int block = 0; block < numBlocks; ++block) {
+                    midi.clear();
+                    rack.processBlock(buffer, midi);
+                    for (const auto metadata : midi)
+                        if (metadata.getMessage().isNoteOn())
+                            noteOns.push_back(position + metadata.samplePosition);
+                    position += blockSize;
+                }
+            };
+
+            // 120 BPM en semicorcheas: un step cada 6000 samples
+            runBlocks(40);
+            expect(rack.isPlaying());
+            bool onGrid = noteOns.size() == (size_t)(40 * blockSize / 6000 + 1);
+            for (size_t i = 0; i < noteOns.size(); ++i)
+                onGrid = onGrid && noteOns[i] == (int64_t)i * 6000;
+            expect(onGrid, "Steps every 6000 samples from 0");
+
+            // 150 BPM desde el inicio del siguiente bloque: el step en curso conserva su fase
+            const int64_t change = position;
+            const double phase = (double)change / 6000.0;
+            rack.setTempo(150.0);
+            noteOns.clear();
+            runBlocks(40);
+            const int64_t firstAfter = (int64_t)std::llround(change + (std::ceil(phase) - phase) * 4800.0);
+            expect(!noteOns.empty() && noteOns.front() == firstAfter, "First step after the change");
+            bool faster = noteOns.size() > 1;
+            for (size_t i = 1; i < noteOns.size(); ++i)
+                faster = faster && noteOns[i] - noteOns[i - 1] == 4800;
+            expect(faster, "Steps every 4800 samples after the change");
+
+            // Saltar un step lo adelanta al inicio del siguiente bloque
+            rack.advanceStep();
+            noteOns.clear();
+            runBlocks(1);
+            expect(!noteOns.empty() && noteOns.front() == position - blockSize, "Skipped step sounds at the block start");
+
+            // Reinicio: el step 0 en el primer sample del siguiente bloque
+            rack.start();
+            noteOns.clear();
+            const int64_t restart = position;
+            runBlocks(1);
+            expect(!noteOns.empty() && noteOns.front() == restart);
+            expectEquals(rack.getCurrentStep(), 0);
+
+            rack.stop();
+            expect(!rack.isPlaying());
+        }
+
+        beginTest("Channel rack: tempo edits racing the audio thread keep the steps in order");
+        {
+            const int blockSize = 64;
+            ChannelRackEngine rack;
+            const int id = rack.addChannel("Hat", Channel::Type::Instrument);
+            auto* hat = rack.getChannel(id);
+            std::fill(hat->steps.begin(), hat->steps.end(), true);
+            rack.prepareToPlay(sampleRate, blockSize);
+            rack.start();
+
+            std::atomic<bool> stop { false };
+            std::atomic<int> wrong { 0 }, noteOns { 0 };
+            std::thread audio([&] {
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::MidiBuffer midi;
+                int64_t position = 0, lastOn = -1;
+                while (!stop.load() || noteOns.load() < 200) {
+                    midi.clear();
+                    rack.processBlock(buffer, midi);
+                    for (const auto metadata : midi) {
+                        if (!metadata.getMessage().isNoteOn()) continue;
+                        const int64_t on = position + metadata.samplePosition;
+                        if (lastOn >= 0 && (on - lastOn < 3600 - 1 || on - lastOn > 12000 + 1))
+                            ++wrong;
+                        lastOn = on;
+                        ++noteOns;
+                    }
+                    position += blockSize;
+                }
+            });
+
+            juce::Random random(426);
+            for (int edit = 0; edit < 2000; ++edit) {
+                rack.setTempo(60.0 + random.nextDouble() * 140.0);
+                std::this_thread::yield();
+            }
+            stop.store(true);
+            audio.join();
+
+            expectGreaterOrEqual(noteOns.load(), 200);
+            expectEquals(wrong.load(), 0);
+        }
+
+        beginTest("Stop releases the notes that are sounding");
+        {
+            auto pattern = std::make_shared<StepPattern>(16, 1);
+            for (int i = 0; i < 16; ++i)
+                pattern->getStep(0, i).active = true;
+
+            StepSequencerEngine engine;
+            StepSequencerEngine::Config config;
+            config.sampleRate = sampleRate;
+            engine.prepare(config);
+            engine.setPattern(pattern);
+            engine.setGate(1.5f);
+            engine.start();
+
+            juce::MidiBuffer midi;
+            int held = 0;
+            for (int block = 0; block < 20; ++block) {
+                engine.process(midi, 512);
+                for (const auto metadata : midi) {
+                    const auto message = metadata.getMessage();
+                    held += message.isNoteOn() ? 1 : message.isNoteOff() ? -1 : 0;
+                }
+            }
+            expectGreaterThan(held, 0);
+
+            engine.stop();
+            engine.process(midi, 512);
+            for (const auto metadata : midi) {
+                const auto message = metadata.getMessage();
+                held += message.isNoteOn() ? 1 : message.isNoteOff() ? -1 : 0;
+            }
+            expectEquals(held, 0);
+        }
+
+        beginTest("Groove events: short templates and negative positions stay in bounds");
+        {
+            // 16 steps pero solo 4 valores: los steps sin valor quedan neutros
+            GrooveTemplate groove("Short", 16);
+            groove.velocity.assign(4, 0.5f);
+            groove.timing.assign(4, 0.0f);
+
+            GrooveEngine engine;
+            engine.setCustomGroove(groove);
+            engine.setAmount(1.0f);
+
+            const double samplesPerStep = sampleRate * 60.0 / 120.0 / 4.0;
+            MIDIFX::MidiEventBuffer events(16);
+            int wrong = 0;
+            for (int grid = -32; grid < 32; ++grid) {
+                events.clear();
+                events.add(MIDIFX::MidiEvent::noteOn(1, 60, 100, 0));
+                engine.processEvents(events, MIDIFX::BlockContext { sampleRate, 120.0, 512,
+                                                                     (int64_t)(grid * samplesPerStep) + 100 });
+
+                const int step = ((grid % 16) + 16) % 16;
+                wrong += events.size() != 1 || events[0].getVelocity() != (step < 4 ? 50 : 100) ? 1 : 0;
+            }
+            expectEquals(wrong, 0);
+        }
+    }
+};
+
+static StepSchedulerTest stepSchedulerTest;
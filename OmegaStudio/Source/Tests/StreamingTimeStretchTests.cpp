@@ -0,0 +1,235 @@
+#include <JuceHeader.h>
+#include "../Audio/DSP/StreamingTimeStretch.h"
+
+using namespace OmegaStudio::Audio::DSP;
+
+class StreamingTimeStretchTest : public juce::UnitTest {
+public:
+    StreamingTimeStretchTest() : juce::UnitTest("StreamingTimeStretch", "DSP") {}
+
+    void runTest() override {
+        const double sampleRate = 48000.0;
+        const int blockSize = 480;
+
+        auto makeTone = [&](int numSamples, double frequency, float amplitude) {
+            juce::AudioBuffer<float> buffer(2, numSamples);
+            for (int i = 0; i < numSamples; ++i) {
+                const float value = amplitude * (float) std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+                buffer.setSample(0, i, value);
+                buffer.setSample(1, i, value);
+            }
+            return buffer;
+        };
+
+        // Amplitude of one frequency over the second half (past the start-up)
+        auto fit = [&](const std::vector<float>& signal, double frequency) {
+            const double w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            double s = 0.0, c = 0.0;
+            const int start = (int) signal.size() / 2;
+            for (int i = start; i < (int) signal.size(); ++i) {
+                s += signal[(size_t) i] * std::sin(w * i);
+                c += signal[(size_t) i] * std::cos(w * i);
+            }
+            return 2.0 * std::hypot(s, c) / (double) (signal.size() - (size_t) start);
+        };
+
+        // Left channel of the stretcher output, block by block
+        auto stretch = [&](StreamingTimeStretcher& stretcher, StretchSource& source, int numSamples,
+                           double startPosition, auto&& rateForBlock) {
+            std::vector<float> left((size_t) numSamples), right((size_t) numSamples);
+            double position = startPosition;
+            for (int offset = 0, block = 0; offset < numSamples; offset += blockSize, ++block) {
+                const int count = juce::jmin(blockSize, numSamples - offset);
+                const double rate = rateForBlock(block);
+                float* outputs[2] = { left.data() + offset, right.data() + offset };
+                stretcher.process(source, outputs, 2, count, position, rate);
+                position += rate * count;
+            }
+            return left;
+        };
+
+        beginTest("Unity rate reproduces the source without latency");
+        {
+            juce::Random random(7);
+            juce::AudioBuffer<float> buffer(2, 96000);
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                const float value = 0.3f * (float) std::sin(juce::MathConstants<double>::twoPi * 440.0 * i / sampleRate)
+                                  + 0.2f * (random.nextFloat() - 0.5f);
+                buffer.setSample(0, i, value);
+                buffer.setSample(1, i, value);
+            }
+            BufferStretchSource source(buffer);
+
+            StreamingTimeStretcher stretcher;
+            stretcher.prepare(2, blockSize);
+            expectEquals(stretcher.getLatencySamples(), 0);
+
+            const int start = 1000;
+            const auto output = stretch(stretcher, source, 48000, (double) start, [](int) { return 1.0; });
+
+            float maxError = 0.0f;
+            for (int i = 0; i < (int) output.size(); ++i)
+                maxError = juce::jmax(maxError, std::abs(output[(size_t) i] - buffer.getSample(0, start + i)));
+            expect(maxError < 1.0e-4f, "Unity stretch differs from the source by " + juce::String(maxError));
+        }
+
+        beginTest("Stretched tones keep their pitch");
+        {
+            const auto buffer = makeTone(240000, 440.0, 0.5f);
+            BufferStretchSource source(buffer);
+
+            const std::vector<std::pair<const char*, std::function<double(int)>>> rates {
+                { "0.5x", [](int) { return 0.5; } },
+                { "1.5x", [](int) { return 1.5; } },
+                { "ramp", [](int block) { return 0.5 + 1.5 * (0.5 + 0.5 * std::sin(block * 0.05)); } },
+            };
+
+            for (const auto& rate : rates) {
+                StreamingTimeStretcher stretcher;
+                stretcher.prepare(2, blockSize);
+                const auto output = stretch(stretcher, source, 48000, 0.0, rate.second);
+
+                const double level = juce::Decibels::gainToDecibels(fit(output, 440.0) / 0.5);
+                expect(std::abs(level) < 1.0, juce::String(rate.first) + ": 440 Hz at " + juce::String(level, 2) + " dB");
+
+                // Varispeed would have moved the tone
+                if (rate.second(0) != 1.0 && rate.second(1) == rate.second(0)) {
+                    const double shifted = juce::Decibels::gainToDecibels(fit(output, 440.0 * rate.second(0)) / 0.5, -200.0);
+                    expect(shifted < -40.0, juce::String(rate.first) + ": energy at the varispeed pitch " + juce::String(shifted, 1) + " dB");
+                }
+            }
+        }
+
+        beginTest("Transients keep their attack");
+        {
+            // Noise bursts with a sharp onset over a quiet tone
+            juce::Random random(13);
+            const int spacing = 12000;
+            auto buffer = makeTone(120000, 220.0, 0.01f);
+            for (int onset = spacing; onset < buffer.getNumSamples() - spacing; onset += spacing)
+                for (int i = 0; i < 4800; ++i) {
+                    const float value = buffer.getSample(0, onset + i)
+                                      + 0.8f * (random.nextFloat() - 0.5f) * std::exp(-(float) i / 480.0f);
+                    buffer.setSample(0, onset + i, value);
+                    buffer.setSample(1, onset + i, value);
+                }
+            BufferStretchSource source(buffer);
+
+            // Level before each attack relative to the attack, in the 2x stretched output
+            auto preEcho = [&](bool preserve, int& numTransients) {
+                StreamingTimeStretcher stretcher;
+                stretcher.prepare(2, blockSize);
+                stretcher.setTransientPreservation(preserve);
+                const auto output = stretch(stretcher, source, 200000, 0.0, [](int) { return 0.5; });
+                numTransients = stretcher.getNumTransients();
+
+                double worst = 0.0;
+                for (int onset = spacing; onset * 2 < (int) output.size() - 4096; onset += spacing) {
+                    const int expected = onset * 2;
+                    float before = 0.0f, after = 0.0f;
+                    for (int i = expected - 1024; i < expected - 64; ++i)
+                        before = juce::jmax(before, std::abs(output[(size_t) i]));
+                    for (int i = expected; i < expected + 256; ++i)
+                        after = juce::jmax(after, std::abs(output[(size_t) i]));
+                    worst = juce::jmax(worst, (double) before / after);
+                }
+                return juce::Decibels::gainToDecibels(worst, -200.0);
+            };
+
+            int numTransients = 0, numTransientsOff = 0;
+            const double preserved = preEcho(true, numTransients);
+            const double smeared = preEcho(false, numTransientsOff);
+            logMessage("Pre-echo: " + juce::String(preserved, 1) + " dB with transient preservation, "
+                       + juce::String(smeared, 1) + " dB without");
+
+            expect(numTransients >= 8, "Detected " + juce::String(numTransients) + " of 8 attacks");
+            expectEquals(numTransientsOff, 0);
+            expect(preserved < -20.0, "Pre-echo at " + juce::String(preserved, 1) + " dB");
+            expect(preserved < smeared - 3.0, "Transient preservation must reduce the pre-echo");
+        }
+
+        beginTest("Warped clip plays from the background cache while the tempo is static");
+        {
+            const auto buffer = makeTone(8 * 48000, 440.0, 0.5f);
+            BufferStretchSource source(buffer);
+
+            WarpedClipPlayer player(false);
+            player.prepare(sampleRate, 512, 2);
+            player.setSource(&source);
+            player.setWarp({}, 120.0, sampleRate);
+
+            juce::AudioBuffer<float> block(2, 512);
+            std::vector<float> output;
+            double beat = 0.0;
+            int cachedBlocks = 0, rampCachedBlocks = 0;
+
+            auto run = [&](int numBlocks, auto&& tempoForBlock, int& fromCache) {
+                for (int b = 0; b < numBlocks; ++b) {
+                    const double tempo = tempoForBlock(b);
+                    block.clear();
+                    player.process(block.getArrayOfWritePointers(), 2, 512, beat, tempo, 16.0);
+                    player.runBackgroundJobs();
+                    fromCache += player.isPlayingFromCache() ? 1 : 0;
+                    for (int i = 0; i < 512; ++i)
+                        output.push_back(block.getSample(0, i));
+                    beat += 512.0 * tempo / (60.0 * sampleRate);
+                }
+            };
+
+            run(400, [](int) { return 100.0; }, cachedBlocks);
+            expect(player.isPlayingFromCache(), "Static tempo must end up on the cache");
+            expect(cachedBlocks > 300, "Only " + juce::String(cachedBlocks) + " of 400 blocks came from the cache");
+
+            run(200, [](int b) { return 100.0 + 0.2 * (b + 1); }, rampCachedBlocks);
+            expectEquals(rampCachedBlocks, 0);
+
+            int settledBlocks = 0;
+            run(200, [](int) { return 140.0; }, settledBlocks);
+            expect(settledBlocks > 150, "Cache must re-engage after the ramp");
+
+            // Sine at 440 Hz: no step larger than its slope across live/cache switches
+            float maxStep = 0.0f;
+            for (size_t i = 4096; i < output.size(); ++i)
+                maxStep = juce::jmax(maxStep, std::abs(output[i] - output[i - 1]));
+            expect(maxStep < 0.05f, "Discontinuity of " + juce::String(maxStep));
+
+            const double level = juce::Decibels::gainToDecibels(fit(output, 440.0) / 0.5);
+            expect(std::abs(level) < 1.5, "440 Hz at " + juce::String(level, 2) + " dB");
+        }
+
+        beginTest("Benchmark: 40 clips under tempo automation");
+        {
+            const auto buffer = makeTone(8 * 48000, 220.0, 0.5f);
+            const int numClips = 40;
+            const int numBlocks = 188;                   // 2 s
+
+            std::vector<std::unique_ptr<BufferStretchSource>> sources;
+            std::vector<std::unique_ptr<WarpedClipPlayer>> players;
+            for (int i = 0; i < numClips; ++i) {
+                sources.push_back(std::make_unique<BufferStretchSource>(buffer));
+                players.push_back(std::make_unique<WarpedClipPlayer>(false));
+                players.back()->prepare(sampleRate, 512, 2);
+                players.back()->setSource(sources.back().get());
+                players.back()->setWarp({}, 120.0, sampleRate);
+            }
+
+            juce::AudioBuffer<float> block(2, 512);
+            double beat = 0.0;
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < numBlocks; ++b) {
+                const double tempo = 90.0 + 0.25 * b;      // Never static: every clip stretches live
+                block.clear();
+                for (auto& player : players)
+                    player->process(block.getArrayOfWritePointers(), 2, 512, beat, tempo, 16.0);
+                beat += 512.0 * tempo / (60.0 * sampleRate);
+            }
+            const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            const double seconds = numBlocks * 512 / sampleRate;
+
+            logMessage(juce::String(numClips) + " stereo clips stretched live: " + juce::String(elapsed / seconds * 100.0, 1)
+                       + "% of one core");
+        }
+    }
+};
+
+static StreamingTimeStretchTest streamingTimeStretchTest;
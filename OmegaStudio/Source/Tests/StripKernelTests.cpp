@@ -0,0 +1,286 @@
+#include <JuceHeader.h>
+#include "../Mixer/StripKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace OmegaStudio;
+
+class StripKernelTest : public juce::UnitTest {
+public:
+    StripKernelTest() : juce::UnitTest("StripKernel", "Mixer") {}
+
+    void runTest() override {
+        // Odd sizes leave a scalar tail after the vector body (8 lanes AVX2, 4 NEON)
+        const int blockSizes[] { 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 64, 100, 127, 256, 511 };
+
+        beginTest("Stereo kernel matches the scalar reference");
+        {
+            juce::Random random(31);
+            for (int numSamples : blockSizes) {
+                for (int config = 0; config < 8; ++config) {
+                    const bool measureInput = (config & 1) != 0;
+                    const bool accumulate = (config & 2) != 0;
+                    const int numTaps = (config & 4) != 0 ? 3 : 0;
+                    checkStereo(random, numSamples, measureInput, accumulate, numTaps);
+                }
+            }
+        }
+
+        beginTest("Mono kernel matches the scalar reference");
+        {
+            juce::Random random(32);
+            for (int numSamples : blockSizes) {
+                for (int config = 0; config < 8; ++config) {
+                    const bool measureInput = (config & 1) != 0;
+                    const bool accumulate = (config & 2) != 0;
+                    const int numTaps = (config & 4) != 0 ? 2 : 0;
+                    checkMono(random, numSamples, measureInput, accumulate, numTaps);
+                }
+            }
+        }
+
+        beginTest("measureAndScale meters the input and ramps the gain");
+        {
+            juce::Random random(33);
+            for (int numSamples : blockSizes) {
+                const auto input = noise(random, numSamples);
+                const float from = gain(random), to = gain(random);
+
+                auto data = input;
+                StripKernel::Levels levels;
+                StripKernel::measureAndScale(data.data(), numSamples, from, to, levels, 1);
+
+                std::vector<double> expected((size_t) numSamples);
+                double peak = 0.0, sumSquares = 0.0;
+                for (int i = 0; i < numSamples; ++i) {
+                    const double x = input[(size_t) i];
+                    expected[(size_t) i] = ramp(from, to, i, numSamples) * x;
+                    peak = std::max(peak, std::abs(x));
+                    sumSquares += x * x;
+                }
+
+                expectClose(data, expected, "scaled", numSamples);
+                expectLevels(levels, 1, peak, sumSquares, "input", numSamples);
+                expectEquals(levels.peak[0], 0.0f);
+            }
+        }
+
+        beginTest("A ramp reaches its target on the last sample and holds it on the next block");
+        {
+            const int numSamples = 13;
+            std::vector<float> left((size_t) numSamples, 1.0f), right((size_t) numSamples, 1.0f);
+            StripKernel::Matrix from, to;
+            to.a00 = 0.25f;
+            to.a11 = 0.5f;
+            StripKernel::Levels out;
+            StripKernel::processStereo(left.data(), right.data(), numSamples, from, to,
+                                       nullptr, nullptr, nullptr, out);
+            expectWithinAbsoluteError(left.back(), 0.25f, 1.0e-6f);
+            expectWithinAbsoluteError(right.back(), 0.5f, 1.0e-6f);
+
+            std::fill(left.begin(), left.end(), 1.0f);
+            std::fill(right.begin(), right.end(), 1.0f);
+            StripKernel::processStereo(left.data(), right.data(), numSamples, to, to,
+                                       nullptr, nullptr, nullptr, out);
+            for (int i = 0; i < numSamples; ++i) {
+                expectEquals(left[(size_t) i], 0.25f);
+                expectEquals(right[(size_t) i], 0.5f);
+            }
+        }
+    }
+
+private:
+    // Referencia escalar: gain del sample i = from + (to - from) * (i + 1) / n, en double
+    static double ramp(float from, float to, int i, int numSamples) {
+        return (double) from + ((double) to - (double) from) * (double) (i + 1) / (double) numSamples;
+    }
+
+    static std::vector<float> noise(juce::Random& random, int numSamples) {
+        std::vector<float> data((size_t) numSamples);
+        for (auto& x : data)
+            x = random.nextFloat() * 2.0f - 1.0f;
+        return data;
+    }
+
+    static float gain(juce::Random& random) { return random.nextFloat() * 3.0f - 1.5f; }
+
+    static StripKernel::Matrix matrix(juce::Random& random) {
+        StripKernel::Matrix m;
+        m.a00 = gain(random); m.a01 = gain(random);
+        m.a10 = gain(random); m.a11 = gain(random);
+        return m;
+    }
+
+    void expectClose(const std::vector<float>& actual, const std::vector<double>& expected,
+                     const juce::String& what, int numSamples) {
+        double worst = 0.0;
+        for (size_t i = 0; i < actual.size(); ++i)
+            worst = std::max(worst, std::abs((double) actual[i] - expected[i]));
+        expect(worst < 1.0e-5, what + " differs by " + juce::String(worst) + " at " + juce::String(numSamples) + " samples");
+    }
+
+    void expectLevels(const StripKernel::Levels& levels, int channel, double peak, double sumSquares,
+                      const juce::String& what, int numSamples) {
+        const juce::String where = what + " ch" + juce::String(channel) + " at " + juce::String(numSamples) + " samples";
+        expect(std::abs((double) levels.peak[channel] - peak) < 1.0e-5, where + ": peak");
+        expect(std::abs((double) levels.sumSquares[channel] - sumSquares) < 1.0e-4 * juce::jmax(1.0, sumSquares),
+               where + ": sum of squares");
+    }
+
+    void checkStereo(juce::Random& random, int numSamples, bool measureInput, bool accumulate, int numTaps) {
+        const auto inL = noise(random, numSamples), inR = noise(random, numSamples);
+        const auto from = matrix(random), to = matrix(random);
+
+        // Buses ya con señal: el kernel suma, no sobrescribe
+        auto destL = noise(random, numSamples), destR = noise(random, numSamples);
+        std::vector<std::vector<float>> tapL, tapR;
+        StripKernel::Tap taps[3];
+        for (int k = 0; k < numTaps; ++k) {
+            tapL.push_back(noise(random, numSamples));
+            tapR.push_back(noise(random, numSamples));
+        }
+        for (int k = 0; k < numTaps; ++k) {
+            taps[k].destL = tapL[(size_t) k].data();
+            taps[k].destR = k == 2 ? nullptr : tapR[(size_t) k].data();   // El tercero va a un bus mono
+            taps[k].fromGain = gain(random);
+            taps[k].toGain = gain(random);
+            taps[k].preFader = k == 1;
+        }
+
+        std::vector<double> expL((size_t) numSamples), expR((size_t) numSamples);
+        std::vector<double> expDestL(destL.begin(), destL.end()), expDestR(destR.begin(), destR.end());
+        std::vector<std::vector<double>> expTapL, expTapR;
+        for (int k = 0; k < numTaps; ++k) {
+            expTapL.emplace_back(tapL[(size_t) k].begin(), tapL[(size_t) k].end());
+            expTapR.emplace_back(tapR[(size_t) k].begin(), tapR[(size_t) k].end());
+        }
+        double inPeak[2] {}, inSq[2] {}, outPeak[2] {}, outSq[2] {};
+
+        for (int i = 0; i < numSamples; ++i) {
+            const double l = inL[(size_t) i], r = inR[(size_t) i];
+            const double outL = ramp(from.a00, to.a00, i, numSamples) * l + ramp(from.a01, to.a01, i, numSamples) * r;
+            const double outR = ramp(from.a10, to.a10, i, numSamples) * l + ramp(from.a11, to.a11, i, numSamples) * r;
+            expL[(size_t) i] = outL;
+            expR[(size_t) i] = outR;
+            expDestL[(size_t) i] += outL;
+            expDestR[(size_t) i] += outR;
+
+            for (int k = 0; k < numTaps; ++k) {
+                const double g = ramp(taps[k].fromGain, taps[k].toGain, i, numSamples);
+                const double srcL = taps[k].preFader ? l : outL;
+                const double srcR = taps[k].preFader ? r : outR;
+                if (taps[k].destR != nullptr) {
+                    expTapL[(size_t) k][(size_t) i] += g * srcL;
+                    expTapR[(size_t) k][(size_t) i] += g * srcR;
+                } else {
+                    expTapL[(size_t) k][(size_t) i] += g * (srcL + srcR);
+                }
+            }
+
+            inPeak[0] = std::max(inPeak[0], std::abs(l));
+            inPeak[1] = std::max(inPeak[1], std::abs(r));
+            inSq[0] += l * l;
+            inSq[1] += r * r;
+            outPeak[0] = std::max(outPeak[0], std::abs(outL));
+            outPeak[1] = std::max(outPeak[1], std::abs(outR));
+            outSq[0] += outL * outL;
+            outSq[1] += outR * outR;
+        }
+
+        auto left = inL, right = inR;
+        StripKernel::Levels inLevels, outLevels;
+        StripKernel::processStereo(left.data(), right.data(), numSamples, from, to,
+                                   accumulate ? destL.data() : nullptr, accumulate ? destR.data() : nullptr,
+                                   measureInput ? &inLevels : nullptr, outLevels,
+                                   numTaps > 0 ? taps : nullptr, numTaps);
+
+        expectClose(left, expL, "left", numSamples);
+        expectClose(right, expR, "right", numSamples);
+        if (accumulate) {
+            expectClose(destL, expDestL, "bus left", numSamples);
+            expectClose(destR, expDestR, "bus right", numSamples);
+        }
+        for (int k = 0; k < numTaps; ++k) {
+            expectClose(tapL[(size_t) k], expTapL[(size_t) k], "send " + juce::String(k) + " left", numSamples);
+            if (taps[k].destR != nullptr)
+                expectClose(tapR[(size_t) k], expTapR[(size_t) k], "send " + juce::String(k) + " right", numSamples);
+        }
+        for (int ch = 0; ch < 2; ++ch) {
+            expectLevels(outLevels, ch, outPeak[ch], outSq[ch], "output", numSamples);
+            if (measureInput)
+                expectLevels(inLevels, ch, inPeak[ch], inSq[ch], "input", numSamples);
+        }
+    }
+
+    void checkMono(juce::Random& random, int numSamples, bool measureInput, bool accumulate, int numTaps) {
+        const auto input = noise(random, numSamples);
+        const float from = gain(random), to = gain(random);
+        const int channel = 1;
+
+        auto dest = noise(random, numSamples);
+        std::vector<std::vector<float>> tapL, tapR;
+        StripKernel::Tap taps[2];
+        for (int k = 0; k < numTaps; ++k) {
+            tapL.push_back(noise(random, numSamples));
+            tapR.push_back(noise(random, numSamples));
+        }
+        for (int k = 0; k < numTaps; ++k) {
+            taps[k].destL = tapL[(size_t) k].data();
+            taps[k].destR = k == 1 ? nullptr : tapR[(size_t) k].data();
+            taps[k].fromGain = gain(random);
+            taps[k].toGain = gain(random);
+            taps[k].preFader = k == 0;
+        }
+
+        std::vector<double> expected((size_t) numSamples), expDest(dest.begin(), dest.end());
+        std::vector<std::vector<double>> expTapL, expTapR;
+        for (int k = 0; k < numTaps; ++k) {
+            expTapL.emplace_back(tapL[(size_t) k].begin(), tapL[(size_t) k].end());
+            expTapR.emplace_back(tapR[(size_t) k].begin(), tapR[(size_t) k].end());
+        }
+        double inPeak = 0.0, inSq = 0.0, outPeak = 0.0, outSq = 0.0;
+
+        for (int i = 0; i < numSamples; ++i) {
+            const double x = input[(size_t) i];
+            const double y = ramp(from, to, i, numSamples) * x;
+            expected[(size_t) i] = y;
+            expDest[(size_t) i] += y;
+
+            // Mono: el send suma la misma señal a ambos lados del bus
+            for (int k = 0; k < numTaps; ++k) {
+                const double g = ramp(taps[k].fromGain, taps[k].toGain, i, numSamples);
+                const double src = taps[k].preFader ? x : y;
+                expTapL[(size_t) k][(size_t) i] += g * src;
+                expTapR[(size_t) k][(size_t) i] += g * src;
+            }
+
+            inPeak = std::max(inPeak, std::abs(x));
+            inSq += x * x;
+            outPeak = std::max(outPeak, std::abs(y));
+            outSq += y * y;
+        }
+
+        auto data = input;
+        StripKernel::Levels inLevels, outLevels;
+        StripKernel::processMono(data.data(), numSamples, from, to,
+                                 accumulate ? dest.data() : nullptr,
+                                 measureInput ? &inLevels : nullptr, outLevels, channel,
+                                 numTaps > 0 ? taps : nullptr, numTaps);
+
+        expectClose(data, expected, "mono", numSamples);
+        if (accumulate)
+            expectClose(dest, expDest, "mono bus", numSamples);
+        for (int k = 0; k < numTaps; ++k) {
+            expectClose(tapL[(size_t) k], expTapL[(size_t) k], "mono send " + juce::String(k) + " left", numSamples);
+            if (taps[k].destR != nullptr)
+                expectClose(tapR[(size_t) k], expTapR[(size_t) k], "mono send " + juce::String(k) + " right", numSamples);
+        }
+        expectLevels(outLevels, channel, outPeak, outSq, "mono output", numSamples);
+        expectEquals(outLevels.peak[0], 0.0f);
+        if (measureInput)
+            expectLevels(inLevels, channel, inPeak, inSq, "mono input", numSamples);
+    }
+};
+
+static StripKernelTest stripKernelTest;